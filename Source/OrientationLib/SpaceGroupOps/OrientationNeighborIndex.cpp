@@ -0,0 +1,364 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "OrientationNeighborIndex.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "SIMPLib/Math/SIMPLibMath.h"
+
+namespace
+{
+  static const size_t k_MaxLeafSize = 8;
+
+  /**
+   * @brief The CompareAxis class orders point indices by one coordinate
+   */
+  class CompareAxis
+  {
+    public:
+      CompareAxis(const float* points, int32_t axis) : m_Points(points), m_Axis(axis) {}
+      bool operator()(size_t a, size_t b) const
+      {
+        return m_Points[a * 4 + m_Axis] < m_Points[b * 4 + m_Axis];
+      }
+    private:
+      const float* m_Points;
+      int32_t m_Axis;
+  };
+
+  inline float chordSqrd(const float* a, const float* b)
+  {
+    float d0 = a[0] - b[0];
+    float d1 = a[1] - b[1];
+    float d2 = a[2] - b[2];
+    float d3 = a[3] - b[3];
+    return d0 * d0 + d1 * d1 + d2 * d2 + d3 * d3;
+  }
+
+  /**
+   * @brief chordSqrdToAngle Converts the squared chord between two unit quaternions to the rotation angle. The
+   * chord is 2*sin(angle/4), which keeps its precision for the small angles that acos of the dot product loses
+   */
+  inline float chordSqrdToAngle(float d2)
+  {
+    float halfChord = 0.5f * sqrtf(d2);
+    SIMPLibMath::boundF(halfChord, 0.0f, 1.0f);
+    return 4.0f * asinf(halfChord);
+  }
+
+  bool lessByAngle(const OrientationNeighborIndex::Neighbor& a, const OrientationNeighborIndex::Neighbor& b)
+  {
+    if (a.angle == b.angle) { return a.id < b.id; }
+    return a.angle < b.angle;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+OrientationNeighborIndex::OrientationNeighborIndex()
+{
+  setSpaceGroupOps(SpaceGroupOps::Pointer());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+OrientationNeighborIndex::~OrientationNeighborIndex()
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void OrientationNeighborIndex::setSpaceGroupOps(SpaceGroupOps::Pointer ops)
+{
+  m_Ops = ops;
+  m_SymOps.clear();
+  if (NULL != m_Ops.get())
+  {
+    int numSymOps = m_Ops->getNumSymOps();
+    m_SymOps.resize(numSymOps);
+    for (int i = 0; i < numSymOps; i++)
+    {
+      m_Ops->getQuatSymOp(i, m_SymOps[i]);
+    }
+  }
+  else
+  {
+    // No symmetry at all, just the identity
+    m_SymOps.push_back(QuaternionMathF::New(0.0f, 0.0f, 0.0f, 1.0f));
+  }
+
+  m_Ids.clear();
+  m_Points.clear();
+  m_Owners.clear();
+  m_Order.clear();
+  m_Nodes.clear();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void OrientationNeighborIndex::addOrientation(size_t id, const QuatF& q)
+{
+  QuatF qn = q;
+  QuaternionMathF::UnitQuaternion(qn);
+  QuatF qc = QuaternionMathF::New();
+
+  size_t owner = m_Ids.size();
+  m_Ids.push_back(id);
+  for (size_t i = 0; i < m_SymOps.size(); i++)
+  {
+    QuaternionMathF::Multiply(m_SymOps[i], qn, qc);
+    if (qc.w < 0.0f)
+    {
+      QuaternionMathF::Negate(qc);
+    }
+    m_Points.push_back(qc.x);
+    m_Points.push_back(qc.y);
+    m_Points.push_back(qc.z);
+    m_Points.push_back(qc.w);
+    m_Owners.push_back(owner);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t OrientationNeighborIndex::getNumberOfOrientations() const
+{
+  return m_Ids.size();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void OrientationNeighborIndex::build()
+{
+  size_t numPoints = m_Owners.size();
+  m_Order.resize(numPoints);
+  for (size_t i = 0; i < numPoints; i++)
+  {
+    m_Order[i] = i;
+  }
+  m_Nodes.clear();
+  m_Nodes.reserve(2 * (numPoints / k_MaxLeafSize + 1));
+  if (numPoints > 0)
+  {
+    buildNode(0, numPoints);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int32_t OrientationNeighborIndex::buildNode(size_t begin, size_t end)
+{
+  int32_t index = static_cast<int32_t>(m_Nodes.size());
+  Node node = { begin, end, -1, 0.0f, -1, -1 };
+  m_Nodes.push_back(node);
+  if (end - begin <= k_MaxLeafSize)
+  {
+    return index;
+  }
+
+  // Split along the axis with the largest spread
+  float minVal[4] = { 2.0f, 2.0f, 2.0f, 2.0f };
+  float maxVal[4] = { -2.0f, -2.0f, -2.0f, -2.0f };
+  for (size_t i = begin; i < end; i++)
+  {
+    const float* p = &(m_Points[m_Order[i] * 4]);
+    for (int32_t a = 0; a < 4; a++)
+    {
+      if (p[a] < minVal[a]) { minVal[a] = p[a]; }
+      if (p[a] > maxVal[a]) { maxVal[a] = p[a]; }
+    }
+  }
+  int32_t axis = 0;
+  for (int32_t a = 1; a < 4; a++)
+  {
+    if (maxVal[a] - minVal[a] > maxVal[axis] - minVal[axis]) { axis = a; }
+  }
+
+  size_t mid = begin + (end - begin) / 2;
+  std::nth_element(m_Order.begin() + begin, m_Order.begin() + mid, m_Order.begin() + end, CompareAxis(m_Points.data(), axis));
+  float split = m_Points[m_Order[mid] * 4 + axis];
+
+  int32_t left = buildNode(begin, mid);
+  int32_t right = buildNode(mid, end);
+  m_Nodes[index].axis = axis;
+  m_Nodes[index].split = split;
+  m_Nodes[index].left = left;
+  m_Nodes[index].right = right;
+  return index;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void OrientationNeighborIndex::searchRadius(int32_t node, const float* q, float radiusSqrd, std::vector<std::pair<size_t, float> >& matches) const
+{
+  const Node& n = m_Nodes[node];
+  if (n.axis < 0)
+  {
+    for (size_t i = n.begin; i < n.end; i++)
+    {
+      size_t p = m_Order[i];
+      float d2 = chordSqrd(q, &(m_Points[p * 4]));
+      if (d2 <= radiusSqrd)
+      {
+        matches.push_back(std::make_pair(m_Owners[p], d2));
+      }
+    }
+    return;
+  }
+
+  float diff = q[n.axis] - n.split;
+  int32_t nearChild = (diff <= 0.0f) ? n.left : n.right;
+  int32_t farChild = (diff <= 0.0f) ? n.right : n.left;
+  searchRadius(nearChild, q, radiusSqrd, matches);
+  if (diff * diff <= radiusSqrd)
+  {
+    searchRadius(farChild, q, radiusSqrd, matches);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+OrientationNeighborIndex::NeighborListType OrientationNeighborIndex::findWithinAngle(const QuatF& q, float angle) const
+{
+  NeighborListType neighbors;
+  if (m_Nodes.empty()) { return neighbors; }
+
+  QuatF qn = q;
+  QuaternionMathF::UnitQuaternion(qn);
+  float halfAngle = 0.5f * angle;
+  if (halfAngle > SIMPLib::Constants::k_Pi / 2.0f) { halfAngle = SIMPLib::Constants::k_Pi / 2.0f; }
+  float radius = 2.0f * sinf(0.5f * halfAngle);
+  float radiusSqrd = radius * radius;
+
+  // The stored equivalents are folded onto w >= 0, so both q and -q have to be searched
+  float query[4] = { qn.x, qn.y, qn.z, qn.w };
+  float negQuery[4] = { -qn.x, -qn.y, -qn.z, -qn.w };
+  std::vector<std::pair<size_t, float> > owners;
+  searchRadius(0, query, radiusSqrd, owners);
+  searchRadius(0, negQuery, radiusSqrd, owners);
+
+  // Keep the closest symmetric equivalent of each orientation
+  std::sort(owners.begin(), owners.end());
+  for (size_t i = 0; i < owners.size(); i++)
+  {
+    if (i > 0 && owners[i].first == owners[i - 1].first) { continue; }
+    Neighbor neighbor = { m_Ids[owners[i].first], chordSqrdToAngle(owners[i].second) };
+    neighbors.push_back(neighbor);
+  }
+  std::sort(neighbors.begin(), neighbors.end(), lessByAngle);
+  return neighbors;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void OrientationNeighborIndex::searchNearest(int32_t node, const float* q, size_t k, std::vector<std::pair<float, size_t> >& results) const
+{
+  const Node& n = m_Nodes[node];
+  if (n.axis < 0)
+  {
+    for (size_t i = n.begin; i < n.end; i++)
+    {
+      size_t p = m_Order[i];
+      size_t owner = m_Owners[p];
+      float d2 = chordSqrd(q, &(m_Points[p * 4]));
+      if (results.size() == k && d2 >= results.back().first) { continue; }
+
+      // Each orientation may only occupy one slot, with its closest equivalent
+      std::vector<std::pair<float, size_t> >::iterator existing = results.begin();
+      for (; existing != results.end(); ++existing)
+      {
+        if (existing->second == owner) { break; }
+      }
+      if (existing != results.end())
+      {
+        if (d2 >= existing->first) { continue; }
+        results.erase(existing);
+      }
+      std::pair<float, size_t> entry(d2, owner);
+      results.insert(std::upper_bound(results.begin(), results.end(), entry), entry);
+      if (results.size() > k) { results.pop_back(); }
+    }
+    return;
+  }
+
+  float diff = q[n.axis] - n.split;
+  int32_t nearChild = (diff <= 0.0f) ? n.left : n.right;
+  int32_t farChild = (diff <= 0.0f) ? n.right : n.left;
+  searchNearest(nearChild, q, k, results);
+  if (results.size() < k || diff * diff < results.back().first)
+  {
+    searchNearest(farChild, q, k, results);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+OrientationNeighborIndex::NeighborListType OrientationNeighborIndex::findNearest(const QuatF& q, size_t k) const
+{
+  NeighborListType neighbors;
+  if (m_Nodes.empty() || k == 0) { return neighbors; }
+
+  QuatF qn = q;
+  QuaternionMathF::UnitQuaternion(qn);
+  float query[4] = { qn.x, qn.y, qn.z, qn.w };
+  float negQuery[4] = { -qn.x, -qn.y, -qn.z, -qn.w };
+
+  std::vector<std::pair<float, size_t> > results;
+  results.reserve(k + 1);
+  searchNearest(0, query, k, results);
+  searchNearest(0, negQuery, k, results);
+
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    Neighbor neighbor = { m_Ids[results[i].second], chordSqrdToAngle(results[i].first) };
+    neighbors.push_back(neighbor);
+  }
+  std::sort(neighbors.begin(), neighbors.end(), lessByAngle);
+  return neighbors;
+}
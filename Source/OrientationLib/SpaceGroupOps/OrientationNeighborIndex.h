@@ -0,0 +1,153 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#ifndef _orientationneighborindex_h_
+#define _orientationneighborindex_h_
+
+#include <vector>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/Common/SIMPLibSetGetMacros.h"
+#include "SIMPLib/Math/QuaternionMath.hpp"
+
+#include "OrientationLib/OrientationLib.h"
+#include "OrientationLib/SpaceGroupOps/SpaceGroupOps.h"
+
+/**
+ * @brief The OrientationNeighborIndex class is a spatial index over a set of orientations that answers
+ * "which orientations are within X degrees of this one" and "which are the k closest" queries using
+ * the crystallographic disorientation angle as the metric.
+ *
+ * Every orientation is expanded into its symmetrically equivalent quaternions (S_i * q, the same
+ * convention used by SpaceGroupOps::getMisoQuat), folded onto the w >= 0 hemisphere and stored in a
+ * k-d tree in R^4. For unit quaternions the misorientation angle 2*acos(|q.p|) is a monotonic function
+ * of the chord length between q and +/-p, so a disorientation query becomes a Euclidean ball query
+ * around q and -q and the minimum over the symmetry operators falls out of the search.
+ *
+ * All orientations added to one index must share the crystal symmetry that the index was created
+ * with; multi-phase data should use one index per phase.
+ */
+class OrientationLib_EXPORT OrientationNeighborIndex
+{
+  public:
+    SIMPL_SHARED_POINTERS(OrientationNeighborIndex)
+    SIMPL_STATIC_NEW_MACRO(OrientationNeighborIndex)
+    SIMPL_TYPE_MACRO(OrientationNeighborIndex)
+
+    virtual ~OrientationNeighborIndex();
+
+    /**
+     * @brief The Neighbor struct is a single query result
+     */
+    typedef struct
+    {
+      size_t id;    // The id the orientation was added with
+      float angle;  // The disorientation angle to the query orientation (radians)
+    } Neighbor;
+
+    typedef std::vector<Neighbor> NeighborListType;
+
+    /**
+     * @brief setSpaceGroupOps Sets the crystal symmetry and clears the index
+     * @param ops The symmetry operators to expand each orientation with
+     */
+    void setSpaceGroupOps(SpaceGroupOps::Pointer ops);
+
+    /**
+     * @brief addOrientation Adds an orientation to the index. build() must be called
+     * after all orientations have been added and before any query.
+     * @param id A caller defined id (a Feature id or cell index for example)
+     * @param q The orientation
+     */
+    void addOrientation(size_t id, const QuatF& q);
+
+    /**
+     * @brief build Builds the k-d tree over the symmetry expanded orientations
+     */
+    void build();
+
+    /**
+     * @brief getNumberOfOrientations Returns the number of orientations that have been added
+     */
+    size_t getNumberOfOrientations() const;
+
+    /**
+     * @brief findWithinAngle Finds every orientation whose disorientation from q is <= angle
+     * @param q The query orientation
+     * @param angle The disorientation tolerance in radians
+     * @return The matches sorted by increasing angle. Each id appears once.
+     */
+    NeighborListType findWithinAngle(const QuatF& q, float angle) const;
+
+    /**
+     * @brief findNearest Finds the k orientations with the smallest disorientation from q
+     * @param q The query orientation
+     * @param k The number of neighbors to return
+     * @return The matches sorted by increasing angle. Each id appears once.
+     */
+    NeighborListType findNearest(const QuatF& q, size_t k) const;
+
+  protected:
+    OrientationNeighborIndex();
+
+  private:
+    typedef struct
+    {
+      size_t begin;   // First point of this node in m_Order
+      size_t end;     // One past the last point of this node in m_Order
+      int32_t axis;   // Split axis, -1 for a leaf
+      float split;    // Split value along the axis
+      int32_t left;   // Index of the child holding values <= split
+      int32_t right;  // Index of the child holding values >= split
+    } Node;
+
+    SpaceGroupOps::Pointer m_Ops;
+    std::vector<QuatF> m_SymOps;
+    std::vector<size_t> m_Ids;
+    std::vector<float> m_Points;    // 4 floats (x, y, z, w) per symmetric equivalent
+    std::vector<size_t> m_Owners;   // The index into m_Ids of each symmetric equivalent
+    std::vector<size_t> m_Order;    // Point indices, reordered so each node is a contiguous range
+    std::vector<Node> m_Nodes;
+
+    int32_t buildNode(size_t begin, size_t end);
+    void searchRadius(int32_t node, const float* q, float radiusSqrd, std::vector<std::pair<size_t, float> >& matches) const;
+    void searchNearest(int32_t node, const float* q, size_t k, std::vector<std::pair<float, size_t> >& results) const;
+
+    OrientationNeighborIndex(const OrientationNeighborIndex&); // Copy Constructor Not Implemented
+    void operator=(const OrientationNeighborIndex&); // Operator '=' Not Implemented
+};
+
+#endif /* _orientationneighborindex_h_ */
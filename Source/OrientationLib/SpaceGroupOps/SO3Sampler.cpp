@@ -31,6 +31,14 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "SO3Sampler.h"
 
+#include <algorithm>
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
 
 #include "SIMPLib/Math/SIMPLibMath.h"
 #include "SIMPLib/Math/ArrayHelpers.hpp"
@@ -103,6 +111,98 @@ static const int FZoarray[32] = { NoAxisOrder,NoAxisOrder,TwoFoldAxisOrder,TwoFo
                                   SixFoldAxisOrder,SixFoldAxisOrder,NoAxisOrder,NoAxisOrder,NoAxisOrder,NoAxisOrder,NoAxisOrder};
 
 
+namespace
+{
+/**
+ * @brief The SampleRFZImpl class converts a range of x-planes of the cubochoric grid to Rodrigues
+ * vectors and keeps the ones inside the fundamental zone. Each plane is written to its own buffer.
+ */
+class SampleRFZImpl
+{
+  public:
+    SampleRFZImpl(SO3Sampler* sampler, int nsteps, double delta, int FZtype, int FZorder, int firstPlane, std::vector<std::vector<double> >* planes) :
+      m_Sampler(sampler),
+      m_NSteps(nsteps),
+      m_Delta(delta),
+      m_FZtype(FZtype),
+      m_FZorder(FZorder),
+      m_FirstPlane(firstPlane),
+      m_Planes(planes)
+    {}
+    virtual ~SampleRFZImpl() {}
+
+    void sample(size_t start, size_t end) const
+    {
+      typedef OrientationTransforms<DOrientArrayType, double> OrientationTransformsType;
+
+      // Wrap stack memory so the inner loop does not allocate
+      double cuData[3] = { 0.0, 0.0, 0.0 };
+      double rodData[4] = { 0.0, 0.0, 0.0, 0.0 };
+      DOrientArrayType cu(cuData, 3);
+      DOrientArrayType rod(rodData, 4);
+
+      for (size_t p = start; p < end; p++)
+      {
+        std::vector<double>& plane = (*m_Planes)[p];
+        plane.clear();
+        cuData[0] = static_cast<double>(m_FirstPlane + static_cast<int>(p)) * m_Delta;
+        for(int j = -m_NSteps; j < m_NSteps; j++)
+        {
+          cuData[1] = static_cast<double>(j) * m_Delta;
+          for (int k = -m_NSteps; k < m_NSteps; k++)
+          {
+            cuData[2] = static_cast<double>(k) * m_Delta;
+            OrientationTransformsType::cu2ro(cu, rod);
+            if (m_Sampler->IsinsideFZ(rodData, m_FZtype, m_FZorder))
+            {
+              plane.insert(plane.end(), rodData, rodData + 4);
+            }
+          }
+        }
+      }
+    }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+    void operator()(const tbb::blocked_range<size_t>& r) const
+    {
+      sample(r.begin(), r.end());
+    }
+#endif
+
+  private:
+    SO3Sampler* m_Sampler;
+    int m_NSteps;
+    double m_Delta;
+    int m_FZtype;
+    int m_FZorder;
+    int m_FirstPlane;
+    std::vector<std::vector<double> >* m_Planes;
+};
+
+/**
+ * @brief The AppendToListFunctor class collects streamed Rodrigues vectors into an OrientationListArrayType
+ */
+class AppendToListFunctor
+{
+  public:
+    AppendToListFunctor(SO3Sampler::OrientationListArrayType& list) :
+      m_List(list)
+    {}
+
+    void operator()(const double* rods, size_t numPoints)
+    {
+      for (size_t i = 0; i < numPoints; i++)
+      {
+        const double* r = rods + i * 4;
+        m_List.push_back(DOrientArrayType(r[0], r[1], r[2], r[3]));
+      }
+    }
+
+  private:
+    SO3Sampler::OrientationListArrayType& m_List;
+};
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -224,6 +324,20 @@ bool SO3Sampler::IsinsideFZ(double* rod, int FZtype, int FZorder)
 }
 
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t SO3Sampler::IsinsideFZ(double* rods, size_t numPoints, int FZtype, int FZorder, bool* inside)
+{
+  size_t count = 0;
+  for (size_t i = 0; i < numPoints; i++)
+  {
+    inside[i] = IsinsideFZ(rods + i * 4, FZtype, FZorder);
+    if (inside[i]) { count++; }
+  }
+  return count;
+}
+
 //--------------------------------------------------------------------------
 //
 // FUNCTION: insideCyclicFZ
@@ -338,27 +452,24 @@ bool SO3Sampler::insideDihedralFZ(double* rod, int order)
 bool SO3Sampler::insideCubicFZ(double* rod, int ot)
 {
   bool res = false, c1 = false, c2 = false;
-  std::vector<double> r(3);
-  r[0] = rod[0] * rod[3];
-  r[1] = rod[1] * rod[3];
-  r[2] = rod[2] * rod[3];
-  const double r1 = 1.0;
+  // absolute values of the scaled components; kept on the stack since this is
+  // called once for every grid point by the samplers
+  const double r0 = fabs(rod[0] * rod[3]);
+  const double r1 = fabs(rod[1] * rod[3]);
+  const double r2 = fabs(rod[2] * rod[3]);
+  const double one = 1.0;
 
   // primary cube planes (only needed for octahedral case)
   if (ot == OctahedralType) {
-
-    typedef OrientationTransforms<std::vector<double>, double> OrientationTransformsType;
-
-    // std::vector<double> absR = OrientationTransformsType::OMHelperType::absValue(r);
-    // double maxVal = OrientationTransformsType::OMHelperType::maxval(absR);
-    c1 = OrientationTransformsType::OMHelperType::maxval(OrientationTransformsType::OMHelperType::absValue(r)) <= LPs::BP[3];
-
+    double maxVal = (r0 > r1) ? r0 : r1;
+    maxVal = (maxVal > r2) ? maxVal : r2;
+    c1 = maxVal <= LPs::BP[3];
   } else {
     c1 = true;
   }
 
   // octahedral truncation planes, both for tetrahedral and octahedral point groups
-  c2 = ((fabs(r[0])+fabs(r[1])+fabs(r[2])) <= r1);
+  c2 = ((r0 + r1 + r2) <= one);
 
   // if both c1 and c2, then the point is inside
   if (c1 && c2) { res = true;}
@@ -421,50 +532,66 @@ bool SO3Sampler::insideCubicFZ(double* rod, int ot)
 //--------------------------------------------------------------------------
 SO3Sampler::OrientationListArrayType SO3Sampler::SampleRFZ(int nsteps,int pgnum)
 {
+  OrientationListArrayType FZlist;
+  AppendToListFunctor appender(FZlist);
+  SampleRFZ(nsteps, pgnum, appender);
+  return FZlist;
+}
 
-  double                        x, y, z, delta;
-  OrientationListArrayType              FZlist;
-  int32_t                 FZtype, FZorder;
-
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t SO3Sampler::SampleRFZ(int nsteps, int pgnum, RodriguesBlockCallbackType callback)
+{
   // step size for sampling of grid; total number of samples = (2*nsteps+1)**3
-  delta = ( 0.50 * LPs::ap)/static_cast<double>(nsteps);
+  double delta = ( 0.50 * LPs::ap)/static_cast<double>(nsteps);
 
   // determine which function we should call for this point group symmetry
-  FZtype = FZtarray[pgnum-1];
-  FZorder = FZoarray[pgnum-1];
-  typedef OrientationTransforms<DOrientArrayType, double> OrientationTransformsType;
+  int32_t FZtype = FZtarray[pgnum-1];
+  int32_t FZorder = FZoarray[pgnum-1];
 
   // loop over the cube of volume pi^2; note that we do not want to include
   // the opposite edges/facets of the cube, to avoid double counting rotations
   // with a rotation angle of 180 degrees.  This only affects the cyclic groups.
-  for(int i = -nsteps; i < nsteps; i++)
+  // The cube is processed as batches of x-planes, each plane filling its own buffer.
+  const int numPlanes = 2 * nsteps;
+  int batchSize = 1;
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+  tbb::task_scheduler_init init;
+  bool doParallel = true;
+  batchSize = 4 * tbb::task_scheduler_init::default_num_threads();
+#endif
+  if (batchSize > numPlanes) { batchSize = numPlanes; }
+
+  std::vector<std::vector<double> > planes(batchSize);
+  size_t totalPoints = 0;
+  for (int firstPlane = 0; firstPlane < numPlanes; firstPlane += batchSize)
   {
-    x = static_cast<double>(i) * delta;
-
-    for(int j = -nsteps; j < nsteps; j++)
+    int planesInBatch = std::min(batchSize, numPlanes - firstPlane);
+    SampleRFZImpl impl(this, nsteps, delta, FZtype, FZorder, firstPlane - nsteps, &planes);
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+    if (doParallel == true)
     {
-      y = static_cast<double>(j) * delta;
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, planesInBatch), impl, tbb::auto_partitioner());
+    }
+    else
+#endif
+    {
+      impl.sample(0, planesInBatch);
+    }
 
-      for (int k = -nsteps; k < nsteps; k++)
+    // Hand the planes over in grid order so the output matches the serial traversal
+    for (int p = 0; p < planesInBatch; p++)
+    {
+      size_t numPoints = planes[p].size() / 4;
+      if (numPoints > 0)
       {
-        z = static_cast<double>(k) * delta;
-
-        // convert to Rodrigues representation
-        DOrientArrayType cu(x, y, z);
-        DOrientArrayType rod(4);
-        OrientationTransformsType::cu2ro(cu, rod);
-
-        // If insideFZ=true, then add this point to the linked list FZlist and keep
-        // track of how many points there are on this list
-        bool b = IsinsideFZ(rod.data(), FZtype, FZorder);
-        if (b)
-        {
-          FZlist.push_back(rod);
-        }
-
+        callback(planes[p].data(), numPoints);
       }
+      totalPoints += numPoints;
     }
   }
 
-  return FZlist;
+  return totalPoints;
 }
@@ -32,6 +32,9 @@
 #ifndef _so3sampler_h_
 #define _so3sampler_h_
 
+#include <functional>
+#include <list>
+
 
 
 #include "SIMPLib/SIMPLib.h"
@@ -59,9 +62,40 @@ class OrientationLib_EXPORT SO3Sampler
      */
     typedef std::list<DOrientArrayType> OrientationListArrayType;
 
+    /**
+     * @brief RodriguesBlockCallbackType is handed consecutive blocks of Rodrigues vectors that lie
+     * inside the fundamental zone. Each vector is 4 doubles (unit axis followed by tan(omega/2)) and
+     * the blocks arrive in the same order as the serial cubochoric grid traversal. The callback is
+     * always invoked from the calling thread so it does not need to be thread safe.
+     */
+    typedef std::function<void(const double* rods, size_t numPoints)> RodriguesBlockCallbackType;
+
     // sampler routine
     OrientationListArrayType SampleRFZ(int nsteps,int pgnum);
 
+    /**
+     * @brief SampleRFZ Streaming version of the sampler. Planes of the cubochoric grid are converted
+     * and tested against the fundamental zone in parallel, a batch at a time, and each plane's
+     * points are passed to the callback before the batch buffers are reused. Only one batch of
+     * planes is ever held in memory.
+     * @param nsteps Number of steps along semi-edge in cubochoric grid
+     * @param pgnum Point group number to determine the appropriate Rodrigues fundamental zone
+     * @param callback Receives the points inside the fundamental zone
+     * @return The total number of points inside the fundamental zone
+     */
+    size_t SampleRFZ(int nsteps, int pgnum, RodriguesBlockCallbackType callback);
+
+    /**
+     * @brief IsinsideFZ Batch version that tests a contiguous array of Rodrigues vectors
+     * @param rods Pointer to numPoints * 4 doubles
+     * @param numPoints The number of Rodrigues vectors
+     * @param FZtype FZ type
+     * @param FZorder FZ order
+     * @param inside [output] Preallocated array of numPoints flags
+     * @return The number of points inside the fundamental zone
+     */
+    size_t IsinsideFZ(double* rods, size_t numPoints, int FZtype, int FZorder, bool* inside);
+
     /**
      * @brief IsinsideFZ
      * @param rod
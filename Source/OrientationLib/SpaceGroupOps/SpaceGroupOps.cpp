@@ -433,3 +433,23 @@ size_t SpaceGroupOps::getRandomSymmetryOperatorIndex(int numSymOps)
   size_t symOp = numberGenerator(); // Random remaining position.
   return symOp;
 }
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FOrientArrayType SpaceGroupOps::applySymmetryOperator(FOrientArrayType euler, size_t symOp)
+{
+  QuatF sym;
+  QuatF q;
+  QuatF qc;
+  getQuatSymOp(static_cast<int>(symOp), sym);
+
+  FOrientArrayType quat(4, 0.0f);
+  OrientationTransforms<FOrientArrayType, float>::eu2qu(euler, quat);
+  q = quat.toQuaternion();
+  QuaternionMathF::Multiply(sym, q, qc);
+
+  quat.fromQuaternion(qc);
+  OrientationTransforms<FOrientArrayType, float>::qu2eu(quat, euler);
+  return euler;
+}
@@ -139,6 +139,16 @@ class OrientationLib_EXPORT SpaceGroupOps
     virtual FOrientArrayType determineEulerAngles(uint64_t seed, int choose) = 0;
     virtual FOrientArrayType randomizeEulerAngles(FOrientArrayType euler) = 0;
     virtual size_t getRandomSymmetryOperatorIndex(int numSymOps);
+
+    /**
+     * @brief applySymmetryOperator Rotates the Euler angles by the given symmetry operator. This is what
+     * randomizeEulerAngles does with a randomly chosen operator, for callers that draw the operator index
+     * from their own random number stream.
+     * @param euler The Euler angles
+     * @param symOp The index of the symmetry operator, in [0, getNumSymOps())
+     * @return The symmetrically equivalent Euler angles
+     */
+    FOrientArrayType applySymmetryOperator(FOrientArrayType euler, size_t symOp);
     virtual FOrientArrayType determineRodriguesVector(uint64_t seed, int choose) = 0;
     virtual int getOdfBin(FOrientArrayType rod) = 0;
     virtual void getSchmidFactorAndSS(float load[3], float& schmidfactor, float angleComps[2], int& slipsys) = 0;
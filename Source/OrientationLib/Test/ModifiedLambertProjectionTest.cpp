@@ -0,0 +1,163 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <cstring>
+#include <vector>
+
+#include "SIMPLib/Math/SIMPLibMath.h"
+#include "SIMPLib/Utilities/SIMPLibRandom.h"
+
+#include "OrientationLib/Utilities/ModifiedLambertProjection.h"
+
+class ModifiedLambertProjectionTest
+{
+  public:
+    ModifiedLambertProjectionTest(){}
+    virtual ~ModifiedLambertProjectionTest(){}
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    FloatArrayType::Pointer randomDirections(size_t numDirections)
+    {
+      SIMPL_RANDOMNG_NEW_SEEDED(54321)
+      QVector<size_t> cDims(1, 3);
+      FloatArrayType::Pointer xyz = FloatArrayType::CreateArray(numDirections, cDims, "Directions");
+      for (size_t i = 0; i < numDirections; i++)
+      {
+        float* v = xyz->getPointer(i * 3);
+        float z = 2.0f * static_cast<float>(rg.genrand_res53()) - 1.0f;
+        float phi = static_cast<float>(rg.genrand_res53()) * SIMPLib::Constants::k_2Pi;
+        float r = sqrtf(1.0f - z * z);
+        v[0] = r * cosf(phi);
+        v[1] = r * sinf(phi);
+        v[2] = z;
+      }
+      // A few special directions: the poles and the equator
+      float special[6][3] = { { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f }, { 1.0f, 0.0f, 0.0f },
+        { 0.0f, -1.0f, 0.0f }, { static_cast<float>(SIMPLib::Constants::k_1OverRoot2), static_cast<float>(SIMPLib::Constants::k_1OverRoot2), 0.0f }, { -0.6f, 0.0f, 0.8f }
+      };
+      for (size_t i = 0; i < 6; i++)
+      {
+        ::memcpy(xyz->getPointer(i * 3), special[i], sizeof(float) * 3);
+      }
+      return xyz;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void ProjectDirectionsTest()
+    {
+      const size_t numDirections = 100000;
+      const int dimension = 36;
+      FloatArrayType::Pointer xyz = randomDirections(numDirections);
+
+      ModifiedLambertProjection::Pointer lambert = ModifiedLambertProjection::New();
+      lambert->initializeSquares(dimension, 1.0f);
+      std::vector<int> northIdx(numDirections * 4);
+      std::vector<int> southIdx(numDirections * 4);
+      std::vector<float> weights(numDirections * 4);
+      lambert->projectDirections(xyz->getPointer(0), numDirections, &(northIdx.front()), &(southIdx.front()), &(weights.front()));
+
+      size_t mismatched = 0;
+      float sqCoord[2] = { 0.0f, 0.0f };
+      for (size_t i = 0; i < numDirections; i++)
+      {
+        bool north = lambert->getSquareCoord(xyz->getPointer(i * 3), sqCoord);
+        int* hit = north ? &(northIdx[i * 4]) : &(southIdx[i * 4]);
+        int* miss = north ? &(southIdx[i * 4]) : &(northIdx[i * 4]);
+        float weightSum = 0.0f;
+        for (int b = 0; b < 4; b++)
+        {
+          DREAM3D_REQUIRE_EQUAL(miss[b], -1)
+          DREAM3D_REQUIRE(hit[b] >= 0 && hit[b] < dimension * dimension)
+          weightSum += weights[i * 4 + b];
+        }
+        DREAM3D_REQUIRE(fabs(weightSum - 1.0f) < 1.0E-5f)
+        // The batched kernel does not use the same trig so a direction sitting right on a bin boundary may land in the neighbor bin
+        if (hit[0] != lambert->getSquareIndex(sqCoord)) { mismatched++; }
+      }
+      DREAM3D_REQUIRE(mismatched < numDirections / 1000)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void CreateProjectionTest()
+    {
+      const size_t numDirections = 100000;
+      const int dimension = 32;
+      FloatArrayType::Pointer xyz = randomDirections(numDirections);
+
+      // Reference squares built one direction at a time
+      ModifiedLambertProjection::Pointer reference = ModifiedLambertProjection::New();
+      reference->initializeSquares(dimension, 1.0f);
+      float sqCoord[2] = { 0.0f, 0.0f };
+      for (size_t i = 0; i < numDirections; i++)
+      {
+        bool north = reference->getSquareCoord(xyz->getPointer(i * 3), sqCoord);
+        reference->addInterpolatedValues(north ? ModifiedLambertProjection::NorthSquare : ModifiedLambertProjection::SouthSquare, sqCoord, 1.0);
+      }
+
+      ModifiedLambertProjection::Pointer lambert = ModifiedLambertProjection::CreateProjectionFromXYZCoords(xyz.get(), dimension, 1.0f);
+
+      double total = 0.0;
+      double diff = 0.0;
+      for (int i = 0; i < dimension * dimension; i++)
+      {
+        total += lambert->getValue(ModifiedLambertProjection::NorthSquare, i) + lambert->getValue(ModifiedLambertProjection::SouthSquare, i);
+        diff += fabs(lambert->getValue(ModifiedLambertProjection::NorthSquare, i) - reference->getValue(ModifiedLambertProjection::NorthSquare, i));
+        diff += fabs(lambert->getValue(ModifiedLambertProjection::SouthSquare, i) - reference->getValue(ModifiedLambertProjection::SouthSquare, i));
+      }
+      DREAM3D_REQUIRE(fabs(total - double(numDirections)) < 1.0E-3 * numDirections)
+      DREAM3D_REQUIRE(diff < 1.0E-3 * numDirections)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( ProjectDirectionsTest() )
+      DREAM3D_REGISTER_TEST( CreateProjectionTest() )
+    }
+
+  private:
+    ModifiedLambertProjectionTest(const ModifiedLambertProjectionTest&); // Copy Constructor Not Implemented
+    void operator=(const ModifiedLambertProjectionTest&); // Operator '=' Not Implemented
+};
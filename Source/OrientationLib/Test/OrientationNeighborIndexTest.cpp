@@ -0,0 +1,199 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <algorithm>
+#include <map>
+
+#include "SIMPLib/Math/SIMPLibMath.h"
+#include "SIMPLib/Math/QuaternionMath.hpp"
+#include "SIMPLib/Utilities/SIMPLibRandom.h"
+
+#include "OrientationLib/SpaceGroupOps/CubicOps.h"
+#include "OrientationLib/SpaceGroupOps/HexagonalOps.h"
+#include "OrientationLib/SpaceGroupOps/OrientationNeighborIndex.h"
+
+class OrientationNeighborIndexTest
+{
+  public:
+    OrientationNeighborIndexTest(){}
+    virtual ~OrientationNeighborIndexTest(){}
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    QuatF randomQuaternion(SIMPLibRandom& rg)
+    {
+      // Uniformly distributed unit quaternion (Shoemake)
+      float u1 = static_cast<float>(rg.genrand_res53());
+      float u2 = static_cast<float>(rg.genrand_res53()) * SIMPLib::Constants::k_2Pi;
+      float u3 = static_cast<float>(rg.genrand_res53()) * SIMPLib::Constants::k_2Pi;
+      float a = sqrtf(1.0f - u1);
+      float b = sqrtf(u1);
+      return QuaternionMathF::New(a * sinf(u2), a * cosf(u2), b * sinf(u3), b * cosf(u3));
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestAgainstBruteForce(SpaceGroupOps::Pointer ops)
+    {
+      SIMPL_RANDOMNG_NEW_SEEDED(12345)
+      const size_t numOrientations = 2000;
+      const float tolerance = 1.0E-3f;
+      std::vector<QuatF> quats(numOrientations);
+
+      OrientationNeighborIndex::Pointer index = OrientationNeighborIndex::New();
+      index->setSpaceGroupOps(ops);
+      for (size_t i = 0; i < numOrientations; i++)
+      {
+        quats[i] = randomQuaternion(rg);
+        index->addOrientation(i + 1, quats[i]);
+      }
+      index->build();
+      DREAM3D_REQUIRE_EQUAL(index->getNumberOfOrientations(), numOrientations)
+
+      float n1 = 0.0f, n2 = 0.0f, n3 = 0.0f;
+      const float radius = 10.0f * SIMPLib::Constants::k_PiOver180;
+      for (size_t trial = 0; trial < 20; trial++)
+      {
+        QuatF q = randomQuaternion(rg);
+        std::vector<float> bruteAngles(numOrientations);
+        for (size_t i = 0; i < numOrientations; i++)
+        {
+          bruteAngles[i] = ops->getMisoQuat(q, quats[i], n1, n2, n3);
+        }
+
+        // Radius query: every reported angle must be the true disorientation and
+        // every orientation clearly inside the radius must be reported
+        OrientationNeighborIndex::NeighborListType within = index->findWithinAngle(q, radius);
+        std::map<size_t, float> found;
+        for (size_t i = 0; i < within.size(); i++)
+        {
+          DREAM3D_REQUIRE(found.find(within[i].id) == found.end())
+          found[within[i].id] = within[i].angle;
+          DREAM3D_REQUIRE(fabs(within[i].angle - bruteAngles[within[i].id - 1]) < tolerance)
+          DREAM3D_REQUIRE(within[i].angle <= radius + tolerance)
+        }
+        for (size_t i = 0; i < numOrientations; i++)
+        {
+          if (bruteAngles[i] < radius - tolerance)
+          {
+            DREAM3D_REQUIRE(found.find(i + 1) != found.end())
+          }
+        }
+
+        // k-NN query: the k-th reported angle must match the k-th smallest true disorientation
+        const size_t k = 7;
+        OrientationNeighborIndex::NeighborListType nearest = index->findNearest(q, k);
+        DREAM3D_REQUIRE_EQUAL(nearest.size(), k)
+        std::sort(bruteAngles.begin(), bruteAngles.end());
+        for (size_t i = 0; i < k; i++)
+        {
+          DREAM3D_REQUIRE(fabs(nearest[i].angle - bruteAngles[i]) < tolerance)
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void SmallAngleTest()
+    {
+      SIMPL_RANDOMNG_NEW_SEEDED(13579)
+      OrientationNeighborIndex::Pointer index = OrientationNeighborIndex::New();
+      index->setSpaceGroupOps(CubicOps::New());
+
+      // rotations of a few hundredths of a degree away from the query, well below what acos of the quaternion
+      // dot product resolves in float
+      const size_t numAngles = 5;
+      const float degrees[numAngles] = { 0.005f, 0.01f, 0.05f, 0.2f, 1.0f };
+      QuatF q = randomQuaternion(rg);
+      for (size_t i = 0; i < numAngles; i++)
+      {
+        float angle = degrees[i] * SIMPLib::Constants::k_PiOver180;
+        QuatF rotation = QuaternionMathF::New(0.0f, 0.0f, sinf(0.5f * angle), cosf(0.5f * angle));
+        QuatF p = QuaternionMathF::New();
+        QuaternionMathF::Multiply(q, rotation, p);
+        index->addOrientation(i + 1, p);
+      }
+      index->build();
+
+      const float radius = 0.5f * SIMPLib::Constants::k_PiOver180;
+      OrientationNeighborIndex::NeighborListType within = index->findWithinAngle(q, radius);
+      DREAM3D_REQUIRE_EQUAL(within.size(), numAngles - 1)
+      for (size_t i = 0; i < within.size(); i++)
+      {
+        DREAM3D_REQUIRE_EQUAL(within[i].id, i + 1)
+        float expected = degrees[i] * SIMPLib::Constants::k_PiOver180;
+        DREAM3D_REQUIRE(fabs(within[i].angle - expected) < 0.02f * expected)
+      }
+
+      OrientationNeighborIndex::NeighborListType nearest = index->findNearest(q, 1);
+      DREAM3D_REQUIRE_EQUAL(nearest.size(), 1)
+      DREAM3D_REQUIRE(nearest[0].angle > 0.0f)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void CubicIndexTest()
+    {
+      TestAgainstBruteForce(CubicOps::New());
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void HexagonalIndexTest()
+    {
+      TestAgainstBruteForce(HexagonalOps::New());
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( CubicIndexTest() )
+      DREAM3D_REGISTER_TEST( HexagonalIndexTest() )
+      DREAM3D_REGISTER_TEST( SmallAngleTest() )
+    }
+
+  private:
+    OrientationNeighborIndexTest(const OrientationNeighborIndexTest&); // Copy Constructor Not Implemented
+    void operator=(const OrientationNeighborIndexTest&); // Operator '=' Not Implemented
+};
@@ -30,13 +30,17 @@
  *
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
+#include <limits>
+#include <vector>
+
 #include "SIMPLib/SIMPLib.h"
 #include "SIMPLib/Math/SIMPLibMath.h"
+#include "SIMPLib/Utilities/SIMPLibRandom.h"
 #include "SIMPLib/Utilities/UnitTestSupport.hpp"
 
 #include "OrientationLibTestFileLocations.h"
 
-
+#include "OrientationLib/OrientationLibConstants.h"
 #include "OrientationLib/SpaceGroupOps/SO3Sampler.h"
 #include "OrientationLib/OrientationMath/OrientationTransforms.hpp"
 #include "OrientationLib/Utilities/ModifiedLambertProjection3D.hpp"
@@ -75,6 +79,134 @@ class SO3SamplerTest
       DREAM3D_REQUIRE_EQUAL(333227, orientations.size());
     }
 
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    class CollectRodriguesFunctor
+    {
+      public:
+        CollectRodriguesFunctor(std::vector<double>& rods) : m_Rods(rods) {}
+        void operator()(const double* rods, size_t numPoints)
+        {
+          m_Rods.insert(m_Rods.end(), rods, rods + numPoints * 4);
+        }
+      private:
+        std::vector<double>& m_Rods;
+    };
+
+    // -----------------------------------------------------------------------------
+    // Walks the cubochoric grid point by point, the way SampleRFZ did before it sampled in plane batches
+    // -----------------------------------------------------------------------------
+    void sampleSerially(SO3Sampler::Pointer sampler, int nsteps, int FZtype, int FZorder, std::vector<double>& rods)
+    {
+      double delta = (0.50 * LPs::ap) / static_cast<double>(nsteps);
+      for (int i = -nsteps; i < nsteps; i++)
+      {
+        for (int j = -nsteps; j < nsteps; j++)
+        {
+          for (int k = -nsteps; k < nsteps; k++)
+          {
+            DOrientArrayType cu(static_cast<double>(i) * delta, static_cast<double>(j) * delta, static_cast<double>(k) * delta);
+            DOrientArrayType rod(4);
+            OrientationTransformsType::cu2ro(cu, rod);
+            if (sampler->IsinsideFZ(rod.data(), FZtype, FZorder))
+            {
+              for (size_t c = 0; c < 4; c++) { rods.push_back(rod[c]); }
+            }
+          }
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void SO3StreamingTest()
+    {
+      // a point group of each FZ type and axis order, with its FZ type and order
+      const int numGroups = 11;
+      const int groups[numGroups][3] = { { 1, 0, 0 }, { 3, 1, 2 }, { 6, 2, 2 }, { 9, 1, 4 }, { 12, 2, 4 }, { 16, 1, 3 },
+                                         { 18, 2, 3 }, { 21, 1, 6 }, { 24, 2, 6 }, { 28, 3, 0 }, { 32, 4, 0 } };
+      const int nsteps = 12;
+
+      SO3Sampler::Pointer sampler = SO3Sampler::New();
+      for (int g = 0; g < numGroups; g++)
+      {
+        std::vector<double> expected;
+        sampleSerially(sampler, nsteps, groups[g][1], groups[g][2], expected);
+        DREAM3D_REQUIRE(expected.size() > 0)
+
+        // The streamed points must arrive in the order of the serial grid traversal
+        std::vector<double> rods;
+        size_t count = sampler->SampleRFZ(nsteps, groups[g][0], CollectRodriguesFunctor(rods));
+        DREAM3D_REQUIRE_EQUAL(count * 4, expected.size());
+        DREAM3D_REQUIRE(rods == expected)
+
+        SO3Sampler::OrientationListArrayType orientations = sampler->SampleRFZ(nsteps, groups[g][0]);
+        DREAM3D_REQUIRE_EQUAL(orientations.size() * 4, expected.size());
+        size_t index = 0;
+        for (SO3Sampler::OrientationListArrayType::iterator iter = orientations.begin(); iter != orientations.end(); ++iter)
+        {
+          for (size_t c = 0; c < 4; c++)
+          {
+            DREAM3D_REQUIRE_EQUAL((*iter)[c], expected[index * 4 + c]);
+          }
+          index++;
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void SO3BatchInsideTest()
+    {
+      SIMPL_RANDOMNG_NEW_SEEDED(24680)
+      const size_t numPoints = 5000;
+
+      // random rotations of every angle, some of them 180 degree rotations about an axis in the xy plane
+      std::vector<double> rods(numPoints * 4, 0.0);
+      for (size_t i = 0; i < numPoints; i++)
+      {
+        double z = 2.0 * rg.genrand_res53() - 1.0;
+        double phi = rg.genrand_res53() * SIMPLib::Constants::k_2Pi;
+        if (i % 50 == 0) { z = 0.0; }
+        double xy = sqrt(1.0 - z * z);
+        rods[i * 4] = xy * cos(phi);
+        rods[i * 4 + 1] = xy * sin(phi);
+        rods[i * 4 + 2] = z;
+        rods[i * 4 + 3] = (i % 25 == 0) ? std::numeric_limits<double>::infinity() : tan(0.5 * rg.genrand_res53() * SIMPLib::Constants::k_Pi);
+      }
+
+      // every FZ type, with every axis order of the cyclic and dihedral types
+      const int numZones = 11;
+      const int zones[numZones][2] = { { 0, 0 }, { 1, 2 }, { 1, 3 }, { 1, 4 }, { 1, 6 }, { 2, 2 }, { 2, 3 }, { 2, 4 }, { 2, 6 }, { 3, 0 }, { 4, 0 } };
+
+      SO3Sampler::Pointer sampler = SO3Sampler::New();
+      std::vector<bool> expected(numPoints, false);
+      QVector<bool> insideFlags(static_cast<int>(numPoints), false);
+      for (int z = 0; z < numZones; z++)
+      {
+        size_t expectedCount = 0;
+        for (size_t i = 0; i < numPoints; i++)
+        {
+          expected[i] = sampler->IsinsideFZ(&(rods[i * 4]), zones[z][0], zones[z][1]);
+          if (expected[i]) { expectedCount++; }
+        }
+
+        size_t insideCount = sampler->IsinsideFZ(rods.data(), numPoints, zones[z][0], zones[z][1], insideFlags.data());
+        DREAM3D_REQUIRE_EQUAL(insideCount, expectedCount);
+        for (size_t i = 0; i < numPoints; i++)
+        {
+          DREAM3D_REQUIRE_EQUAL(insideFlags[static_cast<int>(i)], expected[i]);
+        }
+
+        // only the triclinic FZ holds every rotation
+        if (zones[z][0] == 0) { DREAM3D_REQUIRE_EQUAL(insideCount, numPoints); }
+        else { DREAM3D_REQUIRE(insideCount > 0 && insideCount < numPoints) }
+      }
+    }
+
     // -----------------------------------------------------------------------------
     //
     // -----------------------------------------------------------------------------
@@ -138,6 +270,8 @@ class SO3SamplerTest
       DREAM3D_REGISTER_TEST( InsideCubicFZTest() )
       DREAM3D_REGISTER_TEST( TestPyramid() )
       DREAM3D_REGISTER_TEST( SO3CountTest() )
+      DREAM3D_REGISTER_TEST( SO3StreamingTest() )
+      DREAM3D_REGISTER_TEST( SO3BatchInsideTest() )
       DREAM3D_REGISTER_TEST( RemoveTestFiles() )
     }
 
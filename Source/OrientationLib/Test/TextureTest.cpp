@@ -40,6 +40,7 @@
 #include <string>
 
 #include "OrientationLib/Texture/Texture.hpp"
+#include "OrientationLib/Texture/OdfAccumulator.hpp"
 #include "OrientationLib/SpaceGroupOps/CubicOps.h"
 
 
@@ -56,7 +57,59 @@ class TextureTest
     TextureTest(){}
     virtual ~TextureTest(){}
 
-    void operator()()
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void OdfAccumulatorTest()
+    {
+      const int dim1 = 36, dim2 = 36, dim3 = 12;
+      QVector<int32_t> bins;
+      QVector<float> weights;
+      QVector<float> sigmas;
+      bins << 0 << 17 << 35 << (dim1 * dim2 * dim3 - 1) << (5 * dim1 * dim2 + 20 * dim1 + 3) << 700;
+      weights << 1.0f << 2.0f << 0.5f << 3.0f << 1.5f << 4.0f;
+      sigmas << 0.0f << 1.0f << 3.0f << 5.0f << 2.0f << 7.0f;
+
+      // Brute force splat of each component over its full (2s+1)^3 cube
+      QVector<double> expected(dim1 * dim2 * dim3, 0.0);
+      double expectedTotal = 0.0;
+      for (int i = 0; i < bins.size(); i++)
+      {
+        int s = static_cast<int>(sigmas[i]);
+        int bin1 = bins[i] % dim1;
+        int bin2 = (bins[i] / dim1) % dim2;
+        int bin3 = bins[i] / (dim1 * dim2);
+        for (int l = -s; l <= s; l++)
+        {
+          for (int k = -s; k <= s; k++)
+          {
+            for (int j = -s; j <= s; j++)
+            {
+              int distSqrd = j * j + k * k + l * l;
+              if (distSqrd > s * s) { continue; }
+              if (bin1 + j < 0 || bin1 + j >= dim1 || bin2 + k < 0 || bin2 + k >= dim2 || bin3 + l < 0 || bin3 + l >= dim3) { continue; }
+              double w = (s == 0) ? weights[i] : weights[i] * (1.0 - double(distSqrd) / double(s * s));
+              expected[((bin3 + l) * dim2 + (bin2 + k)) * dim1 + (bin1 + j)] += w;
+              expectedTotal += w;
+            }
+          }
+        }
+      }
+
+      OdfAccumulator accumulator(dim1, dim2, dim3);
+      accumulator.splat(bins.data(), weights.data(), sigmas.data(), bins.size());
+      DREAM3D_REQUIRE_EQUAL(accumulator.getSize(), static_cast<size_t>(expected.size()))
+      for (int i = 0; i < expected.size(); i++)
+      {
+        DREAM3D_REQUIRE(fabs(accumulator.getValues()[i] - expected[i]) < 1.0E-5)
+      }
+      DREAM3D_REQUIRE(fabs(accumulator.getTotalWeight() - expectedTotal) < 1.0E-3)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void CompileTest()
     {
       QVector<float> e1s;
       QVector<float> e2s;
@@ -92,6 +145,13 @@ class TextureTest
       Texture::CalculateMDFData<float, CubicOps>(angles.data(), axes.data(), weights.data(), odf.data(), mdf.data(), angles.size());
 
     }
+
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( CompileTest() )
+      DREAM3D_REGISTER_TEST( OdfAccumulatorTest() )
+    }
   private:
     TextureTest(const TextureTest&); // Copy Constructor Not Implemented
     void operator=(const TextureTest&); // Operator '=' Not Implemented
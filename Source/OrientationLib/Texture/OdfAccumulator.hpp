@@ -0,0 +1,341 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#ifndef _odfaccumulator_h_
+#define _odfaccumulator_h_
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/parallel_reduce.h>
+#include <tbb/blocked_range.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
+#include "SIMPLib/SIMPLib.h"
+
+/**
+ * @brief The OdfSmoothingKernel class holds the precomputed weight stencil that is
+ * splatted around a texture component's ODF bin. The weight of the offset (j, k, l)
+ * is 1 - (j^2 + k^2 + l^2) / sigma^2 for every offset inside the sphere of radius sigma.
+ * The stencil is stored as runs along the fastest varying bin axis so that each run
+ * is a contiguous add with the bounds clipped once per run instead of once per bin.
+ */
+class OdfSmoothingKernel
+{
+  public:
+    struct Run
+    {
+      int k;          // Offset along the second bin axis
+      int l;          // Offset along the third bin axis
+      int halfWidth;  // The run covers j = -halfWidth ... halfWidth
+      float base;     // 1 - (k^2 + l^2) / sigma^2
+    };
+
+    /**
+     * @brief OdfSmoothingKernel Builds the stencil for the given sigma. A sigma that
+     * is less than 1 produces a single unit weight at the center bin.
+     * @param sigma The smoothing radius in bins
+     */
+    explicit OdfSmoothingKernel(int sigma = 0) :
+      m_Sigma(sigma < 0 ? 0 : sigma)
+    {
+      if (m_Sigma == 0)
+      {
+        Run run = { 0, 0, 0, 1.0f };
+        m_Runs.push_back(run);
+        m_Falloff.push_back(0.0f);
+        return;
+      }
+
+      const int sigmaSqrd = m_Sigma * m_Sigma;
+      const float invSigmaSqrd = 1.0f / static_cast<float>(sigmaSqrd);
+      m_Falloff.resize(m_Sigma + 1);
+      for (int j = 0; j <= m_Sigma; j++)
+      {
+        m_Falloff[j] = static_cast<float>(j * j) * invSigmaSqrd;
+      }
+
+      for (int l = -m_Sigma; l <= m_Sigma; l++)
+      {
+        for (int k = -m_Sigma; k <= m_Sigma; k++)
+        {
+          int rowSqrd = k * k + l * l;
+          if (rowSqrd > sigmaSqrd) { continue; }
+          int halfWidth = 0;
+          while ((halfWidth + 1) * (halfWidth + 1) + rowSqrd <= sigmaSqrd) { halfWidth++; }
+          Run run = { k, l, halfWidth, 1.0f - static_cast<float>(rowSqrd) * invSigmaSqrd };
+          m_Runs.push_back(run);
+        }
+      }
+    }
+
+    virtual ~OdfSmoothingKernel() {}
+
+    int getSigma() const { return m_Sigma; }
+    const std::vector<Run>& getRuns() const { return m_Runs; }
+
+    /**
+     * @brief getFalloff Returns j^2 / sigma^2 for the given non-negative offset along the run
+     */
+    float getFalloff(int j) const { return m_Falloff[j]; }
+
+  private:
+    int m_Sigma;
+    std::vector<Run> m_Runs;
+    std::vector<float> m_Falloff;
+};
+
+/**
+ * @brief The OdfAccumulator class accumulates weights into a 3D grid of ODF bins. Bins are
+ * laid out with the first dimension varying fastest, which matches the bin numbering used
+ * by the SpaceGroupOps getOdfBin() functions. Accumulators can be merged so that
+ * each thread may fill its own private copy which are then combined at the end.
+ */
+class OdfAccumulator
+{
+  public:
+    OdfAccumulator(int dim1, int dim2, int dim3) :
+      m_Dim1(dim1),
+      m_Dim2(dim2),
+      m_Dim3(dim3),
+      m_Values(static_cast<size_t>(dim1) * dim2 * dim3, 0.0),
+      m_TotalWeight(0.0)
+    {}
+
+    virtual ~OdfAccumulator() {}
+
+    int getDim1() const { return m_Dim1; }
+    int getDim2() const { return m_Dim2; }
+    int getDim3() const { return m_Dim3; }
+    size_t getSize() const { return m_Values.size(); }
+    const double* getValues() const { return m_Values.data(); }
+
+    /**
+     * @brief getTotalWeight Returns the sum of all weights that landed inside the grid
+     */
+    double getTotalWeight() const { return m_TotalWeight; }
+
+    /**
+     * @brief reset Zeros all bins and the total weight
+     */
+    void reset()
+    {
+      std::fill(m_Values.begin(), m_Values.end(), 0.0);
+      m_TotalWeight = 0.0;
+    }
+
+    /**
+     * @brief addValue Adds the weight to a single bin
+     * @param bin The ODF bin
+     * @param weight The weight to add
+     */
+    void addValue(size_t bin, double weight)
+    {
+      m_Values[bin] += weight;
+      m_TotalWeight += weight;
+    }
+
+    /**
+     * @brief addSmoothed Splats the weight around the given bin using the kernel's stencil. Stencil
+     * entries that fall outside the grid are dropped (the grid does not wrap).
+     * @param bin The ODF bin at the center of the stencil
+     * @param weight The peak weight at the center of the stencil
+     * @param kernel The precomputed smoothing stencil
+     */
+    void addSmoothed(size_t bin, double weight, const OdfSmoothingKernel& kernel)
+    {
+      const int bin1 = static_cast<int>(bin % m_Dim1);
+      const int bin2 = static_cast<int>((bin / m_Dim1) % m_Dim2);
+      const int bin3 = static_cast<int>(bin / (m_Dim1 * m_Dim2));
+      const std::vector<OdfSmoothingKernel::Run>& runs = kernel.getRuns();
+      double added = 0.0;
+      for (size_t r = 0; r < runs.size(); r++)
+      {
+        const OdfSmoothingKernel::Run& run = runs[r];
+        const int addbin2 = bin2 + run.k;
+        const int addbin3 = bin3 + run.l;
+        if (addbin2 < 0 || addbin2 >= m_Dim2 || addbin3 < 0 || addbin3 >= m_Dim3) { continue; }
+        const int jStart = (bin1 - run.halfWidth < 0) ? -bin1 : -run.halfWidth;
+        const int jEnd = (bin1 + run.halfWidth >= m_Dim1) ? (m_Dim1 - 1 - bin1) : run.halfWidth;
+        double* row = &(m_Values[(static_cast<size_t>(addbin3) * m_Dim2 + addbin2) * m_Dim1 + bin1]);
+        for (int j = jStart; j <= jEnd; j++)
+        {
+          double addweight = weight * (run.base - kernel.getFalloff(j < 0 ? -j : j));
+          row[j] += addweight;
+          added += addweight;
+        }
+      }
+      m_TotalWeight += added;
+    }
+
+    /**
+     * @brief merge Adds the bins and total weight of another accumulator with the same dimensions
+     */
+    void merge(const OdfAccumulator& other)
+    {
+      for (size_t i = 0; i < m_Values.size(); i++)
+      {
+        m_Values[i] += other.m_Values[i];
+      }
+      m_TotalWeight += other.m_TotalWeight;
+    }
+
+    /**
+     * @brief copyTo Copies the accumulated bins into a preallocated array of getSize() elements
+     */
+    template<typename T>
+    void copyTo(T* odf) const
+    {
+      for (size_t i = 0; i < m_Values.size(); i++)
+      {
+        odf[i] = static_cast<T>(m_Values[i]);
+      }
+    }
+
+    /**
+     * @brief splat Smooths a list of texture components into this accumulator. One kernel is
+     * built for each distinct (integer) sigma and the components are then splatted in parallel
+     * into per-thread accumulators that are merged into this one.
+     * @param bins The ODF bin of each component
+     * @param weights The peak weight of each component
+     * @param sigmas The smoothing radius, in bins, of each component
+     * @param numEntries The number of components
+     */
+    template<typename T>
+    void splat(const int32_t* bins, const T* weights, const T* sigmas, size_t numEntries);
+
+  private:
+    int m_Dim1;
+    int m_Dim2;
+    int m_Dim3;
+    std::vector<double> m_Values;
+    double m_TotalWeight;
+};
+
+/**
+ * @brief The OdfSplatImpl class is the parallel_reduce body that gives each thread its own OdfAccumulator
+ */
+template<typename T>
+class OdfSplatImpl
+{
+  public:
+    OdfSplatImpl(int dim1, int dim2, int dim3, const int32_t* bins, const T* weights, const OdfSmoothingKernel* const* kernels) :
+      m_Accumulator(dim1, dim2, dim3),
+      m_Bins(bins),
+      m_Weights(weights),
+      m_Kernels(kernels)
+    {}
+
+    virtual ~OdfSplatImpl() {}
+
+    void splat(size_t start, size_t end)
+    {
+      for (size_t i = start; i < end; i++)
+      {
+        m_Accumulator.addSmoothed(m_Bins[i], m_Weights[i], *(m_Kernels[i]));
+      }
+    }
+
+    const OdfAccumulator& getAccumulator() const { return m_Accumulator; }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+    OdfSplatImpl(OdfSplatImpl& other, tbb::split) :
+      m_Accumulator(other.m_Accumulator.getDim1(), other.m_Accumulator.getDim2(), other.m_Accumulator.getDim3()),
+      m_Bins(other.m_Bins),
+      m_Weights(other.m_Weights),
+      m_Kernels(other.m_Kernels)
+    {}
+
+    void operator()(const tbb::blocked_range<size_t>& r)
+    {
+      splat(r.begin(), r.end());
+    }
+
+    void join(const OdfSplatImpl& rhs)
+    {
+      m_Accumulator.merge(rhs.m_Accumulator);
+    }
+#endif
+
+  private:
+    OdfAccumulator m_Accumulator;
+    const int32_t* m_Bins;
+    const T* m_Weights;
+    const OdfSmoothingKernel* const* m_Kernels;
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+template<typename T>
+void OdfAccumulator::splat(const int32_t* bins, const T* weights, const T* sigmas, size_t numEntries)
+{
+  std::map<int, OdfSmoothingKernel> kernelCache;
+  std::vector<const OdfSmoothingKernel*> kernels(numEntries, NULL);
+  for (size_t i = 0; i < numEntries; i++)
+  {
+    int sigma = static_cast<int>(sigmas[i]);
+    std::map<int, OdfSmoothingKernel>::iterator iter = kernelCache.find(sigma);
+    if (iter == kernelCache.end())
+    {
+      iter = kernelCache.insert(std::make_pair(sigma, OdfSmoothingKernel(sigma))).first;
+    }
+    kernels[i] = &(iter->second);
+  }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+  tbb::task_scheduler_init init;
+  bool doParallel = (numEntries > 1);
+  if (doParallel == true)
+  {
+    OdfSplatImpl<T> body(m_Dim1, m_Dim2, m_Dim3, bins, weights, kernels.data());
+    tbb::parallel_reduce(tbb::blocked_range<size_t>(0, numEntries), body, tbb::auto_partitioner());
+    merge(body.getAccumulator());
+  }
+  else
+#endif
+  {
+    for (size_t i = 0; i < numEntries; i++)
+    {
+      addSmoothed(bins[i], weights[i], *(kernels[i]));
+    }
+  }
+}
+
+#endif /* _odfaccumulator_h_ */
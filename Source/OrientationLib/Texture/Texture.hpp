@@ -55,6 +55,7 @@
 #include "OrientationLib/SpaceGroupOps/CubicOps.h"
 #include "OrientationLib/SpaceGroupOps/HexagonalOps.h"
 #include "OrientationLib/SpaceGroupOps/OrthoRhombicOps.h"
+#include "OrientationLib/Texture/OdfAccumulator.hpp"
 
 /**
  * @class Texture Texture.h AIM/Common/Texture.h
@@ -92,19 +93,10 @@ class Texture
                                       T* weights, T* sigmas,
                                       bool normalize, T* odf, size_t numEntries)
     {
-      SIMPL_RANDOMNG_NEW()
       CubicOps ops;
       Int32ArrayType::Pointer textureBins = Int32ArrayType::CreateArray(numEntries, "TextureBins");
       int32_t* TextureBins = textureBins->getPointer(0);
 
-      float addweight = 0;
-      float totaladdweight = 0;
-      float totalweight = float(ops.getODFSize());
-      int bin, addbin;
-      int bin1, bin2, bin3;
-      int addbin1, addbin2, addbin3;
-      float dist, fraction;
-
       for (size_t i = 0; i < numEntries; i++)
       {
         FOrientArrayType eu(e1s[i], e2s[i], e3s[i]);
@@ -112,84 +104,11 @@ class Texture
         OrientationTransforms<FOrientArrayType, float>::eu2ro(eu, rod);
 
         rod = ops.getODFFZRod(rod);
-        bin = ops.getOdfBin(rod);
-        TextureBins[i] = static_cast<int>(bin);
+        TextureBins[i] = static_cast<int32_t>(ops.getOdfBin(rod));
       }
 
-      for (int i = 0; i < ops.getODFSize(); i++)
-      {
-        odf[i] = 0;
-      }
-      for (size_t i = 0; i < numEntries; i++)
-      {
-        bin = TextureBins[i];
-        bin1 = bin % 18;
-        bin2 = (bin / 18) % 18;
-        bin3 = bin / (18 * 18);
-        for (int j = -sigmas[i]; j <= sigmas[i]; j++)
-        {
-          int jsqrd = j * j;
-          for (int k = -sigmas[i]; k <= sigmas[i]; k++)
-          {
-            int ksqrd = k * k;
-            for (int l = -sigmas[i]; l <= sigmas[i]; l++)
-            {
-              int lsqrd = l * l;
-              addbin1 = bin1 + int(j);
-              addbin2 = bin2 + int(k);
-              addbin3 = bin3 + int(l);
-              //if(addbin1 < 0) addbin1 = addbin1 + 18;
-              //if(addbin1 >= 18) addbin1 = addbin1 - 18;
-              //if(addbin2 < 0) addbin2 = addbin2 + 18;
-              //if(addbin2 >= 18) addbin2 = addbin2 - 18;
-              //if(addbin3 < 0) addbin3 = addbin3 + 18;
-              //if(addbin3 >= 18) addbin3 = addbin3 - 18;
-              int good = 1;
-              if(addbin1 < 0) { good = 0; }
-              if(addbin1 >= 18) { good = 0; }
-              if(addbin2 < 0) { good = 0; }
-              if(addbin2 >= 18) { good = 0; }
-              if(addbin3 < 0) { good = 0; }
-              if(addbin3 >= 18) { good = 0; }
-              addbin = (addbin3 * 18 * 18) + (addbin2 * 18) + (addbin1);
-              dist = powf((jsqrd + ksqrd + lsqrd), 0.5);
-              fraction = 1.0 - (double(dist / int(sigmas[i])) * double(dist / int(sigmas[i])));
-              if(dist <= int(sigmas[i]) && good == 1)
-              {
-                addweight = (weights[i] * fraction);
-                if(sigmas[i] == 0.0) { addweight = weights[i]; }
-                odf[addbin] = odf[addbin] + addweight;
-                totaladdweight = totaladdweight + addweight;
-              }
-            }
-          }
-        }
-      }
-      if(totaladdweight > totalweight)
-      {
-        float scale = (totaladdweight / totalweight);
-        for (int i = 0; i < ops.getODFSize(); i++)
-        {
-          odf[i] = odf[i] / scale;
-        }
-      }
-      else
-      {
-        float remainingweight = totalweight - totaladdweight;
-        float background = remainingweight / static_cast<float>(ops.getODFSize());
-        for (int i = 0; i < ops.getODFSize(); i++)
-        {
-          odf[i] += background;
-        }
-      }
-      if (normalize == true)
-      {
-        // Normalize the odf
-        for (int i = 0; i < ops.getODFSize(); i++)
-        {
-          odf[i] = odf[i] / totalweight;
-        }
-      }
+      OdfAccumulator accumulator(18, 18, 18);
+      SmoothODFData(accumulator, TextureBins, weights, sigmas, normalize, odf, numEntries);
     }
 
     /**
@@ -211,18 +130,10 @@ class Texture
     template<typename T>
     static void CalculateHexODFData(T* e1s, T* e2s, T* e3s, T* weights, T* sigmas, bool normalize, T* odf, size_t numEntries)
     {
-      HexagonalOps hexOps;
-      SIMPL_RANDOMNG_NEW()
+      HexagonalOps ops;
       Int32ArrayType::Pointer textureBins = Int32ArrayType::CreateArray(numEntries, "TextureBins");
       int32_t* TextureBins = textureBins->getPointer(0);
-      float addweight = 0;
-      float totaladdweight = 0;
-      float totalweight = float(hexOps.getODFSize());
-      int bin, addbin;
-      int bin1, bin2, bin3;
-      int addbin1, addbin2, addbin3;
-      float dist, fraction;
-      HexagonalOps ops;
+
       for (size_t i = 0; i < numEntries; i++)
       {
         FOrientArrayType eu(e1s[i], e2s[i], e3s[i]);
@@ -230,84 +141,11 @@ class Texture
         OrientationTransforms<FOrientArrayType, float>::eu2ro(eu, rod);
 
         rod = ops.getODFFZRod(rod);
-        bin = ops.getOdfBin(rod);
-        TextureBins[i] = static_cast<int>(bin);
+        TextureBins[i] = static_cast<int32_t>(ops.getOdfBin(rod));
       }
 
-      for (int i = 0; i < hexOps.getODFSize(); i++)
-      {
-        odf[i] = 0;
-      }
-      for (size_t i = 0; i < numEntries; i++)
-      {
-        bin = TextureBins[i];
-        bin1 = bin % 36;
-        bin2 = (bin / 36) % 36;
-        bin3 = bin / (36 * 36);
-        for (int j = -sigmas[i]; j <= sigmas[i]; j++)
-        {
-          int jsqrd = j * j;
-          for (int k = -sigmas[i]; k <= sigmas[i]; k++)
-          {
-            int ksqrd = k * k;
-            for (int l = -sigmas[i]; l <= sigmas[i]; l++)
-            {
-              int lsqrd = l * l;
-              addbin1 = bin1 + int(j);
-              addbin2 = bin2 + int(k);
-              addbin3 = bin3 + int(l);
-              //if(addbin1 < 0) addbin1 = addbin1 + 36;
-              //if(addbin1 >= 36) addbin1 = addbin1 - 36;
-              //if(addbin2 < 0) addbin2 = addbin2 + 36;
-              //if(addbin2 >= 36) addbin2 = addbin2 - 36;
-              //if(addbin3 < 0) addbin3 = addbin3 + 12;
-              //if(addbin3 >= 12) addbin3 = addbin3 - 12;
-              int good = 1;
-              if(addbin1 < 0) { good = 0; }
-              if(addbin1 >= 36) { good = 0; }
-              if(addbin2 < 0) { good = 0; }
-              if(addbin2 >= 36) { good = 0; }
-              if(addbin3 < 0) { good = 0; }
-              if(addbin3 >= 12) { good = 0; }
-              addbin = (addbin3 * 36 * 36) + (addbin2 * 36) + (addbin1);
-              dist = powf((jsqrd + ksqrd + lsqrd), 0.5);
-              fraction = 1.0 - (double(dist / int(sigmas[i])) * double(dist / int(sigmas[i])));
-              if(dist <= int(sigmas[i]) && good == 1)
-              {
-                addweight = (weights[i] * fraction);
-                if(sigmas[i] == 0.0) { addweight = weights[i]; }
-                odf[addbin] = odf[addbin] + addweight;
-                totaladdweight = totaladdweight + addweight;
-              }
-            }
-          }
-        }
-      }
-      if (totaladdweight > totalweight)
-      {
-        float scale = (totaladdweight / totalweight);
-        for (int i = 0; i < ops.getODFSize(); i++)
-        {
-          odf[i] = odf[i] / scale;
-        }
-      }
-      else
-      {
-        float remainingweight = totalweight - totaladdweight;
-        float background = remainingweight / static_cast<float>(ops.getODFSize());
-        for (int i = 0; i < ops.getODFSize(); i++)
-        {
-          odf[i] += background;
-        }
-      }
-      if (normalize == true)
-      {
-        // Normalize the odf
-        for (int i = 0; i < ops.getODFSize(); i++)
-        {
-          odf[i] = odf[i] / totalweight;
-        }
-      }
+      OdfAccumulator accumulator(36, 36, 12);
+      SmoothODFData(accumulator, TextureBins, weights, sigmas, normalize, odf, numEntries);
     }
 
     /**
@@ -330,16 +168,9 @@ class Texture
     static void CalculateOrthoRhombicODFData(T* e1s, T* e2s, T* e3s, T* weights, T* sigmas, bool normalize, T* odf, size_t numEntries)
     {
       OrthoRhombicOps ops;
-      SIMPL_RANDOMNG_NEW()
       Int32ArrayType::Pointer textureBins = Int32ArrayType::CreateArray(numEntries, "TextureBins");
       int32_t* TextureBins = textureBins->getPointer(0);
-      float addweight = 0;
-      float totaladdweight = 0;
-      float totalweight = float(ops.getODFSize());
-      int bin, addbin;
-      int bin1, bin2, bin3;
-      int addbin1, addbin2, addbin3;
-      float dist, fraction;
+
       for (size_t i = 0; i < numEntries; i++)
       {
         FOrientArrayType eu(e1s[i], e2s[i], e3s[i]);
@@ -347,84 +178,11 @@ class Texture
         OrientationTransforms<FOrientArrayType, float>::eu2ro(eu, rod);
 
         rod = ops.getODFFZRod(rod);
-        bin = ops.getOdfBin(rod);
-        TextureBins[i] = static_cast<int>(bin);
+        TextureBins[i] = static_cast<int32_t>(ops.getOdfBin(rod));
       }
 
-      for (int i = 0; i < ops.getODFSize(); i++)
-      {
-        odf[i] = 0;
-      }
-      for (size_t i = 0; i < numEntries; i++)
-      {
-        bin = TextureBins[i];
-        bin1 = bin % 36;
-        bin2 = (bin / 36) % 36;
-        bin3 = bin / (36 * 36);
-        for (int j = -sigmas[i]; j <= sigmas[i]; j++)
-        {
-          int jsqrd = j * j;
-          for (int k = -sigmas[i]; k <= sigmas[i]; k++)
-          {
-            int ksqrd = k * k;
-            for (int l = -sigmas[i]; l <= sigmas[i]; l++)
-            {
-              int lsqrd = l * l;
-              addbin1 = bin1 + int(j);
-              addbin2 = bin2 + int(k);
-              addbin3 = bin3 + int(l);
-              //if (addbin1 < 0) addbin1 = addbin1 + 36;
-              //if (addbin1 >= 36) addbin1 = addbin1 - 36;
-              //if (addbin2 < 0) addbin2 = addbin2 + 36;
-              //if (addbin2 >= 36) addbin2 = addbin2 - 36;
-              //if (addbin3 < 0) addbin3 = addbin3 + 36;
-              //if (addbin3 >= 36) addbin3 = addbin3 - 36;
-              int good = 1;
-              if (addbin1 < 0) { good = 0; }
-              if (addbin1 >= 36) { good = 0; }
-              if (addbin2 < 0) { good = 0; }
-              if (addbin2 >= 36) { good = 0; }
-              if (addbin3 < 0) { good = 0; }
-              if (addbin3 >= 36) { good = 0; }
-              addbin = (addbin3 * 36 * 36) + (addbin2 * 36) + (addbin1);
-              dist = sqrtf(jsqrd + ksqrd + lsqrd);
-              fraction = 1.0 - (float(dist / int(sigmas[i])) * float(dist / int(sigmas[i])));
-              if (dist <= int(sigmas[i]) && good == 1)
-              {
-                addweight = (weights[i] * fraction);
-                if(sigmas[i] == 0.0) { addweight = weights[i]; }
-                odf[addbin] = odf[addbin] + addweight;
-                totaladdweight = totaladdweight + addweight;
-              }
-            }
-          }
-        }
-      }
-      if (totaladdweight > totalweight)
-      {
-        float scale = (totaladdweight / totalweight);
-        for (int i = 0; i < ops.getODFSize(); i++)
-        {
-          odf[i] = odf[i] / scale;
-        }
-      }
-      else
-      {
-        float remainingweight = totalweight - totaladdweight;
-        float background = remainingweight / static_cast<float>(ops.getODFSize());
-        for (int i = 0; i < ops.getODFSize(); i++)
-        {
-          odf[i] += background;
-        }
-      }
-      if (normalize == true)
-      {
-        // Normalize the odf
-        for (int i = 0; i < ops.getODFSize(); i++)
-        {
-          odf[i] = odf[i] / totalweight;
-        }
-      }
+      OdfAccumulator accumulator(36, 36, 36);
+      SmoothODFData(accumulator, TextureBins, weights, sigmas, normalize, odf, numEntries);
     }
 
     /**
@@ -527,6 +285,55 @@ class Texture
   protected:
     Texture() {}
 
+    /**
+     * @brief SmoothODFData Splats each texture component into the accumulator using a precomputed
+     * stencil for its sigma, then either rescales the ODF so it sums to the number of bins or
+     * fills the remaining weight in as a uniform background.
+     * @param accumulator An empty accumulator sized to the ODF grid of the crystal structure
+     * @param textureBins The ODF bin of each texture component
+     * @param weights Pointer to the Array of weights values.
+     * @param sigmas Pointer to the Array of sigma values.
+     * @param normalize Should the ODF data be normalized by the totalWeight value
+     * before returning.
+     * @param odf (OUT) Pointer to the preallocated ODF array
+     * @param numEntries The number of entries of Bins/Weight/Sigmas
+     */
+    template<typename T>
+    static void SmoothODFData(OdfAccumulator& accumulator, int32_t* textureBins, T* weights, T* sigmas, bool normalize, T* odf, size_t numEntries)
+    {
+      accumulator.splat(textureBins, weights, sigmas, numEntries);
+      accumulator.copyTo(odf);
+
+      const size_t odfSize = accumulator.getSize();
+      float totaladdweight = static_cast<float>(accumulator.getTotalWeight());
+      float totalweight = static_cast<float>(odfSize);
+      if (totaladdweight > totalweight)
+      {
+        float scale = (totaladdweight / totalweight);
+        for (size_t i = 0; i < odfSize; i++)
+        {
+          odf[i] = odf[i] / scale;
+        }
+      }
+      else
+      {
+        float remainingweight = totalweight - totaladdweight;
+        float background = remainingweight / totalweight;
+        for (size_t i = 0; i < odfSize; i++)
+        {
+          odf[i] += background;
+        }
+      }
+      if (normalize == true)
+      {
+        // Normalize the odf
+        for (size_t i = 0; i < odfSize; i++)
+        {
+          odf[i] = odf[i] / totalweight;
+        }
+      }
+    }
+
   private:
     Texture(const Texture&); // Copy Constructor Not Implemented
     void operator=(const Texture&); // Operator '=' Not Implemented
@@ -36,14 +36,201 @@
 
 #include "ModifiedLambertProjection.h"
 
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
 #include <QtCore/QSet>
 
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
 
 #include "SIMPLib/Math/SIMPLibMath.h"
 #include "SIMPLib/Math/MatrixMath.h"
 
 #define WRITE_LAMBERT_SQUARE_COORD_VTK 0
 
+namespace
+{
+  // Number of directions that CreateProjectionFromXYZCoords projects per batch
+  const size_t k_ProjectionBatchSize = 65536;
+
+  /**
+   * @brief ComputeInterpolationBins Computes the 4 bins (with the wrap around rules at the edges of the square)
+   * and the fractional offsets that are used to bilinearly spread a value at the given square coordinate.
+   * @param sqCoord The XY coordinate in the Modified Lambert Square
+   * @param dimension The number of bins along each edge of the square
+   * @param stepSize The edge length of a single bin
+   * @param halfDimTimesStepSize Half of the edge length of the square
+   * @param index [output] The 4 bin indices
+   * @param modX [output] The fractional offset along X
+   * @param modY [output] The fractional offset along Y
+   */
+  inline void ComputeInterpolationBins(const float* sqCoord, int dimension, float stepSize, float halfDimTimesStepSize,
+                                       int* index, float& modX, float& modY)
+  {
+    modX = (sqCoord[0] + halfDimTimesStepSize) / stepSize;
+    modY = (sqCoord[1] + halfDimTimesStepSize) / stepSize;
+    int abin = (int) modX;
+    int bbin = (int) modY;
+    modX -= abin;
+    modY -= bbin;
+    modX -= 0.5;
+    modY -= 0.5;
+    int abinSign = (modX < 0.0f) ? -1 : 1;
+    int bbinSign = (modY < 0.0f) ? -1 : 1;
+
+    int abin2 = abin + abinSign;
+    int bbin2 = bbin;
+    if(abin2 < 0 || abin2 > dimension - 1)
+    {
+      abin2 = abin2 - (abinSign * dimension), bbin2 = dimension - bbin2 - 1;
+    }
+    int abin3 = abin;
+    int bbin3 = bbin + bbinSign;
+    if(bbin3 < 0 || bbin3 > dimension - 1)
+    {
+      abin3 = dimension - abin3 - 1, bbin3 = bbin3 - (bbinSign * dimension);
+    }
+    int abin4 = abin + abinSign;
+    int bbin4 = bbin + bbinSign;
+    bool aOutside = (abin4 < 0 || abin4 > dimension - 1);
+    bool bOutside = (bbin4 < 0 || bbin4 > dimension - 1);
+    if(aOutside && !bOutside)
+    {
+      abin4 = abin4 - (abinSign * dimension), bbin4 = dimension - bbin4 - 1;
+    }
+    else if(!aOutside && bOutside)
+    {
+      abin4 = dimension - abin4 - 1, bbin4 = bbin4 - (bbinSign * dimension);
+    }
+    else if(aOutside && bOutside)
+    {
+      abin4 = abin4 - (abinSign * dimension), bbin4 = bbin4 - (bbinSign * dimension);
+    }
+    modX = fabsf(modX);
+    modY = fabsf(modY);
+
+    index[0] = bbin * dimension + abin;
+    index[1] = bbin2 * dimension + abin2;
+    index[2] = bbin3 * dimension + abin3;
+    index[3] = bbin4 * dimension + abin4;
+  }
+
+  /**
+   * @brief FastAtanUnit Polynomial approximation of atan(x) for |x| <= 1 (Abramowitz & Stegun 4.4.49).
+   * The absolute error is below 2E-8 which is well under the precision of a float.
+   */
+  inline float FastAtanUnit(float x)
+  {
+    const float x2 = x * x;
+    return x * (0.9999993329f + x2 * (-0.3332985605f + x2 * (0.1994653599f + x2 * (-0.1390853351f
+                + x2 * (0.0964200441f + x2 * (-0.0559098861f + x2 * (0.0218612288f + x2 * -0.0040540580f)))))));
+  }
+
+  /**
+   * @brief The ProjectDirectionsImpl class maps a range of XYZ directions onto the Modified Lambert squares and
+   * computes the 4 bins and bilinear weights for each of them. Each direction only touches its own output slots
+   * so ranges can be processed in parallel.
+   */
+  class ProjectDirectionsImpl
+  {
+    public:
+      ProjectDirectionsImpl(const float* xyz, int dimension, float stepSize, float sphereRadius, float maxCoord,
+                            int* northIdx, int* southIdx, float* weights) :
+        m_XYZ(xyz),
+        m_Dimension(dimension),
+        m_StepSize(stepSize),
+        m_SphereRadius(sphereRadius),
+        m_MaxCoord(maxCoord),
+        m_NorthIdx(northIdx),
+        m_SouthIdx(southIdx),
+        m_Weights(weights)
+      {}
+      virtual ~ProjectDirectionsImpl() {}
+
+      void project(size_t start, size_t end) const
+      {
+        const float halfDimTimesStepSize = static_cast<float>(m_Dimension) / 2.0f * m_StepSize;
+        const float maxCoord = m_MaxCoord - 0.0001f;
+        const float twoR = 2.0f * m_SphereRadius;
+        float sqCoord[2] = { 0.0f, 0.0f };
+        int index[4] = { 0, 0, 0, 0 };
+        float modX = 0.0f, modY = 0.0f;
+
+        for (size_t i = start; i < end; i++)
+        {
+          const float x = m_XYZ[i * 3];
+          const float y = m_XYZ[i * 3 + 1];
+          const float z = m_XYZ[i * 3 + 2];
+          const float ax = fabsf(x);
+          const float ay = fabsf(y);
+          // Both hemispheres use the distance from their own pole, R - |z|
+          const float rho = sqrtf(twoR * (m_SphereRadius - fabsf(z)));
+          if (ax >= ay && ax > 0.0f)
+          {
+            const float s = copysignf(rho, x);
+            sqCoord[0] = s * SIMPLib::Constants::k_HalfOfSqrtPi;
+            sqCoord[1] = s * SIMPLib::Constants::k_2OverSqrtPi * FastAtanUnit(y / x);
+          }
+          else if (ay > 0.0f)
+          {
+            const float s = copysignf(rho, y);
+            sqCoord[0] = s * SIMPLib::Constants::k_2OverSqrtPi * FastAtanUnit(x / y);
+            sqCoord[1] = s * SIMPLib::Constants::k_HalfOfSqrtPi;
+          }
+          else
+          {
+            sqCoord[0] = 0.0f;
+            sqCoord[1] = 0.0f;
+          }
+          sqCoord[0] = std::min(sqCoord[0], maxCoord);
+          sqCoord[1] = std::min(sqCoord[1], maxCoord);
+
+          ComputeInterpolationBins(sqCoord, m_Dimension, m_StepSize, halfDimTimesStepSize, index, modX, modY);
+
+          int* hit = m_NorthIdx + i * 4;
+          int* miss = m_SouthIdx + i * 4;
+          if (z < 0.0f) { std::swap(hit, miss); }
+          for (int b = 0; b < 4; b++)
+          {
+            hit[b] = index[b];
+            miss[b] = -1;
+          }
+          if (NULL != m_Weights)
+          {
+            float* w = m_Weights + i * 4;
+            w[0] = (1.0f - modX) * (1.0f - modY);
+            w[1] = modX * (1.0f - modY);
+            w[2] = (1.0f - modX) * modY;
+            w[3] = modX * modY;
+          }
+        }
+      }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+      void operator()(const tbb::blocked_range<size_t>& r) const
+      {
+        project(r.begin(), r.end());
+      }
+#endif
+
+    private:
+      const float* m_XYZ;
+      int m_Dimension;
+      float m_StepSize;
+      float m_SphereRadius;
+      float m_MaxCoord;
+      int* m_NorthIdx;
+      int* m_SouthIdx;
+      float* m_Weights;
+  };
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -72,13 +259,9 @@ ModifiedLambertProjection::Pointer ModifiedLambertProjection::CreateProjectionFr
 {
 
   size_t npoints = coords->getNumberOfTuples();
-  bool nhCheck = false;
-  float sqCoord[2];
-  //int sqIndex = 0;
   ModifiedLambertProjection::Pointer squareProj = ModifiedLambertProjection::New();
   squareProj->initializeSquares(dimension, sphereRadius);
 
-
 #if WRITE_LAMBERT_SQUARE_COORD_VTK
   QString ss;
   QString filename("/tmp/");
@@ -99,37 +282,27 @@ ModifiedLambertProjection::Pointer ModifiedLambertProjection::CreateProjectionFr
   fprintf(f, "\n");
 
   fprintf(f, "DATASET UNSTRUCTURED_GRID\nPOINTS %lu float\n", coords->getNumberOfTuples() );
-#endif
-
+  float sqCoord[2];
   for(size_t i = 0; i < npoints; ++i)
   {
-    sqCoord[0] = 0.0;
-    sqCoord[1] = 0.0;
-    //get coordinates in square projection of crystal normal parallel to boundary normal
-    nhCheck = squareProj->getSquareCoord(coords->getPointer(i * 3), sqCoord);
-#if WRITE_LAMBERT_SQUARE_COORD_VTK
+    squareProj->getSquareCoord(coords->getPointer(i * 3), sqCoord);
     fprintf(f, "%f %f 0\n", sqCoord[0], sqCoord[1]);
-#endif
-
-    // Based on the XY coordinate, get the pointer index that the value corresponds to in the proper square
-//    sqIndex = squareProj->getSquareIndex(sqCoord);
-    if (nhCheck == true)
-    {
-      //north increment by 1
-//      squareProj->addValue(ModifiedLambertProjection::NorthSquare, sqIndex, 1.0);
-      squareProj->addInterpolatedValues(ModifiedLambertProjection::NorthSquare, sqCoord, 1.0);
-    }
-    else
-    {
-      // south increment by 1
-//      squareProj->addValue(ModifiedLambertProjection::SouthSquare, sqIndex, 1.0);
-      squareProj->addInterpolatedValues(ModifiedLambertProjection::SouthSquare, sqCoord, 1.0);
-    }
   }
-#if WRITE_LAMBERT_SQUARE_COORD_VTK
   fclose(f);
 #endif
 
+  // Project the directions in batches so the bin/weight scratch space stays bounded
+  size_t batchSize = std::min(npoints, k_ProjectionBatchSize);
+  std::vector<int> northIdx(batchSize * 4);
+  std::vector<int> southIdx(batchSize * 4);
+  std::vector<float> weights(batchSize * 4);
+  for(size_t start = 0; start < npoints; start += batchSize)
+  {
+    size_t count = std::min(batchSize, npoints - start);
+    squareProj->projectDirections(coords->getPointer(start * 3), count, &(northIdx.front()), &(southIdx.front()), &(weights.front()));
+    squareProj->addProjectedValues(&(northIdx.front()), &(southIdx.front()), &(weights.front()), count, 1.0);
+  }
+
   return squareProj;
 }
 
@@ -185,91 +358,59 @@ int ModifiedLambertProjection::readHDF5Data(hid_t groupId)
 // -----------------------------------------------------------------------------
 void ModifiedLambertProjection::addInterpolatedValues(Square square, float* sqCoord, double value)
 {
-  int abin1 = 0, bbin1 = 0;
-  int abin2 = 0, bbin2 = 0;
-  int abin3 = 0, bbin3 = 0;
-  int abin4 = 0, bbin4 = 0;
-  int abinSign, bbinSign;
-  float modX = (sqCoord[0] + m_HalfDimensionTimesStepSize ) / m_StepSize;
-  float modY = (sqCoord[1] + m_HalfDimensionTimesStepSize ) / m_StepSize;
-  int abin = (int) modX;
-  int bbin = (int) modY;
-  modX -= abin;
-  modY -= bbin;
-  modX -= 0.5;
-  modY -= 0.5;
-  if(modX == 0.0)
+  int index[4] = { 0, 0, 0, 0 };
+  float modX = 0.0f;
+  float modY = 0.0f;
+  ComputeInterpolationBins(sqCoord, m_Dimension, m_StepSize, m_HalfDimensionTimesStepSize, index, modX, modY);
+
+  double* values = (square == NorthSquare) ? m_NorthSquare->getPointer(0) : m_SouthSquare->getPointer(0);
+  values[index[0]] += value * (1.0 - modX) * (1.0 - modY);
+  values[index[1]] += value * (modX) * (1.0 - modY);
+  values[index[2]] += value * (1.0 - modX) * (modY);
+  values[index[3]] += value * (modX) * (modY);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ModifiedLambertProjection::projectDirections(const float* xyz, size_t n, int* northIdx, int* southIdx, float* weights)
+{
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+  tbb::task_scheduler_init init;
+  bool doParallel = true;
+#endif
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+  if (doParallel == true)
   {
-    abinSign = 1;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, n),
+                      ProjectDirectionsImpl(xyz, m_Dimension, m_StepSize, m_SphereRadius, m_MaxCoord, northIdx, southIdx, weights), tbb::auto_partitioner());
   }
   else
+#endif
   {
-    abinSign = modX / fabs(modX);
-  }
-  if(modY == 0.0)
-  {
-    bbinSign = 1;
-  }
-  else
-  {
-    bbinSign = modY / fabs(modY);
-  }
-  abin1 = abin;
-  bbin1 = bbin;
-  abin2 = abin + abinSign;
-  bbin2 = bbin;
-  if(abin2 < 0 || abin2 > m_Dimension - 1)
-  {
-    abin2 = abin2 - (abinSign * m_Dimension), bbin2 = m_Dimension - bbin2 - 1;
-  }
-  abin3 = abin;
-  bbin3 = bbin + bbinSign;
-  if(bbin3 < 0 || bbin3 > m_Dimension - 1)
-  {
-    abin3 = m_Dimension - abin3 - 1, bbin3 = bbin3 - (bbinSign * m_Dimension);
-  }
-  abin4 = abin + abinSign;
-  bbin4 = bbin + bbinSign;
-  if((abin4 < 0 || abin4 > m_Dimension - 1) && (bbin4 >= 0 && bbin4 <= m_Dimension - 1))
-  {
-    abin4 = abin4 - (abinSign * m_Dimension), bbin4 = m_Dimension - bbin4 - 1;
-  }
-  else if((abin4 >= 0 && abin4 <= m_Dimension - 1) && (bbin4 < 0 || bbin4 > m_Dimension - 1))
-  {
-    abin4 = m_Dimension - abin4 - 1, bbin4 = bbin4 - (bbinSign * m_Dimension);
-  }
-  else if((abin4 < 0 || abin4 > m_Dimension - 1) && (bbin4 < 0 || bbin4 > m_Dimension - 1))
-  {
-    abin4 = abin4 - (abinSign * m_Dimension), bbin4 = bbin4 - (bbinSign * m_Dimension);
+    ProjectDirectionsImpl serial(xyz, m_Dimension, m_StepSize, m_SphereRadius, m_MaxCoord, northIdx, southIdx, weights);
+    serial.project(0, n);
   }
-  modX = fabs(modX);
-  modY = fabs(modY);
+}
 
-  int index1 = bbin1 * m_Dimension + abin1;
-  int index2 = bbin2 * m_Dimension + abin2;
-  int index3 = bbin3 * m_Dimension + abin3;
-  int index4 = bbin4 * m_Dimension + abin4;
-  if (square == NorthSquare)
-  {
-    double v1 = m_NorthSquare->getValue(index1) + value * (1.0 - modX) * (1.0 - modY);
-    double v2 = m_NorthSquare->getValue(index2) + value * (modX) * (1.0 - modY);
-    double v3 = m_NorthSquare->getValue(index3) + value * (1.0 - modX) * (modY);
-    double v4 = m_NorthSquare->getValue(index4) + value * (modX) * (modY);
-    m_NorthSquare->setValue(index1, v1);
-    m_NorthSquare->setValue(index2, v2);
-    m_NorthSquare->setValue(index3, v3);
-    m_NorthSquare->setValue(index4, v4);
-  }
-  else
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ModifiedLambertProjection::addProjectedValues(const int* northIdx, const int* southIdx, const float* weights, size_t n, double value)
+{
+  double* north = m_NorthSquare->getPointer(0);
+  double* south = m_SouthSquare->getPointer(0);
+  for (size_t i = 0; i < n * 4; i++)
   {
-    double v1 = m_SouthSquare->getValue(index1) + value * (1.0 - modX) * (1.0 - modY);
-    double v2 = m_SouthSquare->getValue(index2) + value * (modX) * (1.0 - modY);
-    double v3 = m_SouthSquare->getValue(index3) + value * (1.0 - modX) * (modY);
-    double v4 = m_SouthSquare->getValue(index4) + value * (modX) * (modY);
-    m_SouthSquare->setValue(index1, v1);
-    m_SouthSquare->setValue(index2, v2);
-    m_SouthSquare->setValue(index3, v3);
-    m_SouthSquare->setValue(index4, v4);
+    if (northIdx[i] >= 0)
+    {
+      north[northIdx[i]] += value * weights[i];
+    }
+    else
+    {
+      south[southIdx[i]] += value * weights[i];
+    }
   }
 }
 
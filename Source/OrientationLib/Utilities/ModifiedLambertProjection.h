@@ -106,6 +106,31 @@ class OrientationLib_EXPORT ModifiedLambertProjection
      */
     void addInterpolatedValues(Square square, float* sqCoord, double value);
 
+    /**
+     * @brief projectDirections Maps a batch of XYZ directions onto the Modified Lambert squares. For each direction
+     * the 4 bins used for bilinear interpolation are written to the square of the hemisphere the direction lies in
+     * while the 4 entries for the other square are set to -1. This produces the same bins as getSquareCoord followed
+     * by addInterpolatedValues but the directions are processed in parallel without any per sample allocation. As in
+     * getSquareCoord, coordinates on the upper edges of the square are clamped into the last bin and the poles
+     * (x = y = 0) are mapped to the center of the square, so every direction lands in a valid bin.
+     * @param xyz The XYZ coordinates (3 floats per direction) on the sphere
+     * @param n The number of directions
+     * @param northIdx [output] 4 * n bin indices into the north square (-1 if the direction is in the south)
+     * @param southIdx [output] 4 * n bin indices into the south square (-1 if the direction is in the north)
+     * @param weights [output] 4 * n bilinear weights. May be NULL if only the bins are needed.
+     */
+    void projectDirections(const float* xyz, size_t n, int* northIdx, int* southIdx, float* weights);
+
+    /**
+     * @brief addProjectedValues Accumulates the bins and weights produced by projectDirections into the squares.
+     * @param northIdx The north square bins from projectDirections
+     * @param southIdx The south square bins from projectDirections
+     * @param weights The bilinear weights from projectDirections
+     * @param n The number of directions
+     * @param value The value that is spread over the 4 bins of each direction
+     */
+    void addProjectedValues(const int* northIdx, const int* southIdx, const float* weights, size_t n, double value);
+
     /**
      * @brief addValue
      * @param square
@@ -45,6 +45,7 @@
 
 #include "Generic/GenericConstants.h"
 #include "Generic/GenericVersion.h"
+#include "Generic/GenericFilters/util/FeatureReductionEngine.hpp"
 
 // Include the MOC generated file for this class
 #include "moc_FindSurfaceFeatures.cpp"
@@ -149,90 +150,15 @@ void FindSurfaceFeatures::find_surfacefeatures()
 {
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getFeatureIdsArrayPath().getDataContainerName());
 
-  int64_t xPoints = static_cast<int64_t>(m->getGeometryAs<ImageGeom>()->getXPoints());
-  int64_t yPoints = static_cast<int64_t>(m->getGeometryAs<ImageGeom>()->getYPoints());
-  int64_t zPoints = static_cast<int64_t>(m->getGeometryAs<ImageGeom>()->getZPoints());
+  size_t totalFeatures = m_SurfaceFeaturesPtr.lock()->getNumberOfTuples();
+  size_t dims[3] = { m->getGeometryAs<ImageGeom>()->getXPoints(), m->getGeometryAs<ImageGeom>()->getYPoints(), m->getGeometryAs<ImageGeom>()->getZPoints() };
 
-  int64_t zStride = 0, yStride = 0;
-  for (int64_t i = 0; i < zPoints; i++)
-  {
-    zStride = i * xPoints * yPoints;
-    for (int64_t j = 0; j < yPoints; j++)
-    {
-      yStride = j * xPoints;
-      for (int64_t k = 0; k < xPoints; k++)
-      {
-        int32_t gnum = m_FeatureIds[zStride + yStride + k];
-        if( m_SurfaceFeatures[gnum] == false)
-        {
-          if (k <= 0) { m_SurfaceFeatures[gnum] = true; }
-          if (k >= xPoints - 1) { m_SurfaceFeatures[gnum] = true; }
-          if (j <= 0) { m_SurfaceFeatures[gnum] = true; }
-          if (j >= yPoints - 1) { m_SurfaceFeatures[gnum] = true; }
-          if (i <= 0) { m_SurfaceFeatures[gnum] = true; }
-          if (i >= zPoints - 1) { m_SurfaceFeatures[gnum] = true; }
-          if (m_SurfaceFeatures[gnum] == false)
-          {
-            if (m_FeatureIds[zStride + yStride + k - 1] == 0) { m_SurfaceFeatures[gnum] = true; }
-            if (m_FeatureIds[zStride + yStride + k + 1] == 0) { m_SurfaceFeatures[gnum] = true; }
-            if (m_FeatureIds[zStride + yStride + k - xPoints] == 0) { m_SurfaceFeatures[gnum] = true; }
-            if (m_FeatureIds[zStride + yStride + k + xPoints] == 0) { m_SurfaceFeatures[gnum] = true; }
-            if (m_FeatureIds[zStride + yStride + k - (xPoints * yPoints)] == 0) { m_SurfaceFeatures[gnum] = true; }
-            if (m_FeatureIds[zStride + yStride + k + (xPoints * yPoints)] == 0) { m_SurfaceFeatures[gnum] = true; }
-          }
-        }
-      }
-    }
-  }
-}
-
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
-void FindSurfaceFeatures::find_surfacefeatures2D()
-{
-  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getFeatureIdsArrayPath().getDataContainerName());
-
-  int64_t xPoints = 0, yPoints = 0;
+  // axes with a single cell are skipped by the engine, so a 2D area is handled in its own plane
+  FeatureReductionEngine::Pointer engine = FeatureReductionEngine::Compute(m_FeatureIds, dims, totalFeatures);
 
-  if (m->getGeometryAs<ImageGeom>()->getXPoints() == 1)
+  for (size_t i = 0; i < totalFeatures; i++)
   {
-    xPoints = static_cast<int64_t>(m->getGeometryAs<ImageGeom>()->getYPoints());
-    yPoints = static_cast<int64_t>(m->getGeometryAs<ImageGeom>()->getZPoints());
-  }
-  if (m->getGeometryAs<ImageGeom>()->getYPoints() == 1)
-  {
-    xPoints = static_cast<int64_t>(m->getGeometryAs<ImageGeom>()->getXPoints());
-    yPoints = static_cast<int64_t>(m->getGeometryAs<ImageGeom>()->getZPoints());
-  }
-  if (m->getGeometryAs<ImageGeom>()->getZPoints() == 1)
-  {
-    xPoints = static_cast<int64_t>(m->getGeometryAs<ImageGeom>()->getXPoints());
-    yPoints = static_cast<int64_t>(m->getGeometryAs<ImageGeom>()->getYPoints());
-  }
-
-  int64_t yStride;
-  for (int64_t j = 0; j < yPoints; j++)
-  {
-    yStride = j * xPoints;
-    for (int64_t k = 0; k < xPoints; k++)
-    {
-      int32_t gnum = m_FeatureIds[yStride + k];
-      if (m_SurfaceFeatures[gnum] == false)
-      {
-        if (k <= 0) { m_SurfaceFeatures[gnum] = true; }
-        if (k >= xPoints - 1) { m_SurfaceFeatures[gnum] = true; }
-        if (j <= 0) { m_SurfaceFeatures[gnum] = true; }
-        if (j >= yPoints - 1) { m_SurfaceFeatures[gnum] = true; }
-        if (m_SurfaceFeatures[gnum] == false)
-        {
-          if (m_FeatureIds[yStride + k - 1] == 0) { m_SurfaceFeatures[gnum] = true; }
-          if (m_FeatureIds[yStride + k + 1] == 0) { m_SurfaceFeatures[gnum] = true; }
-          if (m_FeatureIds[yStride + k - static_cast<int64_t>(m->getGeometryAs<ImageGeom>()->getXPoints())] == 0) { m_SurfaceFeatures[gnum] = true; }
-          if (m_FeatureIds[yStride + k + static_cast<int64_t>(m->getGeometryAs<ImageGeom>()->getXPoints())] == 0) { m_SurfaceFeatures[gnum] = true; }
-        }
-      }
-    }
+    if (engine->isSurfaceFeature(i) == true) { m_SurfaceFeatures[i] = true; }
   }
 }
 
@@ -245,10 +171,7 @@ void FindSurfaceFeatures::execute()
   dataCheck();
   if(getErrorCondition() < 0) { return; }
 
-  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getFeatureIdsArrayPath().getDataContainerName());
-
-  if(m->getGeometryAs<ImageGeom>()->getXPoints() > 1 && m->getGeometryAs<ImageGeom>()->getYPoints() > 1 && m->getGeometryAs<ImageGeom>()->getZPoints() > 1) { find_surfacefeatures(); }
-  if(m->getGeometryAs<ImageGeom>()->getXPoints() == 1 || m->getGeometryAs<ImageGeom>()->getYPoints() == 1 || m->getGeometryAs<ImageGeom>()->getZPoints() == 1) { find_surfacefeatures2D(); }
+  find_surfacefeatures();
 
   notifyStatusMessage(getHumanLabel(), "Complete");
 }
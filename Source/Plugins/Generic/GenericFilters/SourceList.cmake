@@ -55,6 +55,11 @@ endforeach()
 
 
 
+#-------------
+# These are files that need to be compiled into DREAM3DLib but are NOT filters
+ADD_SIMPL_SUPPORT_HEADER_SUBDIR(${Generic_SOURCE_DIR} ${_filterGroupName} FeatureReductionEngine.hpp util)
+
+
 #---------------------
 # This macro must come last after we are done adding all the filters and support files.
 SIMPL_END_FILTER_GROUP(${Generic_BINARY_DIR} "${_filterGroupName}" "Generic")
@@ -0,0 +1,541 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#ifndef _featurereductionengine_hpp_
+#define _featurereductionengine_hpp_
+
+#include <algorithm>
+#include <vector>
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/Common/SIMPLibSetGetMacros.h"
+
+/**
+ * @class FeatureReductionEngine FeatureReductionEngine.hpp Generic/GenericFilters/util/FeatureReductionEngine.hpp
+ * @brief Computes the per-Feature morphology quantities of an image geometry in a single sweep of the FeatureIds.
+ *
+ * One pass over the cells accumulates, for every Feature, the voxel count, the first and second order sums of the
+ * voxel indices, the voxel bounding box, the number of boundary faces normal to each axis, whether the Feature
+ * touches the outer surface of the volume or a cell with Feature Id 0, and optionally the sum of one scalar cell
+ * array. Everything geometric is kept in voxel index units as exact integers, so the result does not depend on
+ * the resolution and the rows of the volume can be split between threads, each filling its own partial
+ * accumulators, without changing the merged result.
+ */
+class FeatureReductionEngine
+{
+  public:
+    SIMPL_SHARED_POINTERS(FeatureReductionEngine)
+
+    /**
+     * @brief FeatureReductionEngine
+     * @param featureIds Feature Id of every cell, x fastest
+     * @param dims Number of cells along x, y and z
+     * @param numFeatures Number of Features (tuples of the Feature Attribute Matrix); Ids outside [0, numFeatures) are skipped
+     */
+    FeatureReductionEngine(const int32_t* featureIds, const size_t dims[3], size_t numFeatures) :
+      m_FeatureIds(featureIds),
+      m_NumFeatures(static_cast<int64_t>(numFeatures)),
+      m_Scalars(NULL),
+      m_ReadScalar(NULL),
+      m_NumPartials(0)
+    {
+      m_Dims[0] = static_cast<int64_t>(dims[0]);
+      m_Dims[1] = static_cast<int64_t>(dims[1]);
+      m_Dims[2] = static_cast<int64_t>(dims[2]);
+    }
+
+    virtual ~FeatureReductionEngine() {}
+
+    /**
+     * @brief setScalars Selects a scalar cell array to sum per Feature during the next execute()
+     * @param values One value per cell; must stay valid until execute() returns
+     */
+    template<typename T>
+    void setScalars(const T* values)
+    {
+      m_Scalars = values;
+      m_ReadScalar = &FeatureReductionEngine::ReadScalar<T>;
+    }
+
+    /**
+     * @brief setNumberOfPartials Overrides the number of chunks of rows that are accumulated separately; 0 lets the engine choose
+     */
+    void setNumberOfPartials(int64_t numPartials) { m_NumPartials = numPartials; }
+
+    /**
+     * @brief execute Runs the reduction, in parallel over rows of the volume when available
+     */
+    void execute()
+    {
+      int64_t numRows = m_Dims[1] * m_Dims[2];
+      bool sumScalars = (m_Scalars != NULL);
+
+      // every partial holds the full set of per-Feature accumulators, so unless overridden their number is kept to
+      // the number of threads and to a quarter of the size of the FeatureIds
+      int64_t numChunks = 1;
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+      tbb::task_scheduler_init init;
+      bool doParallel = true;
+      numChunks = tbb::task_scheduler_init::default_num_threads();
+      int64_t partialBytes = (m_NumFeatures + 1) * static_cast<int64_t>(19 * sizeof(int64_t) + sizeof(uint8_t) + (sumScalars ? sizeof(double) : 0));
+      int64_t maxChunks = (numRows * m_Dims[0] * static_cast<int64_t>(sizeof(int32_t))) / (4 * partialBytes);
+      numChunks = std::min(numChunks, std::max(maxChunks, static_cast<int64_t>(1)));
+#endif
+      if (m_NumPartials > 0) { numChunks = m_NumPartials; }
+      numChunks = std::min(numChunks, std::max(numRows, static_cast<int64_t>(1)));
+
+      std::vector<Partial_t> partials(numChunks);
+      partials[0].initialize(m_NumFeatures, m_Dims, sumScalars);
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+      if (doParallel == true && numChunks > 1)
+      {
+        tbb::parallel_for(tbb::blocked_range<int64_t>(0, numChunks, 1), ReduceImpl(this, &(partials.front()), numChunks), tbb::auto_partitioner());
+        tbb::parallel_for(tbb::blocked_range<int64_t>(0, m_NumFeatures), MergeImpl(&(partials.front()), numChunks), tbb::auto_partitioner());
+      }
+      else
+#endif
+      {
+        ReduceImpl serial(this, &(partials.front()), numChunks);
+        serial.reduce(0, numChunks);
+        MergeImpl merge(&(partials.front()), numChunks);
+        merge.merge(0, m_NumFeatures);
+      }
+
+      for (int64_t c = 1; c < numChunks; c++)
+      {
+        partials[0].m_LargestFeatureId = std::max(partials[0].m_LargestFeatureId, partials[c].m_LargestFeatureId);
+        partials[0].m_InvalidIds += partials[c].m_InvalidIds;
+      }
+      m_Result.swap(partials[0]);
+      m_Scalars = NULL;
+      m_ReadScalar = NULL;
+    }
+
+    /**
+     * @brief getNumberOfFeatures Returns the number of Features the engine accumulates
+     */
+    size_t getNumberOfFeatures() const { return static_cast<size_t>(m_NumFeatures); }
+
+    /**
+     * @brief getLargestFeatureId Returns the largest Feature Id found in the cells (at least 0), including the Ids out of range
+     */
+    int32_t getLargestFeatureId() const { return m_Result.m_LargestFeatureId; }
+
+    /**
+     * @brief getNumberOfInvalidIds Returns the number of cells whose Feature Id is outside [0, numFeatures)
+     */
+    int64_t getNumberOfInvalidIds() const { return m_Result.m_InvalidIds; }
+
+    /**
+     * @brief hasScalarSums Returns whether the last execute() summed a scalar array
+     */
+    bool hasScalarSums() const { return (m_Result.m_ScalarSums.empty() == false); }
+
+    /**
+     * @brief getCount Returns the number of cells of the Feature
+     */
+    int64_t getCount(size_t feature) const { return m_Result.m_Counts[feature]; }
+
+    /**
+     * @brief getIndexSum Returns the sum of the voxel indices of the Feature along one axis
+     */
+    int64_t getIndexSum(size_t feature, int32_t axis) const { return m_Result.m_Sums[3 * feature + axis]; }
+
+    /**
+     * @brief getIndexProductSum Returns the sum over the Feature's voxels of the product of their indices along two axes
+     */
+    int64_t getIndexProductSum(size_t feature, int32_t axisA, int32_t axisB) const { return m_Result.m_Products[6 * feature + ProductIndex(axisA, axisB)]; }
+
+    /**
+     * @brief getCentroid Returns the centroid of the Feature along one axis, measured from the first voxel
+     * @param feature The Feature
+     * @param axis The axis
+     * @param resolution Spacing of the voxels along the axis
+     */
+    float getCentroid(size_t feature, int32_t axis, float resolution) const
+    {
+      return static_cast<float>((static_cast<double>(getIndexSum(feature, axis)) * static_cast<double>(resolution)) / static_cast<double>(getCount(feature)));
+    }
+
+    /**
+     * @brief getCentralProductSum Returns the sum over the Feature's voxels of (a * scaleA - centerA) * (b * scaleB - centerB),
+     * where a and b are the voxel indices along axisA and axisB. Evaluated from the exact index sums, so the center
+     * does not have to be known before the reduction.
+     */
+    double getCentralProductSum(size_t feature, int32_t axisA, int32_t axisB, double scaleA, double scaleB, double centerA, double centerB) const
+    {
+      double count = static_cast<double>(getCount(feature));
+      double sumA = static_cast<double>(getIndexSum(feature, axisA));
+      double sumB = static_cast<double>(getIndexSum(feature, axisB));
+      double sumAB = static_cast<double>(getIndexProductSum(feature, axisA, axisB));
+      return (scaleA * scaleB * sumAB) - (scaleA * centerB * sumA) - (scaleB * centerA * sumB) + (count * centerA * centerB);
+    }
+
+    /**
+     * @brief getBounds Returns the inclusive voxel bounding box of the Feature as xmin, xmax, ymin, ymax, zmin, zmax; min > max if the Feature has no cells
+     */
+    void getBounds(size_t feature, int64_t bounds[6]) const
+    {
+      for (int32_t i = 0; i < 6; i++)
+      {
+        bounds[i] = m_Result.m_Bounds[6 * feature + i];
+      }
+    }
+
+    /**
+     * @brief isSurfaceFeature Returns whether the Feature touches the outer surface of the volume or a cell with Feature Id 0.
+     * Axes with a single cell are ignored, so 2D volumes are treated in their plane.
+     */
+    bool isSurfaceFeature(size_t feature) const { return (m_Result.m_Surface[feature] != 0); }
+
+    /**
+     * @brief getBoundaryFaces Returns the number of faces normal to the axis between a cell of the Feature and a neighboring cell of another Feature
+     */
+    int64_t getBoundaryFaces(size_t feature, int32_t axis) const { return m_Result.m_Faces[3 * feature + axis]; }
+
+    /**
+     * @brief getScalarSum Returns the sum of the scalar array over the cells of the Feature
+     */
+    double getScalarSum(size_t feature) const { return m_Result.m_ScalarSums[feature]; }
+
+    /**
+     * @brief Compute Runs a reduction of the FeatureIds
+     * @param featureIds Feature Id of every cell
+     * @param dims Number of cells along x, y and z
+     * @param numFeatures Number of Features
+     */
+    static Pointer Compute(const int32_t* featureIds, const size_t dims[3], size_t numFeatures)
+    {
+      Pointer engine(new FeatureReductionEngine(featureIds, dims, numFeatures));
+      engine->execute();
+      return engine;
+    }
+
+    /**
+     * @brief ComputeWithScalars Runs a reduction of the FeatureIds that also sums the scalar array
+     * @param featureIds Feature Id of every cell
+     * @param dims Number of cells along x, y and z
+     * @param numFeatures Number of Features
+     * @param values One value per cell
+     */
+    template<typename T>
+    static Pointer ComputeWithScalars(const int32_t* featureIds, const size_t dims[3], size_t numFeatures, const T* values)
+    {
+      Pointer engine(new FeatureReductionEngine(featureIds, dims, numFeatures));
+      engine->setScalars(values);
+      engine->execute();
+      return engine;
+    }
+
+  private:
+    /**
+     * @brief Per-Feature accumulators; one set per chunk of rows, merged into the first one at the end
+     */
+    struct Partial_t
+    {
+      std::vector<int64_t> m_Counts;
+      std::vector<int64_t> m_Sums;
+      std::vector<int64_t> m_Products;
+      std::vector<int64_t> m_Bounds;
+      std::vector<int64_t> m_Faces;
+      std::vector<uint8_t> m_Surface;
+      std::vector<double> m_ScalarSums;
+      int32_t m_LargestFeatureId;
+      int64_t m_InvalidIds;
+
+      Partial_t() :
+        m_LargestFeatureId(0),
+        m_InvalidIds(0)
+      {}
+
+      void initialize(int64_t numFeatures, const int64_t dims[3], bool sumScalars)
+      {
+        m_Counts.assign(numFeatures, 0);
+        m_Sums.assign(3 * numFeatures, 0);
+        m_Products.assign(6 * numFeatures, 0);
+        m_Bounds.resize(6 * numFeatures);
+        for (int64_t i = 0; i < numFeatures; i++)
+        {
+          for (int32_t d = 0; d < 3; d++)
+          {
+            m_Bounds[6 * i + 2 * d] = dims[d];
+            m_Bounds[6 * i + 2 * d + 1] = -1;
+          }
+        }
+        m_Faces.assign(3 * numFeatures, 0);
+        m_Surface.assign(numFeatures, 0);
+        if (sumScalars == true) { m_ScalarSums.assign(numFeatures, 0.0); }
+        else { m_ScalarSums.clear(); }
+        m_LargestFeatureId = 0;
+        m_InvalidIds = 0;
+      }
+
+      void swap(Partial_t& other)
+      {
+        m_Counts.swap(other.m_Counts);
+        m_Sums.swap(other.m_Sums);
+        m_Products.swap(other.m_Products);
+        m_Bounds.swap(other.m_Bounds);
+        m_Faces.swap(other.m_Faces);
+        m_Surface.swap(other.m_Surface);
+        m_ScalarSums.swap(other.m_ScalarSums);
+        std::swap(m_LargestFeatureId, other.m_LargestFeatureId);
+        std::swap(m_InvalidIds, other.m_InvalidIds);
+      }
+    };
+
+    const int32_t* m_FeatureIds;
+    int64_t m_Dims[3];
+    int64_t m_NumFeatures;
+    const void* m_Scalars;
+    double (*m_ReadScalar)(const void*, int64_t);
+    int64_t m_NumPartials;
+    Partial_t m_Result;
+
+    template<typename T>
+    static double ReadScalar(const void* values, int64_t index)
+    {
+      return static_cast<double>(static_cast<const T*>(values)[index]);
+    }
+
+    static int32_t ProductIndex(int32_t axisA, int32_t axisB)
+    {
+      // xx, yy, zz, xy, yz, xz
+      if (axisA == axisB) { return axisA; }
+      if (axisA + axisB == 1) { return 3; }
+      if (axisA + axisB == 3) { return 4; }
+      return 5;
+    }
+
+    /**
+     * @brief reduceRows Accumulates the rows [rowStart, rowEnd) into the partial
+     */
+    void reduceRows(int64_t rowStart, int64_t rowEnd, Partial_t& partial) const
+    {
+      const int64_t xPoints = m_Dims[0];
+      const int64_t yPoints = m_Dims[1];
+      const int64_t strides[3] = { 1, xPoints, xPoints * yPoints };
+      int64_t coords[3] = { 0, 0, 0 };
+
+      // an axis with a single cell has neither neighbors nor an outer surface; the interior path compares such an axis
+      // against the cell itself and masks out its Feature Id 0 contacts
+      const int64_t interiorStrides[3] = { 1, (yPoints > 1) ? strides[1] : 0, (m_Dims[2] > 1) ? strides[2] : 0 };
+      const uint8_t yActive = (yPoints > 1) ? 1 : 0;
+      const uint8_t zActive = (m_Dims[2] > 1) ? 1 : 0;
+
+      for (int64_t row = rowStart; row < rowEnd; row++)
+      {
+        coords[2] = row / yPoints;
+        coords[1] = row - (coords[2] * yPoints);
+        int64_t rowIndex = row * xPoints;
+
+        // a row away from the y and z faces of the volume has all its neighbor rows, so only its first and last cells need the checked path
+        bool interiorRow = (yPoints == 1 || (coords[1] > 0 && coords[1] < yPoints - 1)) && (m_Dims[2] == 1 || (coords[2] > 0 && coords[2] < m_Dims[2] - 1));
+
+        for (int64_t k = 0; k < xPoints; k++)
+        {
+          coords[0] = k;
+          int64_t index = rowIndex + k;
+          int32_t feature = m_FeatureIds[index];
+          if (feature > partial.m_LargestFeatureId) { partial.m_LargestFeatureId = feature; }
+          if (feature < 0 || feature >= m_NumFeatures)
+          {
+            partial.m_InvalidIds++;
+            continue;
+          }
+
+          partial.m_Counts[feature]++;
+          if (NULL != m_Scalars) { partial.m_ScalarSums[feature] += m_ReadScalar(m_Scalars, index); }
+
+          int64_t* sums = &(partial.m_Sums[3 * feature]);
+          int64_t* products = &(partial.m_Products[6 * feature]);
+          int64_t* bounds = &(partial.m_Bounds[6 * feature]);
+          int64_t* faces = &(partial.m_Faces[3 * feature]);
+          for (int32_t d = 0; d < 3; d++)
+          {
+            sums[d] += coords[d];
+            products[d] += coords[d] * coords[d];
+            if (coords[d] < bounds[2 * d]) { bounds[2 * d] = coords[d]; }
+            if (coords[d] > bounds[2 * d + 1]) { bounds[2 * d + 1] = coords[d]; }
+          }
+          products[3] += coords[0] * coords[1];
+          products[4] += coords[1] * coords[2];
+          products[5] += coords[0] * coords[2];
+
+          if (interiorRow == true && k > 0 && k < xPoints - 1)
+          {
+            const int32_t* cell = m_FeatureIds + index;
+            int32_t xLow = cell[-1];
+            int32_t xHigh = cell[1];
+            int32_t yLow = cell[-interiorStrides[1]];
+            int32_t yHigh = cell[interiorStrides[1]];
+            int32_t zLow = cell[-interiorStrides[2]];
+            int32_t zHigh = cell[interiorStrides[2]];
+            faces[0] += static_cast<int64_t>(xLow != feature) + static_cast<int64_t>(xHigh != feature);
+            faces[1] += static_cast<int64_t>(yLow != feature) + static_cast<int64_t>(yHigh != feature);
+            faces[2] += static_cast<int64_t>(zLow != feature) + static_cast<int64_t>(zHigh != feature);
+            uint8_t surface = static_cast<uint8_t>((xLow == 0) | (xHigh == 0));
+            surface |= static_cast<uint8_t>((yLow == 0) | (yHigh == 0)) & yActive;
+            surface |= static_cast<uint8_t>((zLow == 0) | (zHigh == 0)) & zActive;
+            partial.m_Surface[feature] |= surface;
+            continue;
+          }
+
+          uint8_t surface = 0;
+          for (int32_t d = 0; d < 3; d++)
+          {
+            if (m_Dims[d] == 1) { continue; }
+            if (coords[d] == 0) { surface = 1; }
+            else
+            {
+              int32_t neighbor = m_FeatureIds[index - strides[d]];
+              if (neighbor == 0) { surface = 1; }
+              if (neighbor != feature) { faces[d]++; }
+            }
+            if (coords[d] == m_Dims[d] - 1) { surface = 1; }
+            else
+            {
+              int32_t neighbor = m_FeatureIds[index + strides[d]];
+              if (neighbor == 0) { surface = 1; }
+              if (neighbor != feature) { faces[d]++; }
+            }
+          }
+          partial.m_Surface[feature] |= surface;
+        }
+      }
+    }
+
+    /**
+     * @brief Reduces contiguous chunks of rows, each into its own partial
+     */
+    class ReduceImpl
+    {
+        const FeatureReductionEngine* m_Engine;
+        Partial_t* m_Partials;
+        int64_t m_NumChunks;
+
+      public:
+        ReduceImpl(const FeatureReductionEngine* engine, Partial_t* partials, int64_t numChunks) :
+          m_Engine(engine),
+          m_Partials(partials),
+          m_NumChunks(numChunks)
+        {}
+
+        virtual ~ReduceImpl() {}
+
+        void reduce(int64_t start, int64_t end) const
+        {
+          int64_t numRows = m_Engine->m_Dims[1] * m_Engine->m_Dims[2];
+          for (int64_t c = start; c < end; c++)
+          {
+            if (c > 0) { m_Partials[c].initialize(m_Engine->m_NumFeatures, m_Engine->m_Dims, m_Engine->m_Scalars != NULL); }
+            int64_t rowStart = (numRows * c) / m_NumChunks;
+            int64_t rowEnd = (numRows * (c + 1)) / m_NumChunks;
+            m_Engine->reduceRows(rowStart, rowEnd, m_Partials[c]);
+          }
+        }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+        void operator()(const tbb::blocked_range<int64_t>& r) const
+        {
+          reduce(r.begin(), r.end());
+        }
+#endif
+    };
+
+    /**
+     * @brief Adds the partials of the other chunks into the first one for a range of Features
+     */
+    class MergeImpl
+    {
+        Partial_t* m_Partials;
+        int64_t m_NumChunks;
+
+      public:
+        MergeImpl(Partial_t* partials, int64_t numChunks) :
+          m_Partials(partials),
+          m_NumChunks(numChunks)
+        {}
+
+        virtual ~MergeImpl() {}
+
+        void merge(int64_t start, int64_t end) const
+        {
+          Partial_t& result = m_Partials[0];
+          for (int64_t c = 1; c < m_NumChunks; c++)
+          {
+            const Partial_t& partial = m_Partials[c];
+            for (int64_t i = start; i < end; i++)
+            {
+              result.m_Counts[i] += partial.m_Counts[i];
+              for (int32_t d = 0; d < 3; d++)
+              {
+                result.m_Sums[3 * i + d] += partial.m_Sums[3 * i + d];
+                result.m_Faces[3 * i + d] += partial.m_Faces[3 * i + d];
+                result.m_Bounds[6 * i + 2 * d] = std::min(result.m_Bounds[6 * i + 2 * d], partial.m_Bounds[6 * i + 2 * d]);
+                result.m_Bounds[6 * i + 2 * d + 1] = std::max(result.m_Bounds[6 * i + 2 * d + 1], partial.m_Bounds[6 * i + 2 * d + 1]);
+              }
+              for (int32_t p = 0; p < 6; p++)
+              {
+                result.m_Products[6 * i + p] += partial.m_Products[6 * i + p];
+              }
+              result.m_Surface[i] |= partial.m_Surface[i];
+              if (result.m_ScalarSums.empty() == false) { result.m_ScalarSums[i] += partial.m_ScalarSums[i]; }
+            }
+          }
+        }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+        void operator()(const tbb::blocked_range<int64_t>& r) const
+        {
+          merge(r.begin(), r.end());
+        }
+#endif
+    };
+
+    FeatureReductionEngine(const FeatureReductionEngine&); // Copy Constructor Not Implemented
+    void operator=(const FeatureReductionEngine&); // Operator '=' Not Implemented
+};
+
+#endif /* _featurereductionengine_hpp_ */
@@ -0,0 +1,313 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <cmath>
+#include <vector>
+
+#include "Generic/GenericFilters/util/FeatureReductionEngine.hpp"
+
+class FeatureReductionEngineTest
+{
+  public:
+    FeatureReductionEngineTest(){}
+    virtual ~FeatureReductionEngineTest(){}
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    uint32_t NextRandom(uint32_t& state)
+    {
+      state = state * 1664525u + 1013904223u;
+      return state >> 8;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Blocky Features with some Feature Id 0 cells, so that all the boundary cases show up
+    // -----------------------------------------------------------------------------
+    std::vector<int32_t> MakeFeatureIds(const size_t dims[3], int32_t numFeatures, uint32_t seed)
+    {
+      std::vector<int32_t> featureIds(dims[0] * dims[1] * dims[2], 0);
+      uint32_t state = seed;
+      for (size_t z = 0; z < dims[2]; z++)
+      {
+        for (size_t y = 0; y < dims[1]; y++)
+        {
+          for (size_t x = 0; x < dims[0]; x++)
+          {
+            size_t index = (dims[0] * dims[1] * z) + (dims[0] * y) + x;
+            int32_t block = static_cast<int32_t>((x / 3) + (y / 2) * 5 + (z / 2) * 7);
+            featureIds[index] = block % numFeatures;
+            if (NextRandom(state) % 11 == 0) { featureIds[index] = static_cast<int32_t>(NextRandom(state) % numFeatures); }
+          }
+        }
+      }
+      return featureIds;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void CheckAgainstBruteForce(const size_t dims[3], int32_t numFeatures, uint32_t seed)
+    {
+      std::vector<int32_t> featureIds = MakeFeatureIds(dims, numFeatures, seed);
+      std::vector<float> scalars(featureIds.size());
+      for (size_t i = 0; i < scalars.size(); i++)
+      {
+        scalars[i] = static_cast<float>(i % 17) * 0.25f;
+      }
+
+      std::vector<int64_t> counts(numFeatures, 0);
+      std::vector<int64_t> sums(3 * numFeatures, 0);
+      std::vector<int64_t> products(9 * numFeatures, 0);
+      std::vector<int64_t> bounds(6 * numFeatures, 0);
+      std::vector<int64_t> faces(3 * numFeatures, 0);
+      std::vector<bool> surface(numFeatures, false);
+      std::vector<double> scalarSums(numFeatures, 0.0);
+      for (int32_t f = 0; f < numFeatures; f++)
+      {
+        for (int32_t d = 0; d < 3; d++)
+        {
+          bounds[6 * f + 2 * d] = static_cast<int64_t>(dims[d]);
+          bounds[6 * f + 2 * d + 1] = -1;
+        }
+      }
+
+      const int64_t strides[3] = { 1, static_cast<int64_t>(dims[0]), static_cast<int64_t>(dims[0] * dims[1]) };
+      for (size_t index = 0; index < featureIds.size(); index++)
+      {
+        int32_t f = featureIds[index];
+        int64_t coords[3] = { static_cast<int64_t>(index % dims[0]), static_cast<int64_t>((index / dims[0]) % dims[1]), static_cast<int64_t>(index / (dims[0] * dims[1])) };
+        counts[f]++;
+        scalarSums[f] += scalars[index];
+        for (int32_t a = 0; a < 3; a++)
+        {
+          sums[3 * f + a] += coords[a];
+          bounds[6 * f + 2 * a] = std::min(bounds[6 * f + 2 * a], coords[a]);
+          bounds[6 * f + 2 * a + 1] = std::max(bounds[6 * f + 2 * a + 1], coords[a]);
+          for (int32_t b = 0; b < 3; b++)
+          {
+            products[9 * f + 3 * a + b] += coords[a] * coords[b];
+          }
+          if (dims[a] == 1) { continue; }
+          for (int32_t side = -1; side <= 1; side += 2)
+          {
+            int64_t neighborCoord = coords[a] + side;
+            if (neighborCoord < 0 || neighborCoord >= static_cast<int64_t>(dims[a]))
+            {
+              surface[f] = true;
+              continue;
+            }
+            int32_t neighbor = featureIds[index + side * strides[a]];
+            if (neighbor == 0) { surface[f] = true; }
+            if (neighbor != f) { faces[3 * f + a]++; }
+          }
+        }
+      }
+
+      // the rows are split into a varying number of partials, which must not change the merged result
+      for (int64_t numPartials = 1; numPartials <= 7; numPartials += 3)
+      {
+        FeatureReductionEngine engine(&(featureIds.front()), dims, static_cast<size_t>(numFeatures));
+        engine.setNumberOfPartials(numPartials);
+        engine.setScalars(&(scalars.front()));
+        engine.execute();
+        CheckEngine(engine, counts, sums, products, bounds, faces, surface, scalarSums);
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void CheckEngine(const FeatureReductionEngine& engine, const std::vector<int64_t>& counts, const std::vector<int64_t>& sums, const std::vector<int64_t>& products,
+                     const std::vector<int64_t>& bounds, const std::vector<int64_t>& faces, const std::vector<bool>& surface, const std::vector<double>& scalarSums)
+    {
+      int32_t numFeatures = static_cast<int32_t>(counts.size());
+      DREAM3D_REQUIRE_EQUAL(engine.getNumberOfInvalidIds(), 0)
+      DREAM3D_REQUIRE_EQUAL(engine.hasScalarSums(), true)
+      for (int32_t f = 0; f < numFeatures; f++)
+      {
+        DREAM3D_REQUIRE_EQUAL(engine.getCount(f), counts[f])
+        DREAM3D_REQUIRE_EQUAL(engine.isSurfaceFeature(f), surface[f])
+        DREAM3D_REQUIRE(std::fabs(engine.getScalarSum(f) - scalarSums[f]) < 1.0e-9)
+        int64_t engineBounds[6] = { 0, 0, 0, 0, 0, 0 };
+        engine.getBounds(f, engineBounds);
+        for (int32_t a = 0; a < 3; a++)
+        {
+          DREAM3D_REQUIRE_EQUAL(engine.getIndexSum(f, a), sums[3 * f + a])
+          DREAM3D_REQUIRE_EQUAL(engine.getBoundaryFaces(f, a), faces[3 * f + a])
+          DREAM3D_REQUIRE_EQUAL(engineBounds[2 * a], bounds[6 * f + 2 * a])
+          DREAM3D_REQUIRE_EQUAL(engineBounds[2 * a + 1], bounds[6 * f + 2 * a + 1])
+          for (int32_t b = 0; b < 3; b++)
+          {
+            DREAM3D_REQUIRE_EQUAL(engine.getIndexProductSum(f, a, b), products[9 * f + 3 * a + b])
+          }
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestReduction()
+    {
+      const size_t volume[3] = { 23, 17, 13 };
+      CheckAgainstBruteForce(volume, 40, 1);
+      // the three orientations of a 2D image, and a single row
+      const size_t planeXY[3] = { 31, 19, 1 };
+      CheckAgainstBruteForce(planeXY, 25, 2);
+      const size_t planeXZ[3] = { 31, 1, 19 };
+      CheckAgainstBruteForce(planeXZ, 25, 3);
+      const size_t planeYZ[3] = { 1, 31, 19 };
+      CheckAgainstBruteForce(planeYZ, 25, 4);
+      const size_t line[3] = { 1, 57, 1 };
+      CheckAgainstBruteForce(line, 6, 5);
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestCentralSums()
+    {
+      const size_t dims[3] = { 20, 15, 10 };
+      int32_t numFeatures = 12;
+      std::vector<int32_t> featureIds = MakeFeatureIds(dims, numFeatures, 7);
+      FeatureReductionEngine engine(&(featureIds.front()), dims, static_cast<size_t>(numFeatures));
+      engine.execute();
+
+      const double res[3] = { 0.5, 0.25, 2.0 };
+      for (int32_t f = 1; f < numFeatures; f++)
+      {
+        double center[3] = { 0.0, 0.0, 0.0 };
+        for (int32_t a = 0; a < 3; a++)
+        {
+          center[a] = engine.getCentroid(f, a, static_cast<float>(res[a]));
+        }
+        double direct[3][3] = { { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 } };
+        for (size_t index = 0; index < featureIds.size(); index++)
+        {
+          if (featureIds[index] != f) { continue; }
+          double coords[3] = { static_cast<double>(index % dims[0]), static_cast<double>((index / dims[0]) % dims[1]), static_cast<double>(index / (dims[0] * dims[1])) };
+          for (int32_t a = 0; a < 3; a++)
+          {
+            for (int32_t b = 0; b < 3; b++)
+            {
+              direct[a][b] += (coords[a] * res[a] - center[a]) * (coords[b] * res[b] - center[b]);
+            }
+          }
+        }
+        for (int32_t a = 0; a < 3; a++)
+        {
+          for (int32_t b = 0; b < 3; b++)
+          {
+            double central = engine.getCentralProductSum(f, a, b, res[a], res[b], center[a], center[b]);
+            DREAM3D_REQUIRE(std::fabs(central - direct[a][b]) < 1.0e-6 * (1.0 + std::fabs(direct[a][b])))
+          }
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestInvalidIds()
+    {
+      const size_t dims[3] = { 4, 3, 2 };
+      std::vector<int32_t> featureIds(24, 1);
+      featureIds[5] = 9;
+      featureIds[17] = -2;
+      FeatureReductionEngine engine(&(featureIds.front()), dims, 3);
+      engine.execute();
+      DREAM3D_REQUIRE_EQUAL(engine.getNumberOfInvalidIds(), 2)
+      DREAM3D_REQUIRE_EQUAL(engine.getLargestFeatureId(), 9)
+      DREAM3D_REQUIRE_EQUAL(engine.getCount(1), 22)
+      DREAM3D_REQUIRE_EQUAL(engine.getCount(2), 0)
+      int64_t bounds[6] = { 0, 0, 0, 0, 0, 0 };
+      engine.getBounds(2, bounds);
+      DREAM3D_REQUIRE(bounds[0] > bounds[1])
+
+      // cells next to an invalid Id count a face, but the invalid cells themselves do not
+      DREAM3D_REQUIRE_EQUAL(engine.getBoundaryFaces(1, 0), 4)
+      DREAM3D_REQUIRE_EQUAL(engine.getBoundaryFaces(1, 1), 4)
+      DREAM3D_REQUIRE_EQUAL(engine.getBoundaryFaces(1, 2), 0)
+      DREAM3D_REQUIRE_EQUAL(engine.isSurfaceFeature(1), true)
+      DREAM3D_REQUIRE_EQUAL(engine.isSurfaceFeature(2), false)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestCompute()
+    {
+      const size_t dims[3] = { 16, 12, 8 };
+      int32_t numFeatures = 20;
+      std::vector<int32_t> featureIds = MakeFeatureIds(dims, numFeatures, 11);
+
+      FeatureReductionEngine::Pointer first = FeatureReductionEngine::Compute(&(featureIds.front()), dims, numFeatures);
+      DREAM3D_REQUIRE_EQUAL(first->hasScalarSums(), false)
+
+      // every call reduces the Feature Ids as they are now, so a single changed cell shows up
+      int32_t oldId = featureIds[100];
+      int32_t newId = (oldId + 1) % numFeatures;
+      featureIds[100] = newId;
+      FeatureReductionEngine::Pointer second = FeatureReductionEngine::Compute(&(featureIds.front()), dims, numFeatures);
+      DREAM3D_REQUIRE_EQUAL(second->getCount(newId), first->getCount(newId) + 1)
+      DREAM3D_REQUIRE_EQUAL(second->getCount(oldId), first->getCount(oldId) - 1)
+
+      std::vector<int16_t> scalars(featureIds.size(), 3);
+      FeatureReductionEngine::Pointer third = FeatureReductionEngine::ComputeWithScalars(&(featureIds.front()), dims, numFeatures, &(scalars.front()));
+      DREAM3D_REQUIRE_EQUAL(third->hasScalarSums(), true)
+      for (int32_t f = 0; f < numFeatures; f++)
+      {
+        DREAM3D_REQUIRE_EQUAL(third->getCount(f), second->getCount(f))
+        DREAM3D_REQUIRE(std::fabs(third->getScalarSum(f) - 3.0 * static_cast<double>(third->getCount(f))) < 1.0e-9)
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( TestReduction() )
+      DREAM3D_REGISTER_TEST( TestCentralSums() )
+      DREAM3D_REGISTER_TEST( TestInvalidIds() )
+      DREAM3D_REGISTER_TEST( TestCompute() )
+    }
+
+  private:
+    FeatureReductionEngineTest(const FeatureReductionEngineTest&); // Copy Constructor Not Implemented
+    void operator=(const FeatureReductionEngineTest&); // Operator '=' Not Implemented
+};
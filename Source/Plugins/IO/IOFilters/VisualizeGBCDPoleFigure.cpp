@@ -35,6 +35,8 @@
 
 #include "VisualizeGBCDPoleFigure.h"
 
+#include <vector>
+
 #include <QtCore/QDir>
 
 #include "SIMPLib/Common/Constants.h"
@@ -49,6 +51,7 @@
 #include "SIMPLib/Geometry/TriangleGeom.h"
 
 #include "OrientationLib/OrientationMath/OrientationTransforms.hpp"
+#include "OrientationLib/Utilities/ModifiedLambertProjection.h"
 
 #include "IO/IOConstants.h"
 #include "IO/IOVersion.h"
@@ -290,9 +293,6 @@ void VisualizeGBCDPoleFigure::execute()
 
   float vec[3] = { 0.0f, 0.0f, 0.0f };
   float vec2[3] = { 0.0f, 0.0f, 0.0f };
-  float rotNormal[3] = { 0.0f, 0.0f, 0.0f };
-  float rotNormal2[3] = { 0.0f, 0.0f, 0.0f };
-  float sqCoord[2] = { 0.0f, 0.0f };
   float dg[3][3] = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
   float dgt[3][3] = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
   float dg1[3][3] = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
@@ -330,24 +330,99 @@ void VisualizeGBCDPoleFigure::execute()
   float x = 0.0f, y = 0.0f;
   float sum = 0;
   int32_t count = 0;
-  bool nhCheck = false;
-  int32_t hemisphere = 0;
 
   int32_t shift1 = gbcdSizes[0];
   int32_t shift2 = gbcdSizes[0] * gbcdSizes[1];
   int32_t shift3 = gbcdSizes[0] * gbcdSizes[1] * gbcdSizes[2];
-  int32_t shift4 = gbcdSizes[0] * gbcdSizes[1] * gbcdSizes[2] * gbcdSizes[3];
 
   int64_t totalGBCDBins = gbcdSizes[0] * gbcdSizes[1] * gbcdSizes[2] * gbcdSizes[3] * gbcdSizes[4] * 2;
 
+  // The misorientation part of the GBCD bin only depends on the pair of symmetry operators and not
+  // on the pole figure pixel, so find the valid pairs once. For each pair we keep the first symmetry
+  // operator (used to rotate the boundary normal) and the bin offset of the misorientation.
+  QVector<int32_t> symOps1;
+  QVector<int32_t> misoBins1;
+  QVector<int32_t> symOps2;
+  QVector<int32_t> misoBins2;
+  for (int32_t i = 0; i < n_sym; i++)
+  {
+    //get symmetry operator1
+    orientOps->getMatSymOp(i, sym1);
+    for (int32_t j = 0; j < n_sym; j++)
+    {
+      // get symmetry operator2
+      orientOps->getMatSymOp(j, sym2);
+      MatrixMath::Transpose3x3(sym2, sym2t);
+      // calculate symmetric misorientation
+      MatrixMath::Multiply3x3with3x3(dg, sym2t, dg1);
+      MatrixMath::Multiply3x3with3x3(sym1, dg1, dg2);
+      // convert to euler angle
+      FOrientArrayType eu(mis_euler1, 3);
+      FOrientTransformsType::om2eu(FOrientArrayType(dg2), eu);
+      if (mis_euler1[0] < SIMPLib::Constants::k_PiOver2 && mis_euler1[1] < SIMPLib::Constants::k_PiOver2 && mis_euler1[2] < SIMPLib::Constants::k_PiOver2)
+      {
+        mis_euler1[1] = cosf(mis_euler1[1]);
+        // find bins in GBCD
+        int32_t location1 = int32_t((mis_euler1[0] - gbcdLimits[0]) / gbcdDeltas[0]);
+        int32_t location2 = int32_t((mis_euler1[1] - gbcdLimits[1]) / gbcdDeltas[1]);
+        int32_t location3 = int32_t((mis_euler1[2] - gbcdLimits[2]) / gbcdDeltas[2]);
+        if (location1 >= 0 && location2 >= 0 && location3 >= 0 &&
+            location1 < gbcdSizes[0] && location2 < gbcdSizes[1] && location3 < gbcdSizes[2])
+        {
+          symOps1.push_back(i);
+          misoBins1.push_back((location3 * shift2) + (location2 * shift1) + location1);
+        }
+      }
+
+      // again in second crystal reference frame
+      // calculate symmetric misorientation
+      MatrixMath::Multiply3x3with3x3(dgt, sym2, dg1);
+      MatrixMath::Multiply3x3with3x3(sym1, dg1, dg2);
+      // convert to euler angle
+      FOrientTransformsType::om2eu(FOrientArrayType(dg2), eu);
+      if (mis_euler1[0] < SIMPLib::Constants::k_PiOver2 && mis_euler1[1] < SIMPLib::Constants::k_PiOver2 && mis_euler1[2] < SIMPLib::Constants::k_PiOver2)
+      {
+        mis_euler1[1] = cosf(mis_euler1[1]);
+        // find bins in GBCD
+        int32_t location1 = int32_t((mis_euler1[0] - gbcdLimits[0]) / gbcdDeltas[0]);
+        int32_t location2 = int32_t((mis_euler1[1] - gbcdLimits[1]) / gbcdDeltas[1]);
+        int32_t location3 = int32_t((mis_euler1[2] - gbcdLimits[2]) / gbcdDeltas[2]);
+        if (location1 >= 0 && location2 >= 0 && location3 >= 0 &&
+            location1 < gbcdSizes[0] && location2 < gbcdSizes[1] && location3 < gbcdSizes[2])
+        {
+          symOps2.push_back(i);
+          misoBins2.push_back((location3 * shift2) + (location2 * shift1) + location1);
+        }
+      }
+    }
+  }
+  int32_t numEntries1 = symOps1.size();
+  int32_t numEntries = numEntries1 + symOps2.size();
+
+  // The last 2 GBCD dimensions are the (square) Lambert projection of the boundary normal, so the
+  // nearest Lambert bin of a rotated normal is (location5 * gbcdSizes[3] + location4). Normals on the
+  // equator edge of the square are clamped into the last bin and normals along the poles fall in the
+  // center bin, so every symmetric normal of a pixel is averaged.
+  ModifiedLambertProjection::Pointer lambert = ModifiedLambertProjection::New();
+  lambert->initializeSquares(gbcdSizes[3], 1.0f);
+
+  // Scratch space for the symmetric normals of one row of pixels
+  std::vector<float> normals(size_t(xpoints) * numEntries * 3 + 3);
+  std::vector<int32_t> northIdx(size_t(xpoints) * numEntries * 4 + 4);
+  std::vector<int32_t> southIdx(size_t(xpoints) * numEntries * 4 + 4);
+
   QVector<size_t> dims(1, 1);
   DoubleArrayType::Pointer poleFigureArray = DoubleArrayType::NullPointer();
   poleFigureArray = DoubleArrayType::CreateArray(xpoints * ypoints, dims, "PoleFigure");
   poleFigureArray->initializeWithZeros();
   double* poleFigure = poleFigureArray->getPointer(0);
 
+  double* gbcdPhase = m_GBCD + (m_PhaseOfInterest * totalGBCDBins);
+
   for (int32_t k = 0; k < ypoints; k++)
   {
+    // Gather the symmetric boundary normals of every pixel in this row
+    size_t numNormals = 0;
     for (int32_t l = 0; l < xpoints; l++)
     {
       // get (x,y) for stereographic projection pixel
@@ -355,83 +430,52 @@ void VisualizeGBCDPoleFigure::execute()
       y = float(k - ypointshalf) * yres + (yres / 2.0);
       if ((x * x + y * y) <= 1.0)
       {
-        sum = 0.0f;
-        count = 0;
         vec[2] = -((x * x + y * y) - 1) / ((x * x + y * y) + 1);
         vec[0] = x * (1 + vec[2]);
         vec[1] = y * (1 + vec[2]);
         MatrixMath::Multiply3x3with3x1(dgt, vec, vec2);
 
-        // Loop over all the symetry operators in the given cystal symmetry
-        for (int32_t i = 0; i < n_sym; i++)
+        //find symmetric poles using the first symmetry operator
+        for (int32_t e = 0; e < numEntries1; e++)
+        {
+          orientOps->getMatSymOp(symOps1[e], sym1);
+          MatrixMath::Multiply3x3with3x1(sym1, vec, &(normals[numNormals * 3]));
+          numNormals++;
+        }
+        // again in second crystal reference frame
+        for (int32_t e = numEntries1; e < numEntries; e++)
+        {
+          orientOps->getMatSymOp(symOps2[e - numEntries1], sym1);
+          MatrixMath::Multiply3x3with3x1(sym1, vec2, &(normals[numNormals * 3]));
+          numNormals++;
+        }
+      }
+    }
+
+    //get coordinates in square projection of crystal normal parallel to boundary normal
+    lambert->projectDirections(&(normals.front()), numNormals, &(northIdx.front()), &(southIdx.front()), NULL);
+
+    size_t n = 0;
+    for (int32_t l = 0; l < xpoints; l++)
+    {
+      x = float(l - xpointshalf) * xres + (xres / 2.0);
+      y = float(k - ypointshalf) * yres + (yres / 2.0);
+      if ((x * x + y * y) <= 1.0)
+      {
+        sum = 0.0f;
+        count = 0;
+        for (int32_t e = 0; e < numEntries; e++, n++)
         {
-          //get symmetry operator1
-          orientOps->getMatSymOp(i, sym1);
-          for (int32_t j = 0; j < n_sym; j++)
+          int32_t hemisphere = 0;
+          int32_t squareBin = northIdx[n * 4];
+          if (squareBin < 0)
           {
-            // get symmetry operator2
-            orientOps->getMatSymOp(j, sym2);
-            MatrixMath::Transpose3x3(sym2, sym2t);
-            // calculate symmetric misorientation
-            MatrixMath::Multiply3x3with3x3(dg, sym2t, dg1);
-            MatrixMath::Multiply3x3with3x3(sym1, dg1, dg2);
-            // convert to euler angle
-            FOrientArrayType eu(mis_euler1, 3);
-            FOrientTransformsType::om2eu(FOrientArrayType(dg2), eu);
-            if (mis_euler1[0] < SIMPLib::Constants::k_PiOver2 && mis_euler1[1] < SIMPLib::Constants::k_PiOver2 && mis_euler1[2] < SIMPLib::Constants::k_PiOver2)
-            {
-              mis_euler1[1] = cosf(mis_euler1[1]);
-              // find bins in GBCD
-              int32_t location1 = int32_t((mis_euler1[0] - gbcdLimits[0]) / gbcdDeltas[0]);
-              int32_t location2 = int32_t((mis_euler1[1] - gbcdLimits[1]) / gbcdDeltas[1]);
-              int32_t location3 = int32_t((mis_euler1[2] - gbcdLimits[2]) / gbcdDeltas[2]);
-              //find symmetric poles using the first symmetry operator
-              MatrixMath::Multiply3x3with3x1(sym1, vec, rotNormal);
-              //get coordinates in square projection of crystal normal parallel to boundary normal
-              nhCheck = getSquareCoord(rotNormal, sqCoord);
-              // Note the switch to have theta in the 4 slot and cos(Phi) int he 3 slot
-              int32_t location4 = int32_t((sqCoord[0] - gbcdLimits[3]) / gbcdDeltas[3]);
-              int32_t location5 = int32_t((sqCoord[1] - gbcdLimits[4]) / gbcdDeltas[4]);
-              if (location1 >= 0 && location2 >= 0 && location3 >= 0 && location4 >= 0 && location5 >= 0 &&
-                  location1 < gbcdSizes[0] && location2 < gbcdSizes[1] && location3 < gbcdSizes[2] && location4 < gbcdSizes[3] && location5 < gbcdSizes[4])
-              {
-                hemisphere = 0;
-                if (nhCheck == false) { hemisphere = 1; }
-                sum += m_GBCD[(m_PhaseOfInterest * totalGBCDBins) + 2 * ((location5 * shift4) + (location4 * shift3) + (location3 * shift2) + (location2 * shift1) + location1) + hemisphere];
-                count++;
-              }
-            }
-
-            // again in second crystal reference frame
-            // calculate symmetric misorientation
-            MatrixMath::Multiply3x3with3x3(dgt, sym2, dg1);
-            MatrixMath::Multiply3x3with3x3(sym1, dg1, dg2);
-            // convert to euler angle
-            FOrientTransformsType::om2eu(FOrientArrayType(dg2), eu);
-            if (mis_euler1[0] < SIMPLib::Constants::k_PiOver2 && mis_euler1[1] < SIMPLib::Constants::k_PiOver2 && mis_euler1[2] < SIMPLib::Constants::k_PiOver2)
-            {
-              mis_euler1[1] = cosf(mis_euler1[1]);
-              // find bins in GBCD
-              int32_t location1 = int32_t((mis_euler1[0] - gbcdLimits[0]) / gbcdDeltas[0]);
-              int32_t location2 = int32_t((mis_euler1[1] - gbcdLimits[1]) / gbcdDeltas[1]);
-              int32_t location3 = int32_t((mis_euler1[2] - gbcdLimits[2]) / gbcdDeltas[2]);
-              // find symmetric poles using the first symmetry operator
-              MatrixMath::Multiply3x3with3x1(sym1, vec2, rotNormal2);
-              // get coordinates in square projection of crystal normal parallel to boundary normal
-              nhCheck = getSquareCoord(rotNormal2, sqCoord);
-              // Note the switch to have theta in the 4 slot and cos(Phi) int he 3 slot
-              int32_t location4 = int32_t((sqCoord[0] - gbcdLimits[3]) / gbcdDeltas[3]);
-              int32_t location5 = int32_t((sqCoord[1] - gbcdLimits[4]) / gbcdDeltas[4]);
-              if (location1 >= 0 && location2 >= 0 && location3 >= 0 && location4 >= 0 && location5 >= 0 &&
-                  location1 < gbcdSizes[0] && location2 < gbcdSizes[1] && location3 < gbcdSizes[2] && location4 < gbcdSizes[3] && location5 < gbcdSizes[4])
-              {
-                hemisphere = 0;
-                if (nhCheck == false) { hemisphere = 1; }
-                sum += m_GBCD[(m_PhaseOfInterest * totalGBCDBins) + 2 * ((location5 * shift4) + (location4 * shift3) + (location3 * shift2) + (location2 * shift1) + location1) + hemisphere];
-                count++;
-              }
-            }
+            hemisphere = 1;
+            squareBin = southIdx[n * 4];
           }
+          int32_t misoBin = (e < numEntries1) ? misoBins1[e] : misoBins2[e - numEntries1];
+          sum += gbcdPhase[2 * ((squareBin * shift3) + misoBin) + hemisphere];
+          count++;
         }
         if (count > 0)
         {
@@ -500,31 +544,6 @@ void VisualizeGBCDPoleFigure::execute()
   notifyStatusMessage(getHumanLabel(), "Complete");
 }
 
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
-bool VisualizeGBCDPoleFigure::getSquareCoord(float* xstl1_norm1, float* sqCoord)
-{
-  bool nhCheck = false;
-  float adjust = 1.0;
-  if (xstl1_norm1[2] >= 0.0)
-  {
-    adjust = -1.0;
-    nhCheck = true;
-  }
-  if (fabsf(xstl1_norm1[0]) >= fabsf(xstl1_norm1[1]))
-  {
-    sqCoord[0] = (xstl1_norm1[0] / fabsf(xstl1_norm1[0])) * sqrtf(2.0f * 1.0f * (1.0f + (xstl1_norm1[2] * adjust))) * (SIMPLib::Constants::k_SqrtPi / 2.0f);
-    sqCoord[1] = (xstl1_norm1[0] / fabsf(xstl1_norm1[0])) * sqrtf(2.0f * 1.0f * (1.0f + (xstl1_norm1[2] * adjust))) * ((2.0f / SIMPLib::Constants::k_SqrtPi) * atanf(xstl1_norm1[1] / xstl1_norm1[0]));
-  }
-  else
-  {
-    sqCoord[0] = (xstl1_norm1[1] / fabsf(xstl1_norm1[1])) * sqrtf(2.0f * 1.0f * (1.0f + (xstl1_norm1[2] * adjust))) * ((2.0f / SIMPLib::Constants::k_SqrtPi) * atanf(xstl1_norm1[0] / xstl1_norm1[1]));
-    sqCoord[1] = (xstl1_norm1[1] / fabsf(xstl1_norm1[1])) * sqrtf(2.0f * 1.0f * (1.0f + (xstl1_norm1[2] * adjust))) * (SIMPLib::Constants::k_SqrtPi / 2.0f);
-  }
-  return nhCheck;
-}
-
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
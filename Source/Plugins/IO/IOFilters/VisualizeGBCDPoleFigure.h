@@ -169,15 +169,6 @@ class VisualizeGBCDPoleFigure : public AbstractFilter
      */
     void initialize();
 
-
-    /**
-     * @brief getSquareCoord Computes the square based coordinate based on the incoming normal
-     * @param xstl1_norm1 Incoming normal
-     * @param sqCoord Computed square coordinate
-     * @return Boolean value for whether coordinate lies in the norther hemisphere
-     */
-    bool getSquareCoord(float* xstl1_norm1, float* sqCoord);
-
   private:
     DEFINE_DATAARRAY_VARIABLE(double, GBCD)
     DEFINE_DATAARRAY_VARIABLE(unsigned int, CrystalStructures)
@@ -55,24 +55,52 @@ BetaOps::BetaOps()
 //
 // -----------------------------------------------------------------------------
 int BetaOps::calculateParameters(std::vector<float>& data, FloatArrayType::Pointer outputs)
+{
+  float parameters[2] = { 0.0f, 0.0f };
+  int err = calculateParameters(data.empty() ? NULL : &(data.front()), data.size(), parameters);
+  outputs->setValue(0, parameters[0]);
+  outputs->setValue(1, parameters[1]);
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int BetaOps::calculateCorrelatedParameters(std::vector<std::vector<float> >& data, VectorOfFloatArray outputs)
+{
+  int err = 0;
+  float parameters[2] = { 0.0f, 0.0f };
+  for(std::vector<float>::size_type i = 0; i < data.size(); i++)
+  {
+    err = calculateBinParameters(data[i].empty() ? NULL : &(data[i].front()), data[i].size(), parameters);
+    outputs[0]->setValue(i, parameters[0]);
+    outputs[1]->setValue(i, parameters[1]);
+  }
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int BetaOps::calculateParameters(const float* data, size_t count, float* outputs)
 {
   int err = 0;
   float avg = 0;
   float stddev = 0;
   float alpha = 0;
   float beta = 0;
-  if(data.size() > 1)
+  if(count > 1)
   {
-    for(std::vector<float>::size_type i = 0; i < data.size(); i++)
+    for(size_t i = 0; i < count; i++)
     {
       avg = avg + data[i];
     }
-    avg = avg / float(data.size());
-    for(std::vector<float>::size_type i = 0; i < data.size(); i++)
+    avg = avg / float(count);
+    for(size_t i = 0; i < count; i++)
     {
       stddev = stddev + ((avg - data[i]) * (avg - data[i]));
     }
-    stddev = stddev / float(data.size());
+    stddev = stddev / float(count);
     alpha = avg * (((avg * (1 - avg)) / stddev) - 1);
     beta = (1 - avg) * (((avg * (1 - avg)) / stddev) - 1);
   }
@@ -81,55 +109,50 @@ int BetaOps::calculateParameters(std::vector<float>& data, FloatArrayType::Point
     alpha = 0;
     beta = 0;
   }
-  outputs->setValue(0, alpha);
-  outputs->setValue(1, beta);
+  outputs[0] = alpha;
+  outputs[1] = beta;
   return err;
 }
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-int BetaOps::calculateCorrelatedParameters(std::vector<std::vector<float> >& data, VectorOfFloatArray outputs)
+int BetaOps::calculateBinParameters(const float* data, size_t count, float* outputs)
 {
   int err = 0;
   float avg = 0;
   float stddev = 0;
   float alpha = 0;
   float beta = 0;
-  for(std::vector<float>::size_type i = 0; i < data.size(); i++)
+  if(count > 1)
   {
-    avg = 0;
-    stddev = 0;
-    if(data[i].size() > 1)
+    for(size_t j = 0; j < count; j++)
     {
-      for(std::vector<float>::size_type j = 0; j < data[i].size(); j++)
-      {
-        avg = avg + data[i][j];
-      }
-      avg = avg / float(data[i].size());
-      for(std::vector<float>::size_type j = 0; j < data[i].size(); j++)
-      {
-        stddev = stddev + ((avg - data[i][j]) * (avg - data[i][j]));
-      }
-      stddev = stddev / float(data[i].size());
-      if (stddev == 0)
-      {
-        alpha = 0;
-        beta = 0;
-      }
-      else
-      {
-        alpha = avg * (((avg * (1 - avg)) / stddev) - 1);
-        beta = (1 - avg) * (((avg * (1 - avg)) / stddev) - 1);
-      }
+      avg = avg + data[j];
     }
-    else
+    avg = avg / float(count);
+    for(size_t j = 0; j < count; j++)
+    {
+      stddev = stddev + ((avg - data[j]) * (avg - data[j]));
+    }
+    stddev = stddev / float(count);
+    if (stddev == 0)
     {
       alpha = 0;
       beta = 0;
     }
-    outputs[0]->setValue(i, alpha);
-    outputs[1]->setValue(i, beta);
+    else
+    {
+      alpha = avg * (((avg * (1 - avg)) / stddev) - 1);
+      beta = (1 - avg) * (((avg * (1 - avg)) / stddev) - 1);
+    }
+  }
+  else
+  {
+    alpha = 0;
+    beta = 0;
   }
+  outputs[0] = alpha;
+  outputs[1] = beta;
   return err;
 }
-
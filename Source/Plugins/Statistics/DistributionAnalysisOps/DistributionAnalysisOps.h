@@ -61,6 +61,25 @@ class DistributionAnalysisOps
     virtual int calculateParameters(std::vector<float>& data, FloatArrayType::Pointer outputs) = 0;
     virtual int calculateCorrelatedParameters(std::vector<std::vector<float> >& data, VectorOfFloatArray outputs) = 0;
 
+    /**
+     * @brief calculateParameters Fits the distribution to count values stored contiguously
+     * @param data The values; may be NULL when count is 0
+     * @param count Number of values
+     * @param outputs Receives the 2 parameters of the distribution
+     * @return Error code
+     */
+    virtual int calculateParameters(const float* data, size_t count, float* outputs) = 0;
+
+    /**
+     * @brief calculateBinParameters Fits the distribution to the count values of one bin of a correlated
+     * distribution, the way calculateCorrelatedParameters() fits every bin
+     * @param data The values; may be NULL when count is 0
+     * @param count Number of values
+     * @param outputs Receives the 2 parameters of the distribution
+     * @return Error code
+     */
+    virtual int calculateBinParameters(const float* data, size_t count, float* outputs) = 0;
+
     static void determineMaxAndMinValues(std::vector<float>& data, float& max, float& min);
     static void determineBinNumbers(float& max, float& min, float& numbins, FloatArrayType::Pointer binnumbers);
 
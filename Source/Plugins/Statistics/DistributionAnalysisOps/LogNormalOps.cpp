@@ -55,25 +55,61 @@ LogNormalOps::LogNormalOps()
 //
 // -----------------------------------------------------------------------------
 int LogNormalOps::calculateParameters(std::vector<float>& data, FloatArrayType::Pointer outputs)
+{
+  float parameters[2] = { 0.0f, 0.0f };
+  int err = calculateParameters(data.empty() ? NULL : &(data.front()), data.size(), parameters);
+  outputs->setValue(0, parameters[0]);
+  outputs->setValue(1, parameters[1]);
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int LogNormalOps::calculateCorrelatedParameters(std::vector<std::vector<float> >& data, VectorOfFloatArray outputs)
+{
+  int err = 0;
+  float parameters[2] = { 0.0f, 0.0f };
+  for(std::vector<float>::size_type i = 0; i < data.size(); i++)
+  {
+    err = calculateBinParameters(data[i].empty() ? NULL : &(data[i].front()), data[i].size(), parameters);
+    outputs[0]->setValue(i, parameters[0]);
+    outputs[1]->setValue(i, parameters[1]);
+  }
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int LogNormalOps::calculateParameters(const float* data, size_t count, float* outputs)
+{
+  return calculateBinParameters(data, count, outputs);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int LogNormalOps::calculateBinParameters(const float* data, size_t count, float* outputs)
 {
   int err = 0;
   float avg = 0;
   float stddev = 0;
-  if(data.size() > 1)
+  if(count > 1)
   {
-    for(std::vector<float>::size_type i = 0; i < data.size(); i++)
+    for(size_t i = 0; i < count; i++)
     {
       avg = avg + log(data[i]);
     }
-    avg = avg / float(data.size());
-    for(std::vector<float>::size_type i = 0; i < data.size(); i++)
+    avg = avg / float(count);
+    for(size_t i = 0; i < count; i++)
     {
       stddev = stddev + ((avg - log(data[i])) * (avg - log(data[i])));
     }
-    stddev = stddev / float(data.size());
+    stddev = stddev / float(count);
     stddev = sqrt(stddev);
   }
-  else if (data.size() == 1)
+  else if (count == 1)
   {
     avg = data[0];
     stddev = 0;
@@ -83,49 +119,7 @@ int LogNormalOps::calculateParameters(std::vector<float>& data, FloatArrayType::
     avg = 0;
     stddev = 0;
   }
-  outputs->setValue(0, avg);
-  outputs->setValue(1, stddev);
+  outputs[0] = avg;
+  outputs[1] = stddev;
   return err;
 }
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
-int LogNormalOps::calculateCorrelatedParameters(std::vector<std::vector<float> >& data, VectorOfFloatArray outputs)
-{
-  int err = 0;
-  float avg = 0;
-  float stddev = 0;
-  for(std::vector<float>::size_type i = 0; i < data.size(); i++)
-  {
-    avg = 0;
-    stddev = 0;
-    if(data[i].size() > 1)
-    {
-      for(std::vector<float>::size_type j = 0; j < data[i].size(); j++)
-      {
-        avg = avg + log(data[i][j]);
-      }
-      avg = avg / float(data[i].size());
-      for(std::vector<float>::size_type j = 0; j < data[i].size(); j++)
-      {
-        stddev = stddev + ((avg - log(data[i][j])) * (avg - log(data[i][j])));
-      }
-      stddev = stddev / float(data[i].size());
-      stddev = sqrt(stddev);
-    }
-    else if (data[i].size() == 1)
-    {
-      avg = data[i][0];
-      stddev = 0;
-    }
-    else
-    {
-      avg = 0;
-      stddev = 0;
-    }
-    outputs[0]->setValue(i, avg);
-    outputs[1]->setValue(i, stddev);
-  }
-  return err;
-}
-
@@ -57,73 +57,93 @@ PowerLawOps::PowerLawOps()
 //
 // -----------------------------------------------------------------------------
 int PowerLawOps::calculateParameters(std::vector<float>& data, FloatArrayType::Pointer outputs)
+{
+  float parameters[2] = { 0.0f, 0.0f };
+  int err = calculateParameters(data.empty() ? NULL : &(data.front()), data.size(), parameters);
+  outputs->setValue(0, parameters[0]);
+  outputs->setValue(1, parameters[1]);
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PowerLawOps::calculateCorrelatedParameters(std::vector<std::vector<float> >& data, VectorOfFloatArray outputs)
+{
+  int err = 0;
+  float parameters[2] = { 0.0f, 0.0f };
+  for(std::vector<float>::size_type i = 0; i < data.size(); i++)
+  {
+    err = calculateBinParameters(data[i].empty() ? NULL : &(data[i].front()), data[i].size(), parameters);
+    outputs[0]->setValue(i, parameters[0]);
+    outputs[1]->setValue(i, parameters[1]);
+  }
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PowerLawOps::calculateParameters(const float* data, size_t count, float* outputs)
 {
   int err = 0;
   float alpha = 0;
   float min = std::numeric_limits<float>::max();
-  if(data.size() > 1)
+  if(count > 1)
   {
-    for(std::vector<float>::size_type i = 0; i < data.size(); i++)
+    for(size_t i = 0; i < count; i++)
     {
       if (data[i] < min)
       {
         min = data[i];
       }
     }
-    for(std::vector<float>::size_type i = 0; i < data.size(); i++)
+    for(size_t i = 0; i < count; i++)
     {
       alpha = alpha + log(data[i] / min);
     }
     alpha = 1.0f / alpha;
-    alpha = 1 + (alpha * data.size());
+    alpha = 1 + (alpha * count);
   }
   else
   {
     min = 0;
     alpha = 0;
   }
-  outputs->setValue(0, alpha);
-  outputs->setValue(1, min);
+  outputs[0] = alpha;
+  outputs[1] = min;
   return err;
 }
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-int PowerLawOps::calculateCorrelatedParameters(std::vector<std::vector<float> >& data, VectorOfFloatArray outputs)
+int PowerLawOps::calculateBinParameters(const float* data, size_t count, float* outputs)
 {
   int err = 0;
   float alpha = 0;
-  float min;
-  for(std::vector<float>::size_type i = 0; i < data.size(); i++)
+  float min = 0;
+  if(count > 1)
   {
-    if(data[i].size() > 1)
+    min = std::numeric_limits<float>::max();
+    for(size_t j = 0; j < count; j++)
     {
-      min = std::numeric_limits<float>::max();
-      for(std::vector<float>::size_type j = 0; j < data[i].size(); j++)
+      if (data[j] < min)
       {
-        if (data[i][j] < min)
-        {
-          min = data[i][j];
-        }
+        min = data[j];
       }
-      for(std::vector<float>::size_type j = 0; j < data[i].size(); j++)
-      {
-        alpha = alpha + log(data[i][j] / min);
-      }
-      if(alpha != 0.0f)
-      {
-        alpha = 1.0f / alpha;
-      }
-      alpha = 1.0f + (alpha * data[i].size());
     }
-    else
+    for(size_t j = 0; j < count; j++)
     {
-      min = 0;
-      alpha = 0;
+      alpha = alpha + log(data[j] / min);
     }
-    outputs[0]->setValue(i, alpha);
-    outputs[1]->setValue(i, min);
+    if(alpha != 0.0f)
+    {
+      alpha = 1.0f / alpha;
+    }
+    alpha = 1.0f + (alpha * count);
   }
+  outputs[0] = alpha;
+  outputs[1] = min;
   return err;
 }
-
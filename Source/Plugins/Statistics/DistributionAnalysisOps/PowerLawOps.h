@@ -62,6 +62,9 @@ class PowerLawOps : public DistributionAnalysisOps
     int calculateParameters(std::vector<float>& data, FloatArrayType::Pointer outputs);
     int calculateCorrelatedParameters(std::vector<std::vector<float> >& data, VectorOfFloatArray outputs);
 
+    int calculateParameters(const float* data, size_t count, float* outputs);
+    int calculateBinParameters(const float* data, size_t count, float* outputs);
+
   protected:
     PowerLawOps();
 
@@ -35,6 +35,9 @@
 
 #include "CalculateArrayHistogram.h"
 
+#include <limits>
+#include <vector>
+
 #include "SIMPLib/Common/Constants.h"
 #include "SIMPLib/Common/TemplateHelpers.hpp"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
@@ -47,6 +50,7 @@
 
 #include "Statistics/StatisticsConstants.h"
 #include "Statistics/StatisticsVersion.h"
+#include "Statistics/StatisticsFilters/util/HistogramEngine.hpp"
 
 // Include the MOC generated file for this class
 #include "moc_CalculateArrayHistogram.cpp"
@@ -63,6 +67,8 @@ CalculateArrayHistogram::CalculateArrayHistogram() :
   m_MinRange(0.0f),
   m_MaxRange(1.0f),
   m_UserDefinedRange(false),
+  m_ExcludeOutliers(false),
+  m_OutlierFraction(0.01),
   m_Normalize(false),
   m_NewAttributeMatrixName(SIMPL::Defaults::NewAttributeMatrixName),
   m_NewDataArrayName(SIMPL::CellData::Histogram),
@@ -95,6 +101,10 @@ void CalculateArrayHistogram::setupFilterParameters()
   parameters.push_back(SIMPL_NEW_DOUBLE_FP("Min Value", MinRange, FilterParameter::Parameter, CalculateArrayHistogram));
   parameters.push_back(SIMPL_NEW_DOUBLE_FP("Max Value", MaxRange, FilterParameter::Parameter, CalculateArrayHistogram));
   linkedProps.clear();
+  linkedProps << "OutlierFraction";
+  parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Exclude Outliers", ExcludeOutliers, FilterParameter::Parameter, CalculateArrayHistogram, linkedProps));
+  parameters.push_back(SIMPL_NEW_DOUBLE_FP("Outlier Fraction", OutlierFraction, FilterParameter::Parameter, CalculateArrayHistogram));
+  linkedProps.clear();
   linkedProps << "NewDataContainerName";
   parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("New Data Container", NewDataContainer, FilterParameter::Parameter, CalculateArrayHistogram, linkedProps));
   {
@@ -167,6 +177,14 @@ void CalculateArrayHistogram::dataCheck()
     return;
   }
 
+  if (m_UserDefinedRange == false && m_ExcludeOutliers == true && (m_OutlierFraction < 0.0 || m_OutlierFraction >= 0.5))
+  {
+    setErrorCondition(-11012);
+    QString ss = QObject::tr("The outlier fraction (%1) must be at least 0 and less than 0.5").arg(m_OutlierFraction);
+    notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+    return;
+  }
+
   QVector<size_t> tDims(1, m_NumberOfBins);
   QVector<size_t> cDims(1, 2);
 
@@ -233,7 +251,7 @@ void CalculateArrayHistogram::preflight()
 //
 // -----------------------------------------------------------------------------
 template<typename T>
-void findHistogram(IDataArray::Pointer inDataPtr, int32_t numberOfBins, bool userRange, double minRange, double maxRange, DoubleArrayType::Pointer newDataArray)
+void findHistogram(IDataArray::Pointer inDataPtr, int32_t numberOfBins, bool userRange, double minRange, double maxRange, bool excludeOutliers, double outlierFraction, DoubleArrayType::Pointer newDataArray)
 {
   typename DataArray<T>::Pointer inputDataPtr = std::dynamic_pointer_cast<DataArray<T> >(inDataPtr);
 
@@ -242,21 +260,18 @@ void findHistogram(IDataArray::Pointer inDataPtr, int32_t numberOfBins, bool use
 
   T* inputArrayPtr = inputDataPtr->getPointer(0);
   size_t numPoints = inputDataPtr->getNumberOfTuples();
-  int32_t bin = 0;
   float min = std::numeric_limits<float>::max();
   float max = -1.0 * std::numeric_limits<float>::max();
+
+  HistogramEngine<T> engine(inputArrayPtr, numPoints, inputDataPtr->getNumberOfComponents());
   if (userRange)
   {
     min = minRange;
     max = maxRange;
   }
-  else
+  else if (excludeOutliers == false || engine.findQuantileRange(outlierFraction, 1.0 - outlierFraction, min, max) == false)
   {
-    for (size_t i = 0; i < numPoints; i++) // min and max in the input array
-    {
-      if (static_cast<float>(inputArrayPtr[i]) > max) { max = static_cast<float>(inputArrayPtr[i]); }
-      if (static_cast<float>(inputArrayPtr[i]) < min) { min = static_cast<float>(inputArrayPtr[i]); }
-    }
+    engine.findRange(min, max); // min and max in the input array
   }
 
   float increment = (max - min) / (numberOfBins);
@@ -267,13 +282,12 @@ void findHistogram(IDataArray::Pointer inDataPtr, int32_t numberOfBins, bool use
   }
   else
   {
-    for (size_t i = 0; i < numPoints; i++) // sort into bins to create the histogram
+    // sort into bins to create the histogram; values outside the range are not counted
+    std::vector<uint64_t> counts;
+    engine.findCounts(min, increment, numberOfBins, counts);
+    for (int32_t i = 0; i < numberOfBins; i++)
     {
-      bin = size_t((inputArrayPtr[i] - min) / increment); // find bin for this input array value
-      if ((bin >= 0) && (bin < numberOfBins)) // make certain bin is in range
-      {
-        newDataArrayPtr[bin * 2 + 1]++; // increment histogram element corresponding to this input array value
-      }
+      newDataArrayPtr[i * 2 + 1] = static_cast<double>(counts[i]);
     }
   }
 
@@ -300,7 +314,7 @@ void CalculateArrayHistogram::execute()
   dataCheck();
   if (getErrorCondition() < 0) { return; }
 
-  EXECUTE_FUNCTION_TEMPLATE(this, findHistogram, m_InDataArrayPtr.lock(), m_InDataArrayPtr.lock(), m_NumberOfBins, m_UserDefinedRange, m_MinRange, m_MaxRange, m_NewDataArrayPtr.lock())
+  EXECUTE_FUNCTION_TEMPLATE(this, findHistogram, m_InDataArrayPtr.lock(), m_InDataArrayPtr.lock(), m_NumberOfBins, m_UserDefinedRange, m_MinRange, m_MaxRange, m_ExcludeOutliers, m_OutlierFraction, m_NewDataArrayPtr.lock())
 
   notifyStatusMessage(getHumanLabel(), "Complete");
 }
@@ -69,6 +69,12 @@ class CalculateArrayHistogram : public AbstractFilter
     SIMPL_FILTER_PARAMETER(bool, UserDefinedRange)
     Q_PROPERTY(bool UserDefinedRange READ getUserDefinedRange WRITE setUserDefinedRange)
 
+    SIMPL_FILTER_PARAMETER(bool, ExcludeOutliers)
+    Q_PROPERTY(bool ExcludeOutliers READ getExcludeOutliers WRITE setExcludeOutliers)
+
+    SIMPL_FILTER_PARAMETER(double, OutlierFraction)
+    Q_PROPERTY(double OutlierFraction READ getOutlierFraction WRITE setOutlierFraction)
+
     SIMPL_FILTER_PARAMETER(bool, Normalize)
     Q_PROPERTY(bool Normalize READ getNormalize WRITE setNormalize)
 
@@ -41,6 +41,9 @@
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/DataArrayCreationFilterParameter.h"
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+#include "Generic/GenericFilters/util/FeatureReductionEngine.hpp"
 
 #include "Statistics/StatisticsConstants.h"
 #include "Statistics/StatisticsVersion.h"
@@ -164,7 +167,7 @@ void FindAvgScalarValueForFeatures::preflight()
 //
 // -----------------------------------------------------------------------------
 template<typename T>
-void findAverage(IDataArray::Pointer inDataPtr, FloatArrayType::Pointer averageArray, int32_t* fIds)
+void findAverage(IDataArray::Pointer inDataPtr, FloatArrayType::Pointer averageArray, int32_t* fIds, ImageGeom::Pointer image)
 {
   typename DataArray<T>::Pointer inputDataPtr = std::dynamic_pointer_cast<DataArray<T> >(inDataPtr);
 
@@ -173,21 +176,19 @@ void findAverage(IDataArray::Pointer inDataPtr, FloatArrayType::Pointer averageA
   size_t numPoints = inputDataPtr->getNumberOfTuples();
   size_t numFeatures = averageArray->getNumberOfTuples();
 
-  std::vector<float> counts(numFeatures, 0.0f);
+  // the cells of an image are reduced row by row; the cells of any other geometry are handed over as a column of
+  // single cell rows, so that they can still be split between threads
+  size_t dims[3] = { 1, numPoints, 1 };
+  bool isImage = (NULL != image.get() && image->getNumberOfElements() == numPoints);
+  if (isImage == true) { image->getDimensions(dims); }
 
-  int32_t feature = 0;
-  float value = 0.0f;
-  for (size_t i = 0; i < numPoints; i++)
-  {
-    value = float(cPtr[i]);
-    feature = fIds[i];
-    aPtr[feature] += value;
-    counts[feature] += 1.0f;
-  }
+  FeatureReductionEngine::Pointer engine = FeatureReductionEngine::ComputeWithScalars(fIds, dims, numFeatures, cPtr);
+
+  aPtr[0] = static_cast<float>(engine->getScalarSum(0));
   for (size_t i = 1; i < numFeatures; i++)
   {
-    if (counts[i] == 0) { aPtr[i] = 0; }
-    else { aPtr[i] /= counts[i]; }
+    if (engine->getCount(i) == 0) { aPtr[i] = 0; }
+    else { aPtr[i] = static_cast<float>(engine->getScalarSum(i) / static_cast<double>(engine->getCount(i))); }
   }
 }
 
@@ -200,7 +201,10 @@ void FindAvgScalarValueForFeatures::execute()
   dataCheck();
   if(getErrorCondition() < 0) { return; }
 
-  EXECUTE_FUNCTION_TEMPLATE(this, findAverage, m_InDataArrayPtr.lock(), m_InDataArrayPtr.lock(), m_NewFeatureArrayPtr.lock(), m_FeatureIds)
+  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getFeatureIdsArrayPath().getDataContainerName());
+  ImageGeom::Pointer image = m->getGeometryAs<ImageGeom>();
+
+  EXECUTE_FUNCTION_TEMPLATE(this, findAverage, m_InDataArrayPtr.lock(), m_InDataArrayPtr.lock(), m_NewFeatureArrayPtr.lock(), m_FeatureIds, image)
 
   notifyStatusMessage(getHumanLabel(), "Complete");
 }
@@ -35,7 +35,16 @@
 
 #include "FindFeatureClustering.h"
 
+#include <algorithm>
 #include <fstream>
+#include <vector>
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
 
 #include "SIMPLib/Common/Constants.h"
 #include "SIMPLib/Math/SIMPLibMath.h"
@@ -55,6 +64,134 @@
 // Include the MOC generated file for this class
 #include "moc_FindFeatureClustering.cpp"
 
+/**
+ * @brief The FindClusteringImpl class computes, for each Feature of the phase in a range, the distances from its
+ * centroid to the centroids of all other Features of the phase in ascending Feature order, together with the
+ * smallest and largest of those distances.
+ */
+class FindClusteringImpl
+{
+    const float* m_Centroids;
+    const size_t* m_PhaseFeatures;
+    size_t m_NumPhaseFeatures;
+    std::vector<float>* m_ClusteringList;
+    float* m_Min;
+    float* m_Max;
+
+  public:
+    FindClusteringImpl(const float* centroids, const size_t* phaseFeatures, size_t numPhaseFeatures, std::vector<float>* clusteringList, float* min, float* max) :
+      m_Centroids(centroids),
+      m_PhaseFeatures(phaseFeatures),
+      m_NumPhaseFeatures(numPhaseFeatures),
+      m_ClusteringList(clusteringList),
+      m_Min(min),
+      m_Max(max)
+    {}
+
+    virtual ~FindClusteringImpl() {}
+
+    void compute(size_t start, size_t end) const
+    {
+      for (size_t n = start; n < end; n++)
+      {
+        size_t i = m_PhaseFeatures[n];
+        float x = m_Centroids[3 * i];
+        float y = m_Centroids[3 * i + 1];
+        float z = m_Centroids[3 * i + 2];
+        float min = m_Min[n];
+        float max = m_Max[n];
+        std::vector<float>& distances = m_ClusteringList[i];
+        distances.resize(m_NumPhaseFeatures - 1);
+        size_t k = 0;
+        for (size_t m = 0; m < m_NumPhaseFeatures; m++)
+        {
+          if (m == n) { continue; }
+          size_t j = m_PhaseFeatures[m];
+          float xn = m_Centroids[3 * j];
+          float yn = m_Centroids[3 * j + 1];
+          float zn = m_Centroids[3 * j + 2];
+          float r = sqrtf((x - xn) * (x - xn) + (y - yn) * (y - yn) + (z - zn) * (z - zn));
+          distances[k++] = r;
+          if (r > max) { max = r; }
+          if (r < min) { min = r; }
+        }
+        m_Min[n] = min;
+        m_Max[n] = max;
+      }
+    }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+    void operator()(const tbb::blocked_range<size_t>& r) const
+    {
+      compute(r.begin(), r.end());
+    }
+#endif
+};
+
+/**
+ * @brief The ClusteringHistogramImpl class bins the distances of the Features of the phase, giving every chunk of
+ * Features its own counts so that the chunks may be binned concurrently.
+ */
+class ClusteringHistogramImpl
+{
+    const std::vector<float>* m_ClusteringList;
+    const size_t* m_PhaseFeatures;
+    size_t m_NumPhaseFeatures;
+    const bool* m_BiasedFeatures;
+    float m_Min;
+    float m_StepSize;
+    int32_t m_NumBins;
+    size_t m_NumChunks;
+    std::vector<uint64_t>* m_ChunkCounts;
+
+  public:
+    ClusteringHistogramImpl(const std::vector<float>* clusteringList, const size_t* phaseFeatures, size_t numPhaseFeatures, const bool* biasedFeatures, float min, float stepSize,
+                            int32_t numBins, size_t numChunks, std::vector<uint64_t>* chunkCounts) :
+      m_ClusteringList(clusteringList),
+      m_PhaseFeatures(phaseFeatures),
+      m_NumPhaseFeatures(numPhaseFeatures),
+      m_BiasedFeatures(biasedFeatures),
+      m_Min(min),
+      m_StepSize(stepSize),
+      m_NumBins(numBins),
+      m_NumChunks(numChunks),
+      m_ChunkCounts(chunkCounts)
+    {}
+
+    virtual ~ClusteringHistogramImpl() {}
+
+    void count(size_t start, size_t end) const
+    {
+      for (size_t c = start; c < end; c++)
+      {
+        std::vector<uint64_t>& counts = m_ChunkCounts[c];
+        counts.assign(m_NumBins, 0);
+        size_t first = (c * m_NumPhaseFeatures) / m_NumChunks;
+        size_t last = ((c + 1) * m_NumPhaseFeatures) / m_NumChunks;
+        for (size_t n = first; n < last; n++)
+        {
+          size_t i = m_PhaseFeatures[n];
+          if (NULL != m_BiasedFeatures && m_BiasedFeatures[i] == true) { continue; }
+          const std::vector<float>& distances = m_ClusteringList[i];
+          size_t numDistances = distances.size();
+          for (size_t k = 0; k < numDistances; k++)
+          {
+            int32_t bin = (distances[k] - m_Min) / m_StepSize;
+            if (bin >= m_NumBins) { bin = m_NumBins - 1; }
+            counts[bin]++;
+          }
+        }
+      }
+    }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+    void operator()(const tbb::blocked_range<size_t>& r) const
+    {
+      count(r.begin(), r.end());
+    }
+#endif
+};
+
 
 
 // -----------------------------------------------------------------------------
@@ -237,16 +374,9 @@ void FindFeatureClustering::find_clustering()
     writeErrorFile = true;
   }
 
-  float x = 0.0f, y = 0.0f, z = 0.0f;
-  float xn = 0.0f, yn = 0.0f, zn = 0.0f;
-  float r = 0.0f;
-
-  int32_t bin = 0;
-  int32_t ensemble = 0;
   int32_t totalPPTfeatures = 0;
   float min = std::numeric_limits<float>::max();
   float max = 0.0f;
-  float value = 0.0f;
   float sizex = 0.0f, sizey = 0.0f, sizez = 0.0f, totalvol = 0.0f, totalpoints = 0.0f;
   float normFactor = 0.0f;
 
@@ -277,58 +407,67 @@ void FindFeatureClustering::find_clustering()
   boxres[1] = m->getGeometryAs<ImageGeom>()->getYRes();
   boxres[2] = m->getGeometryAs<ImageGeom>()->getZRes();
 
+  std::vector<size_t> phaseFeatures;
   for (size_t i = 1; i < totalFeatures; i++)
   {
-    if (m_FeaturePhases[i] == m_PhaseNumber) {totalPPTfeatures++;}
+    if (m_FeaturePhases[i] == m_PhaseNumber) { phaseFeatures.push_back(i); }
   }
+  size_t numPhaseFeatures = phaseFeatures.size();
+  totalPPTfeatures = static_cast<int32_t>(numPhaseFeatures);
 
   clusteringlist.resize(totalFeatures);
 
-  for (size_t i = 1; i < totalFeatures; i++)
-  {
-    if (m_FeaturePhases[i] == m_PhaseNumber)
-    {
-      if (i % 1000 == 0)
-      {
-        QString ss = QObject::tr("Working on Feature %1 of %2").arg(i).arg(totalPPTfeatures);
-        notifyStatusMessage(getMessagePrefix(), getHumanLabel(), ss);
-      }
+  // Every Feature of the phase is paired with every other one, so there is no cutoff distance to search within;
+  // the distance list of each Feature is computed on its own instead, which lets the Features run concurrently
+  std::vector<float> featureMin(numPhaseFeatures, std::numeric_limits<float>::max());
+  std::vector<float> featureMax(numPhaseFeatures, 0.0f);
 
-      x = m_Centroids[3 * i];
-      y = m_Centroids[3 * i + 1];
-      z = m_Centroids[3 * i + 2];
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+  tbb::task_scheduler_init init;
+  bool doParallel = true;
+#endif
 
-      for (size_t j = i + 1; j < totalFeatures; j++)
-      {
-        if (m_FeaturePhases[i] == m_FeaturePhases[j])
-        {
-          xn = m_Centroids[3 * j];
-          yn = m_Centroids[3 * j + 1];
-          zn = m_Centroids[3 * j + 2];
-
-          r = sqrtf((x - xn) * (x - xn) + (y - yn) * (y - yn) + (z - zn) * (z - zn));
-
-          clusteringlist[i].push_back(r);
-          clusteringlist[j].push_back(r);
+  size_t featuresPerBlock = 1000;
+  for (size_t start = 0; start < numPhaseFeatures; start += featuresPerBlock)
+  {
+    if (start > 0)
+    {
+      QString ss = QObject::tr("Working on Feature %1 of %2").arg(start).arg(totalPPTfeatures);
+      notifyStatusMessage(getMessagePrefix(), getHumanLabel(), ss);
+    }
+    if (getCancel() == true) { return; }
+    size_t end = std::min(start + featuresPerBlock, numPhaseFeatures);
 
-          if (writeErrorFile == true && m_FeaturePhases[j] == 2)
-          {
-            outFile << r << "\n" << r << "\n";
-          }
-        }
-      }
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+    if (doParallel == true)
+    {
+      tbb::parallel_for(tbb::blocked_range<size_t>(start, end),
+                        FindClusteringImpl(m_Centroids, &(phaseFeatures.front()), numPhaseFeatures, &(clusteringlist.front()), &(featureMin.front()), &(featureMax.front())),
+                        tbb::auto_partitioner());
+    }
+    else
+#endif
+    {
+      FindClusteringImpl serial(m_Centroids, &(phaseFeatures.front()), numPhaseFeatures, &(clusteringlist.front()), &(featureMin.front()), &(featureMax.front()));
+      serial.compute(start, end);
     }
   }
 
-  for (size_t i = 1; i < totalFeatures; i++)
+  for (size_t n = 0; n < numPhaseFeatures; n++)
   {
-    for (size_t j = 0; j < clusteringlist[i].size(); j++)
+    if (featureMax[n] > max) { max = featureMax[n]; }
+    if (featureMin[n] < min) { min = featureMin[n]; }
+  }
+
+  // The list of a Feature is in ascending Feature order, so its distances to the later Features are at its end
+  if (writeErrorFile == true && outFile.is_open() == true && m_PhaseNumber == 2)
+  {
+    for (size_t n = 0; n < numPhaseFeatures; n++)
     {
-      if (m_FeaturePhases[i] == m_PhaseNumber)
+      const std::vector<float>& distances = clusteringlist[phaseFeatures[n]];
+      for (size_t k = n; k < distances.size(); k++)
       {
-        value = clusteringlist[i][j];
-        if (value > max) { max = value; }
-        if (value < min) { min = value; }
+        outFile << distances[k] << "\n" << distances[k] << "\n";
       }
     }
   }
@@ -338,21 +477,37 @@ void FindFeatureClustering::find_clustering()
   m_MaxMinArray[(m_PhaseNumber * 2)] = max;
   m_MaxMinArray[(m_PhaseNumber * 2) + 1] = min;
 
-  for (size_t i = 1; i < totalFeatures; i++)
+  size_t numChunks = 1;
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+  numChunks = tbb::task_scheduler_init::default_num_threads();
+#endif
+  numChunks = std::max(std::min(numChunks, numPhaseFeatures), static_cast<size_t>(1));
+  std::vector<std::vector<uint64_t> > chunkCounts(numChunks);
+  const bool* biasedFeatures = (m_RemoveBiasedFeatures == true) ? m_BiasedFeatures : NULL;
+  if (numPhaseFeatures > 0)
   {
-    for (size_t j = 0; j < clusteringlist[i].size(); j++)
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+    if (doParallel == true)
     {
-      if (m_FeaturePhases[i] == m_PhaseNumber)
-      {
-        if (m_RemoveBiasedFeatures == false || m_BiasedFeatures[i] == false)
-        {
-          ensemble = m_FeaturePhases[i];
-          bin = (clusteringlist[i][j] - min) / stepsize;
-          if(bin >= m_NumberOfBins) { bin = m_NumberOfBins - 1; }
-          m_NewEnsembleArray[(m_NumberOfBins * ensemble) + bin]++;
-        }
-      }
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, numChunks),
+                        ClusteringHistogramImpl(&(clusteringlist.front()), &(phaseFeatures.front()), numPhaseFeatures, biasedFeatures, min, stepsize, m_NumberOfBins, numChunks, &(chunkCounts.front())),
+                        tbb::auto_partitioner());
+    }
+    else
+#endif
+    {
+      ClusteringHistogramImpl serial(&(clusteringlist.front()), &(phaseFeatures.front()), numPhaseFeatures, biasedFeatures, min, stepsize, m_NumberOfBins, numChunks, &(chunkCounts.front()));
+      serial.count(0, numChunks);
+    }
+  }
+  for (int32_t b = 0; b < m_NumberOfBins; b++)
+  {
+    uint64_t total = 0;
+    for (size_t c = 0; c < numChunks; c++)
+    {
+      if (chunkCounts[c].empty() == false) { total += chunkCounts[c][b]; }
     }
+    m_NewEnsembleArray[(m_NumberOfBins * m_PhaseNumber) + b] += static_cast<float>(total);
   }
 
   // Generate random distribution based on same box size and same stepsize
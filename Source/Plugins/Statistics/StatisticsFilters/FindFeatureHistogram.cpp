@@ -35,10 +35,13 @@
 
 #include "FindFeatureHistogram.h"
 
+#include <vector>
+
 #include "SIMPLib/Common/Constants.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/DataArrayCreationFilterParameter.h"
+#include "SIMPLib/FilterParameters/DoubleFilterParameter.h"
 #include "SIMPLib/FilterParameters/LinkedBooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/ChoiceFilterParameter.h"
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
@@ -46,6 +49,7 @@
 #include "Statistics/DistributionAnalysisOps/BetaOps.h"
 #include "Statistics/DistributionAnalysisOps/PowerLawOps.h"
 #include "Statistics/DistributionAnalysisOps/LogNormalOps.h"
+#include "Statistics/StatisticsFilters/util/HistogramEngine.hpp"
 
 // Include the MOC generated file for this class
 #include "moc_FindFeatureHistogram.cpp"
@@ -60,6 +64,8 @@ FindFeatureHistogram::FindFeatureHistogram() :
   m_SelectedFeatureArrayPath("", "", ""),
   m_NumberOfBins(1),
   m_RemoveBiasedFeatures(false),
+  m_ExcludeOutliers(false),
+  m_OutlierFraction(0.01),
   m_FeaturePhasesArrayPath("", "", ""),
   m_BiasedFeaturesArrayPath("", "", ""),
   m_NewEnsembleArrayArrayPath("", "", ""),
@@ -95,6 +101,10 @@ void FindFeatureHistogram::setupFilterParameters()
   }
   QStringList linkedProps("BiasedFeaturesArrayPath");
   parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Remove Biased Features", RemoveBiasedFeatures, FilterParameter::Parameter, FindFeatureHistogram, linkedProps));
+  linkedProps.clear();
+  linkedProps << "OutlierFraction";
+  parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Exclude Outliers", ExcludeOutliers, FilterParameter::Parameter, FindFeatureHistogram, linkedProps));
+  parameters.push_back(SIMPL_NEW_DOUBLE_FP("Outlier Fraction", OutlierFraction, FilterParameter::Parameter, FindFeatureHistogram));
   {
     DataArraySelectionFilterParameter::RequirementType req;
     parameters.push_back(SIMPL_NEW_DA_SELECTION_FP("Feature Array To Bin", SelectedFeatureArrayPath, FilterParameter::RequiredArray, FindFeatureHistogram, req));
@@ -128,6 +138,8 @@ void FindFeatureHistogram::readFilterParameters(AbstractFilterParametersReader*
   setSelectedFeatureArrayPath( reader->readDataArrayPath( "SelectedFeatureArrayPath", getSelectedFeatureArrayPath() ) );
   setNumberOfBins( reader->readValue( "NumberOfBins", getNumberOfBins() ) );
   setRemoveBiasedFeatures( reader->readValue( "RemoveBiasedFeatures", getRemoveBiasedFeatures() ) );
+  setExcludeOutliers( reader->readValue( "ExcludeOutliers", getExcludeOutliers() ) );
+  setOutlierFraction( reader->readValue( "OutlierFraction", getOutlierFraction() ) );
   reader->closeFilterGroup();
 }
 
@@ -157,6 +169,13 @@ void FindFeatureHistogram::dataCheck()
     notifyErrorMessage(getHumanLabel(), "An array from the Volume DataContainer must be selected.", getErrorCondition());
   }
 
+  if (m_ExcludeOutliers == true && (m_OutlierFraction < 0.0 || m_OutlierFraction >= 0.5))
+  {
+    setErrorCondition(-11002);
+    QString ss = QObject::tr("The outlier fraction (%1) must be at least 0 and less than 0.5").arg(m_OutlierFraction);
+    notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+  }
+
   int numComp = m_NumberOfBins;
   getNewEnsembleArrayArrayPath().setDataArrayName(m_SelectedFeatureArrayPath.getDataArrayName() + QString("Histogram"));
   dims[0] = numComp;
@@ -190,7 +209,8 @@ void FindFeatureHistogram::preflight()
 //
 // -----------------------------------------------------------------------------
 template<typename T>
-void findHistogram(IDataArray::Pointer inputData, int32_t* ensembleArray, int32_t* eIds, int NumberOfBins, bool removeBiasedFeatures, bool* biasedFeatures)
+void findHistogram(IDataArray::Pointer inputData, int32_t* ensembleArray, int32_t numEnsembles, int32_t* eIds, int NumberOfBins, bool removeBiasedFeatures, bool* biasedFeatures,
+                   bool excludeOutliers, double outlierFraction)
 {
   DataArray<T>* featureArray = DataArray<T>::SafePointerDownCast(inputData.get());
   if (NULL == featureArray)
@@ -201,28 +221,29 @@ void findHistogram(IDataArray::Pointer inputData, int32_t* ensembleArray, int32_
   T* fPtr = featureArray->getPointer(0);
   size_t numfeatures = featureArray->getNumberOfTuples();
 
-  int32_t bin;
-  int32_t ensemble;
+  HistogramEngine<T> engine(fPtr, numfeatures, 1);
+  engine.setTupleRange(1, numfeatures);
+
+  // the range is taken over all Features, biased or not; the Features outside a range that excludes the outliers are
+  // counted in the first or last bin
   float min = 1000000.0f;
   float max = 0.0f;
-  float value;
-  for (size_t i = 1; i < numfeatures; i++)
+  if (excludeOutliers == false || engine.findQuantileRange(outlierFraction, 1.0 - outlierFraction, min, max) == false)
   {
-    value = fPtr[i];
-    if(value > max) { max = value; }
-    if(value < min) { min = value; }
+    engine.findRange(min, max);
   }
   float stepsize = (max - min) / NumberOfBins;
 
-  for (size_t i = 1; i < numfeatures; i++)
+  if (removeBiasedFeatures == true) { engine.setMask(biasedFeatures, false); }
+  engine.setGroups(eIds, numEnsembles);
+  engine.setClampToFirstBin(excludeOutliers);
+  engine.setClampToLastBin(true);
+  std::vector<uint64_t> counts;
+  engine.findCounts(min, stepsize, NumberOfBins, counts);
+  size_t numCounts = counts.size();
+  for (size_t i = 0; i < numCounts; i++)
   {
-    if(removeBiasedFeatures == false || biasedFeatures[i] == false)
-    {
-      ensemble = eIds[i];
-      bin = (fPtr[i] - min) / stepsize;
-      if(bin >= NumberOfBins) { bin = NumberOfBins - 1; }
-      ensembleArray[(NumberOfBins * ensemble) + bin]++;
-    }
+    ensembleArray[i] += static_cast<int32_t>(counts[i]);
   }
 }
 
@@ -248,51 +269,52 @@ void FindFeatureHistogram::execute()
     return;
   }
 
+  int32_t numEnsembles = static_cast<int32_t>(m_NewEnsembleArrayPtr.lock()->getNumberOfTuples());
   QString dType = inputData->getTypeAsString();
   IDataArray::Pointer p = IDataArray::NullPointer();
   if (dType.compare("int8_t") == 0)
   {
-    findHistogram<int8_t>(inputData, m_NewEnsembleArray, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures);
+    findHistogram<int8_t>(inputData, m_NewEnsembleArray, numEnsembles, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures, m_ExcludeOutliers, m_OutlierFraction);
   }
   else if (dType.compare("uint8_t") == 0)
   {
-    findHistogram<uint8_t>(inputData, m_NewEnsembleArray, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures);
+    findHistogram<uint8_t>(inputData, m_NewEnsembleArray, numEnsembles, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures, m_ExcludeOutliers, m_OutlierFraction);
   }
   else if (dType.compare("int16_t") == 0)
   {
-    findHistogram<int16_t>(inputData, m_NewEnsembleArray, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures);
+    findHistogram<int16_t>(inputData, m_NewEnsembleArray, numEnsembles, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures, m_ExcludeOutliers, m_OutlierFraction);
   }
   else if (dType.compare("uint16_t") == 0)
   {
-    findHistogram<uint16_t>(inputData, m_NewEnsembleArray, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures);
+    findHistogram<uint16_t>(inputData, m_NewEnsembleArray, numEnsembles, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures, m_ExcludeOutliers, m_OutlierFraction);
   }
   else if (dType.compare("int32_t") == 0)
   {
-    findHistogram<int32_t>(inputData, m_NewEnsembleArray, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures);
+    findHistogram<int32_t>(inputData, m_NewEnsembleArray, numEnsembles, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures, m_ExcludeOutliers, m_OutlierFraction);
   }
   else if (dType.compare("uint32_t") == 0)
   {
-    findHistogram<uint32_t>(inputData, m_NewEnsembleArray, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures);
+    findHistogram<uint32_t>(inputData, m_NewEnsembleArray, numEnsembles, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures, m_ExcludeOutliers, m_OutlierFraction);
   }
   else if (dType.compare("int64_t") == 0)
   {
-    findHistogram<int64_t>(inputData, m_NewEnsembleArray, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures);
+    findHistogram<int64_t>(inputData, m_NewEnsembleArray, numEnsembles, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures, m_ExcludeOutliers, m_OutlierFraction);
   }
   else if (dType.compare("uint64_t") == 0)
   {
-    findHistogram<uint64_t>(inputData, m_NewEnsembleArray, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures);
+    findHistogram<uint64_t>(inputData, m_NewEnsembleArray, numEnsembles, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures, m_ExcludeOutliers, m_OutlierFraction);
   }
   else if (dType.compare("float") == 0)
   {
-    findHistogram<float>(inputData, m_NewEnsembleArray, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures);
+    findHistogram<float>(inputData, m_NewEnsembleArray, numEnsembles, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures, m_ExcludeOutliers, m_OutlierFraction);
   }
   else if (dType.compare("double") == 0)
   {
-    findHistogram<double>(inputData, m_NewEnsembleArray, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures);
+    findHistogram<double>(inputData, m_NewEnsembleArray, numEnsembles, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures, m_ExcludeOutliers, m_OutlierFraction);
   }
   else if (dType.compare("bool") == 0)
   {
-    findHistogram<bool>(inputData, m_NewEnsembleArray, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures);
+    findHistogram<bool>(inputData, m_NewEnsembleArray, numEnsembles, m_FeaturePhases, m_NumberOfBins, m_RemoveBiasedFeatures, m_BiasedFeatures, m_ExcludeOutliers, m_OutlierFraction);
   }
 
   notifyStatusMessage(getHumanLabel(), "Complete");
@@ -77,6 +77,12 @@ class FindFeatureHistogram : public AbstractFilter
     SIMPL_FILTER_PARAMETER(bool, RemoveBiasedFeatures)
     Q_PROPERTY(bool RemoveBiasedFeatures READ getRemoveBiasedFeatures WRITE setRemoveBiasedFeatures)
 
+    SIMPL_FILTER_PARAMETER(bool, ExcludeOutliers)
+    Q_PROPERTY(bool ExcludeOutliers READ getExcludeOutliers WRITE setExcludeOutliers)
+
+    SIMPL_FILTER_PARAMETER(double, OutlierFraction)
+    Q_PROPERTY(double OutlierFraction READ getOutlierFraction WRITE setOutlierFraction)
+
     /**
     * @brief This returns the group that the filter belonds to. You can select
     * a different group if you want. The string returned here will be displayed
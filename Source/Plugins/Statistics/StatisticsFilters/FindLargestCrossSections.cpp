@@ -44,6 +44,7 @@
 #include "SIMPLib/Geometry/ImageGeom.h"
 
 #include "Statistics/StatisticsConstants.h"
+#include "Statistics/StatisticsFilters/util/CrossSectionCounter.hpp"
 #include "Statistics/StatisticsVersion.h"
 
 // Include the MOC generated file for this class
@@ -177,68 +178,20 @@ void FindLargestCrossSections::find_crosssections()
 
   size_t numfeatures = m_LargestCrossSectionsPtr.lock()->getNumberOfTuples();
 
-  DoubleArrayType::Pointer m_FeatureCounts = DoubleArrayType::CreateArray(numfeatures, "_INTERNAL_USE_ONLY_FeatureCounts");
-  double* featurecounts = m_FeatureCounts->getPointer(0);
+  ImageGeom::Pointer image = m->getGeometryAs<ImageGeom>();
+  size_t dims[3] = { image->getXPoints(), image->getYPoints(), image->getZPoints() };
+  float res_scalar = 0.0f;
+  if (m_Plane == 0) { res_scalar = image->getXRes() * image->getYRes(); }
+  if (m_Plane == 1) { res_scalar = image->getXRes() * image->getZRes(); }
+  if (m_Plane == 2) { res_scalar = image->getYRes() * image->getZRes(); }
 
-  size_t outPlane = 0, inPlane1 = 0, inPlane2 = 0;
-  float res_scalar = 0.0f, area = 0.0f;
-  size_t stride1 = 0, stride2 = 0, stride3 = 0;
-  size_t istride = 0, jstride = 0, kstride = 0;
-  size_t point = 0, gnum = 0;
+  CrossSectionCounter counter;
+  counter.execute(m_FeatureIds, dims, static_cast<int32_t>(m_Plane), numfeatures, 0);
 
-  if (m_Plane == 0)
+  for (size_t i = 1; i < numfeatures; i++)
   {
-    outPlane = m->getGeometryAs<ImageGeom>()->getZPoints();
-    inPlane1 = m->getGeometryAs<ImageGeom>()->getXPoints();
-    inPlane2 = m->getGeometryAs<ImageGeom>()->getYPoints();
-    res_scalar = m->getGeometryAs<ImageGeom>()->getXRes() * m->getGeometryAs<ImageGeom>()->getYRes();
-    stride1 = inPlane1 * inPlane2;
-    stride2 = 1;
-    stride3 = inPlane1;
-  }
-  if (m_Plane == 1)
-  {
-    outPlane = m->getGeometryAs<ImageGeom>()->getYPoints();
-    inPlane1 = m->getGeometryAs<ImageGeom>()->getXPoints();
-    inPlane2 = m->getGeometryAs<ImageGeom>()->getZPoints();
-    res_scalar = m->getGeometryAs<ImageGeom>()->getXRes() * m->getGeometryAs<ImageGeom>()->getZRes();
-    stride1 = inPlane1;
-    stride2 = 1;
-    stride3 = inPlane1 * inPlane2;
-  }
-  if (m_Plane == 2)
-  {
-    outPlane = m->getGeometryAs<ImageGeom>()->getXPoints();
-    inPlane1 = m->getGeometryAs<ImageGeom>()->getYPoints();
-    inPlane2 = m->getGeometryAs<ImageGeom>()->getZPoints();
-    res_scalar = m->getGeometryAs<ImageGeom>()->getYRes() * m->getGeometryAs<ImageGeom>()->getZRes();
-    stride1 = 1;
-    stride2 = inPlane1;
-    stride3 = inPlane1 * inPlane2;
-  }
-  for (size_t i = 0; i < outPlane; i++)
-  {
-    for (size_t g = 0; g < numfeatures * 1; g++)
-    {
-      featurecounts[g] = 0.0f;
-    }
-    istride = i * stride1;
-    for (size_t j = 0; j < inPlane1; j++)
-    {
-      jstride = j * stride2;
-      for (size_t k = 0; k < inPlane2; k++)
-      {
-        kstride = k * stride3;
-        point = istride + jstride + kstride;
-        gnum = m_FeatureIds[point];
-        featurecounts[gnum]++;
-      }
-    }
-    for (size_t g = 1; g < numfeatures; g++)
-    {
-      area = featurecounts[g] * res_scalar;
-      if (area > m_LargestCrossSections[g]) { m_LargestCrossSections[g] = area; }
-    }
+    float area = static_cast<double>(counter.getLargestCount(i)) * res_scalar;
+    if (area > m_LargestCrossSections[i]) { m_LargestCrossSections[i] = area; }
   }
 }
 
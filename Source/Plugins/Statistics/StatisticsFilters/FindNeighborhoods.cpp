@@ -35,6 +35,16 @@
 
 #include "FindNeighborhoods.h"
 
+#include <algorithm>
+#include <vector>
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
 #include "SIMPLib/Common/Constants.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
 #include "SIMPLib/FilterParameters/DoubleFilterParameter.h"
@@ -46,10 +56,49 @@
 
 #include "Statistics/StatisticsConstants.h"
 #include "Statistics/StatisticsVersion.h"
+#include "Statistics/StatisticsFilters/util/CentroidBinGrid.hpp"
 
 // Include the MOC generated file for this class
 #include "moc_FindNeighborhoods.cpp"
 
+/**
+ * @brief The FindNeighborhoodsImpl class finds the neighborhood of each Feature in a range by querying the
+ * cell list of centroid bins, writing the neighborhood list and count of that Feature only.
+ */
+class FindNeighborhoodsImpl
+{
+    const CentroidBinGrid* m_Grid;
+    const float* m_CriticalDistance;
+    std::vector<int32_t>* m_NeighborhoodLists;
+    int32_t* m_Neighborhoods;
+
+  public:
+    FindNeighborhoodsImpl(const CentroidBinGrid* grid, const float* criticalDistance, std::vector<int32_t>* neighborhoodLists, int32_t* neighborhoods) :
+      m_Grid(grid),
+      m_CriticalDistance(criticalDistance),
+      m_NeighborhoodLists(neighborhoodLists),
+      m_Neighborhoods(neighborhoods)
+    {}
+
+    virtual ~FindNeighborhoodsImpl() {}
+
+    void search(size_t start, size_t end) const
+    {
+      for (size_t i = start; i < end; i++)
+      {
+        m_Grid->findWithinBins(i, m_CriticalDistance[i], m_NeighborhoodLists[i]);
+        m_Neighborhoods[i] = static_cast<int32_t>(m_NeighborhoodLists[i].size());
+      }
+    }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+    void operator()(const tbb::blocked_range<size_t>& r) const
+    {
+      search(r.begin(), r.end());
+    }
+#endif
+};
+
 
 
 // -----------------------------------------------------------------------------
@@ -232,51 +281,42 @@ void FindNeighborhoods::find_neighborhoods()
     bins[3 * i + 2] = zbin;
   }
 
-  int64_t bin1x = 0, bin2x = 0, bin1y = 0, bin2y = 0, bin1z = 0, bin2z = 0;
-  float dBinX = 0, dBinY = 0, dBinZ = 0;
-  float criticalDistance1 = 0, criticalDistance2 = 0;
+  // Feature j is in the neighborhood of Feature i when their bins differ by less than the critical distance of i
+  // along every axis, so each neighborhood only needs the bins within that distance, which the cell list finds
+  CentroidBinGrid grid;
+  grid.initialize(bins.empty() ? NULL : &(bins.front()), totalFeatures, 1);
 
-  for (size_t i = 1; i < totalFeatures; i++)
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+  tbb::task_scheduler_init init;
+  bool doParallel = true;
+#endif
+
+  size_t featuresPerBlock = 1000;
+  size_t end = 0;
+  for (size_t start = 1; start < totalFeatures; start = end)
   {
-    if (i % 1000 == 0)
+    if (start % featuresPerBlock == 0)
     {
-
-      QString ss = QObject::tr("Working on Feature %1 of %2").arg(i).arg(totalFeatures);
+      QString ss = QObject::tr("Working on Feature %1 of %2").arg(start).arg(totalFeatures);
       notifyStatusMessage(getMessagePrefix(), getHumanLabel(), ss);
     }
-    x = m_Centroids[3 * i];
-    y = m_Centroids[3 * i + 1];
-    z = m_Centroids[3 * i + 2];
-    bin1x = bins[3 * i];
-    bin1y = bins[3 * i + 1];
-    bin1z = bins[3 * i + 2];
-    criticalDistance1 = criticalDistance[i];
+    if (getCancel() == true) { return; }
+    end = std::min(start - (start % featuresPerBlock) + featuresPerBlock, totalFeatures);
 
-    for (size_t j = i + 1; j < totalFeatures; j++)
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+    if (doParallel == true)
     {
-      bin2x = bins[3 * j];
-      bin2y = bins[3 * j + 1];
-      bin2z = bins[3 * j + 2];
-      criticalDistance2 = criticalDistance[j];
-      // Use the llabs version of the "C" abs function because we are using int64_t
-      // do NOT try to use the std::abs() function as this is C++11 ONLY
-      dBinX = llabs(bin2x - bin1x);
-      dBinY = llabs(bin2y - bin1y);
-      dBinZ = llabs(bin2z - bin1z);
-
-      if (dBinX < criticalDistance1 && dBinY < criticalDistance1 && dBinZ < criticalDistance1)
-      {
-        m_Neighborhoods[i]++;
-        neighborhoodlist[i].push_back(j);
-      }
-
-      if (dBinX < criticalDistance2 && dBinY < criticalDistance2 && dBinZ < criticalDistance2)
-      {
-        m_Neighborhoods[j]++;
-        neighborhoodlist[j].push_back(i);
-      }
+      tbb::parallel_for(tbb::blocked_range<size_t>(start, end),
+                        FindNeighborhoodsImpl(&grid, &(criticalDistance.front()), &(neighborhoodlist.front()), m_Neighborhoods), tbb::auto_partitioner());
+    }
+    else
+#endif
+    {
+      FindNeighborhoodsImpl serial(&grid, &(criticalDistance.front()), &(neighborhoodlist.front()), m_Neighborhoods);
+      serial.search(start, end);
     }
   }
+
   for (size_t i = 1; i < totalFeatures; i++)
   {
     // Set the vector for each list into the NeighborhoodList Object
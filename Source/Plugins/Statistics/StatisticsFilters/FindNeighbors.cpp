@@ -35,8 +35,18 @@
 
 #include "FindNeighbors.h"
 
+#include <algorithm>
+#include <vector>
+
 #include <QtCore/QDateTime>
 
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
 #include "SIMPLib/Common/Constants.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
@@ -48,10 +58,112 @@
 
 #include "Statistics/StatisticsConstants.h"
 #include "Statistics/StatisticsVersion.h"
+#include "Statistics/StatisticsFilters/util/FaceContactGraph.hpp"
 
 // Include the MOC generated file for this class
 #include "moc_FindNeighbors.cpp"
 
+/**
+ * @brief The FindNeighborsImpl class scans slabs of rows of cells. For every slab it counts the boundary faces of
+ * each cell, collects the Features that touch the outer surface of the volume and emits one contact key per
+ * Feature and direction for every face between two different Features, which it then sorts and run-length counts.
+ */
+class FindNeighborsImpl
+{
+    const int32_t* m_FeatureIds;
+    int64_t m_Dims[3];
+    int32_t m_NumFeatures;
+    int64_t m_RowsPerSlab;
+    int8_t* m_BoundaryCells;
+    bool m_StoreSurfaceFeatures;
+    std::vector<FaceContactGraph::Contact_t>* m_SlabContacts;
+    std::vector<int32_t>* m_SlabSurfaceFeatures;
+
+  public:
+    FindNeighborsImpl(const int32_t* featureIds, const int64_t dims[3], int32_t numFeatures, int64_t rowsPerSlab, int8_t* boundaryCells, bool storeSurfaceFeatures,
+                      std::vector<FaceContactGraph::Contact_t>* slabContacts, std::vector<int32_t>* slabSurfaceFeatures) :
+      m_FeatureIds(featureIds),
+      m_NumFeatures(numFeatures),
+      m_RowsPerSlab(rowsPerSlab),
+      m_BoundaryCells(boundaryCells),
+      m_StoreSurfaceFeatures(storeSurfaceFeatures),
+      m_SlabContacts(slabContacts),
+      m_SlabSurfaceFeatures(slabSurfaceFeatures)
+    {
+      m_Dims[0] = dims[0];
+      m_Dims[1] = dims[1];
+      m_Dims[2] = dims[2];
+    }
+
+    virtual ~FindNeighborsImpl() {}
+
+    void scan(size_t start, size_t end) const
+    {
+      int64_t numRows = m_Dims[1] * m_Dims[2];
+      int64_t neighpoints[6] = { -m_Dims[0] * m_Dims[1], -m_Dims[0], -1, 1, m_Dims[0], m_Dims[0] * m_Dims[1] };
+      std::vector<uint64_t> keys;
+      std::vector<uint64_t> buffer;
+
+      for (size_t slab = start; slab < end; slab++)
+      {
+        int64_t rowStart = static_cast<int64_t>(slab) * m_RowsPerSlab;
+        int64_t rowEnd = std::min(rowStart + m_RowsPerSlab, numRows);
+        std::vector<int32_t>& surfaceFeatures = m_SlabSurfaceFeatures[slab];
+        keys.clear();
+
+        for (int64_t r = rowStart; r < rowEnd; r++)
+        {
+          int64_t plane = r / m_Dims[1];
+          int64_t row = r - (plane * m_Dims[1]);
+          bool edgeRow = (row == 0 || row == m_Dims[1] - 1);
+          bool edgePlane = (plane == 0 || plane == m_Dims[2] - 1);
+          for (int64_t column = 0; column < m_Dims[0]; column++)
+          {
+            int64_t j = (r * m_Dims[0]) + column;
+            int8_t onsurf = 0;
+            int32_t feature = m_FeatureIds[j];
+            if (feature > 0)
+            {
+              if (m_StoreSurfaceFeatures == true && feature < m_NumFeatures)
+              {
+                bool edgeColumn = (column == 0 || column == m_Dims[0] - 1);
+                bool onSurface = (m_Dims[2] != 1) ? (edgeColumn || edgeRow || edgePlane) : (edgeColumn || edgeRow);
+                if (onSurface == true && (surfaceFeatures.empty() == true || surfaceFeatures.back() != feature)) { surfaceFeatures.push_back(feature); }
+              }
+              bool good[6] = { plane != 0, row != 0, column != 0, column != m_Dims[0] - 1, row != m_Dims[1] - 1, plane != m_Dims[2] - 1 };
+              for (int32_t k = 0; k < 6; k++)
+              {
+                if (good[k] == false) { continue; }
+                int32_t neighbor = m_FeatureIds[j + neighpoints[k]];
+                if (neighbor != feature && neighbor > 0)
+                {
+                  onsurf++;
+                  // every face is seen from both of its cells; only the one below emits it, once for each side
+                  if (k >= 3)
+                  {
+                    keys.push_back(FaceContactGraph::PackContact(feature, neighbor));
+                    keys.push_back(FaceContactGraph::PackContact(neighbor, feature));
+                  }
+                }
+              }
+            }
+            if (NULL != m_BoundaryCells) { m_BoundaryCells[j] = onsurf; }
+          }
+        }
+
+        FaceContactGraph::SortKeys(keys, buffer);
+        FaceContactGraph::CountRuns(keys, m_SlabContacts[slab]);
+      }
+    }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+    void operator()(const tbb::blocked_range<size_t>& r) const
+    {
+      scan(r.begin(), r.end());
+    }
+#endif
+};
+
 
 
 // -----------------------------------------------------------------------------
@@ -219,7 +331,6 @@ void FindNeighbors::execute()
   if(getErrorCondition() < 0) { return; }
 
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(m_FeatureIdsArrayPath.getDataContainerName());
-  size_t totalPoints = m_FeatureIdsPtr.lock()->getNumberOfTuples();
   size_t totalFeatures = m_NumNeighborsPtr.lock()->getNumberOfTuples();
 
   size_t udims[3] = { 0, 0, 0 };
@@ -232,106 +343,64 @@ void FindNeighbors::execute()
     static_cast<int64_t>(udims[2]),
   };
 
-  int64_t neighpoints[6] = { 0, 0, 0, 0, 0, 0 };
-  neighpoints[0] = -dims[0] * dims[1];
-  neighpoints[1] = -dims[0];
-  neighpoints[2] = -1;
-  neighpoints[3] = 1;
-  neighpoints[4] = dims[0];
-  neighpoints[5] = dims[0] * dims[1];
-
-  int64_t column = 0, row = 0, plane = 0;
-  int32_t feature = 0;
-  int32_t nnum = 0;
-  int8_t onsurf = 0;
-  bool good = false;
-  int64_t neighbor = 0;
-
-  std::vector<std::vector<int32_t> > neighborlist;
-  std::vector<std::vector<float> > neighborsurfacearealist;
-
-  int32_t nListSize = 100;
-  neighborlist.resize(totalFeatures);
-  neighborsurfacearealist.resize(totalFeatures);
-
-  uint64_t millis = QDateTime::currentMSecsSinceEpoch();
-  uint64_t currentMillis = millis;
-
   for (size_t i = 1; i < totalFeatures; i++)
   {
-    currentMillis = QDateTime::currentMSecsSinceEpoch();
-    if (currentMillis - millis > 1000)
-    {
-      QString ss = QObject::tr("Finding Neighbors || Initializing Neighbor Lists || %1% Complete").arg((static_cast<float>(i) / totalFeatures) * 100);
-      notifyStatusMessage(getMessagePrefix(), getHumanLabel(), ss);
-      millis = QDateTime::currentMSecsSinceEpoch();
-    }
-
-    if (getCancel() == true) { return; }
-
     m_NumNeighbors[i] = 0;
-    neighborlist[i].resize(nListSize);
-    neighborsurfacearealist[i].assign(nListSize, -1.0f);
     if (m_StoreSurfaceFeatures == true) { m_SurfaceFeatures[i] = false; }
-
   }
 
-  for (size_t j = 0; j < totalPoints; j++)
+  // slabs of about a million cells keep the unsorted face keys of a slab small whatever the size of the volume
+  int64_t numRows = dims[1] * dims[2];
+  int64_t rowsPerSlab = std::max(static_cast<int64_t>(1), static_cast<int64_t>(1 << 20) / std::max(dims[0], static_cast<int64_t>(1)));
+  size_t numSlabs = static_cast<size_t>((numRows + rowsPerSlab - 1) / rowsPerSlab);
+  std::vector<std::vector<FaceContactGraph::Contact_t> > slabContacts(numSlabs);
+  std::vector<std::vector<int32_t> > slabSurfaceFeatures(numSlabs);
+  int8_t* boundaryCells = (m_StoreBoundaryCells == true) ? m_BoundaryCells : NULL;
+
+  notifyStatusMessage(getMessagePrefix(), getHumanLabel(), "Finding Neighbors || Determining Neighbor Lists");
+  if (numSlabs > 0)
   {
-    currentMillis = QDateTime::currentMSecsSinceEpoch();
-    if (currentMillis - millis > 1000)
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+    tbb::task_scheduler_init init;
+    bool doParallel = true;
+    if (doParallel == true)
     {
-      QString ss = QObject::tr("Finding Neighbors || Determining Neighbor Lists || %1% Complete").arg((static_cast<float>(j) / totalPoints) * 100);
-      notifyStatusMessage(getMessagePrefix(), getHumanLabel(), ss);
-      millis = QDateTime::currentMSecsSinceEpoch();
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, numSlabs),
+                        FindNeighborsImpl(m_FeatureIds, dims, static_cast<int32_t>(totalFeatures), rowsPerSlab, boundaryCells, m_StoreSurfaceFeatures, &(slabContacts.front()), &(slabSurfaceFeatures.front())),
+                        tbb::auto_partitioner());
+    }
+    else
+#endif
+    {
+      FindNeighborsImpl serial(m_FeatureIds, dims, static_cast<int32_t>(totalFeatures), rowsPerSlab, boundaryCells, m_StoreSurfaceFeatures, &(slabContacts.front()), &(slabSurfaceFeatures.front()));
+      serial.scan(0, numSlabs);
     }
+  }
 
-    if (getCancel() == true) { return; }
+  if (getCancel() == true) { return; }
 
-    onsurf = 0;
-    feature = m_FeatureIds[j];
-    if (feature > 0)
+  if (m_StoreSurfaceFeatures == true)
+  {
+    for (size_t s = 0; s < numSlabs; s++)
     {
-      column = static_cast<int64_t>( j % m->getGeometryAs<ImageGeom>()->getXPoints() );
-      row = static_cast<int64_t>( (j / m->getGeometryAs<ImageGeom>()->getXPoints()) % m->getGeometryAs<ImageGeom>()->getYPoints() );
-      plane = static_cast<int64_t>( j / (m->getGeometryAs<ImageGeom>()->getXPoints() * m->getGeometryAs<ImageGeom>()->getYPoints()) );
-      if (m_StoreSurfaceFeatures == true)
-      {
-        if ((column == 0 || column == static_cast<int64_t>((m->getGeometryAs<ImageGeom>()->getXPoints() - 1))
-             || row == 0 || row == static_cast<int64_t>((m->getGeometryAs<ImageGeom>()->getYPoints()) - 1)
-             || plane == 0 || plane == static_cast<int64_t>((m->getGeometryAs<ImageGeom>()->getZPoints() - 1)))
-            && m->getGeometryAs<ImageGeom>()->getZPoints() != 1)
-        {
-          m_SurfaceFeatures[feature] = true;
-        }
-        if ((column == 0 || column == static_cast<int64_t>((m->getGeometryAs<ImageGeom>()->getXPoints() - 1)) || row == 0 || row == static_cast<int64_t>((m->getGeometryAs<ImageGeom>()->getYPoints() - 1))) && m->getGeometryAs<ImageGeom>()->getZPoints() == 1)
-        {
-          m_SurfaceFeatures[feature] = true;
-        }
-      }
-      for (int32_t k = 0; k < 6; k++)
+      for (size_t i = 0; i < slabSurfaceFeatures[s].size(); i++)
       {
-        good = true;
-        neighbor = static_cast<int64_t>( j + neighpoints[k] );
-        if (k == 0 && plane == 0) { good = false; }
-        if (k == 5 && plane == (m->getGeometryAs<ImageGeom>()->getZPoints() - 1)) { good = false; }
-        if (k == 1 && row == 0) { good = false; }
-        if (k == 4 && row == (m->getGeometryAs<ImageGeom>()->getYPoints() - 1)) { good = false; }
-        if (k == 2 && column == 0) { good = false; }
-        if (k == 3 && column == (m->getGeometryAs<ImageGeom>()->getXPoints() - 1)) { good = false; }
-        if (good == true && m_FeatureIds[neighbor] != feature && m_FeatureIds[neighbor] > 0)
-        {
-          onsurf++;
-          nnum = m_NumNeighbors[feature];
-          neighborlist[feature].push_back(m_FeatureIds[neighbor]);
-          nnum++;
-          m_NumNeighbors[feature] = nnum;
-        }
+        m_SurfaceFeatures[slabSurfaceFeatures[s][i]] = true;
       }
     }
-    if (m_StoreBoundaryCells == true) { m_BoundaryCells[j] = onsurf; }
   }
 
+  notifyStatusMessage(getMessagePrefix(), getHumanLabel(), "Finding Neighbors || Building Neighbor Graph");
+  FaceContactGraph graph;
+  graph.build(slabContacts, totalFeatures);
+
+  if (getCancel() == true) { return; }
+
+  float faceArea = m->getGeometryAs<ImageGeom>()->getXRes() * m->getGeometryAs<ImageGeom>()->getYRes();
+
+  uint64_t millis = QDateTime::currentMSecsSinceEpoch();
+  uint64_t currentMillis = millis;
+
   // We do this to create new set of NeighborList objects
   for (size_t i = 1; i < totalFeatures; i++)
   {
@@ -345,43 +414,18 @@ void FindNeighbors::execute()
 
     if(getCancel() == true) { return; }
 
-
-    QMap<int32_t, int32_t> neighToCount;
-    int32_t numneighs = static_cast<int32_t>( neighborlist[i].size() );
-
-    // this increments the voxel counts for each feature
-    for (int32_t j = 0; j < numneighs; j++)
-    {
-      neighToCount[neighborlist[i][j]]++;
-    }
-
-    QMap<int32_t, int32_t>::Iterator neighiter = neighToCount.find(0);
-    neighToCount.erase(neighiter);
-    neighiter = neighToCount.find(-1);
-    neighToCount.erase(neighiter);
-    // Resize the features neighbor list to zero
-    neighborlist[i].resize(0);
-    neighborsurfacearealist[i].resize(0);
-
-    for (QMap<int32_t, int32_t>::iterator iter = neighToCount.begin(); iter != neighToCount.end(); ++iter)
+    size_t numneighs = graph.getNumberOfNeighbors(i);
+    NeighborList<int32_t>::SharedVectorType sharedNeiLst(new std::vector<int32_t>(numneighs));
+    NeighborList<float>::SharedVectorType sharedSAL(new std::vector<float>(numneighs));
+    for (size_t j = 0; j < numneighs; j++)
     {
-      int32_t neigh = iter.key(); // get the neighbor feature
-      int32_t number = iter.value(); // get the number of voxels
-      float area = float(number) * m->getGeometryAs<ImageGeom>()->getXRes() * m->getGeometryAs<ImageGeom>()->getYRes();
-
-      // Push the neighbor feature id back onto the list so we stay synced up
-      neighborlist[i].push_back(neigh);
-      neighborsurfacearealist[i].push_back(area);
+      (*sharedNeiLst)[j] = graph.getNeighbor(i, j);
+      (*sharedSAL)[j] = float(graph.getFaceCount(i, j)) * faceArea;
     }
-    m_NumNeighbors[i] = int32_t(neighborlist[i].size());
+    m_NumNeighbors[i] = static_cast<int32_t>(numneighs);
 
     // Set the vector for each list into the NeighborList Object
-    NeighborList<int32_t>::SharedVectorType sharedNeiLst(new std::vector<int32_t>);
-    sharedNeiLst->assign(neighborlist[i].begin(), neighborlist[i].end());
     m_NeighborList.lock()->setList(static_cast<int32_t>(i), sharedNeiLst);
-
-    NeighborList<float>::SharedVectorType sharedSAL(new std::vector<float>);
-    sharedSAL->assign(neighborsurfacearealist[i].begin(), neighborsurfacearealist[i].end());
     m_SharedSurfaceAreaList.lock()->setList(static_cast<int32_t>(i), sharedSAL);
   }
 
@@ -60,6 +60,8 @@ class FindShapes : public AbstractFilter
 
     SIMPL_DECLARE_ARRAY(double, featureeigenvals, FeatureEigenVals) // N x 3 Array
 
+    SIMPL_DECLARE_ARRAY(double, featureeigenvectors, FeatureEigenVectors) // N x 9 Array
+
     SIMPL_FILTER_PARAMETER(DataArrayPath, FeatureIdsArrayPath)
     Q_PROPERTY(DataArrayPath FeatureIdsArrayPath READ getFeatureIdsArrayPath WRITE setFeatureIdsArrayPath)
 
@@ -35,13 +35,19 @@
 
 #include "FindSurfaceAreaToVolume.h"
 
+#include <cmath>
+
 #include "SIMPLib/Common/Constants.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
+#include "SIMPLib/FilterParameters/LinkedBooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
+#include "SIMPLib/Math/SIMPLibMath.h"
 #include "SIMPLib/Geometry/ImageGeom.h"
 
+#include "Generic/GenericFilters/util/FeatureReductionEngine.hpp"
+
 #include "Statistics/StatisticsConstants.h"
 #include "Statistics/StatisticsVersion.h"
 
@@ -58,9 +64,12 @@ FindSurfaceAreaToVolume::FindSurfaceAreaToVolume() :
   m_FeatureIdsArrayPath(SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellAttributeMatrixName, SIMPL::CellData::FeatureIds),
   m_NumCellsArrayPath(SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellFeatureAttributeMatrixName, SIMPL::FeatureData::NumCells),
   m_SurfaceAreaVolumeRatioArrayName(SIMPL::FeatureData::SurfaceAreaVol),
+  m_SphericityArrayName("Sphericity"),
+  m_CalculateSphericity(false),
   m_FeatureIds(NULL),
   m_NumCells(NULL),
-  m_SurfaceAreaVolumeRatio(NULL)
+  m_SurfaceAreaVolumeRatio(NULL),
+  m_Sphericity(NULL)
 {
   setupFilterParameters();
 }
@@ -77,6 +86,8 @@ FindSurfaceAreaToVolume::~FindSurfaceAreaToVolume()
 void FindSurfaceAreaToVolume::setupFilterParameters()
 {
   FilterParameterVector parameters;
+  QStringList linkedProps("SphericityArrayName");
+  parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Calculate Sphericity", CalculateSphericity, FilterParameter::Parameter, FindSurfaceAreaToVolume, linkedProps));
   parameters.push_back(SeparatorFilterParameter::New("Cell Data", FilterParameter::RequiredArray));
   {
     DataArraySelectionFilterParameter::RequirementType req = DataArraySelectionFilterParameter::CreateRequirement(SIMPL::TypeNames::Int32, 1, SIMPL::AttributeMatrixType::Cell, SIMPL::GeometryType::ImageGeometry);
@@ -90,6 +101,7 @@ void FindSurfaceAreaToVolume::setupFilterParameters()
   }
   parameters.push_back(SeparatorFilterParameter::New("Cell Feature Data", FilterParameter::CreatedArray));
   parameters.push_back(SIMPL_NEW_STRING_FP("Surface Area to Volume Ratio", SurfaceAreaVolumeRatioArrayName, FilterParameter::CreatedArray, FindSurfaceAreaToVolume));
+  parameters.push_back(SIMPL_NEW_STRING_FP("Sphericity", SphericityArrayName, FilterParameter::CreatedArray, FindSurfaceAreaToVolume));
   setFilterParameters(parameters);
 }
 
@@ -102,6 +114,8 @@ void FindSurfaceAreaToVolume::readFilterParameters(AbstractFilterParametersReade
   setFeatureIdsArrayPath(reader->readDataArrayPath("FeatureIdsArrayPath", getFeatureIdsArrayPath() ) );
   setNumCellsArrayPath(reader->readDataArrayPath("NumCellsArrayPath", getNumCellsArrayPath()));
   setSurfaceAreaVolumeRatioArrayName(reader->readString("SurfaceAreaVolumeRatioArrayName", getSurfaceAreaVolumeRatioArrayName()));
+  setSphericityArrayName(reader->readString("SphericityArrayName", getSphericityArrayName()));
+  setCalculateSphericity(reader->readValue("CalculateSphericity", getCalculateSphericity()));
   reader->closeFilterGroup();
 }
 
@@ -138,6 +152,14 @@ void FindSurfaceAreaToVolume::dataCheck()
   m_SurfaceAreaVolumeRatioPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<float>, AbstractFilter, float>(this, tempPath, 0, cDims); /* Assigns the shared_ptr<> to an instance variable that is a weak_ptr<> */
   if( NULL != m_SurfaceAreaVolumeRatioPtr.lock().get() ) /* Validate the Weak Pointer wraps a non-NULL pointer to a DataArray<T> object */
   { m_SurfaceAreaVolumeRatio = m_SurfaceAreaVolumeRatioPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
+
+  if (m_CalculateSphericity == true)
+  {
+    tempPath.update(getNumCellsArrayPath().getDataContainerName(), getNumCellsArrayPath().getAttributeMatrixName(), getSphericityArrayName() );
+    m_SphericityPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<float>, AbstractFilter, float>(this, tempPath, 0, cDims); /* Assigns the shared_ptr<> to an instance variable that is a weak_ptr<> */
+    if( NULL != m_SphericityPtr.lock().get() ) /* Validate the Weak Pointer wraps a non-NULL pointer to a DataArray<T> object */
+    { m_Sphericity = m_SphericityPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -167,23 +189,17 @@ void FindSurfaceAreaToVolume::execute()
   // be notified of unanticipated behavior ; this cannot be done in the dataCheck since
   // we don't have acces to the data yet
   int32_t numFeatures = static_cast<int32_t>(m_NumCellsPtr.lock()->getNumberOfTuples());
-  bool mismatchedFeatures = false;
-  int32_t largestFeature = 0;
-  size_t numTuples = m_FeatureIdsPtr.lock()->getNumberOfTuples();
-  for (size_t i = 0; i < numTuples; i ++)
-  {
-    if (m_FeatureIds[i] > largestFeature)
-    {
-      largestFeature = m_FeatureIds[i];
-      if (largestFeature >= numFeatures)
-      {
-        mismatchedFeatures = true;
-        break;
-      }
-    }
-  }
 
-  if (mismatchedFeatures == true)
+  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(m_NumCellsArrayPath.getDataContainerName());
+  float xRes = m->getGeometryAs<ImageGeom>()->getXRes();
+  float yRes = m->getGeometryAs<ImageGeom>()->getYRes();
+  float zRes = m->getGeometryAs<ImageGeom>()->getZRes();
+
+  size_t dims[3] = { m->getGeometryAs<ImageGeom>()->getXPoints(), m->getGeometryAs<ImageGeom>()->getYPoints(), m->getGeometryAs<ImageGeom>()->getZPoints() };
+  FeatureReductionEngine::Pointer engine = FeatureReductionEngine::Compute(m_FeatureIds, dims, numFeatures);
+  int32_t largestFeature = engine->getLargestFeatureId();
+
+  if (largestFeature >= numFeatures)
   {
     QString ss = QObject::tr("The number of Features in the NumCells array (%1) is larger than the largest Feature Id in the FeatureIds array").arg(numFeatures);
     setErrorCondition(-5555);
@@ -199,79 +215,23 @@ void FindSurfaceAreaToVolume::execute()
     return;
   }
 
-  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(m_NumCellsArrayPath.getDataContainerName());
-  float xRes = m->getGeometryAs<ImageGeom>()->getXRes();
-  float yRes = m->getGeometryAs<ImageGeom>()->getYRes();
-  float zRes = m->getGeometryAs<ImageGeom>()->getZRes();
-
-  int64_t xPoints = static_cast<int64_t>(m->getGeometryAs<ImageGeom>()->getXPoints());
-  int64_t yPoints = static_cast<int64_t>(m->getGeometryAs<ImageGeom>()->getYPoints());
-  int64_t zPoints = static_cast<int64_t>(m->getGeometryAs<ImageGeom>()->getZPoints());
-
-  std::vector<float> featureSurfaceArea(numFeatures);
-
-  int64_t neighpoints[6] = { 0, 0, 0, 0, 0, 0 };
-  neighpoints[0] = -xPoints * yPoints;
-  neighpoints[1] = -xPoints;
-  neighpoints[2] = -1;
-  neighpoints[3] = 1;
-  neighpoints[4] = xPoints;
-  neighpoints[5] = xPoints * yPoints;
-
-  int32_t feature = 0;
-  float onsurf = 0.0f;
-  bool good = false;
-  int64_t neighbor = 0;
-
-  int64_t zStride = 0, yStride = 0;
-  for (int64_t i = 0; i < zPoints; i++)
+  // a face between two cells along x has an area of yRes * zRes, and so on; the sphericity is the surface area of
+  // the sphere with the volume of the Feature over the surface area of the Feature
+  float faceAreas[3] = { yRes * zRes, zRes * xRes, xRes * yRes };
+  double thirdRootPi = std::pow(SIMPLib::Constants::k_Pi, 1.0 / 3.0);
+  for (int32_t i = 1; i < numFeatures; i++)
   {
-    zStride = i * xPoints * yPoints;
-    for (int64_t j = 0; j < yPoints; j++)
+    float featureSurfaceArea = 0.0f;
+    for (int32_t d = 0; d < 3; d++)
     {
-      yStride = j * xPoints;
-      for (int64_t k = 0; k < xPoints; k++)
-      {
-        onsurf = 0.0f;
-        feature = m_FeatureIds[zStride + yStride + k];
-        if (feature > 0)
-        {
-          for (int32_t l = 0; l < 6; l++)
-          {
-            good = true;
-            neighbor = zStride + yStride + k + neighpoints[l];
-            if (l == 0 && i == 0) { good = false; }
-            if (l == 5 && i == (zPoints - 1)) { good = false; }
-            if (l == 1 && j == 0) { good = false; }
-            if (l == 4 && j == (yPoints - 1)) { good = false; }
-            if (l == 2 && k == 0) { good = false; }
-            if (l == 3 && k == (xPoints - 1)) { good = false; }
-            if (good == true && m_FeatureIds[neighbor] != feature)
-            {
-              if (l == 0 || l == 5)  // XY face shared
-              {
-                onsurf = onsurf + xRes * yRes;
-              }
-              if (l == 1 || l == 4)  //YZ face shared
-              {
-                onsurf = onsurf + yRes * zRes;
-              }
-              if (l == 2 || l == 3)  //XZ face shared
-              {
-                onsurf = onsurf + zRes * xRes;
-              }
-            }
-          }
-        }
-
-        featureSurfaceArea[m_FeatureIds[zStride + yStride + k]] = featureSurfaceArea[m_FeatureIds[zStride + yStride + k]] + onsurf;
-      }
+      featureSurfaceArea += static_cast<float>(engine->getBoundaryFaces(i, d)) * faceAreas[d];
+    }
+    float featureVolume = m_NumCells[i] * xRes * yRes * zRes;
+    m_SurfaceAreaVolumeRatio[i] = featureSurfaceArea / featureVolume;
+    if (m_CalculateSphericity == true)
+    {
+      m_Sphericity[i] = static_cast<float>(thirdRootPi * std::pow(6.0 * featureVolume, 2.0 / 3.0) / featureSurfaceArea);
     }
-  }
-
-  for (int32_t i = 1; i < numFeatures; i++)
-  {
-    m_SurfaceAreaVolumeRatio[i] = featureSurfaceArea[i] / (m_NumCells[i] * xRes * yRes * zRes);
   }
 
   notifyStatusMessage(getHumanLabel(), "Complete");
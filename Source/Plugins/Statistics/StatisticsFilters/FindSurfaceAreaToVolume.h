@@ -63,6 +63,12 @@ class FindSurfaceAreaToVolume : public AbstractFilter
     SIMPL_FILTER_PARAMETER(QString, SurfaceAreaVolumeRatioArrayName)
     Q_PROPERTY(QString SurfaceAreaVolumeRatioArrayName READ getSurfaceAreaVolumeRatioArrayName WRITE setSurfaceAreaVolumeRatioArrayName)
 
+    SIMPL_FILTER_PARAMETER(QString, SphericityArrayName)
+    Q_PROPERTY(QString SphericityArrayName READ getSphericityArrayName WRITE setSphericityArrayName)
+
+    SIMPL_FILTER_PARAMETER(bool, CalculateSphericity)
+    Q_PROPERTY(bool CalculateSphericity READ getCalculateSphericity WRITE setCalculateSphericity)
+
     /**
      * @brief getCompiledLibraryName Reimplemented from @see AbstractFilter class
      */
@@ -163,6 +169,7 @@ class FindSurfaceAreaToVolume : public AbstractFilter
     DEFINE_DATAARRAY_VARIABLE(int32_t, NumCells)
 
     DEFINE_DATAARRAY_VARIABLE(float, SurfaceAreaVolumeRatio)
+    DEFINE_DATAARRAY_VARIABLE(float, Sphericity)
 
     FindSurfaceAreaToVolume(const FindSurfaceAreaToVolume&); // Copy Constructor Not Implemented
     void operator=(const FindSurfaceAreaToVolume&); // Operator '=' Not Implemented
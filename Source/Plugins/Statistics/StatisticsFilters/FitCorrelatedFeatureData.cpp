@@ -47,6 +47,7 @@
 #include "Statistics/DistributionAnalysisOps/BetaOps.h"
 #include "Statistics/DistributionAnalysisOps/PowerLawOps.h"
 #include "Statistics/DistributionAnalysisOps/LogNormalOps.h"
+#include "Statistics/StatisticsFilters/util/DistributionBuckets.hpp"
 
 // Include the MOC generated file for this class
 #include "moc_FitCorrelatedFeatureData.cpp"
@@ -223,8 +224,6 @@ void FitCorrelatedFeatureData::preflight()
 template<typename T>
 void fitData(IDataArray::Pointer inputData, float* ensembleArray, int32_t* eIds, int32_t numEnsembles, unsigned int dType, Int32ArrayType::Pointer binArray, int numBins, bool removeBiasedFeatures, bool* biasedFeatures)
 {
-  StatsData::Pointer sData = StatsData::New();
-
   std::vector<DistributionAnalysisOps::Pointer> distributionAnalysis;
   distributionAnalysis.push_back(BetaOps::New());
   distributionAnalysis.push_back(LogNormalOps::New());
@@ -247,44 +246,14 @@ void fitData(IDataArray::Pointer inputData, float* ensembleArray, int32_t* eIds,
   T* fPtr = featureArray->getPointer(0);
   int32_t* bPtr = binArray->getPointer(0);
 
-  //float max;
-  //float min;
-  std::vector<VectorOfFloatArray> dist;
-  std::vector<std::vector<std::vector<float > > > values;
-
   size_t numfeatures = featureArray->getNumberOfTuples();
+  if (numBins < 1) { return; }
 
-  dist.resize(numEnsembles);
-  values.resize(numEnsembles);
-
-  for(int64_t i = 1; i < numEnsembles; i++)
-  {
-    dist[i] = sData->CreateCorrelatedDistributionArrays(dType, numBins);
-    values[i].resize(numBins);
-  }
-
-  int32_t ensemble;
-  for (size_t i = 1; i < numfeatures; i++)
-  {
-    if(removeBiasedFeatures == false || biasedFeatures[i] == false)
-    {
-      ensemble = eIds[i];
-      values[ensemble][bPtr[i]].push_back(static_cast<float>(fPtr[i]));
-    }
-  }
-  for (int64_t i = 1; i < numEnsembles; i++)
-  {
-    distributionAnalysis[dType]->calculateCorrelatedParameters(values[i], dist[i]);
-    for (int j = 0; j < numBins; j++)
-    {
-      for(int k = 0; k < numComp; k++)
-      {
-        VectorOfFloatArray data = dist[i];
-        ensembleArray[(numComp * numBins * i) + (numComp * j) + k] = data[k]->getValue(j);
-      }
-    }
-  }
-  return;
+  // One bucket of values per Ensemble and bin, in the layout of the Ensemble array, so every bin of every
+  // Ensemble is fitted in parallel straight into place
+  DistributionBuckets buckets;
+  buckets.initialize(fPtr, numfeatures, eIds, static_cast<int64_t>(numEnsembles), bPtr, numBins, (removeBiasedFeatures == true) ? biasedFeatures : NULL);
+  buckets.fit(distributionAnalysis[dType], true, static_cast<size_t>(numBins), numComp, ensembleArray);
 }
 
 // -----------------------------------------------------------------------------
@@ -50,6 +50,7 @@
 #include "Statistics/DistributionAnalysisOps/LogNormalOps.h"
 #include "Statistics/StatisticsConstants.h"
 #include "Statistics/StatisticsVersion.h"
+#include "Statistics/StatisticsFilters/util/DistributionBuckets.hpp"
 
 // Include the MOC generated file for this class
 #include "moc_FitFeatureData.cpp"
@@ -206,8 +207,6 @@ void fitData(IDataArray::Pointer inDataPtr, float* ensembleArray, int32_t* eIds,
 {
   typename DataArray<T>::Pointer inputDataPtr = std::dynamic_pointer_cast<DataArray<T> >(inDataPtr);
 
-  StatsData::Pointer sData = StatsData::New();
-
   std::vector<DistributionAnalysisOps::Pointer> distributionAnalysis;
   distributionAnalysis.push_back(BetaOps::New());
   distributionAnalysis.push_back(LogNormalOps::New());
@@ -222,38 +221,12 @@ void fitData(IDataArray::Pointer inDataPtr, float* ensembleArray, int32_t* eIds,
   else if (dType == SIMPL::DistributionType::Power) { distType = "PowerLaw", numComp = SIMPL::DistributionType::PowerLawColumnCount; }
 
   T* fPtr = inputDataPtr->getPointer(0);
-
-  std::vector<FloatArrayType::Pointer> dist;
-  std::vector<std::vector<float > > values;
-
   size_t numfeatures = inputDataPtr->getNumberOfTuples();
 
-  dist.resize(numEnsembles);
-  values.resize(numEnsembles);
-
-  for(size_t i = 1; i < numEnsembles; i++)
-  {
-    dist[i] = sData->CreateDistributionArrays(dType);
-  }
-
-  int32_t ensemble = 0;
-  for (size_t i = 1; i < numfeatures; i++)
-  {
-    if (removeBiasedFeatures == false || biasedFeatures[i] == false)
-    {
-      ensemble = eIds[i];
-      values[ensemble].push_back(static_cast<float>(fPtr[i]));
-    }
-  }
-  for (size_t i = 1; i < numEnsembles; i++)
-  {
-    distributionAnalysis[dType]->calculateParameters(values[i], dist[i]);
-    for (int32_t j = 0; j < numComp; j++)
-    {
-      FloatArrayType::Pointer data = dist[i];
-      ensembleArray[numComp * i + j] = data->getValue(j);
-    }
-  }
+  // One bucket of values per Ensemble, fitted in parallel straight into the Ensemble array
+  DistributionBuckets buckets;
+  buckets.initialize(fPtr, numfeatures, eIds, static_cast<int64_t>(numEnsembles), NULL, 1, (removeBiasedFeatures == true) ? biasedFeatures : NULL);
+  buckets.fit(distributionAnalysis[dType], false, 1, numComp, ensembleArray);
 }
 
 // -----------------------------------------------------------------------------
@@ -35,6 +35,14 @@
 
 #include "GenerateEnsembleStatistics.h"
 
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#include <tbb/task_group.h>
+#endif
+
 #include "SIMPLib/Common/Constants.h"
 #include "SIMPLib/Common/PhaseType.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
@@ -53,6 +61,7 @@
 
 #include "OrientationLib/OrientationMath/OrientationArray.hpp"
 #include "OrientationLib/OrientationMath/OrientationTransforms.hpp"
+#include "OrientationLib/Texture/OdfAccumulator.hpp"
 
 #include "Statistics/DistributionAnalysisOps/BetaOps.h"
 #include "Statistics/DistributionAnalysisOps/PowerLawOps.h"
@@ -69,6 +78,101 @@
 // Include the MOC generated file for this class
 #include "moc_GenerateEnsembleStatistics.cpp"
 
+/**
+ * @brief The GatherStatsImpl class runs one of the gathers of GenerateEnsembleStatistics as a task
+ */
+class GatherStatsImpl
+{
+  public:
+    typedef void (GenerateEnsembleStatistics::*GatherFunction)();
+
+  private:
+    GenerateEnsembleStatistics* m_Filter;
+    GatherFunction m_Function;
+
+  public:
+    GatherStatsImpl(GenerateEnsembleStatistics* filter, GatherFunction function) :
+      m_Filter(filter),
+      m_Function(function)
+    {}
+
+    virtual ~GatherStatsImpl() {}
+
+    void operator()() const
+    {
+      (m_Filter->*m_Function)();
+    }
+};
+
+/**
+ * @brief The MisorientationBinsImpl class finds the misorientation bin of every neighbor pair of a range of Features
+ * that contributes to the MDF, or -1 for the pairs that do not
+ */
+class MisorientationBinsImpl
+{
+    float* m_AvgQuats;
+    int32_t* m_FeaturePhases;
+    bool* m_SurfaceFeatures;
+    unsigned int* m_CrystalStructures;
+    NeighborList<int32_t>* m_NeighborList;
+    size_t* m_PairStart;
+    int32_t* m_PairBins;
+    QVector<SpaceGroupOps::Pointer> m_OrientationOps;
+
+  public:
+    MisorientationBinsImpl(float* avgQuats, int32_t* featurePhases, bool* surfaceFeatures, unsigned int* crystalStructures,
+                           NeighborList<int32_t>* neighborList, size_t* pairStart, int32_t* pairBins) :
+      m_AvgQuats(avgQuats),
+      m_FeaturePhases(featurePhases),
+      m_SurfaceFeatures(surfaceFeatures),
+      m_CrystalStructures(crystalStructures),
+      m_NeighborList(neighborList),
+      m_PairStart(pairStart),
+      m_PairBins(pairBins)
+    {
+      m_OrientationOps = SpaceGroupOps::getOrientationOpsQVector();
+    }
+
+    virtual ~MisorientationBinsImpl() {}
+
+    void convert(size_t start, size_t end) const
+    {
+      NeighborList<int32_t>& neighborlist = *m_NeighborList;
+      QuatF* avgQuats = reinterpret_cast<QuatF*>(m_AvgQuats);
+      QuatF q1 = QuaternionMathF::New();
+      QuatF q2 = QuaternionMathF::New();
+      float n1 = 0.0f, n2 = 0.0f, n3 = 0.0f;
+
+      for (size_t i = start; i < end; i++)
+      {
+        QuaternionMathF::Copy(avgQuats[i], q1);
+        uint32_t phase1 = m_CrystalStructures[m_FeaturePhases[i]];
+        int32_t* bins = m_PairBins + m_PairStart[i];
+        for (size_t j = 0; j < neighborlist[i].size(); j++)
+        {
+          bins[j] = -1;
+          int32_t nname = neighborlist[i][j];
+          uint32_t phase2 = m_CrystalStructures[m_FeaturePhases[nname]];
+          if (phase1 != phase2) { continue; }
+          if (static_cast<size_t>(nname) <= i && m_SurfaceFeatures[nname] == false) { continue; }
+
+          QuaternionMathF::Copy(avgQuats[nname], q2);
+          float w = m_OrientationOps[phase1]->getMisoQuat(q1, q2, n1, n2, n3);
+          FOrientArrayType rod(4);
+          FOrientTransformsType::ax2ro(FOrientArrayType(n1, n2, n3, w), rod);
+          bins[j] = m_OrientationOps[phase1]->getMisoBin(rod);
+        }
+      }
+    }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+    void operator()(const tbb::blocked_range<size_t>& r) const
+    {
+      convert(r.begin(), r.end());
+    }
+#endif
+};
+
 
 
 // -----------------------------------------------------------------------------
@@ -107,6 +211,7 @@ GenerateEnsembleStatistics::GenerateEnsembleStatistics() :
   m_CalculateMDF(false),
   m_CalculateAxisODF(false),
   m_SizeCorrelationResolution(1),
+  m_UseParallelGathers(true),
   m_AvgQuats(NULL),
   m_FeatureEulerAngles(NULL),
   m_Volumes(NULL),
@@ -695,7 +800,6 @@ void GenerateEnsembleStatistics::gatherAspectRatioStats()
   std::vector<std::vector<std::vector<float> > > cvalues;
   std::vector<float> mindiams;
   std::vector<float> binsteps;
-  size_t numfeatures = m_AspectRatiosPtr.lock()->getNumberOfTuples();
   size_t numensembles = m_PhaseTypesPtr.lock()->getNumberOfTuples();
 
   boveras.resize(numensembles);
@@ -737,17 +841,22 @@ void GenerateEnsembleStatistics::gatherAspectRatioStats()
       binsteps[i] = tp->getBinStepSize();
     }
   }
-  for (size_t i = 1; i < numfeatures; i++)
+  for (size_t p = 1; p < numensembles; p++)
   {
-    if (m_PhaseTypes[m_FeaturePhases[i]] == SIMPL::PhaseType::PrimaryPhase ||
-        m_PhaseTypes[m_FeaturePhases[i]] == SIMPL::PhaseType::PrecipitatePhase ||
-        m_PhaseTypes[m_FeaturePhases[i]] == SIMPL::PhaseType::TransformationPhase)
+    if (m_PhaseTypes[p] != SIMPL::PhaseType::PrimaryPhase &&
+        m_PhaseTypes[p] != SIMPL::PhaseType::PrecipitatePhase &&
+        m_PhaseTypes[p] != SIMPL::PhaseType::TransformationPhase)
     {
+      continue;
+    }
+    for (size_t k = m_PhaseFeatureStart[p]; k < m_PhaseFeatureStart[p + 1]; k++)
+    {
+      size_t i = static_cast<size_t>(m_PhaseFeatureList[k]);
       if (m_BiasedFeatures[i] == false)
       {
-        bin = size_t((m_EquivalentDiameters[i] - mindiams[m_FeaturePhases[i]]) / binsteps[m_FeaturePhases[i]]);
-        bvalues[m_FeaturePhases[i]][bin].push_back(m_AspectRatios[2 * i]);
-        cvalues[m_FeaturePhases[i]][bin].push_back(m_AspectRatios[2 * i + 1]);
+        bin = size_t((m_EquivalentDiameters[i] - mindiams[p]) / binsteps[p]);
+        bvalues[p][bin].push_back(m_AspectRatios[2 * i]);
+        cvalues[p][bin].push_back(m_AspectRatios[2 * i + 1]);
       }
     }
   }
@@ -792,7 +901,6 @@ void GenerateEnsembleStatistics::gatherOmega3Stats()
   std::vector<std::vector<std::vector<float> > > values;
   QVector<float> mindiams;
   QVector<float> binsteps;
-  size_t numfeatures = m_Omega3sPtr.lock()->getNumberOfTuples();
   size_t numensembles = m_PhaseTypesPtr.lock()->getNumberOfTuples();
 
   omega3s.resize(numensembles);
@@ -826,16 +934,21 @@ void GenerateEnsembleStatistics::gatherOmega3Stats()
       binsteps[i] = tp->getBinStepSize();
     }
   }
-  for (size_t i = 1; i < numfeatures; i++)
+  for (size_t p = 1; p < numensembles; p++)
   {
-    if (m_PhaseTypes[m_FeaturePhases[i]] == SIMPL::PhaseType::PrimaryPhase ||
-        m_PhaseTypes[m_FeaturePhases[i]] == SIMPL::PhaseType::PrecipitatePhase ||
-        m_PhaseTypes[m_FeaturePhases[i]] == SIMPL::PhaseType::TransformationPhase)
+    if (m_PhaseTypes[p] != SIMPL::PhaseType::PrimaryPhase &&
+        m_PhaseTypes[p] != SIMPL::PhaseType::PrecipitatePhase &&
+        m_PhaseTypes[p] != SIMPL::PhaseType::TransformationPhase)
+    {
+      continue;
+    }
+    for (size_t k = m_PhaseFeatureStart[p]; k < m_PhaseFeatureStart[p + 1]; k++)
     {
+      size_t i = static_cast<size_t>(m_PhaseFeatureList[k]);
       if (m_BiasedFeatures[i] == false)
       {
-        bin = size_t((m_EquivalentDiameters[i] - mindiams[m_FeaturePhases[i]]) / binsteps[m_FeaturePhases[i]]);
-        values[m_FeaturePhases[i]][bin].push_back(m_Omega3s[i]);
+        bin = size_t((m_EquivalentDiameters[i] - mindiams[p]) / binsteps[p]);
+        values[p][bin].push_back(m_Omega3s[i]);
       }
     }
   }
@@ -874,7 +987,6 @@ void GenerateEnsembleStatistics::gatherNeighborhoodStats()
   std::vector<std::vector<std::vector<float> > > values;
   std::vector<float> mindiams;
   std::vector<float> binsteps;
-  size_t numfeatures = m_NeighborhoodsPtr.lock()->getNumberOfTuples();
   size_t numensembles = m_PhaseTypesPtr.lock()->getNumberOfTuples();
 
   neighborhoods.resize(numensembles);
@@ -909,16 +1021,21 @@ void GenerateEnsembleStatistics::gatherNeighborhoodStats()
     }
   }
 
-  for (size_t i = 1; i < numfeatures; i++)
+  for (size_t p = 1; p < numensembles; p++)
   {
-    if (m_PhaseTypes[m_FeaturePhases[i]] == SIMPL::PhaseType::PrimaryPhase ||
-        m_PhaseTypes[m_FeaturePhases[i]] == SIMPL::PhaseType::PrecipitatePhase ||
-        m_PhaseTypes[m_FeaturePhases[i]] == SIMPL::PhaseType::TransformationPhase)
+    if (m_PhaseTypes[p] != SIMPL::PhaseType::PrimaryPhase &&
+        m_PhaseTypes[p] != SIMPL::PhaseType::PrecipitatePhase &&
+        m_PhaseTypes[p] != SIMPL::PhaseType::TransformationPhase)
+    {
+      continue;
+    }
+    for (size_t k = m_PhaseFeatureStart[p]; k < m_PhaseFeatureStart[p + 1]; k++)
     {
+      size_t i = static_cast<size_t>(m_PhaseFeatureList[k]);
       if (m_BiasedFeatures[i] == false)
       {
-        bin = size_t((m_EquivalentDiameters[i] - mindiams[m_FeaturePhases[i]]) / binsteps[m_FeaturePhases[i]]);
-        values[m_FeaturePhases[i]][bin].push_back(static_cast<float>( m_Neighborhoods[i] ));
+        bin = size_t((m_EquivalentDiameters[i] - mindiams[p]) / binsteps[p]);
+        values[p][bin].push_back(static_cast<float>( m_Neighborhoods[i] ));
       }
     }
   }
@@ -953,54 +1070,57 @@ void GenerateEnsembleStatistics::gatherODFStats()
   StatsDataArray& statsDataArray = *(m_StatsDataArray);
 
   size_t bin = 0;
-  size_t numfeatures = m_FeatureEulerAnglesPtr.lock()->getNumberOfTuples();
   size_t numensembles = m_PhaseTypesPtr.lock()->getNumberOfTuples();
   int32_t phase = 0;
   std::vector<float> totalvol;
   std::vector<FloatArrayType::Pointer> eulerodf;
+  std::vector<std::shared_ptr<OdfAccumulator> > accumulators(numensembles);
 
   totalvol.resize(numensembles);
   eulerodf.resize(numensembles);
-  uint64_t dims = 0;
   for (size_t i = 1; i < numensembles; i++)
   {
     totalvol[i] = 0;
     if (m_CrystalStructures[i] == Ebsd::CrystalStructure::Hexagonal_High)
     {
-      dims = 36 * 36 * 12;
-      eulerodf[i] = FloatArrayType::CreateArray(dims, SIMPL::StringConstants::ODF);
-      for (uint64_t j = 0; j < dims; j++)
-      {
-        eulerodf[i]->setValue(j, 0.0);
-      }
+      accumulators[i] = std::shared_ptr<OdfAccumulator>(new OdfAccumulator(36, 36, 12));
     }
     else if (m_CrystalStructures[i] == Ebsd::CrystalStructure::Cubic_High)
     {
-      dims = 18 * 18 * 18;
-      eulerodf[i] = FloatArrayType::CreateArray(dims, SIMPL::StringConstants::ODF);
-      for (uint64_t j = 0; j < dims; j++)
-      {
-        eulerodf[i]->setValue(j, 0.0);
-      }
+      accumulators[i] = std::shared_ptr<OdfAccumulator>(new OdfAccumulator(18, 18, 18));
     }
   }
-  for (size_t i = 1; i < numfeatures; i++)
+  for (size_t p = 1; p < numensembles; p++)
   {
-    if (m_SurfaceFeatures[i] == false)
+    if (NULL == accumulators[p].get()) { continue; }
+    for (size_t k = m_PhaseFeatureStart[p]; k < m_PhaseFeatureStart[p + 1]; k++)
     {
-      totalvol[m_FeaturePhases[i]] = totalvol[m_FeaturePhases[i]] + m_Volumes[i];
+      size_t i = static_cast<size_t>(m_PhaseFeatureList[k]);
+      if (m_SurfaceFeatures[i] == false)
+      {
+        totalvol[p] = totalvol[p] + m_Volumes[i];
+      }
+    }
+    phase = m_CrystalStructures[p];
+    for (size_t k = m_PhaseFeatureStart[p]; k < m_PhaseFeatureStart[p + 1]; k++)
+    {
+      size_t i = static_cast<size_t>(m_PhaseFeatureList[k]);
+      if (m_SurfaceFeatures[i] == false)
+      {
+        FOrientArrayType eu( &(m_FeatureEulerAngles[3 * i]), 3); // Wrap the pointer
+        FOrientArrayType rod(4);
+        OrientationTransforms<FOrientArrayType, float>::eu2ro(eu, rod);
+        bin = m_OrientationOps[phase]->getOdfBin(rod);
+        accumulators[p]->addValue(bin, m_Volumes[i] / totalvol[p]);
+      }
     }
   }
-  for (size_t i = 1; i < numfeatures; i++)
+  for (size_t i = 1; i < numensembles; i++)
   {
-    if (m_SurfaceFeatures[i] == false)
+    if (NULL != accumulators[i].get())
     {
-      phase = m_CrystalStructures[m_FeaturePhases[i]];
-      FOrientArrayType eu( &(m_FeatureEulerAngles[3 * i]), 3); // Wrap the pointer
-      FOrientArrayType rod(4);
-      OrientationTransforms<FOrientArrayType, float>::eu2ro(eu, rod);
-      bin = m_OrientationOps[phase]->getOdfBin(rod);
-      eulerodf[m_FeaturePhases[i]]->setValue(bin, (eulerodf[m_FeaturePhases[i]]->getValue(bin) + (m_Volumes[i] / totalvol[m_FeaturePhases[i]])));
+      eulerodf[i] = FloatArrayType::CreateArray(accumulators[i]->getSize(), SIMPL::StringConstants::ODF);
+      accumulators[i]->copyTo(eulerodf[i]->getPointer(0));
     }
   }
   for (size_t i = 1; i < numensembles; i++)
@@ -1037,16 +1157,10 @@ void GenerateEnsembleStatistics::gatherMDFStats()
   // And we do the same for the SharedSurfaceArea list
   NeighborList<float>& neighborsurfacearealist = *(m_SharedSurfaceAreaList.lock());
 
-  float n1 = 0.0f, n2 = 0.0f, n3 = 0.0f;
   int32_t mbin = 0;
-  float w = 0.0f;
-  QuatF q1 = QuaternionMathF::New();
-  QuatF q2 = QuaternionMathF::New();
-  QuatF* avgQuats = reinterpret_cast<QuatF*>(m_AvgQuats);
 
   size_t numfeatures = m_FeaturePhasesPtr.lock()->getNumberOfTuples();
   size_t numensembles = m_PhaseTypesPtr.lock()->getNumberOfTuples();
-  uint32_t phase1 = 0, phase2 = 0;
   QVector<float> totalSurfaceArea;
   QVector<FloatArrayType::Pointer> misobin;
   int32_t numbins = 0;
@@ -1072,32 +1186,45 @@ void GenerateEnsembleStatistics::gatherMDFStats()
       misobin[i]->setValue(j, 0.0);
     }
   }
-  int32_t nname = 0;
+
+  // The misorientations of the neighbor pairs are independent of each other; find their bins first and add the
+  // shared surface areas up afterwards in Feature order
+  std::vector<size_t> pairStart(numfeatures + 1, 0);
+  for (size_t i = 1; i < numfeatures; i++)
+  {
+    pairStart[i + 1] = pairStart[i] + neighborlist[i].size();
+  }
+  std::vector<int32_t> pairBins(pairStart[numfeatures], -1);
+
+  if (numfeatures > 1 && pairBins.empty() == false)
+  {
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+    tbb::task_scheduler_init init;
+    bool doParallel = m_UseParallelGathers;
+    if (doParallel == true)
+    {
+      tbb::parallel_for(tbb::blocked_range<size_t>(1, numfeatures),
+                        MisorientationBinsImpl(m_AvgQuats, m_FeaturePhases, m_SurfaceFeatures, m_CrystalStructures, &neighborlist, &(pairStart.front()), &(pairBins.front())),
+                        tbb::auto_partitioner());
+    }
+    else
+#endif
+    {
+      MisorientationBinsImpl serial(m_AvgQuats, m_FeaturePhases, m_SurfaceFeatures, m_CrystalStructures, &neighborlist, &(pairStart.front()), &(pairBins.front()));
+      serial.convert(1, numfeatures);
+    }
+  }
+
   float nsa = 0.0f;
   for (size_t i = 1; i < numfeatures; i++)
   {
-    QuaternionMathF::Copy(avgQuats[i], q1);
-    phase1 = m_CrystalStructures[m_FeaturePhases[i]];
     for (size_t j = 0; j < neighborlist[i].size(); j++)
     {
-      w = 10000.0f;
-      nname = neighborlist[i][j];
-      QuaternionMathF::Copy(avgQuats[nname], q2);
-      phase2 = m_CrystalStructures[m_FeaturePhases[nname]];
-      if (phase1 == phase2) { w = m_OrientationOps[phase1]->getMisoQuat( q1, q2, n1, n2, n3); }
-      if (phase1 == phase2)
-      {
-        FOrientArrayType rod(4);
-        FOrientTransformsType::ax2ro(FOrientArrayType(n1, n2, n3, w), rod);
-
-        if ((nname > i || m_SurfaceFeatures[nname] == true))
-        {
-          mbin = m_OrientationOps[phase1]->getMisoBin(rod);
-          nsa = neighborsurfacearealist[i][j];
-          misobin[m_FeaturePhases[i]]->setValue(mbin, (misobin[m_FeaturePhases[i]]->getValue(mbin) + nsa));
-          totalSurfaceArea[m_FeaturePhases[i]] = totalSurfaceArea[m_FeaturePhases[i]] + nsa;
-        }
-      }
+      mbin = pairBins[pairStart[i] + j];
+      if (mbin < 0) { continue; }
+      nsa = neighborsurfacearealist[i][j];
+      misobin[m_FeaturePhases[i]]->setValue(mbin, (misobin[m_FeaturePhases[i]]->getValue(mbin) + nsa));
+      totalSurfaceArea[m_FeaturePhases[i]] = totalSurfaceArea[m_FeaturePhases[i]] + nsa;
     }
   }
 
@@ -1138,7 +1265,6 @@ void GenerateEnsembleStatistics::gatherAxisODFStats()
   int32_t bin = 0;
   QVector<FloatArrayType::Pointer> axisodf;
   QVector<float> totalaxes;
-  size_t numfeatures = m_AxisEulerAnglesPtr.lock()->getNumberOfTuples();
   size_t numXTals = m_PhaseTypesPtr.lock()->getNumberOfTuples();
   axisodf.resize(numXTals);
   totalaxes.resize(numXTals);
@@ -1151,22 +1277,26 @@ void GenerateEnsembleStatistics::gatherAxisODFStats()
       axisodf[i]->setValue(j, 0.0);
     }
   }
-  for (size_t i = 1; i < numfeatures; i++)
+  for (size_t p = 1; p < numXTals; p++)
   {
-    if (m_BiasedFeatures[i] == false)
+    for (size_t k = m_PhaseFeatureStart[p]; k < m_PhaseFeatureStart[p + 1]; k++)
     {
-      totalaxes[m_FeaturePhases[i]]++;
+      if (m_BiasedFeatures[m_PhaseFeatureList[k]] == false)
+      {
+        totalaxes[p]++;
+      }
     }
-  }
-  for (size_t i = 1; i < numfeatures; i++)
-  {
-    if (m_BiasedFeatures[i] == false)
+    for (size_t k = m_PhaseFeatureStart[p]; k < m_PhaseFeatureStart[p + 1]; k++)
     {
-      FOrientArrayType rod(4);
-      FOrientTransformsType::eu2ro( FOrientArrayType( &(m_AxisEulerAngles[3 * i]), 3), rod);
-      m_OrientationOps[Ebsd::CrystalStructure::OrthoRhombic]->getODFFZRod(rod);
-      bin = m_OrientationOps[Ebsd::CrystalStructure::OrthoRhombic]->getOdfBin(rod);
-      axisodf[m_FeaturePhases[i]]->setValue(bin, (axisodf[m_FeaturePhases[i]]->getValue(bin) + static_cast<float>((1.0 / totalaxes[m_FeaturePhases[i]]))));
+      size_t i = static_cast<size_t>(m_PhaseFeatureList[k]);
+      if (m_BiasedFeatures[i] == false)
+      {
+        FOrientArrayType rod(4);
+        FOrientTransformsType::eu2ro( FOrientArrayType( &(m_AxisEulerAngles[3 * i]), 3), rod);
+        m_OrientationOps[Ebsd::CrystalStructure::OrthoRhombic]->getODFFZRod(rod);
+        bin = m_OrientationOps[Ebsd::CrystalStructure::OrthoRhombic]->getOdfBin(rod);
+        axisodf[p]->setValue(bin, (axisodf[p]->getValue(bin) + static_cast<float>((1.0 / totalaxes[p]))));
+      }
     }
   }
 
@@ -1239,7 +1369,6 @@ void GenerateEnsembleStatistics::calculatePPTBoundaryFrac()
 
   NeighborList<int32_t>& neighborlist = *(m_NeighborList.lock());
   size_t numensembles = m_PhaseTypesPtr.lock()->getNumberOfTuples();
-  size_t numfeatures = m_FeaturePhasesPtr.lock()->getNumberOfTuples();
   std::vector<int32_t> boundaryPPT(numensembles, 0);
   std::vector<int32_t> totalNumPPT(numensembles, 0);
   std::vector<float> PPTBoundaryFrac(numensembles, 0);
@@ -1249,27 +1378,24 @@ void GenerateEnsembleStatistics::calculatePPTBoundaryFrac()
   {
     if (m_PhaseTypes[k] == SIMPL::PhaseType::PrecipitatePhase)
     {
-      for (size_t i = 1; i < numfeatures; i++)
+      for (size_t f = m_PhaseFeatureStart[k]; f < m_PhaseFeatureStart[k + 1]; f++)
       {
-        if (m_FeaturePhases[i] == k)
-        {
-          totalNumPPT[k]++;
+        size_t i = static_cast<size_t>(m_PhaseFeatureList[f]);
+        totalNumPPT[k]++;
 
-          for (size_t j = 0; j < neighborlist[i].size(); j++)
-          {
-            if (m_FeaturePhases[i] != m_FeaturePhases[neighborlist[i][j]] &&
-                m_PhaseTypes[m_FeaturePhases[neighborlist[i][j]]] != SIMPL::PhaseType::MatrixPhase)  // Currently counts something as on the boundary if it has at least two neighbors of a different non-matrix phase. Might want to specify which phase in the future.
-            {
-              count++;
-            }
-          }
-          if (count >= 2)
+        for (size_t j = 0; j < neighborlist[i].size(); j++)
+        {
+          if (m_FeaturePhases[i] != m_FeaturePhases[neighborlist[i][j]] &&
+              m_PhaseTypes[m_FeaturePhases[neighborlist[i][j]]] != SIMPL::PhaseType::MatrixPhase)  // Currently counts something as on the boundary if it has at least two neighbors of a different non-matrix phase. Might want to specify which phase in the future.
           {
-            boundaryPPT[k]++;
+            count++;
           }
-          count = 0;
-
         }
+        if (count >= 2)
+        {
+          boundaryPPT[k]++;
+        }
+        count = 0;
       }
       PPTBoundaryFrac[k] = (float)boundaryPPT[k] / (float)totalNumPPT[k];
       PrecipitateStatsData* pp = PrecipitateStatsData::SafePointerDownCast(statsDataArray[k].get());
@@ -1278,6 +1404,34 @@ void GenerateEnsembleStatistics::calculatePPTBoundaryFrac()
   }
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void GenerateEnsembleStatistics::buildPhaseIndex()
+{
+  size_t numfeatures = m_FeaturePhasesPtr.lock()->getNumberOfTuples();
+  size_t numensembles = m_PhaseTypesPtr.lock()->getNumberOfTuples();
+
+  // Counting sort of the Features by phase; Features with a phase outside the Ensembles are left out
+  m_PhaseFeatureStart.assign(numensembles + 1, 0);
+  for (size_t i = 1; i < numfeatures; i++)
+  {
+    int32_t phase = m_FeaturePhases[i];
+    if (phase >= 0 && static_cast<size_t>(phase) < numensembles) { m_PhaseFeatureStart[phase + 1]++; }
+  }
+  for (size_t p = 0; p < numensembles; p++)
+  {
+    m_PhaseFeatureStart[p + 1] += m_PhaseFeatureStart[p];
+  }
+  m_PhaseFeatureList.resize(m_PhaseFeatureStart[numensembles]);
+  std::vector<size_t> next(m_PhaseFeatureStart.begin(), m_PhaseFeatureStart.end() - 1);
+  for (size_t i = 1; i < numfeatures; i++)
+  {
+    int32_t phase = m_FeaturePhases[i];
+    if (phase >= 0 && static_cast<size_t>(phase) < numensembles) { m_PhaseFeatureList[next[phase]++] = static_cast<int32_t>(i); }
+  }
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -1351,40 +1505,67 @@ void GenerateEnsembleStatistics::execute()
     m_StatsDataArray->fillArrayWithNewStatsData(m_PhaseTypesPtr.lock()->getNumberOfTuples(), m_PhaseTypes);
   }
 
-  if(m_ComputeSizeDistribution == true)
-  {
-    gatherSizeStats();
-  }
-  if(m_ComputeAspectRatioDistribution == true)
-  {
-    gatherAspectRatioStats();
-  }
-  if(m_ComputeOmega3Distribution == true)
-  {
-    gatherOmega3Stats();
-  }
-  if(m_ComputeNeighborhoodDistribution == true)
-  {
-    gatherNeighborhoodStats();
-  }
-  if(m_CalculateODF == true)
-  {
-    gatherODFStats();
-  }
-  if(m_CalculateMDF == true)
-  {
-    gatherMDFStats();
-  }
-  if(m_CalculateAxisODF == true)
+  buildPhaseIndex();
+
+  // Each gather fills its own part of the StatsData of every phase. Only the aspect ratio, Omega3 and neighborhood
+  // gathers depend on another one, the size gather, for the diameter bins they correlate with
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+  tbb::task_scheduler_init init;
+  bool doParallel = m_UseParallelGathers;
+  if (doParallel == true)
   {
-    gatherAxisODFStats();
+    tbb::task_group* g = new tbb::task_group;
+    if(m_CalculateODF == true) { g->run(GatherStatsImpl(this, &GenerateEnsembleStatistics::gatherODFStats)); }
+    if(m_CalculateMDF == true) { g->run(GatherStatsImpl(this, &GenerateEnsembleStatistics::gatherMDFStats)); }
+    if(m_CalculateAxisODF == true) { g->run(GatherStatsImpl(this, &GenerateEnsembleStatistics::gatherAxisODFStats)); }
+    if(m_IncludeRadialDistFunc == true) { g->run(GatherStatsImpl(this, &GenerateEnsembleStatistics::gatherRadialDistFunc)); }
+    g->run(GatherStatsImpl(this, &GenerateEnsembleStatistics::calculatePPTBoundaryFrac));
+
+    if(m_ComputeSizeDistribution == true) { gatherSizeStats(); }
+    if(m_ComputeAspectRatioDistribution == true) { g->run(GatherStatsImpl(this, &GenerateEnsembleStatistics::gatherAspectRatioStats)); }
+    if(m_ComputeOmega3Distribution == true) { g->run(GatherStatsImpl(this, &GenerateEnsembleStatistics::gatherOmega3Stats)); }
+    if(m_ComputeNeighborhoodDistribution == true) { g->run(GatherStatsImpl(this, &GenerateEnsembleStatistics::gatherNeighborhoodStats)); }
+    g->wait(); // Wait for all the gathers to complete before moving on.
+    delete g;
   }
-  if(m_IncludeRadialDistFunc == true)
+  else
+#endif
   {
-    gatherRadialDistFunc();
-  }
+    if(m_ComputeSizeDistribution == true)
+    {
+      gatherSizeStats();
+    }
+    if(m_ComputeAspectRatioDistribution == true)
+    {
+      gatherAspectRatioStats();
+    }
+    if(m_ComputeOmega3Distribution == true)
+    {
+      gatherOmega3Stats();
+    }
+    if(m_ComputeNeighborhoodDistribution == true)
+    {
+      gatherNeighborhoodStats();
+    }
+    if(m_CalculateODF == true)
+    {
+      gatherODFStats();
+    }
+    if(m_CalculateMDF == true)
+    {
+      gatherMDFStats();
+    }
+    if(m_CalculateAxisODF == true)
+    {
+      gatherAxisODFStats();
+    }
+    if(m_IncludeRadialDistFunc == true)
+    {
+      gatherRadialDistFunc();
+    }
 
-  calculatePPTBoundaryFrac();
+    calculatePPTBoundaryFrac();
+  }
 
   notifyStatusMessage(getHumanLabel(), "Complete");
 }
@@ -37,6 +37,8 @@
 #ifndef _generateensemblestatistics_h_
 #define _generateensemblestatistics_h_
 
+#include <vector>
+
 #include "SIMPLib/SIMPLib.h"
 #include "SIMPLib/Common/AbstractFilter.h"
 #include "SIMPLib/Common/SIMPLibSetGetMacros.h"
@@ -171,6 +173,10 @@ class GenerateEnsembleStatistics : public AbstractFilter
     SIMPL_FILTER_PARAMETER(float, SizeCorrelationResolution)
     Q_PROPERTY(float SizeCorrelationResolution READ getSizeCorrelationResolution WRITE setSizeCorrelationResolution)
 
+    // Not a filter parameter: runs the gathers one after the other on the calling thread when false
+    SIMPL_INSTANCE_PROPERTY(bool, UseParallelGathers)
+    Q_PROPERTY(bool UseParallelGathers READ getUseParallelGathers WRITE setUseParallelGathers)
+
     /**
      * @brief getCompiledLibraryName Reimplemented from @see AbstractFilter class
      */
@@ -323,6 +329,12 @@ class GenerateEnsembleStatistics : public AbstractFilter
      */
     void calculatePPTBoundaryFrac();
 
+    /**
+     * @brief buildPhaseIndex Groups the Features by phase, in increasing Feature order, so that the gathers only
+     * visit the Features of the phases they consolidate
+     */
+    void buildPhaseIndex();
+
   private:
     DEFINE_DATAARRAY_VARIABLE(float, AvgQuats)
     DEFINE_DATAARRAY_VARIABLE(float, FeatureEulerAngles)
@@ -349,6 +361,9 @@ class GenerateEnsembleStatistics : public AbstractFilter
 
     QVector<DistributionAnalysisOps::Pointer> m_DistributionAnalysis;
 
+    std::vector<size_t> m_PhaseFeatureStart;
+    std::vector<int32_t> m_PhaseFeatureList;
+
     GenerateEnsembleStatistics(const GenerateEnsembleStatistics&); // Copy Constructor Not Implemented
     void operator=(const GenerateEnsembleStatistics&); // Operator '=' Not Implemented
 };
@@ -35,16 +35,26 @@
 
 #include "QuiltCellData.h"
 
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
 #include "SIMPLib/Common/Constants.h"
 #include "SIMPLib/Math/SIMPLibMath.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
 #include "SIMPLib/FilterParameters/IntVec3FilterParameter.h"
+#include "SIMPLib/FilterParameters/BooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
 #include "SIMPLib/FilterParameters/LinkedBooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
 #include "SIMPLib/Geometry/ImageGeom.h"
 
+#include "Statistics/StatisticsFilters/util/SummedAreaTable.hpp"
+
 // Include the MOC generated file for this class
 #include "moc_QuiltCellData.cpp"
 
@@ -59,6 +69,7 @@ QuiltCellData::QuiltCellData() :
   m_OutputDataContainerName(SIMPL::Defaults::NewImageDataContainerName),
   m_OutputAttributeMatrixName(SIMPL::Defaults::CellAttributeMatrixName),
   m_OutputArrayName("Quilt_Data"),
+  m_UseSummedAreaTable(true),
   m_OutputArray(NULL)
 {
   m_QuiltStep.x = 2;
@@ -88,6 +99,7 @@ void QuiltCellData::setupFilterParameters()
 
   parameters.push_back(SIMPL_NEW_INT_VEC3_FP("Quilt Step (Voxels)", QuiltStep, FilterParameter::Parameter, QuiltCellData));
   parameters.push_back(SIMPL_NEW_INT_VEC3_FP("Patch Size (Voxels)", PatchSize, FilterParameter::Parameter, QuiltCellData));
+  parameters.push_back(SIMPL_NEW_BOOL_FP("Use Summed-Area Table", UseSummedAreaTable, FilterParameter::Parameter, QuiltCellData));
 
   {
     DataArraySelectionFilterParameter::RequirementType req;
@@ -113,6 +125,7 @@ void QuiltCellData::readFilterParameters(AbstractFilterParametersReader* reader,
   setOutputArrayName( reader->readString( "OutputArrayName", getOutputArrayName() ) );
   setQuiltStep( reader->readIntVec3("QuiltStep", getQuiltStep() ) );
   setPatchSize( reader->readIntVec3("PatchSize", getPatchSize() ) );
+  setUseSummedAreaTable( reader->readValue("UseSummedAreaTable", getUseSummedAreaTable() ) );
   reader->closeFilterGroup();
 }
 
@@ -245,60 +258,41 @@ void QuiltCellData::preflight()
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-template<typename T>
-float quiltData(IDataArray::Pointer inputData, int64_t xc, int64_t yc, int64_t zc, IntVec3_t pSize, int64_t xDim, int64_t yDim, int64_t zDim)
+static void getPatchRange(int32_t patchSize, int64_t& low, int64_t& high)
 {
-  float value = 0.0;
-  DataArray<T>* cellArray = DataArray<T>::SafePointerDownCast(inputData.get());
-  if (NULL == cellArray)
+  // the offsets of a patch are [-patchSize / 2, patchSize / 2), or just 0 for a patch one cell wide
+  low = -static_cast<int64_t>(patchSize / 2);
+  high = static_cast<int64_t>(patchSize / 2);
+  if (patchSize == 1)
   {
-    return 0.0;
+    low = 0;
+    high = 1;
   }
+}
 
-  T* cPtr = cellArray->getPointer(0);
-
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+template<typename T>
+float quiltData(const T* cPtr, int64_t xc, int64_t yc, int64_t zc, const int64_t patchLow[3], const int64_t patchHigh[3], const int64_t dims[3])
+{
+  float value = 0.0;
   int64_t zStride = 0, yStride = 0;
   float count = 0;
 
-  int xRangeMin = -floorf((float)pSize.x / 2.0f);
-  int xRangeMax = floorf((float)pSize.x / 2.0f);
-  int yRangeMin = -floorf((float)pSize.y / 2.0f);
-  int yRangeMax = floorf((float)pSize.y / 2.0f);
-  int zRangeMin = -floorf((float)pSize.z / 2.0f);
-  int zRangeMax = floorf((float)pSize.z / 2.0f);
-
-  if (pSize.x == 1)
-  {
-    xRangeMin = 0;
-    xRangeMax = 1;
-  }
-
-  if (pSize.y == 1)
-  {
-    yRangeMin = 0;
-    yRangeMax = 1;
-  }
-
-
-  if (pSize.z == 1)
-  {
-    zRangeMin = 0;
-    zRangeMax = 1;
-  }
-
-  for(int64_t k = zRangeMin; k < zRangeMax; k++)
+  for(int64_t k = patchLow[2]; k < patchHigh[2]; k++)
   {
-    if((zc + k) >= 0 && (zc + k) < zDim)
+    if((zc + k) >= 0 && (zc + k) < dims[2])
     {
-      zStride = ((zc + k) * xDim * yDim);
-      for(int64_t j = yRangeMin; j < yRangeMax; j++)
+      zStride = ((zc + k) * dims[0] * dims[1]);
+      for(int64_t j = patchLow[1]; j < patchHigh[1]; j++)
       {
-        if((yc + j) >= 0 && (yc + j) < yDim)
+        if((yc + j) >= 0 && (yc + j) < dims[1])
         {
-          yStride = ((yc + j) * xDim);
-          for(int64_t i = xRangeMin; i < xRangeMax; i++)
+          yStride = ((yc + j) * dims[0]);
+          for(int64_t i = patchLow[0]; i < patchHigh[0]; i++)
           {
-            if((xc + i) >= 0 && (xc + i) < xDim)
+            if((xc + i) >= 0 && (xc + i) < dims[0])
             {
               value += cPtr[zStride + yStride + (xc + i)];
               count++;
@@ -319,6 +313,119 @@ float quiltData(IDataArray::Pointer inputData, int64_t xc, int64_t yc, int64_t z
   return value;
 }
 
+/**
+ * @brief The QuiltDataImpl class averages the cell array over the patches of a range of rows of the quilted
+ * image, either cell by cell or from the summed-area table of the cell array when one is given.
+ */
+template<typename T>
+class QuiltDataImpl
+{
+    const T* m_Data;
+    const SummedAreaTable* m_Table;
+    const int64_t* m_Dims;
+    const int64_t* m_OutDims;
+    IntVec3_t m_QuiltStep;
+    const int64_t* m_PatchLow;
+    const int64_t* m_PatchHigh;
+    float* m_Output;
+
+  public:
+    QuiltDataImpl(const T* data, const SummedAreaTable* table, const int64_t dims[3], const int64_t outDims[3], IntVec3_t quiltStep, const int64_t patchLow[3], const int64_t patchHigh[3], float* output) :
+      m_Data(data),
+      m_Table(table),
+      m_Dims(dims),
+      m_OutDims(outDims),
+      m_QuiltStep(quiltStep),
+      m_PatchLow(patchLow),
+      m_PatchHigh(patchHigh),
+      m_Output(output)
+    {}
+
+    virtual ~QuiltDataImpl() {}
+
+    void quilt(int64_t start, int64_t end) const
+    {
+      int64_t center[3] = { 0, 0, 0 };
+      int64_t low[3] = { 0, 0, 0 };
+      int64_t high[3] = { 0, 0, 0 };
+      for (int64_t row = start; row < end; row++)
+      {
+        int64_t j = row % m_OutDims[1];
+        center[1] = j * m_QuiltStep.y + m_QuiltStep.y / 2;
+        //center[2] = (row / m_OutDims[1]) * m_QuiltStep.z + m_QuiltStep.z / 2;
+        center[2] = 0;
+        for (int64_t i = 0; i < m_OutDims[0]; i++)
+        {
+          center[0] = i * m_QuiltStep.x + m_QuiltStep.x / 2;
+          if (NULL == m_Table)
+          {
+            m_Output[row * m_OutDims[0] + i] = quiltData<T>(m_Data, center[0], center[1], center[2], m_PatchLow, m_PatchHigh, m_Dims);
+            continue;
+          }
+
+          for (int32_t d = 0; d < 3; d++)
+          {
+            low[d] = center[d] + m_PatchLow[d];
+            high[d] = center[d] + m_PatchHigh[d];
+          }
+          int64_t count = 0;
+          double sum = m_Table->getBoxSum(low, high, count);
+          m_Output[row * m_OutDims[0] + i] = (count == 0) ? 0.0f : static_cast<float>(sum / static_cast<double>(count));
+        }
+      }
+    }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+    void operator()(const tbb::blocked_range<int64_t>& r) const
+    {
+      quilt(r.begin(), r.end());
+    }
+#endif
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+template<typename T>
+void quiltArray(IDataArray::Pointer inputData, bool useSummedAreaTable, const int64_t dims[3], const int64_t outDims[3], IntVec3_t quiltStep, IntVec3_t patchSize, float* output)
+{
+  DataArray<T>* cellArray = DataArray<T>::SafePointerDownCast(inputData.get());
+  if (NULL == cellArray)
+  {
+    return;
+  }
+  T* cPtr = cellArray->getPointer(0);
+
+  int64_t patchLow[3] = { 0, 0, 0 };
+  int64_t patchHigh[3] = { 0, 0, 0 };
+  getPatchRange(patchSize.x, patchLow[0], patchHigh[0]);
+  getPatchRange(patchSize.y, patchLow[1], patchHigh[1]);
+  getPatchRange(patchSize.z, patchLow[2], patchHigh[2]);
+
+  // every patch is centered on the first slice, so the table only needs the slices one patch reaches
+  SummedAreaTable table;
+  if (useSummedAreaTable == true)
+  {
+    table.initialize(cPtr, dims, patchLow[2], patchHigh[2]);
+  }
+  const SummedAreaTable* tablePtr = (useSummedAreaTable == true) ? &table : NULL;
+
+  int64_t numRows = outDims[1] * outDims[2];
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+  tbb::task_scheduler_init init;
+  bool doParallel = true;
+  if (doParallel == true)
+  {
+    tbb::parallel_for(tbb::blocked_range<int64_t>(0, numRows), QuiltDataImpl<T>(cPtr, tablePtr, dims, outDims, quiltStep, patchLow, patchHigh, output), tbb::auto_partitioner());
+  }
+  else
+#endif
+  {
+    QuiltDataImpl<T> serial(cPtr, tablePtr, dims, outDims, quiltStep, patchLow, patchHigh, output);
+    serial.quilt(0, numRows);
+  }
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -352,67 +459,52 @@ void QuiltCellData::execute()
   dims[0] = static_cast<int64_t>(dcDims[0]);
   dims[1] = static_cast<int64_t>(dcDims[1]);
   dims[2] = static_cast<int64_t>(dcDims[2]);
+  int64_t outDims[3] = { static_cast<int64_t>(dc2Dims[0]), static_cast<int64_t>(dc2Dims[1]), static_cast<int64_t>(dc2Dims[2]) };
 
-  int64_t zStride = 0, yStride = 0;
-  int64_t xc = 0, yc = 0, zc = 0;
-  for(size_t k = 0; k < dc2Dims[2]; k++)
+  // the summed-area table makes every patch average cost the same, however large the patch
+  if (dType.compare("int8_t") == 0)
   {
-    zStride = (k * dc2Dims[0] * dc2Dims[1]);
-    for(size_t j = 0; j < dc2Dims[1]; j++)
-    {
-      yStride = (j * dc2Dims[0]);
-      for(size_t i = 0; i < dc2Dims[0]; i++)
-      {
-        xc = i * m_QuiltStep.x + m_QuiltStep.x / 2;
-        yc = j * m_QuiltStep.y + m_QuiltStep.y / 2;
-        //zc = k * m_QuiltStep.z + m_QuiltStep.z / 2;
-        zc = 0;
-        if (dType.compare("int8_t") == 0)
-        {
-          m_OutputArray[zStride + yStride + i] = quiltData<int8_t>(inputData, xc, yc, zc, m_PatchSize, dims[0], dims[1], dims[2]);
-        }
-        else if (dType.compare("uint8_t") == 0)
-        {
-          m_OutputArray[zStride + yStride + i] = quiltData<uint8_t>(inputData, xc, yc, zc, m_PatchSize, dims[0], dims[1], dims[2]);
-        }
-        else if (dType.compare("int16_t") == 0)
-        {
-          m_OutputArray[zStride + yStride + i] = quiltData<int16_t>(inputData, xc, yc, zc, m_PatchSize, dims[0], dims[1], dims[2]);
-        }
-        else if (dType.compare("uint16_t") == 0)
-        {
-          m_OutputArray[zStride + yStride + i] = quiltData<uint16_t>(inputData, xc, yc, zc, m_PatchSize, dims[0], dims[1], dims[2]);
-        }
-        else if (dType.compare("int32_t") == 0)
-        {
-          m_OutputArray[zStride + yStride + i] = quiltData<int32_t>(inputData, xc, yc, zc, m_PatchSize, dims[0], dims[1], dims[2]);
-        }
-        else if (dType.compare("uint32_t") == 0)
-        {
-          m_OutputArray[zStride + yStride + i] = quiltData<uint32_t>(inputData, xc, yc, zc, m_PatchSize, dims[0], dims[1], dims[2]);
-        }
-        else if (dType.compare("int64_t") == 0)
-        {
-          m_OutputArray[zStride + yStride + i] = quiltData<int64_t>(inputData, xc, yc, zc, m_PatchSize, dims[0], dims[1], dims[2]);
-        }
-        else if (dType.compare("uint64_t") == 0)
-        {
-          m_OutputArray[zStride + yStride + i] = quiltData<uint64_t>(inputData, xc, yc, zc, m_PatchSize, dims[0], dims[1], dims[2]);
-        }
-        else if (dType.compare("float") == 0)
-        {
-          m_OutputArray[zStride + yStride + i] = quiltData<float>(inputData, xc, yc, zc, m_PatchSize, dims[0], dims[1], dims[2]);
-        }
-        else if (dType.compare("double") == 0)
-        {
-          m_OutputArray[zStride + yStride + i] = quiltData<double>(inputData, xc, yc, zc, m_PatchSize, dims[0], dims[1], dims[2]);
-        }
-        else if (dType.compare("bool") == 0)
-        {
-          m_OutputArray[zStride + yStride + i] = quiltData<bool>(inputData, xc, yc, zc, m_PatchSize, dims[0], dims[1], dims[2]);
-        }
-      }
-    }
+    quiltArray<int8_t>(inputData, m_UseSummedAreaTable, dims, outDims, m_QuiltStep, m_PatchSize, m_OutputArray);
+  }
+  else if (dType.compare("uint8_t") == 0)
+  {
+    quiltArray<uint8_t>(inputData, m_UseSummedAreaTable, dims, outDims, m_QuiltStep, m_PatchSize, m_OutputArray);
+  }
+  else if (dType.compare("int16_t") == 0)
+  {
+    quiltArray<int16_t>(inputData, m_UseSummedAreaTable, dims, outDims, m_QuiltStep, m_PatchSize, m_OutputArray);
+  }
+  else if (dType.compare("uint16_t") == 0)
+  {
+    quiltArray<uint16_t>(inputData, m_UseSummedAreaTable, dims, outDims, m_QuiltStep, m_PatchSize, m_OutputArray);
+  }
+  else if (dType.compare("int32_t") == 0)
+  {
+    quiltArray<int32_t>(inputData, m_UseSummedAreaTable, dims, outDims, m_QuiltStep, m_PatchSize, m_OutputArray);
+  }
+  else if (dType.compare("uint32_t") == 0)
+  {
+    quiltArray<uint32_t>(inputData, m_UseSummedAreaTable, dims, outDims, m_QuiltStep, m_PatchSize, m_OutputArray);
+  }
+  else if (dType.compare("int64_t") == 0)
+  {
+    quiltArray<int64_t>(inputData, m_UseSummedAreaTable, dims, outDims, m_QuiltStep, m_PatchSize, m_OutputArray);
+  }
+  else if (dType.compare("uint64_t") == 0)
+  {
+    quiltArray<uint64_t>(inputData, m_UseSummedAreaTable, dims, outDims, m_QuiltStep, m_PatchSize, m_OutputArray);
+  }
+  else if (dType.compare("float") == 0)
+  {
+    quiltArray<float>(inputData, m_UseSummedAreaTable, dims, outDims, m_QuiltStep, m_PatchSize, m_OutputArray);
+  }
+  else if (dType.compare("double") == 0)
+  {
+    quiltArray<double>(inputData, m_UseSummedAreaTable, dims, outDims, m_QuiltStep, m_PatchSize, m_OutputArray);
+  }
+  else if (dType.compare("bool") == 0)
+  {
+    quiltArray<bool>(inputData, m_UseSummedAreaTable, dims, outDims, m_QuiltStep, m_PatchSize, m_OutputArray);
   }
 
   notifyStatusMessage(getHumanLabel(), "Complete");
@@ -73,6 +73,8 @@ class QuiltCellData : public AbstractFilter
     Q_PROPERTY(IntVec3_t QuiltStep READ getQuiltStep WRITE setQuiltStep)
     SIMPL_FILTER_PARAMETER(IntVec3_t, PatchSize)
     Q_PROPERTY(IntVec3_t PatchSize READ getPatchSize WRITE setPatchSize)
+    SIMPL_FILTER_PARAMETER(bool, UseSummedAreaTable)
+    Q_PROPERTY(bool UseSummedAreaTable READ getUseSummedAreaTable WRITE setUseSummedAreaTable)
 
     // The user selects a new DataContainerName
     SIMPL_FILTER_PARAMETER(QString, OutputDataContainerName)
@@ -65,7 +65,15 @@ foreach(f ${_PrivateFilters} )
 endforeach()
 
 
-
+#-------------
+# These are files that need to be compiled into DREAM3DLib but are NOT filters
+ADD_SIMPL_SUPPORT_HEADER_SUBDIR(${Statistics_SOURCE_DIR} ${_filterGroupName} FaceContactGraph.hpp util)
+ADD_SIMPL_SUPPORT_HEADER_SUBDIR(${Statistics_SOURCE_DIR} ${_filterGroupName} CentroidBinGrid.hpp util)
+ADD_SIMPL_SUPPORT_HEADER_SUBDIR(${Statistics_SOURCE_DIR} ${_filterGroupName} HistogramEngine.hpp util)
+ADD_SIMPL_SUPPORT_HEADER_SUBDIR(${Statistics_SOURCE_DIR} ${_filterGroupName} SymmetricEigenSolver.hpp util)
+ADD_SIMPL_SUPPORT_HEADER_SUBDIR(${Statistics_SOURCE_DIR} ${_filterGroupName} DistributionBuckets.hpp util)
+ADD_SIMPL_SUPPORT_HEADER_SUBDIR(${Statistics_SOURCE_DIR} ${_filterGroupName} SummedAreaTable.hpp util)
+ADD_SIMPL_SUPPORT_HEADER_SUBDIR(${Statistics_SOURCE_DIR} ${_filterGroupName} CrossSectionCounter.hpp util)
 
 SIMPL_END_FILTER_GROUP(${Statistics_BINARY_DIR} "${_filterGroupName}" "Statistics Filters")
 
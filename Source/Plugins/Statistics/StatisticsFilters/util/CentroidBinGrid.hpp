@@ -0,0 +1,251 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#ifndef _centroidbingrid_hpp_
+#define _centroidbingrid_hpp_
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "SIMPLib/SIMPLib.h"
+
+/**
+ * @class CentroidBinGrid CentroidBinGrid.hpp Statistics/StatisticsFilters/util/CentroidBinGrid.hpp
+ * @brief Uniform grid cell list over the integer bins of Feature centroids.
+ *
+ * Every Feature is placed in a bin of its centroid (typically the centroid divided by the average diameter), and
+ * findWithinBins() returns the Features whose bins are all within a critical distance of a query Feature's bins,
+ * exactly as comparing the query against every other Feature would. The Features are counting sorted into cells of
+ * getCellSize() bins per axis, so a query only visits the cells overlapping its critical distance. The cell size is
+ * 1 unless the occupied bins are so sparse that the cells would far outnumber the Features. Queries only read the
+ * grid, so any number of them may run concurrently.
+ */
+class CentroidBinGrid
+{
+  public:
+    CentroidBinGrid() :
+      m_NumFeatures(0),
+      m_FirstFeature(0),
+      m_Bins(NULL),
+      m_CellSize(1),
+      m_MaxReach(0)
+    {
+      for (int32_t d = 0; d < 3; d++)
+      {
+        m_MinBin[d] = 0;
+        m_MaxBin[d] = -1;
+        m_NumCells[d] = 0;
+      }
+    }
+
+    virtual ~CentroidBinGrid() {}
+
+    /**
+     * @brief initialize Sorts the Features into the grid
+     * @param bins Bins of the Features, 3 per Feature; must outlive the grid
+     * @param numFeatures Number of Features, including those before firstFeature
+     * @param firstFeature First Feature placed in the grid; Features before it are never found
+     */
+    void initialize(const int64_t* bins, size_t numFeatures, size_t firstFeature)
+    {
+      m_Bins = bins;
+      m_NumFeatures = numFeatures;
+      m_FirstFeature = std::min(firstFeature, numFeatures);
+      m_CellSize = 1;
+      m_MaxReach = 0;
+      for (int32_t d = 0; d < 3; d++)
+      {
+        m_MinBin[d] = 0;
+        m_MaxBin[d] = -1;
+        m_NumCells[d] = 0;
+      }
+      m_CellOffsets.clear();
+      m_CellFeatures.clear();
+      if (m_FirstFeature >= m_NumFeatures) { return; }
+
+      for (int32_t d = 0; d < 3; d++)
+      {
+        m_MinBin[d] = m_Bins[3 * m_FirstFeature + d];
+        m_MaxBin[d] = m_MinBin[d];
+      }
+      for (size_t i = m_FirstFeature + 1; i < m_NumFeatures; i++)
+      {
+        for (int32_t d = 0; d < 3; d++)
+        {
+          m_MinBin[d] = std::min(m_MinBin[d], m_Bins[3 * i + d]);
+          m_MaxBin[d] = std::max(m_MaxBin[d], m_Bins[3 * i + d]);
+        }
+      }
+      for (int32_t d = 0; d < 3; d++)
+      {
+        m_MaxReach = std::max(m_MaxReach, m_MaxBin[d] - m_MinBin[d]);
+      }
+
+      // Coarsen the cells until there are at most a few per Feature
+      double maxCells = std::max(64.0, 8.0 * static_cast<double>(m_NumFeatures - m_FirstFeature));
+      while (true)
+      {
+        double totalCells = 1.0;
+        for (int32_t d = 0; d < 3; d++)
+        {
+          m_NumCells[d] = ((m_MaxBin[d] - m_MinBin[d]) / m_CellSize) + 1;
+          totalCells *= static_cast<double>(m_NumCells[d]);
+        }
+        if (totalCells <= maxCells) { break; }
+        m_CellSize *= 2;
+      }
+
+      size_t totalCells = static_cast<size_t>(m_NumCells[0] * m_NumCells[1] * m_NumCells[2]);
+      m_CellOffsets.assign(totalCells + 1, 0);
+      for (size_t i = m_FirstFeature; i < m_NumFeatures; i++)
+      {
+        m_CellOffsets[cellOf(i) + 1]++;
+      }
+      for (size_t c = 0; c < totalCells; c++)
+      {
+        m_CellOffsets[c + 1] += m_CellOffsets[c];
+      }
+      std::vector<size_t> fill(m_CellOffsets.begin(), m_CellOffsets.end() - 1);
+      m_CellFeatures.resize(m_NumFeatures - m_FirstFeature);
+      for (size_t i = m_FirstFeature; i < m_NumFeatures; i++)
+      {
+        m_CellFeatures[fill[cellOf(i)]++] = static_cast<int32_t>(i);
+      }
+    }
+
+    /**
+     * @brief getNumberOfFeatures Returns the number of Features, including those before the first one in the grid
+     */
+    size_t getNumberOfFeatures() const { return m_NumFeatures; }
+
+    /**
+     * @brief getCellSize Returns the number of bins along each axis of a cell
+     */
+    int64_t getCellSize() const { return m_CellSize; }
+
+    /**
+     * @brief getNumberOfCells Returns the number of cells of the grid
+     */
+    size_t getNumberOfCells() const { return m_CellOffsets.empty() ? 0 : m_CellOffsets.size() - 1; }
+
+    /**
+     * @brief findWithinBins Finds the Features whose bins differ from those of feature by less than criticalDistance
+     * along every axis
+     * @param feature The query Feature, which must be in the grid; it is never part of the result
+     * @param criticalDistance Critical distance in bins
+     * @param neighbors Filled with the Features found, in ascending order
+     */
+    void findWithinBins(size_t feature, float criticalDistance, std::vector<int32_t>& neighbors) const
+    {
+      neighbors.clear();
+      // No bin distance is below a critical distance that is not positive (or is NaN)
+      if ((criticalDistance > 0.0f) == false) { return; }
+
+      // Largest whole number of bins below the critical distance, clamped to the extent of the grid
+      int64_t reach = m_MaxReach;
+      if (criticalDistance <= static_cast<float>(m_MaxReach))
+      {
+        reach = static_cast<int64_t>(ceilf(criticalDistance)) - 1;
+      }
+
+      const int64_t* bin1 = m_Bins + 3 * feature;
+      int64_t cellMin[3] = { 0, 0, 0 };
+      int64_t cellMax[3] = { 0, 0, 0 };
+      for (int32_t d = 0; d < 3; d++)
+      {
+        cellMin[d] = (std::max(bin1[d] - reach, m_MinBin[d]) - m_MinBin[d]) / m_CellSize;
+        cellMax[d] = (std::min(bin1[d] + reach, m_MaxBin[d]) - m_MinBin[d]) / m_CellSize;
+      }
+
+      for (int64_t cz = cellMin[2]; cz <= cellMax[2]; cz++)
+      {
+        for (int64_t cy = cellMin[1]; cy <= cellMax[1]; cy++)
+        {
+          size_t rowStart = static_cast<size_t>((cz * m_NumCells[1] + cy) * m_NumCells[0]);
+          size_t first = m_CellOffsets[rowStart + cellMin[0]];
+          size_t last = m_CellOffsets[rowStart + cellMax[0] + 1];
+          for (size_t n = first; n < last; n++)
+          {
+            size_t j = static_cast<size_t>(m_CellFeatures[n]);
+            if (j == feature) { continue; }
+            const int64_t* bin2 = m_Bins + 3 * j;
+            // Use the llabs version of the "C" abs function because we are using int64_t
+            float dBinX = static_cast<float>(llabs(bin2[0] - bin1[0]));
+            float dBinY = static_cast<float>(llabs(bin2[1] - bin1[1]));
+            float dBinZ = static_cast<float>(llabs(bin2[2] - bin1[2]));
+            if (dBinX < criticalDistance && dBinY < criticalDistance && dBinZ < criticalDistance)
+            {
+              neighbors.push_back(static_cast<int32_t>(j));
+            }
+          }
+        }
+      }
+      std::sort(neighbors.begin(), neighbors.end());
+    }
+
+  private:
+    size_t m_NumFeatures;
+    size_t m_FirstFeature;
+    const int64_t* m_Bins;
+    int64_t m_CellSize;
+    int64_t m_MaxReach;
+    int64_t m_MinBin[3];
+    int64_t m_MaxBin[3];
+    int64_t m_NumCells[3];
+    std::vector<size_t> m_CellOffsets;
+    std::vector<int32_t> m_CellFeatures;
+
+    /**
+     * @brief cellOf Returns the index of the cell holding Feature i
+     */
+    size_t cellOf(size_t i) const
+    {
+      int64_t c[3] = { 0, 0, 0 };
+      for (int32_t d = 0; d < 3; d++)
+      {
+        c[d] = (m_Bins[3 * i + d] - m_MinBin[d]) / m_CellSize;
+      }
+      return static_cast<size_t>((c[2] * m_NumCells[1] + c[1]) * m_NumCells[0] + c[0]);
+    }
+
+    CentroidBinGrid(const CentroidBinGrid&); // Copy Constructor Not Implemented
+    void operator=(const CentroidBinGrid&); // Operator '=' Not Implemented
+};
+
+#endif /* _centroidbingrid_hpp_ */
@@ -0,0 +1,270 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#ifndef _crosssectioncounter_hpp_
+#define _crosssectioncounter_hpp_
+
+#include <algorithm>
+#include <vector>
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
+#include "SIMPLib/SIMPLib.h"
+
+/**
+ * @class CrossSectionCounter CrossSectionCounter.hpp Statistics/StatisticsFilters/util/CrossSectionCounter.hpp
+ * @brief Finds the largest number of cells of every Feature in any single plane of an image geometry that is normal
+ * to one axis.
+ *
+ * The planes are split into contiguous chunks. Each chunk keeps the largest count of every Feature over its planes,
+ * and the chunks are then reduced per Feature, both in parallel when available. The counter of a plane is sparse:
+ * only the Features found in that plane are touched while counting and reset afterwards.
+ */
+class CrossSectionCounter
+{
+  public:
+    CrossSectionCounter() :
+      m_NumChunks(0)
+    {}
+
+    virtual ~CrossSectionCounter() {}
+
+    /**
+     * @brief GetPlaneLayout Returns how the planes normal to one axis are laid out in the FeatureIds
+     * @param dims Number of cells along x, y and z
+     * @param plane 0 for the XY planes, 1 for the XZ planes and 2 for the YZ planes
+     * @param extents Receives the number of planes and the number of cells along the two in-plane axes
+     * @param strides Receives the index strides of the plane axis and of the two in-plane axes
+     */
+    static void GetPlaneLayout(const size_t dims[3], int32_t plane, size_t extents[3], size_t strides[3])
+    {
+      // the in-plane axes are taken in increasing order, and the plane axis is the remaining one
+      const int32_t axes[3][3] = { { 2, 0, 1 }, { 1, 0, 2 }, { 0, 1, 2 } };
+      const size_t axisStrides[3] = { 1, dims[0], dims[0] * dims[1] };
+      for (int32_t i = 0; i < 3; i++)
+      {
+        extents[i] = dims[axes[plane][i]];
+        strides[i] = axisStrides[axes[plane][i]];
+      }
+    }
+
+    /**
+     * @brief execute Counts the cells of every Feature in each plane and keeps the largest count
+     * @param featureIds Feature Id of every cell, x fastest
+     * @param dims Number of cells along x, y and z
+     * @param plane 0 for the XY planes, 1 for the XZ planes and 2 for the YZ planes
+     * @param numFeatures Number of Features; Ids outside [1, numFeatures) are skipped
+     * @param numChunks Number of chunks of planes that are counted separately; 0 lets the counter choose
+     */
+    void execute(const int32_t* featureIds, const size_t dims[3], int32_t plane, size_t numFeatures, size_t numChunks)
+    {
+      size_t extents[3] = { 0, 0, 0 };
+      size_t strides[3] = { 0, 0, 0 };
+      GetPlaneLayout(dims, plane, extents, strides);
+      m_LargestCounts.assign(numFeatures, 0);
+      m_NumChunks = 0;
+      if (extents[0] == 0 || numFeatures == 0) { return; }
+
+      // every chunk keeps the largest count of each Feature in its planes, so unless overridden the number of chunks
+      // is limited to keep that memory below the size of the FeatureIds
+      if (numChunks == 0)
+      {
+        numChunks = 1;
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+        numChunks = tbb::task_scheduler_init::default_num_threads();
+        size_t maxChunks = (extents[0] * extents[1] * extents[2] * sizeof(int32_t)) / (2 * numFeatures * sizeof(size_t));
+        numChunks = std::min(numChunks, std::max(maxChunks, static_cast<size_t>(1)));
+#endif
+      }
+      m_NumChunks = std::min(numChunks, extents[0]);
+      std::vector<std::vector<size_t> > chunkMaxCounts(m_NumChunks);
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+      tbb::task_scheduler_init init;
+      bool doParallel = true;
+      if (doParallel == true)
+      {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, m_NumChunks, 1),
+                          CountsImpl(featureIds, numFeatures, extents, strides, m_NumChunks, &(chunkMaxCounts.front())), tbb::auto_partitioner());
+        tbb::parallel_for(tbb::blocked_range<size_t>(1, numFeatures),
+                          MaxImpl(&(chunkMaxCounts.front()), m_NumChunks, &(m_LargestCounts.front())), tbb::auto_partitioner());
+      }
+      else
+#endif
+      {
+        CountsImpl serial(featureIds, numFeatures, extents, strides, m_NumChunks, &(chunkMaxCounts.front()));
+        serial.count(0, m_NumChunks);
+        MaxImpl reduce(&(chunkMaxCounts.front()), m_NumChunks, &(m_LargestCounts.front()));
+        reduce.reduce(1, numFeatures);
+      }
+    }
+
+    /**
+     * @brief getLargestCount Returns the largest number of cells of the Feature in any one plane
+     */
+    size_t getLargestCount(size_t feature) const { return m_LargestCounts[feature]; }
+
+    /**
+     * @brief getNumberOfChunks Returns the number of chunks of planes the last execute() used
+     */
+    size_t getNumberOfChunks() const { return m_NumChunks; }
+
+  private:
+    std::vector<size_t> m_LargestCounts;
+    size_t m_NumChunks;
+
+    /**
+     * @brief Counts the cells of every Feature in each plane of a range of chunks of planes and keeps the largest
+     * count of every Feature over each chunk
+     */
+    class CountsImpl
+    {
+        const int32_t* m_FeatureIds;
+        size_t m_NumFeatures;
+        size_t m_Extents[3];
+        size_t m_Strides[3];
+        size_t m_NumChunks;
+        std::vector<size_t>* m_ChunkMaxCounts;
+
+      public:
+        CountsImpl(const int32_t* featureIds, size_t numFeatures, const size_t extents[3], const size_t strides[3], size_t numChunks, std::vector<size_t>* chunkMaxCounts) :
+          m_FeatureIds(featureIds),
+          m_NumFeatures(numFeatures),
+          m_NumChunks(numChunks),
+          m_ChunkMaxCounts(chunkMaxCounts)
+        {
+          for (int32_t i = 0; i < 3; i++)
+          {
+            m_Extents[i] = extents[i];
+            m_Strides[i] = strides[i];
+          }
+        }
+
+        virtual ~CountsImpl() {}
+
+        void count(size_t start, size_t end) const
+        {
+          std::vector<size_t> counts(m_NumFeatures, 0);
+          std::vector<int32_t> present;
+          for (size_t c = start; c < end; c++)
+          {
+            std::vector<size_t>& maxCounts = m_ChunkMaxCounts[c];
+            maxCounts.assign(m_NumFeatures, 0);
+            size_t planeStart = (m_Extents[0] * c) / m_NumChunks;
+            size_t planeEnd = (m_Extents[0] * (c + 1)) / m_NumChunks;
+            for (size_t i = planeStart; i < planeEnd; i++)
+            {
+              size_t istride = i * m_Strides[0];
+              for (size_t k = 0; k < m_Extents[2]; k++)
+              {
+                size_t kstride = istride + k * m_Strides[2];
+                for (size_t j = 0; j < m_Extents[1]; j++)
+                {
+                  int32_t gnum = m_FeatureIds[kstride + j * m_Strides[1]];
+                  if (gnum <= 0 || static_cast<size_t>(gnum) >= m_NumFeatures) { continue; }
+                  if (counts[gnum] == 0) { present.push_back(gnum); }
+                  counts[gnum]++;
+                }
+              }
+              size_t numPresent = present.size();
+              for (size_t n = 0; n < numPresent; n++)
+              {
+                int32_t gnum = present[n];
+                if (counts[gnum] > maxCounts[gnum]) { maxCounts[gnum] = counts[gnum]; }
+                counts[gnum] = 0;
+              }
+              present.clear();
+            }
+          }
+        }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+        void operator()(const tbb::blocked_range<size_t>& r) const
+        {
+          count(r.begin(), r.end());
+        }
+#endif
+    };
+
+    /**
+     * @brief Reduces the largest counts of all chunks of planes for a range of Features
+     */
+    class MaxImpl
+    {
+        const std::vector<size_t>* m_ChunkMaxCounts;
+        size_t m_NumChunks;
+        size_t* m_LargestCounts;
+
+      public:
+        MaxImpl(const std::vector<size_t>* chunkMaxCounts, size_t numChunks, size_t* largestCounts) :
+          m_ChunkMaxCounts(chunkMaxCounts),
+          m_NumChunks(numChunks),
+          m_LargestCounts(largestCounts)
+        {}
+
+        virtual ~MaxImpl() {}
+
+        void reduce(size_t start, size_t end) const
+        {
+          for (size_t g = start; g < end; g++)
+          {
+            size_t maxCount = 0;
+            for (size_t c = 0; c < m_NumChunks; c++)
+            {
+              maxCount = std::max(maxCount, m_ChunkMaxCounts[c][g]);
+            }
+            m_LargestCounts[g] = maxCount;
+          }
+        }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+        void operator()(const tbb::blocked_range<size_t>& r) const
+        {
+          reduce(r.begin(), r.end());
+        }
+#endif
+    };
+
+    CrossSectionCounter(const CrossSectionCounter&); // Copy Constructor Not Implemented
+    void operator=(const CrossSectionCounter&); // Operator '=' Not Implemented
+};
+
+#endif /* _crosssectioncounter_hpp_ */
@@ -0,0 +1,224 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#ifndef _distributionbuckets_hpp_
+#define _distributionbuckets_hpp_
+
+#include <vector>
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
+#include "SIMPLib/SIMPLib.h"
+
+#include "Statistics/DistributionAnalysisOps/DistributionAnalysisOps.h"
+
+/**
+ * @class DistributionBuckets DistributionBuckets.hpp Statistics/StatisticsFilters/util/DistributionBuckets.hpp
+ * @brief Sorts the values of a Feature array into one bucket per (Ensemble, bin) and fits a distribution to every
+ * bucket in parallel.
+ *
+ * initialize() counts the Features of every bucket and places their values into one flat buffer, bucket after
+ * bucket, in increasing Feature order, so every bucket holds the same values in the same order as a vector filled
+ * one Feature at a time. Bucket b of Ensemble e and bin j is e * numBins + j. fit() then runs the fits of the
+ * buckets independently of each other and writes the parameters of bucket b to parameters[numColumns * b], which
+ * is the layout of the Ensemble arrays of FitFeatureData and FitCorrelatedFeatureData.
+ */
+class DistributionBuckets
+{
+  public:
+    DistributionBuckets() :
+      m_NumBins(1)
+    {}
+
+    virtual ~DistributionBuckets() {}
+
+    /**
+     * @brief initialize Sorts the values of Features 1 to numFeatures - 1 into their buckets
+     * @param values The Feature values
+     * @param numFeatures Number of Features, including Feature 0
+     * @param ensembleIds The Ensemble of every Feature; Features outside [0, numEnsembles) are skipped
+     * @param numEnsembles Number of Ensembles
+     * @param binIds The bin of every Feature, or NULL for a single bin; negative bins are skipped and bins past the
+     * last one are counted in the last one
+     * @param numBins Number of bins per Ensemble
+     * @param excluded Features whose value is true are skipped; may be NULL
+     */
+    template<typename T>
+    void initialize(const T* values, size_t numFeatures, const int32_t* ensembleIds, int64_t numEnsembles, const int32_t* binIds, int32_t numBins, const bool* excluded)
+    {
+      m_NumBins = (NULL == binIds || numBins < 1) ? 1 : numBins;
+      size_t numBuckets = (numEnsembles > 0) ? static_cast<size_t>(numEnsembles) * m_NumBins : 0;
+
+      // Counting sort: the bucket of every Feature, the bucket sizes, then the values placed bucket after bucket
+      std::vector<int64_t> featureBuckets(numFeatures, -1);
+      m_BucketStart.assign(numBuckets + 1, 0);
+      for (size_t i = 1; i < numFeatures; i++)
+      {
+        if (NULL != excluded && excluded[i] == true) { continue; }
+        int32_t ensemble = ensembleIds[i];
+        if (ensemble < 0 || ensemble >= numEnsembles) { continue; }
+        int32_t bin = 0;
+        if (NULL != binIds)
+        {
+          bin = binIds[i];
+          if (bin < 0) { continue; }
+          if (bin >= m_NumBins) { bin = m_NumBins - 1; }
+        }
+        featureBuckets[i] = static_cast<int64_t>(ensemble) * m_NumBins + bin;
+        m_BucketStart[featureBuckets[i] + 1]++;
+      }
+      for (size_t b = 0; b < numBuckets; b++)
+      {
+        m_BucketStart[b + 1] += m_BucketStart[b];
+      }
+
+      m_Values.resize(m_BucketStart[numBuckets]);
+      std::vector<size_t> next(m_BucketStart.begin(), m_BucketStart.end() - 1);
+      for (size_t i = 1; i < numFeatures; i++)
+      {
+        if (featureBuckets[i] < 0) { continue; }
+        m_Values[next[featureBuckets[i]]++] = static_cast<float>(values[i]);
+      }
+    }
+
+    /**
+     * @brief getNumberOfBuckets Returns the number of buckets, numEnsembles * numBins
+     */
+    size_t getNumberOfBuckets() const { return m_BucketStart.empty() ? 0 : m_BucketStart.size() - 1; }
+
+    /**
+     * @brief getBucketSize Returns the number of values in bucket b
+     */
+    size_t getBucketSize(size_t b) const { return m_BucketStart[b + 1] - m_BucketStart[b]; }
+
+    /**
+     * @brief getBucketValues Returns the values of bucket b, or NULL when it is empty
+     */
+    const float* getBucketValues(size_t b) const { return (getBucketSize(b) > 0) ? &(m_Values[m_BucketStart[b]]) : NULL; }
+
+    /**
+     * @brief fit Fits the distribution to the buckets from firstBucket on
+     * @param distribution The distribution to fit
+     * @param correlated Fits the buckets like the bins of DistributionAnalysisOps::calculateCorrelatedParameters()
+     * when true, and like DistributionAnalysisOps::calculateParameters() otherwise
+     * @param firstBucket The first bucket to fit; the parameters of the buckets before it are not written
+     * @param numColumns Number of parameters stored per bucket; the columns past the ones the distribution has are set to 0
+     * @param parameters Receives numColumns parameters per bucket
+     */
+    void fit(DistributionAnalysisOps::Pointer distribution, bool correlated, size_t firstBucket, int32_t numColumns, float* parameters) const
+    {
+      size_t numBuckets = getNumberOfBuckets();
+      if (firstBucket >= numBuckets || NULL == distribution.get()) { return; }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+      tbb::task_scheduler_init init;
+      bool doParallel = true;
+      if (doParallel == true)
+      {
+        tbb::parallel_for(tbb::blocked_range<size_t>(firstBucket, numBuckets), FitImpl(this, distribution.get(), correlated, numColumns, parameters), tbb::auto_partitioner());
+      }
+      else
+#endif
+      {
+        FitImpl serial(this, distribution.get(), correlated, numColumns, parameters);
+        serial.run(firstBucket, numBuckets);
+      }
+    }
+
+  private:
+    int32_t m_NumBins;
+    std::vector<size_t> m_BucketStart;
+    std::vector<float> m_Values;
+
+    /**
+     * @brief Fits a range of buckets
+     */
+    class FitImpl
+    {
+        const DistributionBuckets* m_Buckets;
+        DistributionAnalysisOps* m_Distribution;
+        bool m_Correlated;
+        int32_t m_NumColumns;
+        float* m_Parameters;
+
+      public:
+        FitImpl(const DistributionBuckets* buckets, DistributionAnalysisOps* distribution, bool correlated, int32_t numColumns, float* parameters) :
+          m_Buckets(buckets),
+          m_Distribution(distribution),
+          m_Correlated(correlated),
+          m_NumColumns(numColumns),
+          m_Parameters(parameters)
+        {}
+
+        virtual ~FitImpl() {}
+
+        void run(size_t start, size_t end) const
+        {
+          for (size_t b = start; b < end; b++)
+          {
+            float fitted[2] = { 0.0f, 0.0f };
+            if (m_Correlated == true)
+            {
+              m_Distribution->calculateBinParameters(m_Buckets->getBucketValues(b), m_Buckets->getBucketSize(b), fitted);
+            }
+            else
+            {
+              m_Distribution->calculateParameters(m_Buckets->getBucketValues(b), m_Buckets->getBucketSize(b), fitted);
+            }
+            for (int32_t k = 0; k < m_NumColumns; k++)
+            {
+              m_Parameters[m_NumColumns * b + k] = (k < 2) ? fitted[k] : 0.0f;
+            }
+          }
+        }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+        void operator()(const tbb::blocked_range<size_t>& r) const
+        {
+          run(r.begin(), r.end());
+        }
+#endif
+    };
+
+    DistributionBuckets(const DistributionBuckets&); // Copy Constructor Not Implemented
+    void operator=(const DistributionBuckets&); // Operator '=' Not Implemented
+};
+
+#endif /* _distributionbuckets_hpp_ */
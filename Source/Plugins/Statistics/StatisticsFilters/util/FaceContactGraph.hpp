@@ -0,0 +1,224 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#ifndef _facecontactgraph_hpp_
+#define _facecontactgraph_hpp_
+
+#include <vector>
+
+#include "SIMPLib/SIMPLib.h"
+
+/**
+ * @class FaceContactGraph FaceContactGraph.hpp Statistics/StatisticsFilters/util/FaceContactGraph.hpp
+ * @brief Compressed sparse row adjacency of Features that share cell faces, with the number of shared faces.
+ *
+ * A contact between Feature A and Feature B is packed into one 64 bit key with A in the high half, so that sorting
+ * the keys groups them by Feature and then by neighbor. The cells of a volume are usually scanned in slabs: every
+ * slab radix sorts the keys of its faces and run-length counts them with SortKeys() and CountRuns(), and build()
+ * then merges the counted contacts of all slabs into one row of (neighbor, face count) entries per Feature, with
+ * the neighbors in ascending order.
+ */
+class FaceContactGraph
+{
+  public:
+    /**
+     * @brief A contact key and the number of faces it was found on
+     */
+    typedef struct
+    {
+      uint64_t m_Key;
+      uint64_t m_Count;
+    } Contact_t;
+
+    FaceContactGraph() {}
+
+    virtual ~FaceContactGraph() {}
+
+    /**
+     * @brief PackContact Returns the key of a contact of feature with neighbor
+     */
+    static uint64_t PackContact(int32_t feature, int32_t neighbor)
+    {
+      return (static_cast<uint64_t>(static_cast<uint32_t>(feature)) << 32) | static_cast<uint64_t>(static_cast<uint32_t>(neighbor));
+    }
+
+    /**
+     * @brief SortKeys Sorts contact keys with a least significant digit radix sort, skipping the digits all keys share
+     * @param keys The keys; sorted on return
+     * @param buffer Scratch space, resized as needed so it can be reused between calls
+     */
+    static void SortKeys(std::vector<uint64_t>& keys, std::vector<uint64_t>& buffer)
+    {
+      RadixSort(keys, buffer);
+    }
+
+    /**
+     * @brief CountRuns Collapses sorted keys into one contact per distinct key, counting its occurrences
+     * @param sortedKeys Keys sorted by SortKeys()
+     * @param contacts Filled with the counted contacts, in key order
+     */
+    static void CountRuns(const std::vector<uint64_t>& sortedKeys, std::vector<Contact_t>& contacts)
+    {
+      contacts.clear();
+      size_t numKeys = sortedKeys.size();
+      for (size_t i = 0; i < numKeys;)
+      {
+        size_t runEnd = i + 1;
+        while (runEnd < numKeys && sortedKeys[runEnd] == sortedKeys[i]) { runEnd++; }
+        Contact_t contact = { sortedKeys[i], static_cast<uint64_t>(runEnd - i) };
+        contacts.push_back(contact);
+        i = runEnd;
+      }
+    }
+
+    /**
+     * @brief build Merges the counted contacts of all slabs into the adjacency
+     * @param slabContacts Counted contacts of every slab; released while they are merged
+     * @param numFeatures Number of Features; contacts of Features outside [0, numFeatures) are dropped
+     */
+    void build(std::vector<std::vector<Contact_t> >& slabContacts, size_t numFeatures)
+    {
+      size_t total = 0;
+      size_t numSlabs = slabContacts.size();
+      for (size_t s = 0; s < numSlabs; s++)
+      {
+        total += slabContacts[s].size();
+      }
+      std::vector<Contact_t> contacts;
+      contacts.reserve(total);
+      for (size_t s = 0; s < numSlabs; s++)
+      {
+        contacts.insert(contacts.end(), slabContacts[s].begin(), slabContacts[s].end());
+        std::vector<Contact_t>().swap(slabContacts[s]);
+      }
+      std::vector<Contact_t> buffer;
+      RadixSort(contacts, buffer);
+      std::vector<Contact_t>().swap(buffer);
+
+      m_Offsets.assign(numFeatures + 1, 0);
+      m_Neighbors.clear();
+      m_FaceCounts.clear();
+      size_t numContacts = contacts.size();
+      for (size_t i = 0; i < numContacts;)
+      {
+        uint64_t key = contacts[i].m_Key;
+        uint64_t count = 0;
+        for (; i < numContacts && contacts[i].m_Key == key; i++)
+        {
+          count += contacts[i].m_Count;
+        }
+        size_t feature = static_cast<size_t>(key >> 32);
+        if (feature >= numFeatures) { continue; }
+        m_Offsets[feature + 1]++;
+        m_Neighbors.push_back(static_cast<int32_t>(static_cast<uint32_t>(key & 0xFFFFFFFFULL)));
+        m_FaceCounts.push_back(count);
+      }
+      for (size_t i = 0; i < numFeatures; i++)
+      {
+        m_Offsets[i + 1] += m_Offsets[i];
+      }
+    }
+
+    /**
+     * @brief getNumberOfFeatures Returns the number of rows of the adjacency
+     */
+    size_t getNumberOfFeatures() const { return (m_Offsets.empty() ? 0 : m_Offsets.size() - 1); }
+
+    /**
+     * @brief getNumberOfNeighbors Returns the number of distinct Features in contact with the Feature
+     */
+    size_t getNumberOfNeighbors(size_t feature) const { return static_cast<size_t>(m_Offsets[feature + 1] - m_Offsets[feature]); }
+
+    /**
+     * @brief getNeighbor Returns the n-th neighbor of the Feature, in ascending order of Feature Id
+     */
+    int32_t getNeighbor(size_t feature, size_t n) const { return m_Neighbors[m_Offsets[feature] + n]; }
+
+    /**
+     * @brief getFaceCount Returns the number of faces the Feature shares with its n-th neighbor
+     */
+    uint64_t getFaceCount(size_t feature, size_t n) const { return m_FaceCounts[m_Offsets[feature] + n]; }
+
+  private:
+    std::vector<uint64_t> m_Offsets;
+    std::vector<int32_t> m_Neighbors;
+    std::vector<uint64_t> m_FaceCounts;
+
+    static uint64_t KeyOf(const uint64_t& key) { return key; }
+    static uint64_t KeyOf(const Contact_t& contact) { return contact.m_Key; }
+
+    template<typename T>
+    static void RadixSort(std::vector<T>& items, std::vector<T>& buffer)
+    {
+      size_t numItems = items.size();
+      if (numItems < 2) { return; }
+
+      // the histograms of all eight digits come out of a single pass
+      std::vector<size_t> histograms(8 * 256, 0);
+      for (size_t i = 0; i < numItems; i++)
+      {
+        uint64_t key = KeyOf(items[i]);
+        for (int32_t d = 0; d < 8; d++)
+        {
+          histograms[256 * d + ((key >> (8 * d)) & 0xFF)]++;
+        }
+      }
+
+      buffer.resize(numItems);
+      for (int32_t d = 0; d < 8; d++)
+      {
+        size_t* histogram = &(histograms[256 * d]);
+        if (histogram[(KeyOf(items[0]) >> (8 * d)) & 0xFF] == numItems) { continue; }
+        size_t offset = 0;
+        for (int32_t b = 0; b < 256; b++)
+        {
+          size_t count = histogram[b];
+          histogram[b] = offset;
+          offset += count;
+        }
+        for (size_t i = 0; i < numItems; i++)
+        {
+          buffer[histogram[(KeyOf(items[i]) >> (8 * d)) & 0xFF]++] = items[i];
+        }
+        items.swap(buffer);
+      }
+    }
+
+    FaceContactGraph(const FaceContactGraph&); // Copy Constructor Not Implemented
+    void operator=(const FaceContactGraph&); // Operator '=' Not Implemented
+};
+
+#endif /* _facecontactgraph_hpp_ */
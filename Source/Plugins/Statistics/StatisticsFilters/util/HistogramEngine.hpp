@@ -0,0 +1,552 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#ifndef _histogramengine_hpp_
+#define _histogramengine_hpp_
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
+#include "SIMPLib/SIMPLib.h"
+
+/**
+ * @class HistogramEngine HistogramEngine.hpp Statistics/StatisticsFilters/util/HistogramEngine.hpp
+ * @brief Computes the range and the bin counts of the values of an array in parallel.
+ *
+ * The tuples are split into contiguous chunks. findRange() reduces the minimum and maximum of every chunk in one
+ * pass and combines them, and findCounts() bins every chunk into its own counts, which are added together at the
+ * end, so the results do not depend on the number of chunks. The values that are looked at can be limited to a
+ * range of tuples, a single component and the tuples selected by a mask, and the counts can be split by a group
+ * (e.g. ensemble) id per tuple.
+ *
+ * findQuantileRange() bins the values into a fixed sketch of the float number line instead, which needs no range
+ * up front and merges between chunks, to find a range that excludes outliers.
+ */
+template<typename T>
+class HistogramEngine
+{
+  public:
+    /**
+     * @brief HistogramEngine
+     * @param values The values, numComponents per tuple; must stay valid while the engine is used
+     * @param numTuples Number of tuples
+     * @param numComponents Number of components of each tuple
+     */
+    HistogramEngine(const T* values, size_t numTuples, int32_t numComponents) :
+      m_Values(values),
+      m_NumComponents(std::max(numComponents, 1)),
+      m_TupleStart(0),
+      m_TupleEnd(numTuples),
+      m_Component(-1),
+      m_Mask(NULL),
+      m_MaskValue(true),
+      m_GroupIds(NULL),
+      m_NumGroups(1),
+      m_ClampToFirstBin(false),
+      m_ClampToLastBin(false),
+      m_NumPartials(0)
+    {}
+
+    virtual ~HistogramEngine() {}
+
+    /**
+     * @brief setTupleRange Limits the engine to the tuples in [start, end)
+     */
+    void setTupleRange(size_t start, size_t end)
+    {
+      m_TupleEnd = std::max(start, end);
+      m_TupleStart = start;
+    }
+
+    /**
+     * @brief setComponent Limits the engine to one component of each tuple; -1 uses all of them
+     */
+    void setComponent(int32_t component) { m_Component = (component < m_NumComponents) ? component : -1; }
+
+    /**
+     * @brief setMask Limits the engine to the tuples whose mask value equals maskValue; NULL uses all tuples
+     */
+    void setMask(const bool* mask, bool maskValue)
+    {
+      m_Mask = mask;
+      m_MaskValue = maskValue;
+    }
+
+    /**
+     * @brief setGroups Splits the counts by a group id per tuple; tuples with an id outside [0, numGroups) are not counted
+     */
+    void setGroups(const int32_t* groupIds, int32_t numGroups)
+    {
+      m_GroupIds = groupIds;
+      m_NumGroups = (groupIds == NULL) ? 1 : std::max(numGroups, 0);
+    }
+
+    /**
+     * @brief setClampToFirstBin Counts the values below the range in the first bin instead of dropping them
+     */
+    void setClampToFirstBin(bool clamp) { m_ClampToFirstBin = clamp; }
+
+    /**
+     * @brief setClampToLastBin Counts the values at or above the top of the range in the last bin instead of dropping them
+     */
+    void setClampToLastBin(bool clamp) { m_ClampToLastBin = clamp; }
+
+    /**
+     * @brief setNumberOfPartials Overrides the number of chunks of tuples that are processed separately; 0 lets the engine choose
+     */
+    void setNumberOfPartials(int64_t numPartials) { m_NumPartials = numPartials; }
+
+    /**
+     * @brief findRange Lowers min and raises max to the smallest and largest of the values, compared as floats
+     * @param min Initial minimum on input, the minimum on return
+     * @param max Initial maximum on input, the maximum on return
+     */
+    void findRange(float& min, float& max) const
+    {
+      int64_t numChunks = getNumberOfChunks(0);
+      std::vector<float> mins(numChunks, min);
+      std::vector<float> maxs(numChunks, max);
+      runChunks(numChunks, RangeImpl(this, numChunks, &(mins.front()), &(maxs.front())));
+      for (int64_t c = 0; c < numChunks; c++)
+      {
+        if (maxs[c] > max) { max = maxs[c]; }
+        if (mins[c] < min) { min = mins[c]; }
+      }
+    }
+
+    /**
+     * @brief findCounts Bins the values into numBins bins of width increment starting at min
+     *
+     * A value v falls into bin (v - min) / increment truncated toward zero. Values below the range are dropped
+     * unless clamped to the first bin, as are the values above it unless clamped to the last bin. With a zero
+     * increment the values equal to min fall into the first bin.
+     * @param counts Resized to numGroups * numBins counts, the bins of group g starting at g * numBins
+     */
+    void findCounts(float min, float increment, int32_t numBins, std::vector<uint64_t>& counts) const
+    {
+      numBins = std::max(numBins, 0);
+      size_t countsSize = static_cast<size_t>(m_NumGroups) * static_cast<size_t>(numBins);
+      int64_t numChunks = getNumberOfChunks(countsSize);
+      std::vector<std::vector<uint64_t> > partials(numChunks);
+      runChunks(numChunks, CountImpl(this, numChunks, min, increment, numBins, &(partials.front())));
+
+      counts.swap(partials[0]);
+      for (int64_t c = 1; c < numChunks; c++)
+      {
+        for (size_t b = 0; b < countsSize; b++)
+        {
+          counts[b] += partials[c][b];
+        }
+      }
+    }
+
+    /**
+     * @brief findQuantileRange Finds a range holding the values between two quantiles
+     *
+     * The values are counted in a sketch of the float number line with SketchBins buckets of about 0.8% relative
+     * width, in one pass. The range returned runs from the lower edge of the bucket holding the lower quantile to
+     * the upper edge of the bucket holding the upper quantile, clipped to the smallest and largest value, so it
+     * always contains the values between the two quantiles.
+     * @param lowerQuantile Fraction of the values below the range, in [0, 1]
+     * @param upperQuantile Fraction of the values below the top of the range, in [lowerQuantile, 1]
+     * @return false when there are no values, which leaves min and max untouched
+     */
+    bool findQuantileRange(double lowerQuantile, double upperQuantile, float& min, float& max) const
+    {
+      int64_t numChunks = getNumberOfChunks(SketchBins);
+      std::vector<std::vector<uint64_t> > partials(numChunks);
+      std::vector<float> mins(numChunks, std::numeric_limits<float>::infinity());
+      std::vector<float> maxs(numChunks, -std::numeric_limits<float>::infinity());
+      runChunks(numChunks, SketchImpl(this, numChunks, &(partials.front()), &(mins.front()), &(maxs.front())));
+
+      std::vector<uint64_t>& sketch = partials[0];
+      float valueMin = mins[0];
+      float valueMax = maxs[0];
+      for (int64_t c = 1; c < numChunks; c++)
+      {
+        for (size_t b = 0; b < SketchBins; b++)
+        {
+          sketch[b] += partials[c][b];
+        }
+        valueMin = std::min(valueMin, mins[c]);
+        valueMax = std::max(valueMax, maxs[c]);
+      }
+      uint64_t total = 0;
+      for (size_t b = 0; b < SketchBins; b++)
+      {
+        total += sketch[b];
+      }
+      if (total == 0) { return false; }
+
+      lowerQuantile = std::min(std::max(lowerQuantile, 0.0), 1.0);
+      upperQuantile = std::min(std::max(upperQuantile, lowerQuantile), 1.0);
+      // rank (0 based) of the values at the two quantiles
+      uint64_t lowerRank = static_cast<uint64_t>(lowerQuantile * static_cast<double>(total - 1));
+      uint64_t upperRank = static_cast<uint64_t>(ceil(upperQuantile * static_cast<double>(total - 1)));
+      upperRank = std::min(upperRank, total - 1);
+
+      size_t lowerBucket = 0;
+      size_t upperBucket = 0;
+      uint64_t seen = 0;
+      bool lowerFound = false;
+      for (size_t b = 0; b < SketchBins; b++)
+      {
+        seen += sketch[b];
+        if (lowerFound == false && seen > lowerRank)
+        {
+          lowerBucket = b;
+          lowerFound = true;
+        }
+        if (seen > upperRank)
+        {
+          upperBucket = b;
+          break;
+        }
+      }
+      min = std::max(BucketEdge(static_cast<uint32_t>(lowerBucket) << SketchShift), valueMin);
+      max = std::min(BucketEdge((static_cast<uint32_t>(upperBucket) << SketchShift) | ((1u << SketchShift) - 1)), valueMax);
+      return true;
+    }
+
+    static const uint32_t SketchShift = 16;
+    static const size_t SketchBins = static_cast<size_t>(1) << (32 - SketchShift);
+
+    /**
+     * @brief SketchKey Maps a float to an unsigned key that sorts in the same order as the float
+     */
+    static uint32_t SketchKey(float value)
+    {
+      uint32_t bits = 0;
+      memcpy(&bits, &value, sizeof(bits));
+      return ((bits & 0x80000000u) != 0) ? ~bits : (bits | 0x80000000u);
+    }
+
+    /**
+     * @brief BucketEdge Returns the float a key was made from
+     */
+    static float BucketEdge(uint32_t key)
+    {
+      uint32_t bits = ((key & 0x80000000u) != 0) ? (key & 0x7FFFFFFFu) : ~key;
+      float value = 0.0f;
+      memcpy(&value, &bits, sizeof(value));
+      return value;
+    }
+
+  private:
+    const T* m_Values;
+    int32_t m_NumComponents;
+    size_t m_TupleStart;
+    size_t m_TupleEnd;
+    int32_t m_Component;
+    const bool* m_Mask;
+    bool m_MaskValue;
+    const int32_t* m_GroupIds;
+    int32_t m_NumGroups;
+    bool m_ClampToFirstBin;
+    bool m_ClampToLastBin;
+    int64_t m_NumPartials;
+
+    /**
+     * @brief getNumberOfChunks Returns how many chunks to split the tuples into when every chunk needs partialSize
+     * counts of its own; their memory is kept below that of the values unless overridden
+     */
+    int64_t getNumberOfChunks(size_t partialSize) const
+    {
+      int64_t numTuples = static_cast<int64_t>(m_TupleEnd - m_TupleStart);
+      int64_t numChunks = 1;
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+      numChunks = tbb::task_scheduler_init::default_num_threads();
+      if (partialSize > 0)
+      {
+        int64_t maxChunks = static_cast<int64_t>((numTuples * m_NumComponents * sizeof(T)) / (partialSize * sizeof(uint64_t)));
+        numChunks = std::min(numChunks, std::max(maxChunks, static_cast<int64_t>(1)));
+      }
+#endif
+      if (m_NumPartials > 0) { numChunks = m_NumPartials; }
+      return std::max(std::min(numChunks, numTuples), static_cast<int64_t>(1));
+    }
+
+    /**
+     * @brief runChunks Runs impl over all chunks, in parallel when available
+     */
+    template<typename Impl>
+    void runChunks(int64_t numChunks, const Impl& impl) const
+    {
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+      tbb::task_scheduler_init init;
+      bool doParallel = true;
+      if (doParallel == true && numChunks > 1)
+      {
+        tbb::parallel_for(tbb::blocked_range<int64_t>(0, numChunks, 1), impl, tbb::auto_partitioner());
+      }
+      else
+#endif
+      {
+        impl.run(0, numChunks);
+      }
+    }
+
+    /**
+     * @brief getChunkTuples Returns the first and one past the last tuple of chunk c
+     */
+    void getChunkTuples(int64_t c, int64_t numChunks, size_t& start, size_t& end) const
+    {
+      size_t numTuples = m_TupleEnd - m_TupleStart;
+      start = m_TupleStart + static_cast<size_t>((numTuples * static_cast<size_t>(c)) / static_cast<size_t>(numChunks));
+      end = m_TupleStart + static_cast<size_t>((numTuples * static_cast<size_t>(c + 1)) / static_cast<size_t>(numChunks));
+    }
+
+    /**
+     * @brief getComponents Returns the first and one past the last component looked at
+     */
+    void getComponents(int32_t& start, int32_t& end) const
+    {
+      start = (m_Component < 0) ? 0 : m_Component;
+      end = (m_Component < 0) ? m_NumComponents : m_Component + 1;
+    }
+
+    void rangeOfChunk(int64_t c, int64_t numChunks, float& min, float& max) const
+    {
+      size_t start = 0, end = 0;
+      int32_t compStart = 0, compEnd = 0;
+      getChunkTuples(c, numChunks, start, end);
+      getComponents(compStart, compEnd);
+      for (size_t t = start; t < end; t++)
+      {
+        if (m_Mask != NULL && m_Mask[t] != m_MaskValue) { continue; }
+        const T* tuple = m_Values + (t * m_NumComponents);
+        for (int32_t k = compStart; k < compEnd; k++)
+        {
+          float value = static_cast<float>(tuple[k]);
+          if (value > max) { max = value; }
+          if (value < min) { min = value; }
+        }
+      }
+    }
+
+    void countChunk(int64_t c, int64_t numChunks, float min, float increment, int32_t numBins, std::vector<uint64_t>& counts) const
+    {
+      counts.assign(static_cast<size_t>(m_NumGroups) * static_cast<size_t>(numBins), 0);
+      if (counts.empty() == true) { return; }
+      size_t start = 0, end = 0;
+      int32_t compStart = 0, compEnd = 0;
+      getChunkTuples(c, numChunks, start, end);
+      getComponents(compStart, compEnd);
+      for (size_t t = start; t < end; t++)
+      {
+        if (m_Mask != NULL && m_Mask[t] != m_MaskValue) { continue; }
+        uint64_t* groupCounts = &(counts.front());
+        if (m_GroupIds != NULL)
+        {
+          int32_t group = m_GroupIds[t];
+          if (group < 0 || group >= m_NumGroups) { continue; }
+          groupCounts += static_cast<size_t>(group) * static_cast<size_t>(numBins);
+        }
+        const T* tuple = m_Values + (t * m_NumComponents);
+        for (int32_t k = compStart; k < compEnd; k++)
+        {
+          // same arithmetic as binning the values directly, so the bins match for every value type
+          double bin = 0.0;
+          if (increment != 0.0f) { bin = (tuple[k] - min) / increment; }
+          else if (tuple[k] - min != 0) { bin = (tuple[k] - min > 0) ? std::numeric_limits<double>::infinity() : -1.0; }
+          if (bin >= numBins)
+          {
+            if (m_ClampToLastBin == true) { groupCounts[numBins - 1]++; }
+          }
+          else if (bin >= 0.0)
+          {
+            groupCounts[static_cast<int32_t>(bin)]++;
+          }
+          else if (bin < 0.0)
+          {
+            if (m_ClampToFirstBin == true) { groupCounts[0]++; }
+          }
+        }
+      }
+    }
+
+    void sketchChunk(int64_t c, int64_t numChunks, std::vector<uint64_t>& sketch, float& min, float& max) const
+    {
+      sketch.assign(SketchBins, 0);
+      size_t start = 0, end = 0;
+      int32_t compStart = 0, compEnd = 0;
+      getChunkTuples(c, numChunks, start, end);
+      getComponents(compStart, compEnd);
+      for (size_t t = start; t < end; t++)
+      {
+        if (m_Mask != NULL && m_Mask[t] != m_MaskValue) { continue; }
+        const T* tuple = m_Values + (t * m_NumComponents);
+        for (int32_t k = compStart; k < compEnd; k++)
+        {
+          float value = static_cast<float>(tuple[k]);
+          if (value != value) { continue; }
+          sketch[SketchKey(value) >> SketchShift]++;
+          if (value > max) { max = value; }
+          if (value < min) { min = value; }
+        }
+      }
+    }
+
+    /**
+     * @brief Finds the range of each chunk of tuples
+     */
+    class RangeImpl
+    {
+        const HistogramEngine* m_Engine;
+        int64_t m_NumChunks;
+        float* m_Mins;
+        float* m_Maxs;
+
+      public:
+        RangeImpl(const HistogramEngine* engine, int64_t numChunks, float* mins, float* maxs) :
+          m_Engine(engine),
+          m_NumChunks(numChunks),
+          m_Mins(mins),
+          m_Maxs(maxs)
+        {}
+
+        virtual ~RangeImpl() {}
+
+        void run(int64_t start, int64_t end) const
+        {
+          for (int64_t c = start; c < end; c++)
+          {
+            m_Engine->rangeOfChunk(c, m_NumChunks, m_Mins[c], m_Maxs[c]);
+          }
+        }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+        void operator()(const tbb::blocked_range<int64_t>& r) const
+        {
+          run(r.begin(), r.end());
+        }
+#endif
+    };
+
+    /**
+     * @brief Bins each chunk of tuples into its own counts
+     */
+    class CountImpl
+    {
+        const HistogramEngine* m_Engine;
+        int64_t m_NumChunks;
+        float m_Min;
+        float m_Increment;
+        int32_t m_NumBins;
+        std::vector<uint64_t>* m_Partials;
+
+      public:
+        CountImpl(const HistogramEngine* engine, int64_t numChunks, float min, float increment, int32_t numBins, std::vector<uint64_t>* partials) :
+          m_Engine(engine),
+          m_NumChunks(numChunks),
+          m_Min(min),
+          m_Increment(increment),
+          m_NumBins(numBins),
+          m_Partials(partials)
+        {}
+
+        virtual ~CountImpl() {}
+
+        void run(int64_t start, int64_t end) const
+        {
+          for (int64_t c = start; c < end; c++)
+          {
+            m_Engine->countChunk(c, m_NumChunks, m_Min, m_Increment, m_NumBins, m_Partials[c]);
+          }
+        }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+        void operator()(const tbb::blocked_range<int64_t>& r) const
+        {
+          run(r.begin(), r.end());
+        }
+#endif
+    };
+
+    /**
+     * @brief Counts each chunk of tuples into its own quantile sketch
+     */
+    class SketchImpl
+    {
+        const HistogramEngine* m_Engine;
+        int64_t m_NumChunks;
+        std::vector<uint64_t>* m_Partials;
+        float* m_Mins;
+        float* m_Maxs;
+
+      public:
+        SketchImpl(const HistogramEngine* engine, int64_t numChunks, std::vector<uint64_t>* partials, float* mins, float* maxs) :
+          m_Engine(engine),
+          m_NumChunks(numChunks),
+          m_Partials(partials),
+          m_Mins(mins),
+          m_Maxs(maxs)
+        {}
+
+        virtual ~SketchImpl() {}
+
+        void run(int64_t start, int64_t end) const
+        {
+          for (int64_t c = start; c < end; c++)
+          {
+            m_Engine->sketchChunk(c, m_NumChunks, m_Partials[c], m_Mins[c], m_Maxs[c]);
+          }
+        }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+        void operator()(const tbb::blocked_range<int64_t>& r) const
+        {
+          run(r.begin(), r.end());
+        }
+#endif
+    };
+
+    HistogramEngine(const HistogramEngine&); // Copy Constructor Not Implemented
+    void operator=(const HistogramEngine&); // Operator '=' Not Implemented
+};
+
+#endif /* _histogramengine_hpp_ */
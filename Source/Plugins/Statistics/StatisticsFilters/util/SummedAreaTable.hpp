@@ -0,0 +1,258 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#ifndef _summedareatable_hpp_
+#define _summedareatable_hpp_
+
+#include <algorithm>
+#include <vector>
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
+#include "SIMPLib/SIMPLib.h"
+
+/**
+ * @class SummedAreaTable SummedAreaTable.hpp Statistics/StatisticsFilters/util/SummedAreaTable.hpp
+ * @brief Holds the 3D summed-area table (integral image) of a scalar cell array of an image geometry, so the sum
+ * of the cells in any box costs eight lookups regardless of the size of the box.
+ *
+ * Entry (x, y, z) holds, in double precision, the sum of the cells with all three indices below (x, y, z); the
+ * table has one more entry than the volume along every axis so the lower faces are zero. It is built in three
+ * passes of running sums, along x, then y, then z, each of which is parallel over the lines it accumulates. The
+ * table may cover only a range of z slices, since it takes 8 bytes per cell of that range.
+ */
+class SummedAreaTable
+{
+  public:
+    SummedAreaTable() :
+      m_ZStart(0)
+    {
+      for (int32_t d = 0; d < 3; d++)
+      {
+        m_Dims[d] = 0;
+      }
+    }
+
+    virtual ~SummedAreaTable() {}
+
+    /**
+     * @brief initialize Builds the table of the slices [zStart, zEnd) of the array
+     * @param data One value per cell, x fastest
+     * @param dims Number of cells along x, y and z
+     * @param zStart First slice covered by the table
+     * @param zEnd One past the last slice covered by the table
+     */
+    template<typename T>
+    void initialize(const T* data, const int64_t dims[3], int64_t zStart, int64_t zEnd)
+    {
+      zStart = std::max(zStart, static_cast<int64_t>(0));
+      zEnd = std::max(std::min(zEnd, dims[2]), zStart);
+      m_Dims[0] = dims[0];
+      m_Dims[1] = dims[1];
+      m_Dims[2] = zEnd - zStart;
+      m_ZStart = zStart;
+
+      const int64_t rowLength = m_Dims[0] + 1;
+      const int64_t planeSize = rowLength * (m_Dims[1] + 1);
+      m_Table.assign(planeSize * (m_Dims[2] + 1), 0.0);
+      if (m_Dims[0] == 0 || m_Dims[1] == 0 || m_Dims[2] == 0) { return; }
+
+      const T* slab = data + zStart * m_Dims[0] * m_Dims[1];
+      int64_t numRows = m_Dims[1] * m_Dims[2];
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+      tbb::task_scheduler_init init;
+      bool doParallel = true;
+      if (doParallel == true)
+      {
+        tbb::parallel_for(tbb::blocked_range<int64_t>(0, numRows), RowSumsImpl<T>(slab, m_Dims, &(m_Table.front())), tbb::auto_partitioner());
+        // along y the lines are the rows of a plane, along z they are the rows with the same y in consecutive planes
+        tbb::parallel_for(tbb::blocked_range<int64_t>(1, m_Dims[2] + 1), AccumulateRowsImpl(&(m_Table.front()), rowLength, planeSize, rowLength, m_Dims[1] + 1), tbb::auto_partitioner());
+        tbb::parallel_for(tbb::blocked_range<int64_t>(1, m_Dims[1] + 1), AccumulateRowsImpl(&(m_Table.front()), rowLength, rowLength, planeSize, m_Dims[2] + 1), tbb::auto_partitioner());
+      }
+      else
+#endif
+      {
+        RowSumsImpl<T> rowSums(slab, m_Dims, &(m_Table.front()));
+        rowSums.sum(0, numRows);
+        AccumulateRowsImpl alongY(&(m_Table.front()), rowLength, planeSize, rowLength, m_Dims[1] + 1);
+        alongY.accumulate(1, m_Dims[2] + 1);
+        AccumulateRowsImpl alongZ(&(m_Table.front()), rowLength, rowLength, planeSize, m_Dims[2] + 1);
+        alongZ.accumulate(1, m_Dims[1] + 1);
+      }
+    }
+
+    /**
+     * @brief getBoxSum Returns the sum of the cells in the box [low, high), clipped to the cells covered by the table
+     * @param low Lowest cell of the box along x, y and z, in cells of the whole volume
+     * @param high One past the highest cell of the box along x, y and z
+     * @param count Receives the number of cells summed once the box is clipped
+     */
+    double getBoxSum(const int64_t low[3], const int64_t high[3], int64_t& count) const
+    {
+      int64_t lo[3] = { low[0], low[1], low[2] - m_ZStart };
+      int64_t hi[3] = { high[0], high[1], high[2] - m_ZStart };
+      count = 1;
+      for (int32_t d = 0; d < 3; d++)
+      {
+        lo[d] = std::max(lo[d], static_cast<int64_t>(0));
+        hi[d] = std::min(hi[d], m_Dims[d]);
+        if (hi[d] <= lo[d])
+        {
+          count = 0;
+          return 0.0;
+        }
+        count *= hi[d] - lo[d];
+      }
+
+      const int64_t rowLength = m_Dims[0] + 1;
+      const int64_t planeSize = rowLength * (m_Dims[1] + 1);
+      const double* table = &(m_Table.front());
+      int64_t zLo = lo[2] * planeSize;
+      int64_t zHi = hi[2] * planeSize;
+      int64_t yLo = lo[1] * rowLength;
+      int64_t yHi = hi[1] * rowLength;
+      double upper = table[zHi + yHi + hi[0]] - table[zHi + yHi + lo[0]] - table[zHi + yLo + hi[0]] + table[zHi + yLo + lo[0]];
+      double lower = table[zLo + yHi + hi[0]] - table[zLo + yHi + lo[0]] - table[zLo + yLo + hi[0]] + table[zLo + yLo + lo[0]];
+      return upper - lower;
+    }
+
+  private:
+    int64_t m_Dims[3];
+    int64_t m_ZStart;
+    std::vector<double> m_Table;
+
+    /**
+     * @brief Writes the running sums along x of a range of rows of the cells into the table
+     */
+    template<typename T>
+    class RowSumsImpl
+    {
+        const T* m_Data;
+        int64_t m_XPoints;
+        int64_t m_YPoints;
+        double* m_Table;
+
+      public:
+        RowSumsImpl(const T* data, const int64_t dims[3], double* table) :
+          m_Data(data),
+          m_XPoints(dims[0]),
+          m_YPoints(dims[1]),
+          m_Table(table)
+        {}
+
+        virtual ~RowSumsImpl() {}
+
+        void sum(int64_t start, int64_t end) const
+        {
+          for (int64_t row = start; row < end; row++)
+          {
+            int64_t z = row / m_YPoints;
+            int64_t y = row - z * m_YPoints;
+            const T* cells = m_Data + row * m_XPoints;
+            double* entries = m_Table + ((z + 1) * (m_YPoints + 1) + (y + 1)) * (m_XPoints + 1) + 1;
+            double runningSum = 0.0;
+            for (int64_t x = 0; x < m_XPoints; x++)
+            {
+              runningSum += static_cast<double>(cells[x]);
+              entries[x] = runningSum;
+            }
+          }
+        }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+        void operator()(const tbb::blocked_range<int64_t>& r) const
+        {
+          sum(r.begin(), r.end());
+        }
+#endif
+    };
+
+    /**
+     * @brief Adds every table row of a line to the next one, for a range of independent lines of rows
+     */
+    class AccumulateRowsImpl
+    {
+        double* m_Table;
+        int64_t m_RowLength;
+        int64_t m_LineStride;
+        int64_t m_RowStride;
+        int64_t m_RowsPerLine;
+
+      public:
+        AccumulateRowsImpl(double* table, int64_t rowLength, int64_t lineStride, int64_t rowStride, int64_t rowsPerLine) :
+          m_Table(table),
+          m_RowLength(rowLength),
+          m_LineStride(lineStride),
+          m_RowStride(rowStride),
+          m_RowsPerLine(rowsPerLine)
+        {}
+
+        virtual ~AccumulateRowsImpl() {}
+
+        void accumulate(int64_t start, int64_t end) const
+        {
+          for (int64_t line = start; line < end; line++)
+          {
+            double* previous = m_Table + line * m_LineStride;
+            for (int64_t r = 1; r < m_RowsPerLine; r++)
+            {
+              double* current = previous + m_RowStride;
+              for (int64_t x = 0; x < m_RowLength; x++)
+              {
+                current[x] += previous[x];
+              }
+              previous = current;
+            }
+          }
+        }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+        void operator()(const tbb::blocked_range<int64_t>& r) const
+        {
+          accumulate(r.begin(), r.end());
+        }
+#endif
+    };
+
+    SummedAreaTable(const SummedAreaTable&); // Copy Constructor Not Implemented
+    void operator=(const SummedAreaTable&); // Operator '=' Not Implemented
+};
+
+#endif /* _summedareatable_hpp_ */
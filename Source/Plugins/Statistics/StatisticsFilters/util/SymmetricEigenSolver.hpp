@@ -0,0 +1,301 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#ifndef _symmetriceigensolver_hpp_
+#define _symmetriceigensolver_hpp_
+
+#include <math.h>
+
+#include <algorithm>
+
+#include "SIMPLib/SIMPLib.h"
+
+/**
+ * @class SymmetricEigenSolver SymmetricEigenSolver.hpp Statistics/StatisticsFilters/util/SymmetricEigenSolver.hpp
+ * @brief Closed form eigen decomposition of 3x3 real symmetric matrices, such as the second order moments of Features.
+ *
+ * A matrix is given by its 6 distinct entries in the order xx, yy, zz, xy, yz, xz, the layout of the Feature
+ * moments of FindShapes. The eigenvalues are the roots of the characteristic cubic, found with the trigonometric
+ * solution of Smith (1961) on the matrix shifted by its mean eigenvalue and scaled by its largest entry. The
+ * eigenvector of the eigenvalue farthest from the other two is the normalized largest cross product of two rows
+ * of the matrix minus that eigenvalue; the second one is solved for in the plane orthogonal to it, and the third
+ * one completes the right-handed frame. Neither step iterates or pivots, so repeated eigenvalues and diagonal
+ * matrices are handled exactly, and every matrix costs the same.
+ *
+ * SolveBatch() runs the eigenvalue step over blocks of BatchSize matrices at a time, one entry per array, so that
+ * the compiler can vectorize it across matrices.
+ */
+class SymmetricEigenSolver
+{
+  public:
+    static const size_t BatchSize = 16;
+
+    /**
+     * @brief Solve Computes the eigenvalues and eigenvectors of one matrix
+     * @param matrix The entries xx, yy, zz, xy, yz, xz
+     * @param values The eigenvalues, largest first
+     * @param vectors The unit eigenvectors, 3 per eigenvalue in the same order; each is oriented so that the sum of
+     * its components is not negative
+     */
+    static void Solve(const double matrix[6], double values[3], double vectors[9])
+    {
+      SolveBatch(matrix, 1, values, vectors);
+    }
+
+    /**
+     * @brief SolveBatch Computes the eigenvalues and eigenvectors of count matrices stored one after the other
+     * @param matrices 6 entries per matrix
+     * @param count Number of matrices
+     * @param values 3 eigenvalues per matrix, largest first
+     * @param vectors 9 eigenvector components per matrix, may be NULL when only the eigenvalues are needed
+     */
+    static void SolveBatch(const double* matrices, size_t count, double* values, double* vectors)
+    {
+      double scale[BatchSize];
+      double mean[BatchSize];
+      double deviation[BatchSize];
+      double halfDet[BatchSize];
+      for (size_t start = 0; start < count; start += BatchSize)
+      {
+        size_t num = (count - start < BatchSize) ? count - start : static_cast<size_t>(BatchSize);
+        const double* block = matrices + 6 * start;
+
+        // eigenvalues of the scaled matrices, one loop per step over the whole block
+        for (size_t n = 0; n < num; n++)
+        {
+          const double* a = block + 6 * n;
+          double maxAbs = std::max(std::max(std::max(fabs(a[0]), fabs(a[1])), std::max(fabs(a[2]), fabs(a[3]))), std::max(fabs(a[4]), fabs(a[5])));
+          scale[n] = maxAbs;
+        }
+        for (size_t n = 0; n < num; n++)
+        {
+          const double* a = block + 6 * n;
+          double inv = (scale[n] > 0.0) ? 1.0 / scale[n] : 0.0;
+          double a00 = a[0] * inv, a11 = a[1] * inv, a22 = a[2] * inv;
+          double a01 = a[3] * inv, a12 = a[4] * inv, a02 = a[5] * inv;
+          double q = (a00 + a11 + a22) / 3.0;
+          double b00 = a00 - q, b11 = a11 - q, b22 = a22 - q;
+          double p = sqrt((b00 * b00 + b11 * b11 + b22 * b22 + 2.0 * (a01 * a01 + a02 * a02 + a12 * a12)) / 6.0);
+          double c00 = b11 * b22 - a12 * a12;
+          double c01 = a01 * b22 - a12 * a02;
+          double c02 = a01 * a12 - b11 * a02;
+          double invP = (p > 0.0) ? 1.0 / p : 0.0;
+          double det = (b00 * c00 - a01 * c01 + a02 * c02) * invP * invP * invP;
+          mean[n] = q;
+          deviation[n] = p;
+          halfDet[n] = std::min(std::max(0.5 * det, -1.0), 1.0);
+        }
+        for (size_t n = 0; n < num; n++)
+        {
+          double angle = acos(halfDet[n]) / 3.0;
+          double beta2 = 2.0 * cos(angle);
+          double beta0 = 2.0 * cos(angle + (2.0 * M_PI / 3.0));
+          // the roots sum to zero; keep the middle one between the others when rounding would push it outside
+          double beta1 = std::min(std::max(-(beta0 + beta2), beta0), beta2);
+          double* v = values + 3 * (start + n);
+          v[0] = (mean[n] + deviation[n] * beta2) * scale[n];
+          v[1] = (mean[n] + deviation[n] * beta1) * scale[n];
+          v[2] = (mean[n] + deviation[n] * beta0) * scale[n];
+        }
+
+        if (NULL == vectors) { continue; }
+        for (size_t n = 0; n < num; n++)
+        {
+          size_t index = start + n;
+          double inv = (scale[n] > 0.0) ? 1.0 / scale[n] : 0.0;
+          double a[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+          for (size_t k = 0; k < 6; k++)
+          {
+            a[k] = block[6 * n + k] * inv;
+          }
+          double eval[3] = { values[3 * index] * inv, values[3 * index + 1] * inv, values[3 * index + 2] * inv };
+          double* evec = vectors + 9 * index;
+          // the eigenvalue farthest from the others is the largest one when the cubic's half determinant is positive
+          if (halfDet[n] >= 0.0)
+          {
+            EigenVector0(a, eval[0], evec);
+            EigenVector1(a, evec, eval[1], evec + 3);
+            Cross(evec, evec + 3, evec + 6);
+          }
+          else
+          {
+            EigenVector0(a, eval[2], evec + 6);
+            EigenVector1(a, evec + 6, eval[1], evec + 3);
+            Cross(evec + 3, evec + 6, evec);
+          }
+          for (size_t k = 0; k < 3; k++)
+          {
+            double* e = evec + 3 * k;
+            if (e[0] + e[1] + e[2] < 0.0)
+            {
+              e[0] = -e[0];
+              e[1] = -e[1];
+              e[2] = -e[2];
+            }
+          }
+        }
+      }
+    }
+
+  protected:
+    SymmetricEigenSolver() {}
+
+    /**
+     * @brief Cross Computes w = u x v
+     */
+    static void Cross(const double u[3], const double v[3], double w[3])
+    {
+      w[0] = u[1] * v[2] - u[2] * v[1];
+      w[1] = u[2] * v[0] - u[0] * v[2];
+      w[2] = u[0] * v[1] - u[1] * v[0];
+    }
+
+    /**
+     * @brief EigenVector0 Computes the eigenvector of an eigenvalue that is not repeated, from the largest cross
+     * product of two rows of the matrix minus the eigenvalue
+     */
+    static void EigenVector0(const double a[6], double eval, double evec[3])
+    {
+      double row0[3] = { a[0] - eval, a[3], a[5] };
+      double row1[3] = { a[3], a[1] - eval, a[4] };
+      double row2[3] = { a[5], a[4], a[2] - eval };
+      double r0xr1[3], r0xr2[3], r1xr2[3];
+      Cross(row0, row1, r0xr1);
+      Cross(row0, row2, r0xr2);
+      Cross(row1, row2, r1xr2);
+      double d0 = r0xr1[0] * r0xr1[0] + r0xr1[1] * r0xr1[1] + r0xr1[2] * r0xr1[2];
+      double d1 = r0xr2[0] * r0xr2[0] + r0xr2[1] * r0xr2[1] + r0xr2[2] * r0xr2[2];
+      double d2 = r1xr2[0] * r1xr2[0] + r1xr2[1] * r1xr2[1] + r1xr2[2] * r1xr2[2];
+      const double* best = r0xr1;
+      double dmax = d0;
+      if (d1 > dmax) { best = r0xr2; dmax = d1; }
+      if (d2 > dmax) { best = r1xr2; dmax = d2; }
+      if (dmax > 0.0)
+      {
+        double inv = 1.0 / sqrt(dmax);
+        evec[0] = best[0] * inv;
+        evec[1] = best[1] * inv;
+        evec[2] = best[2] * inv;
+      }
+      else
+      {
+        // the matrix is a multiple of the identity, so every direction is an eigenvector
+        evec[0] = 1.0;
+        evec[1] = 0.0;
+        evec[2] = 0.0;
+      }
+    }
+
+    /**
+     * @brief EigenVector1 Computes the eigenvector of eval orthogonal to the unit eigenvector evec0 by solving the
+     * 2x2 problem in the plane orthogonal to evec0
+     */
+    static void EigenVector1(const double a[6], const double evec0[3], double eval, double evec1[3])
+    {
+      double u[3], v[3];
+      if (fabs(evec0[0]) > fabs(evec0[1]))
+      {
+        double inv = 1.0 / sqrt(evec0[0] * evec0[0] + evec0[2] * evec0[2]);
+        u[0] = -evec0[2] * inv;
+        u[1] = 0.0;
+        u[2] = evec0[0] * inv;
+      }
+      else
+      {
+        double inv = 1.0 / sqrt(evec0[1] * evec0[1] + evec0[2] * evec0[2]);
+        u[0] = 0.0;
+        u[1] = evec0[2] * inv;
+        u[2] = -evec0[1] * inv;
+      }
+      Cross(evec0, u, v);
+
+      double au[3] = { a[0] * u[0] + a[3] * u[1] + a[5] * u[2], a[3] * u[0] + a[1] * u[1] + a[4] * u[2], a[5] * u[0] + a[4] * u[1] + a[2] * u[2] };
+      double av[3] = { a[0] * v[0] + a[3] * v[1] + a[5] * v[2], a[3] * v[0] + a[1] * v[1] + a[4] * v[2], a[5] * v[0] + a[4] * v[1] + a[2] * v[2] };
+      double m00 = u[0] * au[0] + u[1] * au[1] + u[2] * au[2] - eval;
+      double m01 = u[0] * av[0] + u[1] * av[1] + u[2] * av[2];
+      double m11 = v[0] * av[0] + v[1] * av[1] + v[2] * av[2] - eval;
+      double absM00 = fabs(m00), absM01 = fabs(m01), absM11 = fabs(m11);
+
+      // the solution of [m00 m01; m01 m11] (s, t) = 0, normalized, gives evec1 = s u + t v
+      double s = 1.0, t = 0.0;
+      if (absM00 >= absM11)
+      {
+        if (std::max(absM00, absM01) > 0.0)
+        {
+          if (absM00 >= absM01)
+          {
+            m01 /= m00;
+            m00 = 1.0 / sqrt(1.0 + m01 * m01);
+            m01 *= m00;
+          }
+          else
+          {
+            m00 /= m01;
+            m01 = 1.0 / sqrt(1.0 + m00 * m00);
+            m00 *= m01;
+          }
+          s = m01;
+          t = -m00;
+        }
+      }
+      else
+      {
+        if (absM11 >= absM01)
+        {
+          m01 /= m11;
+          m11 = 1.0 / sqrt(1.0 + m01 * m01);
+          m01 *= m11;
+        }
+        else
+        {
+          m11 /= m01;
+          m01 = 1.0 / sqrt(1.0 + m11 * m11);
+          m11 *= m01;
+        }
+        s = m11;
+        t = -m01;
+      }
+      evec1[0] = s * u[0] + t * v[0];
+      evec1[1] = s * u[1] + t * v[1];
+      evec1[2] = s * u[2] + t * v[2];
+    }
+
+  private:
+    SymmetricEigenSolver(const SymmetricEigenSolver&); // Copy Constructor Not Implemented
+    void operator=(const SymmetricEigenSolver&); // Operator '=' Not Implemented
+};
+
+#endif /* _symmetriceigensolver_hpp_ */
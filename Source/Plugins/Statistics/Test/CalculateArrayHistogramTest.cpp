@@ -509,6 +509,81 @@ void TestFaithful()
 
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void TestExcludeOutliers()
+{
+  DataContainerArray::Pointer dca = DataContainerArray::New();
+  DataContainer::Pointer dc = DataContainer::New(DCName);
+
+  QVector<size_t> tDims(1, Faithful_Rows);
+  QVector<size_t> cDims(1, 1);
+  AttributeMatrix::Pointer am = AttributeMatrix::New(tDims, Data_AMName, SIMPL::AttributeMatrixType::Cell);
+  DoubleArrayType::Pointer duration = DoubleArrayType::CreateArray(tDims, cDims, Duration_Name);
+  for (size_t i = 0; i < tDims[0]; i++)
+  {
+    duration->setComponent(i, 0, faithful[i][1]);
+  }
+  // two far outliers that would otherwise put almost every value into the first bin
+  duration->setComponent(0, 0, 1000.0);
+  duration->setComponent(1, 0, -500.0);
+  am->addAttributeArray(duration->getName(), duration);
+  dc->addAttributeMatrix(am->getName(), am);
+  dca->addDataContainer(dc);
+
+  QString filtName = "CalculateArrayHistogram";
+  FilterManager* fm = FilterManager::Instance();
+  IFilterFactory::Pointer filterFactory = fm->getFactoryForFilter(filtName);
+  DREAM3D_REQUIRE_VALID_POINTER(filterFactory.get())
+
+  AbstractFilter::Pointer filter = filterFactory->create();
+  filter->setDataContainerArray(dca);
+
+  QVariant var;
+  var.setValue(DataArrayPath(dc->getName(), am->getName(), duration->getName()));
+  DREAM3D_REQUIRE_EQUAL(filter->setProperty("SelectedArrayPath", var), true)
+  var.setValue(HistogramBins);
+  DREAM3D_REQUIRE_EQUAL(filter->setProperty("NumberOfBins", var), true)
+  var.setValue(false);
+  DREAM3D_REQUIRE_EQUAL(filter->setProperty("UserDefinedRange", var), true)
+  var.setValue(true);
+  DREAM3D_REQUIRE_EQUAL(filter->setProperty("ExcludeOutliers", var), true)
+  QVariant qv(Hist_AMName);
+  DREAM3D_REQUIRE_EQUAL(filter->setProperty("NewAttributeMatrixName", qv), true)
+  QVariant qv1(DurationHistogram_Name);
+  DREAM3D_REQUIRE_EQUAL(filter->setProperty("NewDataArrayName", qv1), true)
+
+  // the fraction has to leave a range between the two quantiles
+  var.setValue(0.5);
+  DREAM3D_REQUIRE_EQUAL(filter->setProperty("OutlierFraction", var), true)
+  filter->preflight();
+  DREAM3D_REQUIRE_EQUAL(filter->getErrorCondition(), -11012)
+
+  var.setValue(0.01);
+  DREAM3D_REQUIRE_EQUAL(filter->setProperty("OutlierFraction", var), true)
+  filter->execute();
+  DREAM3D_REQUIRED(filter->getErrorCondition(), >= , 0);
+
+  DataArrayPath path(DCName, Hist_AMName, DurationHistogram_Name);
+  cDims[0] = 2;
+  IDataArray::Pointer histArray = dca->getPrereqArrayFromPath<DoubleArrayType, AbstractFilter>(filter.get(), path, cDims);
+  DoubleArrayType::Pointer histPtr = std::dynamic_pointer_cast<DoubleArrayType>(histArray);
+  DREAM3D_REQUIRE_VALID_POINTER(histPtr.get())
+
+  // the bins span the regular durations only, and the outliers are not counted
+  double lastEdge = histPtr->getComponent(HistogramBins - 1, 0);
+  double firstEdge = histPtr->getComponent(0, 0);
+  DREAM3D_REQUIRE(lastEdge > 4.8 && lastEdge < 5.5)
+  DREAM3D_REQUIRE(firstEdge > 1.6 && firstEdge < 2.5)
+  double total = 0.0;
+  for (int32_t r = 0; r < HistogramBins; r++)
+  {
+    total += histPtr->getComponent(r, 1);
+  }
+  DREAM3D_REQUIRE(total > 0.9 * Faithful_Rows && total <= Faithful_Rows - 2)
+}
+
 /**
   * @brief
 */
@@ -518,6 +593,7 @@ void operator()()
   DREAM3D_REGISTER_TEST( TestFilterAvailability() );
   //DREAM3D_REGISTER_TEST( CalculateArrayHistogramTest() )
   DREAM3D_REGISTER_TEST( TestFaithful() )
+  DREAM3D_REGISTER_TEST( TestExcludeOutliers() )
 }
 private:
 CalculateArrayHistogramTest(const CalculateArrayHistogramTest&); // Copy Constructor Not Implemented
@@ -0,0 +1,163 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <stdlib.h>
+
+#include <vector>
+
+#include "Statistics/StatisticsFilters/util/CentroidBinGrid.hpp"
+
+class CentroidBinGridTest
+{
+  public:
+    CentroidBinGridTest(){}
+    virtual ~CentroidBinGridTest(){}
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    uint32_t NextRandom(uint32_t& state)
+    {
+      state = state * 1664525u + 1013904223u;
+      return state >> 8;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Compares every query with checking all Features against each other, the way FindNeighborhoods used to
+    // -----------------------------------------------------------------------------
+    void CompareWithAllPairs(const std::vector<int64_t>& bins, const std::vector<float>& criticalDistance)
+    {
+      size_t numFeatures = criticalDistance.size();
+      CentroidBinGrid grid;
+      grid.initialize(&(bins.front()), numFeatures, 1);
+      DREAM3D_REQUIRE(grid.getNumberOfCells() <= 8 * numFeatures + 64)
+
+      std::vector<int32_t> neighbors;
+      std::vector<int32_t> expected;
+      for (size_t i = 1; i < numFeatures; i++)
+      {
+        expected.clear();
+        for (size_t j = 1; j < numFeatures; j++)
+        {
+          if (j == i) { continue; }
+          float dBinX = static_cast<float>(llabs(bins[3 * j] - bins[3 * i]));
+          float dBinY = static_cast<float>(llabs(bins[3 * j + 1] - bins[3 * i + 1]));
+          float dBinZ = static_cast<float>(llabs(bins[3 * j + 2] - bins[3 * i + 2]));
+          if (dBinX < criticalDistance[i] && dBinY < criticalDistance[i] && dBinZ < criticalDistance[i]) { expected.push_back(static_cast<int32_t>(j)); }
+        }
+        grid.findWithinBins(i, criticalDistance[i], neighbors);
+        DREAM3D_REQUIRE(neighbors == expected)
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestDenseBins()
+    {
+      uint32_t state = 5;
+      size_t numFeatures = 1500;
+      std::vector<int64_t> bins(3 * numFeatures, 0);
+      std::vector<float> criticalDistance(numFeatures, 0.0f);
+      for (size_t i = 1; i < numFeatures; i++)
+      {
+        for (size_t d = 0; d < 3; d++)
+        {
+          bins[3 * i + d] = static_cast<int64_t>(NextRandom(state) % 25) - 3;
+        }
+        // whole and fractional critical distances, a few large ones and a few that find nothing
+        criticalDistance[i] = static_cast<float>(NextRandom(state) % 40) / 8.0f;
+        if (i % 97 == 0) { criticalDistance[i] = 30.0f; }
+      }
+      CompareWithAllPairs(bins, criticalDistance);
+    }
+
+    // -----------------------------------------------------------------------------
+    // Bins spread so thinly that the cells have to be coarsened
+    // -----------------------------------------------------------------------------
+    void TestSparseBins()
+    {
+      uint32_t state = 11;
+      size_t numFeatures = 400;
+      std::vector<int64_t> bins(3 * numFeatures, 0);
+      std::vector<float> criticalDistance(numFeatures, 0.0f);
+      for (size_t i = 1; i < numFeatures; i++)
+      {
+        for (size_t d = 0; d < 3; d++)
+        {
+          bins[3 * i + d] = static_cast<int64_t>(NextRandom(state) % 5000);
+        }
+        criticalDistance[i] = static_cast<float>(NextRandom(state) % 4000) / 4.0f;
+      }
+      CompareWithAllPairs(bins, criticalDistance);
+
+      CentroidBinGrid grid;
+      grid.initialize(&(bins.front()), numFeatures, 1);
+      DREAM3D_REQUIRE(grid.getCellSize() > 1)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestFewFeatures()
+    {
+      std::vector<int64_t> bins(6, 0);
+      std::vector<float> criticalDistance(2, 3.0f);
+      CentroidBinGrid grid;
+      grid.initialize(&(bins.front()), 1, 1);
+      DREAM3D_REQUIRE_EQUAL(grid.getNumberOfCells(), 0)
+
+      // a single Feature never finds itself
+      std::vector<int32_t> neighbors(1, 7);
+      grid.initialize(&(bins.front()), 2, 1);
+      grid.findWithinBins(1, criticalDistance[1], neighbors);
+      DREAM3D_REQUIRE_EQUAL(neighbors.size(), 0)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( TestDenseBins() )
+      DREAM3D_REGISTER_TEST( TestSparseBins() )
+      DREAM3D_REGISTER_TEST( TestFewFeatures() )
+    }
+
+  private:
+    CentroidBinGridTest(const CentroidBinGridTest&); // Copy Constructor Not Implemented
+    void operator=(const CentroidBinGridTest&); // Operator '=' Not Implemented
+};
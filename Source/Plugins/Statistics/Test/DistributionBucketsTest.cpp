@@ -0,0 +1,148 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <stdlib.h>
+
+#include <vector>
+
+#include "Statistics/StatisticsFilters/util/DistributionBuckets.hpp"
+
+class DistributionBucketsTest
+{
+  public:
+    DistributionBucketsTest(){}
+    virtual ~DistributionBucketsTest(){}
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    uint32_t NextRandom(uint32_t& state)
+    {
+      state = state * 1664525u + 1013904223u;
+      return state >> 8;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Compares the buckets with the vectors FitCorrelatedFeatureData used to fill one Feature at a time
+    // -----------------------------------------------------------------------------
+    void TestCorrelatedBuckets()
+    {
+      uint32_t state = 9;
+      size_t numFeatures = 3000;
+      int32_t numEnsembles = 4;
+      int32_t numBins = 7;
+      std::vector<int32_t> values(numFeatures, 0);
+      std::vector<int32_t> ensembleIds(numFeatures, 0);
+      std::vector<int32_t> binIds(numFeatures, 0);
+      bool* biased = new bool[numFeatures];
+      for (size_t i = 0; i < numFeatures; i++)
+      {
+        values[i] = static_cast<int32_t>(NextRandom(state) % 1000);
+        ensembleIds[i] = static_cast<int32_t>(NextRandom(state) % numEnsembles);
+        binIds[i] = static_cast<int32_t>(NextRandom(state) % numBins);
+        biased[i] = (NextRandom(state) % 5 == 0);
+      }
+
+      std::vector<std::vector<std::vector<float> > > expected(numEnsembles, std::vector<std::vector<float> >(numBins));
+      for (size_t i = 1; i < numFeatures; i++)
+      {
+        if (biased[i] == false)
+        {
+          expected[ensembleIds[i]][binIds[i]].push_back(static_cast<float>(values[i]));
+        }
+      }
+
+      DistributionBuckets buckets;
+      buckets.initialize(&(values.front()), numFeatures, &(ensembleIds.front()), numEnsembles, &(binIds.front()), numBins, biased);
+      DREAM3D_REQUIRE_EQUAL(buckets.getNumberOfBuckets(), numEnsembles * numBins)
+      for (int32_t e = 0; e < numEnsembles; e++)
+      {
+        for (int32_t j = 0; j < numBins; j++)
+        {
+          size_t b = static_cast<size_t>(e * numBins + j);
+          DREAM3D_REQUIRE_EQUAL(buckets.getBucketSize(b), expected[e][j].size())
+          const float* bucketValues = buckets.getBucketValues(b);
+          for (size_t k = 0; k < expected[e][j].size(); k++)
+          {
+            DREAM3D_REQUIRE_EQUAL(bucketValues[k], expected[e][j][k])
+          }
+        }
+      }
+      delete[] biased;
+    }
+
+    // -----------------------------------------------------------------------------
+    // A single bin per Ensemble, with out of range Ensembles and bins
+    // -----------------------------------------------------------------------------
+    void TestBucketBounds()
+    {
+      float values[6] = { 9.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f };
+      int32_t ensembleIds[6] = { 1, 1, 2, 5, -1, 1 };
+      int32_t binIds[6] = { 0, 0, 3, 0, 0, -2 };
+
+      DistributionBuckets buckets;
+      buckets.initialize(values, 6, ensembleIds, 3, NULL, 1, NULL);
+      DREAM3D_REQUIRE_EQUAL(buckets.getNumberOfBuckets(), 3)
+      DREAM3D_REQUIRE_EQUAL(buckets.getBucketSize(0), 0)
+      DREAM3D_REQUIRE(buckets.getBucketValues(0) == NULL)
+      DREAM3D_REQUIRE_EQUAL(buckets.getBucketSize(1), 2)
+      DREAM3D_REQUIRE_EQUAL(buckets.getBucketValues(1)[0], 1.0f)
+      DREAM3D_REQUIRE_EQUAL(buckets.getBucketValues(1)[1], 5.0f)
+      DREAM3D_REQUIRE_EQUAL(buckets.getBucketSize(2), 1)
+
+      // bins past the last one count in the last one and negative bins are skipped
+      buckets.initialize(values, 6, ensembleIds, 3, binIds, 2, NULL);
+      DREAM3D_REQUIRE_EQUAL(buckets.getNumberOfBuckets(), 6)
+      DREAM3D_REQUIRE_EQUAL(buckets.getBucketSize(2), 1)
+      DREAM3D_REQUIRE_EQUAL(buckets.getBucketSize(3), 0)
+      DREAM3D_REQUIRE_EQUAL(buckets.getBucketSize(5), 1)
+      DREAM3D_REQUIRE_EQUAL(buckets.getBucketValues(5)[0], 2.0f)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( TestCorrelatedBuckets() )
+      DREAM3D_REGISTER_TEST( TestBucketBounds() )
+    }
+
+  private:
+    DistributionBucketsTest(const DistributionBucketsTest&); // Copy Constructor Not Implemented
+    void operator=(const DistributionBucketsTest&); // Operator '=' Not Implemented
+};
@@ -0,0 +1,190 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "Statistics/StatisticsFilters/util/FaceContactGraph.hpp"
+
+class FaceContactGraphTest
+{
+  public:
+    FaceContactGraphTest(){}
+    virtual ~FaceContactGraphTest(){}
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    uint32_t NextRandom(uint32_t& state)
+    {
+      state = state * 1664525u + 1013904223u;
+      return state >> 8;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestSortKeys()
+    {
+      uint32_t state = 3;
+      std::vector<uint64_t> keys;
+      std::vector<uint64_t> buffer;
+      // few distinct high digits, so that some radix passes are skipped
+      for (size_t i = 0; i < 5000; i++)
+      {
+        keys.push_back(FaceContactGraph::PackContact(static_cast<int32_t>(NextRandom(state) % 300), static_cast<int32_t>(NextRandom(state) % 70000)));
+      }
+      std::vector<uint64_t> expected = keys;
+      std::sort(expected.begin(), expected.end());
+      FaceContactGraph::SortKeys(keys, buffer);
+      DREAM3D_REQUIRE(keys == expected)
+
+      // full width keys
+      keys.clear();
+      for (size_t i = 0; i < 5000; i++)
+      {
+        keys.push_back((static_cast<uint64_t>(NextRandom(state)) << 40) ^ (static_cast<uint64_t>(NextRandom(state)) << 16) ^ NextRandom(state));
+      }
+      expected = keys;
+      std::sort(expected.begin(), expected.end());
+      FaceContactGraph::SortKeys(keys, buffer);
+      DREAM3D_REQUIRE(keys == expected)
+
+      // all equal and empty
+      keys.assign(10, 42);
+      FaceContactGraph::SortKeys(keys, buffer);
+      DREAM3D_REQUIRE_EQUAL(keys[9], 42)
+      keys.clear();
+      FaceContactGraph::SortKeys(keys, buffer);
+      DREAM3D_REQUIRE_EQUAL(keys.size(), 0)
+    }
+
+    // -----------------------------------------------------------------------------
+    // Builds the graph of a random volume from slabs of rows, the way FindNeighbors does, and compares it with
+    // counting the faces of every Feature in a map
+    // -----------------------------------------------------------------------------
+    void TestVolume()
+    {
+      const int64_t dims[3] = { 19, 13, 11 };
+      const int32_t numFeatures = 30;
+      uint32_t state = 17;
+      std::vector<int32_t> featureIds(dims[0] * dims[1] * dims[2]);
+      for (int64_t z = 0; z < dims[2]; z++)
+      {
+        for (int64_t y = 0; y < dims[1]; y++)
+        {
+          for (int64_t x = 0; x < dims[0]; x++)
+          {
+            int32_t feature = static_cast<int32_t>(((x / 4) + (y / 3) * 5 + (z / 3) * 20) % numFeatures);
+            if (NextRandom(state) % 7 == 0) { feature = static_cast<int32_t>(NextRandom(state) % numFeatures); }
+            featureIds[(dims[0] * dims[1] * z) + (dims[0] * y) + x] = feature;
+          }
+        }
+      }
+
+      const int64_t strides[3] = { 1, dims[0], dims[0] * dims[1] };
+      std::vector<std::map<int32_t, uint64_t> > expected(numFeatures);
+      int64_t rowsPerSlab = 5;
+      int64_t numRows = dims[1] * dims[2];
+      std::vector<std::vector<FaceContactGraph::Contact_t> > slabContacts;
+      std::vector<uint64_t> keys;
+      std::vector<uint64_t> buffer;
+      for (int64_t rowStart = 0; rowStart < numRows; rowStart += rowsPerSlab)
+      {
+        keys.clear();
+        for (int64_t r = rowStart; r < std::min(rowStart + rowsPerSlab, numRows); r++)
+        {
+          for (int64_t x = 0; x < dims[0]; x++)
+          {
+            int64_t coords[3] = { x, r % dims[1], r / dims[1] };
+            int64_t index = (r * dims[0]) + x;
+            int32_t feature = featureIds[index];
+            if (feature <= 0) { continue; }
+            for (int32_t d = 0; d < 3; d++)
+            {
+              if (coords[d] > 0)
+              {
+                int32_t neighbor = featureIds[index - strides[d]];
+                if (neighbor > 0 && neighbor != feature) { expected[feature][neighbor]++; }
+              }
+              if (coords[d] < dims[d] - 1)
+              {
+                int32_t neighbor = featureIds[index + strides[d]];
+                if (neighbor > 0 && neighbor != feature)
+                {
+                  expected[feature][neighbor]++;
+                  keys.push_back(FaceContactGraph::PackContact(feature, neighbor));
+                  keys.push_back(FaceContactGraph::PackContact(neighbor, feature));
+                }
+              }
+            }
+          }
+        }
+        FaceContactGraph::SortKeys(keys, buffer);
+        slabContacts.push_back(std::vector<FaceContactGraph::Contact_t>());
+        FaceContactGraph::CountRuns(keys, slabContacts.back());
+      }
+
+      // drop the last Feature from the graph to check that rows out of range are ignored
+      FaceContactGraph graph;
+      graph.build(slabContacts, numFeatures - 1);
+      DREAM3D_REQUIRE_EQUAL(graph.getNumberOfFeatures(), numFeatures - 1)
+      for (int32_t f = 0; f < numFeatures - 1; f++)
+      {
+        DREAM3D_REQUIRE_EQUAL(graph.getNumberOfNeighbors(f), expected[f].size())
+        size_t n = 0;
+        for (std::map<int32_t, uint64_t>::iterator iter = expected[f].begin(); iter != expected[f].end(); ++iter, n++)
+        {
+          DREAM3D_REQUIRE_EQUAL(graph.getNeighbor(f, n), iter->first)
+          DREAM3D_REQUIRE_EQUAL(graph.getFaceCount(f, n), iter->second)
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( TestSortKeys() )
+      DREAM3D_REGISTER_TEST( TestVolume() )
+    }
+
+  private:
+    FaceContactGraphTest(const FaceContactGraphTest&); // Copy Constructor Not Implemented
+    void operator=(const FaceContactGraphTest&); // Operator '=' Not Implemented
+};
@@ -0,0 +1,205 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "Statistics/StatisticsFilters/util/CrossSectionCounter.hpp"
+
+class FindLargestCrossSectionsTest
+{
+  public:
+    FindLargestCrossSectionsTest(){}
+    virtual ~FindLargestCrossSectionsTest(){}
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    uint32_t NextRandom(uint32_t& state)
+    {
+      state = state * 1664525u + 1013904223u;
+      return state >> 8;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Random Features, some of which only show up in a few planes along one axis, plus Feature Id 0 cells and Ids
+    // out of range. Feature numFeatures - 1 never shows up at all.
+    // -----------------------------------------------------------------------------
+    std::vector<int32_t> MakeFeatureIds(const size_t dims[3], int32_t numFeatures, uint32_t seed)
+    {
+      std::vector<int32_t> featureIds(dims[0] * dims[1] * dims[2], 0);
+      uint32_t state = seed;
+      for (size_t z = 0; z < dims[2]; z++)
+      {
+        for (size_t y = 0; y < dims[1]; y++)
+        {
+          for (size_t x = 0; x < dims[0]; x++)
+          {
+            size_t index = (dims[0] * dims[1] * z) + (dims[0] * y) + x;
+            uint32_t r = NextRandom(state) % 20;
+            if (r < 2) { featureIds[index] = 0; }
+            else if (r == 2) { featureIds[index] = numFeatures + static_cast<int32_t>(NextRandom(state) % 3); }
+            else if (r == 3) { featureIds[index] = -1; }
+            else { featureIds[index] = 1 + static_cast<int32_t>(NextRandom(state) % (numFeatures - 4)); }
+            // Features numFeatures - 3 and numFeatures - 2 are confined to the first plane along x and the last along z
+            if (x == 0 && r < 8) { featureIds[index] = numFeatures - 3; }
+            if (z == dims[2] - 1 && r >= 16) { featureIds[index] = numFeatures - 2; }
+          }
+        }
+      }
+      return featureIds;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Counts the Features plane by plane straight from the x, y and z indices of the cells
+    // -----------------------------------------------------------------------------
+    std::vector<size_t> BruteForceLargestCounts(const std::vector<int32_t>& featureIds, const size_t dims[3], int32_t plane, int32_t numFeatures)
+    {
+      // the XY planes are normal to z, the XZ planes to y and the YZ planes to x
+      const int32_t normalAxis[3] = { 2, 1, 0 };
+      int32_t axis = normalAxis[plane];
+      std::vector<size_t> largest(numFeatures, 0);
+      for (size_t p = 0; p < dims[axis]; p++)
+      {
+        std::vector<size_t> counts(numFeatures, 0);
+        for (size_t z = 0; z < dims[2]; z++)
+        {
+          for (size_t y = 0; y < dims[1]; y++)
+          {
+            for (size_t x = 0; x < dims[0]; x++)
+            {
+              size_t coords[3] = { x, y, z };
+              if (coords[axis] != p) { continue; }
+              int32_t gnum = featureIds[(dims[0] * dims[1] * z) + (dims[0] * y) + x];
+              if (gnum <= 0 || gnum >= numFeatures) { continue; }
+              counts[gnum]++;
+            }
+          }
+        }
+        for (int32_t g = 0; g < numFeatures; g++)
+        {
+          largest[g] = std::max(largest[g], counts[g]);
+        }
+      }
+      return largest;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void CheckVolume(const size_t dims[3], int32_t numFeatures, uint32_t seed)
+    {
+      std::vector<int32_t> featureIds = MakeFeatureIds(dims, numFeatures, seed);
+      const size_t numChunks[5] = { 0, 1, 2, 3, 64 };
+      for (int32_t plane = 0; plane < 3; plane++)
+      {
+        std::vector<size_t> expected = BruteForceLargestCounts(featureIds, dims, plane, numFeatures);
+        DREAM3D_REQUIRE_EQUAL(expected[numFeatures - 1], 0)
+        DREAM3D_REQUIRE(expected[numFeatures - 3] > 0)
+        DREAM3D_REQUIRE(expected[numFeatures - 2] > 0)
+
+        // a single chunk and every split into several chunks have to find the same maxima
+        for (int32_t c = 0; c < 5; c++)
+        {
+          CrossSectionCounter counter;
+          counter.execute(&(featureIds.front()), dims, plane, numFeatures, numChunks[c]);
+          if (numChunks[c] > 0)
+          {
+            size_t extents[3] = { 0, 0, 0 };
+            size_t strides[3] = { 0, 0, 0 };
+            CrossSectionCounter::GetPlaneLayout(dims, plane, extents, strides);
+            DREAM3D_REQUIRE_EQUAL(counter.getNumberOfChunks(), std::min(numChunks[c], extents[0]))
+          }
+          for (int32_t g = 1; g < numFeatures; g++)
+          {
+            DREAM3D_REQUIRE_EQUAL(counter.getLargestCount(g), expected[g])
+          }
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestPlaneLayout()
+    {
+      const size_t dims[3] = { 7, 5, 3 };
+      const size_t expectedExtents[3][3] = { { 3, 7, 5 }, { 5, 7, 3 }, { 7, 5, 3 } };
+      const size_t expectedStrides[3][3] = { { 35, 1, 7 }, { 7, 1, 35 }, { 1, 7, 35 } };
+      for (int32_t plane = 0; plane < 3; plane++)
+      {
+        size_t extents[3] = { 0, 0, 0 };
+        size_t strides[3] = { 0, 0, 0 };
+        CrossSectionCounter::GetPlaneLayout(dims, plane, extents, strides);
+        for (int32_t i = 0; i < 3; i++)
+        {
+          DREAM3D_REQUIRE_EQUAL(extents[i], expectedExtents[plane][i])
+          DREAM3D_REQUIRE_EQUAL(strides[i], expectedStrides[plane][i])
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestAgainstBruteForce()
+    {
+      // no two axes have the same length, so swapped strides cannot go unnoticed
+      const size_t dims[3] = { 7, 5, 3 };
+      CheckVolume(dims, 12, 1);
+      CheckVolume(dims, 40, 2);
+      const size_t otherDims[3] = { 4, 9, 6 };
+      CheckVolume(otherDims, 9, 3);
+      const size_t flatDims[3] = { 11, 8, 1 };
+      CheckVolume(flatDims, 10, 4);
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( TestPlaneLayout() )
+      DREAM3D_REGISTER_TEST( TestAgainstBruteForce() )
+    }
+
+  private:
+    FindLargestCrossSectionsTest(const FindLargestCrossSectionsTest&); // Copy Constructor Not Implemented
+    void operator=(const FindLargestCrossSectionsTest&); // Operator '=' Not Implemented
+};
@@ -0,0 +1,263 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <cmath>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QString>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/Common/SIMPLibSetGetMacros.h"
+#include "SIMPLib/Common/FilterManager.h"
+#include "SIMPLib/Common/FilterFactory.hpp"
+#include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/Geometry/ImageGeom.h"
+#include "SIMPLib/Utilities/UnitTestSupport.hpp"
+#include "SIMPLib/Utilities/QMetaObjectUtilities.h"
+
+static const QString SphericityName("Sphericity");
+static const QString SurfaceAreaVolumeRatioName("SurfaceAreaVolumeRatio");
+
+class FindSurfaceAreaToVolumeTest
+{
+  public:
+    FindSurfaceAreaToVolumeTest(){}
+    virtual ~FindSurfaceAreaToVolumeTest(){}
+    SIMPL_TYPE_MACRO(FindSurfaceAreaToVolumeTest)
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int TestFilterAvailability()
+    {
+      // Now instantiate the FindSurfaceAreaToVolume Filter from the FilterManager
+      QString filtName = "FindSurfaceAreaToVolume";
+      FilterManager* fm = FilterManager::Instance();
+      IFilterFactory::Pointer filterFactory = fm->getFactoryForFilter(filtName);
+      if (NULL == filterFactory.get() )
+      {
+        std::stringstream ss;
+        ss << "The FindSurfaceAreaToVolumeTest Requires the use of the " << filtName.toStdString() << " filter which is found in the Statistics Plugin";
+        DREAM3D_TEST_THROW_EXCEPTION(ss.str())
+      }
+      return 0;
+    }
+
+    // -----------------------------------------------------------------------------
+    // A 20x12x10 grid with a resolution of 0.5, 1 and 2. Feature 1 is a box of 8x4x2 cells, a cube with an edge of
+    // 4; Feature 2 is a sphere with a radius of 3.5. Both are surrounded by cells of Feature 0
+    // -----------------------------------------------------------------------------
+    DataContainerArray::Pointer CreateDataContainerArray()
+    {
+      size_t dims[3] = { 20, 12, 10 };
+      float res[3] = { 0.5f, 1.0f, 2.0f };
+
+      DataContainerArray::Pointer dca = DataContainerArray::New();
+      DataContainer::Pointer m = DataContainer::New(SIMPL::Defaults::ImageDataContainerName);
+      ImageGeom::Pointer image = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+      m->setGeometry(image);
+      image->setDimensions(dims);
+      image->setResolution(res[0], res[1], res[2]);
+      dca->addDataContainer(m);
+
+      QVector<size_t> cDims(1, 1);
+      QVector<size_t> tDims(3, 0);
+      tDims[0] = dims[0];
+      tDims[1] = dims[1];
+      tDims[2] = dims[2];
+      AttributeMatrix::Pointer cellAttrMat = AttributeMatrix::New(tDims, SIMPL::Defaults::CellAttributeMatrixName, SIMPL::AttributeMatrixType::Cell);
+      m->addAttributeMatrix(cellAttrMat->getName(), cellAttrMat);
+      Int32ArrayType::Pointer featureIds = Int32ArrayType::CreateArray(tDims, cDims, SIMPL::CellData::FeatureIds);
+      cellAttrMat->addAttributeArray(featureIds->getName(), featureIds);
+
+      QVector<size_t> fDims(1, 3);
+      AttributeMatrix::Pointer featureAttrMat = AttributeMatrix::New(fDims, SIMPL::Defaults::CellFeatureAttributeMatrixName, SIMPL::AttributeMatrixType::CellFeature);
+      m->addAttributeMatrix(featureAttrMat->getName(), featureAttrMat);
+      Int32ArrayType::Pointer numCells = Int32ArrayType::CreateArray(fDims, cDims, SIMPL::FeatureData::NumCells);
+      numCells->initializeWithZeros();
+      featureAttrMat->addAttributeArray(numCells->getName(), numCells);
+
+      for (size_t z = 0; z < dims[2]; z++)
+      {
+        for (size_t y = 0; y < dims[1]; y++)
+        {
+          for (size_t x = 0; x < dims[0]; x++)
+          {
+            int32_t feature = 0;
+            if (x >= 2 && x < 10 && y >= 2 && y < 6 && z >= 2 && z < 4)
+            {
+              feature = 1;
+            }
+            float px = (float(x) + 0.5f) * res[0] - 5.0f;
+            float py = (float(y) + 0.5f) * res[1] - 6.0f;
+            float pz = (float(z) + 0.5f) * res[2] - 14.0f;
+            if (px * px + py * py + pz * pz <= 3.5f * 3.5f)
+            {
+              feature = 2;
+            }
+            featureIds->setValue((dims[0] * dims[1] * z) + (dims[0] * y) + x, feature);
+            numCells->setValue(feature, numCells->getValue(feature) + 1);
+          }
+        }
+      }
+      return dca;
+    }
+
+    // -----------------------------------------------------------------------------
+    // The surface area of a Feature counted face by face: every face between a cell of the Feature and a cell of
+    // another Feature inside the grid
+    // -----------------------------------------------------------------------------
+    float BruteForceSurfaceArea(DataContainerArray::Pointer dca, int32_t feature)
+    {
+      DataContainer::Pointer m = dca->getDataContainer(SIMPL::Defaults::ImageDataContainerName);
+      ImageGeom::Pointer image = m->getGeometryAs<ImageGeom>();
+      int64_t dims[3] = { int64_t(image->getXPoints()), int64_t(image->getYPoints()), int64_t(image->getZPoints()) };
+      float faceAreas[3] = { image->getYRes() * image->getZRes(), image->getZRes() * image->getXRes(), image->getXRes() * image->getYRes() };
+      Int32ArrayType::Pointer featureIds = std::dynamic_pointer_cast<Int32ArrayType>(m->getAttributeMatrix(SIMPL::Defaults::CellAttributeMatrixName)->getAttributeArray(SIMPL::CellData::FeatureIds));
+
+      float area = 0.0f;
+      for (int64_t z = 0; z < dims[2]; z++)
+      {
+        for (int64_t y = 0; y < dims[1]; y++)
+        {
+          for (int64_t x = 0; x < dims[0]; x++)
+          {
+            if (featureIds->getValue((dims[0] * dims[1] * z) + (dims[0] * y) + x) != feature) { continue; }
+            for (int32_t axis = 0; axis < 3; axis++)
+            {
+              for (int64_t step = -1; step <= 1; step += 2)
+              {
+                int64_t p[3] = { x, y, z };
+                p[axis] += step;
+                if (p[axis] < 0 || p[axis] >= dims[axis]) { continue; }
+                if (featureIds->getValue((dims[0] * dims[1] * p[2]) + (dims[0] * p[1]) + p[0]) != feature)
+                {
+                  area += faceAreas[axis];
+                }
+              }
+            }
+          }
+        }
+      }
+      return area;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    AttributeMatrix::Pointer RunFilter(DataContainerArray::Pointer dca, bool calculateSphericity)
+    {
+      FilterManager* fm = FilterManager::Instance();
+      IFilterFactory::Pointer filterFactory = fm->getFactoryForFilter("FindSurfaceAreaToVolume");
+      DREAM3D_REQUIRE(NULL != filterFactory.get())
+      AbstractFilter::Pointer filter = filterFactory->create();
+      filter->setDataContainerArray(dca);
+
+      QVariant var;
+      var.setValue(DataArrayPath(SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellAttributeMatrixName, SIMPL::CellData::FeatureIds));
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("FeatureIdsArrayPath", var), true)
+      var.setValue(DataArrayPath(SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellFeatureAttributeMatrixName, SIMPL::FeatureData::NumCells));
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("NumCellsArrayPath", var), true)
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("SurfaceAreaVolumeRatioArrayName", SurfaceAreaVolumeRatioName), true)
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("SphericityArrayName", SphericityName), true)
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("CalculateSphericity", calculateSphericity), true)
+
+      filter->execute();
+      DREAM3D_REQUIRE_EQUAL(filter->getErrorCondition(), 0)
+
+      return dca->getDataContainer(SIMPL::Defaults::ImageDataContainerName)->getAttributeMatrix(SIMPL::Defaults::CellFeatureAttributeMatrixName);
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestSphericity()
+    {
+      DataContainerArray::Pointer dca = CreateDataContainerArray();
+      AttributeMatrix::Pointer featureAttrMat = RunFilter(dca, true);
+      FloatArrayType::Pointer ratios = std::dynamic_pointer_cast<FloatArrayType>(featureAttrMat->getAttributeArray(SurfaceAreaVolumeRatioName));
+      FloatArrayType::Pointer sphericity = std::dynamic_pointer_cast<FloatArrayType>(featureAttrMat->getAttributeArray(SphericityName));
+      DREAM3D_REQUIRE(NULL != ratios.get())
+      DREAM3D_REQUIRE(NULL != sphericity.get())
+      DREAM3D_REQUIRE_EQUAL(sphericity->getNumberOfTuples(), 3)
+
+      // the cube: an area of 96 over a volume of 64, and a sphericity of (pi / 6)^(1/3) for any edge length
+      double cubeSphericity = std::pow(SIMPLib::Constants::k_Pi / 6.0, 1.0 / 3.0);
+      DREAM3D_REQUIRE(std::fabs(ratios->getValue(1) - 1.5f) < 1.0e-5f)
+      DREAM3D_REQUIRE(std::fabs(sphericity->getValue(1) - cubeSphericity) < 1.0e-5)
+
+      // the sphere: 176 cells of a volume of 1; the staircase of the voxels has about 3/2 of the area of a smooth
+      // sphere, so the sphericity is close to 2/3 and not 1
+      Int32ArrayType::Pointer numCells = std::dynamic_pointer_cast<Int32ArrayType>(featureAttrMat->getAttributeArray(SIMPL::FeatureData::NumCells));
+      DREAM3D_REQUIRE_EQUAL(numCells->getValue(2), 176)
+      double volume = 176.0;
+      double area = BruteForceSurfaceArea(dca, 2);
+      double expected = std::pow(SIMPLib::Constants::k_Pi, 1.0 / 3.0) * std::pow(6.0 * volume, 2.0 / 3.0) / area;
+      DREAM3D_REQUIRE(std::fabs(ratios->getValue(2) - area / volume) < 1.0e-5)
+      DREAM3D_REQUIRE(std::fabs(sphericity->getValue(2) - expected) < 1.0e-5)
+      DREAM3D_REQUIRE(std::fabs(sphericity->getValue(2) - 2.0 / 3.0) < 0.02)
+
+      // the cube has to come out the same when it is counted face by face
+      DREAM3D_REQUIRE(std::fabs(BruteForceSurfaceArea(dca, 1) - 96.0f) < 1.0e-3f)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestSphericityIsOptional()
+    {
+      DataContainerArray::Pointer dca = CreateDataContainerArray();
+      AttributeMatrix::Pointer featureAttrMat = RunFilter(dca, false);
+      DREAM3D_REQUIRE(NULL != featureAttrMat->getAttributeArray(SurfaceAreaVolumeRatioName).get())
+      DREAM3D_REQUIRE(NULL == featureAttrMat->getAttributeArray(SphericityName).get())
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( TestFilterAvailability() )
+      DREAM3D_REGISTER_TEST( TestSphericity() )
+      DREAM3D_REGISTER_TEST( TestSphericityIsOptional() )
+    }
+
+  private:
+    FindSurfaceAreaToVolumeTest(const FindSurfaceAreaToVolumeTest&); // Copy Constructor Not Implemented
+    void operator=(const FindSurfaceAreaToVolumeTest&); // Operator '=' Not Implemented
+};
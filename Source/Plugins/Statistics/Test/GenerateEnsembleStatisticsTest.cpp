@@ -0,0 +1,368 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QString>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/Common/SIMPLibSetGetMacros.h"
+#include "SIMPLib/Common/FilterManager.h"
+#include "SIMPLib/Common/FilterFactory.hpp"
+#include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/Common/PhaseType.h"
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataArrays/NeighborList.hpp"
+#include "SIMPLib/DataArrays/StatsDataArray.h"
+#include "SIMPLib/StatsData/PrimaryStatsData.h"
+#include "SIMPLib/StatsData/PrecipitateStatsData.h"
+#include "SIMPLib/Utilities/UnitTestSupport.hpp"
+#include "SIMPLib/Utilities/QMetaObjectUtilities.h"
+
+#include "EbsdLib/EbsdConstants.h"
+
+class GenerateEnsembleStatisticsTest
+{
+  public:
+    GenerateEnsembleStatisticsTest(){}
+    virtual ~GenerateEnsembleStatisticsTest(){}
+    SIMPL_TYPE_MACRO(GenerateEnsembleStatisticsTest)
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int TestFilterAvailability()
+    {
+      // Now instantiate the GenerateEnsembleStatistics Filter from the FilterManager
+      QString filtName = "GenerateEnsembleStatistics";
+      FilterManager* fm = FilterManager::Instance();
+      IFilterFactory::Pointer filterFactory = fm->getFactoryForFilter(filtName);
+      if (NULL == filterFactory.get() )
+      {
+        std::stringstream ss;
+        ss << "The GenerateEnsembleStatisticsTest Requires the use of the " << filtName.toStdString() << " filter which is found in the Statistics Plugin";
+        DREAM3D_TEST_THROW_EXCEPTION(ss.str())
+      }
+      return 0;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    uint32_t NextRandom(uint32_t& state)
+    {
+      state = state * 1664525u + 1013904223u;
+      return state >> 8;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    float NextUniform(uint32_t& state, float low, float high)
+    {
+      return low + (high - low) * static_cast<float>(NextRandom(state) % 100000) / 100000.0f;
+    }
+
+    // -----------------------------------------------------------------------------
+    // A cubic primary phase and a hexagonal precipitate phase; every third Feature is a precipitate. Each Feature
+    // neighbors the Features 1 and 3 before and after it, with the same shared surface area seen from both sides
+    // -----------------------------------------------------------------------------
+    DataContainerArray::Pointer CreateDataContainerArray()
+    {
+      const size_t numFeatures = 92;
+      uint32_t state = 2016;
+
+      DataContainerArray::Pointer dca = DataContainerArray::New();
+      DataContainer::Pointer m = DataContainer::New(SIMPL::Defaults::ImageDataContainerName);
+      dca->addDataContainer(m);
+
+      QVector<size_t> cDims(1, 1);
+      QVector<size_t> eDims(1, 3);
+      AttributeMatrix::Pointer ensembleAttrMat = AttributeMatrix::New(eDims, SIMPL::Defaults::CellEnsembleAttributeMatrixName, SIMPL::AttributeMatrixType::CellEnsemble);
+      m->addAttributeMatrix(ensembleAttrMat->getName(), ensembleAttrMat);
+      UInt32ArrayType::Pointer crystalStructures = UInt32ArrayType::CreateArray(eDims, cDims, SIMPL::EnsembleData::CrystalStructures);
+      crystalStructures->setValue(0, Ebsd::CrystalStructure::UnknownCrystalStructure);
+      crystalStructures->setValue(1, Ebsd::CrystalStructure::Cubic_High);
+      crystalStructures->setValue(2, Ebsd::CrystalStructure::Hexagonal_High);
+      ensembleAttrMat->addAttributeArray(crystalStructures->getName(), crystalStructures);
+
+      QVector<size_t> tDims(1, numFeatures);
+      AttributeMatrix::Pointer featureAttrMat = AttributeMatrix::New(tDims, SIMPL::Defaults::CellFeatureAttributeMatrixName, SIMPL::AttributeMatrixType::CellFeature);
+      m->addAttributeMatrix(featureAttrMat->getName(), featureAttrMat);
+
+      Int32ArrayType::Pointer phases = Int32ArrayType::CreateArray(tDims, cDims, SIMPL::FeatureData::Phases);
+      DataArray<bool>::Pointer biased = DataArray<bool>::CreateArray(tDims, cDims, SIMPL::FeatureData::BiasedFeatures);
+      DataArray<bool>::Pointer surface = DataArray<bool>::CreateArray(tDims, cDims, SIMPL::FeatureData::SurfaceFeatures);
+      FloatArrayType::Pointer diameters = FloatArrayType::CreateArray(tDims, cDims, SIMPL::FeatureData::EquivalentDiameters);
+      FloatArrayType::Pointer volumes = FloatArrayType::CreateArray(tDims, cDims, SIMPL::FeatureData::Volumes);
+      FloatArrayType::Pointer omega3s = FloatArrayType::CreateArray(tDims, cDims, SIMPL::FeatureData::Omega3s);
+      Int32ArrayType::Pointer neighborhoods = Int32ArrayType::CreateArray(tDims, cDims, SIMPL::FeatureData::Neighborhoods);
+      QVector<size_t> twoDims(1, 2);
+      FloatArrayType::Pointer aspectRatios = FloatArrayType::CreateArray(tDims, twoDims, SIMPL::FeatureData::AspectRatios);
+      QVector<size_t> threeDims(1, 3);
+      FloatArrayType::Pointer axisEulers = FloatArrayType::CreateArray(tDims, threeDims, SIMPL::FeatureData::AxisEulerAngles);
+      FloatArrayType::Pointer eulers = FloatArrayType::CreateArray(tDims, threeDims, SIMPL::FeatureData::EulerAngles);
+      QVector<size_t> fourDims(1, 4);
+      FloatArrayType::Pointer avgQuats = FloatArrayType::CreateArray(tDims, fourDims, SIMPL::FeatureData::AvgQuats);
+      NeighborList<int32_t>::Pointer neighborList = NeighborList<int32_t>::CreateArray(numFeatures, SIMPL::FeatureData::NeighborList, true);
+      NeighborList<float>::Pointer sharedSurfaceAreas = NeighborList<float>::CreateArray(numFeatures, SIMPL::FeatureData::SharedSurfaceAreaList, true);
+
+      std::vector<float> areas(numFeatures * 4, 0.0f);
+      for (size_t i = 0; i < areas.size(); i++)
+      {
+        areas[i] = NextUniform(state, 1.0f, 20.0f);
+      }
+      for (size_t i = 0; i < numFeatures; i++)
+      {
+        phases->setValue(i, (i == 0) ? 0 : ((i % 3 == 0) ? 2 : 1));
+        biased->setValue(i, (i % 11 == 5));
+        surface->setValue(i, (i % 7 == 2));
+        float diameter = NextUniform(state, 3.0f, 12.0f);
+        diameters->setValue(i, diameter);
+        volumes->setValue(i, 0.5236f * diameter * diameter * diameter);
+        omega3s->setValue(i, NextUniform(state, 0.5f, 0.95f));
+        neighborhoods->setValue(i, static_cast<int32_t>(4 + NextRandom(state) % 20));
+        float bovera = NextUniform(state, 0.4f, 0.95f);
+        aspectRatios->setComponent(i, 0, bovera);
+        aspectRatios->setComponent(i, 1, bovera * NextUniform(state, 0.5f, 1.0f));
+        for (int32_t c = 0; c < 3; c++)
+        {
+          float scale = static_cast<float>((c == 1) ? SIMPLib::Constants::k_Pi : SIMPLib::Constants::k_2Pi);
+          axisEulers->setComponent(i, c, NextUniform(state, 0.0f, scale));
+          eulers->setComponent(i, c, NextUniform(state, 0.0f, scale));
+        }
+        float q[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        float norm = 0.0f;
+        for (int32_t c = 0; c < 4; c++)
+        {
+          q[c] = NextUniform(state, -1.0f, 1.0f);
+          norm += q[c] * q[c];
+        }
+        norm = sqrtf(norm);
+        for (int32_t c = 0; c < 4; c++)
+        {
+          avgQuats->setComponent(i, c, q[c] / norm);
+        }
+
+        NeighborList<int32_t>::SharedVectorType neighborsL(new std::vector<int32_t>);
+        NeighborList<float>::SharedVectorType areasL(new std::vector<float>);
+        if (i > 0)
+        {
+          // the shared surface area of a pair is stored at the lower of the two Features
+          const int32_t offsets[4] = { -3, -1, 1, 3 };
+          for (int32_t n = 0; n < 4; n++)
+          {
+            int32_t neighbor = static_cast<int32_t>(i) + offsets[n];
+            if (neighbor < 1 || neighbor >= static_cast<int32_t>(numFeatures)) { continue; }
+            size_t low = std::min(i, static_cast<size_t>(neighbor));
+            neighborsL->push_back(neighbor);
+            areasL->push_back(areas[4 * low + ((offsets[n] == 1 || offsets[n] == -1) ? 0 : 1)]);
+          }
+        }
+        neighborList->setList(static_cast<int32_t>(i), neighborsL);
+        sharedSurfaceAreas->setList(static_cast<int32_t>(i), areasL);
+      }
+
+      featureAttrMat->addAttributeArray(phases->getName(), phases);
+      featureAttrMat->addAttributeArray(biased->getName(), biased);
+      featureAttrMat->addAttributeArray(surface->getName(), surface);
+      featureAttrMat->addAttributeArray(diameters->getName(), diameters);
+      featureAttrMat->addAttributeArray(volumes->getName(), volumes);
+      featureAttrMat->addAttributeArray(omega3s->getName(), omega3s);
+      featureAttrMat->addAttributeArray(neighborhoods->getName(), neighborhoods);
+      featureAttrMat->addAttributeArray(aspectRatios->getName(), aspectRatios);
+      featureAttrMat->addAttributeArray(axisEulers->getName(), axisEulers);
+      featureAttrMat->addAttributeArray(eulers->getName(), eulers);
+      featureAttrMat->addAttributeArray(avgQuats->getName(), avgQuats);
+      featureAttrMat->addAttributeArray(neighborList->getName(), neighborList);
+      featureAttrMat->addAttributeArray(sharedSurfaceAreas->getName(), sharedSurfaceAreas);
+
+      return dca;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    StatsDataArray::Pointer RunFilter(bool useParallelGathers)
+    {
+      DataContainerArray::Pointer dca = CreateDataContainerArray();
+      FilterManager* fm = FilterManager::Instance();
+      IFilterFactory::Pointer filterFactory = fm->getFactoryForFilter("GenerateEnsembleStatistics");
+      DREAM3D_REQUIRE(NULL != filterFactory.get())
+      AbstractFilter::Pointer filter = filterFactory->create();
+      filter->setDataContainerArray(dca);
+
+      QString dcName = SIMPL::Defaults::ImageDataContainerName;
+      QString amName = SIMPL::Defaults::CellFeatureAttributeMatrixName;
+      QVariant var;
+      var.setValue(DataArrayPath(dcName, SIMPL::Defaults::CellEnsembleAttributeMatrixName, ""));
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("CellEnsembleAttributeMatrixPath", var), true)
+      var.setValue(DataArrayPath(dcName, SIMPL::Defaults::CellEnsembleAttributeMatrixName, SIMPL::EnsembleData::CrystalStructures));
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("CrystalStructuresArrayPath", var), true)
+      const char* properties[13] = { "FeaturePhasesArrayPath", "BiasedFeaturesArrayPath", "SurfaceFeaturesArrayPath", "EquivalentDiametersArrayPath",
+                                     "VolumesArrayPath", "Omega3sArrayPath", "NeighborhoodsArrayPath", "AspectRatiosArrayPath", "AxisEulerAnglesArrayPath",
+                                     "FeatureEulerAnglesArrayPath", "AvgQuatsArrayPath", "NeighborListArrayPath", "SharedSurfaceAreaListArrayPath"
+                                   };
+      const QString arrays[13] = { SIMPL::FeatureData::Phases, SIMPL::FeatureData::BiasedFeatures, SIMPL::FeatureData::SurfaceFeatures, SIMPL::FeatureData::EquivalentDiameters,
+                                   SIMPL::FeatureData::Volumes, SIMPL::FeatureData::Omega3s, SIMPL::FeatureData::Neighborhoods, SIMPL::FeatureData::AspectRatios, SIMPL::FeatureData::AxisEulerAngles,
+                                   SIMPL::FeatureData::EulerAngles, SIMPL::FeatureData::AvgQuats, SIMPL::FeatureData::NeighborList, SIMPL::FeatureData::SharedSurfaceAreaList
+                                 };
+      for (int32_t i = 0; i < 13; i++)
+      {
+        var.setValue(DataArrayPath(dcName, amName, arrays[i]));
+        DREAM3D_REQUIRE_EQUAL(filter->setProperty(properties[i], var), true)
+      }
+
+      UInt32Vector_t phaseTypes;
+      phaseTypes.d.push_back(SIMPL::PhaseType::UnknownPhaseType);
+      phaseTypes.d.push_back(SIMPL::PhaseType::PrimaryPhase);
+      phaseTypes.d.push_back(SIMPL::PhaseType::PrecipitatePhase);
+      var.setValue(phaseTypes);
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("PhaseTypeData", var), true)
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("CalculateMorphologicalStats", true), true)
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("CalculateCrystallographicStats", true), true)
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("IncludeRadialDistFunc", false), true)
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("UseParallelGathers", useParallelGathers), true)
+
+      filter->execute();
+      DREAM3D_REQUIRE_EQUAL(filter->getErrorCondition(), 0)
+
+      AttributeMatrix::Pointer ensembleAttrMat = dca->getAttributeMatrix(DataArrayPath(dcName, SIMPL::Defaults::CellEnsembleAttributeMatrixName, ""));
+      StatsDataArray::Pointer statsDataArray = std::dynamic_pointer_cast<StatsDataArray>(ensembleAttrMat->getAttributeArray(SIMPL::EnsembleData::Statistics));
+      DREAM3D_REQUIRE(NULL != statsDataArray.get())
+      return statsDataArray;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void RequireSameArray(FloatArrayType::Pointer serial, FloatArrayType::Pointer parallel)
+    {
+      DREAM3D_REQUIRE(NULL != serial.get())
+      DREAM3D_REQUIRE(NULL != parallel.get())
+      DREAM3D_REQUIRE_EQUAL(serial->getSize(), parallel->getSize())
+      for (size_t i = 0; i < serial->getSize(); i++)
+      {
+        DREAM3D_REQUIRE_EQUAL(serial->getValue(i), parallel->getValue(i))
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void RequireSameArrays(VectorOfFloatArray serial, VectorOfFloatArray parallel)
+    {
+      DREAM3D_REQUIRE(serial.size() > 0)
+      DREAM3D_REQUIRE_EQUAL(serial.size(), parallel.size())
+      for (int32_t i = 0; i < serial.size(); i++)
+      {
+        RequireSameArray(serial[i], parallel[i]);
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    // The fields that the primary and the precipitate statistics have in common
+    // -----------------------------------------------------------------------------
+    template<typename StatsDataType>
+    void RequireSameStatsData(StatsDataType* serial, StatsDataType* parallel)
+    {
+      DREAM3D_REQUIRE(NULL != serial)
+      DREAM3D_REQUIRE(NULL != parallel)
+      RequireSameArrays(serial->getFeatureSizeDistribution(), parallel->getFeatureSizeDistribution());
+      RequireSameArray(serial->getBinNumbers(), parallel->getBinNumbers());
+      DREAM3D_REQUIRE_EQUAL(serial->getMinFeatureDiameter(), parallel->getMinFeatureDiameter())
+      DREAM3D_REQUIRE_EQUAL(serial->getMaxFeatureDiameter(), parallel->getMaxFeatureDiameter())
+      DREAM3D_REQUIRE_EQUAL(serial->getBinStepSize(), parallel->getBinStepSize())
+      RequireSameArrays(serial->getFeatureSize_BOverA(), parallel->getFeatureSize_BOverA());
+      RequireSameArrays(serial->getFeatureSize_COverA(), parallel->getFeatureSize_COverA());
+      RequireSameArrays(serial->getFeatureSize_Omegas(), parallel->getFeatureSize_Omegas());
+      RequireSameArray(serial->getODF(), parallel->getODF());
+      RequireSameArray(serial->getMisorientationBins(), parallel->getMisorientationBins());
+      RequireSameArray(serial->getAxisOrientation(), parallel->getAxisOrientation());
+      DREAM3D_REQUIRE_EQUAL(serial->getBoundaryArea(), parallel->getBoundaryArea())
+
+      // the ODF of a phase sums to one, so it cannot be left empty in both runs
+      double odfSum = 0.0;
+      FloatArrayType::Pointer odf = serial->getODF();
+      for (size_t i = 0; i < odf->getSize(); i++)
+      {
+        odfSum += odf->getValue(i);
+      }
+      DREAM3D_REQUIRE(std::fabs(odfSum - 1.0) < 1.0e-4)
+      DREAM3D_REQUIRE(serial->getBoundaryArea() > 0.0f)
+    }
+
+    // -----------------------------------------------------------------------------
+    // The gathers run as parallel tasks and the misorientation bins of the neighbor pairs are found in a parallel
+    // loop; every output has to be the same as when everything runs on the calling thread
+    // -----------------------------------------------------------------------------
+    void TestSerialAndParallelGathers()
+    {
+      StatsDataArray::Pointer serial = RunFilter(false);
+      StatsDataArray::Pointer parallel = RunFilter(true);
+      DREAM3D_REQUIRE_EQUAL(serial->getNumberOfTuples(), 3)
+      DREAM3D_REQUIRE_EQUAL(parallel->getNumberOfTuples(), 3)
+
+      PrimaryStatsData* serialPrimary = PrimaryStatsData::SafePointerDownCast((*serial)[1].get());
+      PrimaryStatsData* parallelPrimary = PrimaryStatsData::SafePointerDownCast((*parallel)[1].get());
+      RequireSameStatsData(serialPrimary, parallelPrimary);
+      RequireSameArrays(serialPrimary->getFeatureSize_Neighbors(), parallelPrimary->getFeatureSize_Neighbors());
+
+      PrecipitateStatsData* serialPrecipitate = PrecipitateStatsData::SafePointerDownCast((*serial)[2].get());
+      PrecipitateStatsData* parallelPrecipitate = PrecipitateStatsData::SafePointerDownCast((*parallel)[2].get());
+      RequireSameStatsData(serialPrecipitate, parallelPrecipitate);
+      // every precipitate has two primary neighbors, one right before and one right after it
+      DREAM3D_REQUIRE_EQUAL(serialPrecipitate->getPrecipBoundaryFraction(), 1.0f)
+      DREAM3D_REQUIRE_EQUAL(serialPrecipitate->getPrecipBoundaryFraction(), parallelPrecipitate->getPrecipBoundaryFraction())
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( TestFilterAvailability() )
+      DREAM3D_REGISTER_TEST( TestSerialAndParallelGathers() )
+    }
+
+  private:
+    GenerateEnsembleStatisticsTest(const GenerateEnsembleStatisticsTest&); // Copy Constructor Not Implemented
+    void operator=(const GenerateEnsembleStatisticsTest&); // Operator '=' Not Implemented
+};
@@ -0,0 +1,269 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <math.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "Statistics/StatisticsFilters/util/HistogramEngine.hpp"
+
+class HistogramEngineTest
+{
+  public:
+    HistogramEngineTest(){}
+    virtual ~HistogramEngineTest(){}
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    uint32_t NextRandom(uint32_t& state)
+    {
+      state = state * 1664525u + 1013904223u;
+      return state >> 8;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Checks the engine against a serial loop over the values for several numbers of chunks
+    // -----------------------------------------------------------------------------
+    template<typename T>
+    void CompareWithSerial(const std::vector<T>& values, int32_t numComponents, int32_t component, const bool* mask, const int32_t* groupIds, int32_t numGroups,
+                           bool clamp, int32_t numBins)
+    {
+      size_t numTuples = values.size() / numComponents;
+      size_t tupleStart = 1;
+      int32_t compStart = (component < 0) ? 0 : component;
+      int32_t compEnd = (component < 0) ? numComponents : component + 1;
+
+      float expectedMin = std::numeric_limits<float>::max();
+      float expectedMax = -std::numeric_limits<float>::max();
+      for (size_t t = tupleStart; t < numTuples; t++)
+      {
+        if (NULL != mask && mask[t] == false) { continue; }
+        for (int32_t k = compStart; k < compEnd; k++)
+        {
+          float value = static_cast<float>(values[t * numComponents + k]);
+          if (value > expectedMax) { expectedMax = value; }
+          if (value < expectedMin) { expectedMin = value; }
+        }
+      }
+      float increment = (expectedMax - expectedMin) / numBins;
+
+      std::vector<uint64_t> expected(numGroups * numBins, 0);
+      for (size_t t = tupleStart; t < numTuples; t++)
+      {
+        if (NULL != mask && mask[t] == false) { continue; }
+        int32_t group = (NULL == groupIds) ? 0 : groupIds[t];
+        if (group < 0 || group >= numGroups) { continue; }
+        for (int32_t k = compStart; k < compEnd; k++)
+        {
+          int32_t bin = static_cast<int32_t>((values[t * numComponents + k] - expectedMin) / increment);
+          if (bin >= numBins)
+          {
+            if (clamp == false) { continue; }
+            bin = numBins - 1;
+          }
+          expected[group * numBins + bin]++;
+        }
+      }
+
+      int64_t partials[4] = { 0, 1, 3, 8 };
+      for (int32_t p = 0; p < 4; p++)
+      {
+        HistogramEngine<T> engine(&(values.front()), numTuples, numComponents);
+        engine.setNumberOfPartials(partials[p]);
+        engine.setTupleRange(tupleStart, numTuples);
+        engine.setComponent(component);
+        engine.setMask(mask, true);
+        engine.setGroups(groupIds, numGroups);
+        engine.setClampToLastBin(clamp);
+
+        float min = std::numeric_limits<float>::max();
+        float max = -std::numeric_limits<float>::max();
+        engine.findRange(min, max);
+        DREAM3D_REQUIRE_EQUAL(min, expectedMin)
+        DREAM3D_REQUIRE_EQUAL(max, expectedMax)
+
+        std::vector<uint64_t> counts;
+        engine.findCounts(min, increment, numBins, counts);
+        DREAM3D_REQUIRE(counts == expected)
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestCounts()
+    {
+      uint32_t state = 9;
+      size_t numTuples = 20000;
+      std::vector<float> floats(numTuples * 3);
+      std::vector<int16_t> shorts(numTuples);
+      std::vector<bool> maskValues(numTuples);
+      std::vector<int32_t> groupIds(numTuples);
+      for (size_t i = 0; i < numTuples; i++)
+      {
+        for (size_t k = 0; k < 3; k++)
+        {
+          floats[i * 3 + k] = static_cast<float>(NextRandom(state) % 100000) / 977.0f - 30.0f;
+        }
+        shorts[i] = static_cast<int16_t>(static_cast<int32_t>(NextRandom(state) % 2001) - 1000);
+        maskValues[i] = (NextRandom(state) % 5 != 0);
+        groupIds[i] = static_cast<int32_t>(NextRandom(state) % 5) - 1; // includes an invalid group
+      }
+      bool* mask = new bool[numTuples];
+      std::copy(maskValues.begin(), maskValues.end(), mask);
+
+      CompareWithSerial(floats, 3, -1, NULL, NULL, 1, false, 17);
+      CompareWithSerial(floats, 3, 2, mask, &(groupIds.front()), 3, true, 10);
+      CompareWithSerial(shorts, 1, -1, mask, NULL, 1, true, 64);
+      CompareWithSerial(shorts, 1, 0, NULL, &(groupIds.front()), 4, false, 7);
+      delete[] mask;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestUserRange()
+    {
+      std::vector<double> values;
+      for (int32_t i = -10; i <= 30; i++)
+      {
+        values.push_back(i * 0.5);
+      }
+      // bins of 2 from 0 to 10; the values below 0 and from 10 up are dropped
+      HistogramEngine<double> engine(&(values.front()), values.size(), 1);
+      std::vector<uint64_t> counts;
+      engine.findCounts(0.0f, 2.0f, 5, counts);
+      DREAM3D_REQUIRE_EQUAL(counts.size(), 5)
+      for (size_t b = 0; b < 5; b++)
+      {
+        DREAM3D_REQUIRE_EQUAL(counts[b], 4)
+      }
+
+      // clamped, 10 and above go into the last bin
+      engine.setClampToLastBin(true);
+      engine.findCounts(0.0f, 2.0f, 5, counts);
+      DREAM3D_REQUIRE_EQUAL(counts[4], 15)
+
+      // clamped at both ends, the values below 0 go into the first bin
+      engine.setClampToFirstBin(true);
+      engine.findCounts(0.0f, 2.0f, 5, counts);
+      DREAM3D_REQUIRE_EQUAL(counts[0], 14)
+      DREAM3D_REQUIRE_EQUAL(counts[4], 15)
+
+      // a zero width range counts the values equal to its start in the first bin
+      std::vector<int32_t> constant(100, 7);
+      HistogramEngine<int32_t> constantEngine(&(constant.front()), constant.size(), 1);
+      float min = std::numeric_limits<float>::max();
+      float max = -std::numeric_limits<float>::max();
+      constantEngine.findRange(min, max);
+      DREAM3D_REQUIRE_EQUAL(min, 7.0f)
+      DREAM3D_REQUIRE_EQUAL(max, 7.0f)
+      constantEngine.findCounts(min, 0.0f, 4, counts);
+      DREAM3D_REQUIRE_EQUAL(counts[0], 100)
+      DREAM3D_REQUIRE_EQUAL(counts[3], 0)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestQuantileRange()
+    {
+      uint32_t state = 21;
+      std::vector<float> values(50000);
+      for (size_t i = 0; i < values.size(); i++)
+      {
+        values[i] = static_cast<float>(NextRandom(state) % 1000000) / 1000.0f - 200.0f;
+      }
+      // a few far outliers
+      values[10] = 1.0e9f;
+      values[20] = -3.0e8f;
+      values[30] = std::numeric_limits<float>::quiet_NaN();
+
+      std::vector<float> sorted;
+      for (size_t i = 0; i < values.size(); i++)
+      {
+        if (values[i] == values[i]) { sorted.push_back(values[i]); }
+      }
+      std::sort(sorted.begin(), sorted.end());
+      size_t n = sorted.size();
+
+      HistogramEngine<float> engine(&(values.front()), values.size(), 1);
+      float min = 0.0f;
+      float max = 0.0f;
+      DREAM3D_REQUIRE(engine.findQuantileRange(0.01, 0.99, min, max) == true)
+      float lower = sorted[static_cast<size_t>(0.01 * (n - 1))];
+      float upper = sorted[static_cast<size_t>(ceil(0.99 * (n - 1)))];
+      // the range holds the quantiles and is at most one bucket wider on each side
+      DREAM3D_REQUIRE(min <= lower && min >= lower - fabs(lower) * 0.01f)
+      DREAM3D_REQUIRE(max >= upper && max <= upper + fabs(upper) * 0.01f)
+
+      DREAM3D_REQUIRE(engine.findQuantileRange(0.0, 1.0, min, max) == true)
+      DREAM3D_REQUIRE_EQUAL(min, sorted.front())
+      DREAM3D_REQUIRE_EQUAL(max, sorted.back())
+
+      // no values at all
+      bool* mask = new bool[values.size()];
+      std::fill(mask, mask + values.size(), false);
+      engine.setMask(mask, true);
+      DREAM3D_REQUIRE(engine.findQuantileRange(0.0, 1.0, min, max) == false)
+      delete[] mask;
+
+      // the sketch keys keep the order of the floats
+      float ordered[6] = { -std::numeric_limits<float>::max(), -1.5f, -0.0f, 0.0f, 2.25f, std::numeric_limits<float>::infinity() };
+      for (size_t i = 0; i < 5; i++)
+      {
+        DREAM3D_REQUIRE(HistogramEngine<float>::SketchKey(ordered[i]) <= HistogramEngine<float>::SketchKey(ordered[i + 1]))
+        DREAM3D_REQUIRE_EQUAL(HistogramEngine<float>::BucketEdge(HistogramEngine<float>::SketchKey(ordered[i])), ordered[i])
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( TestCounts() )
+      DREAM3D_REGISTER_TEST( TestUserRange() )
+      DREAM3D_REGISTER_TEST( TestQuantileRange() )
+    }
+
+  private:
+    HistogramEngineTest(const HistogramEngineTest&); // Copy Constructor Not Implemented
+    void operator=(const HistogramEngineTest&); // Operator '=' Not Implemented
+};
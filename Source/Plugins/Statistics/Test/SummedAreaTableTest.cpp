@@ -0,0 +1,175 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <stdlib.h>
+
+#include <cmath>
+#include <vector>
+
+#include "Statistics/StatisticsFilters/util/SummedAreaTable.hpp"
+
+class SummedAreaTableTest
+{
+  public:
+    SummedAreaTableTest(){}
+    virtual ~SummedAreaTableTest(){}
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    uint32_t NextRandom(uint32_t& state)
+    {
+      state = state * 1664525u + 1013904223u;
+      return state >> 8;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Sums the box cell by cell, clipped to the volume and to the slices [zStart, zEnd)
+    // -----------------------------------------------------------------------------
+    template<typename T>
+    double BoxSum(const std::vector<T>& data, const int64_t dims[3], int64_t zStart, int64_t zEnd, const int64_t low[3], const int64_t high[3], int64_t& count)
+    {
+      double sum = 0.0;
+      count = 0;
+      for (int64_t z = low[2]; z < high[2]; z++)
+      {
+        if (z < zStart || z >= zEnd || z < 0 || z >= dims[2]) { continue; }
+        for (int64_t y = low[1]; y < high[1]; y++)
+        {
+          if (y < 0 || y >= dims[1]) { continue; }
+          for (int64_t x = low[0]; x < high[0]; x++)
+          {
+            if (x < 0 || x >= dims[0]) { continue; }
+            sum += static_cast<double>(data[(z * dims[1] + y) * dims[0] + x]);
+            count++;
+          }
+        }
+      }
+      return sum;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    template<typename T>
+    void CompareRandomBoxes(const std::vector<T>& data, const int64_t dims[3], int64_t zStart, int64_t zEnd, double tolerance, uint32_t seed)
+    {
+      SummedAreaTable table;
+      table.initialize(&(data.front()), dims, zStart, zEnd);
+      uint32_t state = seed;
+      for (int32_t n = 0; n < 2000; n++)
+      {
+        // boxes that start and end outside the volume as well, and some empty ones
+        int64_t low[3] = { 0, 0, 0 };
+        int64_t high[3] = { 0, 0, 0 };
+        for (int32_t d = 0; d < 3; d++)
+        {
+          low[d] = static_cast<int64_t>(NextRandom(state) % (dims[d] + 6)) - 3;
+          high[d] = low[d] + static_cast<int64_t>(NextRandom(state) % (dims[d] + 4));
+        }
+        int64_t expectedCount = 0;
+        double expected = BoxSum(data, dims, zStart, zEnd, low, high, expectedCount);
+        int64_t count = -1;
+        double sum = table.getBoxSum(low, high, count);
+        DREAM3D_REQUIRE_EQUAL(count, expectedCount)
+        DREAM3D_REQUIRE(std::fabs(sum - expected) <= tolerance * (1.0 + std::fabs(expected)))
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestIntegerVolume()
+    {
+      const int64_t dims[3] = { 17, 11, 9 };
+      std::vector<uint16_t> data(dims[0] * dims[1] * dims[2]);
+      uint32_t state = 3;
+      for (size_t i = 0; i < data.size(); i++)
+      {
+        data[i] = static_cast<uint16_t>(NextRandom(state) % 65536);
+      }
+      // integer sums are exact in double precision
+      CompareRandomBoxes(data, dims, 0, dims[2], 0.0, 1);
+      CompareRandomBoxes(data, dims, 2, 5, 0.0, 2);
+      CompareRandomBoxes(data, dims, -4, 40, 0.0, 3);
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestFloatImage()
+    {
+      const int64_t dims[3] = { 40, 23, 1 };
+      std::vector<float> data(dims[0] * dims[1] * dims[2]);
+      uint32_t state = 9;
+      for (size_t i = 0; i < data.size(); i++)
+      {
+        data[i] = static_cast<float>(NextRandom(state) % 20000) / 1000.0f - 10.0f;
+      }
+      CompareRandomBoxes(data, dims, 0, 1, 1.0e-12, 4);
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestEmptyTable()
+    {
+      const int64_t dims[3] = { 5, 4, 3 };
+      std::vector<int32_t> data(60, 1);
+      SummedAreaTable table;
+      table.initialize(&(data.front()), dims, 3, 7);
+      const int64_t low[3] = { 0, 0, 0 };
+      const int64_t high[3] = { 5, 4, 3 };
+      int64_t count = -1;
+      DREAM3D_REQUIRE_EQUAL(table.getBoxSum(low, high, count), 0.0)
+      DREAM3D_REQUIRE_EQUAL(count, 0)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( TestIntegerVolume() )
+      DREAM3D_REGISTER_TEST( TestFloatImage() )
+      DREAM3D_REGISTER_TEST( TestEmptyTable() )
+    }
+
+  private:
+    SummedAreaTableTest(const SummedAreaTableTest&); // Copy Constructor Not Implemented
+    void operator=(const SummedAreaTableTest&); // Operator '=' Not Implemented
+};
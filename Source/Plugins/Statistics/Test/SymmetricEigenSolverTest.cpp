@@ -0,0 +1,319 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <stdlib.h>
+
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+#include "Statistics/StatisticsFilters/util/SymmetricEigenSolver.hpp"
+
+class SymmetricEigenSolverTest
+{
+  public:
+    SymmetricEigenSolverTest(){}
+    virtual ~SymmetricEigenSolverTest(){}
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    uint32_t NextRandom(uint32_t& state)
+    {
+      state = state * 1664525u + 1013904223u;
+      return state >> 8;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    double NextUniform(uint32_t& state)
+    {
+      return static_cast<double>(NextRandom(state)) / 16777216.0;
+    }
+
+    // -----------------------------------------------------------------------------
+    // The eigenvalues the way FindShapes used to find them, from the roots of the characteristic cubic
+    // -----------------------------------------------------------------------------
+    void CubicEigenValues(const double* m, double* values)
+    {
+      double Ixx = m[0], Iyy = m[1], Izz = m[2], Ixy = m[3], Iyz = m[4], Ixz = m[5];
+      double b = (-Ixx - Iyy - Izz);
+      double c = ((Ixx * Izz) + (Ixx * Iyy) + (Iyy * Izz) - (Ixz * Ixz) - (Ixy * Ixy) - (Iyz * Iyz));
+      double d = ((Ixz * Iyy * Ixz) + (Ixy * Izz * Ixy) + (Iyz * Ixx * Iyz) - (Ixx * Iyy * Izz) - (Ixy * Iyz * Ixz) - (Ixy * Iyz * Ixz));
+      double f = ((3.0 * c) - (b * b)) / 3.0;
+      double g = ((2.0 * b * b * b) - (9.0 * b * c) + (27.0 * d)) / 27.0;
+      double h = (g * g / 4.0) + (f * f * f / 27.0);
+      double rsquare = (g * g / 4.0) - h;
+      double r = sqrt(rsquare);
+      if (rsquare < 0.0) { r = 0.0; }
+      double theta = 0.0;
+      if (r != 0)
+      {
+        double value = -g / (2.0 * r);
+        if (value > 1) { value = 1.0; }
+        if (value < -1) { value = -1.0; }
+        theta = acos(value);
+      }
+      double const1 = pow(r, 0.33333333333);
+      double const2 = cos(theta / 3.0);
+      double const3 = b / 3.0;
+      double const4 = 1.7320508 * sin(theta / 3.0);
+      values[0] = 2 * const1 * const2 - const3;
+      values[1] = -const1 * (const2 - const4) - const3;
+      values[2] = -const1 * (const2 + const4) - const3;
+    }
+
+    // -----------------------------------------------------------------------------
+    // The eigenvector the way FindShapes used to find it, by elimination on (M - lambda I) v = 1e-7
+    // -----------------------------------------------------------------------------
+    void EliminationEigenVector(const double* m, double value, double* vector)
+    {
+      double uber[3][3] = { { m[0] - value, m[3], m[5] }, { m[3], m[1] - value, m[4] }, { m[5], m[4], m[2] - value } };
+      double bmat[3] = { 0.0000001, 0.0000001, 0.0000001 };
+      for (int32_t k = 0; k < 2; k++)
+      {
+        for (int32_t l = k + 1; l < 3; l++)
+        {
+          double c = uber[l][k] / uber[k][k];
+          for (int32_t r = k + 1; r < 3; r++)
+          {
+            uber[l][r] = uber[l][r] - c * uber[k][r];
+          }
+          bmat[l] = bmat[l] - c * bmat[k];
+        }
+      }
+      bmat[2] = bmat[2] / uber[2][2];
+      for (int32_t r = 1; r >= 0; r--)
+      {
+        double sum = 0.0;
+        for (int32_t n = r + 1; n < 3; n++)
+        {
+          sum = sum + (uber[r][n] * bmat[n]);
+        }
+        bmat[r] = (bmat[r] - sum) / uber[r][r];
+      }
+      double norm = sqrt(bmat[0] * bmat[0] + bmat[1] * bmat[1] + bmat[2] * bmat[2]);
+      for (int32_t d = 0; d < 3; d++)
+      {
+        vector[d] = bmat[d] / norm;
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    // Builds the moments of an ellipsoid with the given principal moments, rotated by a random quaternion
+    // -----------------------------------------------------------------------------
+    void RotatedMoments(uint32_t& state, const double principal[3], bool rotate, double* m)
+    {
+      double rot[3][3] = { { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+      if (rotate == true)
+      {
+        double q0 = NextUniform(state) - 0.5, q1 = NextUniform(state) - 0.5, q2 = NextUniform(state) - 0.5, q3 = NextUniform(state) - 0.5;
+        double qn = sqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+        q0 /= qn, q1 /= qn, q2 /= qn, q3 /= qn;
+        rot[0][0] = 1.0 - 2.0 * (q2 * q2 + q3 * q3);
+        rot[0][1] = 2.0 * (q1 * q2 - q0 * q3);
+        rot[0][2] = 2.0 * (q1 * q3 + q0 * q2);
+        rot[1][0] = 2.0 * (q1 * q2 + q0 * q3);
+        rot[1][1] = 1.0 - 2.0 * (q1 * q1 + q3 * q3);
+        rot[1][2] = 2.0 * (q2 * q3 - q0 * q1);
+        rot[2][0] = 2.0 * (q1 * q3 - q0 * q2);
+        rot[2][1] = 2.0 * (q2 * q3 + q0 * q1);
+        rot[2][2] = 1.0 - 2.0 * (q1 * q1 + q2 * q2);
+      }
+      double full[3][3];
+      for (int32_t a = 0; a < 3; a++)
+      {
+        for (int32_t b = 0; b < 3; b++)
+        {
+          full[a][b] = 0.0;
+          for (int32_t k = 0; k < 3; k++)
+          {
+            full[a][b] += rot[a][k] * principal[k] * rot[b][k];
+          }
+        }
+      }
+      m[0] = full[0][0];
+      m[1] = full[1][1];
+      m[2] = full[2][2];
+      m[3] = full[0][1];
+      m[4] = full[1][2];
+      m[5] = full[0][2];
+    }
+
+    // -----------------------------------------------------------------------------
+    // Checks the ordering, residuals, orthonormality and signs of one solution
+    // -----------------------------------------------------------------------------
+    void CheckDecomposition(const double* m, const double* values, const double* vectors)
+    {
+      double scale = std::max(fabs(values[0]), fabs(values[2]));
+      if (scale == 0.0) { scale = 1.0; }
+      DREAM3D_REQUIRE(values[0] >= values[1] && values[1] >= values[2])
+
+      double full[3][3] = { { m[0], m[3], m[5] }, { m[3], m[1], m[4] }, { m[5], m[4], m[2] } };
+      for (int32_t k = 0; k < 3; k++)
+      {
+        const double* v = vectors + 3 * k;
+        DREAM3D_REQUIRE(v[0] + v[1] + v[2] >= 0.0)
+        for (int32_t r = 0; r < 3; r++)
+        {
+          double mv = full[r][0] * v[0] + full[r][1] * v[1] + full[r][2] * v[2];
+          DREAM3D_REQUIRE(fabs(mv - values[k] * v[r]) <= 1.0e-6 * scale)
+        }
+        for (int32_t l = 0; l < 3; l++)
+        {
+          const double* w = vectors + 3 * l;
+          double dot = v[0] * w[0] + v[1] * w[1] + v[2] * w[2];
+          DREAM3D_REQUIRE(fabs(dot - (k == l ? 1.0 : 0.0)) <= 1.0e-9)
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    // Compares a batch of randomly oriented ellipsoids, some with repeated axes, with the old implementation
+    // -----------------------------------------------------------------------------
+    void TestRandomEllipsoids()
+    {
+      uint32_t state = 7;
+      size_t count = 5000;
+      std::vector<double> moments(6 * count, 0.0);
+      for (size_t i = 0; i < count; i++)
+      {
+        double principal[3] = { 1.0 + 10.0 * NextUniform(state), 1.0 + 10.0 * NextUniform(state), 1.0 + 10.0 * NextUniform(state) };
+        if (i % 10 == 0) { principal[1] = principal[0]; }
+        if (i % 17 == 0) { principal[1] = principal[0], principal[2] = principal[0]; }
+        for (int32_t k = 0; k < 3; k++)
+        {
+          principal[k] *= 1.0e4;
+        }
+        RotatedMoments(state, principal, (i % 13 != 0), &(moments[6 * i]));
+      }
+
+      std::vector<double> values(3 * count, 0.0);
+      std::vector<double> vectors(9 * count, 0.0);
+      SymmetricEigenSolver::SolveBatch(&(moments.front()), count, &(values.front()), &(vectors.front()));
+
+      size_t compared = 0;
+      for (size_t i = 0; i < count; i++)
+      {
+        const double* m = &(moments[6 * i]);
+        const double* v = &(values[3 * i]);
+        CheckDecomposition(m, v, &(vectors[9 * i]));
+
+        double scale = fabs(v[0]);
+        double cubic[3] = { 0.0, 0.0, 0.0 };
+        CubicEigenValues(m, cubic);
+        for (int32_t k = 0; k < 3; k++)
+        {
+          DREAM3D_REQUIRE(fabs(cubic[k] - v[k]) <= 1.0e-5 * scale)
+        }
+
+        // eigenvectors are only defined up to sign, and only for eigenvalues that are well separated
+        for (int32_t k = 0; k < 3; k++)
+        {
+          double gap = std::min(fabs(v[k] - v[(k + 1) % 3]), fabs(v[k] - v[(k + 2) % 3]));
+          if (gap <= 1.0e-3 * scale) { continue; }
+          double old[3] = { 0.0, 0.0, 0.0 };
+          EliminationEigenVector(m, cubic[k], old);
+          if (old[0] != old[0]) { continue; }
+          const double* e = &(vectors[9 * i + 3 * k]);
+          double dot = fabs(old[0] * e[0] + old[1] * e[1] + old[2] * e[2]);
+          DREAM3D_REQUIRE(1.0 - dot <= 1.0e-5)
+          compared++;
+        }
+      }
+      DREAM3D_REQUIRE(compared > count)
+    }
+
+    // -----------------------------------------------------------------------------
+    // Single solves agree with the batch, and diagonal and zero moments produce the axes themselves
+    // -----------------------------------------------------------------------------
+    void TestSpecialMatrices()
+    {
+      double diagonal[6] = { 2.0, 5.0, 3.0, 0.0, 0.0, 0.0 };
+      double values[3] = { 0.0, 0.0, 0.0 };
+      double vectors[9];
+      SymmetricEigenSolver::Solve(diagonal, values, vectors);
+      CheckDecomposition(diagonal, values, vectors);
+      DREAM3D_REQUIRE(fabs(values[0] - 5.0) <= 1.0e-12)
+      DREAM3D_REQUIRE(fabs(values[1] - 3.0) <= 1.0e-12)
+      DREAM3D_REQUIRE(fabs(values[2] - 2.0) <= 1.0e-12)
+      DREAM3D_REQUIRE(fabs(vectors[1] - 1.0) <= 1.0e-12)
+      DREAM3D_REQUIRE(fabs(vectors[5] - 1.0) <= 1.0e-12)
+      DREAM3D_REQUIRE(fabs(vectors[6] - 1.0) <= 1.0e-12)
+
+      double zero[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+      SymmetricEigenSolver::Solve(zero, values, vectors);
+      CheckDecomposition(zero, values, vectors);
+      DREAM3D_REQUIRE_EQUAL(values[0], 0.0)
+      DREAM3D_REQUIRE_EQUAL(values[2], 0.0)
+
+      // a batch that does not fill the last block, with the eigenvectors left out
+      uint32_t state = 3;
+      size_t count = SymmetricEigenSolver::BatchSize * 2 + 5;
+      std::vector<double> moments(6 * count, 0.0);
+      for (size_t i = 0; i < count; i++)
+      {
+        double principal[3] = { NextUniform(state), NextUniform(state), NextUniform(state) };
+        RotatedMoments(state, principal, true, &(moments[6 * i]));
+      }
+      std::vector<double> batchValues(3 * count, 0.0);
+      SymmetricEigenSolver::SolveBatch(&(moments.front()), count, &(batchValues.front()), NULL);
+      for (size_t i = 0; i < count; i++)
+      {
+        SymmetricEigenSolver::Solve(&(moments[6 * i]), values, vectors);
+        CheckDecomposition(&(moments[6 * i]), values, vectors);
+        for (int32_t k = 0; k < 3; k++)
+        {
+          DREAM3D_REQUIRE_EQUAL(values[k], batchValues[3 * i + k])
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( TestRandomEllipsoids() )
+      DREAM3D_REGISTER_TEST( TestSpecialMatrices() )
+    }
+
+  private:
+    SymmetricEigenSolverTest(const SymmetricEigenSolverTest&); // Copy Constructor Not Implemented
+    void operator=(const SymmetricEigenSolverTest&); // Operator '=' Not Implemented
+};
@@ -35,6 +35,8 @@
 
 #include "QuickSurfaceMesh.h"
 
+#include <vector>
+
 #include "SIMPLib/Common/Constants.h"
 #include "SIMPLib/Common/TemplateHelpers.hpp"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
@@ -48,9 +50,7 @@
 
 #include "SurfaceMeshing/SurfaceMeshingConstants.h"
 #include "SurfaceMeshing/SurfaceMeshingVersion.h"
-
-#define QSM_GETCOORD(index, res, coord, origin)\
-coord = float((float(index)*float(res)) + float(origin));\
+#include "SurfaceMeshing/SurfaceMeshingFilters/util/QuickSurfaceMesher.hpp"
 
 #include "moc_QuickSurfaceMesh.cpp"
 
@@ -142,25 +142,24 @@ void QuickSurfaceMesh::updateFaceInstancePointers()
 }
 
 // -----------------------------------------------------------------------------
-//
+// Copies the values of the cells on both sides of every triangle to the triangle, leaving the second value of
+// triangles on the surface of the volume (no second cell) as it is
 // -----------------------------------------------------------------------------
 template<typename T>
-void copyCellArraysToFaceArrays(size_t faceIndex, size_t firstCellIndex, size_t secondCellIndex,
-                                IDataArray::Pointer cellArray, IDataArray::Pointer faceArray,
-                                bool forceSecondToZero = false)
+void copyCellArraysToFaceArrays(const std::vector<int64_t>& triangleCells, int64_t triangleCount,
+                                IDataArray::Pointer cellArray, IDataArray::Pointer faceArray)
 {
   typename DataArray<T>::Pointer cellPtr = std::dynamic_pointer_cast<DataArray<T> >(cellArray);
   typename DataArray<T>::Pointer facePtr = std::dynamic_pointer_cast<DataArray<T> >(faceArray);
 
   int32_t numComps = cellPtr->getNumberOfComponents();
-  QVector<size_t> cDims = facePtr->getComponentDimensions();
-  
-  T* faceTuplePtr = facePtr->getTuplePointer(faceIndex);
-  T* firstCellTuplePtr = cellPtr->getTuplePointer(firstCellIndex);
-  T* secondCellTuplePtr = cellPtr->getTuplePointer(secondCellIndex);
-  
-  ::memcpy(faceTuplePtr, firstCellTuplePtr, sizeof(T) * numComps);
-  if (!forceSecondToZero) { ::memcpy(faceTuplePtr + numComps, secondCellTuplePtr, sizeof(T) * numComps); }
+
+  for (int64_t t = 0; t < triangleCount; t++)
+  {
+    T* faceTuplePtr = facePtr->getTuplePointer(t);
+    ::memcpy(faceTuplePtr, cellPtr->getTuplePointer(triangleCells[2 * t]), sizeof(T) * numComps);
+    if (triangleCells[2 * t + 1] >= 0) { ::memcpy(faceTuplePtr + numComps, cellPtr->getTuplePointer(triangleCells[2 * t + 1]), sizeof(T) * numComps); }
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -309,858 +308,52 @@ void QuickSurfaceMesh::execute()
     static_cast<int64_t>(udims[2]),
   };
   
-  int64_t xP = dims[0];
-  int64_t yP = dims[1];
   int64_t zP = dims[2];
   float xRes = m->getGeometryAs<ImageGeom>()->getXRes();
   float yRes = m->getGeometryAs<ImageGeom>()->getYRes();
   float zRes = m->getGeometryAs<ImageGeom>()->getZRes();
   
-  std::vector<std::set<int32_t> > ownerLists;
-  
-  int64_t possibleNumNodes = (xP + 1) * (yP + 1) * (zP + 1);
-  std::vector<int64_t> m_NodeIds(possibleNumNodes, -1);
-  
-  int64_t nodeCount = 0;
-  int64_t triangleCount = 0;
-  
-  int64_t point = 0, neigh1 = 0, neigh2 = 0, neigh3 = 0;
-  
-  int64_t nodeId1 = 0, nodeId2 = 0, nodeId3 = 0, nodeId4 = 0;
-  
+  // the volume is meshed in slabs of whole cell layers, a few per thread so the slabs even out
+  QuickSurfaceMesher mesher(m_FeatureIds, dims, QuickSurfaceMesher::DefaultNumberOfSlabs(zP));
+
   // first determining which nodes are actually boundary nodes and
   // count number of nodes and triangles that will be created
-  for (int64_t k = 0; k < zP; k++)
-  {
-    for (int64_t j = 0; j < yP; j++)
-    {
-      for (int64_t i = 0; i < xP; i++)
-      {
-        point = (k * xP * yP) + (j * xP) + i;
-        neigh1 = point + 1;
-        neigh2 = point + xP;
-        neigh3 = point + (xP * yP);
-        
-        if (i == 0)
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          if (m_NodeIds[nodeId1] == -1)
-          {
-            m_NodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if (m_NodeIds[nodeId2] == -1)
-          {
-            m_NodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          if (m_NodeIds[nodeId3] == -1)
-          {
-            m_NodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if (m_NodeIds[nodeId4] == -1)
-          {
-            m_NodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        if (j == 0)
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          if (m_NodeIds[nodeId1] == -1)
-          {
-            m_NodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if (m_NodeIds[nodeId2] == -1)
-          {
-            m_NodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          if (m_NodeIds[nodeId3] == -1)
-          {
-            m_NodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if (m_NodeIds[nodeId4] == -1)
-          {
-            m_NodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        if (k == 0)
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          if (m_NodeIds[nodeId1] == -1)
-          {
-            m_NodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if (m_NodeIds[nodeId2] == -1)
-          {
-            m_NodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if (m_NodeIds[nodeId3] == -1)
-          {
-            m_NodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if (m_NodeIds[nodeId4] == -1)
-          {
-            m_NodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        if (i == (xP - 1))
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if (m_NodeIds[nodeId1] == -1)
-          {
-            m_NodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if (m_NodeIds[nodeId2] == -1)
-          {
-            m_NodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if (m_NodeIds[nodeId3] == -1)
-          {
-            m_NodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if (m_NodeIds[nodeId4] == -1)
-          {
-            m_NodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        else if (m_FeatureIds[point] != m_FeatureIds[neigh1])
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if (m_NodeIds[nodeId1] == -1)
-          {
-            m_NodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if (m_NodeIds[nodeId2] == -1)
-          {
-            m_NodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if (m_NodeIds[nodeId3] == -1)
-          {
-            m_NodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if (m_NodeIds[nodeId4] == -1)
-          {
-            m_NodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        if (j == (yP - 1))
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if (m_NodeIds[nodeId1] == -1)
-          {
-            m_NodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if (m_NodeIds[nodeId2] == -1)
-          {
-            m_NodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if (m_NodeIds[nodeId3] == -1)
-          {
-            m_NodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if (m_NodeIds[nodeId4] == -1)
-          {
-            m_NodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        else if (m_FeatureIds[point] != m_FeatureIds[neigh2])
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if (m_NodeIds[nodeId1] == -1)
-          {
-            m_NodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if (m_NodeIds[nodeId2] == -1)
-          {
-            m_NodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if (m_NodeIds[nodeId3] == -1)
-          {
-            m_NodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if (m_NodeIds[nodeId4] == -1)
-          {
-            m_NodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        if (k == (zP - 1))
-        {
-          nodeId1 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if (m_NodeIds[nodeId1] == -1)
-          {
-            m_NodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          if (m_NodeIds[nodeId2] == -1)
-          {
-            m_NodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if (m_NodeIds[nodeId3] == -1)
-          {
-            m_NodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if (m_NodeIds[nodeId4] == -1)
-          {
-            m_NodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        else if(k < zP - 1 && m_FeatureIds[point] != m_FeatureIds[neigh3])
-        {
-          nodeId1 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if (m_NodeIds[nodeId1] == -1)
-          {
-            m_NodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          if (m_NodeIds[nodeId2] == -1)
-          {
-            m_NodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if (m_NodeIds[nodeId3] == -1)
-          {
-            m_NodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if (m_NodeIds[nodeId4] == -1)
-          {
-            m_NodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-      }
-    }
-  }
-  
+  mesher.countNodesAndTriangles();
+  int64_t nodeCount = mesher.getNodeCount();
+  int64_t triangleCount = mesher.getTriangleCount();
+
   // now create node and triangle arrays knowing the number that will be needed
   TriangleGeom::Pointer triangleGeom = sm->getGeometryAs<TriangleGeom>();
   triangleGeom->resizeTriList(triangleCount);
   triangleGeom->resizeVertexList(nodeCount);
-  
+
   float* vertex = triangleGeom->getVertexPointer(0);
   int64_t* triangle = triangleGeom->getTriPointer(0);
-  
-  
+
   QVector<size_t> tDims(1, nodeCount);
   sm->getAttributeMatrix(getVertexAttributeMatrixName())->resizeAttributeArrays(tDims);
   tDims[0] = triangleCount;
   sm->getAttributeMatrix(getFaceAttributeMatrixName())->resizeAttributeArrays(tDims);
-  
+
   updateVertexInstancePointers();
   updateFaceInstancePointers();
-  
-  ownerLists.resize(nodeCount);
-  
+
   // Cycle through again assigning coordinates to each node and assigning node numbers and feature labels to each triangle
-  int64_t triangleIndex = 0;
-  for (int64_t k = 0; k < zP; k++)
-  {
-    for (int64_t j = 0; j < yP; j++)
-    {
-      for (int64_t i = 0; i < xP; i++)
-      {
-        point = (k * xP * yP) + (j * xP) + i;
-        neigh1 = point + 1;
-        neigh2 = point + xP;
-        neigh3 = point + (xP * yP);
-        
-        if (i == 0)
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          QSM_GETCOORD(i, xRes, vertex[m_NodeIds[nodeId1] * 3 + 0], m_OriginX);
-          QSM_GETCOORD(j, yRes, vertex[m_NodeIds[nodeId1] * 3 + 1], m_OriginY);
-          QSM_GETCOORD(k, zRes, vertex[m_NodeIds[nodeId1] * 3 + 2], m_OriginZ);
-          
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          QSM_GETCOORD(i, xRes, vertex[m_NodeIds[nodeId2] * 3 + 0], m_OriginX);
-          QSM_GETCOORD((j + 1), yRes, vertex[m_NodeIds[nodeId2] * 3 + 1], m_OriginY);
-          QSM_GETCOORD(k, zRes, vertex[m_NodeIds[nodeId2] * 3 + 2], m_OriginZ);
-          
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          QSM_GETCOORD(i, xRes, vertex[m_NodeIds[nodeId3] * 3 + 0], m_OriginX);
-          QSM_GETCOORD(j, yRes, vertex[m_NodeIds[nodeId3] * 3 + 1], m_OriginY);
-          QSM_GETCOORD((k + 1), zRes, vertex[m_NodeIds[nodeId3] * 3 + 2], m_OriginZ);
-          
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          QSM_GETCOORD((i + 1), xRes, vertex[m_NodeIds[nodeId4] * 3 + 0], m_OriginX);
-          QSM_GETCOORD((j + 1), yRes, vertex[m_NodeIds[nodeId4] * 3 + 1], m_OriginY);
-          QSM_GETCOORD((k + 1), zRes, vertex[m_NodeIds[nodeId4] * 3 + 2], m_OriginZ);
-          
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId1];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId3];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[point];
-          m_FaceLabels[triangleIndex * 2 + 1] = -1;
-          
-          for (int32_t i = 0; i < m_SelectedWeakPtrVector.size(); i++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[i].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[i].lock(), m_CreatedWeakPtrVector[i].lock(), true)
-          }
-          
-          triangleIndex++;
-          
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId4];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId3];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[point];
-          m_FaceLabels[triangleIndex * 2 + 1] = -1;
-          
-          for (int32_t i = 0; i < m_SelectedWeakPtrVector.size(); i++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[i].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[i].lock(), m_CreatedWeakPtrVector[i].lock(), true)
-          }
-          
-          triangleIndex++;
-          
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId1]].insert(-1);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId2]].insert(-1);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId3]].insert(-1);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId4]].insert(-1);
-        }
-        if (j == 0)
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          QSM_GETCOORD(i, xRes, vertex[m_NodeIds[nodeId1] * 3 + 0], m_OriginX);
-          QSM_GETCOORD(j, yRes, vertex[m_NodeIds[nodeId1] * 3 + 1], m_OriginY);
-          QSM_GETCOORD(k, zRes, vertex[m_NodeIds[nodeId1] * 3 + 2], m_OriginZ);
-          
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          QSM_GETCOORD((i + 1), xRes, vertex[m_NodeIds[nodeId2] * 3 + 0], m_OriginX);
-          QSM_GETCOORD(j, yRes, vertex[m_NodeIds[nodeId2] * 3 + 1], m_OriginY);
-          QSM_GETCOORD(k, zRes, vertex[m_NodeIds[nodeId2] * 3 + 2], m_OriginZ);
-          
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          QSM_GETCOORD(i, xRes, vertex[m_NodeIds[nodeId3] * 3 + 0], m_OriginX);
-          QSM_GETCOORD(j, yRes, vertex[m_NodeIds[nodeId3] * 3 + 1], m_OriginY);
-          QSM_GETCOORD((k + 1), zRes, vertex[m_NodeIds[nodeId3] * 3 + 2], m_OriginZ);
-          
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          QSM_GETCOORD((i + 1), xRes, vertex[m_NodeIds[nodeId4] * 3 + 0], m_OriginX);
-          QSM_GETCOORD(j, yRes, vertex[m_NodeIds[nodeId4] * 3 + 1], m_OriginY);
-          QSM_GETCOORD((k + 1), zRes, vertex[m_NodeIds[nodeId4] * 3 + 2], m_OriginZ);
-          
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId1];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId3];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId2];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[point];
-          m_FaceLabels[triangleIndex * 2 + 1] = -1;
-          
-          for (int32_t i = 0; i < m_SelectedWeakPtrVector.size(); i++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[i].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[i].lock(), m_CreatedWeakPtrVector[i].lock(), true)
-          }
-  
-          triangleIndex++;
-          
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId3];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId4];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[point];
-          m_FaceLabels[triangleIndex * 2 + 1] = -1;
-          
-          for (int32_t i = 0; i < m_SelectedWeakPtrVector.size(); i++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[i].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[i].lock(), m_CreatedWeakPtrVector[i].lock(), true)
-          }
-          
-          triangleIndex++;
-          
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId1]].insert(-1);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId2]].insert(-1);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId3]].insert(-1);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId4]].insert(-1);
-        }
-        if (k == 0)
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          QSM_GETCOORD(i, xRes, vertex[m_NodeIds[nodeId1] * 3 + 0], m_OriginX);
-          QSM_GETCOORD(j, yRes, vertex[m_NodeIds[nodeId1] * 3 + 1], m_OriginY);
-          QSM_GETCOORD(k, zRes, vertex[m_NodeIds[nodeId1] * 3 + 2], m_OriginZ);
-          
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          QSM_GETCOORD((i + 1), xRes, vertex[m_NodeIds[nodeId2] * 3 + 0], m_OriginX);
-          QSM_GETCOORD(j, yRes, vertex[m_NodeIds[nodeId2] * 3 + 1], m_OriginY);
-          QSM_GETCOORD(k, zRes, vertex[m_NodeIds[nodeId2] * 3 + 2], m_OriginZ);
-          
-          nodeId3 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          QSM_GETCOORD(i, xRes, vertex[m_NodeIds[nodeId3] * 3 + 0], m_OriginX);
-          QSM_GETCOORD((j + 1), yRes, vertex[m_NodeIds[nodeId3] * 3 + 1], m_OriginY);
-          QSM_GETCOORD(k, zRes, vertex[m_NodeIds[nodeId3] * 3 + 2], m_OriginZ);
-          
-          nodeId4 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          QSM_GETCOORD((i + 1), xRes, vertex[m_NodeIds[nodeId4] * 3 + 0], m_OriginX);
-          QSM_GETCOORD((j + 1), yRes, vertex[m_NodeIds[nodeId4] * 3 + 1], m_OriginY);
-          QSM_GETCOORD(k, zRes, vertex[m_NodeIds[nodeId4] * 3 + 2], m_OriginZ);
-          
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId1];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId3];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[point];
-          m_FaceLabels[triangleIndex * 2 + 1] = -1;
-          
-          for (int32_t i = 0; i < m_SelectedWeakPtrVector.size(); i++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[i].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[i].lock(), m_CreatedWeakPtrVector[i].lock(), true)
-          }
-        
-          triangleIndex++;
-          
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId4];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId3];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[point];
-          m_FaceLabels[triangleIndex * 2 + 1] = -1;
-          
-          for (int32_t i = 0; i < m_SelectedWeakPtrVector.size(); i++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[i].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[i].lock(), m_CreatedWeakPtrVector[i].lock(), true)
-          }
-          
-          triangleIndex++;
-          
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId1]].insert(-1);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId2]].insert(-1);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId3]].insert(-1);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId4]].insert(-1);
-        }
-        if (i == (xP - 1))
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          QSM_GETCOORD((i + 1), xRes, vertex[m_NodeIds[nodeId1] * 3 + 0], m_OriginX);
-          QSM_GETCOORD(j, yRes, vertex[m_NodeIds[nodeId1] * 3 + 1], m_OriginY);
-          QSM_GETCOORD(k, zRes, vertex[m_NodeIds[nodeId1] * 3 + 2], m_OriginZ);
-          
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          QSM_GETCOORD((i + 1), xRes, vertex[m_NodeIds[nodeId2] * 3 + 0], m_OriginX);
-          QSM_GETCOORD((j + 1), yRes, vertex[m_NodeIds[nodeId2] * 3 + 1], m_OriginY);
-          QSM_GETCOORD(k, zRes, vertex[m_NodeIds[nodeId2] * 3 + 2], m_OriginZ);
-          
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          QSM_GETCOORD((i + 1), xRes, vertex[m_NodeIds[nodeId3] * 3 + 0], m_OriginX);
-          QSM_GETCOORD(j, yRes, vertex[m_NodeIds[nodeId3] * 3 + 1], m_OriginY);
-          QSM_GETCOORD((k + 1), zRes, vertex[m_NodeIds[nodeId3] * 3 + 2], m_OriginZ);
-          
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          QSM_GETCOORD((i + 1), xRes, vertex[m_NodeIds[nodeId4] * 3 + 0], m_OriginX);
-          QSM_GETCOORD((j + 1), yRes, vertex[m_NodeIds[nodeId4] * 3 + 1], m_OriginY);
-          QSM_GETCOORD((k + 1), zRes, vertex[m_NodeIds[nodeId4] * 3 + 2], m_OriginZ);
-          
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId3];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId1];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[point];
-          m_FaceLabels[triangleIndex * 2 + 1] = -1;
-          
-          for (int32_t i = 0; i < m_SelectedWeakPtrVector.size(); i++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[i].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[i].lock(), m_CreatedWeakPtrVector[i].lock(), true)
-          }
-          
-          triangleIndex++;
-          
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId3];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId4];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId2];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[point];
-          m_FaceLabels[triangleIndex * 2 + 1] = -1;
-          
-          for (int32_t i = 0; i < m_SelectedWeakPtrVector.size(); i++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[i].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[i].lock(), m_CreatedWeakPtrVector[i].lock(), true)
-          }
-          
-          triangleIndex++;
-          
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId1]].insert(-1);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId2]].insert(-1);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId3]].insert(-1);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId4]].insert(-1);
-        }
-        else if (m_FeatureIds[point] != m_FeatureIds[neigh1])
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          QSM_GETCOORD((i + 1), xRes, vertex[m_NodeIds[nodeId1] * 3 + 0], m_OriginX);
-          QSM_GETCOORD(j, yRes, vertex[m_NodeIds[nodeId1] * 3 + 1], m_OriginY);
-          QSM_GETCOORD(k, zRes, vertex[m_NodeIds[nodeId1] * 3 + 2], m_OriginZ);
-          
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          QSM_GETCOORD((i + 1), xRes, vertex[m_NodeIds[nodeId2] * 3 + 0], m_OriginX);
-          QSM_GETCOORD((j + 1), yRes, vertex[m_NodeIds[nodeId2] * 3 + 1], m_OriginY);
-          QSM_GETCOORD(k, zRes, vertex[m_NodeIds[nodeId2] * 3 + 2], m_OriginZ);
-          
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          QSM_GETCOORD((i + 1), xRes, vertex[m_NodeIds[nodeId3] * 3 + 0], m_OriginX);
-          QSM_GETCOORD(j, yRes, vertex[m_NodeIds[nodeId3] * 3 + 1], m_OriginY);
-          QSM_GETCOORD((k + 1), zRes, vertex[m_NodeIds[nodeId3] * 3 + 2], m_OriginZ);
-          
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          QSM_GETCOORD((i + 1), xRes, vertex[m_NodeIds[nodeId4] * 3 + 0], m_OriginX);
-          QSM_GETCOORD((j + 1), yRes, vertex[m_NodeIds[nodeId4] * 3 + 1], m_OriginY);
-          QSM_GETCOORD((k + 1), zRes, vertex[m_NodeIds[nodeId4] * 3 + 2], m_OriginZ);
-          
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId1];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId3];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[neigh1];
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-          
-          for (int32_t i = 0; i < m_SelectedWeakPtrVector.size(); i++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[i].lock(), triangleIndex, neigh1, point, m_SelectedWeakPtrVector[i].lock(), m_CreatedWeakPtrVector[i].lock())
-          }
-          
-          triangleIndex++;
-          
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId4];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId3];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[neigh1];
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-          
-          for (int32_t i = 0; i < m_SelectedWeakPtrVector.size(); i++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[i].lock(), triangleIndex, neigh1, point, m_SelectedWeakPtrVector[i].lock(), m_CreatedWeakPtrVector[i].lock())
-          }
-          
-          triangleIndex++;
-          
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[neigh1]);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[neigh1]);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[neigh1]);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[neigh1]);
-        }
-        if (j == (yP - 1))
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          QSM_GETCOORD((i + 1), xRes, vertex[m_NodeIds[nodeId1] * 3 + 0], m_OriginX);
-          QSM_GETCOORD((j + 1), yRes, vertex[m_NodeIds[nodeId1] * 3 + 1], m_OriginY);
-          QSM_GETCOORD(k, zRes, vertex[m_NodeIds[nodeId1] * 3 + 2], m_OriginZ);
-          
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          QSM_GETCOORD(i, xRes, vertex[m_NodeIds[nodeId2] * 3 + 0], m_OriginX);
-          QSM_GETCOORD((j + 1), yRes, vertex[m_NodeIds[nodeId2] * 3 + 1], m_OriginY);
-          QSM_GETCOORD(k, zRes, vertex[m_NodeIds[nodeId2] * 3 + 2], m_OriginZ);
-          
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          QSM_GETCOORD((i + 1), xRes, vertex[m_NodeIds[nodeId3] * 3 + 0], m_OriginX);
-          QSM_GETCOORD((j + 1), yRes, vertex[m_NodeIds[nodeId3] * 3 + 1], m_OriginY);
-          QSM_GETCOORD((k + 1), zRes, vertex[m_NodeIds[nodeId3] * 3 + 2], m_OriginZ);
-          
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          QSM_GETCOORD(i, xRes, vertex[m_NodeIds[nodeId4] * 3 + 0], m_OriginX);
-          QSM_GETCOORD((j + 1), yRes, vertex[m_NodeIds[nodeId4] * 3 + 1], m_OriginY);
-          QSM_GETCOORD((k + 1), zRes, vertex[m_NodeIds[nodeId4] * 3 + 2], m_OriginZ);
-          
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId3];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId1];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[point];
-          m_FaceLabels[triangleIndex * 2 + 1] = -1;
-          
-          for (int32_t i = 0; i < m_SelectedWeakPtrVector.size(); i++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[i].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[i].lock(), m_CreatedWeakPtrVector[i].lock(), true)
-          }
-          
-          triangleIndex++;
-          
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId3];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId4];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId2];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[point];
-          m_FaceLabels[triangleIndex * 2 + 1] = -1;
-          
-          for (int32_t i = 0; i < m_SelectedWeakPtrVector.size(); i++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[i].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[i].lock(), m_CreatedWeakPtrVector[i].lock(), true)
-          }
-          
-          triangleIndex++;
-          
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId1]].insert(-1);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId2]].insert(-1);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId3]].insert(-1);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId4]].insert(-1);
-        }
-        else if (m_FeatureIds[point] != m_FeatureIds[neigh2])
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          QSM_GETCOORD((i + 1), xRes, vertex[m_NodeIds[nodeId1] * 3 + 0], m_OriginX);
-          QSM_GETCOORD((j + 1), yRes, vertex[m_NodeIds[nodeId1] * 3 + 1], m_OriginY);
-          QSM_GETCOORD(k, zRes, vertex[m_NodeIds[nodeId1] * 3 + 2], m_OriginZ);
-          
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          QSM_GETCOORD(i, xRes, vertex[m_NodeIds[nodeId2] * 3 + 0], m_OriginX);
-          QSM_GETCOORD((j + 1), yRes, vertex[m_NodeIds[nodeId2] * 3 + 1], m_OriginY);
-          QSM_GETCOORD(k, zRes, vertex[m_NodeIds[nodeId2] * 3 + 2], m_OriginZ);
-          
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          QSM_GETCOORD((i + 1), xRes, vertex[m_NodeIds[nodeId3] * 3 + 0], m_OriginX);
-          QSM_GETCOORD((j + 1), yRes, vertex[m_NodeIds[nodeId3] * 3 + 1], m_OriginY);
-          QSM_GETCOORD((k + 1), zRes, vertex[m_NodeIds[nodeId3] * 3 + 2], m_OriginZ);
-          
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          QSM_GETCOORD(i, xRes, vertex[m_NodeIds[nodeId4] * 3 + 0], m_OriginX);
-          QSM_GETCOORD((j + 1), yRes, vertex[m_NodeIds[nodeId4] * 3 + 1], m_OriginY);
-          QSM_GETCOORD((k + 1), zRes, vertex[m_NodeIds[nodeId4] * 3 + 2], m_OriginZ);
-          
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId1];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId3];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[neigh2];
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-          
-          for (int32_t i = 0; i < m_SelectedWeakPtrVector.size(); i++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[i].lock(), triangleIndex, neigh2, point, m_SelectedWeakPtrVector[i].lock(), m_CreatedWeakPtrVector[i].lock())
-          }
-          
-          triangleIndex++;
-          
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId4];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId3];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[neigh2];
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-          
-          for (int32_t i = 0; i < m_SelectedWeakPtrVector.size(); i++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[i].lock(), triangleIndex, neigh2, point, m_SelectedWeakPtrVector[i].lock(), m_CreatedWeakPtrVector[i].lock())
-          }
-          
-          triangleIndex++;
-          
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[neigh2]);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[neigh2]);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[neigh2]);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[neigh2]);
-        }
-        if (k == (zP - 1))
-        {
-          nodeId1 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          QSM_GETCOORD((i + 1), xRes, vertex[m_NodeIds[nodeId1] * 3 + 0], m_OriginX);
-          QSM_GETCOORD(j, yRes, vertex[m_NodeIds[nodeId1] * 3 + 1], m_OriginY);
-          QSM_GETCOORD((k + 1), zRes, vertex[m_NodeIds[nodeId1] * 3 + 2], m_OriginZ);
-          
-          nodeId2 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          QSM_GETCOORD(i, xRes, vertex[m_NodeIds[nodeId2] * 3 + 0], m_OriginX);
-          QSM_GETCOORD(j, yRes, vertex[m_NodeIds[nodeId2] * 3 + 1], m_OriginY);
-          QSM_GETCOORD((k + 1), zRes, vertex[m_NodeIds[nodeId2] * 3 + 2], m_OriginZ);
-          
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          QSM_GETCOORD((i + 1), xRes, vertex[m_NodeIds[nodeId3] * 3 + 0], m_OriginX);
-          QSM_GETCOORD((j + 1), yRes, vertex[m_NodeIds[nodeId3] * 3 + 1], m_OriginY);
-          QSM_GETCOORD((k + 1), zRes, vertex[m_NodeIds[nodeId3] * 3 + 2], m_OriginZ);
-          
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          QSM_GETCOORD(i, xRes, vertex[m_NodeIds[nodeId4] * 3 + 0], m_OriginX);
-          QSM_GETCOORD((j + 1), yRes, vertex[m_NodeIds[nodeId4] * 3 + 1], m_OriginY);
-          QSM_GETCOORD((k + 1), zRes, vertex[m_NodeIds[nodeId4] * 3 + 2], m_OriginZ);
-          
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId3];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId1];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[point];
-          m_FaceLabels[triangleIndex * 2 + 1] = -1;
-          
-          for (int32_t i = 0; i < m_SelectedWeakPtrVector.size(); i++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[i].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[i].lock(), m_CreatedWeakPtrVector[i].lock(), true)
-          }
-          
-          triangleIndex++;
-          
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId4];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId3];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId2];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[point];
-          m_FaceLabels[triangleIndex * 2 + 1] = -1;
-          
-          for (int32_t i = 0; i < m_SelectedWeakPtrVector.size(); i++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[i].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[i].lock(), m_CreatedWeakPtrVector[i].lock(), true)
-          }
-          
-          triangleIndex++;
-          
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId1]].insert(-1);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId2]].insert(-1);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId3]].insert(-1);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId4]].insert(-1);
-        }
-        else if (m_FeatureIds[point] != m_FeatureIds[neigh3])
-        {
-          nodeId1 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          QSM_GETCOORD((i + 1), xRes, vertex[m_NodeIds[nodeId1] * 3 + 0], m_OriginX);
-          QSM_GETCOORD(j, yRes, vertex[m_NodeIds[nodeId1] * 3 + 1], m_OriginY);
-          QSM_GETCOORD((k + 1), zRes, vertex[m_NodeIds[nodeId1] * 3 + 2], m_OriginZ);
-          
-          nodeId2 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          QSM_GETCOORD(i, xRes, vertex[m_NodeIds[nodeId2] * 3 + 0], m_OriginX);
-          QSM_GETCOORD(j, yRes, vertex[m_NodeIds[nodeId2] * 3 + 1], m_OriginY);
-          QSM_GETCOORD((k + 1), zRes, vertex[m_NodeIds[nodeId2] * 3 + 2], m_OriginZ);
-          
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          QSM_GETCOORD((i + 1), xRes, vertex[m_NodeIds[nodeId3] * 3 + 0], m_OriginX);
-          QSM_GETCOORD((j + 1), yRes, vertex[m_NodeIds[nodeId3] * 3 + 1], m_OriginY);
-          QSM_GETCOORD((k + 1), zRes, vertex[m_NodeIds[nodeId3] * 3 + 2], m_OriginZ);
-          
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          QSM_GETCOORD(i, xRes, vertex[m_NodeIds[nodeId4] * 3 + 0], m_OriginX);
-          QSM_GETCOORD((j + 1), yRes, vertex[m_NodeIds[nodeId4] * 3 + 1], m_OriginY);
-          QSM_GETCOORD((k + 1), zRes, vertex[m_NodeIds[nodeId4] * 3 + 2], m_OriginZ);
-          
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId1];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId3];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId2];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[neigh3];
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-          
-          for (int32_t i = 0; i < m_SelectedWeakPtrVector.size(); i++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[i].lock(), triangleIndex, neigh3, point, m_SelectedWeakPtrVector[i].lock(), m_CreatedWeakPtrVector[i].lock())
-          }
-          
-          triangleIndex++;
-          
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId3];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId4];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[neigh3];
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-          
-          for (int32_t i = 0; i < m_SelectedWeakPtrVector.size(); i++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[i].lock(), triangleIndex, neigh3, point, m_SelectedWeakPtrVector[i].lock(), m_CreatedWeakPtrVector[i].lock())
-          }
-          
-          triangleIndex++;
-          
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[neigh3]);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[neigh3]);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[neigh3]);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[neigh3]);
-        }
-      }
-    }
-  }
-  
-  for (int64_t i = 0; i < nodeCount; i++)
+  float resolution[3] = { xRes, yRes, zRes };
+  float origin[3] = { m_OriginX, m_OriginY, m_OriginZ };
+  mesher.placeNodes(resolution, origin, vertex);
+
+  std::vector<int64_t> triangleCells;
+  if (m_SelectedWeakPtrVector.size() > 0) { triangleCells.resize(2 * triangleCount + 2, -1); }
+  int64_t* triangleCellsPtr = triangleCells.empty() ? NULL : &(triangleCells.front());
+  mesher.generateTriangles(triangle, m_FaceLabels, triangleCellsPtr);
+
+  for (size_t i = 0; i < m_SelectedWeakPtrVector.size(); i++)
   {
-    m_NodeTypes[i] = ownerLists[i].size();
-    if (m_NodeTypes[i] > 4) { m_NodeTypes[i] = 4; }
-    if (ownerLists[i].find(-1) != ownerLists[i].end()) { m_NodeTypes[i] += 10; }
+    EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[i].lock(), triangleCells, triangleCount, m_SelectedWeakPtrVector[i].lock(), m_CreatedWeakPtrVector[i].lock())
   }
+
+  mesher.findNodeTypes(m_NodeTypes);
   
   notifyStatusMessage(getHumanLabel(), "Complete");
 }
@@ -0,0 +1,593 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+
+#ifndef _quicksurfacemesher_hpp_
+#define _quicksurfacemesher_hpp_
+
+#include <algorithm>
+#include <vector>
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
+#include "SIMPLib/SIMPLib.h"
+
+#define QSM_GETCOORD(index, res, coord, origin)\
+coord = float((float(index)*float(res)) + float(origin));\
+
+/**
+ * @brief The QuickSurfaceMeshFace_t struct describes one kind of quad face of a cell: its four nodes, as offsets
+ * along x, y and z from the lowest node of the cell, and the two triangles the quad is split into
+ */
+struct QuickSurfaceMeshFace_t
+{
+  int8_t m_Nodes[4][3];
+  int8_t m_Triangles[2][3];
+};
+
+/**
+ * @brief The faces a cell can create, in the order the cell creates them: the faces on the -x, -y and -z surfaces
+ * of the volume, then its +x, +y and +z faces, each either on the surface of the volume or between two Features
+ */
+static const QuickSurfaceMeshFace_t k_QuickSurfaceMeshFaces[9] =
+{
+  { { { 0, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 }, { 0, 1, 1 } }, { { 0, 1, 2 }, { 1, 3, 2 } } },
+  { { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 0, 1 }, { 1, 0, 1 } }, { { 0, 2, 1 }, { 1, 2, 3 } } },
+  { { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 1, 1, 0 } }, { { 0, 1, 2 }, { 1, 3, 2 } } },
+  { { { 1, 0, 0 }, { 1, 1, 0 }, { 1, 0, 1 }, { 1, 1, 1 } }, { { 2, 1, 0 }, { 2, 3, 1 } } },
+  { { { 1, 0, 0 }, { 1, 1, 0 }, { 1, 0, 1 }, { 1, 1, 1 } }, { { 0, 1, 2 }, { 1, 3, 2 } } },
+  { { { 1, 1, 0 }, { 0, 1, 0 }, { 1, 1, 1 }, { 0, 1, 1 } }, { { 2, 1, 0 }, { 2, 3, 1 } } },
+  { { { 1, 1, 0 }, { 0, 1, 0 }, { 1, 1, 1 }, { 0, 1, 1 } }, { { 0, 1, 2 }, { 1, 3, 2 } } },
+  { { { 1, 0, 1 }, { 0, 0, 1 }, { 1, 1, 1 }, { 0, 1, 1 } }, { { 1, 2, 0 }, { 3, 2, 1 } } },
+  { { { 1, 0, 1 }, { 0, 0, 1 }, { 1, 1, 1 }, { 0, 1, 1 } }, { { 0, 2, 1 }, { 1, 2, 3 } } }
+};
+
+// -----------------------------------------------------------------------------
+// Lists the faces of a cell as indices into k_QuickSurfaceMeshFaces, with the neighboring cell across every face
+// or -1 for faces on the surface of the volume, and returns their number
+// -----------------------------------------------------------------------------
+static int32_t findCellFaces(const int32_t* featureIds, const int64_t dims[3], int64_t i, int64_t j, int64_t k, int32_t faces[6], int64_t neighbors[6])
+{
+  int64_t point = (k * dims[0] * dims[1]) + (j * dims[0]) + i;
+  int32_t count = 0;
+  if (i == 0) { faces[count] = 0; neighbors[count] = -1; count++; }
+  if (j == 0) { faces[count] = 1; neighbors[count] = -1; count++; }
+  if (k == 0) { faces[count] = 2; neighbors[count] = -1; count++; }
+
+  const int64_t strides[3] = { 1, dims[0], dims[0] * dims[1] };
+  const int64_t coords[3] = { i, j, k };
+  for (int32_t d = 0; d < 3; d++)
+  {
+    if (coords[d] == dims[d] - 1) { faces[count] = 3 + 2 * d; neighbors[count] = -1; count++; }
+    else if (featureIds[point] != featureIds[point + strides[d]]) { faces[count] = 4 + 2 * d; neighbors[count] = point + strides[d]; count++; }
+  }
+  return count;
+}
+
+// -----------------------------------------------------------------------------
+// Adds a Feature to the owners of a node. Only up to four distinct Features are kept, which is all the node type
+// needs, and the surface of the volume (-1) is kept as a flag
+// -----------------------------------------------------------------------------
+static void addNodeOwner(int32_t* owners, int8_t* ownerCounts, uint8_t* surfaceNodes, int64_t node, int32_t feature)
+{
+  if (feature == -1)
+  {
+    surfaceNodes[node] = 1;
+    return;
+  }
+  int32_t* nodeOwners = owners + 4 * node;
+  int8_t count = ownerCounts[node];
+  for (int8_t c = 0; c < count; c++)
+  {
+    if (nodeOwners[c] == feature) { return; }
+  }
+  if (count < 4)
+  {
+    nodeOwners[count] = feature;
+    ownerCounts[node] = count + 1;
+  }
+}
+
+/**
+ * @brief The QuickSurfaceMeshSlab_t struct holds the range of cell layers of one z slab of the volume, the number of
+ * nodes and triangles the slab creates, where they start in the mesh, and which nodes of its lowest node plane the
+ * slab below it creates instead
+ */
+struct QuickSurfaceMeshSlab_t
+{
+  int64_t m_ZStart;
+  int64_t m_ZEnd;
+  int64_t m_NodeCount;
+  int64_t m_TriangleCount;
+  int64_t m_FirstNode;
+  int64_t m_FirstTriangle;
+  std::vector<uint8_t> m_NodesFromBelow;
+};
+
+/**
+ * @brief The QuickSurfaceMeshCountImpl class numbers the nodes of a range of slabs in the order the cells of each
+ * slab first reach them, counting from 0 in every slab, and counts the triangles of the slabs. A node on the plane
+ * between two slabs belongs to the lower slab if a face of the lower slab reaches it, which is exactly when the
+ * serial sweep would have numbered it there, so the upper slab finds these nodes from the layer of cells below it
+ * and leaves them alone.
+ */
+class QuickSurfaceMeshCountImpl
+{
+    const int32_t* m_FeatureIds;
+    const int64_t* m_Dims;
+    QuickSurfaceMeshSlab_t* m_Slabs;
+    int64_t* m_NodeIds;
+
+  public:
+    QuickSurfaceMeshCountImpl(const int32_t* featureIds, const int64_t dims[3], QuickSurfaceMeshSlab_t* slabs, int64_t* nodeIds) :
+      m_FeatureIds(featureIds),
+      m_Dims(dims),
+      m_Slabs(slabs),
+      m_NodeIds(nodeIds)
+    {}
+    virtual ~QuickSurfaceMeshCountImpl() {}
+
+    void count(int64_t start, int64_t end) const
+    {
+      int64_t xP = m_Dims[0];
+      int64_t yP = m_Dims[1];
+      int64_t planeSize = (xP + 1) * (yP + 1);
+      int32_t faces[6] = { 0, 0, 0, 0, 0, 0 };
+      int64_t neighbors[6] = { 0, 0, 0, 0, 0, 0 };
+      for (int64_t s = start; s < end; s++)
+      {
+        QuickSurfaceMeshSlab_t& slab = m_Slabs[s];
+        bool shareLowestPlane = (slab.m_ZStart > 0);
+        if (shareLowestPlane == true)
+        {
+          slab.m_NodesFromBelow.assign(planeSize, 0);
+          int64_t k = slab.m_ZStart - 1;
+          for (int64_t j = 0; j < yP; j++)
+          {
+            for (int64_t i = 0; i < xP; i++)
+            {
+              int32_t numFaces = findCellFaces(m_FeatureIds, m_Dims, i, j, k, faces, neighbors);
+              for (int32_t f = 0; f < numFaces; f++)
+              {
+                const QuickSurfaceMeshFace_t& face = k_QuickSurfaceMeshFaces[faces[f]];
+                for (int32_t n = 0; n < 4; n++)
+                {
+                  if (face.m_Nodes[n][2] == 1) { slab.m_NodesFromBelow[(j + face.m_Nodes[n][1]) * (xP + 1) + i + face.m_Nodes[n][0]] = 1; }
+                }
+              }
+            }
+          }
+        }
+
+        int64_t nodeCount = 0;
+        int64_t triangleCount = 0;
+        for (int64_t k = slab.m_ZStart; k < slab.m_ZEnd; k++)
+        {
+          for (int64_t j = 0; j < yP; j++)
+          {
+            for (int64_t i = 0; i < xP; i++)
+            {
+              int32_t numFaces = findCellFaces(m_FeatureIds, m_Dims, i, j, k, faces, neighbors);
+              for (int32_t f = 0; f < numFaces; f++)
+              {
+                const QuickSurfaceMeshFace_t& face = k_QuickSurfaceMeshFaces[faces[f]];
+                for (int32_t n = 0; n < 4; n++)
+                {
+                  int64_t planeNode = (j + face.m_Nodes[n][1]) * (xP + 1) + i + face.m_Nodes[n][0];
+                  int64_t plane = k + face.m_Nodes[n][2];
+                  if (shareLowestPlane == true && plane == slab.m_ZStart && slab.m_NodesFromBelow[planeNode] == 1) { continue; }
+                  int64_t node = plane * planeSize + planeNode;
+                  if (m_NodeIds[node] == -1)
+                  {
+                    m_NodeIds[node] = nodeCount;
+                    nodeCount++;
+                  }
+                }
+                triangleCount += 2;
+              }
+            }
+          }
+        }
+        slab.m_NodeCount = nodeCount;
+        slab.m_TriangleCount = triangleCount;
+      }
+    }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+    void operator()(const tbb::blocked_range<int64_t>& r) const
+    {
+      count(r.begin(), r.end());
+    }
+#endif
+};
+
+/**
+ * @brief The QuickSurfaceMeshNodesImpl class shifts the node numbers of a range of slabs by the number of nodes of
+ * the slabs before them and places the nodes the slabs created
+ */
+class QuickSurfaceMeshNodesImpl
+{
+    const int64_t* m_Dims;
+    const QuickSurfaceMeshSlab_t* m_Slabs;
+    int64_t m_NumSlabs;
+    int64_t* m_NodeIds;
+    const float* m_Resolution;
+    const float* m_Origin;
+    float* m_Vertex;
+
+  public:
+    QuickSurfaceMeshNodesImpl(const int64_t dims[3], const QuickSurfaceMeshSlab_t* slabs, int64_t numSlabs, int64_t* nodeIds, const float resolution[3], const float origin[3], float* vertex) :
+      m_Dims(dims),
+      m_Slabs(slabs),
+      m_NumSlabs(numSlabs),
+      m_NodeIds(nodeIds),
+      m_Resolution(resolution),
+      m_Origin(origin),
+      m_Vertex(vertex)
+    {}
+    virtual ~QuickSurfaceMeshNodesImpl() {}
+
+    void place(int64_t start, int64_t end) const
+    {
+      int64_t xP = m_Dims[0];
+      int64_t yP = m_Dims[1];
+      int64_t planeSize = (xP + 1) * (yP + 1);
+      for (int64_t s = start; s < end; s++)
+      {
+        const QuickSurfaceMeshSlab_t& slab = m_Slabs[s];
+        const uint8_t* fromBelow = (slab.m_ZStart > 0) ? &(slab.m_NodesFromBelow.front()) : NULL;
+        const uint8_t* fromThisSlab = (s < m_NumSlabs - 1) ? &(m_Slabs[s + 1].m_NodesFromBelow.front()) : NULL;
+        for (int64_t k = slab.m_ZStart; k <= slab.m_ZEnd; k++)
+        {
+          for (int64_t planeNode = 0; planeNode < planeSize; planeNode++)
+          {
+            // the nodes of the lowest and highest planes that belong to the neighboring slabs
+            if (k == slab.m_ZStart && NULL != fromBelow && fromBelow[planeNode] == 1) { continue; }
+            if (k == slab.m_ZEnd && NULL != fromThisSlab && fromThisSlab[planeNode] == 0) { continue; }
+            int64_t node = k * planeSize + planeNode;
+            if (m_NodeIds[node] == -1) { continue; }
+            int64_t nodeId = m_NodeIds[node] + slab.m_FirstNode;
+            m_NodeIds[node] = nodeId;
+            int64_t j = planeNode / (xP + 1);
+            int64_t i = planeNode - j * (xP + 1);
+            QSM_GETCOORD(i, m_Resolution[0], m_Vertex[nodeId * 3 + 0], m_Origin[0]);
+            QSM_GETCOORD(j, m_Resolution[1], m_Vertex[nodeId * 3 + 1], m_Origin[1]);
+            QSM_GETCOORD(k, m_Resolution[2], m_Vertex[nodeId * 3 + 2], m_Origin[2]);
+          }
+        }
+      }
+    }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+    void operator()(const tbb::blocked_range<int64_t>& r) const
+    {
+      place(r.begin(), r.end());
+    }
+#endif
+};
+
+/**
+ * @brief The QuickSurfaceMeshTrianglesImpl class writes the triangles of every other slab, starting at a given slab,
+ * together with their Feature labels, the cells they separate and the owners of their nodes. Two neighboring slabs
+ * share the owners of the nodes on the plane between them, so the even and the odd slabs are meshed one after the
+ * other.
+ */
+class QuickSurfaceMeshTrianglesImpl
+{
+    const int32_t* m_FeatureIds;
+    const int64_t* m_Dims;
+    const QuickSurfaceMeshSlab_t* m_Slabs;
+    int64_t m_FirstSlab;
+    const int64_t* m_NodeIds;
+    int64_t* m_Triangles;
+    int32_t* m_FaceLabels;
+    int64_t* m_TriangleCells;
+    int32_t* m_Owners;
+    int8_t* m_OwnerCounts;
+    uint8_t* m_SurfaceNodes;
+
+  public:
+    QuickSurfaceMeshTrianglesImpl(const int32_t* featureIds, const int64_t dims[3], const QuickSurfaceMeshSlab_t* slabs, int64_t firstSlab, const int64_t* nodeIds, int64_t* triangles,
+                                  int32_t* faceLabels, int64_t* triangleCells, int32_t* owners, int8_t* ownerCounts, uint8_t* surfaceNodes) :
+      m_FeatureIds(featureIds),
+      m_Dims(dims),
+      m_Slabs(slabs),
+      m_FirstSlab(firstSlab),
+      m_NodeIds(nodeIds),
+      m_Triangles(triangles),
+      m_FaceLabels(faceLabels),
+      m_TriangleCells(triangleCells),
+      m_Owners(owners),
+      m_OwnerCounts(ownerCounts),
+      m_SurfaceNodes(surfaceNodes)
+    {}
+    virtual ~QuickSurfaceMeshTrianglesImpl() {}
+
+    void generate(int64_t start, int64_t end) const
+    {
+      int64_t xP = m_Dims[0];
+      int64_t yP = m_Dims[1];
+      int64_t planeSize = (xP + 1) * (yP + 1);
+      int32_t faces[6] = { 0, 0, 0, 0, 0, 0 };
+      int64_t neighbors[6] = { 0, 0, 0, 0, 0, 0 };
+      int64_t nodeIds[4] = { 0, 0, 0, 0 };
+      for (int64_t n = start; n < end; n++)
+      {
+        const QuickSurfaceMeshSlab_t& slab = m_Slabs[m_FirstSlab + 2 * n];
+        int64_t triangleIndex = slab.m_FirstTriangle;
+        for (int64_t k = slab.m_ZStart; k < slab.m_ZEnd; k++)
+        {
+          for (int64_t j = 0; j < yP; j++)
+          {
+            for (int64_t i = 0; i < xP; i++)
+            {
+              int64_t point = (k * xP * yP) + (j * xP) + i;
+              int32_t numFaces = findCellFaces(m_FeatureIds, m_Dims, i, j, k, faces, neighbors);
+              for (int32_t f = 0; f < numFaces; f++)
+              {
+                const QuickSurfaceMeshFace_t& face = k_QuickSurfaceMeshFaces[faces[f]];
+                for (int32_t c = 0; c < 4; c++)
+                {
+                  nodeIds[c] = m_NodeIds[(k + face.m_Nodes[c][2]) * planeSize + (j + face.m_Nodes[c][1]) * (xP + 1) + i + face.m_Nodes[c][0]];
+                }
+
+                // faces between two Features are labeled with the Feature across the face first
+                int64_t neighbor = neighbors[f];
+                int32_t firstLabel = (neighbor < 0) ? m_FeatureIds[point] : m_FeatureIds[neighbor];
+                int32_t secondLabel = (neighbor < 0) ? -1 : m_FeatureIds[point];
+                for (int32_t t = 0; t < 2; t++)
+                {
+                  for (int32_t c = 0; c < 3; c++)
+                  {
+                    m_Triangles[triangleIndex * 3 + c] = nodeIds[face.m_Triangles[t][c]];
+                  }
+                  m_FaceLabels[triangleIndex * 2] = firstLabel;
+                  m_FaceLabels[triangleIndex * 2 + 1] = secondLabel;
+                  if (NULL != m_TriangleCells)
+                  {
+                    m_TriangleCells[triangleIndex * 2] = (neighbor < 0) ? point : neighbor;
+                    m_TriangleCells[triangleIndex * 2 + 1] = (neighbor < 0) ? -1 : point;
+                  }
+                  triangleIndex++;
+                }
+
+                for (int32_t c = 0; c < 4; c++)
+                {
+                  addNodeOwner(m_Owners, m_OwnerCounts, m_SurfaceNodes, nodeIds[c], firstLabel);
+                  addNodeOwner(m_Owners, m_OwnerCounts, m_SurfaceNodes, nodeIds[c], secondLabel);
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+    void operator()(const tbb::blocked_range<int64_t>& r) const
+    {
+      generate(r.begin(), r.end());
+    }
+#endif
+};
+
+/**
+ * @class QuickSurfaceMesher QuickSurfaceMesher.hpp SurfaceMeshing/SurfaceMeshingFilters/util/QuickSurfaceMesher.hpp
+ * @brief Meshes the boundaries between the Features of an image volume for QuickSurfaceMesh.
+ *
+ * The volume is split into z slabs of whole cell layers that are meshed in parallel when available. The mesh,
+ * including the numbering of its nodes and triangles, does not depend on the number of slabs. The mesher is used
+ * in four steps: countNodesAndTriangles(), then placeNodes() and generateTriangles() into arrays sized from the
+ * counts, then findNodeTypes().
+ */
+class QuickSurfaceMesher
+{
+  public:
+    /**
+     * @brief QuickSurfaceMesher
+     * @param featureIds Feature Id of each cell
+     * @param dims Number of cells along x, y and z
+     * @param numSlabs Number of z slabs to mesh; clamped to [1, dims[2]]
+     */
+    QuickSurfaceMesher(const int32_t* featureIds, const int64_t dims[3], int64_t numSlabs) :
+      m_FeatureIds(featureIds),
+      m_NodeCount(0),
+      m_TriangleCount(0)
+    {
+      for (int32_t d = 0; d < 3; d++) { m_Dims[d] = dims[d]; }
+      numSlabs = std::max<int64_t>(1, std::min<int64_t>(numSlabs, m_Dims[2]));
+      m_Slabs.resize(numSlabs);
+      for (int64_t s = 0; s < numSlabs; s++)
+      {
+        m_Slabs[s].m_ZStart = (s * m_Dims[2]) / numSlabs;
+        m_Slabs[s].m_ZEnd = ((s + 1) * m_Dims[2]) / numSlabs;
+      }
+    }
+
+    virtual ~QuickSurfaceMesher() {}
+
+    /**
+     * @brief DefaultNumberOfSlabs Returns the number of slabs QuickSurfaceMesh meshes a volume in: a few per thread
+     * so the slabs even out, or a single slab without parallel algorithms
+     * @param zP Number of cell layers of the volume
+     * @return Number of slabs
+     */
+    static int64_t DefaultNumberOfSlabs(int64_t zP)
+    {
+      int64_t numSlabs = 1;
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+      numSlabs = 4 * tbb::task_scheduler_init::default_num_threads();
+#endif
+      return std::max<int64_t>(1, std::min<int64_t>(zP, numSlabs));
+    }
+
+    int64_t getNumberOfSlabs() const { return static_cast<int64_t>(m_Slabs.size()); }
+    int64_t getNodeCount() const { return m_NodeCount; }
+    int64_t getTriangleCount() const { return m_TriangleCount; }
+
+    /**
+     * @brief countNodesAndTriangles Determines which nodes are boundary nodes, numbers them and counts the nodes
+     * and triangles of the mesh
+     */
+    void countNodesAndTriangles()
+    {
+      int64_t numSlabs = getNumberOfSlabs();
+      m_NodeIds.assign((m_Dims[0] + 1) * (m_Dims[1] + 1) * (m_Dims[2] + 1), -1);
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+      tbb::task_scheduler_init init;
+      bool doParallel = true;
+      if (doParallel == true)
+      {
+        tbb::parallel_for(tbb::blocked_range<int64_t>(0, numSlabs, 1), QuickSurfaceMeshCountImpl(m_FeatureIds, m_Dims, &(m_Slabs.front()), &(m_NodeIds.front())), tbb::auto_partitioner());
+      }
+      else
+#endif
+      {
+        QuickSurfaceMeshCountImpl serial(m_FeatureIds, m_Dims, &(m_Slabs.front()), &(m_NodeIds.front()));
+        serial.count(0, numSlabs);
+      }
+
+      m_NodeCount = 0;
+      m_TriangleCount = 0;
+      for (int64_t s = 0; s < numSlabs; s++)
+      {
+        m_Slabs[s].m_FirstNode = m_NodeCount;
+        m_Slabs[s].m_FirstTriangle = m_TriangleCount;
+        m_NodeCount += m_Slabs[s].m_NodeCount;
+        m_TriangleCount += m_Slabs[s].m_TriangleCount;
+      }
+    }
+
+    /**
+     * @brief placeNodes Assigns the final number of each node and writes its coordinates
+     * @param resolution Cell size along x, y and z
+     * @param origin Origin of the volume
+     * @param vertex Coordinates of the nodes, 3 * getNodeCount() values
+     */
+    void placeNodes(const float resolution[3], const float origin[3], float* vertex)
+    {
+      int64_t numSlabs = getNumberOfSlabs();
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+      tbb::task_scheduler_init init;
+      bool doParallel = true;
+      if (doParallel == true)
+      {
+        tbb::parallel_for(tbb::blocked_range<int64_t>(0, numSlabs, 1), QuickSurfaceMeshNodesImpl(m_Dims, &(m_Slabs.front()), numSlabs, &(m_NodeIds.front()), resolution, origin, vertex), tbb::auto_partitioner());
+      }
+      else
+#endif
+      {
+        QuickSurfaceMeshNodesImpl serial(m_Dims, &(m_Slabs.front()), numSlabs, &(m_NodeIds.front()), resolution, origin, vertex);
+        serial.place(0, numSlabs);
+      }
+    }
+
+    /**
+     * @brief generateTriangles Writes the triangles with their Feature labels and collects the owners of the nodes.
+     * Must follow placeNodes()
+     * @param triangles Node Ids of the triangles, 3 * getTriangleCount() values
+     * @param faceLabels Feature labels of the triangles, 2 * getTriangleCount() values
+     * @param triangleCells Cells on both sides of the triangles, 2 * getTriangleCount() values, or NULL when not needed
+     */
+    void generateTriangles(int64_t* triangles, int32_t* faceLabels, int64_t* triangleCells)
+    {
+      int64_t numSlabs = getNumberOfSlabs();
+      // only the first four distinct Features of a node matter to its type, so they are kept inline per node
+      m_Owners.assign(4 * m_NodeCount + 4, 0);
+      m_OwnerCounts.assign(m_NodeCount + 1, 0);
+      m_SurfaceNodes.assign(m_NodeCount + 1, 0);
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+      tbb::task_scheduler_init init;
+      bool doParallel = true;
+#endif
+      // the even slabs first and then the odd ones, so neighboring slabs never add owners to the same nodes at once
+      for (int64_t firstSlab = 0; firstSlab < 2 && firstSlab < numSlabs; firstSlab++)
+      {
+        int64_t numRoundSlabs = (numSlabs - firstSlab + 1) / 2;
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+        if (doParallel == true)
+        {
+          tbb::parallel_for(tbb::blocked_range<int64_t>(0, numRoundSlabs, 1),
+                            QuickSurfaceMeshTrianglesImpl(m_FeatureIds, m_Dims, &(m_Slabs.front()), firstSlab, &(m_NodeIds.front()), triangles, faceLabels, triangleCells,
+                                                          &(m_Owners.front()), &(m_OwnerCounts.front()), &(m_SurfaceNodes.front())), tbb::auto_partitioner());
+        }
+        else
+#endif
+        {
+          QuickSurfaceMeshTrianglesImpl serial(m_FeatureIds, m_Dims, &(m_Slabs.front()), firstSlab, &(m_NodeIds.front()), triangles, faceLabels, triangleCells,
+                                               &(m_Owners.front()), &(m_OwnerCounts.front()), &(m_SurfaceNodes.front()));
+          serial.generate(0, numRoundSlabs);
+        }
+      }
+    }
+
+    /**
+     * @brief findNodeTypes Writes the type of each node: the number of Features that share it, counting the
+     * surface of the volume as one and capped at 4, plus 10 for nodes on the surface. Must follow generateTriangles()
+     * @param nodeTypes Type of each node, getNodeCount() values
+     */
+    void findNodeTypes(int8_t* nodeTypes) const
+    {
+      for (int64_t i = 0; i < m_NodeCount; i++)
+      {
+        nodeTypes[i] = m_OwnerCounts[i] + m_SurfaceNodes[i];
+        if (nodeTypes[i] > 4) { nodeTypes[i] = 4; }
+        if (m_SurfaceNodes[i] == 1) { nodeTypes[i] += 10; }
+      }
+    }
+
+  private:
+    const int32_t* m_FeatureIds;
+    int64_t m_Dims[3];
+    std::vector<QuickSurfaceMeshSlab_t> m_Slabs;
+    std::vector<int64_t> m_NodeIds;
+    int64_t m_NodeCount;
+    int64_t m_TriangleCount;
+    std::vector<int32_t> m_Owners;
+    std::vector<int8_t> m_OwnerCounts;
+    std::vector<uint8_t> m_SurfaceNodes;
+
+    QuickSurfaceMesher(const QuickSurfaceMesher&); // Copy Constructor Not Implemented
+    void operator=(const QuickSurfaceMesher&); // Operator '=' Not Implemented
+};
+
+#endif /* _quicksurfacemesher_hpp_ */
@@ -0,0 +1,405 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <vector>
+
+#include "SurfaceMeshing/SurfaceMeshingFilters/util/QuickSurfaceMesher.hpp"
+
+/**
+ * @brief The QuickSurfaceMesh_t struct holds everything QuickSurfaceMesher writes for one volume
+ */
+typedef struct
+{
+  int64_t m_NumSlabs;
+  std::vector<float> m_Vertex;
+  std::vector<int64_t> m_Triangles;
+  std::vector<int32_t> m_FaceLabels;
+  std::vector<int64_t> m_TriangleCells;
+  std::vector<int8_t> m_NodeTypes;
+} QuickSurfaceMesh_t;
+
+class QuickSurfaceMeshTest
+{
+  public:
+    QuickSurfaceMeshTest(){}
+    virtual ~QuickSurfaceMeshTest(){}
+
+    // -----------------------------------------------------------------------------
+    // Meshes a volume the way QuickSurfaceMesh does, with unit cells at the origin
+    // -----------------------------------------------------------------------------
+    void meshVolume(const std::vector<int32_t>& featureIds, const int64_t dims[3], int64_t numSlabs, QuickSurfaceMesh_t& mesh)
+    {
+      QuickSurfaceMesher mesher(&(featureIds.front()), dims, numSlabs);
+      mesher.countNodesAndTriangles();
+      int64_t nodeCount = mesher.getNodeCount();
+      int64_t triangleCount = mesher.getTriangleCount();
+
+      mesh.m_NumSlabs = mesher.getNumberOfSlabs();
+      mesh.m_Vertex.assign(3 * nodeCount + 3, -1.0f);
+      mesh.m_Triangles.assign(3 * triangleCount + 3, -2);
+      mesh.m_FaceLabels.assign(2 * triangleCount + 2, -2);
+      mesh.m_TriangleCells.assign(2 * triangleCount + 2, -2);
+      mesh.m_NodeTypes.assign(nodeCount + 1, -1);
+
+      float resolution[3] = { 1.0f, 1.0f, 1.0f };
+      float origin[3] = { 0.0f, 0.0f, 0.0f };
+      mesher.placeNodes(resolution, origin, &(mesh.m_Vertex.front()));
+      mesher.generateTriangles(&(mesh.m_Triangles.front()), &(mesh.m_FaceLabels.front()), &(mesh.m_TriangleCells.front()));
+      mesher.findNodeTypes(&(mesh.m_NodeTypes.front()));
+
+      mesh.m_Vertex.resize(3 * nodeCount);
+      mesh.m_Triangles.resize(3 * triangleCount);
+      mesh.m_FaceLabels.resize(2 * triangleCount);
+      mesh.m_TriangleCells.resize(2 * triangleCount);
+      mesh.m_NodeTypes.resize(nodeCount);
+    }
+
+    // -----------------------------------------------------------------------------
+    // Returns the cell at the given coordinates, or -1 outside the volume
+    // -----------------------------------------------------------------------------
+    int64_t cellAt(const int64_t dims[3], int64_t i, int64_t j, int64_t k)
+    {
+      if (i < 0 || j < 0 || k < 0 || i >= dims[0] || j >= dims[1] || k >= dims[2]) { return -1; }
+      return (k * dims[0] * dims[1]) + (j * dims[0]) + i;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Checks a mesh against the volume cell by cell: every quad between two Features or on the surface is two
+    // triangles, every node is a distinct lattice point, every triangle faces the Feature of its first label and
+    // every node type counts the Features of the cells around the node
+    // -----------------------------------------------------------------------------
+    void checkMesh(const std::vector<int32_t>& featureIds, const int64_t dims[3], const QuickSurfaceMesh_t& mesh)
+    {
+      int64_t nodeCount = static_cast<int64_t>(mesh.m_NodeTypes.size());
+      int64_t triangleCount = static_cast<int64_t>(mesh.m_FaceLabels.size()) / 2;
+
+      // the quads of the volume and the lattice points they reach
+      int64_t expectedTriangles = 0;
+      std::set<int64_t> expectedNodes;
+      for (int64_t k = 0; k < dims[2]; k++)
+      {
+        for (int64_t j = 0; j < dims[1]; j++)
+        {
+          for (int64_t i = 0; i < dims[0]; i++)
+          {
+            int64_t point = cellAt(dims, i, j, k);
+            for (int32_t d = 0; d < 3; d++)
+            {
+              for (int32_t side = 0; side < 2; side++)
+              {
+                int64_t coords[3] = { i, j, k };
+                coords[d] += (side == 0) ? -1 : 1;
+                int64_t neighbor = cellAt(dims, coords[0], coords[1], coords[2]);
+                // faces between two Features are counted from the cell below them
+                if (neighbor >= 0 && (side == 0 || featureIds[neighbor] == featureIds[point])) { continue; }
+                expectedTriangles += 2;
+                for (int32_t c = 0; c < 4; c++)
+                {
+                  int64_t node[3] = { i, j, k };
+                  node[d] += side;
+                  node[(d + 1) % 3] += c % 2;
+                  node[(d + 2) % 3] += c / 2;
+                  expectedNodes.insert((node[2] * (dims[1] + 1) + node[1]) * (dims[0] + 1) + node[0]);
+                }
+              }
+            }
+          }
+        }
+      }
+      DREAM3D_REQUIRE_EQUAL(triangleCount, expectedTriangles)
+      DREAM3D_REQUIRE_EQUAL(nodeCount, static_cast<int64_t>(expectedNodes.size()))
+
+      std::set<int64_t> nodes;
+      for (int64_t n = 0; n < nodeCount; n++)
+      {
+        int64_t node[3] = { 0, 0, 0 };
+        for (int32_t d = 0; d < 3; d++)
+        {
+          node[d] = static_cast<int64_t>(mesh.m_Vertex[3 * n + d]);
+          DREAM3D_REQUIRE_EQUAL(mesh.m_Vertex[3 * n + d], static_cast<float>(node[d]))
+        }
+        int64_t latticePoint = (node[2] * (dims[1] + 1) + node[1]) * (dims[0] + 1) + node[0];
+        DREAM3D_REQUIRE(expectedNodes.count(latticePoint) == 1)
+        nodes.insert(latticePoint);
+
+        // the Features of the cells around the node, with the surface of the volume counted as one more
+        std::set<int32_t> features;
+        bool surface = false;
+        for (int32_t c = 0; c < 8; c++)
+        {
+          int64_t cell = cellAt(dims, node[0] - 1 + (c & 1), node[1] - 1 + ((c >> 1) & 1), node[2] - 1 + ((c >> 2) & 1));
+          if (cell < 0) { surface = true; }
+          else { features.insert(featureIds[cell]); }
+        }
+        int32_t expectedType = std::min<int32_t>(static_cast<int32_t>(features.size()) + (surface ? 1 : 0), 4) + (surface ? 10 : 0);
+        DREAM3D_REQUIRE_EQUAL(static_cast<int32_t>(mesh.m_NodeTypes[n]), expectedType)
+      }
+      DREAM3D_REQUIRE_EQUAL(static_cast<int64_t>(nodes.size()), nodeCount)
+
+      for (int64_t t = 0; t < triangleCount; t++)
+      {
+        float p[3][3];
+        for (int32_t c = 0; c < 3; c++)
+        {
+          int64_t node = mesh.m_Triangles[3 * t + c];
+          DREAM3D_REQUIRE(node >= 0 && node < nodeCount)
+          for (int32_t d = 0; d < 3; d++) { p[c][d] = mesh.m_Vertex[3 * node + d]; }
+        }
+        float u[3] = { p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2] };
+        float v[3] = { p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2] };
+        float normal[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+        float length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        DREAM3D_REQUIRE(length > 0.5f)
+
+        // the triangle faces into the cell of its first label; the cell behind it has the second label
+        int64_t front[3] = { 0, 0, 0 };
+        int64_t back[3] = { 0, 0, 0 };
+        for (int32_t d = 0; d < 3; d++)
+        {
+          float centroid = (p[0][d] + p[1][d] + p[2][d]) / 3.0f;
+          front[d] = static_cast<int64_t>(floorf(centroid + 0.5f * normal[d] / length));
+          back[d] = static_cast<int64_t>(floorf(centroid - 0.5f * normal[d] / length));
+        }
+        int64_t frontCell = cellAt(dims, front[0], front[1], front[2]);
+        int64_t backCell = cellAt(dims, back[0], back[1], back[2]);
+        DREAM3D_REQUIRE(frontCell >= 0)
+        DREAM3D_REQUIRE_EQUAL(mesh.m_FaceLabels[2 * t], featureIds[frontCell])
+        DREAM3D_REQUIRE_EQUAL(mesh.m_TriangleCells[2 * t], frontCell)
+        DREAM3D_REQUIRE_EQUAL(mesh.m_TriangleCells[2 * t + 1], backCell)
+        if (backCell < 0)
+        {
+          DREAM3D_REQUIRE_EQUAL(mesh.m_FaceLabels[2 * t + 1], -1)
+        }
+        else
+        {
+          DREAM3D_REQUIRE_EQUAL(mesh.m_FaceLabels[2 * t + 1], featureIds[backCell])
+          DREAM3D_REQUIRE(featureIds[backCell] != featureIds[frontCell])
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void requireSameMesh(const QuickSurfaceMesh_t& mesh, const QuickSurfaceMesh_t& expected)
+    {
+      DREAM3D_REQUIRE(mesh.m_Vertex == expected.m_Vertex)
+      DREAM3D_REQUIRE(mesh.m_Triangles == expected.m_Triangles)
+      DREAM3D_REQUIRE(mesh.m_FaceLabels == expected.m_FaceLabels)
+      DREAM3D_REQUIRE(mesh.m_TriangleCells == expected.m_TriangleCells)
+      DREAM3D_REQUIRE(mesh.m_NodeTypes == expected.m_NodeTypes)
+    }
+
+    // -----------------------------------------------------------------------------
+    // Blocks of 2 x 2 x 2 cells of Features 1 to numFeatures, with single cells of other Features sprinkled in
+    // -----------------------------------------------------------------------------
+    std::vector<int32_t> makeVolume(const int64_t dims[3], int32_t numFeatures, uint32_t seed)
+    {
+      std::vector<int32_t> featureIds(dims[0] * dims[1] * dims[2], 0);
+      for (int64_t k = 0; k < dims[2]; k++)
+      {
+        for (int64_t j = 0; j < dims[1]; j++)
+        {
+          for (int64_t i = 0; i < dims[0]; i++)
+          {
+            uint32_t block = seed + static_cast<uint32_t>(((k / 2) * 31 + (j / 2)) * 17 + (i / 2));
+            block = block * 1103515245u + 12345u;
+            uint32_t cell = seed + static_cast<uint32_t>((k * dims[1] + j) * dims[0] + i);
+            cell = (cell * 2654435761u) >> 7;
+            uint32_t feature = (cell % 5 == 0) ? cell : (block >> 16);
+            featureIds[cellAt(dims, i, j, k)] = 1 + static_cast<int32_t>(feature % static_cast<uint32_t>(numFeatures));
+          }
+        }
+      }
+      return featureIds;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestTwoCells()
+    {
+      int64_t dims[3] = { 2, 1, 1 };
+      std::vector<int32_t> featureIds(2, 1);
+      featureIds[1] = 2;
+
+      QuickSurfaceMesh_t mesh;
+      meshVolume(featureIds, dims, 1, mesh);
+      DREAM3D_REQUIRE_EQUAL(mesh.m_NodeTypes.size(), 12)
+      DREAM3D_REQUIRE_EQUAL(mesh.m_FaceLabels.size(), 2 * 22)
+      checkMesh(featureIds, dims, mesh);
+
+      // the four nodes on the plane between the cells are shared by both Features and the surface
+      int32_t sharedNodes = 0;
+      for (size_t n = 0; n < mesh.m_NodeTypes.size(); n++)
+      {
+        if (mesh.m_Vertex[3 * n] == 1.0f)
+        {
+          DREAM3D_REQUIRE_EQUAL(mesh.m_NodeTypes[n], 13)
+          sharedNodes++;
+        }
+        else
+        {
+          DREAM3D_REQUIRE_EQUAL(mesh.m_NodeTypes[n], 12)
+        }
+      }
+      DREAM3D_REQUIRE_EQUAL(sharedNodes, 4)
+
+      // the face between the cells is labeled with the Feature across it first and faces +x
+      int32_t innerTriangles = 0;
+      for (size_t t = 0; t < mesh.m_FaceLabels.size() / 2; t++)
+      {
+        if (mesh.m_FaceLabels[2 * t + 1] == -1) { continue; }
+        DREAM3D_REQUIRE_EQUAL(mesh.m_FaceLabels[2 * t], 2)
+        DREAM3D_REQUIRE_EQUAL(mesh.m_FaceLabels[2 * t + 1], 1)
+        innerTriangles++;
+      }
+      DREAM3D_REQUIRE_EQUAL(innerTriangles, 2)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestManyFeatureNode()
+    {
+      // eight Features meet at the center node, more than the four owner slots of a node hold
+      int64_t dims[3] = { 2, 2, 2 };
+      std::vector<int32_t> featureIds(8, 0);
+      for (int32_t i = 0; i < 8; i++) { featureIds[i] = i + 1; }
+
+      QuickSurfaceMesh_t expected;
+      meshVolume(featureIds, dims, 1, expected);
+      checkMesh(featureIds, dims, expected);
+
+      int32_t centerNodes = 0;
+      for (size_t n = 0; n < expected.m_NodeTypes.size(); n++)
+      {
+        if (expected.m_Vertex[3 * n] == 1.0f && expected.m_Vertex[3 * n + 1] == 1.0f && expected.m_Vertex[3 * n + 2] == 1.0f)
+        {
+          DREAM3D_REQUIRE_EQUAL(expected.m_NodeTypes[n], 4)
+          centerNodes++;
+        }
+      }
+      DREAM3D_REQUIRE_EQUAL(centerNodes, 1)
+
+      // the center node lies on the plane between the two slabs, whose owners are added in different rounds
+      QuickSurfaceMesh_t mesh;
+      meshVolume(featureIds, dims, 2, mesh);
+      DREAM3D_REQUIRE_EQUAL(mesh.m_NumSlabs, 2)
+      requireSameMesh(mesh, expected);
+
+      // five Features around one node in a larger volume
+      int64_t largeDims[3] = { 4, 3, 4 };
+      std::vector<int32_t> largeIds(4 * 3 * 4, 9);
+      int32_t aroundNode[8] = { 1, 2, 3, 4, 5, 5, 5, 5 };
+      for (int32_t c = 0; c < 8; c++) { largeIds[cellAt(largeDims, 1 + (c & 1), (c >> 1) & 1, 1 + ((c >> 2) & 1))] = aroundNode[c]; }
+      meshVolume(largeIds, largeDims, 1, expected);
+      checkMesh(largeIds, largeDims, expected);
+      for (int64_t numSlabs = 2; numSlabs <= 4; numSlabs++)
+      {
+        meshVolume(largeIds, largeDims, numSlabs, mesh);
+        requireSameMesh(mesh, expected);
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestSlabs()
+    {
+      int64_t dims[3] = { 6, 5, 9 };
+      for (uint32_t seed = 0; seed < 20; seed++)
+      {
+        std::vector<int32_t> featureIds = makeVolume(dims, 2 + seed % 5, seed);
+        QuickSurfaceMesh_t expected;
+        meshVolume(featureIds, dims, 1, expected);
+        DREAM3D_REQUIRE_EQUAL(expected.m_NumSlabs, 1)
+        checkMesh(featureIds, dims, expected);
+
+        int64_t slabCounts[4] = { 2, 3, 4, 9 };
+        for (int32_t s = 0; s < 4; s++)
+        {
+          QuickSurfaceMesh_t mesh;
+          meshVolume(featureIds, dims, slabCounts[s], mesh);
+          DREAM3D_REQUIRE_EQUAL(mesh.m_NumSlabs, slabCounts[s])
+          requireSameMesh(mesh, expected);
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestFewerLayersThanSlabs()
+    {
+      int64_t layers[3] = { 1, 2, 3 };
+      for (int32_t l = 0; l < 3; l++)
+      {
+        int64_t dims[3] = { 5, 4, layers[l] };
+        std::vector<int32_t> featureIds = makeVolume(dims, 4, 7 + l);
+        QuickSurfaceMesh_t expected;
+        meshVolume(featureIds, dims, 1, expected);
+        checkMesh(featureIds, dims, expected);
+
+        // asking for more slabs than cell layers meshes one layer per slab
+        QuickSurfaceMesh_t mesh;
+        meshVolume(featureIds, dims, 8, mesh);
+        DREAM3D_REQUIRE_EQUAL(mesh.m_NumSlabs, layers[l])
+        requireSameMesh(mesh, expected);
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( TestTwoCells() )
+      DREAM3D_REGISTER_TEST( TestManyFeatureNode() )
+      DREAM3D_REGISTER_TEST( TestSlabs() )
+      DREAM3D_REGISTER_TEST( TestFewerLayersThanSlabs() )
+    }
+
+  private:
+    QuickSurfaceMeshTest(const QuickSurfaceMeshTest&); // Copy Constructor Not Implemented
+    void operator=(const QuickSurfaceMeshTest&); // Operator '=' Not Implemented
+};
@@ -0,0 +1,7 @@
+set(PLUGIN_NAME "SyntheticBuilding")
+set(${PLUGIN_NAME}Benchmarks_SOURCE_DIR ${${PLUGIN_NAME}_SOURCE_DIR}/Benchmarks)
+
+# The benchmarks only report timings, so they are built on request and never added to the tests
+add_executable(PackingMoveEvaluatorBenchmark ${${PLUGIN_NAME}Benchmarks_SOURCE_DIR}/PackingMoveEvaluatorBenchmark.cpp)
+target_link_libraries(PackingMoveEvaluatorBenchmark Qt5::Core SIMPLib ${TBB_LIBRARIES})
+SET_TARGET_PROPERTIES(PackingMoveEvaluatorBenchmark PROPERTIES FOLDER ${PLUGIN_NAME}Plugin)
@@ -0,0 +1,182 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include <QtCore/QDateTime>
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/task_scheduler_init.h>
+#endif
+
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PackingMoveEvaluator.hpp"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/SyntheticBuildingRandom.hpp"
+
+/**
+ * Reports the wall time of the batched move evaluation of PackPrimaryPhases against the number of threads.
+ *
+ * Usage: PackingMoveEvaluatorBenchmark [grid points per axis] [number of Features] [number of batches]
+ */
+
+// -----------------------------------------------------------------------------
+// Places numFeatures spherical footprints of random radius at random grid points
+// -----------------------------------------------------------------------------
+void makePacking(const int64_t packingPoints[3], bool periodic, size_t numFeatures, int64_t maxRadius, SyntheticBuildingRandom& rg,
+                 std::vector<PackingFootprint>& footprints, std::vector<int32_t>& featureOwners)
+{
+  footprints.assign(numFeatures, PackingFootprint());
+  featureOwners.assign(packingPoints[0] * packingPoints[1] * packingPoints[2], 0);
+  for (size_t f = 1; f < numFeatures; f++)
+  {
+    int64_t radius = 1 + static_cast<int64_t>(rg.genrand_res53() * maxRadius);
+    int64_t center[3] = { 0, 0, 0 };
+    for (int32_t d = 0; d < 3; d++)
+    {
+      center[d] = static_cast<int64_t>(rg.genrand_res53() * packingPoints[d]);
+    }
+    footprints[f].clear(center[0], center[1], center[2]);
+    for (int64_t i = -radius; i <= radius; i++)
+    {
+      for (int64_t j = -radius; j <= radius; j++)
+      {
+        for (int64_t k = -radius; k <= radius; k++)
+        {
+          if (i * i + j * j + k * k > radius * radius) { continue; }
+          footprints[f].addPoint(center[0] + i, center[1] + j, center[2] + k, false);
+          int64_t point[3] = { center[0] + i, center[1] + j, center[2] + k };
+          bool inside = true;
+          for (int32_t d = 0; d < 3; d++)
+          {
+            if (periodic == true && point[d] < 0) { point[d] += packingPoints[d]; }
+            if (periodic == true && point[d] >= packingPoints[d]) { point[d] -= packingPoints[d]; }
+            if (point[d] < 0 || point[d] >= packingPoints[d]) { inside = false; }
+          }
+          if (inside == true)
+          {
+            featureOwners[(packingPoints[0] * packingPoints[1] * point[2]) + (packingPoints[0] * point[1]) + point[0]]++;
+          }
+        }
+      }
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void randomMove(size_t numFeatures, int64_t maxShift, SyntheticBuildingRandom& rg, PackingMove_t& move)
+{
+  move.m_Feature = 1 + static_cast<int32_t>(rg.genrand_res53() * (numFeatures - 1));
+  for (int32_t d = 0; d < 3; d++)
+  {
+    move.m_Shift[d] = static_cast<int64_t>(rg.genrand_res53() * (2 * maxShift + 1)) - maxShift;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  int64_t gridSize = (argc > 1) ? atoi(argv[1]) : 128;
+  size_t numFeatures = (argc > 2) ? static_cast<size_t>(atoi(argv[2])) : 1000;
+  int32_t numBatches = (argc > 3) ? atoi(argv[3]) : 40;
+  if (gridSize < 8 || numFeatures < 2 || numBatches < 1)
+  {
+    printf("Usage: %s [grid points per axis >= 8] [number of Features >= 2] [number of batches >= 1]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  const int64_t packingPoints[3] = { gridSize, gridSize, gridSize };
+  const bool periodic = true;
+  SyntheticBuildingRandom rg(5489, SyntheticBuildingRandom::PackPrimaryPhasesPlacement, 3);
+  std::vector<PackingFootprint> footprints;
+  std::vector<int32_t> featureOwners;
+  makePacking(packingPoints, periodic, numFeatures, 6, rg, footprints, featureOwners);
+  PackingMoveEvaluator evaluator(packingPoints, periodic, footprints);
+
+  std::vector<PackingMove_t> moves(256);
+  std::vector<int64_t> deltas;
+  std::vector<std::vector<int64_t> > cells;
+  int64_t reference = 0;
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+  int32_t maxThreads = tbb::task_scheduler_init::default_num_threads();
+#else
+  int32_t maxThreads = 1;
+#endif
+  printf("%lld^3 grid, %d Features, %d batches of %d moves\n", static_cast<long long>(gridSize), static_cast<int32_t>(numFeatures), numBatches, static_cast<int32_t>(moves.size()));
+  printf("threads  ms  speedup\n");
+  qint64 serialTime = 0;
+  for (int32_t threads = 1; threads <= maxThreads; threads *= 2)
+  {
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+    tbb::task_scheduler_init init(threads);
+#endif
+    // every thread count evaluates the same moves
+    SyntheticBuildingRandom moveRg(5489, SyntheticBuildingRandom::PackPrimaryPhasesPlacement, 4);
+    int64_t checksum = 0;
+    qint64 start = QDateTime::currentMSecsSinceEpoch();
+    for (int32_t batch = 0; batch < numBatches; batch++)
+    {
+      for (size_t m = 0; m < moves.size(); m++)
+      {
+        randomMove(numFeatures, 4, moveRg, moves[m]);
+      }
+      evaluator.evaluateMoves(&(featureOwners.front()), moves, deltas, cells);
+      for (size_t m = 0; m < deltas.size(); m++)
+      {
+        checksum += deltas[m];
+      }
+    }
+    qint64 elapsed = QDateTime::currentMSecsSinceEpoch() - start;
+    if (threads == 1)
+    {
+      serialTime = elapsed;
+      reference = checksum;
+    }
+    if (checksum != reference)
+    {
+      printf("The moves evaluated with %d threads differ from the serial evaluation\n", threads);
+      return EXIT_FAILURE;
+    }
+    printf("%7d  %lld  %.2f\n", threads, static_cast<long long>(elapsed), elapsed > 0 ? double(serialTime) / double(elapsed) : 0.0);
+  }
+  return EXIT_SUCCESS;
+}
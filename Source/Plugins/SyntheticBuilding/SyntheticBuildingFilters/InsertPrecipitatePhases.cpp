@@ -35,9 +35,12 @@
 
 #include "InsertPrecipitatePhases.h"
 
+#include <algorithm>
 #include <fstream>
+#include <map>
 
 #include <QtCore/QDir>
+#include <QtCore/QFile>
 
 #include "SIMPLib/Common/Constants.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
@@ -47,6 +50,7 @@
 #include "SIMPLib/FilterParameters/OutputFileFilterParameter.h"
 #include "SIMPLib/FilterParameters/LinkedBooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
+#include "SIMPLib/FilterParameters/IntFilterParameter.h"
 #include "SIMPLib/StatsData/PrecipitateStatsData.h"
 #include "SIMPLib/Utilities/SIMPLibRandom.h"
 #include "SIMPLib/Geometry/ImageGeom.h"
@@ -55,6 +59,9 @@
 
 #include "SyntheticBuilding/SyntheticBuildingConstants.h"
 #include "SyntheticBuilding/SyntheticBuildingVersion.h"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PeriodicBox.hpp"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/ShapeRunKernel.hpp"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/SyntheticBuildingRandom.hpp"
 
 // Include the MOC generated file for this class
 #include "moc_InsertPrecipitatePhases.cpp"
@@ -76,6 +83,12 @@ InsertPrecipitatePhases::InsertPrecipitatePhases() :
   m_PeriodicBoundaries(false),
   m_MatchRDF(false),
   m_WriteGoalAttributes(false),
+  m_UseFixedSeed(false),
+  m_RandomSeed(5489),
+  m_WriteCheckpoints(false),
+  m_CheckpointInterval(100000),
+  m_ResumeFromCheckpoint(false),
+  m_CheckpointFile(""),
   m_InputStatsArrayPath(SIMPL::Defaults::StatsGenerator, SIMPL::Defaults::CellEnsembleAttributeMatrixName, SIMPL::EnsembleData::Statistics),
   m_InputPhaseTypesArrayPath(SIMPL::Defaults::StatsGenerator, SIMPL::Defaults::CellEnsembleAttributeMatrixName, SIMPL::EnsembleData::PhaseTypes),
   m_InputShapeTypesArrayPath(SIMPL::Defaults::StatsGenerator, SIMPL::Defaults::CellEnsembleAttributeMatrixName, SIMPL::EnsembleData::ShapeTypes),
@@ -130,6 +143,14 @@ void InsertPrecipitatePhases::setupFilterParameters()
   parameters.push_back(SIMPL_NEW_BOOL_FP("Match Radial Distribution Function", MatchRDF, FilterParameter::Parameter, InsertPrecipitatePhases));
   QStringList linkedProps("MaskArrayPath");
   parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Use Mask", UseMask, FilterParameter::Parameter, InsertPrecipitatePhases, linkedProps));
+  QStringList seedProps("RandomSeed");
+  parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Use Fixed Random Seed", UseFixedSeed, FilterParameter::Parameter, InsertPrecipitatePhases, seedProps));
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Random Seed", RandomSeed, FilterParameter::Parameter, InsertPrecipitatePhases));
+  QStringList checkpointProps("CheckpointInterval");
+  parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Write Checkpoints", WriteCheckpoints, FilterParameter::Parameter, InsertPrecipitatePhases, checkpointProps));
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Checkpoint Interval (Iterations)", CheckpointInterval, FilterParameter::Parameter, InsertPrecipitatePhases));
+  parameters.push_back(SIMPL_NEW_BOOL_FP("Resume From Checkpoint", ResumeFromCheckpoint, FilterParameter::Parameter, InsertPrecipitatePhases));
+  parameters.push_back(SIMPL_NEW_OUTPUT_FILE_FP("Checkpoint File", CheckpointFile, FilterParameter::Parameter, InsertPrecipitatePhases, "*.ckpt", "Checkpoint File"));
   parameters.push_back(SeparatorFilterParameter::New("Cell Data", FilterParameter::RequiredArray));
   {
     DataArraySelectionFilterParameter::RequirementType req = DataArraySelectionFilterParameter::CreateRequirement(SIMPL::TypeNames::Int32, 1, SIMPL::AttributeMatrixType::Cell, SIMPL::GeometryType::ImageGeometry);
@@ -208,6 +229,12 @@ void InsertPrecipitatePhases::readFilterParameters(AbstractFilterParametersReade
   setFeatureIdsArrayPath(reader->readDataArrayPath("FeatureIdsArrayPath", getFeatureIdsArrayPath() ) );
   setMaskArrayPath(reader->readDataArrayPath("MaskArrayPath", getMaskArrayPath()));
   setPeriodicBoundaries(reader->readValue("PeriodicBoundaries", getPeriodicBoundaries()));
+  setUseFixedSeed( reader->readValue("UseFixedSeed", getUseFixedSeed()) );
+  setRandomSeed( reader->readValue("RandomSeed", getRandomSeed()) );
+  setWriteCheckpoints( reader->readValue("WriteCheckpoints", getWriteCheckpoints()) );
+  setCheckpointInterval( reader->readValue("CheckpointInterval", getCheckpointInterval()) );
+  setResumeFromCheckpoint( reader->readValue("ResumeFromCheckpoint", getResumeFromCheckpoint()) );
+  setCheckpointFile( reader->readString("CheckpointFile", getCheckpointFile()) );
   setMatchRDF(reader->readValue("MatchRDF", getMatchRDF()));
   setUseMask(reader->readValue("UseMask", getUseMask()));
   setHavePrecips(reader->readValue("HavePrecips", getHavePrecips()));
@@ -267,9 +294,7 @@ void InsertPrecipitatePhases::initialize()
   m_Neighbors = NULL;
   m_StatsDataArray = StatsDataArray::NullPointer();
 
-  m_ColumnList.clear();
-  m_RowList.clear();
-  m_PlaneList.clear();
+  m_Footprints.clear();
   m_PointsToAdd.clear();
   m_PointsToRemove.clear();
 
@@ -280,8 +305,8 @@ void InsertPrecipitatePhases::initialize()
   m_RdfTargetDist.clear();
   m_RdfCurrentDist.clear();
   m_RdfCurrentDistNorm.clear();
-  m_RandomCentroids.clear();
   m_RdfRandom.clear();
+  m_RdfGrid.clear();
   m_FeatureSizeDistStep.clear();
   m_GSizes.clear();
 
@@ -413,6 +438,27 @@ void InsertPrecipitatePhases::dataCheck()
     notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
   }
 
+  if ((m_WriteCheckpoints == true || m_ResumeFromCheckpoint == true) && getCheckpointFile().isEmpty() == true)
+  {
+    QString ss = QObject::tr("The Checkpoint file must be set");
+    setErrorCondition(-1);
+    notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+  }
+
+  if (m_WriteCheckpoints == true && m_CheckpointInterval <= 0)
+  {
+    QString ss = QObject::tr("The Checkpoint interval must be greater than 0");
+    setErrorCondition(-1);
+    notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+  }
+
+  if (m_ResumeFromCheckpoint == true && getCheckpointFile().isEmpty() == false && QFile::exists(getCheckpointFile()) == false)
+  {
+    QString ss = QObject::tr("The Checkpoint file %1 does not exist").arg(getCheckpointFile());
+    setErrorCondition(-1);
+    notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+  }
+
   getDataContainerArray()->validateNumberOfTuples<AbstractFilter>(this, cellDataArrayPaths);
   getDataContainerArray()->validateNumberOfTuples<AbstractFilter>(this, ensembleDataArrayPaths);
 }
@@ -594,8 +640,20 @@ void InsertPrecipitatePhases::place_precipitates(Int32ArrayType::Pointer exclusi
   }
 
   setErrorCondition(0);
-  m_Seed = QDateTime::currentMSecsSinceEpoch();
-  SIMPL_RANDOMNG_NEW_SEEDED(m_Seed);
+  m_Seed = SyntheticBuildingRandom::ResolveSeed(m_UseFixedSeed, m_RandomSeed);
+  // A resumed run regenerates the same precipitates from the seed stored in the checkpoint
+  PackingCheckpoint checkpoint;
+  if (m_ResumeFromCheckpoint == true)
+  {
+    if (checkpoint.readFile(m_CheckpointFile) < 0 || checkpoint.getValue("Seed", m_Seed) == false)
+    {
+      QString ss = QObject::tr("Could not read the Checkpoint file %1").arg(m_CheckpointFile);
+      setErrorCondition(-1);
+      notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+      return;
+    }
+  }
+  SyntheticBuildingRandom rg(m_Seed, SyntheticBuildingRandom::InsertPrecipitatePhasesPlacement);
 
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(m_FeatureIdsArrayPath.getDataContainerName());
 
@@ -739,9 +797,8 @@ void InsertPrecipitatePhases::place_precipitates(Int32ArrayType::Pointer exclusi
     while (curphasevol[j] < (factor * curphasetotalvol))
     {
       iter++;
-      m_Seed++;
       phase = m_PrecipitatePhases[j];
-      generate_precipitate(phase, &precip, m_ShapeTypes[phase], m_OrthoOps);
+      generate_precipitate(phase, &precip, m_ShapeTypes[phase], m_OrthoOps, currentnumfeatures, iter);
       m_CurrentSizeDistError = check_sizedisterror(&precip);
       change = (m_CurrentSizeDistError) - (m_OldSizeDistError);
       if (change > 0.0f || m_CurrentSizeDistError > (1.0f - (float(iter) * 0.001f)) || curphasevol[j] < (0.75f * factor * curphasetotalvol))
@@ -826,9 +883,7 @@ void InsertPrecipitatePhases::place_precipitates(Int32ArrayType::Pointer exclusi
   size_t numfeatures = m_FeaturePhasesPtr.lock()->getNumberOfTuples();
 
   // initial placement
-  m_ColumnList.resize(numfeatures);
-  m_RowList.resize(numfeatures);
-  m_PlaneList.resize(numfeatures);
+  m_Footprints.resize(numfeatures);
 
   int64_t boundaryVoxels = 0;
 
@@ -1108,6 +1163,7 @@ void InsertPrecipitatePhases::place_precipitates(Int32ArrayType::Pointer exclusi
   if (m_MatchRDF == true)
   {
     // calculate the initial current RDF - this will change as we move particles around
+    initialize_rdfCells();
     for (size_t i = size_t(m_FirstPrecipitateFeature); i < numfeatures; i++)
     {
       m_oldRDFerror = check_RDFerror(int32_t(i), -1000, false);
@@ -1125,12 +1181,29 @@ void InsertPrecipitatePhases::place_precipitates(Int32ArrayType::Pointer exclusi
       // The totalAdjustments are roughly equal to the prefactor (1000, right now) times the number of precipitates.
       // This is not based on convergence or any physics - it's just a factor and there's probably room for improvement here
       int32_t totalAdjustments = static_cast<int32_t>(1000 * ((numfeatures - m_FirstPrecipitateFeature) - 1));
-      for (int32_t iteration = 0; iteration < totalAdjustments; ++iteration)
+      int32_t startIteration = 0;
+      if (m_ResumeFromCheckpoint == true)
+      {
+        startIteration = restore_checkpoint(checkpoint, rg, availablePoints, availablePointsInv, acceptedmoves, exclusionZonesPtr);
+        if (getErrorCondition() < 0) { return; }
+        checkpoint.clear();
+      }
+      PackingCheckpointWriter checkpointWriter;
+      int32_t nextCheckpoint = startIteration + m_CheckpointInterval;
+      for (int32_t iteration = startIteration; iteration < totalAdjustments; ++iteration)
       {
         QString ss;
         ss = QObject::tr("Packing Features - Swapping/Moving/Adding/Removing Features Iteration %1/%2").arg(iteration).arg(totalAdjustments);
         if (iteration % 100 == 0) { notifyStatusMessage(getMessagePrefix(), getHumanLabel(), ss); }
 
+        if (m_WriteCheckpoints == true && (iteration >= nextCheckpoint || getCancel() == true))
+        {
+          write_checkpoint(checkpointWriter, iteration, acceptedmoves, rg, availablePoints, availablePointsInv);
+          nextCheckpoint = iteration + m_CheckpointInterval;
+        }
+
+        if (getCancel() == true) { return; }
+
         if (writeErrorFile == true && iteration % 25 == 0)
         {
           outFile << iteration << " " << m_oldRDFerror << " " << acceptedmoves << "\n";
@@ -1143,7 +1216,6 @@ void InsertPrecipitatePhases::place_precipitates(Int32ArrayType::Pointer exclusi
         {
           randomfeature = static_cast<int32_t>(numfeatures) - 1;
         }
-        m_Seed++;
 
         PrecipitateStatsData* pp = PrecipitateStatsData::SafePointerDownCast(statsDataArray[m_FeaturePhases[randomfeature]].get());
         if (NULL == pp)
@@ -1290,9 +1362,9 @@ void InsertPrecipitatePhases::place_precipitates(Int32ArrayType::Pointer exclusi
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void InsertPrecipitatePhases::generate_precipitate(int32_t phase, Precip_t* precip, uint32_t shapeclass, SpaceGroupOps::Pointer OrthoOps)
+void InsertPrecipitatePhases::generate_precipitate(int32_t phase, Precip_t* precip, uint32_t shapeclass, SpaceGroupOps::Pointer OrthoOps, int32_t featureId, size_t attempt)
 {
-  SIMPL_RANDOMNG_NEW_SEEDED(m_Seed)
+  SyntheticBuildingRandom rg(m_Seed, SyntheticBuildingRandom::InsertPrecipitatePhasesFeatures, static_cast<uint32_t>(featureId), static_cast<uint32_t>(attempt));
 
   StatsDataArray& statsDataArray = *(m_StatsDataArray.lock());
 
@@ -1369,7 +1441,7 @@ void InsertPrecipitatePhases::generate_precipitate(int32_t phase, Precip_t* prec
     totaldensity = totaldensity + density;
     if (random < totaldensity && random >= td1) { bin = j; break; }
   }
-  FOrientArrayType eulers = OrthoOps->determineEulerAngles(m_Seed, bin);
+  FOrientArrayType eulers = OrthoOps->determineEulerAngles(rg.genrand_int64(), bin);
   VectorOfFloatArray omega3 = pp->getFeatureSize_Omegas();
   float mf = omega3[0]->getValue(diameter);
   float s = omega3[1]->getValue(diameter);
@@ -1428,17 +1500,7 @@ void InsertPrecipitatePhases::move_precipitate(int32_t gnum, float xc, float yc,
   m_Centroids[3 * gnum] = xc;
   m_Centroids[3 * gnum + 1] = yc;
   m_Centroids[3 * gnum + 2] = zc;
-  size_t size = m_ColumnList[gnum].size();
-
-  for (size_t i = 0; i < size; i++)
-  {
-    int64_t& cl = m_ColumnList[gnum][i];
-    cl += shiftcolumn;
-    int64_t& rl = m_RowList[gnum][i];
-    rl += shiftrow;
-    int64_t& pl = m_PlaneList[gnum][i];
-    pl += shiftplane;
-  }
+  m_Footprints[gnum].translate(shiftcolumn, shiftrow, shiftplane);
 }
 
 // -----------------------------------------------------------------------------
@@ -1448,41 +1510,24 @@ void InsertPrecipitatePhases::update_exclusionZones(int32_t gadd, int32_t gremov
 {
   size_t featureOwnersIdx = 0;
   int32_t* exclusionZones = exclusionZonesPtr->getPointer(0);
-  int64_t col = 0, row = 0, plane = 0;
+  const int64_t points[3] = { m_XPoints, m_YPoints, m_ZPoints };
+  const int64_t noShift[3] = { 0, 0, 0 };
+  int64_t planeStride = m_XPoints * m_YPoints;
+  PackingFootprint::Segment_t segments[3];
+  int32_t numSegments = 0;
 
   if (gadd > 0)
   {
-    size_t size = m_ColumnList[gadd].size();
-    std::vector<int64_t>& cl = m_ColumnList[gadd];
-    std::vector<int64_t>& rl = m_RowList[gadd];
-    std::vector<int64_t>& pl = m_PlaneList[gadd];
-    for (size_t i = 0; i < size; i++)
+    const PackingFootprint& footprint = m_Footprints[gadd];
+    size_t numRuns = footprint.getNumberOfRuns();
+    for (size_t r = 0; r < numRuns; r++)
     {
-      col = cl[i];
-      row = rl[i];
-      plane = pl[i];
-      if (m_PeriodicBoundaries == true)
+      numSegments = footprint.getSegments(r, points, m_PeriodicBoundaries, noShift, segments);
+      for (int32_t s = 0; s < numSegments; s++)
       {
-        if (col < 0) { col = col + m_XPoints; }
-        if (col > m_XPoints - 1) { col = col - m_XPoints; }
-        if (row < 0) { row = row + m_YPoints; }
-        if (row > m_YPoints - 1) { row = row - m_YPoints; }
-        if (plane < 0) { plane = plane + m_ZPoints; }
-        if (plane > m_ZPoints - 1) { plane = plane - m_ZPoints; }
-        featureOwnersIdx = (m_XPoints * m_YPoints * plane) + (m_XPoints * row) + col;
-        if (exclusionZones[featureOwnersIdx] > 0) {  }
-        if (exclusionZones[featureOwnersIdx] == 0)
+        featureOwnersIdx = segments[s].m_Start;
+        for (int64_t i = 0; i < segments[s].m_Count; i++, featureOwnersIdx += planeStride)
         {
-          m_PointsToRemove.push_back(featureOwnersIdx);
-        }
-        exclusionZones[featureOwnersIdx]++;
-      }
-      else
-      {
-        if (col >= 0 && col < m_XPoints && row >= 0 && row < m_YPoints && plane >= 0 && plane < m_ZPoints)
-        {
-          featureOwnersIdx = (m_XPoints * m_YPoints * plane) + (m_XPoints * row) + col;
-          if (exclusionZones[featureOwnersIdx] > 0) {  }
           if (exclusionZones[featureOwnersIdx] == 0)
           {
             m_PointsToRemove.push_back(featureOwnersIdx);
@@ -1494,37 +1539,16 @@ void InsertPrecipitatePhases::update_exclusionZones(int32_t gadd, int32_t gremov
   }
   if (gremove > 0)
   {
-    size_t size = m_ColumnList[gremove].size();
-    std::vector<int64_t>& cl = m_ColumnList[gremove];
-    std::vector<int64_t>& rl = m_RowList[gremove];
-    std::vector<int64_t>& pl = m_PlaneList[gremove];
-    for (size_t i = 0; i < size; i++)
+    const PackingFootprint& footprint = m_Footprints[gremove];
+    size_t numRuns = footprint.getNumberOfRuns();
+    for (size_t r = 0; r < numRuns; r++)
     {
-      col = cl[i];
-      row = rl[i];
-      plane = pl[i];
-      if (m_PeriodicBoundaries == true)
+      numSegments = footprint.getSegments(r, points, m_PeriodicBoundaries, noShift, segments);
+      for (int32_t s = 0; s < numSegments; s++)
       {
-        if (col < 0) { col = col + m_XPoints; }
-        if (col > m_XPoints - 1) { col = col - m_XPoints; }
-        if (row < 0) { row = row + m_YPoints; }
-        if (row > m_YPoints - 1) { row = row - m_YPoints; }
-        if (plane < 0) { plane = plane + m_ZPoints; }
-        if (plane > m_ZPoints - 1) { plane = plane - m_ZPoints; }
-        featureOwnersIdx = (m_XPoints * m_YPoints * plane) + (m_XPoints * row) + col;
-        if (exclusionZones[featureOwnersIdx] > 1) { }
-        exclusionZones[featureOwnersIdx]--;
-        if (exclusionZones[featureOwnersIdx] == 0)
+        featureOwnersIdx = segments[s].m_Start;
+        for (int64_t i = 0; i < segments[s].m_Count; i++, featureOwnersIdx += planeStride)
         {
-          m_PointsToAdd.push_back(featureOwnersIdx);
-        }
-      }
-      else
-      {
-        if (col >= 0 && col < m_XPoints && row >= 0 && row < m_YPoints && plane >= 0 && plane < m_ZPoints)
-        {
-          featureOwnersIdx = (m_XPoints * m_YPoints * plane) + (m_XPoints * row) + col;
-          if (exclusionZones[featureOwnersIdx] > 1) { }
           exclusionZones[featureOwnersIdx]--;
           if (exclusionZones[featureOwnersIdx] == 0)
           {
@@ -1616,103 +1640,130 @@ void InsertPrecipitatePhases::update_availablepoints(std::map<size_t, size_t>& a
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void InsertPrecipitatePhases::determine_currentRDF(int32_t gnum, int32_t add, bool double_count)
+void InsertPrecipitatePhases::initialize_rdfCells()
 {
-  float x = 0.0f, y = 0.0f, z = 0.0f;
-  float xn = 0.0f, yn = 0.0f, zn = 0.0f;
-  float r = 0.0f;
-
-  size_t iter = 0;
-  int32_t numPPTfeatures = 1;
-  int32_t rdfBin = 0;
-
-  int32_t phase = m_FeaturePhases[gnum];
-  while (phase != m_PrecipitatePhases[iter]) { iter++; }
-
-  x = m_Centroids[3 * gnum];
-  y = m_Centroids[3 * gnum + 1];
-  z = m_Centroids[3 * gnum + 2];
   size_t numFeatures = m_FeaturePhasesPtr.lock()->getNumberOfTuples();
+  float size[3] = { m_SizeX, m_SizeY, m_SizeZ };
+  m_RdfGrid.initialize(m_Centroids, size_t(m_FirstPrecipitateFeature), numFeatures, size, m_rdfMin, m_rdfMax, m_StepSize, m_numRDFbins);
+}
 
-  for (size_t n = size_t(m_FirstPrecipitateFeature); n < numFeatures; n++)
-  {
-    if (m_FeaturePhases[n] == phase && n != gnum)
-    {
-      xn = m_Centroids[3 * n];
-      yn = m_Centroids[3 * n + 1];
-      zn = m_Centroids[3 * n + 2];
-      r = sqrtf((x - xn) * (x - xn) + (y - yn) * (y - yn) + (z - zn) * (z - zn));
-
-      rdfBin = (r - m_rdfMin) / m_StepSize;
-
-      if (r < m_rdfMin)
-      { rdfBin = -1;}
-      //if (r < 6.0)
-      //{
-      //  int stop = 0;
-      //}
-      //if (rdfBin >= m_numRDFbins) {rdfBin = m_numRDFbins;}
-      if (double_count == true)
-      {
-        m_RdfCurrentDist[rdfBin + 1] += 2 * add;
-      }
-      else if (double_count == false)
-      {
-        m_RdfCurrentDist[rdfBin + 1] += add;
-      }
-
-      numPPTfeatures += 1;
-    }
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void InsertPrecipitatePhases::write_checkpoint(PackingCheckpointWriter& checkpointWriter, int32_t iteration, int32_t acceptedmoves, const SyntheticBuildingRandom& rg,
+                                               const std::map<size_t, size_t>& availablePoints, const std::map<size_t, size_t>& availablePointsInv)
+{
+  size_t numFeatures = m_FeaturePhasesPtr.lock()->getNumberOfTuples();
+  uint64_t randomPosition = 0;
+  bool randomHaveNormal = false;
+  double randomNormal = 0.0;
+  rg.getState(randomPosition, randomHaveNormal, randomNormal);
+
+  PackingCheckpoint checkpoint;
+  checkpoint.setValue("Seed", m_Seed);
+  checkpoint.setValue("Iteration", iteration);
+  checkpoint.setValue("FirstPrecipitateFeature", m_FirstPrecipitateFeature);
+  checkpoint.setValue("AcceptedMoves", acceptedmoves);
+  checkpoint.setValue("RandomPosition", randomPosition);
+  checkpoint.setValue("RandomHaveNormal", randomHaveNormal);
+  checkpoint.setValue("RandomNormal", randomNormal);
+  checkpoint.setArray("Volumes", m_Volumes, numFeatures);
+  checkpoint.setArray("Centroids", m_Centroids, 3 * numFeatures);
+  checkpoint.setArray("RdfCurrentDist", m_RdfCurrentDist);
+  checkpoint.setArray("RdfCurrentDistNorm", m_RdfCurrentDistNorm);
+  checkpoint.setMap("AvailablePoints", availablePoints);
+  checkpoint.setMap("AvailablePointsInv", availablePointsInv);
+  checkpoint.setValue("AvailablePointsCount", static_cast<uint64_t>(m_AvailablePointsCount));
+  checkpoint.setValue("OldRDFError", m_oldRDFerror);
+
+  // the snapshot is handed to the writer, so the loop continues while the file is written
+  if (checkpointWriter.write(checkpoint, m_CheckpointFile) < 0)
+  {
+    QString ss = QObject::tr("Could not write the Checkpoint file %1").arg(m_CheckpointFile);
+    notifyWarningMessage(getHumanLabel(), ss, -1);
   }
-
-  m_RdfCurrentDistNorm = normalizeRDF(m_RdfCurrentDist, m_numRDFbins, m_StepSize, m_rdfMin, numPPTfeatures);
 }
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void InsertPrecipitatePhases::determine_randomRDF(size_t gnum, int32_t add, bool double_count, int32_t largeNumber)
+int32_t InsertPrecipitatePhases::restore_checkpoint(const PackingCheckpoint& checkpoint, SyntheticBuildingRandom& rg, std::map<size_t, size_t>& availablePoints,
+                                                    std::map<size_t, size_t>& availablePointsInv, int32_t& acceptedmoves, Int32ArrayType::Pointer exclusionZonesPtr)
 {
+  size_t numFeatures = m_FeaturePhasesPtr.lock()->getNumberOfTuples();
+  int32_t iteration = 0;
+  int32_t firstPrecipitateFeature = 0;
+  std::vector<float> volumes;
+  std::vector<float> centroids;
+  bool good = checkpoint.getValue("Iteration", iteration) && checkpoint.getValue("FirstPrecipitateFeature", firstPrecipitateFeature)
+              && checkpoint.getArray("Volumes", volumes) && checkpoint.getArray("Centroids", centroids);
+
+  // the precipitates are regenerated from the seed, so they must match the ones the checkpoint was taken with
+  if (good == true)
+  {
+    good = (firstPrecipitateFeature == m_FirstPrecipitateFeature && volumes.size() == numFeatures && centroids.size() == 3 * numFeatures);
+    for (size_t i = 0; i < volumes.size() && good == true; i++)
+    {
+      if (volumes[i] != m_Volumes[i]) { good = false; }
+    }
+  }
+  if (good == false)
+  {
+    QString ss = QObject::tr("The Checkpoint file %1 was written with different inputs and cannot be resumed").arg(m_CheckpointFile);
+    setErrorCondition(-1);
+    notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+    return 0;
+  }
 
-  float x = 0.0f, y = 0.0f, z = 0.0f;
-  float xn = 0.0f, yn = 0.0f, zn = 0.0f;
-  float r = 0.0f;
-
-  int32_t rdfBin = 0;
-
-  x = m_RandomCentroids[3 * gnum];
-  y = m_RandomCentroids[3 * gnum + 1];
-  z = m_RandomCentroids[3 * gnum + 2];
-
-  size_t ln = static_cast<size_t>(largeNumber);
+  // moving each precipitate back to its stored centroid also shifts its cell lists
+  for (size_t i = size_t(m_FirstPrecipitateFeature); i < numFeatures; i++)
+  {
+    move_precipitate(static_cast<int32_t>(i), centroids[3 * i], centroids[3 * i + 1], centroids[3 * i + 2]);
+  }
+  initialize_rdfCells();
 
+  // the exclusion zones still hold the initial placement, so stamp them again at the restored positions
+  exclusionZonesPtr->initializeWithZeros();
+  for (size_t i = size_t(m_FirstPrecipitateFeature); i < numFeatures; i++)
+  {
+    update_exclusionZones(static_cast<int32_t>(i), -1000, exclusionZonesPtr);
+  }
 
-  for (size_t n = 0; n < ln; n++)
+  uint64_t randomPosition = 0;
+  bool randomHaveNormal = false;
+  double randomNormal = 0.0;
+  uint64_t availablePointsCount = 0;
+  good = checkpoint.getValue("AcceptedMoves", acceptedmoves) && checkpoint.getValue("RandomPosition", randomPosition) && checkpoint.getValue("RandomHaveNormal", randomHaveNormal)
+         && checkpoint.getValue("RandomNormal", randomNormal) && checkpoint.getArray("RdfCurrentDist", m_RdfCurrentDist) && checkpoint.getArray("RdfCurrentDistNorm", m_RdfCurrentDistNorm)
+         && checkpoint.getMap("AvailablePoints", availablePoints) && checkpoint.getMap("AvailablePointsInv", availablePointsInv)
+         && checkpoint.getValue("AvailablePointsCount", availablePointsCount) && checkpoint.getValue("OldRDFError", m_oldRDFerror);
+  if (good == false)
   {
-    if (n != gnum)
-    {
-      xn = m_RandomCentroids[3 * n];
-      yn = m_RandomCentroids[3 * n + 1];
-      zn = m_RandomCentroids[3 * n + 2];
-      r = sqrtf((x - xn) * (x - xn) + (y - yn) * (y - yn) + (z - zn) * (z - zn));
+    QString ss = QObject::tr("The Checkpoint file %1 is incomplete").arg(m_CheckpointFile);
+    setErrorCondition(-1);
+    notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+    return 0;
+  }
+  m_AvailablePointsCount = static_cast<size_t>(availablePointsCount);
+  m_currentRDFerror = m_oldRDFerror;
+  m_PointsToRemove.clear();
+  m_PointsToAdd.clear();
+  rg.setState(randomPosition, randomHaveNormal, randomNormal);
 
-      rdfBin = (r - m_rdfMin) / m_StepSize;
+  QString ss = QObject::tr("Resuming the RDF matching at iteration %1").arg(iteration);
+  notifyStatusMessage(getMessagePrefix(), getHumanLabel(), ss);
+  return iteration;
+}
 
-      if (r < m_rdfMin)
-      {
-        rdfBin = -1;
-      }
-      if (double_count == true)
-      {
-        m_RdfRandom[rdfBin + 1] += 2 * add;
-      }
-      else if (double_count == false)
-      {
-        m_RdfRandom[rdfBin + 1] += add;
-      }
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void InsertPrecipitatePhases::determine_currentRDF(int32_t gnum, int32_t add, bool double_count)
+{
+  int32_t increment = (double_count == true) ? 2 * add : add;
+  int32_t numPPTfeatures = m_RdfGrid.accumulate(m_Centroids, m_FeaturePhases, gnum, increment, m_RdfCurrentDist);
 
-    }
-  }
+  m_RdfCurrentDistNorm = normalizeRDF(m_RdfCurrentDist, m_numRDFbins, m_StepSize, m_rdfMin, numPPTfeatures);
 }
 
 // -----------------------------------------------------------------------------
@@ -1944,14 +1995,11 @@ float InsertPrecipitatePhases::check_sizedisterror(Precip_t* precip)
 // -----------------------------------------------------------------------------
 void InsertPrecipitatePhases::insert_precipitate(size_t gnum)
 {
-  SIMPL_RANDOMNG_NEW()
-
   float inside = -1.0f;
   int64_t column = 0, row = 0, plane = 0;
   int64_t centercolumn = 0, centerrow = 0, centerplane = 0;
   int64_t xmin = 0, xmax = 0, ymin = 0, ymax = 0, zmin = 0, zmax = 0;
   float xc = 0.0f, yc = 0.0f, zc = 0.0f;
-  float coordsRotated[3] = { 0.0f, 0.0f, 0.0f };
   float coords[3] = { 0.0f, 0.0f, 0.0f };
   float volcur = m_Volumes[gnum];
   float bovera = m_AxisLengths[3 * gnum + 1];
@@ -2011,32 +2059,37 @@ void InsertPrecipitatePhases::insert_precipitate(size_t gnum)
   if (ymax > 2 * m_YPoints - 1) { ymax = (2 * m_YPoints - 1); }
   if (zmin < -m_ZPoints) { zmin = -m_ZPoints; }
   if (zmax > 2 * m_ZPoints - 1) { zmax = (2 * m_ZPoints - 1); }
+  m_Footprints[gnum].clear(centercolumn, centerrow, centerplane);
+  if (zmax < zmin) { return; }
+
+  // The shape function is evaluated a whole run of planes at a time
+  float oneOverRadcur[3] = { 1.0f / radcur1, 1.0f / radcur2, 1.0f / radcur3 };
+  ShapeRunKernel kernel(ga, oneOverRadcur);
+  size_t runLength = static_cast<size_t>(zmax - zmin + 1);
+  std::vector<float> planeCoords(runLength, 0.0f);
+  std::vector<float> runInside(runLength, 0.0f);
+  for (size_t i = 0; i < runLength; i++)
+  {
+    planeCoords[i] = float(zmin + int64_t(i)) * m_ZRes - zc;
+  }
+
   for (int64_t iter1 = xmin; iter1 < xmax + 1; iter1++)
   {
     for (int64_t iter2 = ymin; iter2 < ymax + 1; iter2++)
     {
+      column = iter1;
+      row = iter2;
+      coords[0] = float(column) * m_XRes - xc;
+      coords[1] = float(row) * m_YRes - yc;
+      kernel.setRun(2, coords);
+      kernel.evaluate(m_ShapeOps[shapeclass].get(), &(planeCoords.front()), runLength, &(runInside.front()));
       for (int64_t iter3 = zmin; iter3 < zmax + 1; iter3++)
       {
-        column = iter1;
-        row = iter2;
         plane = iter3;
-        coords[0] = float(column) * m_XRes;
-        coords[1] = float(row) * m_YRes;
-        coords[2] = float(plane) * m_ZRes;
-        inside = -1;
-        coords[0] = coords[0] - xc;
-        coords[1] = coords[1] - yc;
-        coords[2] = coords[2] - zc;
-        MatrixMath::Multiply3x3with3x1(ga, coords, coordsRotated);
-        float axis1comp = coordsRotated[0] / radcur1;
-        float axis2comp = coordsRotated[1] / radcur2;
-        float axis3comp = coordsRotated[2] / radcur3;
-        inside = m_ShapeOps[shapeclass]->inside(axis1comp, axis2comp, axis3comp);
+        inside = runInside[iter3 - zmin];
         if (inside >= 0)
         {
-          m_ColumnList[gnum].push_back(column);
-          m_RowList[gnum].push_back(row);
-          m_PlaneList[gnum].push_back(plane);
+          m_Footprints[gnum].addPoint(column, row, plane, true);
         }
       }
     }
@@ -2071,7 +2124,6 @@ void InsertPrecipitatePhases::assign_voxels()
   int64_t column = 0, row = 0, plane = 0;
   float inside = 0.0f;
   float xc = 0.0f, yc = 0.0f, zc = 0.0f;
-  float coordsRotated[3] = { 0.0f, 0.0f, 0.0f };
   float coords[3] = { 0.0f, 0.0f, 0.0f };
   int64_t xmin = 0, xmax = 0, ymin = 0, ymax = 0, zmin = 0, zmax = 0;
   size_t numFeatures = m_FeaturePhasesPtr.lock()->getNumberOfTuples();
@@ -2142,52 +2194,56 @@ void InsertPrecipitatePhases::assign_voxels()
       if (zmin < 0) { zmin = 0; }
       if (zmax > dims[2] - 1) { zmax = dims[2] - 1; }
     }
-    for (int64_t iter1 = xmin; iter1 < xmax + 1; iter1++)
+    if (xmax < xmin || ymax < ymin || zmax < zmin) { continue; }
+
+    // The coordinates of the (possibly wrapped) points along each axis of the bounding box
+    int64_t bounds[6] = { xmin, xmax, ymin, ymax, zmin, zmax };
+    float sizes[3] = { m_SizeX, m_SizeY, m_SizeZ };
+    float resolution[3] = { xRes, yRes, zRes };
+    float center[3] = { xc, yc, zc };
+    std::vector<float> axisCoords[3];
+    for (int32_t axis = 0; axis < 3; axis++)
     {
-      for (int64_t iter2 = ymin; iter2 < ymax + 1; iter2++)
+      axisCoords[axis].resize(static_cast<size_t>(bounds[2 * axis + 1] - bounds[2 * axis] + 1));
+      for (int64_t iter = bounds[2 * axis]; iter < bounds[2 * axis + 1] + 1; iter++)
+      {
+        int64_t point = iter;
+        if (iter < 0) { point = iter + dims[axis]; }
+        if (iter > dims[axis] - 1) { point = iter - dims[axis]; }
+        coords[axis] = float(point) * resolution[axis];
+        if (iter < 0) { coords[axis] = coords[axis] - sizes[axis]; }
+        if (iter > dims[axis] - 1) { coords[axis] = coords[axis] + sizes[axis]; }
+        axisCoords[axis][iter - bounds[2 * axis]] = coords[axis] - center[axis];
+      }
+    }
+
+    // The shape function is evaluated a whole run of columns at a time
+    float oneOverRadcur[3] = { 1.0f / radcur1, 1.0f / radcur2, 1.0f / radcur3 };
+    ShapeRunKernel kernel(ga, oneOverRadcur);
+    std::vector<float> runInside(axisCoords[0].size(), 0.0f);
+    PeriodicBox box(dims, m_PeriodicBoundaries, bounds);
+    PeriodicBox::Run_t run;
+    while (box.next(run) == true)
+    {
+      coords[1] = axisCoords[1][run.m_Row - ymin];
+      coords[2] = axisCoords[2][run.m_Plane - zmin];
+      kernel.setRun(0, coords);
+      kernel.evaluate(m_ShapeOps[shapeclass].get(), &(axisCoords[0][run.m_Column - xmin]), static_cast<size_t>(run.m_Count), &(runInside.front()));
+
+      index = run.m_Index;
+      for (int64_t j = 0; j < run.m_Count; j++, index++)
       {
-        for (int64_t iter3 = zmin; iter3 < zmax + 1; iter3++)
+        inside = runInside[j];
+        if (inside >= 0)
         {
-          column = iter1;
-          row = iter2;
-          plane = iter3;
-          if (iter1 < 0) { column = iter1 + dims[0]; }
-          if (iter1 > dims[0] - 1) { column = iter1 - dims[0]; }
-          if (iter2 < 0) { row = iter2 + dims[1]; }
-          if (iter2 > dims[1] - 1) { row = iter2 - dims[1]; }
-          if (iter3 < 0) { plane = iter3 + dims[2]; }
-          if (iter3 > dims[2] - 1) { plane = iter3 - dims[2]; }
-          index = (plane * dims[0] * dims[1]) + (row * dims[0]) + column;
-          inside = -1.0f;
-          coords[0] = float(column) * xRes;
-          coords[1] = float(row) * yRes;
-          coords[2] = float(plane) * zRes;
-          if (iter1 < 0) { coords[0] = coords[0] - m_SizeX; }
-          if (iter1 > dims[0] - 1) { coords[0] = coords[0] + m_SizeX; }
-          if (iter2 < 0) { coords[1] = coords[1] - m_SizeY; }
-          if (iter2 > dims[1] - 1) { coords[1] = coords[1] + m_SizeY; }
-          if (iter3 < 0) { coords[2] = coords[2] - m_SizeZ; }
-          if (iter3 > dims[2] - 1) { coords[2] = coords[2] + m_SizeZ; }
-          coords[0] = coords[0] - xc;
-          coords[1] = coords[1] - yc;
-          coords[2] = coords[2] - zc;
-          MatrixMath::Multiply3x3with3x1(ga, coords, coordsRotated);
-          float axis1comp = coordsRotated[0] / radcur1;
-          float axis2comp = coordsRotated[1] / radcur2;
-          float axis3comp = coordsRotated[2] / radcur3;
-          inside = m_ShapeOps[shapeclass]->inside(axis1comp, axis2comp, axis3comp);
-          if (inside >= 0)
+          if (m_FeatureIds[index] > m_FirstPrecipitateFeature)
           {
-            int64_t currentpoint = index;
-            if (m_FeatureIds[currentpoint] > m_FirstPrecipitateFeature)
-            {
-              //oldname = m_FeatureIds[currentpoint];
-              m_FeatureIds[currentpoint] = -2;
-            }
-            if (m_FeatureIds[currentpoint] < m_FirstPrecipitateFeature && m_FeatureIds[currentpoint] != -2)
-            {
-              m_FeatureIds[currentpoint] = static_cast<int32_t>(i);
-            }
+            //oldname = m_FeatureIds[index];
+            m_FeatureIds[index] = -2;
+          }
+          if (m_FeatureIds[index] < m_FirstPrecipitateFeature && m_FeatureIds[index] != -2)
+          {
+            m_FeatureIds[index] = static_cast<int32_t>(i);
           }
         }
       }
@@ -48,6 +48,10 @@
 #include "OrientationLib/SpaceGroupOps/SpaceGroupOps.h"
 #include "OrientationLib/SpaceGroupOps/OrthoRhombicOps.h"
 
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PackingCheckpoint.hpp"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PackingFootprint.hpp"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PrecipitateRdfGrid.hpp"
+
 typedef struct
 {
   float m_Volumes;
@@ -59,6 +63,8 @@ typedef struct
   int m_Neighborhoods;
 } Precip_t;
 
+class SyntheticBuildingRandom;
+
 /**
  * @brief The InsertPrecipitatePhases class. See [Filter documentation](@ref insertprecipitatephases) for details.
  */
@@ -100,6 +106,24 @@ class InsertPrecipitatePhases : public AbstractFilter
     SIMPL_FILTER_PARAMETER(bool, WriteGoalAttributes)
     Q_PROPERTY(bool WriteGoalAttributes READ getWriteGoalAttributes WRITE setWriteGoalAttributes)
 
+    SIMPL_FILTER_PARAMETER(bool, UseFixedSeed)
+    Q_PROPERTY(bool UseFixedSeed READ getUseFixedSeed WRITE setUseFixedSeed)
+
+    SIMPL_FILTER_PARAMETER(int, RandomSeed)
+    Q_PROPERTY(int RandomSeed READ getRandomSeed WRITE setRandomSeed)
+
+    SIMPL_FILTER_PARAMETER(bool, WriteCheckpoints)
+    Q_PROPERTY(bool WriteCheckpoints READ getWriteCheckpoints WRITE setWriteCheckpoints)
+
+    SIMPL_FILTER_PARAMETER(int, CheckpointInterval)
+    Q_PROPERTY(int CheckpointInterval READ getCheckpointInterval WRITE setCheckpointInterval)
+
+    SIMPL_FILTER_PARAMETER(bool, ResumeFromCheckpoint)
+    Q_PROPERTY(bool ResumeFromCheckpoint READ getResumeFromCheckpoint WRITE setResumeFromCheckpoint)
+
+    SIMPL_FILTER_PARAMETER(QString, CheckpointFile)
+    Q_PROPERTY(QString CheckpointFile READ getCheckpointFile WRITE setCheckpointFile)
+
     SIMPL_FILTER_PARAMETER(DataArrayPath, InputStatsArrayPath)
     Q_PROPERTY(DataArrayPath InputStatsArrayPath READ getInputStatsArrayPath WRITE setInputStatsArrayPath)
 
@@ -253,8 +277,10 @@ class InsertPrecipitatePhases : public AbstractFilter
      * @param precip Precip_t struct pointer to be intialized
      * @param shapeclass Type of precipitate shape to be generated
      * @param OrthoOps Pointer to SpaceGroupOps object
+     * @param featureId Id of the precipitate being generated; selects the random stream
+     * @param attempt Placement attempt for this precipitate; selects the random stream
      */
-    void generate_precipitate(int32_t phase, Precip_t* precip, uint32_t shapeclass, SpaceGroupOps::Pointer OrthoOps);
+    void generate_precipitate(int32_t phase, Precip_t* precip, uint32_t shapeclass, SpaceGroupOps::Pointer OrthoOps, int32_t featureId, size_t attempt);
 
     /**
      * @brief load_precipitates Reads a list of precipitates from a file to be used as the packed volume
@@ -322,13 +348,38 @@ class InsertPrecipitatePhases : public AbstractFilter
     void determine_currentRDF(int32_t featureNum, int32_t add, bool double_count);
 
     /**
-     * @brief determine_randomRDF Determines a random radial distribution function
-     * @param gnum Index for the precipitate to determine RDF
-     * @param add Determines amount to iterate RDF bins
-     * @param double_count Determines whether to double count items in bins
-     * @param largeNumber Placeholder value for large address space
+     * @brief initialize_rdfCells Bins the precipitate centroids into a uniform grid of cells that are at least
+     * as large as the RDF cutoff so the RDF updates only need to visit the neighboring cells of a precipitate
+     */
+    void initialize_rdfCells();
+
+    /**
+     * @brief write_checkpoint Takes a snapshot of the state of the RDF matching loop at the start of an iteration
+     * and writes it to the checkpoint file in the background
+     * @param checkpointWriter Writer that owns the background write
+     * @param iteration Iteration the loop will continue with
+     * @param acceptedmoves Number of accepted moves so far
+     * @param rg Random number stream of the loop
+     * @param availablePoints Map of cells available for jumps to their key
+     * @param availablePointsInv Map of keys to cells available for jumps
      */
-    void determine_randomRDF(size_t gnum, int32_t add, bool double_count, int32_t largeNumber);
+    void write_checkpoint(PackingCheckpointWriter& checkpointWriter, int32_t iteration, int32_t acceptedmoves, const SyntheticBuildingRandom& rg,
+                          const std::map<size_t, size_t>& availablePoints, const std::map<size_t, size_t>& availablePointsInv);
+
+    /**
+     * @brief restore_checkpoint Replaces the state of the RDF matching loop with the one stored in a checkpoint.
+     * The precipitates themselves are regenerated from the stored seed, so the checkpoint is rejected if they
+     * differ from the ones it was taken with
+     * @param checkpoint Checkpoint read from the checkpoint file
+     * @param rg Random number stream of the loop
+     * @param availablePoints Map of cells available for jumps to their key
+     * @param availablePointsInv Map of keys to cells available for jumps
+     * @param acceptedmoves Number of accepted moves, restored
+     * @param exclusionZonesPtr Exclusion zone counts, rebuilt for the restored positions
+     * @return Iteration the loop continues with
+     */
+    int32_t restore_checkpoint(const PackingCheckpoint& checkpoint, SyntheticBuildingRandom& rg, std::map<size_t, size_t>& availablePoints,
+                               std::map<size_t, size_t>& availablePointsInv, int32_t& acceptedmoves, Int32ArrayType::Pointer exclusionZonesPtr);
 
     /**
      * @brief normalizeRDF Normalizes a radial distribution function
@@ -456,9 +507,7 @@ class InsertPrecipitatePhases : public AbstractFilter
     int64_t* m_Neighbors;
     StatsDataArray::WeakPointer m_StatsDataArray;
 
-    std::vector<std::vector<int64_t> > m_ColumnList;
-    std::vector<std::vector<int64_t> > m_RowList;
-    std::vector<std::vector<int64_t> > m_PlaneList;
+    std::vector<PackingFootprint> m_Footprints;
 
     std::vector<size_t> m_PointsToAdd;
     std::vector<size_t> m_PointsToRemove;
@@ -471,9 +520,10 @@ class InsertPrecipitatePhases : public AbstractFilter
     std::vector<float> m_RdfCurrentDist;
     std::vector<float> m_RdfCurrentDistNorm;
 
-    std::vector<float> m_RandomCentroids;
     std::vector<float> m_RdfRandom;
 
+    PrecipitateRdfGrid m_RdfGrid;
+
     std::vector<float> m_FeatureSizeDistStep;
 
     std::vector<int64_t> m_GSizes;
@@ -35,23 +35,20 @@
 
 #include "JumbleOrientations.h"
 
-#include <boost/random/mersenne_twister.hpp>
-#include <boost/random/uniform_int.hpp>
-#include <boost/random/variate_generator.hpp>
-
-#include <QtCore/QDateTime>
-
 #include "SIMPLib/Common/Constants.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
+#include "SIMPLib/FilterParameters/IntFilterParameter.h"
+#include "SIMPLib/FilterParameters/LinkedBooleanFilterParameter.h"
 
 #include "OrientationLib/OrientationMath/OrientationArray.hpp"
 #include "OrientationLib/OrientationMath/OrientationTransforms.hpp"
 
 #include "SyntheticBuilding/SyntheticBuildingConstants.h"
 #include "SyntheticBuilding/SyntheticBuildingVersion.h"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/SyntheticBuildingRandom.hpp"
 
 // Include the MOC generated file for this class
 #include "moc_JumbleOrientations.cpp"
@@ -68,6 +65,8 @@ JumbleOrientations::JumbleOrientations() :
   m_FeaturePhasesArrayPath("", "", ""),
   m_FeatureEulerAnglesArrayPath("", "", ""),
   m_AvgQuatsArrayName(SIMPL::FeatureData::AvgQuats),
+  m_UseFixedSeed(false),
+  m_RandomSeed(5489),
   m_FeatureIds(NULL),
   m_CellEulerAngles(NULL),
   m_FeaturePhases(NULL),
@@ -90,6 +89,9 @@ JumbleOrientations::~JumbleOrientations()
 void JumbleOrientations::setupFilterParameters()
 {
   FilterParameterVector parameters;
+  QStringList seedProps("RandomSeed");
+  parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Use Fixed Random Seed", UseFixedSeed, FilterParameter::Parameter, JumbleOrientations, seedProps));
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Random Seed", RandomSeed, FilterParameter::Parameter, JumbleOrientations));
   parameters.push_back(SeparatorFilterParameter::New("Element Data", FilterParameter::RequiredArray));
   {
     DataArraySelectionFilterParameter::RequirementType req = DataArraySelectionFilterParameter::CreateCategoryRequirement(SIMPL::TypeNames::Int32, 1, SIMPL::AttributeMatrixObjectType::Element);
@@ -117,6 +119,8 @@ void JumbleOrientations::setupFilterParameters()
 void JumbleOrientations::readFilterParameters(AbstractFilterParametersReader* reader, int index)
 {
   reader->openFilterGroup(this, index);
+  setUseFixedSeed( reader->readValue("UseFixedSeed", getUseFixedSeed()) );
+  setRandomSeed( reader->readValue("RandomSeed", getRandomSeed()) );
   setAvgQuatsArrayName(reader->readString("AvgQuatsArrayName", getAvgQuatsArrayName() ) );
   setFeatureEulerAnglesArrayPath(reader->readDataArrayPath("FeatureEulerAnglesArrayPath", getFeatureEulerAnglesArrayPath() ) );
   setFeaturePhasesArrayPath(reader->readDataArrayPath("FeaturePhasesArrayPath", getFeaturePhasesArrayPath() ) );
@@ -196,18 +200,10 @@ void JumbleOrientations::execute()
   size_t totalPoints = m_FeatureIdsPtr.lock()->getNumberOfTuples();
   int32_t totalFeatures = static_cast<int32_t>(m_FeaturePhasesPtr.lock()->getNumberOfTuples());
 
-  // Generate all the numbers up front
+  // Swap partners are drawn uniformly from [1, totalFeatures - 1]
   const int32_t rangeMin = 1;
   const int32_t rangeMax = totalFeatures - 1;
-  typedef boost::uniform_int<int32_t> NumberDistribution;
-  typedef boost::mt19937 RandomNumberGenerator;
-  typedef boost::variate_generator < RandomNumberGenerator&,
-          NumberDistribution > Generator;
-
-  NumberDistribution distribution(rangeMin, rangeMax);
-  RandomNumberGenerator generator;
-  Generator numberGenerator(generator, distribution);
-  generator.seed(static_cast<boost::uint32_t>( QDateTime::currentMSecsSinceEpoch() )); // seed with the current time
+  SyntheticBuildingRandom rg(SyntheticBuildingRandom::ResolveSeed(m_UseFixedSeed, m_RandomSeed), SyntheticBuildingRandom::JumbleOrientationsShuffle);
 
   int32_t r = 0;
   float temp1 = 0.0f, temp2 = 0.0f, temp3 = 0.0f;
@@ -218,7 +214,7 @@ void JumbleOrientations::execute()
     while (good == false)
     {
       good = true;
-      r = numberGenerator(); // Random remaining position.
+      r = rangeMin + static_cast<int32_t>(rg.genrand_res53() * (rangeMax - rangeMin + 1)); // Random remaining position.
       if (r >= totalFeatures) { good = false; }
       if (m_FeaturePhases[i] != m_FeaturePhases[r]) { good = false; }
     }
@@ -69,6 +69,12 @@ class JumbleOrientations : public AbstractFilter
     SIMPL_FILTER_PARAMETER(QString, AvgQuatsArrayName)
     Q_PROPERTY(QString AvgQuatsArrayName READ getAvgQuatsArrayName WRITE setAvgQuatsArrayName)
 
+    SIMPL_FILTER_PARAMETER(bool, UseFixedSeed)
+    Q_PROPERTY(bool UseFixedSeed READ getUseFixedSeed WRITE setUseFixedSeed)
+
+    SIMPL_FILTER_PARAMETER(int, RandomSeed)
+    Q_PROPERTY(int RandomSeed READ getRandomSeed WRITE setRandomSeed)
+
     /**
      * @brief getCompiledLibraryName Reimplemented from @see AbstractFilter class
      */
@@ -35,12 +35,20 @@
 
 #include "MatchCrystallography.h"
 
+#include <algorithm>
+#include <limits>
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/task_scheduler_init.h>
+#endif
+
 #include "SIMPLib/Common/Constants.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
 #include "SIMPLib/FilterParameters/IntFilterParameter.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
+#include "SIMPLib/FilterParameters/LinkedBooleanFilterParameter.h"
 #include "SIMPLib/StatsData/PrecipitateStatsData.h"
 #include "SIMPLib/StatsData/PrimaryStatsData.h"
 #include "SIMPLib/Utilities/SIMPLibRandom.h"
@@ -55,14 +63,13 @@
 
 #include "SyntheticBuilding/SyntheticBuildingConstants.h"
 #include "SyntheticBuilding/SyntheticBuildingVersion.h"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/SyntheticBuildingRandom.hpp"
 
 #include "EbsdLib/EbsdConstants.h"
 
 // Include the MOC generated file for this class
 #include "moc_MatchCrystallography.cpp"
 
-
-
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -83,6 +90,10 @@ MatchCrystallography::MatchCrystallography() :
   m_FeatureEulerAnglesArrayName(SIMPL::FeatureData::EulerAngles),
   m_AvgQuatsArrayName(SIMPL::FeatureData::AvgQuats),
   m_MaxIterations(1),
+  m_UseFixedSeed(false),
+  m_RandomSeed(5489),
+  m_NumberOfChains(1),
+  m_ExchangeInterval(10000),
   m_FeatureIds(NULL),
   m_CellEulerAngles(NULL),
   m_SurfaceFeatures(NULL),
@@ -99,7 +110,7 @@ MatchCrystallography::MatchCrystallography() :
   m_SharedSurfaceAreaList = NeighborList<float>::NullPointer();
   m_StatsDataArray = StatsDataArray::NullPointer();
 
-  m_MdfChange = m_OdfChange = 0.0f;
+  m_Seed = 0;
 
   m_ActualOdf = FloatArrayType::NullPointer();
   m_SimOdf = FloatArrayType::NullPointer();
@@ -125,6 +136,11 @@ void MatchCrystallography::setupFilterParameters()
 {
   FilterParameterVector parameters;
   parameters.push_back(SIMPL_NEW_INTEGER_FP("Maximum Number of Iterations (Swaps)", MaxIterations, FilterParameter::Parameter, MatchCrystallography));
+  QStringList seedProps("RandomSeed");
+  parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Use Fixed Random Seed", UseFixedSeed, FilterParameter::Parameter, MatchCrystallography, seedProps));
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Random Seed", RandomSeed, FilterParameter::Parameter, MatchCrystallography));
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Number of Parallel Chains", NumberOfChains, FilterParameter::Parameter, MatchCrystallography));
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Chain Exchange Interval (Iterations)", ExchangeInterval, FilterParameter::Parameter, MatchCrystallography));
 
   parameters.push_back(SeparatorFilterParameter::New("Cell Data", FilterParameter::RequiredArray));
   {
@@ -193,6 +209,10 @@ void MatchCrystallography::readFilterParameters(AbstractFilterParametersReader*
 {
   reader->openFilterGroup(this, index);
   setMaxIterations( reader->readValue("MaxIterations", getMaxIterations()) );
+  setUseFixedSeed( reader->readValue("UseFixedSeed", getUseFixedSeed()) );
+  setRandomSeed( reader->readValue("RandomSeed", getRandomSeed()) );
+  setNumberOfChains( reader->readValue("NumberOfChains", getNumberOfChains()) );
+  setExchangeInterval( reader->readValue("ExchangeInterval", getExchangeInterval()) );
   setInputStatsArrayPath(reader->readDataArrayPath("InputStatsArrayPath", getInputStatsArrayPath() ) );
   setCrystalStructuresArrayPath(reader->readDataArrayPath("CrystalStructuresArrayPath", getCrystalStructuresArrayPath() ) );
   setPhaseTypesArrayPath(reader->readDataArrayPath("PhaseTypesArrayPath", getPhaseTypesArrayPath() ) );
@@ -218,7 +238,7 @@ void MatchCrystallography::initialize()
   m_SharedSurfaceAreaList = NeighborList<float>::NullPointer();
   m_StatsDataArray = StatsDataArray::NullPointer();
 
-  m_MdfChange = m_OdfChange = 0.0f;
+  m_Seed = 0;
   m_UnbiasedVolume.clear();
   m_TotalSurfaceArea.clear();
 
@@ -226,7 +246,10 @@ void MatchCrystallography::initialize()
   m_SimOdf = FloatArrayType::NullPointer();
   m_ActualMdf = FloatArrayType::NullPointer();
   m_SimMdf = FloatArrayType::NullPointer();
-  m_MisorientationLists.clear();
+  m_NeighborOffsets.clear();
+  m_NeighborIds.clear();
+  m_AreaFractions.clear();
+  m_MisorientationBins.clear();
 
   m_OrientationOps = SpaceGroupOps::getOrientationOpsQVector();
 }
@@ -312,6 +335,20 @@ void MatchCrystallography::dataCheck()
   m_SyntheticCrystalStructuresPtr = getDataContainerArray()->createNonPrereqArrayFromPath<UInt32ArrayType, AbstractFilter>(this, tempPath, true, cDims); /* Assigns the shared_ptr<>(this, tempPath, true, dims); Assigns the shared_ptr<> to an instance variable that is a weak_ptr<> */
   if( NULL != m_SyntheticCrystalStructuresPtr.lock().get() ) /* Validate the Weak Pointer wraps a non-NULL pointer to a DataArray<T> object */
   { m_SyntheticCrystalStructures = m_SyntheticCrystalStructuresPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
+
+  if (m_NumberOfChains < 1)
+  {
+    QString ss = QObject::tr("The Number of Parallel Chains must be at least 1");
+    setErrorCondition(-1);
+    notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+  }
+
+  if (m_ExchangeInterval < 1)
+  {
+    QString ss = QObject::tr("The Chain Exchange Interval must be greater than 0");
+    setErrorCondition(-1);
+    notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -349,6 +386,8 @@ void MatchCrystallography::execute()
   determine_boundary_areas();
   if (getCancel() == true) { return; }
 
+  m_Seed = SyntheticBuildingRandom::ResolveSeed(m_UseFixedSeed, m_RandomSeed);
+
   m_SyntheticCrystalStructures[0] = m_CrystalStructures[0];
   for (size_t i = 1; i < totalEnsembles; ++i)
   {
@@ -516,9 +555,6 @@ void MatchCrystallography::determine_boundary_areas()
 // -----------------------------------------------------------------------------
 void MatchCrystallography::assign_eulers(size_t ensem)
 {
-  uint64_t m_Seed = QDateTime::currentMSecsSinceEpoch();
-  SIMPL_RANDOMNG_NEW_SEEDED(m_Seed);
-
   int32_t numbins = 0;
   QuatF* avgQuats = reinterpret_cast<QuatF*>(m_AvgQuats);
   float random = 0.0f;
@@ -534,7 +570,7 @@ void MatchCrystallography::assign_eulers(size_t ensem)
     phase = m_FeaturePhases[i];
     if (phase == ensem)
     {
-      m_Seed++;
+      SyntheticBuildingRandom rg(m_Seed, SyntheticBuildingRandom::MatchCrystallographyInitial, static_cast<uint32_t>(i), static_cast<uint32_t>(ensem));
       random = static_cast<float>(rg.genrand_res53());
 
       if ( Ebsd::CrystalStructure::Cubic_High == m_CrystalStructures[phase] ) { numbins = cOps.getODFSize(); };
@@ -550,10 +586,12 @@ void MatchCrystallography::assign_eulers(size_t ensem)
         return;
       }
 
-      choose = pick_euler(random, numbins);
+      choose = OrientationChainRunner::PickOdfBin(m_ActualOdf->getPointer(0), numbins, random);
 
-      FOrientArrayType eulers = m_OrientationOps[m_CrystalStructures[ensem]]->determineEulerAngles(m_Seed, choose);
-      eulers = m_OrientationOps[m_CrystalStructures[ensem]]->randomizeEulerAngles(eulers);
+      FOrientArrayType eulers = m_OrientationOps[m_CrystalStructures[ensem]]->determineEulerAngles(rg.genrand_int64(), choose);
+      // the symmetry operator comes from the Feature's stream so fixed seeds reproduce the orientations
+      size_t symOp = static_cast<size_t>(rg.genrand_res53() * m_OrientationOps[m_CrystalStructures[ensem]]->getNumSymOps());
+      eulers = m_OrientationOps[m_CrystalStructures[ensem]]->applySymmetryOperator(eulers, symOp);
       m_FeatureEulerAngles[3 * i] = eulers[0];
       m_FeatureEulerAngles[3 * i + 1] = eulers[1];
       m_FeatureEulerAngles[3 * i + 2] = eulers[2];
@@ -572,151 +610,79 @@ void MatchCrystallography::assign_eulers(size_t ensem)
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-int32_t MatchCrystallography::pick_euler(float random, int32_t numbins)
+void MatchCrystallography::initialize_chain(OrientationChain_t& chain, size_t ensem)
 {
-  int32_t choose = 0;
-  float totaldensity = 0.0f;
+  size_t totalFeatures = m_FeaturePhasesPtr.lock()->getNumberOfTuples();
 
-  for (int32_t j = 0; j < numbins; j++)
+  chain.m_FeatureEulerAngles.assign(m_FeatureEulerAngles, m_FeatureEulerAngles + 3 * totalFeatures);
+  chain.m_Quats.assign(totalFeatures, QuaternionMathF::New());
+  FOrientArrayType quat(4, 0.0);
+  for (size_t i = 1; i < totalFeatures; i++)
   {
-    float density = m_ActualOdf->getValue(j);
-    float td1 = totaldensity;
-    totaldensity = totaldensity + density;
-    if (random < totaldensity && random >= td1) { choose = j; break; }
+    if (m_FeaturePhases[i] == static_cast<int32_t>(ensem))
+    {
+      FOrientTransformsType::eu2qu(FOrientArrayType(&(m_FeatureEulerAngles[3 * i]), 3), quat);
+      chain.m_Quats[i] = quat.toQuaternion();
+    }
   }
-  return choose;
+  chain.m_SimOdf.assign(m_SimOdf->getPointer(0), m_SimOdf->getPointer(0) + m_SimOdf->getSize());
+  chain.m_SimMdf.assign(m_SimMdf->getPointer(0), m_SimMdf->getPointer(0) + m_SimMdf->getSize());
+  chain.m_MisorientationBins = m_MisorientationBins;
+  chain.m_Iterations = 0;
+  chain.m_BadTryCount = 0;
 }
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void MatchCrystallography::MC_LoopBody1(int32_t feature, size_t ensem, size_t j, float neighsurfarea, uint32_t sym, QuatF& q1, QuatF& q2)
+void MatchCrystallography::matchCrystallography(size_t ensem)
 {
-  float w = 0.0f;
-  float n1 = 0.0f, n2 = 0.0f, n3 = 0.0f;
-  float curmiso1 = 0.0f, curmiso2 = 0.0f, curmiso3 = 0.0f;
-  size_t curmisobin = 0, newmisobin = 0;
-
-
-  curmiso1 = m_MisorientationLists[feature][3 * j];
-  curmiso2 = m_MisorientationLists[feature][3 * j + 1];
-  curmiso3 = m_MisorientationLists[feature][3 * j + 2];
-
-  FOrientArrayType rod(curmiso1, curmiso2, curmiso3, 0.0f);
-  float mag = sqrt(curmiso1 * curmiso1 + curmiso2 * curmiso2 + curmiso3 * curmiso3);
-  if(mag == 0.0f)
-  {
-    rod[3] = std::numeric_limits<float>::infinity();
-  }
-  else
-  {
-    rod[3] = mag;
-    rod[0] = rod[0] / rod[3];
-    rod[1] = rod[1] / rod[3];
-    rod[2] = rod[2] / rod[3];
-  }
-
-  curmisobin = m_OrientationOps[sym]->getMisoBin(rod);
-  w = m_OrientationOps[sym]->getMisoQuat(q1, q2, n1, n2, n3);
-
-  FOrientTransformsType::ax2ro(FOrientArrayType(n1, n2, n3, w), rod);
-  newmisobin = m_OrientationOps[sym]->getMisoBin(rod);
-  m_MdfChange = m_MdfChange
-              + (((m_ActualMdf->getValue(curmisobin) - m_SimMdf->getValue(curmisobin)) * (m_ActualMdf->getValue(curmisobin) - m_SimMdf->getValue(curmisobin)))
-                 - ((m_ActualMdf->getValue(curmisobin) - (m_SimMdf->getValue(curmisobin) - (neighsurfarea / m_TotalSurfaceArea[ensem])))
-                    * (m_ActualMdf->getValue(curmisobin) - (m_SimMdf->getValue(curmisobin) - (neighsurfarea / m_TotalSurfaceArea[ensem])))));
-  m_MdfChange = m_MdfChange
-              + (((m_ActualMdf->getValue(newmisobin) - m_SimMdf->getValue(newmisobin)) * (m_ActualMdf->getValue(newmisobin) - m_SimMdf->getValue(newmisobin)))
-                 - ((m_ActualMdf->getValue(newmisobin) - (m_SimMdf->getValue(newmisobin) + (neighsurfarea / m_TotalSurfaceArea[ensem])))
-                    * (m_ActualMdf->getValue(newmisobin) - (m_SimMdf->getValue(newmisobin) + (neighsurfarea / m_TotalSurfaceArea[ensem])))));
-}
+  size_t totalPoints = m_FeatureIdsPtr.lock()->getNumberOfTuples();
+  size_t totalFeatures = m_FeaturePhasesPtr.lock()->getNumberOfTuples();
+  QuatF* avgQuats = reinterpret_cast<QuatF*>(m_AvgQuats);
 
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
-void MatchCrystallography::MC_LoopBody2(int32_t feature, size_t ensem, size_t j, float neighsurfarea, uint32_t sym, QuatF& q1, QuatF& q2)
-{
-  float w = 0.0f;
-  float n1 = 0.0f, n2 = 0.0f, n3 = 0.0f;
-  float curmiso1 = 0.0f, curmiso2 = 0.0f, curmiso3 = 0.0f;
-  size_t curmisobin = 0, newmisobin = 0;
-  float miso1 = 0.0f, miso2 = 0.0f, miso3 = 0.0f;
-
-  curmiso1 = m_MisorientationLists[feature][3 * j];
-  curmiso2 = m_MisorientationLists[feature][3 * j + 1];
-  curmiso3 = m_MisorientationLists[feature][3 * j + 2];
-
-  FOrientArrayType rod(curmiso1, curmiso2, curmiso3, 0.0f);
-  float mag = sqrt(curmiso1 * curmiso1 + curmiso2 * curmiso2 + curmiso3 * curmiso3);
-  if(mag == 0.0f)
+  // only interior Features of the phase take part in swaps and switches
+  std::vector<float> volumeFractions(totalFeatures, 0.0f);
+  std::vector<bool> selectable(totalFeatures, false);
+  for (size_t i = 0; i < totalFeatures; i++)
   {
-    rod[3] = std::numeric_limits<float>::infinity();
+    if (m_FeaturePhases[i] == static_cast<int32_t>(ensem))
+    {
+      volumeFractions[i] = m_Volumes[i] / m_UnbiasedVolume[ensem];
+      selectable[i] = (m_SurfaceFeatures[i] == false);
+    }
   }
-  else
+  OrientationChainRunner runner(m_OrientationOps[m_CrystalStructures[ensem]], m_ActualOdf->getPointer(0), m_ActualMdf->getPointer(0), m_NeighborOffsets,
+                                m_NeighborIds, m_AreaFractions, volumeFractions, selectable, m_MaxIterations);
+
+  // every chain draws from its own stream; the first one is the stream of the single chain mode
+  size_t numChains = static_cast<size_t>(m_NumberOfChains);
+  std::vector<OrientationChain_t> chains(numChains);
+  std::vector<SyntheticBuildingRandom> generators;
+  initialize_chain(chains[0], ensem);
+  runner.computeErrors(chains[0]);
+  for (size_t c = 0; c < numChains; c++)
   {
-    rod[3] = mag;
-    rod[0] = rod[0] / rod[3];
-    rod[1] = rod[1] / rod[3];
-    rod[2] = rod[2] / rod[3];
+    generators.push_back(SyntheticBuildingRandom(m_Seed, SyntheticBuildingRandom::MatchCrystallographySwaps, static_cast<uint32_t>(ensem), static_cast<uint32_t>(c)));
+    if (c > 0) { chains[c] = chains[0]; }
   }
+  double epsilon = std::numeric_limits<float>::min();
+  double initialOdfError = std::max(chains[0].m_OdfError, epsilon);
+  double initialMdfError = std::max(chains[0].m_MdfError, epsilon);
 
-  curmisobin = m_OrientationOps[sym]->getMisoBin(rod);
-  w = m_OrientationOps[sym]->getMisoQuat(q1, q2, n1, n2, n3);
-
-  FOrientTransformsType::ax2ro(FOrientArrayType(n1, n2, n3, w), rod);
-  newmisobin = m_OrientationOps[sym]->getMisoBin(rod);
-  m_MisorientationLists[feature][3 * j] = miso1;
-  m_MisorientationLists[feature][3 * j + 1] = miso2;
-  m_MisorientationLists[feature][3 * j + 2] = miso3;
-  m_SimMdf->setValue(curmisobin, (m_SimMdf->getValue(curmisobin) - (neighsurfarea / m_TotalSurfaceArea[ensem])));
-  m_SimMdf->setValue(newmisobin, (m_SimMdf->getValue(newmisobin) + (neighsurfarea / m_TotalSurfaceArea[ensem])));
-}
-
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
-void MatchCrystallography::matchCrystallography(size_t ensem)
-{
-  // But since a pointer is difficult to use operators with we will now create a
-  // reference variable to the pointer with the correct variable name that allows
-  // us to use the same syntax as the "vector of vectors"
-  NeighborList<int32_t>& neighborlist = *(m_NeighborList.lock());
-  NeighborList<float>& neighborsurfacearealist = *(m_SharedSurfaceAreaList.lock() );
-  size_t totalPoints = m_FeatureIdsPtr.lock()->getNumberOfTuples();
-  size_t totalFeatures = m_FeaturePhasesPtr.lock()->getNumberOfTuples();
-
-  uint64_t m_Seed = QDateTime::currentMSecsSinceEpoch();
-  SIMPL_RANDOMNG_NEW_SEEDED(m_Seed);
-
-  int32_t numbins = 0;
-  int32_t iterations = 0, badtrycount = 0;
-  float random = 0.0f;
-  size_t counter = 0;
-
-  QuatF q1;
-  QuatF q2;
-  QuatF* avgQuats = reinterpret_cast<QuatF*>(m_AvgQuats);
-
-  float ea1 = 0.0f, ea2 = 0.0f, ea3 = 0.0f;
-  float g1ea1 = 0.0f, g1ea2 = 0.0f, g1ea3 = 0.0f, g2ea1 = 0.0f, g2ea2 = 0.0f, g2ea3 = 0.0f;
-  int32_t g1odfbin = 0, g2odfbin = 0;
-  float deltaerror = 0.0f;
-  float currentodferror = 0.0f, currentmdferror = 0.0f;
-  int32_t selectedfeature1 = 0, selectedfeature2 = 0;
-  iterations = 0;
-  badtrycount = 0;
-  if ( Ebsd::CrystalStructure::Cubic_High == m_CrystalStructures[ensem]) { numbins = 18 * 18 * 18; }
-  if ( Ebsd::CrystalStructure::Hexagonal_High == m_CrystalStructures[ensem]) { numbins = 36 * 36 * 12; }
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+  tbb::task_scheduler_init init;
+#endif
 
   uint64_t millis = QDateTime::currentMSecsSinceEpoch();
   uint64_t startMillis = millis;
-  int32_t lastIteration = 0;
-  while (badtrycount < (m_MaxIterations / 10) && iterations < m_MaxIterations)
+  size_t best = 0;
+  while (chains[best].m_BadTryCount < (m_MaxIterations / 10) && chains[best].m_Iterations < m_MaxIterations)
   {
-    m_Seed++;
     uint64_t currentMillis = QDateTime::currentMSecsSinceEpoch();
     if (currentMillis - millis > 1000)
     {
+      int32_t iterations = chains[best].m_Iterations;
       QString ss = QObject::tr("Swapping/Switching Orientations Iteration %1/%2").arg(iterations).arg(m_MaxIterations);
       float timeDiff = ((float)iterations / (float)(currentMillis - startMillis));
       float estimatedTime = (float)(m_MaxIterations - iterations) / timeDiff;
@@ -725,275 +691,44 @@ void MatchCrystallography::matchCrystallography(size_t ensem)
       notifyStatusMessage(getMessagePrefix(), getHumanLabel(), ss);
 
       millis = QDateTime::currentMSecsSinceEpoch();
-      lastIteration = iterations;
-    }
-    currentodferror = 0;
-    currentmdferror = 0;
-    float* actualOdfPtr = m_ActualOdf->getPointer(0);
-    float* simOdfPtr = m_SimOdf->getPointer(0);
-    float delta = 0.0f;
-    for (int32_t i = 0; i < numbins; i++)
-    {
-      delta = actualOdfPtr[i] - simOdfPtr[i];
-      currentodferror = currentodferror + (delta * delta);
-    }
-    for (int32_t i = 0; i < (numbins); i++)
-    {
-      currentmdferror = currentmdferror + ((m_ActualMdf->getValue(i) - m_SimMdf->getValue(i)) * (m_ActualMdf->getValue(i) - m_SimMdf->getValue(i)));
     }
-    iterations++;
-    badtrycount++;
-    random = static_cast<float>( rg.genrand_res53() );
+
+    runner.runChains(chains, generators, m_ExchangeInterval);
 
     if (getCancel() == true) { return; }
 
-    if (random < 0.5) // SwapOutOrientation
+    // the errors are tracked incrementally, so they are recomputed before the chains are compared
+    double bestError = std::numeric_limits<double>::max();
+    for (size_t c = 0; c < numChains; c++)
     {
-      counter = 0;
-      selectedfeature1 = int32_t(rg.genrand_res53() * totalFeatures);
-      if (selectedfeature1 >= totalFeatures) { selectedfeature1 = selectedfeature1 - totalFeatures; }
-      while ((m_SurfaceFeatures[selectedfeature1] == true || m_FeaturePhases[selectedfeature1] != static_cast<int32_t>(ensem)) && counter < totalFeatures)
+      runner.computeErrors(chains[c]);
+      double error = (chains[c].m_OdfError / initialOdfError) + (chains[c].m_MdfError / initialMdfError);
+      if (error < bestError)
       {
-        if (selectedfeature1 >= totalFeatures) { selectedfeature1 = selectedfeature1 - totalFeatures; }
-        selectedfeature1++;
-        counter++;
+        bestError = error;
+        best = c;
       }
-      if (selectedfeature1 >= totalFeatures) { selectedfeature1 = selectedfeature1 - totalFeatures; }
-      if (counter == totalFeatures)
-      {
-        badtrycount = 10 * m_NumFeatures[ensem];
-      }
-      else
-      {
-        ea1 = m_FeatureEulerAngles[3 * selectedfeature1];
-        ea2 = m_FeatureEulerAngles[3 * selectedfeature1 + 1];
-        ea3 = m_FeatureEulerAngles[3 * selectedfeature1 + 2];
-        FOrientArrayType rod(4, 0.0);
-        FOrientTransformsType::eu2ro(FOrientArrayType(&(m_FeatureEulerAngles[3 * selectedfeature1]), 3), rod);
-
-        g1odfbin = m_OrientationOps[m_CrystalStructures[ensem]]->getOdfBin(rod);
-        random = static_cast<float>( rg.genrand_res53() );
-        int32_t choose = 0;
-
-        choose = pick_euler(random, numbins);
-
-        FOrientArrayType g1ea = m_OrientationOps[m_CrystalStructures[ensem]]->determineEulerAngles(m_Seed, choose);
-        g1ea = m_OrientationOps[m_CrystalStructures[ensem]]->randomizeEulerAngles(g1ea);
-        FOrientArrayType quat(4, 0.0);
-        FOrientTransformsType::eu2qu(g1ea, quat);
-        q1 = quat.toQuaternion();
-
-        m_OdfChange = ((m_ActualOdf->getValue(choose) - m_SimOdf->getValue(choose)) * (m_ActualOdf->getValue(choose) - m_SimOdf->getValue(choose)))
-                    - ((m_ActualOdf->getValue(choose) - (m_SimOdf->getValue(choose) + (m_Volumes[selectedfeature1] / m_UnbiasedVolume[ensem])))
-                       * (m_ActualOdf->getValue(choose) - (m_SimOdf->getValue(choose) + (m_Volumes[selectedfeature1] / m_UnbiasedVolume[ensem]))));
-        m_OdfChange = m_OdfChange
-                    + (((m_ActualOdf->getValue(g1odfbin) - m_SimOdf->getValue(g1odfbin)) * (m_ActualOdf->getValue(g1odfbin) - m_SimOdf->getValue(g1odfbin)))
-                       - ((m_ActualOdf->getValue(g1odfbin) - (m_SimOdf->getValue(g1odfbin) - (m_Volumes[selectedfeature1] / m_UnbiasedVolume[ensem])))
-                          * (m_ActualOdf->getValue(g1odfbin) - (m_SimOdf->getValue(g1odfbin) - (m_Volumes[selectedfeature1] / m_UnbiasedVolume[ensem])))));
-
-        m_MdfChange = 0;
-        size_t size = 0;
-        if (neighborlist[selectedfeature1].size() != 0) { size = neighborlist[selectedfeature1].size(); }
-        for (size_t j = 0; j < size; j++)
-        {
-          int32_t neighbor = neighborlist[selectedfeature1][j];
-          FOrientTransformsType::eu2qu(FOrientArrayType(&(m_FeatureEulerAngles[3 * neighbor]), 3), quat);
-          q1 = quat.toQuaternion();
-          float neighsurfarea = neighborsurfacearealist[selectedfeature1][j];
-          MC_LoopBody1(selectedfeature1, ensem, j, neighsurfarea, m_CrystalStructures[ensem], q1, q2);
-        }
-
-        deltaerror = (m_OdfChange / currentodferror) + (m_MdfChange / currentmdferror);
-        if (deltaerror > 0)
-        {
-          badtrycount = 0;
-          m_FeatureEulerAngles[3 * selectedfeature1] = g1ea1;
-          m_FeatureEulerAngles[3 * selectedfeature1 + 1] = g1ea2;
-          m_FeatureEulerAngles[3 * selectedfeature1 + 2] = g1ea3;
-          QuaternionMathF::Copy(q1, avgQuats[selectedfeature1]);
-          m_SimOdf->setValue(choose, (m_SimOdf->getValue(choose) + (m_Volumes[selectedfeature1] / m_UnbiasedVolume[ensem])));
-          m_SimOdf->setValue(g1odfbin, (m_SimOdf->getValue(g1odfbin) - (m_Volumes[selectedfeature1] / m_UnbiasedVolume[ensem])));
-          size = 0;
-          if (neighborlist[selectedfeature1].size() != 0) { size = neighborlist[selectedfeature1].size(); }
-          for (size_t j = 0; j < size; j++)
-          {
-            int neighbor = neighborlist[selectedfeature1][j];
-            FOrientArrayType quat(4);
-            FOrientTransformsType::eu2qu(FOrientArrayType(&(m_FeatureEulerAngles[3 * neighbor]), 3), quat);
-            q2 = quat.toQuaternion();
-            float neighsurfarea = neighborsurfacearealist[selectedfeature1][j];
-            MC_LoopBody2(selectedfeature1, ensem, j, neighsurfarea, m_CrystalStructures[ensem], q1, q2);
-          }
-        }
-      }
-      if (getCancel() == true) { return; }
     }
-    else // SwitchOrientation
+    // exchange: every chain continues from the best state found so far
+    for (size_t c = 0; c < numChains; c++)
     {
-      counter = 0;
-      selectedfeature1 = int32_t(rg.genrand_res53() * totalFeatures);
-      if (selectedfeature1 >= totalFeatures) { selectedfeature1 = selectedfeature1 - totalFeatures; }
-      while ((m_SurfaceFeatures[selectedfeature1] == true || m_FeaturePhases[selectedfeature1] != static_cast<int32_t>(ensem)) && counter < totalFeatures)
-      {
-        if (selectedfeature1 >= totalFeatures) { selectedfeature1 = selectedfeature1 - totalFeatures; }
-        selectedfeature1++;
-        counter++;
-      }
-      if (selectedfeature1 >= totalFeatures) { selectedfeature1 = selectedfeature1 - totalFeatures; }
-      if (counter == totalFeatures)
-      {
-        badtrycount = 10 * m_NumFeatures[ensem];
-      }
-      else
-      {
-        counter = 0;
-        selectedfeature2 = int32_t(rg.genrand_res53() * totalFeatures);
-        if (selectedfeature2 >= totalFeatures) { selectedfeature2 = selectedfeature2 - totalFeatures; }
-        while ((m_SurfaceFeatures[selectedfeature2] == true || m_FeaturePhases[selectedfeature2] != static_cast<int32_t>(ensem) || selectedfeature2 == selectedfeature1) && counter < totalFeatures)
-        {
-          if (selectedfeature2 >= totalFeatures) { selectedfeature2 = selectedfeature2 - totalFeatures; }
-          selectedfeature2++;
-          counter++;
-        }
-        if (selectedfeature2 >= totalFeatures) { selectedfeature2 = selectedfeature2 - totalFeatures; }
-        if (counter == totalFeatures)
-        {
-          badtrycount = 10 * m_NumFeatures[ensem];
-        }
-        else
-        {
-          g1ea1 = m_FeatureEulerAngles[3 * selectedfeature1];
-          g1ea2 = m_FeatureEulerAngles[3 * selectedfeature1 + 1];
-          g1ea3 = m_FeatureEulerAngles[3 * selectedfeature1 + 2];
-          g2ea1 = m_FeatureEulerAngles[3 * selectedfeature2];
-          g2ea2 = m_FeatureEulerAngles[3 * selectedfeature2 + 1];
-          g2ea3 = m_FeatureEulerAngles[3 * selectedfeature2 + 2];
-          QuaternionMathF::Copy(q1, avgQuats[selectedfeature1]);
-          FOrientArrayType rod(4);
-          FOrientTransformsType::eu2ro(FOrientArrayType(&(m_FeatureEulerAngles[3 * selectedfeature1]), 3), rod);
-
-          g1odfbin = m_OrientationOps[m_CrystalStructures[ensem]]->getOdfBin(rod);
-          QuaternionMathF::Copy(q1, avgQuats[selectedfeature2]);
-
-          FOrientTransformsType::eu2ro(FOrientArrayType(&(m_FeatureEulerAngles[3 * selectedfeature2]), 3), rod);
-          g2odfbin = m_OrientationOps[m_CrystalStructures[ensem]]->getOdfBin(rod);
-
-          m_OdfChange = ((m_ActualOdf->getValue(g1odfbin) - m_SimOdf->getValue(g1odfbin)) * (m_ActualOdf->getValue(g1odfbin) - m_SimOdf->getValue(g1odfbin)))
-                      - ((m_ActualOdf->getValue(g1odfbin)
-                          - (m_SimOdf->getValue(g1odfbin) - (m_Volumes[selectedfeature1] / m_UnbiasedVolume[ensem])
-                             + (m_Volumes[selectedfeature2] / m_UnbiasedVolume[ensem])))
-                         * (m_ActualOdf->getValue(g1odfbin)
-                            - (m_SimOdf->getValue(g1odfbin) - (m_Volumes[selectedfeature1] / m_UnbiasedVolume[ensem])
-                               + (m_Volumes[selectedfeature2] / m_UnbiasedVolume[ensem]))));
-          m_OdfChange = m_OdfChange
-                      + (((m_ActualOdf->getValue(g2odfbin) - m_SimOdf->getValue(g2odfbin)) * (m_ActualOdf->getValue(g2odfbin) - m_SimOdf->getValue(g2odfbin)))
-                         - ((m_ActualOdf->getValue(g2odfbin)
-                             - (m_SimOdf->getValue(g2odfbin) - (m_Volumes[selectedfeature2] / m_UnbiasedVolume[ensem])
-                                + (m_Volumes[selectedfeature1] / m_UnbiasedVolume[ensem])))
-                            * (m_ActualOdf->getValue(g2odfbin)
-                               - (m_SimOdf->getValue(g2odfbin) - (m_Volumes[selectedfeature2] / m_UnbiasedVolume[ensem])
-                                  + (m_Volumes[selectedfeature1] / m_UnbiasedVolume[ensem])))));
-
-          m_MdfChange = 0;
-
-          FOrientArrayType quat(4);
-          FOrientTransformsType::eu2qu(FOrientArrayType(g2ea1, g2ea2, g2ea3), quat);
-          q1 = quat.toQuaternion();
-
-          size_t size = 0;
-          if (neighborlist[selectedfeature1].size() != 0) { size = neighborlist[selectedfeature1].size(); }
-          for (size_t j = 0; j < size; j++)
-          {
-            int32_t neighbor = neighborlist[selectedfeature1][j];
-            FOrientTransformsType::eu2qu(FOrientArrayType(&(m_FeatureEulerAngles[3 * neighbor]), 3), quat);
-            q2 = quat.toQuaternion();
-            float neighsurfarea = neighborsurfacearealist[selectedfeature1][j];
-            if(neighbor != static_cast<int>(selectedfeature2) )
-            {
-              MC_LoopBody1(selectedfeature1, ensem, j, neighsurfarea, m_CrystalStructures[ensem], q1, q2);
-            }
-          }
-
-          FOrientTransformsType::eu2qu(FOrientArrayType(g1ea1, g1ea2, g1ea3), quat);
-          q1 = quat.toQuaternion();
-          size = 0;
-          if (neighborlist[selectedfeature2].size() != 0) { size = neighborlist[selectedfeature2].size(); }
-          for (size_t j = 0; j < size; j++)
-          {
-            size_t neighbor = neighborlist[selectedfeature2][j];
-
-            FOrientTransformsType::eu2qu(FOrientArrayType(&(m_FeatureEulerAngles[3 * neighbor]), 3), quat);
-            q2 = quat.toQuaternion();
-            float neighsurfarea = neighborsurfacearealist[selectedfeature2][j];
-            if (neighbor != selectedfeature1)
-            {
-              MC_LoopBody1(selectedfeature2, ensem, j, neighsurfarea, m_CrystalStructures[ensem], q1, q2);
-            }
-          }
-
-          deltaerror = (m_OdfChange / currentodferror) + (m_MdfChange / currentmdferror);
-          if (deltaerror > 0)
-          {
-
-            badtrycount = 0;
-            m_FeatureEulerAngles[3 * selectedfeature1] = g2ea1;
-            m_FeatureEulerAngles[3 * selectedfeature1 + 1] = g2ea2;
-            m_FeatureEulerAngles[3 * selectedfeature1 + 2] = g2ea3;
-            m_FeatureEulerAngles[3 * selectedfeature2] = g1ea1;
-            m_FeatureEulerAngles[3 * selectedfeature2 + 1] = g1ea2;
-            m_FeatureEulerAngles[3 * selectedfeature2 + 2] = g1ea3;
-            m_SimOdf->setValue(g1odfbin, (m_SimOdf->getValue(g1odfbin) + (m_Volumes[selectedfeature2] / m_UnbiasedVolume[ensem])
-                                        - (m_Volumes[selectedfeature1] / m_UnbiasedVolume[ensem])));
-            m_SimOdf->setValue(g2odfbin, (m_SimOdf->getValue(g2odfbin) + (m_Volumes[selectedfeature1] / m_UnbiasedVolume[ensem])
-                                        - (m_Volumes[selectedfeature2] / m_UnbiasedVolume[ensem])));
-
-            FOrientTransformsType::eu2qu(FOrientArrayType(g1ea1, g1ea2, g1ea3), quat);
-            q1 = quat.toQuaternion();
-            QuaternionMathF::Copy(q1, avgQuats[selectedfeature1]);
-            size = 0;
-            if (neighborlist[selectedfeature1].size() != 0) { size = neighborlist[selectedfeature1].size(); }
-            for (size_t j = 0; j < size; j++)
-            {
-              size_t neighbor = neighborlist[selectedfeature1][j];
-              ea1 = m_FeatureEulerAngles[3 * neighbor];
-              ea2 = m_FeatureEulerAngles[3 * neighbor + 1];
-              ea3 = m_FeatureEulerAngles[3 * neighbor + 2];
-              FOrientTransformsType::eu2qu(FOrientArrayType(ea1, ea2, ea3), quat);
-              q2 = quat.toQuaternion();
-              float neighsurfarea = neighborsurfacearealist[selectedfeature1][j];
-              if (neighbor != selectedfeature2)
-              {
-                MC_LoopBody2(selectedfeature1, ensem, j, neighsurfarea, m_CrystalStructures[ensem], q1, q2);
-              }
-            }
-
-            FOrientTransformsType::eu2qu(FOrientArrayType(g1ea1, g1ea2, g1ea3), quat);
-            q1 = quat.toQuaternion();
-            QuaternionMathF::Copy(q1, avgQuats[selectedfeature2]);
-            size = 0;
-            if (neighborlist[selectedfeature2].size() != 0) { size = neighborlist[selectedfeature2].size(); }
-            for (size_t j = 0; j < size; j++)
-            {
-              size_t neighbor = neighborlist[selectedfeature2][j];
-              ea1 = m_FeatureEulerAngles[3 * neighbor];
-              ea2 = m_FeatureEulerAngles[3 * neighbor + 1];
-              ea3 = m_FeatureEulerAngles[3 * neighbor + 2];
-              FOrientTransformsType::eu2qu(FOrientArrayType(ea1, ea2, ea3), quat);
-              q2 = quat.toQuaternion();
-              float neighsurfarea = neighborsurfacearealist[selectedfeature2][j];
-              if (neighbor != selectedfeature1)
-              {
-                MC_LoopBody2(selectedfeature2, ensem, j, neighsurfarea, m_CrystalStructures[ensem], q1, q2);
-              }
-            }
-          }
-        }
-      }
+      if (c != best) { chains[c] = chains[best]; }
     }
-    if (getCancel() == true) { return; }
   }
 
-  if (getCancel() == true) { return; }
+  OrientationChain_t& chain = chains[best];
+  for (size_t i = 1; i < totalFeatures; i++)
+  {
+    if (m_FeaturePhases[i] == static_cast<int32_t>(ensem))
+    {
+      m_FeatureEulerAngles[3 * i] = chain.m_FeatureEulerAngles[3 * i];
+      m_FeatureEulerAngles[3 * i + 1] = chain.m_FeatureEulerAngles[3 * i + 1];
+      m_FeatureEulerAngles[3 * i + 2] = chain.m_FeatureEulerAngles[3 * i + 2];
+      QuaternionMathF::Copy(chain.m_Quats[i], avgQuats[i]);
+    }
+  }
+  std::copy(chain.m_SimOdf.begin(), chain.m_SimOdf.end(), m_SimOdf->getPointer(0));
+  std::copy(chain.m_SimMdf.begin(), chain.m_SimMdf.end(), m_SimMdf->getPointer(0));
 
   for (size_t i = 0; i < totalPoints; i++)
   {
@@ -1015,30 +750,25 @@ void MatchCrystallography::measure_misorientations(size_t ensem)
   NeighborList<float>& neighborsurfacearealist = *(m_SharedSurfaceAreaList.lock() );
   size_t totalFeatures = m_FeaturePhasesPtr.lock()->getNumberOfTuples();
 
-  float w = 0.0f;
-  float n1 = 0.0f, n2 = 0.0f, n3 = 0.0f;
-  QuatF q1 = QuaternionMathF::New();
-  QuatF q2 = QuaternionMathF::New();
   QuatF* avgQuats = reinterpret_cast<QuatF*>(m_AvgQuats);
 
   uint32_t crys1 = 0;
   int32_t mbin = 0;
 
-  m_MisorientationLists.resize(totalFeatures);
+  // The MDF bin of every boundary is cached in one flat array, -1 marks boundaries to other phases
+  m_NeighborOffsets.assign(totalFeatures + 1, 0);
+  for (size_t i = 1; i < totalFeatures; i++)
+  {
+    m_NeighborOffsets[i + 1] = m_NeighborOffsets[i] + neighborlist[i].size();
+  }
+  m_NeighborIds.assign(m_NeighborOffsets[totalFeatures], 0);
+  m_AreaFractions.assign(m_NeighborOffsets[totalFeatures], 0.0f);
+  m_MisorientationBins.assign(m_NeighborOffsets[totalFeatures], -1);
 
   for (size_t i = 1; i < totalFeatures; i++)
   {
     if (m_FeaturePhases[i] == ensem)
     {
-      if (m_MisorientationLists[i].size() != 0)
-      {
-        m_MisorientationLists[i].clear();
-      }
-      if (neighborlist[i].size() != 0)
-      {
-        m_MisorientationLists[i].assign(neighborlist[i].size() * 3, 0.0f);
-      }
-      QuaternionMathF::Copy(avgQuats[i], q1);
       crys1 = m_CrystalStructures[ensem];
       size_t size = 0;
       if (neighborlist[i].size() != 0 && neighborsurfacearealist[i].size() == neighborlist[i].size())
@@ -1049,29 +779,18 @@ void MatchCrystallography::measure_misorientations(size_t ensem)
       for (size_t j = 0; j < size; j++)
       {
         int32_t nname = neighborlist[i][j];
+        m_NeighborIds[m_NeighborOffsets[i] + j] = nname;
         if (m_FeaturePhases[nname] == ensem)
         {
-          w = 10000.0f;
           float neighsurfarea = neighborsurfacearealist[i][j];
-          QuaternionMathF::Copy(avgQuats[nname], q2);
-          w = m_OrientationOps[crys1]->getMisoQuat(q1, q2, n1, n2, n3);
-          FOrientArrayType rod(4);
-          FOrientTransformsType::ax2ro(FOrientArrayType(n1, n2, n3, w), rod);
-          m_MisorientationLists[i][3 * j] = rod[0];
-          m_MisorientationLists[i][3 * j + 1] = rod[1];
-          m_MisorientationLists[i][3 * j + 2] = rod[2];
-          mbin = m_OrientationOps[crys1]->getMisoBin(rod);
+          mbin = OrientationChainRunner::MisorientationBin(m_OrientationOps[crys1], avgQuats[i], avgQuats[nname]);
+          m_AreaFractions[m_NeighborOffsets[i] + j] = neighsurfarea / m_TotalSurfaceArea[ensem];
+          m_MisorientationBins[m_NeighborOffsets[i] + j] = mbin;
           if (m_SurfaceFeatures[i] == false && (nname > static_cast<int32_t>(i) || m_SurfaceFeatures[nname] == true))
           {
             m_SimMdf->setValue(mbin, (m_SimMdf->getValue(mbin) + (neighsurfarea / m_TotalSurfaceArea[m_FeaturePhases[i]])));
           }
         }
-        else
-        {
-          m_MisorientationLists[i][3 * j] = -100;
-          m_MisorientationLists[i][3 * j + 1] = -100;
-          m_MisorientationLists[i][3 * j + 2] = -100;
-        }
       }
     }
   }
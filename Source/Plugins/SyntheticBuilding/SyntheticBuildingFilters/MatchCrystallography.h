@@ -46,6 +46,7 @@
 
 #include "SyntheticBuilding/SyntheticBuildingConstants.h"
 #include "SyntheticBuilding/SyntheticBuildingVersion.h"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/OrientationChainRunner.hpp"
 
 /**
  * @brief The MatchCrystallography class. See [Filter documentation](@ref matchcrystallography) for details.
@@ -105,6 +106,18 @@ class MatchCrystallography : public AbstractFilter
     SIMPL_FILTER_PARAMETER(int, MaxIterations)
     Q_PROPERTY(int MaxIterations READ getMaxIterations WRITE setMaxIterations)
 
+    SIMPL_FILTER_PARAMETER(bool, UseFixedSeed)
+    Q_PROPERTY(bool UseFixedSeed READ getUseFixedSeed WRITE setUseFixedSeed)
+
+    SIMPL_FILTER_PARAMETER(int, RandomSeed)
+    Q_PROPERTY(int RandomSeed READ getRandomSeed WRITE setRandomSeed)
+
+    SIMPL_FILTER_PARAMETER(int, NumberOfChains)
+    Q_PROPERTY(int NumberOfChains READ getNumberOfChains WRITE setNumberOfChains)
+
+    SIMPL_FILTER_PARAMETER(int, ExchangeInterval)
+    Q_PROPERTY(int ExchangeInterval READ getExchangeInterval WRITE setExchangeInterval)
+
     /**
      * @brief getCompiledLibraryName Reimplemented from @see AbstractFilter class
      */
@@ -225,40 +238,16 @@ class MatchCrystallography : public AbstractFilter
     void assign_eulers(size_t ensem);
 
     /**
-     * @brief pick_euler Picks a random bin from the incoming orientation statistics
-     * @param random Key random value to compare for sampling
-     * @param numbins Number of possible bins to sample
-     * @return Integer value for bin index
-     */
-    int32_t pick_euler(float random, int32_t numbins);
-
-    /**
-     * @brief MC_LoopBody1 Determines the misorientation change after performing a swap
-     * @param feature Feature Id of Feature that has been swapped
+     * @brief initialize_chain Sets up a chain from the current orientations, ODF and MDF
+     * @param chain Chain to set up
      * @param ensem Ensemble index of the current phase
-     * @param j Neighbor index for the Feature
-     * @param neighsurfarea Surface area for the Feature neighbor
-     * @param sym Crystal structure index
-     * @param q1 Quaterions for the Feature
-     * @param q2 Quaterions for the Feature neighbor
-     */
-    void MC_LoopBody1(int32_t feature, size_t ensem, size_t j, float neighsurfarea, uint32_t sym, QuatF& q1, QuatF& q2);
-
-    /**
-     * @brief MC_LoopBody2 Reinserts the swapped orientation if the swap did not improve the fit
-     * @param feature Feature Id of the Feature that has been swapped
-     * @param phase Ensemble index of the current phase
-     * @param j Neighbor index for the Feature
-     * @param neighsurfarea Surface area for the Feature neighbor
-     * @param sym Crystal structure index
-     * @param q1 Quaternions for the Feature
-     * @param q2 Quaternions for the Feature neighbor
      */
-    void MC_LoopBody2(int32_t feature, size_t phase, size_t j, float neighsurfarea, uint32_t sym, QuatF& q1, QuatF& q2);
+    void initialize_chain(OrientationChain_t& chain, size_t ensem);
 
     /**
      * @brief matchCrystallography Swaps orientations for Features unitl convergence to
-     * the input statistics
+     * the input statistics. With more than one chain, the chains run in parallel and all of them
+     * continue from the best one every ExchangeInterval trials
      * @param ensem Ensemble index of the current phase
      */
     void matchCrystallography(size_t ensem);
@@ -291,8 +280,7 @@ class MatchCrystallography : public AbstractFilter
     StatsDataArray::WeakPointer m_StatsDataArray;
 
     // All other private instance variables
-    float m_MdfChange;
-    float m_OdfChange;
+    uint64_t m_Seed;
 
     std::vector<float> m_UnbiasedVolume;
     std::vector<float> m_TotalSurfaceArea;
@@ -302,7 +290,10 @@ class MatchCrystallography : public AbstractFilter
     FloatArrayType::Pointer m_ActualMdf;
     FloatArrayType::Pointer m_SimMdf;
 
-    std::vector<std::vector<float> > m_MisorientationLists;
+    std::vector<size_t> m_NeighborOffsets;
+    std::vector<int32_t> m_NeighborIds;
+    std::vector<float> m_AreaFractions;
+    std::vector<int32_t> m_MisorientationBins;
 
     QVector<SpaceGroupOps::Pointer> m_OrientationOps;
 
@@ -35,11 +35,13 @@
 
 #include "PackPrimaryPhases.h"
 
+#include <algorithm>
 #include <fstream>
+#include <set>
 
 #ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
 #include <tbb/parallel_for.h>
-#include <tbb/blocked_range3d.h>
+#include <tbb/blocked_range.h>
 #include <tbb/partitioner.h>
 #include <tbb/task_scheduler_init.h>
 #endif
@@ -59,6 +61,7 @@
 #include "SIMPLib/FilterParameters/OutputFileFilterParameter.h"
 #include "SIMPLib/FilterParameters/LinkedBooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
+#include "SIMPLib/FilterParameters/IntFilterParameter.h"
 #include "SIMPLib/StatsData/PrimaryStatsData.h"
 #include "SIMPLib/Utilities/SIMPLibRandom.h"
 #include "SIMPLib/Utilities/TimeUtilities.h"
@@ -68,6 +71,9 @@
 
 #include "SyntheticBuilding/SyntheticBuildingConstants.h"
 #include "SyntheticBuilding/SyntheticBuildingVersion.h"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PackingSlabs.hpp"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/ShapeRunKernel.hpp"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/SyntheticBuildingRandom.hpp"
 
 // Macro to determine if we are going to show the Debugging Output files
 #define PPP_SHOW_DEBUG_OUTPUTS 0
@@ -75,136 +81,81 @@
 
 
 /**
- * @brief The AssignVoxelsGapsImpl class implements a threaded algorithm that assigns all the voxels
- * in the volume to a unique Feature.
+ * @brief The AssignVoxelsShapes class sets up the shape ops of the Features for PackingSlabAssigner
  */
-class AssignVoxelsGapsImpl
+class AssignVoxelsShapes
 {
-    int64_t dims[3];
-    float Invradcur[3];
-    float res[3];
-    int32_t* m_FeatureIds;
-    float xc;
-    float yc;
-    float zc;
-    ShapeOps* m_ShapeOps;
-    float ga[3][3];
-    int32_t curFeature;
-    Int32ArrayType::Pointer newownersPtr;
-    FloatArrayType::Pointer ellipfuncsPtr;
+    const uint32_t* m_ShapeClasses;
+    const float* m_ShapeArgs;
 
   public:
-    AssignVoxelsGapsImpl(int64_t* dimensions, float* resolution, int32_t* featureIds, float* radCur,
-                         float* xx, ShapeOps* shapeOps, float gA[3][3], float* size, int32_t cur_feature,
-    Int32ArrayType::Pointer newowners, FloatArrayType::Pointer ellipfuncs) :
-      m_FeatureIds(featureIds),
-      m_ShapeOps(shapeOps),
-      curFeature(cur_feature)
-    {
-      dims[0] = dimensions[0];
-      dims[1] = dimensions[1];
-      dims[2] = dimensions[2];
-      Invradcur[0] = 1.0 / radCur[0];
-      Invradcur[1] = 1.0 / radCur[1];
-      Invradcur[2] = 1.0 / radCur[2];
-
-      res[0] = resolution[0];
-      res[1] = resolution[1];
-      res[2] = resolution[2];
-
-      xc = xx[0];
-      yc = xx[1];
-      zc = xx[2];
-
-      ga[0][0] = gA[0][0];
-      ga[0][1] = gA[0][1];
-      ga[0][2] = gA[0][2];
-      ga[1][0] = gA[1][0];
-      ga[1][1] = gA[1][1];
-      ga[1][2] = gA[1][2];
-      ga[2][0] = gA[2][0];
-      ga[2][1] = gA[2][1];
-      ga[2][2] = gA[2][2];
-
-      newownersPtr = newowners;
-      ellipfuncsPtr = ellipfuncs;
-
-    }
-
-    virtual ~AssignVoxelsGapsImpl() {}
-
-    // -----------------------------------------------------------------------------
-    //
-    // -----------------------------------------------------------------------------
-    void convert(int64_t zStart, int64_t zEnd, int64_t yStart, int64_t yEnd, int64_t xStart, int64_t xEnd) const
-    {
-      int64_t column = 0;
-      int64_t row = 0;
-      int64_t plane = 0;
-      int64_t index = 0;
-      float coords[3] = { 0.0f, 0.0f, 0.0f };
-      float inside = 0.0f;
-      float coordsRotated[3] = { 0.0f, 0.0f, 0.0f };
-      int32_t* newowners = newownersPtr->getPointer(0);
-      float* ellipfuncs = ellipfuncsPtr->getPointer(0);
-
-      int64_t dim0_dim_1 = dims[0] * dims[1];
-      for (int64_t iter1 = xStart; iter1 < xEnd; iter1++)
-      {
-        column = iter1;
-        if (iter1 < 0) { column = iter1 + dims[0]; }
-        else if (iter1 > dims[0] - 1) { column = iter1 - dims[0]; }
+    typedef QVector<ShapeOps::Pointer> Ops;
+    typedef ShapeOps ShapeOp;
 
-        for (int64_t iter2 = yStart; iter2 < yEnd; iter2++)
-        {
-          row = iter2;
-          if (iter2 < 0) { row = iter2 + dims[1]; }
-          else if (iter2 > dims[1] - 1) { row = iter2 - dims[1]; }
-          size_t row_dim = row * dims[0];
+    AssignVoxelsShapes(const uint32_t* shapeClasses, const float* shapeArgs) :
+      m_ShapeClasses(shapeClasses),
+      m_ShapeArgs(shapeArgs)
+    {}
 
-          for (int64_t iter3 = zStart; iter3 < zEnd; iter3++)
-          {
-            plane = iter3;
-            if (iter3 < 0) { plane = iter3 + dims[2]; }
-            else if (iter3 > dims[2] - 1) { plane = iter3 - dims[2]; }
-
-            index = static_cast<int64_t>( (plane * dim0_dim_1) + (row_dim) + column );
-
-            inside = -1.0f;
-            coords[0] = float(iter1) * res[0];
-            coords[1] = float(iter2) * res[1];
-            coords[2] = float(iter3) * res[2];
-
-            coords[0] = coords[0] - xc;
-            coords[1] = coords[1] - yc;
-            coords[2] = coords[2] - zc;
-            MatrixMath::Multiply3x3with3x1(ga, coords, coordsRotated);
-            float axis1comp = coordsRotated[0] * Invradcur[0];
-            float axis2comp = coordsRotated[1] * Invradcur[1];
-            float axis3comp = coordsRotated[2] * Invradcur[2];
-            inside = m_ShapeOps->inside(axis1comp, axis2comp, axis3comp);
-            //if (inside >= 0 && newowners[index] > 0)
-            if (inside >= 0 && newowners[index] > 0 && inside > ellipfuncs[index])
-            {
-              newowners[index] = curFeature;
-              ellipfuncs[index] = inside;
-              //newowners[index] = -2;
-              //ellipfuncs[index] = inside;
-            }
-            else if (inside >= 0 && newowners[index] == -1)
-            {
-              newowners[index] = curFeature;
-              ellipfuncs[index] = inside;
-            }
-          }
-        }
+    virtual ~AssignVoxelsShapes() {}
+
+    Ops createOps() const
+    {
+      return ShapeOps::getShapeOpsQVector();
+    }
+
+    ShapeOps* setup(Ops& ops, int64_t feature) const
+    {
+      ShapeOps* shapeOp = ops[m_ShapeClasses[feature]].get();
+      shapeOp->init();
+      QMap<ShapeOps::ArgName, float> shapeArgMap;
+      shapeArgMap[ShapeOps::Omega3] = m_ShapeArgs[4 * feature];
+      shapeArgMap[ShapeOps::VolCur] = m_ShapeArgs[4 * feature + 1];
+      shapeArgMap[ShapeOps::B_OverA] = m_ShapeArgs[4 * feature + 2];
+      shapeArgMap[ShapeOps::C_OverA] = m_ShapeArgs[4 * feature + 3];
+      shapeOp->radcur1(shapeArgMap);
+      return shapeOp;
+    }
+};
+
+/**
+ * @brief The GenerateFeaturesImpl class generates the same placement attempt for a run of consecutive
+ * Features. Every (Feature, attempt) pair draws from its own random stream, so the Features do not
+ * depend on the order in which they are generated.
+ */
+class GenerateFeaturesImpl
+{
+    PackPrimaryPhases* m_Filter;
+    int32_t m_Phase;
+    uint32_t m_ShapeClass;
+    int32_t m_FirstFeatureId;
+    size_t m_Attempt;
+    Feature_t* m_Features;
+
+  public:
+    GenerateFeaturesImpl(PackPrimaryPhases* filter, int32_t phase, uint32_t shapeclass, int32_t firstFeatureId, size_t attempt, Feature_t* features) :
+      m_Filter(filter),
+      m_Phase(phase),
+      m_ShapeClass(shapeclass),
+      m_FirstFeatureId(firstFeatureId),
+      m_Attempt(attempt),
+      m_Features(features)
+    {}
+
+    virtual ~GenerateFeaturesImpl() {}
+
+    void generate(size_t start, size_t end) const
+    {
+      for (size_t i = start; i < end; i++)
+      {
+        m_Filter->generate_feature(m_Phase, m_Features + i, m_ShapeClass, m_FirstFeatureId + static_cast<int32_t>(i), m_Attempt);
       }
     }
 
 #ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
-    void operator()(const tbb::blocked_range3d<int64_t, int64_t, int64_t>& r) const
+    void operator()(const tbb::blocked_range<size_t>& r) const
     {
-      convert(r.pages().begin(), r.pages().end(), r.rows().begin(), r.rows().end(), r.cols().begin(), r.cols().end());
+      generate(r.begin(), r.end());
     }
 #endif
 
@@ -212,7 +163,6 @@ class AssignVoxelsGapsImpl
 
 };
 
-
 // Include the MOC generated file for this class
 #include "moc_PackPrimaryPhases.cpp"
 
@@ -241,6 +191,13 @@ PackPrimaryPhases::PackPrimaryPhases() :
   m_CsvOutputFile(""),
   m_PeriodicBoundaries(false),
   m_WriteGoalAttributes(false),
+  m_UseFixedSeed(false),
+  m_RandomSeed(5489),
+  m_BatchMoveEvaluation(false),
+  m_WriteCheckpoints(false),
+  m_CheckpointInterval(100000),
+  m_ResumeFromCheckpoint(false),
+  m_CheckpointFile(""),
   m_NeighborhoodsArrayName(SIMPL::FeatureData::Neighborhoods),
   m_CentroidsArrayName(SIMPL::FeatureData::Centroids),
   m_VolumesArrayName(SIMPL::FeatureData::Volumes),
@@ -297,14 +254,14 @@ void PackPrimaryPhases::initialize()
   m_SuperEllipsoidOps = ShapeOps::NullPointer();
   m_OrthoOps = OrthoRhombicOps::New();
 
-  m_ColumnList.clear();
-  m_RowList.clear();
-  m_PlaneList.clear();
-  m_EllipFuncList.clear();
+  m_Footprints.clear();
 
   m_PointsToAdd.clear();
   m_PointsToRemove.clear();
   m_Seed = QDateTime::currentMSecsSinceEpoch();
+  m_FeatureBatch.clear();
+  m_FeatureBatchStart = 0;
+  m_FeatureBatchPhase = -1;
   m_FirstPrimaryFeature = 1;
   m_SizeX = m_SizeY = m_SizeZ = m_TotalVol = 0.0f;
   m_TotalVol = 1.0f;
@@ -330,7 +287,6 @@ void PackPrimaryPhases::initialize()
   m_PrimaryPhases.clear();
   m_PrimaryPhaseFractions.clear();
 
-  m_AvailablePointsCount = 1;
   m_FillingError = m_OldFillingError = 0.0f;
   m_CurrentNeighborhoodError = m_OldNeighborhoodError = 0.0f;
   m_CurrentSizeDistError = m_OldSizeDistError = 0.0f;
@@ -346,6 +302,15 @@ void PackPrimaryPhases::setupFilterParameters()
   parameters.push_back(SIMPL_NEW_BOOL_FP("Periodic Boundaries", PeriodicBoundaries, FilterParameter::Parameter, PackPrimaryPhases));
   QStringList linkedProps("MaskArrayPath");
   parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Use Mask", UseMask, FilterParameter::Parameter, PackPrimaryPhases, linkedProps));
+  QStringList seedProps("RandomSeed");
+  parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Use Fixed Random Seed", UseFixedSeed, FilterParameter::Parameter, PackPrimaryPhases, seedProps));
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Random Seed", RandomSeed, FilterParameter::Parameter, PackPrimaryPhases));
+  parameters.push_back(SIMPL_NEW_BOOL_FP("Evaluate Moves in Parallel Batches", BatchMoveEvaluation, FilterParameter::Parameter, PackPrimaryPhases));
+  QStringList checkpointProps("CheckpointInterval");
+  parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Write Checkpoints", WriteCheckpoints, FilterParameter::Parameter, PackPrimaryPhases, checkpointProps));
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Checkpoint Interval (Iterations)", CheckpointInterval, FilterParameter::Parameter, PackPrimaryPhases));
+  parameters.push_back(SIMPL_NEW_BOOL_FP("Resume From Checkpoint", ResumeFromCheckpoint, FilterParameter::Parameter, PackPrimaryPhases));
+  parameters.push_back(SIMPL_NEW_OUTPUT_FILE_FP("Checkpoint File", CheckpointFile, FilterParameter::Parameter, PackPrimaryPhases, "*.ckpt", "Checkpoint File"));
   parameters.push_back(SeparatorFilterParameter::New("Cell Data", FilterParameter::RequiredArray));
   {
     AttributeMatrixSelectionFilterParameter::RequirementType req = AttributeMatrixSelectionFilterParameter::CreateRequirement(SIMPL::AttributeMatrixType::Cell, SIMPL::GeometryType::ImageGeometry);
@@ -433,6 +398,13 @@ void PackPrimaryPhases::readFilterParameters(AbstractFilterParametersReader* rea
   setNumFeaturesArrayName( reader->readString("NumFeaturesArrayName", getNumFeaturesArrayName() ) );
   setPeriodicBoundaries( reader->readValue("PeriodicBoundaries", false) );
   setWriteGoalAttributes( reader->readValue("WriteGoalAttributes", false) );
+  setUseFixedSeed( reader->readValue("UseFixedSeed", getUseFixedSeed()) );
+  setRandomSeed( reader->readValue("RandomSeed", getRandomSeed()) );
+  setBatchMoveEvaluation( reader->readValue("BatchMoveEvaluation", getBatchMoveEvaluation()) );
+  setWriteCheckpoints( reader->readValue("WriteCheckpoints", getWriteCheckpoints()) );
+  setCheckpointInterval( reader->readValue("CheckpointInterval", getCheckpointInterval()) );
+  setResumeFromCheckpoint( reader->readValue("ResumeFromCheckpoint", getResumeFromCheckpoint()) );
+  setCheckpointFile( reader->readString("CheckpointFile", getCheckpointFile()) );
   setUseMask( reader->readValue("UseMask", getUseMask()) );
   setHaveFeatures( reader->readValue("HaveFeatures", getHaveFeatures()) );
   setFeatureInputFile( reader->readString( "FeatureInputFile", getFeatureInputFile() ) );
@@ -638,6 +610,27 @@ void PackPrimaryPhases::dataCheck()
     setErrorCondition(-1);
     notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
   }
+
+  if ((m_WriteCheckpoints == true || m_ResumeFromCheckpoint == true) && getCheckpointFile().isEmpty() == true)
+  {
+    QString ss = QObject::tr("The Checkpoint file must be set");
+    setErrorCondition(-1);
+    notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+  }
+
+  if (m_WriteCheckpoints == true && m_CheckpointInterval <= 0)
+  {
+    QString ss = QObject::tr("The Checkpoint interval must be greater than 0");
+    setErrorCondition(-1);
+    notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+  }
+
+  if (m_ResumeFromCheckpoint == true && getCheckpointFile().isEmpty() == false && QFile::exists(getCheckpointFile()) == false)
+  {
+    QString ss = QObject::tr("The Checkpoint file %1 does not exist").arg(getCheckpointFile());
+    setErrorCondition(-1);
+    notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -681,10 +674,11 @@ void PackPrimaryPhases::execute()
   {
     notifyStatusMessage(getMessagePrefix(), getHumanLabel(), "Packing Features || Initializing Volume");
     // this initializes the arrays to hold the details of the locations of all of the features during packing
-    Int32ArrayType::Pointer featureOwnersPtr = initialize_packinggrid();
+    PackingGrid featureOwners;
+    initialize_packinggrid(featureOwners);
     if(getErrorCondition() < 0) { return; }
     notifyStatusMessage(getMessagePrefix(), getHumanLabel(), "Packing Features || Placing Features");
-    place_features(featureOwnersPtr);
+    place_features(featureOwners);
     if(getErrorCondition() < 0) { return; }
     if (getCancel() == true) { return; }
   }
@@ -742,7 +736,7 @@ void PackPrimaryPhases::execute()
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-int32_t PackPrimaryPhases::writeVtkFile(int32_t* featureOwners, int32_t* exclusionZones)
+int32_t PackPrimaryPhases::writeVtkFile(const PackingGrid& featureOwners, const PackingGrid& exclusionZones)
 {
   size_t featureOwnersIdx = 0;
   std::ofstream outFile;
@@ -773,7 +767,7 @@ int32_t PackPrimaryPhases::writeVtkFile(int32_t* featureOwners, int32_t* exclusi
       for (int64_t k = 0; k < (m_PackingPoints[0]); k++)
       {
         featureOwnersIdx = (m_PackingPoints[0] * m_PackingPoints[1] * i) + (m_PackingPoints[0] * j) + k;
-        int32_t name = featureOwners[featureOwnersIdx];
+        int32_t name = featureOwners.getValue(featureOwnersIdx);
         if (i % 20 == 0 && i > 0) { outFile << "\n"; }
         outFile << "     ";
         if (name < 100) { outFile << " "; }
@@ -791,7 +785,7 @@ int32_t PackPrimaryPhases::writeVtkFile(int32_t* featureOwners, int32_t* exclusi
       for (int64_t k = 0; k < (m_PackingPoints[0]); k++)
       {
         featureOwnersIdx = (m_PackingPoints[0] * m_PackingPoints[1] * i) + (m_PackingPoints[0] * j) + k;
-        int32_t val = exclusionZones[featureOwnersIdx];
+        int32_t val = exclusionZones.getValue(featureOwnersIdx);
         if (i % 20 == 0 && i > 0) { outFile << "\n"; }
         outFile << "       ";
         outFile << val;
@@ -864,7 +858,7 @@ void PackPrimaryPhases::load_features()
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void PackPrimaryPhases::place_features(Int32ArrayType::Pointer featureOwnersPtr)
+void PackPrimaryPhases::place_features(PackingGrid& featureOwners)
 {
   bool writeErrorFile = false;
   std::ofstream outFile;
@@ -875,8 +869,22 @@ void PackPrimaryPhases::place_features(Int32ArrayType::Pointer featureOwnersPtr)
   }
 
   setErrorCondition(0);
-  m_Seed = QDateTime::currentMSecsSinceEpoch();
-  SIMPL_RANDOMNG_NEW_SEEDED(m_Seed);
+  m_Seed = SyntheticBuildingRandom::ResolveSeed(m_UseFixedSeed, m_RandomSeed);
+  // A resumed run regenerates the same Features from the seed stored in the checkpoint
+  PackingCheckpoint checkpoint;
+  if (m_ResumeFromCheckpoint == true)
+  {
+    if (checkpoint.readFile(m_CheckpointFile) < 0 || checkpoint.getValue("Seed", m_Seed) == false)
+    {
+      QString ss = QObject::tr("Could not read the Checkpoint file %1").arg(m_CheckpointFile);
+      setErrorCondition(-1);
+      notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+      return;
+    }
+  }
+  SyntheticBuildingRandom rg(m_Seed, SyntheticBuildingRandom::PackPrimaryPhasesPlacement);
+  m_FeatureBatch.clear();
+  m_FeatureBatchPhase = -1;
 
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getOutputCellAttributeMatrixPath().getDataContainerName());
 
@@ -954,30 +962,16 @@ void PackPrimaryPhases::place_features(Int32ArrayType::Pointer featureOwnersPtr)
     m_PrimaryPhaseFractions[i] = m_PrimaryPhaseFractions[i] / totalprimaryfractions;
   }
 
-  QVector<size_t> cDim(1, 1);
-  Int32ArrayType::Pointer exclusionOwnersPtr = Int32ArrayType::CreateArray(m_TotalPackingPoints, cDim, "_INTERNAL_USE_ONLY_PackPrimaryFeatures::exclusions_owners");
-  exclusionOwnersPtr->initializeWithValue(0);
+  // Tiles of the grids are only allocated where some Feature covers or excludes a packing point
+  PackingGrid exclusionOwners;
+  exclusionOwners.resize(m_TotalPackingPoints);
 
   // This is the set that we are going to keep updated with the points that are not in an exclusion zone
-  std::map<size_t, size_t> availablePoints;
-  std::map<size_t, size_t> availablePointsInv;
-
-  // Get a pointer to the Feature Owners that was just initialized in the initialize_packinggrid() method
-  int32_t* featureOwners = featureOwnersPtr->getPointer(0);
-  int32_t* exclusionOwners = exclusionOwnersPtr->getPointer(0);
+  PackingAvailablePoints availablePoints;
   int64_t featureOwnersIdx = 0;
 
   // determine initial set of available points
-  m_AvailablePointsCount = 0;
-  for (int64_t i = 0; i < m_TotalPackingPoints; i++)
-  {
-    if ((exclusionOwners[i] == 0 && m_UseMask == false) || (exclusionOwners[i] == 0 && m_UseMask == true && m_Mask[i] == true))
-    {
-      availablePoints[i] = m_AvailablePointsCount;
-      availablePointsInv[m_AvailablePointsCount] = i;
-      m_AvailablePointsCount++;
-    }
-  }
+  availablePoints.rebuild(exclusionOwners, m_UseMask == true ? m_Mask : NULL);
   // and clear the pointsToRemove and pointsToAdd vectors from the initial packing
   m_PointsToRemove.clear();
   m_PointsToAdd.clear();
@@ -1042,9 +1036,8 @@ void PackPrimaryPhases::place_features(Int32ArrayType::Pointer featureOwnersPtr)
     while (curphasevol[j] < (factor * curphasetotalvol))
     {
       iter++;
-      m_Seed++;
       phase = m_PrimaryPhases[j];
-      generate_feature(phase, &feature, m_ShapeTypes[phase]);
+      next_feature(phase, &feature, m_ShapeTypes[phase], gid, iter);
       m_CurrentSizeDistError = check_sizedisterror(&feature);
       change = (m_CurrentSizeDistError) - (m_OldSizeDistError);
       if (change > 0.0f || m_CurrentSizeDistError > (1.0f - (float(iter) * 0.001f)) || curphasevol[j] < (0.75f * factor * curphasetotalvol))
@@ -1086,9 +1079,8 @@ void PackPrimaryPhases::place_features(Int32ArrayType::Pointer featureOwnersPtr)
       while (curphasevol[j] < ((1 + factor) * curphasetotalvol))
       {
         iter++;
-        m_Seed++;
         phase = m_PrimaryPhases[j];
-        generate_feature(phase, &feature, m_ShapeTypes[phase]);
+        next_feature(phase, &feature, m_ShapeTypes[phase], gid, iter);
         m_CurrentSizeDistError = check_sizedisterror(&feature);
         change = (m_CurrentSizeDistError) - (m_OldSizeDistError);
         if (change > 0 || m_CurrentSizeDistError > (1.0f - (iter * 0.001f)) || curphasevol[j] < (0.75f * factor * curphasetotalvol))
@@ -1174,10 +1166,7 @@ void PackPrimaryPhases::place_features(Int32ArrayType::Pointer featureOwnersPtr)
 
   if (getCancel() == true) { return; }
 
-  m_ColumnList.resize(totalFeatures);
-  m_RowList.resize(totalFeatures);
-  m_PlaneList.resize(totalFeatures);
-  m_EllipFuncList.resize(totalFeatures);
+  m_Footprints.resize(totalFeatures);
   m_PackQualities.resize(totalFeatures);
   m_FillingError = 1.0f;
 
@@ -1222,7 +1211,7 @@ void PackPrimaryPhases::place_features(Int32ArrayType::Pointer featureOwnersPtr)
     plane = static_cast<int64_t>( (zc - (m_HalfPackingRes[2])) * m_OneOverPackingRes[2] );
     featureOwnersIdx = (m_PackingPoints[0] * m_PackingPoints[1] * plane) + (m_PackingPoints[0] * row) + column;
     // now we walk til we find a point that is not in an exclusion zone
-    while (exclusionOwners[featureOwnersIdx] > 0 && count < m_TotalPackingPoints)
+    while (exclusionOwners.getValue(featureOwnersIdx) > 0 && count < m_TotalPackingPoints)
     {
       featureOwnersIdx++;
       if (featureOwnersIdx >= m_TotalPackingPoints) { featureOwnersIdx = 0; }
@@ -1235,7 +1224,9 @@ void PackPrimaryPhases::place_features(Int32ArrayType::Pointer featureOwnersPtr)
     yc = static_cast<float>((row * m_PackingRes[1]) + (m_PackingRes[1] * 0.5));
     zc = static_cast<float>((plane * m_PackingRes[2]) + (m_PackingRes[2] * 0.5));
     move_feature(i, xc, yc, zc);
-    m_FillingError = check_fillingerror(i, -1000, featureOwnersPtr, exclusionOwnersPtr);
+    m_FillingError = check_fillingerror(i, -1000, featureOwners, exclusionOwners);
+    // the available points are counted from scratch once every Feature is placed
+    m_PointsToRemove.clear();
   }
 
   progFeature = 0;
@@ -1268,16 +1259,7 @@ void PackPrimaryPhases::place_features(Int32ArrayType::Pointer featureOwnersPtr)
   int32_t totalAdjustments = static_cast<int32_t>(100 * (totalFeatures - 1));
 
   // determine initial set of available points
-  m_AvailablePointsCount = 0;
-  for (int64_t i = 0; i < m_TotalPackingPoints; i++)
-  {
-    if ((exclusionOwners[i] == 0 && m_UseMask == false) || (exclusionOwners[i] == 0 && m_UseMask == true && m_Mask[i] == true))
-    {
-      availablePoints[i] = m_AvailablePointsCount;
-      availablePointsInv[m_AvailablePointsCount] = i;
-      m_AvailablePointsCount++;
-    }
-  }
+  availablePoints.rebuild(exclusionOwners, m_UseMask == true ? m_Mask : NULL);
 
   // and clear the pointsToRemove and pointsToAdd vectors from the initial packing
   m_PointsToRemove.clear();
@@ -1286,10 +1268,26 @@ void PackPrimaryPhases::place_features(Int32ArrayType::Pointer featureOwnersPtr)
   millis = QDateTime::currentMSecsSinceEpoch();
   startMillis = millis;
   bool good = false;
-  size_t key = 0;
+  int64_t key = 0;
   float xshift = 0.0f, yshift = 0.0f, zshift = 0.0f;
   int32_t lastIteration = 0;
-  for (int32_t iteration = 0; iteration < totalAdjustments; ++iteration)
+  int32_t startIteration = 0;
+  if (m_ResumeFromCheckpoint == true)
+  {
+    startIteration = restore_checkpoint(checkpoint, rg, totalFeatures, featureOwners, exclusionOwners, availablePoints, acceptedmoves);
+    if (getErrorCondition() < 0) { return; }
+    checkpoint.clear();
+  }
+  PackingCheckpointWriter checkpointWriter;
+  int32_t nextCheckpoint = startIteration + m_CheckpointInterval;
+  if (m_BatchMoveEvaluation == true)
+  {
+    batch_move_features(rg, startIteration, totalAdjustments, totalFeatures, featureOwners, exclusionOwners, availablePoints, checkpointWriter, acceptedmoves);
+    if (getCancel() == true) { return; }
+    // All of the moves were made in batches, so there is nothing left for the loop below
+    totalAdjustments = 0;
+  }
+  for (int32_t iteration = startIteration; iteration < totalAdjustments; ++iteration)
   {
     currentMillis = QDateTime::currentMSecsSinceEpoch();
     if (currentMillis - millis > 1000)
@@ -1305,6 +1303,11 @@ void PackPrimaryPhases::place_features(Int32ArrayType::Pointer featureOwnersPtr)
       lastIteration = iteration;
     }
 
+    if (m_WriteCheckpoints == true && (iteration >= nextCheckpoint || getCancel() == true))
+    {
+      write_checkpoint(checkpointWriter, iteration, acceptedmoves, rg, featureOwners, exclusionOwners, availablePoints);
+      nextCheckpoint = iteration + m_CheckpointInterval;
+    }
 
     if (getCancel() == true) { return; }
 
@@ -1312,7 +1315,7 @@ void PackPrimaryPhases::place_features(Int32ArrayType::Pointer featureOwnersPtr)
 
     if (writeErrorFile == true && iteration % 25 == 0)
     {
-      outFile << iteration << " " << m_FillingError << "  " << availablePoints.size() << "  " << m_AvailablePointsCount << " " << totalFeatures << " " << acceptedmoves << "\n";
+      outFile << iteration << " " << m_FillingError << "  " << availablePoints.getCount() << " " << totalFeatures << " " << acceptedmoves << "\n";
     }
 
     // JUMP - this option moves one feature to a random spot in the volume
@@ -1330,17 +1333,16 @@ void PackPrimaryPhases::place_features(Int32ArrayType::Pointer featureOwnersPtr)
         row = static_cast<int64_t>( (yc - (m_HalfPackingRes[1])) * m_OneOverPackingRes[1] );
         plane = static_cast<int64_t>( (zc - (m_HalfPackingRes[2])) * m_OneOverPackingRes[2] );
         featureOwnersIdx = (m_PackingPoints[0] * m_PackingPoints[1] * plane) + (m_PackingPoints[0] * row) + column;
-        if (featureOwners[featureOwnersIdx] > 1) { good = true; }
+        if (featureOwners.getValue(featureOwnersIdx) > 1) { good = true; }
         else { randomfeature++; }
         if (static_cast<size_t>(randomfeature) >= totalFeatures) { randomfeature = m_FirstPrimaryFeature; }
         count++;
       }
-      m_Seed++;
 
-      if (availablePoints.size() > 0)
+      if (availablePoints.getCount() > 0)
       {
-        key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
-        featureOwnersIdx = availablePointsInv[key];
+        key = static_cast<int64_t>(rg.genrand_res53() * (availablePoints.getCount() - 1));
+        featureOwnersIdx = availablePoints.getPoint(exclusionOwners, key);
       }
       else
       {
@@ -1358,21 +1360,21 @@ void PackPrimaryPhases::place_features(Int32ArrayType::Pointer featureOwnersPtr)
       oldyc = m_Centroids[3 * randomfeature + 1];
       oldzc = m_Centroids[3 * randomfeature + 2];
       m_OldFillingError = m_FillingError;
-      m_FillingError = check_fillingerror(-1000, static_cast<int32_t>(randomfeature), featureOwnersPtr, exclusionOwnersPtr);
+      m_FillingError = check_fillingerror(-1000, static_cast<int32_t>(randomfeature), featureOwners, exclusionOwners);
       move_feature(randomfeature, xc, yc, zc);
-      m_FillingError = check_fillingerror(static_cast<int32_t>(randomfeature), -1000, featureOwnersPtr, exclusionOwnersPtr);
+      m_FillingError = check_fillingerror(static_cast<int32_t>(randomfeature), -1000, featureOwners, exclusionOwners);
       m_CurrentNeighborhoodError = check_neighborhooderror(-1000, randomfeature);
       if (m_FillingError <= m_OldFillingError)
       {
         m_OldNeighborhoodError = m_CurrentNeighborhoodError;
-        update_availablepoints(availablePoints, availablePointsInv);
+        update_availablepoints(availablePoints);
         acceptedmoves++;
       }
       else if (m_FillingError > m_OldFillingError)
       {
-        m_FillingError = check_fillingerror(-1000, static_cast<int32_t>(randomfeature), featureOwnersPtr, exclusionOwnersPtr);
+        m_FillingError = check_fillingerror(-1000, static_cast<int32_t>(randomfeature), featureOwners, exclusionOwners);
         move_feature(randomfeature, oldxc, oldyc, oldzc);
-        m_FillingError = check_fillingerror(static_cast<int32_t>(randomfeature), -1000, featureOwnersPtr, exclusionOwnersPtr);
+        m_FillingError = check_fillingerror(static_cast<int32_t>(randomfeature), -1000, featureOwners, exclusionOwners);
         m_PointsToRemove.clear();
         m_PointsToAdd.clear();
       }
@@ -1393,12 +1395,11 @@ void PackPrimaryPhases::place_features(Int32ArrayType::Pointer featureOwnersPtr)
         row = static_cast<int64_t>( (yc - (m_HalfPackingRes[1])) * m_OneOverPackingRes[1] );
         plane = static_cast<int64_t>( (zc - (m_HalfPackingRes[2])) * m_OneOverPackingRes[2] );
         featureOwnersIdx = (m_PackingPoints[0] * m_PackingPoints[1] * plane) + (m_PackingPoints[0] * row) + column;
-        if (featureOwners[featureOwnersIdx] > 1) { good = true; }
+        if (featureOwners.getValue(featureOwnersIdx) > 1) { good = true; }
         else { randomfeature++; }
         if (static_cast<size_t>(randomfeature) >= totalFeatures) { randomfeature = m_FirstPrimaryFeature; }
         count++;
       }
-      m_Seed++;
       oldxc = m_Centroids[3 * randomfeature];
       oldyc = m_Centroids[3 * randomfeature + 1];
       oldzc = m_Centroids[3 * randomfeature + 2];
@@ -1412,33 +1413,35 @@ void PackPrimaryPhases::place_features(Int32ArrayType::Pointer featureOwnersPtr)
       if ((oldzc + zshift) < m_SizeZ && (oldzc + zshift) > 0) { zc = oldzc + zshift; }
       else { zc = oldzc; }
       m_OldFillingError = m_FillingError;
-      m_FillingError = check_fillingerror(-1000, static_cast<int32_t>(randomfeature), featureOwnersPtr, exclusionOwnersPtr);
+      m_FillingError = check_fillingerror(-1000, static_cast<int32_t>(randomfeature), featureOwners, exclusionOwners);
       move_feature(randomfeature, xc, yc, zc);
-      m_FillingError = check_fillingerror(static_cast<int32_t>(randomfeature), -1000, featureOwnersPtr, exclusionOwnersPtr);
+      m_FillingError = check_fillingerror(static_cast<int32_t>(randomfeature), -1000, featureOwners, exclusionOwners);
       m_CurrentNeighborhoodError = check_neighborhooderror(-1000, randomfeature);
       //      change2 = (currentneighborhooderror * currentneighborhooderror) - (oldneighborhooderror * oldneighborhooderror);
       //      if(fillingerror <= oldfillingerror && currentneighborhooderror >= oldneighborhooderror)
       if (m_FillingError <= m_OldFillingError)
       {
         m_OldNeighborhoodError = m_CurrentNeighborhoodError;
-        update_availablepoints(availablePoints, availablePointsInv);
+        update_availablepoints(availablePoints);
         acceptedmoves++;
       }
       //      else if(fillingerror > oldfillingerror || currentneighborhooderror < oldneighborhooderror)
       else if (m_FillingError > m_OldFillingError)
       {
-        m_FillingError = check_fillingerror(-1000, static_cast<int>(randomfeature), featureOwnersPtr, exclusionOwnersPtr);
+        m_FillingError = check_fillingerror(-1000, static_cast<int>(randomfeature), featureOwners, exclusionOwners);
         move_feature(randomfeature, oldxc, oldyc, oldzc);
-        m_FillingError = check_fillingerror(static_cast<int>(randomfeature), -1000, featureOwnersPtr, exclusionOwnersPtr);
+        m_FillingError = check_fillingerror(static_cast<int>(randomfeature), -1000, featureOwners, exclusionOwners);
         m_PointsToRemove.clear();
         m_PointsToAdd.clear();
       }
     }
   }
 
+  notify_packinggrid_memory(featureOwners, exclusionOwners, availablePoints);
+
   if (m_VtkOutputFile.isEmpty() == false)
   {
-    int32_t err = writeVtkFile(featureOwnersPtr->getPointer(0), exclusionOwnersPtr->getPointer(0));
+    int32_t err = writeVtkFile(featureOwners, exclusionOwners);
     if (err < 0)
     {
       QString ss = QObject::tr("Error writing Vtk file");
@@ -1452,7 +1455,7 @@ void PackPrimaryPhases::place_features(Int32ArrayType::Pointer featureOwnersPtr)
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-Int32ArrayType::Pointer PackPrimaryPhases::initialize_packinggrid()
+void PackPrimaryPhases::initialize_packinggrid(PackingGrid& featureOwners)
 {
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getOutputCellAttributeMatrixPath().getDataContainerName());
 
@@ -1483,18 +1486,16 @@ Int32ArrayType::Pointer PackPrimaryPhases::initialize_packinggrid()
 
   m_TotalPackingPoints = m_PackingPoints[0] * m_PackingPoints[1] * m_PackingPoints[2];
 
-  Int32ArrayType::Pointer featureOwnersPtr = Int32ArrayType::CreateArray(m_TotalPackingPoints, "_INTERNAL_USE_ONLY_PackPrimaryFeatures::feature_owners");
-  featureOwnersPtr->initializeWithZeros();
-
-  return featureOwnersPtr;
+  featureOwners.resize(m_TotalPackingPoints);
 }
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void PackPrimaryPhases::generate_feature(int32_t phase, Feature_t* feature, uint32_t shapeclass)
+void PackPrimaryPhases::generate_feature(int32_t phase, Feature_t* feature, uint32_t shapeclass, int32_t featureId, size_t attempt)
 {
-  SIMPL_RANDOMNG_NEW_SEEDED(m_Seed)
+  // Each (feature, attempt) has its own stream so candidates do not depend on how many numbers earlier candidates used
+  SyntheticBuildingRandom rg(m_Seed, SyntheticBuildingRandom::PackPrimaryPhasesFeatures, static_cast<uint32_t>(featureId), static_cast<uint32_t>(attempt));
 
       StatsDataArray& statsDataArray = *(m_StatsDataArray.lock().get());
 
@@ -1571,7 +1572,7 @@ void PackPrimaryPhases::generate_feature(int32_t phase, Feature_t* feature, uint
     totaldensity = totaldensity + density;
     if (random < totaldensity && random >= td1) { bin = j; break; }
   }
-  FOrientArrayType eulers = m_OrthoOps->determineEulerAngles(m_Seed, bin);
+  FOrientArrayType eulers = m_OrthoOps->determineEulerAngles(rg.genrand_int64(), bin);
   VectorOfFloatArray omega3 = pp->getFeatureSize_Omegas();
   float mf = omega3[0]->getValue(diameter);
   float s = omega3[1]->getValue(diameter);
@@ -1591,6 +1592,41 @@ void PackPrimaryPhases::generate_feature(int32_t phase, Feature_t* feature, uint
   feature->m_Neighborhoods = 0;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PackPrimaryPhases::next_feature(int32_t phase, Feature_t* feature, uint32_t shapeclass, int32_t featureId, size_t attempt)
+{
+  if (attempt != 1)
+  {
+    generate_feature(phase, feature, shapeclass, featureId, attempt);
+    return;
+  }
+
+  if (phase != m_FeatureBatchPhase || featureId < m_FeatureBatchStart || featureId >= m_FeatureBatchStart + static_cast<int32_t>(m_FeatureBatch.size()))
+  {
+    const size_t batchSize = 1024;
+    m_FeatureBatch.resize(batchSize);
+    m_FeatureBatchStart = featureId;
+    m_FeatureBatchPhase = phase;
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+    tbb::task_scheduler_init init;
+    bool doParallel = true;
+    if (doParallel == true)
+    {
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, batchSize),
+                        GenerateFeaturesImpl(this, phase, shapeclass, featureId, attempt, &(m_FeatureBatch.front())), tbb::auto_partitioner());
+    }
+    else
+#endif
+    {
+      GenerateFeaturesImpl serial(this, phase, shapeclass, featureId, attempt, &(m_FeatureBatch.front()));
+      serial.generate(0, batchSize);
+    }
+  }
+  *feature = m_FeatureBatch[featureId - m_FeatureBatchStart];
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -1632,19 +1668,321 @@ void PackPrimaryPhases::move_feature(size_t gnum, float xc, float yc, float zc)
   m_Centroids[3 * gnum] = xc;
   m_Centroids[3 * gnum + 1] = yc;
   m_Centroids[3 * gnum + 2] = zc;
-  size_t size = m_ColumnList[gnum].size();
+  m_Footprints[gnum].translate(shiftcolumn, shiftrow, shiftplane);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PackPrimaryPhases::batch_move_features(SyntheticBuildingRandom& rg, int32_t startIteration, int32_t totalAdjustments, size_t totalFeatures, PackingGrid& featureOwners, PackingGrid& exclusionOwners,
+                                            PackingAvailablePoints& availablePoints, PackingCheckpointWriter& checkpointWriter, int32_t& acceptedmoves)
+{
+  PackingMoveEvaluator evaluator(m_PackingPoints, m_PeriodicBoundaries, m_Footprints);
+
+  const int32_t batchSize = 256;
+  std::vector<PackingMove_t> moves;
+  std::vector<float> targets;
+  std::vector<int64_t> deltas;
+  std::vector<std::vector<int64_t> > cells;
+  // Packing points touched by the moves committed in the current batch, and the batch that last moved each Feature
+  std::set<int64_t> claimedPoints;
+  std::vector<int32_t> movedFeatures(totalFeatures, -1);
+
+  int32_t randomfeature = 0;
+  int32_t count = 0;
+  bool good = false;
+  int64_t key = 0;
+  size_t featureOwnersIdx = 0;
+  int64_t column = 0, row = 0, plane = 0;
+  float xc = 0.0f, yc = 0.0f, zc = 0.0f;
+  float oldxc = 0.0f, oldyc = 0.0f, oldzc = 0.0f;
+  float xshift = 0.0f, yshift = 0.0f, zshift = 0.0f;
+  int32_t nextCheckpoint = startIteration + m_CheckpointInterval;
+
+  uint64_t millis = QDateTime::currentMSecsSinceEpoch();
+  uint64_t currentMillis = millis;
+  uint64_t startMillis = millis;
+  uint64_t estimatedTime = 0;
+  float timeDiff = 0.0f;
+
+  for (int32_t batchStart = startIteration; batchStart < totalAdjustments; batchStart += batchSize)
+  {
+    currentMillis = QDateTime::currentMSecsSinceEpoch();
+    if (currentMillis - millis > 1000)
+    {
+      QString ss = QObject::tr("Swapping/Moving/Adding/Removing Features Iteration %1/%2").arg(batchStart).arg(totalAdjustments);
+      timeDiff = ((float)batchStart / (float)(currentMillis - startMillis));
+      estimatedTime = (float)(totalAdjustments - batchStart) / timeDiff;
+
+      ss += QObject::tr(" || Est. Time Remain: %1 || Iterations/Sec: %2").arg(DREAM3D::convertMillisToHrsMinSecs(estimatedTime)).arg(timeDiff * 1000);
+      notifyStatusMessage(getMessagePrefix(), getHumanLabel(), ss);
+
+      millis = QDateTime::currentMSecsSinceEpoch();
+    }
+
+    if (m_WriteCheckpoints == true && (batchStart >= nextCheckpoint || getCancel() == true))
+    {
+      write_checkpoint(checkpointWriter, batchStart, acceptedmoves, rg, featureOwners, exclusionOwners, availablePoints);
+      nextCheckpoint = batchStart + m_CheckpointInterval;
+    }
+
+    if (getCancel() == true) { return; }
+
+    int32_t batch = batchStart / batchSize;
+    int32_t batchEnd = std::min(batchStart + batchSize, totalAdjustments);
+    moves.resize(batchEnd - batchStart);
+    targets.resize(3 * moves.size());
+    claimedPoints.clear();
+
+    // propose the moves serially, exactly as the unbatched loop picks them, but against the grid as it is at the start of the batch
+    for (int32_t iteration = batchStart; iteration < batchEnd; ++iteration)
+    {
+      randomfeature = m_FirstPrimaryFeature + int32_t(rg.genrand_res53() * (totalFeatures - m_FirstPrimaryFeature));
+      good = false;
+      count = 0;
+      while (good == false && count < static_cast<int32_t>((totalFeatures - m_FirstPrimaryFeature)) )
+      {
+        xc = m_Centroids[3 * randomfeature];
+        yc = m_Centroids[3 * randomfeature + 1];
+        zc = m_Centroids[3 * randomfeature + 2];
+        column = static_cast<int64_t>( (xc - (m_HalfPackingRes[0])) * m_OneOverPackingRes[0] );
+        row = static_cast<int64_t>( (yc - (m_HalfPackingRes[1])) * m_OneOverPackingRes[1] );
+        plane = static_cast<int64_t>( (zc - (m_HalfPackingRes[2])) * m_OneOverPackingRes[2] );
+        featureOwnersIdx = (m_PackingPoints[0] * m_PackingPoints[1] * plane) + (m_PackingPoints[0] * row) + column;
+        if (featureOwners.getValue(featureOwnersIdx) > 1) { good = true; }
+        else { randomfeature++; }
+        if (static_cast<size_t>(randomfeature) >= totalFeatures) { randomfeature = m_FirstPrimaryFeature; }
+        count++;
+      }
+      oldxc = m_Centroids[3 * randomfeature];
+      oldyc = m_Centroids[3 * randomfeature + 1];
+      oldzc = m_Centroids[3 * randomfeature + 2];
+
+      // JUMP - this option moves one feature to a random spot in the volume
+      if (iteration % 2 == 0)
+      {
+        if (availablePoints.getCount() > 0)
+        {
+          key = static_cast<int64_t>(rg.genrand_res53() * (availablePoints.getCount() - 1));
+          featureOwnersIdx = availablePoints.getPoint(exclusionOwners, key);
+        }
+        else
+        {
+          featureOwnersIdx = static_cast<size_t>(rg.genrand_res53() * m_TotalPackingPoints);
+        }
+        column = static_cast<int64_t>(featureOwnersIdx % m_PackingPoints[0]);
+        row = static_cast<int64_t>(featureOwnersIdx / m_PackingPoints[0]) % m_PackingPoints[1];
+        plane = static_cast<int64_t>(featureOwnersIdx / (m_PackingPoints[0] * m_PackingPoints[1]));
+        xc = static_cast<float>((column * m_PackingRes[0]) + (m_PackingRes[0] * 0.5));
+        yc = static_cast<float>((row * m_PackingRes[1]) + (m_PackingRes[1] * 0.5));
+        zc = static_cast<float>((plane * m_PackingRes[2]) + (m_PackingRes[2] * 0.5));
+      }
+      // NUDGE - this option moves one feature to a spot close to its current centroid
+      else
+      {
+        xshift = static_cast<float>(((2.0f * (rg.genrand_res53() - 0.5f)) * (2.0f * m_PackingRes[0])) );
+        yshift = static_cast<float>(((2.0f * (rg.genrand_res53() - 0.5f)) * (2.0f * m_PackingRes[1])) );
+        zshift = static_cast<float>(((2.0f * (rg.genrand_res53() - 0.5f)) * (2.0f * m_PackingRes[2])) );
+        if ((oldxc + xshift) < m_SizeX && (oldxc + xshift) > 0) { xc = oldxc + xshift; }
+        else { xc = oldxc; }
+        if ((oldyc + yshift) < m_SizeY && (oldyc + yshift) > 0) { yc = oldyc + yshift; }
+        else { yc = oldyc; }
+        if ((oldzc + zshift) < m_SizeZ && (oldzc + zshift) > 0) { zc = oldzc + zshift; }
+        else { zc = oldzc; }
+      }
+
+      size_t m = static_cast<size_t>(iteration - batchStart);
+      moves[m].m_Feature = randomfeature;
+      targets[3 * m] = xc;
+      targets[3 * m + 1] = yc;
+      targets[3 * m + 2] = zc;
+      set_move_shift(moves[m], xc, yc, zc);
+    }
+
+    // evaluate every move of the batch in parallel against the current grid
+    evaluator.evaluateMoves(featureOwners, moves, deltas, cells);
+
+    // commit in proposal order; a move that overlaps one committed earlier in this batch is re-evaluated first
+    for (size_t m = 0; m < moves.size(); m++)
+    {
+      randomfeature = moves[m].m_Feature;
+      bool stale = (movedFeatures[randomfeature] == batch);
+      for (size_t c = 0; c < cells[m].size() && stale == false; c++)
+      {
+        if (claimedPoints.find(cells[m][c]) != claimedPoints.end()) { stale = true; }
+      }
+      if (stale == true)
+      {
+        set_move_shift(moves[m], targets[3 * m], targets[3 * m + 1], targets[3 * m + 2]);
+        deltas[m] = evaluator.moveDelta(featureOwners, moves[m], cells[m]);
+      }
+      if (deltas[m] <= 0)
+      {
+        m_OldFillingError = m_FillingError;
+        m_FillingError = check_fillingerror(-1000, static_cast<int32_t>(randomfeature), featureOwners, exclusionOwners);
+        move_feature(randomfeature, targets[3 * m], targets[3 * m + 1], targets[3 * m + 2]);
+        m_FillingError = check_fillingerror(static_cast<int32_t>(randomfeature), -1000, featureOwners, exclusionOwners);
+        update_availablepoints(availablePoints);
+        acceptedmoves++;
+        movedFeatures[randomfeature] = batch;
+        for (size_t c = 0; c < cells[m].size(); c++)
+        {
+          claimedPoints.insert(cells[m][c]);
+        }
+      }
+    }
+  }
 
-  for (size_t i = 0; i < size; i++)
+  // the neighborhoods only enter the acceptance through the stored error, so they are rebuilt once for the final packing
+  for (size_t i = m_FirstPrimaryFeature; i < totalFeatures; i++)
   {
-    int64_t& cl = m_ColumnList[gnum][i];
-    cl += shiftcolumn;
-    int64_t& rl = m_RowList[gnum][i];
-    rl += shiftrow;
-    int64_t& pl = m_PlaneList[gnum][i];
-    pl += shiftplane;
+    m_Neighborhoods[i] = 0;
+  }
+  for (size_t i = m_FirstPrimaryFeature; i < totalFeatures; i++)
+  {
+    determine_neighbors(i, true);
+  }
+  m_OldNeighborhoodError = check_neighborhooderror(-1000, -1000);
+  m_CurrentNeighborhoodError = m_OldNeighborhoodError;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PackPrimaryPhases::write_checkpoint(PackingCheckpointWriter& checkpointWriter, int32_t iteration, int32_t acceptedmoves, const SyntheticBuildingRandom& rg, const PackingGrid& featureOwners,
+                                         const PackingGrid& exclusionOwners, const PackingAvailablePoints& availablePoints)
+{
+  size_t totalFeatures = m_FeaturePhasesPtr.lock()->getNumberOfTuples();
+  uint64_t randomPosition = 0;
+  bool randomHaveNormal = false;
+  double randomNormal = 0.0;
+  rg.getState(randomPosition, randomHaveNormal, randomNormal);
+
+  PackingCheckpoint checkpoint;
+  checkpoint.setValue("Seed", m_Seed);
+  checkpoint.setValue("Iteration", iteration);
+  checkpoint.setValue("BatchMoveEvaluation", m_BatchMoveEvaluation);
+  checkpoint.setValue("AcceptedMoves", acceptedmoves);
+  checkpoint.setValue("RandomPosition", randomPosition);
+  checkpoint.setValue("RandomHaveNormal", randomHaveNormal);
+  checkpoint.setValue("RandomNormal", randomNormal);
+  checkpoint.setArray("PackingPoints", m_PackingPoints, 3);
+  checkpoint.setArray("Volumes", m_Volumes, totalFeatures);
+  checkpoint.setArray("Centroids", m_Centroids, 3 * totalFeatures);
+  checkpoint.setArray("Neighborhoods", m_Neighborhoods, totalFeatures);
+  checkpoint.setArray("PackQualities", m_PackQualities);
+  // only the allocated tiles of the grids are stored; the available points are recounted from the exclusion zones
+  std::vector<int64_t> tiles;
+  std::vector<int32_t> values;
+  featureOwners.getTiles(tiles, values);
+  checkpoint.setArray("FeatureOwnerTiles", tiles);
+  checkpoint.setArray("FeatureOwnerValues", values);
+  exclusionOwners.getTiles(tiles, values);
+  checkpoint.setArray("ExclusionOwnerTiles", tiles);
+  checkpoint.setArray("ExclusionOwnerValues", values);
+  checkpoint.setValue("AvailablePointsCount", static_cast<uint64_t>(availablePoints.getCount()));
+  checkpoint.setValue("FillingError", m_FillingError);
+  checkpoint.setValue("OldNeighborhoodError", m_OldNeighborhoodError);
+
+  // the snapshot is handed to the writer, so the loop continues while the file is written
+  if (checkpointWriter.write(checkpoint, m_CheckpointFile) < 0)
+  {
+    QString ss = QObject::tr("Could not write the Checkpoint file %1").arg(m_CheckpointFile);
+    notifyWarningMessage(getHumanLabel(), ss, -1);
   }
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int32_t PackPrimaryPhases::restore_checkpoint(const PackingCheckpoint& checkpoint, SyntheticBuildingRandom& rg, size_t totalFeatures, PackingGrid& featureOwners, PackingGrid& exclusionOwners,
+                                              PackingAvailablePoints& availablePoints, int32_t& acceptedmoves)
+{
+  int32_t iteration = 0;
+  bool batchMoveEvaluation = false;
+  int64_t packingPoints[3] = { 0, 0, 0 };
+  std::vector<float> volumes;
+  std::vector<float> centroids;
+  bool good = checkpoint.getValue("Iteration", iteration) && checkpoint.getValue("BatchMoveEvaluation", batchMoveEvaluation)
+              && checkpoint.getArray("PackingPoints", packingPoints, 3) && checkpoint.getArray("Volumes", volumes) && checkpoint.getArray("Centroids", centroids);
+
+  // the Features are regenerated from the seed, so they must match the ones the checkpoint was taken with
+  if (good == true)
+  {
+    good = (batchMoveEvaluation == m_BatchMoveEvaluation && volumes.size() == totalFeatures && centroids.size() == 3 * totalFeatures);
+    for (size_t i = 0; i < 3; i++)
+    {
+      if (packingPoints[i] != m_PackingPoints[i]) { good = false; }
+    }
+    for (size_t i = 0; i < volumes.size() && good == true; i++)
+    {
+      if (volumes[i] != m_Volumes[i]) { good = false; }
+    }
+  }
+  if (good == false)
+  {
+    QString ss = QObject::tr("The Checkpoint file %1 was written with different inputs and cannot be resumed").arg(m_CheckpointFile);
+    setErrorCondition(-1);
+    notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+    return 0;
+  }
+
+  // moving each Feature back to its stored centroid also translates its footprint
+  for (size_t i = m_FirstPrimaryFeature; i < totalFeatures; i++)
+  {
+    move_feature(i, centroids[3 * i], centroids[3 * i + 1], centroids[3 * i + 2]);
+  }
+
+  uint64_t randomPosition = 0;
+  bool randomHaveNormal = false;
+  double randomNormal = 0.0;
+  uint64_t availablePointsCount = 0;
+  std::vector<int64_t> featureOwnerTiles;
+  std::vector<int32_t> featureOwnerValues;
+  std::vector<int64_t> exclusionOwnerTiles;
+  std::vector<int32_t> exclusionOwnerValues;
+  good = checkpoint.getValue("AcceptedMoves", acceptedmoves) && checkpoint.getValue("RandomPosition", randomPosition) && checkpoint.getValue("RandomHaveNormal", randomHaveNormal)
+         && checkpoint.getValue("RandomNormal", randomNormal) && checkpoint.getArray("Neighborhoods", m_Neighborhoods, totalFeatures) && checkpoint.getArray("PackQualities", m_PackQualities)
+         && checkpoint.getArray("FeatureOwnerTiles", featureOwnerTiles) && checkpoint.getArray("FeatureOwnerValues", featureOwnerValues)
+         && checkpoint.getArray("ExclusionOwnerTiles", exclusionOwnerTiles) && checkpoint.getArray("ExclusionOwnerValues", exclusionOwnerValues)
+         && featureOwners.setTiles(featureOwnerTiles, featureOwnerValues) && exclusionOwners.setTiles(exclusionOwnerTiles, exclusionOwnerValues)
+         && checkpoint.getValue("AvailablePointsCount", availablePointsCount) && checkpoint.getValue("FillingError", m_FillingError)
+         && checkpoint.getValue("OldNeighborhoodError", m_OldNeighborhoodError);
+  if (good == true)
+  {
+    availablePoints.rebuild(exclusionOwners, m_UseMask == true ? m_Mask : NULL);
+    good = (static_cast<uint64_t>(availablePoints.getCount()) == availablePointsCount);
+  }
+  if (good == false)
+  {
+    QString ss = QObject::tr("The Checkpoint file %1 is incomplete").arg(m_CheckpointFile);
+    setErrorCondition(-1);
+    notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+    return 0;
+  }
+  m_CurrentNeighborhoodError = m_OldNeighborhoodError;
+  m_PointsToRemove.clear();
+  m_PointsToAdd.clear();
+  rg.setState(randomPosition, randomHaveNormal, randomNormal);
+
+  QString ss = QObject::tr("Resuming the packing optimization at iteration %1").arg(iteration);
+  notifyStatusMessage(getMessagePrefix(), getHumanLabel(), ss);
+  return iteration;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PackPrimaryPhases::set_move_shift(PackingMove_t& move, float xc, float yc, float zc)
+{
+  float oxc = m_Centroids[3 * move.m_Feature];
+  float oyc = m_Centroids[3 * move.m_Feature + 1];
+  float ozc = m_Centroids[3 * move.m_Feature + 2];
+  move.m_Shift[0] = static_cast<int64_t>( (xc - (m_HalfPackingRes[0])) * m_OneOverPackingRes[0] ) - static_cast<int64_t>( (oxc - (m_HalfPackingRes[0])) * m_OneOverPackingRes[0] );
+  move.m_Shift[1] = static_cast<int64_t>( (yc - (m_HalfPackingRes[1])) * m_OneOverPackingRes[1] ) - static_cast<int64_t>( (oyc - (m_HalfPackingRes[1])) * m_OneOverPackingRes[1] );
+  move.m_Shift[2] = static_cast<int64_t>( (zc - (m_HalfPackingRes[2])) * m_OneOverPackingRes[2] ) - static_cast<int64_t>( (ozc - (m_HalfPackingRes[2])) * m_OneOverPackingRes[2] );
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -1941,72 +2279,44 @@ float PackPrimaryPhases::check_sizedisterror(Feature_t* feature)
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-float PackPrimaryPhases::check_fillingerror(int32_t gadd, int32_t gremove, Int32ArrayType::Pointer featureOwnersPtr, Int32ArrayType::Pointer exclusionOwnersPtr)
+float PackPrimaryPhases::check_fillingerror(int32_t gadd, int32_t gremove, PackingGrid& featureOwners, PackingGrid& exclusionOwners)
 {
   size_t featureOwnersIdx = 0;
-  int32_t* featureOwners = featureOwnersPtr->getPointer(0);
-  int32_t* exclusionOwners = exclusionOwnersPtr->getPointer(0);
 
   m_FillingError = m_FillingError * float(m_TotalPackingPoints);
-  int64_t col = 0, row = 0, plane = 0;
+  int64_t planeStride = m_PackingPoints[0] * m_PackingPoints[1];
+  const int64_t noShift[3] = { 0, 0, 0 };
+  PackingFootprint::Segment_t segments[3];
+  int32_t numSegments = 0;
   int32_t k1 = 0, k2 = 0, k3 = 0;
   if (gadd > 0)
   {
     k1 = 2;
     k2 = -1;
     k3 = 1;
-    size_t numVoxelsForCurrentGrain = m_ColumnList[gadd].size();
-    std::vector<int64_t>& cl = m_ColumnList[gadd];
-    std::vector<int64_t>& rl = m_RowList[gadd];
-    std::vector<int64_t>& pl = m_PlaneList[gadd];
-    std::vector<float>& efl = m_EllipFuncList[gadd];
+    const PackingFootprint& footprint = m_Footprints[gadd];
+    size_t numVoxelsForCurrentGrain = footprint.getNumberOfPoints();
+    size_t numRuns = footprint.getNumberOfRuns();
     float packquality = 0;
-    for (size_t i = 0; i < numVoxelsForCurrentGrain; i++)
+    for (size_t r = 0; r < numRuns; r++)
     {
-      col = cl[i];
-      row = rl[i];
-      plane = pl[i];
-      if (m_PeriodicBoundaries == true)
-      {
-        if (col < 0) { col = col + m_PackingPoints[0]; }
-        if (col > m_PackingPoints[0] - 1) { col = col - m_PackingPoints[0]; }
-        if (row < 0) { row = row + m_PackingPoints[1]; }
-        if (row > m_PackingPoints[1] - 1) { row = row - m_PackingPoints[1]; }
-        if (plane < 0) { plane = plane + m_PackingPoints[2]; }
-        if (plane > m_PackingPoints[2] - 1) { plane = plane - m_PackingPoints[2]; }
-        featureOwnersIdx = (m_PackingPoints[0] * m_PackingPoints[1] * plane) + (m_PackingPoints[0] * row) + col;
-        int32_t currentFeatureOwner = featureOwners[featureOwnersIdx];
-        if (efl[i] > 0.1f)
-        {
-          if (exclusionOwners[featureOwnersIdx] == 0)
-          {
-            m_PointsToRemove.push_back(featureOwnersIdx);
-          }
-          exclusionOwners[featureOwnersIdx]++;
-        }
-        m_FillingError = static_cast<float>(m_FillingError + ((k1 * currentFeatureOwner  + k2)));
-        //        fillingerror = fillingerror + (multiplier * (k1 * currentFeatureOwner  + k2));
-        featureOwners[featureOwnersIdx] = currentFeatureOwner + k3;
-        packquality = static_cast<float>(packquality + ((currentFeatureOwner) * (currentFeatureOwner)));
-      }
-      else
+      bool exclusion = footprint.getRun(r).m_Exclusion;
+      numSegments = footprint.getSegments(r, m_PackingPoints, m_PeriodicBoundaries, noShift, segments);
+      for (int32_t s = 0; s < numSegments; s++)
       {
-        if (col >= 0 && col < m_PackingPoints[0] && row >= 0 && row < m_PackingPoints[1] && plane >= 0 && plane < m_PackingPoints[2])
+        featureOwnersIdx = segments[s].m_Start;
+        for (int64_t i = 0; i < segments[s].m_Count; i++, featureOwnersIdx += planeStride)
         {
-          featureOwnersIdx = (m_PackingPoints[0] * m_PackingPoints[1] * plane) + (m_PackingPoints[0] * row) + col;
-          int32_t currentFeatureOwner = featureOwners[featureOwnersIdx];
-          if (exclusionOwners[featureOwnersIdx] > 0) {  }
-          if (efl[i] > 0.1f)
+          int32_t currentFeatureOwner = featureOwners.getValue(featureOwnersIdx);
+          if (exclusion == true)
           {
-            if (exclusionOwners[featureOwnersIdx] == 0)
+            if (exclusionOwners.add(featureOwnersIdx, 1) == 1)
             {
               m_PointsToRemove.push_back(featureOwnersIdx);
             }
-            exclusionOwners[featureOwnersIdx]++;
           }
           m_FillingError = static_cast<float>(m_FillingError + ((k1 * currentFeatureOwner  + k2)));
-          //        fillingerror = fillingerror + (multiplier * (k1 * currentFeatureOwner  + k2));
-          featureOwners[featureOwnersIdx] = currentFeatureOwner + k3;
+          featureOwners.add(featureOwnersIdx, k3);
           packquality = static_cast<float>(packquality + ((currentFeatureOwner) * (currentFeatureOwner)));
         }
       }
@@ -2018,55 +2328,27 @@ float PackPrimaryPhases::check_fillingerror(int32_t gadd, int32_t gremove, Int32
     k1 = -2;
     k2 = 3;
     k3 = -1;
-    size_t size = m_ColumnList[gremove].size();
-    std::vector<int64_t>& cl = m_ColumnList[gremove];
-    std::vector<int64_t>& rl = m_RowList[gremove];
-    std::vector<int64_t>& pl = m_PlaneList[gremove];
-    std::vector<float>& efl = m_EllipFuncList[gremove];
-    for (size_t i = 0; i < size; i++)
-    {
-      col = cl[i];
-      row = rl[i];
-      plane = pl[i];
-      if (m_PeriodicBoundaries == true)
-      {
-        if (col < 0) { col = col + m_PackingPoints[0]; }
-        if (col > m_PackingPoints[0] - 1) { col = col - m_PackingPoints[0]; }
-        if (row < 0) { row = row + m_PackingPoints[1]; }
-        if (row > m_PackingPoints[1] - 1) { row = row - m_PackingPoints[1]; }
-        if (plane < 0) { plane = plane + m_PackingPoints[2]; }
-        if (plane > m_PackingPoints[2] - 1) { plane = plane - m_PackingPoints[2]; }
-        featureOwnersIdx = (m_PackingPoints[0] * m_PackingPoints[1] * plane) + (m_PackingPoints[0] * row) + col;
-        int32_t currentFeatureOwner = featureOwners[featureOwnersIdx];
-        if (efl[i] > 0.1f)
-        {
-          exclusionOwners[featureOwnersIdx]--;
-          if (exclusionOwners[featureOwnersIdx] == 0)
-          {
-            m_PointsToAdd.push_back(featureOwnersIdx);
-          }
-        }
-        m_FillingError = static_cast<float>(m_FillingError + ((k1 * currentFeatureOwner  + k2)));
-        //        fillingerror = fillingerror + (multiplier * (k1 * currentFeatureOwner  + k2));
-        featureOwners[featureOwnersIdx] = currentFeatureOwner + k3;
-      }
-      else
+    const PackingFootprint& footprint = m_Footprints[gremove];
+    size_t numRuns = footprint.getNumberOfRuns();
+    for (size_t r = 0; r < numRuns; r++)
+    {
+      bool exclusion = footprint.getRun(r).m_Exclusion;
+      numSegments = footprint.getSegments(r, m_PackingPoints, m_PeriodicBoundaries, noShift, segments);
+      for (int32_t s = 0; s < numSegments; s++)
       {
-        if (col >= 0 && col < m_PackingPoints[0] && row >= 0 && row < m_PackingPoints[1] && plane >= 0 && plane < m_PackingPoints[2])
+        featureOwnersIdx = segments[s].m_Start;
+        for (int64_t i = 0; i < segments[s].m_Count; i++, featureOwnersIdx += planeStride)
         {
-          featureOwnersIdx = (m_PackingPoints[0] * m_PackingPoints[1] * plane) + (m_PackingPoints[0] * row) + col;
-          int32_t currentFeatureOwner = featureOwners[featureOwnersIdx];
-          if (efl[i] > 0.1f)
+          int32_t currentFeatureOwner = featureOwners.getValue(featureOwnersIdx);
+          if (exclusion == true)
           {
-            exclusionOwners[featureOwnersIdx]--;
-            if (exclusionOwners[featureOwnersIdx] == 0)
+            if (exclusionOwners.add(featureOwnersIdx, -1) == 0)
             {
               m_PointsToAdd.push_back(featureOwnersIdx);
             }
           }
           m_FillingError = static_cast<float>(m_FillingError + ((k1 * currentFeatureOwner  + k2)));
-          //          fillingerror = fillingerror + (multiplier * (k1 * currentFeatureOwner  + k2));
-          featureOwners[featureOwnersIdx] = currentFeatureOwner + k3;
+          featureOwners.add(featureOwnersIdx, k3);
         }
       }
     }
@@ -2078,32 +2360,17 @@ float PackPrimaryPhases::check_fillingerror(int32_t gadd, int32_t gremove, Int32
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void PackPrimaryPhases::update_availablepoints(std::map<size_t, size_t>& availablePoints, std::map<size_t, size_t>& availablePointsInv)
+void PackPrimaryPhases::update_availablepoints(PackingAvailablePoints& availablePoints)
 {
   size_t removeSize = m_PointsToRemove.size();
   size_t addSize = m_PointsToAdd.size();
-  size_t featureOwnersIdx = 0;
-  size_t key = 0, val = 0;
   for (size_t i = 0; i < removeSize; i++)
   {
-    featureOwnersIdx = m_PointsToRemove[i];
-    key = availablePoints[featureOwnersIdx];
-    //  availablePoints.erase(featureOwnersIdx);
-    val = availablePointsInv[m_AvailablePointsCount - 1];
-    //  availablePointsInv.erase(availablePointsCount-1);
-    if (key < m_AvailablePointsCount - 1)
-    {
-      availablePointsInv[key] = val;
-      availablePoints[val] = key;
-    }
-    m_AvailablePointsCount--;
+    availablePoints.pointRemoved(m_PointsToRemove[i]);
   }
   for (size_t i = 0; i < addSize; i++)
   {
-    featureOwnersIdx = m_PointsToAdd[i];
-    availablePoints[featureOwnersIdx] = m_AvailablePointsCount;
-    availablePointsInv[m_AvailablePointsCount] = featureOwnersIdx;
-    m_AvailablePointsCount++;
+    availablePoints.pointAdded(m_PointsToAdd[i]);
   }
   m_PointsToRemove.clear();
   m_PointsToAdd.clear();
@@ -2112,16 +2379,25 @@ void PackPrimaryPhases::update_availablepoints(std::map<size_t, size_t>& availab
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void PackPrimaryPhases::insert_feature(size_t gnum)
+void PackPrimaryPhases::notify_packinggrid_memory(const PackingGrid& featureOwners, const PackingGrid& exclusionOwners, const PackingAvailablePoints& availablePoints)
 {
-  SIMPL_RANDOMNG_NEW();
+  // the peaks of the two grids need not coincide, so their sum is an upper bound
+  size_t peak = featureOwners.getPeakMemoryUsage() + exclusionOwners.getPeakMemoryUsage() + availablePoints.getMemoryUsage();
+  size_t dense = 2 * static_cast<size_t>(m_TotalPackingPoints) * sizeof(int32_t);
+  QString ss = QObject::tr("Packing grid memory high-water mark: %1 MB (%2 MB as full Int32 arrays)").arg(peak / 1048576.0, 0, 'f', 2).arg(dense / 1048576.0, 0, 'f', 2);
+  notifyStatusMessage(getMessagePrefix(), getHumanLabel(), ss);
+}
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PackPrimaryPhases::insert_feature(size_t gnum)
+{
   float inside = -1.0f;
   int64_t column = 0, row = 0, plane = 0;
   int64_t centercolumn = 0, centerrow = 0, centerplane = 0;
   int64_t xmin = 0, xmax = 0, ymin = 0, ymax = 0, zmin = 0, zmax = 0;
   float xc = 0.0f, yc = 0.0f, zc = 0.0f;
-  float coordsRotated[3] = { 0.0f, 0.0f, 0.0f };
   float coords[3] = { 0.0f, 0.0f, 0.0f };
   float volcur = m_Volumes[gnum];
   float bovera = m_AxisLengths[3 * gnum + 1];
@@ -2183,36 +2459,37 @@ void PackPrimaryPhases::insert_feature(size_t gnum)
   if (zmin < -m_PackingPoints[2]) { zmin = -m_PackingPoints[2]; }
   if (zmax > 2 * m_PackingPoints[2] - 1) { zmax = (2 * m_PackingPoints[2] - 1); }
 
-  float OneOverRadcur1 = 1.0f / radcur1;
-  float OneOverRadcur2 = 1.0f / radcur2;
-  float OneOverRadcur3 = 1.0f / radcur3;
+  float oneOverRadcur[3] = { 1.0f / radcur1, 1.0f / radcur2, 1.0f / radcur3 };
+  m_Footprints[gnum].clear(centercolumn, centerrow, centerplane);
+  if (zmax < zmin) { return; }
+
+  // The shape function is evaluated a whole run of planes at a time
+  ShapeRunKernel kernel(ga, oneOverRadcur);
+  size_t runLength = static_cast<size_t>(zmax - zmin + 1);
+  std::vector<float> planeCoords(runLength, 0.0f);
+  std::vector<float> runInside(runLength, 0.0f);
+  for (size_t i = 0; i < runLength; i++)
+  {
+    planeCoords[i] = float(zmin + int64_t(i)) * m_PackingRes[2] - zc;
+  }
+
   for (int64_t iter1 = xmin; iter1 < xmax + 1; iter1++)
   {
     for (int64_t iter2 = ymin; iter2 < ymax + 1; iter2++)
     {
+      column = iter1;
+      row = iter2;
+      coords[0] = float(column) * m_PackingRes[0] - xc;
+      coords[1] = float(row) * m_PackingRes[1] - yc;
+      kernel.setRun(2, coords);
+      kernel.evaluate(m_ShapeOps[shapeclass].get(), &(planeCoords.front()), runLength, &(runInside.front()));
       for (int64_t iter3 = zmin; iter3 < zmax + 1; iter3++)
       {
-        column = iter1;
-        row = iter2;
         plane = iter3;
-        coords[0] = float(column) * m_PackingRes[0];
-        coords[1] = float(row) * m_PackingRes[1];
-        coords[2] = float(plane) * m_PackingRes[2];
-        inside = -1.0f;
-        coords[0] = coords[0] - xc;
-        coords[1] = coords[1] - yc;
-        coords[2] = coords[2] - zc;
-        MatrixMath::Multiply3x3with3x1(ga, coords, coordsRotated);
-        float axis1comp = coordsRotated[0] * OneOverRadcur1;
-        float axis2comp = coordsRotated[1] * OneOverRadcur2;
-        float axis3comp = coordsRotated[2] * OneOverRadcur3;
-        inside = m_ShapeOps[shapeclass]->inside(axis1comp, axis2comp, axis3comp);
+        inside = runInside[iter3 - zmin];
         if (inside >= 0)
         {
-          m_ColumnList[gnum].push_back(column);
-          m_RowList[gnum].push_back(row);
-          m_PlaneList[gnum].push_back(plane);
-          m_EllipFuncList[gnum].push_back(inside);
+          m_Footprints[gnum].addPoint(column, row, plane, inside > 0.1f);
         }
       }
     }
@@ -2247,7 +2524,6 @@ void PackPrimaryPhases::assign_voxels()
 
   int64_t column = 0, row = 0, plane = 0;
   float xc = 0.0f, yc = 0.0f, zc = 0.0f;
-  float size[3] = { m_SizeX, m_SizeY, m_SizeZ };
 
   int64_t xmin = 0, xmax = 0, ymin = 0, ymax = 0, zmin = 0, zmax = 0;
 
@@ -2264,24 +2540,17 @@ void PackPrimaryPhases::assign_voxels()
   ellipfuncsPtr->initializeWithValue(-1);
   float* ellipfuncs = ellipfuncsPtr->getPointer(0);
 
-  float featuresPerTime = 0;
-  uint64_t millis = QDateTime::currentMSecsSinceEpoch();
-  uint64_t currentMillis = millis;
-
   int64_t totalFeatures = m->getAttributeMatrix(m_OutputCellFeatureAttributeMatrixName)->getNumTuples();
+
+  // Set up the shape of every Feature once; the voxels are then assigned slab by slab
+  std::vector<float> centers(3 * totalFeatures, 0.0f);
+  std::vector<float> invRadCur(3 * totalFeatures, 0.0f);
+  std::vector<float> gaList(9 * totalFeatures, 0.0f);
+  std::vector<int64_t> bounds(6 * totalFeatures, 0);
+  std::vector<uint32_t> shapeClasses(totalFeatures, 0);
+  std::vector<float> shapeArgs(4 * totalFeatures, 0.0f);
   for (int64_t i = m_FirstPrimaryFeature; i < totalFeatures; i++)
   {
-    featuresPerTime++;
-    currentMillis = QDateTime::currentMSecsSinceEpoch();
-    if (currentMillis - millis > 1000)
-    {
-      float rate = featuresPerTime / ( (float)(currentMillis - millis) ) * 1000.0f;
-
-      QString ss = QObject::tr("Assign Voxels & Gaps|| Features Checked: %1 || Features/Second: %2").arg(i).arg((int)rate);
-      notifyStatusMessage(getMessagePrefix(), getHumanLabel(), ss);
-      featuresPerTime = 0;
-      millis = QDateTime::currentMSecsSinceEpoch();
-    }
     float volcur = m_Volumes[i];
     float bovera = m_AxisLengths[3 * i + 1];
     float covera = m_AxisLengths[3 * i + 2];
@@ -2301,7 +2570,6 @@ void PackPrimaryPhases::assign_voxels()
       return;
     }
 
-    // init any values for each of the Shape Ops
     // init any values for each of the Shape Ops
     for (size_t iter = 0; iter < m_ShapeOps.size(); iter++)
     {
@@ -2354,23 +2622,56 @@ void PackPrimaryPhases::assign_voxels()
       if (zmax > dims[2] - 1) { zmax = dims[2] - 1; }
     }
 
-    float radCur[3] = { radcur1, radcur2, radcur3 };
-    float xx[3] = {xc, yc, zc };
-    ShapeOps* shapeOps = m_ShapeOps[shapeclass].get();
-    //#if 0
-#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
-    if (doParallel == true)
+    centers[3 * i] = xc;
+    centers[3 * i + 1] = yc;
+    centers[3 * i + 2] = zc;
+    invRadCur[3 * i] = 1.0f / radcur1;
+    invRadCur[3 * i + 1] = 1.0f / radcur2;
+    invRadCur[3 * i + 2] = 1.0f / radcur3;
+    for (size_t j = 0; j < 3; j++)
     {
-      tbb::parallel_for(tbb::blocked_range3d<int64_t, int64_t, int64_t>(zmin, zmax + 1, ymin, ymax + 1, xmin, xmax + 1),
-                        AssignVoxelsGapsImpl(dims, res, m_FeatureIds, radCur, xx, shapeOps, ga, size, i, newownersPtr, ellipfuncsPtr), tbb::auto_partitioner());
-
+      gaList[9 * i + 3 * j] = ga[j][0];
+      gaList[9 * i + 3 * j + 1] = ga[j][1];
+      gaList[9 * i + 3 * j + 2] = ga[j][2];
     }
-    else
+    bounds[6 * i] = xmin;
+    bounds[6 * i + 1] = xmax;
+    bounds[6 * i + 2] = ymin;
+    bounds[6 * i + 3] = ymax;
+    bounds[6 * i + 4] = zmin;
+    bounds[6 * i + 5] = zmax;
+    shapeClasses[i] = shapeclass;
+    shapeArgs[4 * i] = omega3;
+    shapeArgs[4 * i + 1] = volcur;
+    shapeArgs[4 * i + 2] = bovera;
+    shapeArgs[4 * i + 3] = covera;
+  }
+
+  // Split the volume into slabs of planes and bucket the Features by the slabs they overlap, once,
+  // so every slab only visits its own Features
+  int64_t numSlabs = std::min<int64_t>(dims[2], 64);
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+  if (doParallel == true) { numSlabs = std::min<int64_t>(dims[2], std::max<int64_t>(64, 8 * tbb::task_scheduler_init::default_num_threads())); }
+#else
+  bool doParallel = false;
 #endif
-    {
-      AssignVoxelsGapsImpl serial(dims, res, m_FeatureIds, radCur, xx, shapeOps, ga, size, i, newownersPtr, ellipfuncsPtr);
-      serial.convert(zmin, zmax + 1, ymin, ymax + 1, xmin, xmax + 1);
-    }
+  PackingSlabs slabs;
+  slabs.initialize(dims, numSlabs, &(bounds.front()), m_FirstPrimaryFeature, totalFeatures);
+  numSlabs = slabs.getNumSlabs();
+  AssignVoxelsShapes shapes(&(shapeClasses.front()), &(shapeArgs.front()));
+  PackingSlabAssigner<AssignVoxelsShapes> assigner(dims, res, &slabs, &(centers.front()), &(invRadCur.front()), &(gaList.front()), &(bounds.front()),
+                                                   &shapes, newowners, ellipfuncs);
+
+  // The slabs are filled in a few rounds so the progress can be reported in between
+  const int64_t numRounds = 8;
+  int64_t slabsPerRound = std::max<int64_t>(1, (numSlabs + numRounds - 1) / numRounds);
+  for (int64_t slabStart = 0; slabStart < numSlabs && totalFeatures > m_FirstPrimaryFeature; slabStart += slabsPerRound)
+  {
+    if (getCancel() == true) { return; }
+    int64_t slabEnd = std::min(numSlabs, slabStart + slabsPerRound);
+    QString ss = QObject::tr("Assign Voxels & Gaps || Assigning Voxels to %1 Features || Planes Assigned: %2 of %3").arg(totalFeatures - m_FirstPrimaryFeature).arg(slabs.getSlabPlanes()[slabStart]).arg(dims[2]);
+    notifyStatusMessage(getMessagePrefix(), getHumanLabel(), ss);
+    assigner.assign(slabStart, slabEnd, doParallel);
   }
 
   QVector<bool> activeObjects(totalFeatures, false);
@@ -2753,9 +3054,9 @@ int32_t PackPrimaryPhases::estimate_numfeatures(size_t xpoints, size_t ypoints,
   // Create a Reference Variable so we can use the [] syntax
   StatsDataArray& statsDataArray = *(m_StatsDataArray.lock().get());
 
-  SIMPL_RANDOMNG_NEW()
+  SyntheticBuildingRandom rg(m_Seed, SyntheticBuildingRandom::PackPrimaryPhasesEstimate);
 
-      std::vector<int32_t> primaryPhasesLocal;
+  std::vector<int32_t> primaryPhasesLocal;
   std::vector<double> primaryPhaseFractionsLocal;
   double totalprimaryfractions = 0.0;
   // find which phases are primary phases
@@ -2931,6 +3232,22 @@ AbstractFilter::Pointer PackPrimaryPhases::newFilterInstance(bool copyFilterPara
   return filter;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+float PackPrimaryPhases::getFillingError()
+{
+  return m_FillingError;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+float PackPrimaryPhases::getNeighborhoodError()
+{
+  return m_OldNeighborhoodError;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -45,6 +45,12 @@
 #include "SIMPLib/Geometry/ShapeOps/ShapeOps.h"
 #include "OrientationLib/SpaceGroupOps/OrthoRhombicOps.h"
 
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PackingAvailablePoints.hpp"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PackingCheckpoint.hpp"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PackingFootprint.hpp"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PackingGrid.hpp"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PackingMoveEvaluator.hpp"
+
 typedef struct
 {
   float m_Volumes;
@@ -56,6 +62,9 @@ typedef struct
   int32_t m_Neighborhoods;
 } Feature_t;
 
+class GenerateFeaturesImpl;
+class SyntheticBuildingRandom;
+
 /**
  * @brief The PackPrimaryPhases class. See [Filter documentation](@ref packprimaryphases) for details.
  */
@@ -123,6 +132,39 @@ class PackPrimaryPhases : public AbstractFilter
     SIMPL_FILTER_PARAMETER(bool, WriteGoalAttributes)
     Q_PROPERTY(bool WriteGoalAttributes READ getWriteGoalAttributes WRITE setWriteGoalAttributes)
 
+    SIMPL_FILTER_PARAMETER(bool, UseFixedSeed)
+    Q_PROPERTY(bool UseFixedSeed READ getUseFixedSeed WRITE setUseFixedSeed)
+
+    SIMPL_FILTER_PARAMETER(int, RandomSeed)
+    Q_PROPERTY(int RandomSeed READ getRandomSeed WRITE setRandomSeed)
+
+    SIMPL_FILTER_PARAMETER(bool, BatchMoveEvaluation)
+    Q_PROPERTY(bool BatchMoveEvaluation READ getBatchMoveEvaluation WRITE setBatchMoveEvaluation)
+
+    SIMPL_FILTER_PARAMETER(bool, WriteCheckpoints)
+    Q_PROPERTY(bool WriteCheckpoints READ getWriteCheckpoints WRITE setWriteCheckpoints)
+
+    SIMPL_FILTER_PARAMETER(int, CheckpointInterval)
+    Q_PROPERTY(int CheckpointInterval READ getCheckpointInterval WRITE setCheckpointInterval)
+
+    SIMPL_FILTER_PARAMETER(bool, ResumeFromCheckpoint)
+    Q_PROPERTY(bool ResumeFromCheckpoint READ getResumeFromCheckpoint WRITE setResumeFromCheckpoint)
+
+    SIMPL_FILTER_PARAMETER(QString, CheckpointFile)
+    Q_PROPERTY(QString CheckpointFile READ getCheckpointFile WRITE setCheckpointFile)
+
+    /**
+     * @brief getFillingError Returns the filling error of the packing at the end of the last execute()
+     */
+    float getFillingError();
+    Q_PROPERTY(float FillingError READ getFillingError)
+
+    /**
+     * @brief getNeighborhoodError Returns the neighborhood error of the packing at the end of the last execute()
+     */
+    float getNeighborhoodError();
+    Q_PROPERTY(float NeighborhoodError READ getNeighborhoodError)
+
     /**
      * @brief getCompiledLibraryName Reimplemented from @see AbstractFilter class
      */
@@ -232,24 +274,37 @@ class PackPrimaryPhases : public AbstractFilter
     /**
      * @brief initialize_packinggrid Initializes internal variables for packing grid dimensions based on
      * the incoming grid set by the user
-     * @return
+     * @param featureOwners Grid of the number of Features covering each packing point, resized to the packing grid
      */
-    Int32ArrayType::Pointer initialize_packinggrid();
+    void initialize_packinggrid(PackingGrid& featureOwners);
 
     /**
      * @brief place_features Organizes the placement of Features into the packing volume while ensuring
      * proper size and morphological statistics are maintained
-     * @param featureOwnersPtr Array of Feature Ids for each packing point
+     * @param featureOwners Grid of the number of Features covering each packing point
      */
-    void place_features(Int32ArrayType::Pointer featureOwnersPtr);
+    void place_features(PackingGrid& featureOwners);
 
     /**
      * @brief generate_feature Creates a Feature by sampling the size and morphological statistical distributions
      * @param phase Index of the Ensemble type for the Feature to be generated
      * @param feature Feature_t struct pointer to be intialized
      * @param shapeclass Type of Feature shape to be generated
+     * @param featureId Id of the Feature being generated; selects the random stream
+     * @param attempt Placement attempt for this Feature; selects the random stream
      */
-    void generate_feature(int32_t phase, Feature_t* feature, uint32_t shapeclass);
+    void generate_feature(int32_t phase, Feature_t* feature, uint32_t shapeclass, int32_t featureId, size_t attempt);
+
+    /**
+     * @brief next_feature Creates a Feature like generate_feature, but generates the first attempts of the
+     * upcoming Features ahead of time in parallel batches, since they do not depend on which earlier Features were accepted
+     * @param phase Index of the Ensemble type for the Feature to be generated
+     * @param feature Feature_t struct pointer to be intialized
+     * @param shapeclass Type of Feature shape to be generated
+     * @param featureId Id of the Feature being generated
+     * @param attempt Placement attempt for this Feature
+     */
+    void next_feature(int32_t phase, Feature_t* feature, uint32_t shapeclass, int32_t featureId, size_t attempt);
 
     /**
      * @brief load_features Reads a list of Features from a file to be used as the packed volume
@@ -278,6 +333,63 @@ class PackPrimaryPhases : public AbstractFilter
      */
     void move_feature(size_t gnum, float xc, float yc, float zc);
 
+    /**
+     * @brief batch_move_features Runs the jump/nudge packing optimization on batches of proposed moves. The filling
+     * error change of every move in a batch is evaluated in parallel against the current packing grid, then the moves
+     * are committed in proposal order; a move whose footprint overlaps a move already committed in the same batch is
+     * re-evaluated before it is accepted, so the result is independent of the number of threads
+     * @param rg Random number stream used to propose the moves
+     * @param startIteration First move to propose; non zero when resuming from a checkpoint
+     * @param totalAdjustments Number of moves to propose
+     * @param totalFeatures Number of Features, including the unused 0 Feature
+     * @param featureOwners Grid of the number of Features covering each packing point
+     * @param exclusionOwners Grid of the number of Features excluding each packing point
+     * @param availablePoints Packing points available for jumps
+     * @param checkpointWriter Writer for the checkpoints taken between batches
+     * @param acceptedmoves Number of accepted moves, updated
+     */
+    void batch_move_features(SyntheticBuildingRandom& rg, int32_t startIteration, int32_t totalAdjustments, size_t totalFeatures, PackingGrid& featureOwners, PackingGrid& exclusionOwners,
+                             PackingAvailablePoints& availablePoints, PackingCheckpointWriter& checkpointWriter, int32_t& acceptedmoves);
+
+    /**
+     * @brief write_checkpoint Takes a snapshot of the state of the packing optimization at the start of an iteration
+     * and writes it to the checkpoint file in the background
+     * @param checkpointWriter Writer that owns the background write
+     * @param iteration Iteration the optimization will continue with
+     * @param acceptedmoves Number of accepted moves so far
+     * @param rg Random number stream of the optimization
+     * @param featureOwners Grid of the number of Features covering each packing point
+     * @param exclusionOwners Grid of the number of Features excluding each packing point
+     * @param availablePoints Packing points available for jumps
+     */
+    void write_checkpoint(PackingCheckpointWriter& checkpointWriter, int32_t iteration, int32_t acceptedmoves, const SyntheticBuildingRandom& rg, const PackingGrid& featureOwners,
+                          const PackingGrid& exclusionOwners, const PackingAvailablePoints& availablePoints);
+
+    /**
+     * @brief restore_checkpoint Replaces the state of the packing optimization with the one stored in a checkpoint.
+     * The Features themselves are regenerated from the stored seed, so the checkpoint is rejected if they differ
+     * from the ones it was taken with
+     * @param checkpoint Checkpoint read from the checkpoint file
+     * @param rg Random number stream of the optimization
+     * @param totalFeatures Number of Features, including the unused 0 Feature
+     * @param featureOwners Grid of the number of Features covering each packing point
+     * @param exclusionOwners Grid of the number of Features excluding each packing point
+     * @param availablePoints Packing points available for jumps
+     * @param acceptedmoves Number of accepted moves, restored
+     * @return Iteration the optimization continues with
+     */
+    int32_t restore_checkpoint(const PackingCheckpoint& checkpoint, SyntheticBuildingRandom& rg, size_t totalFeatures, PackingGrid& featureOwners, PackingGrid& exclusionOwners,
+                               PackingAvailablePoints& availablePoints, int32_t& acceptedmoves);
+
+    /**
+     * @brief set_move_shift Sets the packing grid shift of a move that puts its Feature at the supplied (x,y,z) centroid coordinate
+     * @param move Move to update
+     * @param xc x centroid coordinate
+     * @param yc y centroid coordinate
+     * @param zc z centroid coordinate
+     */
+    void set_move_shift(PackingMove_t& move, float xc, float yc, float zc);
+
     /**
      * @brief check_sizedisterror Computes the error between the current Feature size distribution
      * and the goal Feature size distribution
@@ -307,18 +419,23 @@ class PackPrimaryPhases : public AbstractFilter
      * @brief check_fillingerror Computes the percentage of unassigned or multiple assigned packing points
      * @param gadd Value that determines whether to add point Ids to be filled
      * @param gremove Value that determines whether to add point Ids to be removed
-     * @param featureOwnersPtr Array of Feature Ids for each packing point
-     * @param exclusionOwnersPtr Array of exlusion Ids for each packing point
+     * @param featureOwners Grid of the number of Features covering each packing point
+     * @param exclusionOwners Grid of the number of Features excluding each packing point
      * @return Float percentage value for the ratio of unassinged/"garbage" packing points
      */
-    float check_fillingerror(int32_t gadd, int32_t gremove, Int32ArrayType::Pointer featureOwnersPtr, Int32ArrayType::Pointer exclusionOwnersPtr);
+    float check_fillingerror(int32_t gadd, int32_t gremove, PackingGrid& featureOwners, PackingGrid& exclusionOwners);
+
+    /**
+     * @brief update_availablepoints Commits the packing points that entered or left the exclusion zones during the
+     * last accepted move to the set of points available for jumps
+     * @param availablePoints Packing points available for jumps
+     */
+    void update_availablepoints(PackingAvailablePoints& availablePoints);
 
     /**
-     * @brief update_availablepoints Updates the maps used to associate packing points with an "available" state
-     * @param availablePoints Map between Feature owners and number of available points
-     * @param availablePointsInv Inverse associations for the availablePoints map
+     * @brief notify_packinggrid_memory Reports the memory high-water mark of the packing grid structures
      */
-    void update_availablepoints(std::map<size_t, size_t>& availablePoints, std::map<size_t, size_t>& availablePointsInv);
+    void notify_packinggrid_memory(const PackingGrid& featureOwners, const PackingGrid& exclusionOwners, const PackingAvailablePoints& availablePoints);
 
     /**
      * @brief assign_voxels Assigns Feature Id values to voxels within the packing grid
@@ -360,11 +477,11 @@ class PackPrimaryPhases : public AbstractFilter
 
     /**
      * @brief writeVtkFile Outputs a debug VTK file for visualization
-     * @param featureOwners Array of Feature Ids for each packing point
-     * @param exclusionZonesPtr Array of exlusion Ids for each packing point
+     * @param featureOwners Grid of the number of Features covering each packing point
+     * @param exclusionZones Grid of the number of Features excluding each packing point
      * @return Integer error code
      */
-    int32_t writeVtkFile(int32_t* featureOwners, int32_t* exclusionZonesPtr);
+    int32_t writeVtkFile(const PackingGrid& featureOwners, const PackingGrid& exclusionZones);
 
     /**
      * @brief estimate_numfeatures Estimates the number of Features that will be generated based on the supplied statistics
@@ -423,16 +540,17 @@ class PackPrimaryPhases : public AbstractFilter
     ShapeOps::Pointer m_SuperEllipsoidOps;
     OrthoRhombicOps::Pointer m_OrthoOps;
 
-    std::vector<std::vector<int64_t> > m_ColumnList;
-    std::vector<std::vector<int64_t> > m_RowList;
-    std::vector<std::vector<int64_t> > m_PlaneList;
-    std::vector<std::vector<float> > m_EllipFuncList;
+    std::vector<PackingFootprint> m_Footprints;
 
     std::vector<size_t> m_PointsToAdd;
     std::vector<size_t> m_PointsToRemove;
 
     uint64_t m_Seed;
 
+    std::vector<Feature_t> m_FeatureBatch;
+    int32_t m_FeatureBatchStart;
+    int32_t m_FeatureBatchPhase;
+
     int32_t m_FirstPrimaryFeature;
 
     float m_SizeX;
@@ -461,7 +579,6 @@ class PackPrimaryPhases : public AbstractFilter
     std::vector<int32_t> m_PrimaryPhases;
     std::vector<float> m_PrimaryPhaseFractions;
 
-    size_t m_AvailablePointsCount;
     float m_FillingError, m_OldFillingError;
     float m_CurrentNeighborhoodError, m_OldNeighborhoodError;
     float m_CurrentSizeDistError, m_OldSizeDistError;
@@ -475,6 +592,8 @@ class PackPrimaryPhases : public AbstractFilter
      */
     void updateFeatureInstancePointers();
 
+    friend class GenerateFeaturesImpl;
+
     PackPrimaryPhases(const PackPrimaryPhases&); // Copy Constructor Not Implemented
     void operator=(const PackPrimaryPhases&); // Operator '=' Not Implemented
 };
@@ -56,5 +56,19 @@ endforeach()
 
 
 
+#-------------
+# These are files that need to be compiled into DREAM3DLib but are NOT filters
+ADD_SIMPL_SUPPORT_HEADER_SUBDIR(${SyntheticBuilding_SOURCE_DIR} ${_filterGroupName} SyntheticBuildingRandom.hpp util)
+ADD_SIMPL_SUPPORT_HEADER_SUBDIR(${SyntheticBuilding_SOURCE_DIR} ${_filterGroupName} PackingFootprint.hpp util)
+ADD_SIMPL_SUPPORT_HEADER_SUBDIR(${SyntheticBuilding_SOURCE_DIR} ${_filterGroupName} PackingMoveEvaluator.hpp util)
+ADD_SIMPL_SUPPORT_HEADER_SUBDIR(${SyntheticBuilding_SOURCE_DIR} ${_filterGroupName} PackingCheckpoint.hpp util)
+ADD_SIMPL_SUPPORT_HEADER_SUBDIR(${SyntheticBuilding_SOURCE_DIR} ${_filterGroupName} ShapeRunKernel.hpp util)
+ADD_SIMPL_SUPPORT_HEADER_SUBDIR(${SyntheticBuilding_SOURCE_DIR} ${_filterGroupName} PackingGrid.hpp util)
+ADD_SIMPL_SUPPORT_HEADER_SUBDIR(${SyntheticBuilding_SOURCE_DIR} ${_filterGroupName} PackingAvailablePoints.hpp util)
+ADD_SIMPL_SUPPORT_HEADER_SUBDIR(${SyntheticBuilding_SOURCE_DIR} ${_filterGroupName} PeriodicBox.hpp util)
+ADD_SIMPL_SUPPORT_HEADER_SUBDIR(${SyntheticBuilding_SOURCE_DIR} ${_filterGroupName} OrientationChainRunner.hpp util)
+ADD_SIMPL_SUPPORT_HEADER_SUBDIR(${SyntheticBuilding_SOURCE_DIR} ${_filterGroupName} PrecipitateRdfGrid.hpp util)
+ADD_SIMPL_SUPPORT_HEADER_SUBDIR(${SyntheticBuilding_SOURCE_DIR} ${_filterGroupName} PackingSlabs.hpp util)
+
 SIMPL_END_FILTER_GROUP(${SyntheticBuilding_BINARY_DIR} "${_filterGroupName}" "SyntheticBuilding Filters")
 
@@ -0,0 +1,517 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#ifndef _orientationchainrunner_hpp_
+#define _orientationchainrunner_hpp_
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/Math/QuaternionMath.hpp"
+
+#include "OrientationLib/OrientationMath/OrientationArray.hpp"
+#include "OrientationLib/OrientationMath/OrientationTransforms.hpp"
+#include "OrientationLib/SpaceGroupOps/SpaceGroupOps.h"
+
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/SyntheticBuildingRandom.hpp"
+
+/**
+ * @brief The OrientationChain_t struct holds the state of one Markov chain of orientation swaps and switches
+ */
+typedef struct
+{
+  std::vector<float> m_FeatureEulerAngles;
+  std::vector<QuatF> m_Quats;
+  std::vector<float> m_SimOdf;
+  std::vector<float> m_SimMdf;
+  std::vector<int32_t> m_MisorientationBins;
+  double m_OdfError;
+  double m_MdfError;
+  int32_t m_Iterations;
+  int32_t m_BadTryCount;
+} OrientationChain_t;
+
+/**
+ * @class OrientationChainRunner OrientationChainRunner.hpp SyntheticBuilding/SyntheticBuildingFilters/util/OrientationChainRunner.hpp
+ * @brief Performs the orientation swaps and switches of MatchCrystallography on one phase.
+ *
+ * The boundaries of the phase are stored in one flat array: the boundaries of Feature i are the entries
+ * [neighborOffsets[i], neighborOffsets[i + 1]) of the neighbor and area fraction arrays, and a chain caches the
+ * MDF bin of each of them (-1 for boundaries that do not count towards the MDF). A trial only looks at the
+ * boundaries of the Features it changes and updates the ODF and MDF errors of the chain incrementally. The
+ * runner only reads the phase data, so any number of chains can run on it concurrently.
+ */
+class OrientationChainRunner
+{
+  public:
+    /**
+     * @brief OrientationChainRunner
+     * @param orientationOps Symmetry operations of the phase
+     * @param actualOdf Goal ODF of the phase
+     * @param actualMdf Goal MDF of the phase
+     * @param neighborOffsets Offset of the first boundary of each Feature, with one extra entry at the end
+     * @param neighbors Neighbor Feature Id of each boundary
+     * @param areaFractions Fraction of the total boundary area of the phase of each boundary
+     * @param volumeFractions Fraction of the unbiased volume of the phase of each Feature
+     * @param selectable Whether each Feature may be picked for a swap or switch
+     * @param maxIterations Maximum number of trials of a chain; a chain also stops after maxIterations / 10 rejected trials in a row
+     */
+    OrientationChainRunner(SpaceGroupOps::Pointer orientationOps, const float* actualOdf, const float* actualMdf, const std::vector<size_t>& neighborOffsets,
+                           const std::vector<int32_t>& neighbors, const std::vector<float>& areaFractions, const std::vector<float>& volumeFractions,
+                           const std::vector<bool>& selectable, int32_t maxIterations) :
+      m_OrientationOps(orientationOps),
+      m_ActualOdf(actualOdf),
+      m_ActualMdf(actualMdf),
+      m_NeighborOffsets(neighborOffsets),
+      m_Neighbors(neighbors),
+      m_AreaFractions(areaFractions),
+      m_VolumeFractions(volumeFractions),
+      m_Selectable(selectable),
+      m_MaxIterations(maxIterations)
+    {
+      m_OdfSize = m_OrientationOps->getODFSize();
+      m_MdfSize = m_OrientationOps->getMDFSize();
+    }
+
+    virtual ~OrientationChainRunner() {}
+
+    /**
+     * @brief PickOdfBin Picks the bin of a distribution whose cumulative density interval contains a random value
+     * @param odf Distribution to sample
+     * @param numbins Number of bins of the distribution
+     * @param random Random value in [0, 1)
+     * @return Bin index
+     */
+    static int32_t PickOdfBin(const float* odf, int32_t numbins, float random)
+    {
+      int32_t choose = 0;
+      float totaldensity = 0.0f;
+      for (int32_t j = 0; j < numbins; j++)
+      {
+        float density = odf[j];
+        float td1 = totaldensity;
+        totaldensity = totaldensity + density;
+        if (random < totaldensity && random >= td1) { choose = j; break; }
+      }
+      return choose;
+    }
+
+    /**
+     * @brief MisorientationBin Returns the MDF bin of the misorientation between two orientations
+     * @param orientationOps Symmetry operations of the phase
+     * @param q1 Quaternion of the first orientation
+     * @param q2 Quaternion of the second orientation
+     * @return Bin index
+     */
+    static int32_t MisorientationBin(SpaceGroupOps::Pointer orientationOps, QuatF q1, QuatF q2)
+    {
+      float n1 = 0.0f, n2 = 0.0f, n3 = 0.0f;
+      float w = orientationOps->getMisoQuat(q1, q2, n1, n2, n3);
+      FOrientArrayType rod(4);
+      FOrientTransformsType::ax2ro(FOrientArrayType(n1, n2, n3, w), rod);
+      return orientationOps->getMisoBin(rod);
+    }
+
+    /**
+     * @brief BinErrorChange Returns the change of the squared error between a goal and a simulated
+     * distribution when a set of bin changes is applied to the simulated one. Changes to the same bin
+     * are merged first, so the result is exact
+     * @param actual Goal distribution
+     * @param sim Simulated distribution
+     * @param deltas (bin, change) pairs; sorted on return
+     * @return Change of the squared error
+     */
+    static double BinErrorChange(const float* actual, const std::vector<float>& sim, std::vector<std::pair<int32_t, float> >& deltas)
+    {
+      std::sort(deltas.begin(), deltas.end());
+      double change = 0.0;
+      size_t i = 0;
+      while (i < deltas.size())
+      {
+        int32_t bin = deltas[i].first;
+        double delta = 0.0;
+        for (; i < deltas.size() && deltas[i].first == bin; i++)
+        {
+          delta += deltas[i].second;
+        }
+        double oldDiff = static_cast<double>(actual[bin]) - sim[bin];
+        double newDiff = oldDiff - delta;
+        change += (newDiff * newDiff) - (oldDiff * oldDiff);
+      }
+      return change;
+    }
+
+    /**
+     * @brief computeErrors Recomputes the ODF and MDF errors of a chain from its distributions
+     * @param chain Chain to update
+     */
+    void computeErrors(OrientationChain_t& chain) const
+    {
+      chain.m_OdfError = 0.0;
+      for (size_t i = 0; i < chain.m_SimOdf.size(); i++)
+      {
+        double delta = static_cast<double>(m_ActualOdf[i]) - chain.m_SimOdf[i];
+        chain.m_OdfError += delta * delta;
+      }
+      chain.m_MdfError = 0.0;
+      for (size_t i = 0; i < chain.m_SimMdf.size(); i++)
+      {
+        double delta = static_cast<double>(m_ActualMdf[i]) - chain.m_SimMdf[i];
+        chain.m_MdfError += delta * delta;
+      }
+    }
+
+    /**
+     * @brief selectFeature Picks a random selectable Feature
+     * @param rg Random number stream of the chain
+     * @param exclude Feature Id that may not be picked, or -1
+     * @return Feature Id, or -1 if there is no Feature to pick
+     */
+    int32_t selectFeature(SyntheticBuildingRandom& rg, int32_t exclude) const
+    {
+      int32_t totalFeatures = static_cast<int32_t>(m_Selectable.size());
+      int32_t counter = 0;
+      int32_t selectedfeature = int32_t(rg.genrand_res53() * totalFeatures);
+      if (selectedfeature >= totalFeatures) { selectedfeature = selectedfeature - totalFeatures; }
+      while ((m_Selectable[selectedfeature] == false || selectedfeature == exclude) && counter < totalFeatures)
+      {
+        selectedfeature++;
+        if (selectedfeature >= totalFeatures) { selectedfeature = selectedfeature - totalFeatures; }
+        counter++;
+      }
+      if (counter == totalFeatures) { return -1; }
+      return selectedfeature;
+    }
+
+    /**
+     * @brief swapOutOrientation Tries to replace the orientation of a Feature with one sampled from the goal ODF
+     * @param chain Chain to update
+     * @param rg Random number stream of the chain
+     * @param feature Feature Id of the Feature to swap
+     * @return Whether the swap was accepted
+     */
+    bool swapOutOrientation(OrientationChain_t& chain, SyntheticBuildingRandom& rg, int32_t feature) const
+    {
+      FOrientArrayType rod(4, 0.0);
+      FOrientTransformsType::eu2ro(FOrientArrayType(&(chain.m_FeatureEulerAngles[3 * feature]), 3), rod);
+      int32_t g1odfbin = m_OrientationOps->getOdfBin(rod);
+
+      float random = static_cast<float>(rg.genrand_res53());
+      int32_t choose = PickOdfBin(m_ActualOdf, m_OdfSize, random);
+      FOrientArrayType g1ea = m_OrientationOps->determineEulerAngles(rg.genrand_int64(), choose);
+      size_t symOp = static_cast<size_t>(rg.genrand_res53() * m_OrientationOps->getNumSymOps());
+      g1ea = m_OrientationOps->applySymmetryOperator(g1ea, symOp);
+      FOrientArrayType quat(4, 0.0);
+      FOrientTransformsType::eu2qu(g1ea, quat);
+      QuatF q1 = quat.toQuaternion();
+      // bin the angles that are stored, they need not fall into the sampled bin once the symmetry operator is applied
+      FOrientTransformsType::eu2ro(g1ea, rod);
+      int32_t g2odfbin = m_OrientationOps->getOdfBin(rod);
+
+      float volumeFraction = m_VolumeFractions[feature];
+      std::vector<std::pair<int32_t, float> > odfDeltas;
+      odfDeltas.push_back(std::make_pair(g2odfbin, volumeFraction));
+      odfDeltas.push_back(std::make_pair(g1odfbin, -volumeFraction));
+
+      // only the boundaries of the swapped Feature change their misorientation
+      size_t size = m_NeighborOffsets[feature + 1] - m_NeighborOffsets[feature];
+      std::vector<int32_t> newBins(size, -1);
+      std::vector<std::pair<int32_t, float> > mdfDeltas;
+      for (size_t j = 0; j < size; j++)
+      {
+        size_t boundary = m_NeighborOffsets[feature] + j;
+        int32_t curmisobin = chain.m_MisorientationBins[boundary];
+        if (curmisobin < 0) { continue; }
+        newBins[j] = MisorientationBin(m_OrientationOps, q1, chain.m_Quats[m_Neighbors[boundary]]);
+        mdfDeltas.push_back(std::make_pair(curmisobin, -m_AreaFractions[boundary]));
+        mdfDeltas.push_back(std::make_pair(newBins[j], m_AreaFractions[boundary]));
+      }
+
+      if (acceptChange(chain, odfDeltas, mdfDeltas) == false) { return false; }
+
+      chain.m_FeatureEulerAngles[3 * feature] = g1ea[0];
+      chain.m_FeatureEulerAngles[3 * feature + 1] = g1ea[1];
+      chain.m_FeatureEulerAngles[3 * feature + 2] = g1ea[2];
+      chain.m_Quats[feature] = q1;
+      updateMisorientationBins(chain, feature, newBins);
+      return true;
+    }
+
+    /**
+     * @brief switchOrientations Tries to exchange the orientations of two Features
+     * @param chain Chain to update
+     * @param feature1 Feature Id of the first Feature
+     * @param feature2 Feature Id of the second Feature
+     * @return Whether the switch was accepted
+     */
+    bool switchOrientations(OrientationChain_t& chain, int32_t feature1, int32_t feature2) const
+    {
+      FOrientArrayType rod(4);
+      FOrientTransformsType::eu2ro(FOrientArrayType(&(chain.m_FeatureEulerAngles[3 * feature1]), 3), rod);
+      int32_t g1odfbin = m_OrientationOps->getOdfBin(rod);
+      FOrientTransformsType::eu2ro(FOrientArrayType(&(chain.m_FeatureEulerAngles[3 * feature2]), 3), rod);
+      int32_t g2odfbin = m_OrientationOps->getOdfBin(rod);
+
+      float volumeFraction1 = m_VolumeFractions[feature1];
+      float volumeFraction2 = m_VolumeFractions[feature2];
+      std::vector<std::pair<int32_t, float> > odfDeltas;
+      odfDeltas.push_back(std::make_pair(g1odfbin, volumeFraction2 - volumeFraction1));
+      odfDeltas.push_back(std::make_pair(g2odfbin, volumeFraction1 - volumeFraction2));
+
+      // the boundary between the two Features keeps its misorientation, all other boundaries of both change
+      int32_t features[2] = { feature1, feature2 };
+      std::vector<int32_t> newBins[2];
+      std::vector<std::pair<int32_t, float> > mdfDeltas;
+      for (int32_t f = 0; f < 2; f++)
+      {
+        int32_t feature = features[f];
+        int32_t other = features[1 - f];
+        size_t size = m_NeighborOffsets[feature + 1] - m_NeighborOffsets[feature];
+        newBins[f].assign(size, -1);
+        for (size_t j = 0; j < size; j++)
+        {
+          size_t boundary = m_NeighborOffsets[feature] + j;
+          int32_t curmisobin = chain.m_MisorientationBins[boundary];
+          int32_t neighbor = m_Neighbors[boundary];
+          if (curmisobin < 0 || neighbor == other) { continue; }
+          newBins[f][j] = MisorientationBin(m_OrientationOps, chain.m_Quats[other], chain.m_Quats[neighbor]);
+          mdfDeltas.push_back(std::make_pair(curmisobin, -m_AreaFractions[boundary]));
+          mdfDeltas.push_back(std::make_pair(newBins[f][j], m_AreaFractions[boundary]));
+        }
+      }
+
+      if (acceptChange(chain, odfDeltas, mdfDeltas) == false) { return false; }
+
+      for (int32_t i = 0; i < 3; i++)
+      {
+        std::swap(chain.m_FeatureEulerAngles[3 * feature1 + i], chain.m_FeatureEulerAngles[3 * feature2 + i]);
+      }
+      std::swap(chain.m_Quats[feature1], chain.m_Quats[feature2]);
+      updateMisorientationBins(chain, feature1, newBins[0]);
+      updateMisorientationBins(chain, feature2, newBins[1]);
+      return true;
+    }
+
+    /**
+     * @brief runChain Performs swaps and switches on one chain until it has made the given number of
+     * trials or has converged
+     * @param chain Chain to update
+     * @param rg Random number stream of the chain
+     * @param iterations Maximum number of trials
+     */
+    void runChain(OrientationChain_t& chain, SyntheticBuildingRandom& rg, int32_t iterations) const
+    {
+      for (int32_t i = 0; i < iterations; i++)
+      {
+        if (chain.m_BadTryCount >= (m_MaxIterations / 10) || chain.m_Iterations >= m_MaxIterations) { return; }
+
+        chain.m_Iterations++;
+        chain.m_BadTryCount++;
+        float random = static_cast<float>(rg.genrand_res53());
+
+        bool accepted = false;
+        int32_t selectedfeature1 = selectFeature(rg, -1);
+        if (selectedfeature1 < 0)
+        {
+          chain.m_BadTryCount = m_MaxIterations / 10;
+        }
+        else if (random < 0.5) // SwapOutOrientation
+        {
+          accepted = swapOutOrientation(chain, rg, selectedfeature1);
+        }
+        else // SwitchOrientation
+        {
+          int32_t selectedfeature2 = selectFeature(rg, selectedfeature1);
+          if (selectedfeature2 < 0)
+          {
+            chain.m_BadTryCount = m_MaxIterations / 10;
+          }
+          else
+          {
+            accepted = switchOrientations(chain, selectedfeature1, selectedfeature2);
+          }
+        }
+        if (accepted == true) { chain.m_BadTryCount = 0; }
+      }
+    }
+
+    /**
+     * @brief runChains Runs a batch of trials on each of a set of chains, in parallel when available. Every
+     * chain has its own random stream, so the result does not depend on the number of threads
+     * @param chains Chains to update
+     * @param generators Random number stream of each chain
+     * @param iterations Maximum number of trials of each chain
+     */
+    void runChains(std::vector<OrientationChain_t>& chains, std::vector<SyntheticBuildingRandom>& generators, int32_t iterations) const
+    {
+      if (chains.empty()) { return; }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+      bool doParallel = true;
+      if (doParallel == true && chains.size() > 1)
+      {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, chains.size(), 1), RunChainsImpl(this, &(chains.front()), &(generators.front()), iterations), tbb::auto_partitioner());
+      }
+      else
+#endif
+      {
+        RunChainsImpl serial(this, &(chains.front()), &(generators.front()), iterations);
+        serial.run(0, chains.size());
+      }
+    }
+
+  protected:
+    /**
+     * @brief acceptChange Decides whether a set of ODF and MDF bin changes improves the fit of a chain
+     * and applies it if it does
+     * @param chain Chain to update
+     * @param odfDeltas ODF (bin, change) pairs
+     * @param mdfDeltas MDF (bin, change) pairs
+     * @return Whether the change was accepted
+     */
+    bool acceptChange(OrientationChain_t& chain, std::vector<std::pair<int32_t, float> >& odfDeltas, std::vector<std::pair<int32_t, float> >& mdfDeltas) const
+    {
+      double odfChange = BinErrorChange(m_ActualOdf, chain.m_SimOdf, odfDeltas);
+      double mdfChange = BinErrorChange(m_ActualMdf, chain.m_SimMdf, mdfDeltas);
+
+      // the change is accepted if the relative ODF and MDF errors improve in sum
+      double epsilon = std::numeric_limits<float>::min();
+      double deltaerror = (odfChange / std::max(chain.m_OdfError, epsilon)) + (mdfChange / std::max(chain.m_MdfError, epsilon));
+      if (deltaerror >= 0.0) { return false; }
+
+      for (size_t i = 0; i < odfDeltas.size(); i++)
+      {
+        chain.m_SimOdf[odfDeltas[i].first] += odfDeltas[i].second;
+      }
+      for (size_t i = 0; i < mdfDeltas.size(); i++)
+      {
+        chain.m_SimMdf[mdfDeltas[i].first] += mdfDeltas[i].second;
+      }
+      chain.m_OdfError += odfChange;
+      chain.m_MdfError += mdfChange;
+      return true;
+    }
+
+    /**
+     * @brief updateMisorientationBins Stores the new MDF bins of a Feature and its neighbors after a
+     * change of its orientation was accepted
+     * @param chain Chain to update
+     * @param feature Feature Id of the Feature whose orientation changed
+     * @param newBins New MDF bin for each boundary of the Feature, or -1 to keep the old one
+     */
+    void updateMisorientationBins(OrientationChain_t& chain, int32_t feature, const std::vector<int32_t>& newBins) const
+    {
+      for (size_t j = 0; j < newBins.size(); j++)
+      {
+        if (newBins[j] < 0) { continue; }
+        chain.m_MisorientationBins[m_NeighborOffsets[feature] + j] = newBins[j];
+        // the neighbor keeps the same bin for the shared boundary
+        int32_t neighbor = m_Neighbors[m_NeighborOffsets[feature] + j];
+        for (size_t k = m_NeighborOffsets[neighbor]; k < m_NeighborOffsets[neighbor + 1]; k++)
+        {
+          if (m_Neighbors[k] == feature && chain.m_MisorientationBins[k] >= 0)
+          {
+            chain.m_MisorientationBins[k] = newBins[j];
+            break;
+          }
+        }
+      }
+    }
+
+  private:
+    SpaceGroupOps::Pointer m_OrientationOps;
+    const float* m_ActualOdf;
+    const float* m_ActualMdf;
+    int32_t m_OdfSize;
+    int32_t m_MdfSize;
+    const std::vector<size_t>& m_NeighborOffsets;
+    const std::vector<int32_t>& m_Neighbors;
+    const std::vector<float>& m_AreaFractions;
+    const std::vector<float>& m_VolumeFractions;
+    const std::vector<bool>& m_Selectable;
+    int32_t m_MaxIterations;
+
+    /**
+     * @brief The RunChainsImpl class runs a batch of trials on each of a range of chains
+     */
+    class RunChainsImpl
+    {
+        const OrientationChainRunner* m_Runner;
+        OrientationChain_t* m_Chains;
+        SyntheticBuildingRandom* m_Generators;
+        int32_t m_Iterations;
+
+      public:
+        RunChainsImpl(const OrientationChainRunner* runner, OrientationChain_t* chains, SyntheticBuildingRandom* generators, int32_t iterations) :
+          m_Runner(runner),
+          m_Chains(chains),
+          m_Generators(generators),
+          m_Iterations(iterations)
+        {}
+
+        virtual ~RunChainsImpl() {}
+
+        void run(size_t start, size_t end) const
+        {
+          for (size_t c = start; c < end; c++)
+          {
+            m_Runner->runChain(m_Chains[c], m_Generators[c], m_Iterations);
+          }
+        }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+        void operator()(const tbb::blocked_range<size_t>& r) const
+        {
+          run(r.begin(), r.end());
+        }
+#endif
+    };
+
+    OrientationChainRunner(const OrientationChainRunner&); // Copy Constructor Not Implemented
+    void operator=(const OrientationChainRunner&); // Operator '=' Not Implemented
+};
+
+#endif /* _orientationchainrunner_hpp_ */
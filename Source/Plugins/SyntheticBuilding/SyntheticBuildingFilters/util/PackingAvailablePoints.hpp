@@ -0,0 +1,194 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#ifndef _packingavailablepoints_hpp_
+#define _packingavailablepoints_hpp_
+
+#include <algorithm>
+#include <vector>
+
+#include "SIMPLib/SIMPLib.h"
+
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PackingGrid.hpp"
+
+/**
+ * @class PackingAvailablePoints PackingAvailablePoints.hpp SyntheticBuilding/SyntheticBuildingFilters/util/PackingAvailablePoints.hpp
+ * @brief Counts the packing points that are not in any exclusion zone (and inside the mask, if there is one) and picks
+ * the n-th of them in grid order.
+ *
+ * Only the number of available points per PackingGrid tile is stored, in a Fenwick tree, so the memory does not grow
+ * with the number of available points. Picking a point finds its tile in the tree and then scans the exclusion counters
+ * of that one tile.
+ */
+class PackingAvailablePoints
+{
+  public:
+    PackingAvailablePoints() :
+      m_Mask(NULL),
+      m_NumberOfPoints(0),
+      m_Count(0)
+    {}
+
+    virtual ~PackingAvailablePoints() {}
+
+    /**
+     * @brief rebuild Counts the available points from scratch
+     * @param exclusionOwners Number of exclusion zones covering each packing point
+     * @param mask Optional mask over the packing points; NULL if every point may be used
+     */
+    void rebuild(const PackingGrid& exclusionOwners, const bool* mask)
+    {
+      m_Mask = mask;
+      m_NumberOfPoints = exclusionOwners.getNumberOfPoints();
+      int64_t numTiles = exclusionOwners.getNumberOfTiles();
+      m_Tree.assign(static_cast<size_t>(numTiles + 1), 0);
+      m_Count = 0;
+      for (int64_t t = 0; t < numTiles; t++)
+      {
+        int64_t start = t << PackingGrid::k_TileShift;
+        int64_t end = std::min(start + PackingGrid::k_TileSize, m_NumberOfPoints);
+        int64_t count = 0;
+        if (exclusionOwners.isTileEmpty(t) == true && NULL == m_Mask)
+        {
+          count = end - start;
+        }
+        else
+        {
+          for (int64_t i = start; i < end; i++)
+          {
+            if (isAvailable(exclusionOwners, i) == true) { count++; }
+          }
+        }
+        m_Tree[t + 1] = count;
+        m_Count += count;
+      }
+      // turn the per tile counts into a Fenwick tree in place
+      for (size_t i = 1; i < m_Tree.size(); i++)
+      {
+        size_t parent = i + (i & (~i + 1));
+        if (parent < m_Tree.size()) { m_Tree[parent] += m_Tree[i]; }
+      }
+    }
+
+    /**
+     * @brief pointAdded Records that a point left its last exclusion zone
+     */
+    void pointAdded(int64_t index)
+    {
+      if (NULL != m_Mask && m_Mask[index] == false) { return; }
+      update(index >> PackingGrid::k_TileShift, 1);
+    }
+
+    /**
+     * @brief pointRemoved Records that a point entered its first exclusion zone
+     */
+    void pointRemoved(int64_t index)
+    {
+      if (NULL != m_Mask && m_Mask[index] == false) { return; }
+      update(index >> PackingGrid::k_TileShift, -1);
+    }
+
+    /**
+     * @brief getCount Returns the number of available points
+     */
+    int64_t getCount() const { return m_Count; }
+
+    /**
+     * @brief getPoint Returns the key-th available point in grid order
+     * @param exclusionOwners The exclusion counters the counts were last brought up to date with
+     * @param key Number in [0, getCount())
+     */
+    int64_t getPoint(const PackingGrid& exclusionOwners, int64_t key) const
+    {
+      // descend the Fenwick tree to the tile that holds the point
+      size_t tile = 0;
+      size_t step = 1;
+      while ((step << 1) < m_Tree.size()) { step <<= 1; }
+      for (; step > 0; step >>= 1)
+      {
+        if (tile + step < m_Tree.size() && m_Tree[tile + step] <= key)
+        {
+          tile += step;
+          key -= m_Tree[tile];
+        }
+      }
+      int64_t start = static_cast<int64_t>(tile) << PackingGrid::k_TileShift;
+      int64_t end = std::min(start + PackingGrid::k_TileSize, m_NumberOfPoints);
+      if (exclusionOwners.isTileEmpty(static_cast<int64_t>(tile)) == true && NULL == m_Mask)
+      {
+        return std::min(start + key, end - 1);
+      }
+      for (int64_t i = start; i < end; i++)
+      {
+        if (isAvailable(exclusionOwners, i) == true)
+        {
+          if (key == 0) { return i; }
+          key--;
+        }
+      }
+      return end - 1;
+    }
+
+    /**
+     * @brief getMemoryUsage Returns the number of bytes held by the counts
+     */
+    size_t getMemoryUsage() const { return m_Tree.size() * sizeof(int64_t); }
+
+  private:
+    const bool* m_Mask;
+    int64_t m_NumberOfPoints;
+    int64_t m_Count;
+    std::vector<int64_t> m_Tree;
+
+    bool isAvailable(const PackingGrid& exclusionOwners, int64_t index) const
+    {
+      return exclusionOwners.getValue(index) == 0 && (NULL == m_Mask || m_Mask[index] == true);
+    }
+
+    void update(int64_t tile, int64_t delta)
+    {
+      m_Count += delta;
+      for (size_t i = static_cast<size_t>(tile + 1); i < m_Tree.size(); i += (i & (~i + 1)))
+      {
+        m_Tree[i] += delta;
+      }
+    }
+
+    PackingAvailablePoints(const PackingAvailablePoints&); // Copy Constructor Not Implemented
+    void operator=(const PackingAvailablePoints&); // Operator '=' Not Implemented
+};
+
+#endif /* _packingavailablepoints_hpp_ */
@@ -0,0 +1,310 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#ifndef _packingcheckpoint_hpp_
+#define _packingcheckpoint_hpp_
+
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/task_group.h>
+#endif
+
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+#include "SIMPLib/SIMPLib.h"
+
+/**
+ * @class PackingCheckpoint PackingCheckpoint.hpp SyntheticBuilding/SyntheticBuildingFilters/util/PackingCheckpoint.hpp
+ * @brief Named binary blocks holding the state of a packing optimization loop so that it can be resumed later.
+ *
+ * The file is a magic string and version followed by (name, byte count, bytes) records in native byte order; it
+ * is meant to be read back on the same machine by the same filter. Files are written to a temporary file first
+ * and then renamed, so a crash during a write leaves the previous checkpoint intact.
+ */
+class PackingCheckpoint
+{
+  public:
+    PackingCheckpoint() {}
+    virtual ~PackingCheckpoint() {}
+
+    void clear() { m_Blocks.clear(); }
+
+    void swap(PackingCheckpoint& other) { m_Blocks.swap(other.m_Blocks); }
+
+    template<typename T>
+    void setArray(const std::string& name, const T* data, size_t count)
+    {
+      std::vector<char>& block = m_Blocks[name];
+      block.resize(count * sizeof(T));
+      if (count > 0) { ::memcpy(&(block.front()), data, count * sizeof(T)); }
+    }
+
+    template<typename T>
+    void setArray(const std::string& name, const std::vector<T>& data)
+    {
+      setArray(name, data.empty() ? NULL : &(data.front()), data.size());
+    }
+
+    template<typename T>
+    void setValue(const std::string& name, T value)
+    {
+      setArray(name, &value, 1);
+    }
+
+    /**
+     * @brief getArray Copies a block into data, which must hold exactly count values
+     * @return false if the block does not exist or has a different size
+     */
+    template<typename T>
+    bool getArray(const std::string& name, T* data, size_t count) const
+    {
+      std::map<std::string, std::vector<char> >::const_iterator iter = m_Blocks.find(name);
+      if (iter == m_Blocks.end() || iter->second.size() != count * sizeof(T)) { return false; }
+      if (count > 0) { ::memcpy(data, &(iter->second.front()), count * sizeof(T)); }
+      return true;
+    }
+
+    template<typename T>
+    bool getArray(const std::string& name, std::vector<T>& data) const
+    {
+      std::map<std::string, std::vector<char> >::const_iterator iter = m_Blocks.find(name);
+      if (iter == m_Blocks.end() || iter->second.size() % sizeof(T) != 0) { return false; }
+      data.resize(iter->second.size() / sizeof(T));
+      return getArray(name, data.empty() ? NULL : &(data.front()), data.size());
+    }
+
+    template<typename T>
+    bool getValue(const std::string& name, T& value) const
+    {
+      return getArray(name, &value, 1);
+    }
+
+    /**
+     * @brief setMap Stores a map as a flat array of (key, value) pairs
+     */
+    void setMap(const std::string& name, const std::map<size_t, size_t>& map)
+    {
+      std::vector<uint64_t> pairs;
+      pairs.reserve(2 * map.size());
+      for (std::map<size_t, size_t>::const_iterator iter = map.begin(); iter != map.end(); ++iter)
+      {
+        pairs.push_back(iter->first);
+        pairs.push_back(iter->second);
+      }
+      setArray(name, pairs);
+    }
+
+    bool getMap(const std::string& name, std::map<size_t, size_t>& map) const
+    {
+      std::vector<uint64_t> pairs;
+      if (getArray(name, pairs) == false || pairs.size() % 2 != 0) { return false; }
+      map.clear();
+      for (size_t i = 0; i < pairs.size(); i += 2)
+      {
+        map.insert(map.end(), std::make_pair(static_cast<size_t>(pairs[i]), static_cast<size_t>(pairs[i + 1])));
+      }
+      return true;
+    }
+
+    /**
+     * @brief writeFile Writes all blocks to filePath
+     * @return 0 on success, a negative value if the file could not be written
+     */
+    int32_t writeFile(const QString& filePath) const
+    {
+      QString tempPath = filePath + ".tmp";
+      std::ofstream out(tempPath.toLatin1().data(), std::ios_base::binary | std::ios_base::trunc);
+      if (out.is_open() == false) { return -1; }
+      out.write(Magic(), 8);
+      uint32_t version = k_Version;
+      uint32_t numBlocks = static_cast<uint32_t>(m_Blocks.size());
+      out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+      out.write(reinterpret_cast<const char*>(&numBlocks), sizeof(numBlocks));
+      for (std::map<std::string, std::vector<char> >::const_iterator iter = m_Blocks.begin(); iter != m_Blocks.end(); ++iter)
+      {
+        uint32_t nameLength = static_cast<uint32_t>(iter->first.size());
+        uint64_t byteCount = static_cast<uint64_t>(iter->second.size());
+        out.write(reinterpret_cast<const char*>(&nameLength), sizeof(nameLength));
+        out.write(iter->first.data(), nameLength);
+        out.write(reinterpret_cast<const char*>(&byteCount), sizeof(byteCount));
+        if (byteCount > 0) { out.write(&(iter->second.front()), byteCount); }
+      }
+      out.close();
+      if (out.fail() == true) { return -2; }
+      if (QFile::exists(filePath) == true && QFile::remove(filePath) == false) { return -3; }
+      if (QFile::rename(tempPath, filePath) == false) { return -3; }
+      return 0;
+    }
+
+    /**
+     * @brief readFile Replaces all blocks with the ones stored in filePath
+     * @return 0 on success, a negative value if the file could not be read or is not a checkpoint
+     */
+    int32_t readFile(const QString& filePath)
+    {
+      m_Blocks.clear();
+      std::ifstream in(filePath.toLatin1().data(), std::ios_base::binary);
+      if (in.is_open() == false) { return -1; }
+      char magic[8] = { 0 };
+      uint32_t version = 0, numBlocks = 0;
+      in.read(magic, 8);
+      in.read(reinterpret_cast<char*>(&version), sizeof(version));
+      in.read(reinterpret_cast<char*>(&numBlocks), sizeof(numBlocks));
+      if (in.fail() == true || ::memcmp(magic, Magic(), 8) != 0 || version != k_Version) { return -2; }
+      for (uint32_t i = 0; i < numBlocks; i++)
+      {
+        uint32_t nameLength = 0;
+        uint64_t byteCount = 0;
+        in.read(reinterpret_cast<char*>(&nameLength), sizeof(nameLength));
+        if (in.fail() == true) { return -2; }
+        std::string name(nameLength, '\0');
+        if (nameLength > 0) { in.read(&(name[0]), nameLength); }
+        in.read(reinterpret_cast<char*>(&byteCount), sizeof(byteCount));
+        if (in.fail() == true) { return -2; }
+        std::vector<char>& block = m_Blocks[name];
+        block.resize(byteCount);
+        if (byteCount > 0) { in.read(&(block.front()), byteCount); }
+        if (in.fail() == true) { m_Blocks.clear(); return -2; }
+      }
+      return 0;
+    }
+
+  private:
+    static const uint32_t k_Version = 1;
+
+    static const char* Magic() { return "D3DPACK1"; }
+
+    std::map<std::string, std::vector<char> > m_Blocks;
+};
+
+/**
+ * @class PackingCheckpointWriter PackingCheckpoint.hpp SyntheticBuilding/SyntheticBuildingFilters/util/PackingCheckpoint.hpp
+ * @brief Writes checkpoints in the background so the optimization loop only pays for taking the snapshot.
+ */
+class PackingCheckpointWriter
+{
+  public:
+    PackingCheckpointWriter() :
+      m_Error(0)
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+      , m_Group(NULL)
+#endif
+    {}
+
+    virtual ~PackingCheckpointWriter()
+    {
+      wait();
+    }
+
+    /**
+     * @brief write Takes over the contents of checkpoint, which is left empty, and writes it to filePath. A write
+     * that is still running is waited for first, so at most one snapshot is held besides the caller's.
+     * @return The result of the previous write
+     */
+    int32_t write(PackingCheckpoint& checkpoint, const QString& filePath)
+    {
+      int32_t err = wait();
+      m_Pending.swap(checkpoint);
+      checkpoint.clear();
+      m_FilePath = filePath;
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+      m_Group = new tbb::task_group;
+      m_Group->run(WriteCheckpointImpl(&m_Pending, &m_FilePath, &m_Error));
+#else
+      WriteCheckpointImpl serial(&m_Pending, &m_FilePath, &m_Error);
+      serial();
+#endif
+      return err;
+    }
+
+    /**
+     * @brief wait Blocks until the current write is finished
+     * @return 0 if the last write succeeded, a negative value otherwise
+     */
+    int32_t wait()
+    {
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+      if (NULL != m_Group)
+      {
+        m_Group->wait();
+        delete m_Group;
+        m_Group = NULL;
+      }
+#endif
+      m_Pending.clear();
+      return m_Error;
+    }
+
+  private:
+    PackingCheckpoint m_Pending;
+    QString m_FilePath;
+    int32_t m_Error;
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+    tbb::task_group* m_Group;
+#endif
+
+    class WriteCheckpointImpl
+    {
+        const PackingCheckpoint* m_Checkpoint;
+        const QString* m_FilePath;
+        int32_t* m_Error;
+
+      public:
+        WriteCheckpointImpl(const PackingCheckpoint* checkpoint, const QString* filePath, int32_t* error) :
+          m_Checkpoint(checkpoint),
+          m_FilePath(filePath),
+          m_Error(error)
+        {}
+
+        virtual ~WriteCheckpointImpl() {}
+
+        void operator()() const
+        {
+          *m_Error = m_Checkpoint->writeFile(*m_FilePath);
+        }
+    };
+
+    PackingCheckpointWriter(const PackingCheckpointWriter&); // Copy Constructor Not Implemented
+    void operator=(const PackingCheckpointWriter&); // Operator '=' Not Implemented
+};
+
+#endif /* _packingcheckpoint_hpp_ */
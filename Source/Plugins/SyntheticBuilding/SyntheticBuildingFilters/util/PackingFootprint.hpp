@@ -0,0 +1,180 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#ifndef _packingfootprint_hpp_
+#define _packingfootprint_hpp_
+
+#include <algorithm>
+#include <vector>
+
+#include "SIMPLib/SIMPLib.h"
+
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PeriodicBox.hpp"
+
+/**
+ * @class PackingFootprint PackingFootprint.hpp SyntheticBuilding/SyntheticBuildingFilters/util/PackingFootprint.hpp
+ * @brief Run length encoded set of packing grid points covered by a Feature.
+ *
+ * The points are stored as runs along the plane axis, relative to an origin cell, in the order they were added, so
+ * iterating the runs visits the points in insertion order. Moving the Feature by a whole number of packing grid
+ * cells only moves the origin.
+ */
+class PackingFootprint
+{
+  public:
+    /**
+     * @brief A run of points along the plane axis; all points of a run share the same exclusion flag
+     */
+    typedef struct
+    {
+      int32_t m_Column;
+      int32_t m_Row;
+      int32_t m_Plane;
+      int32_t m_Length;
+      bool m_Exclusion;
+    } Run_t;
+
+    /**
+     * @brief A run mapped onto the packing grid: m_Count points starting at grid index m_Start, one plane apart
+     */
+    typedef struct
+    {
+      int64_t m_Start;
+      int64_t m_Count;
+    } Segment_t;
+
+    PackingFootprint() :
+      m_NumberOfPoints(0)
+    {
+      m_Origin[0] = m_Origin[1] = m_Origin[2] = 0;
+    }
+
+    virtual ~PackingFootprint() {}
+
+    /**
+     * @brief clear Removes all points and sets the origin the later points are stored relative to
+     */
+    void clear(int64_t column, int64_t row, int64_t plane)
+    {
+      m_Runs.clear();
+      m_NumberOfPoints = 0;
+      m_Origin[0] = column;
+      m_Origin[1] = row;
+      m_Origin[2] = plane;
+    }
+
+    /**
+     * @brief addPoint Appends a point; extends the last run if the point directly follows it along the plane axis
+     * @param exclusion Whether the point is part of the exclusion zone of the Feature
+     */
+    void addPoint(int64_t column, int64_t row, int64_t plane, bool exclusion)
+    {
+      int32_t c = static_cast<int32_t>(column - m_Origin[0]);
+      int32_t r = static_cast<int32_t>(row - m_Origin[1]);
+      int32_t p = static_cast<int32_t>(plane - m_Origin[2]);
+      m_NumberOfPoints++;
+      if (m_Runs.empty() == false)
+      {
+        Run_t& last = m_Runs.back();
+        if (last.m_Column == c && last.m_Row == r && last.m_Plane + last.m_Length == p && last.m_Exclusion == exclusion)
+        {
+          last.m_Length++;
+          return;
+        }
+      }
+      Run_t run = { c, r, p, 1, exclusion };
+      m_Runs.push_back(run);
+    }
+
+    /**
+     * @brief translate Moves every point by a whole number of packing grid cells
+     */
+    void translate(int64_t shiftColumn, int64_t shiftRow, int64_t shiftPlane)
+    {
+      m_Origin[0] += shiftColumn;
+      m_Origin[1] += shiftRow;
+      m_Origin[2] += shiftPlane;
+    }
+
+    size_t getNumberOfPoints() const { return m_NumberOfPoints; }
+
+    size_t getNumberOfRuns() const { return m_Runs.size(); }
+
+    const Run_t& getRun(size_t i) const { return m_Runs[i]; }
+
+    const int64_t* getOrigin() const { return m_Origin; }
+
+    /**
+     * @brief getSegments Maps a run, moved by shift, onto the packing grid. With periodic boundaries every coordinate
+     * is wrapped by at most one period, like the point lists PackPrimaryPhases used before; otherwise the points
+     * outside of the grid are dropped. The segments are returned in the order of the points of the run.
+     * @param run Index of the run
+     * @param packingPoints Dimensions of the packing grid
+     * @param periodic Whether the grid is periodic
+     * @param shift Additional translation of the footprint
+     * @param segments Filled with up to 3 segments
+     * @return Number of segments
+     */
+    int32_t getSegments(size_t run, const int64_t packingPoints[3], bool periodic, const int64_t shift[3], Segment_t segments[3]) const
+    {
+      const Run_t& r = m_Runs[run];
+      int64_t column = m_Origin[0] + shift[0] + r.m_Column;
+      int64_t row = m_Origin[1] + shift[1] + r.m_Row;
+      int64_t plane = m_Origin[2] + shift[2] + r.m_Plane;
+      PeriodicBox::Range_t columns[3];
+      PeriodicBox::Range_t rows[3];
+      PeriodicBox::Range_t planes[3];
+      if (PeriodicBox::SplitRange(column, column + 1, packingPoints[0], periodic, columns) == 0) { return 0; }
+      if (PeriodicBox::SplitRange(row, row + 1, packingPoints[1], periodic, rows) == 0) { return 0; }
+      int32_t numSegments = PeriodicBox::SplitRange(plane, plane + r.m_Length, packingPoints[2], periodic, planes);
+
+      int64_t base = (packingPoints[0] * (row + rows[0].m_Wrap)) + column + columns[0].m_Wrap;
+      int64_t planeStride = packingPoints[0] * packingPoints[1];
+      for (int32_t s = 0; s < numSegments; s++)
+      {
+        segments[s].m_Start = base + (planeStride * (planes[s].m_Start + planes[s].m_Wrap));
+        segments[s].m_Count = planes[s].m_Count;
+      }
+      return numSegments;
+    }
+
+  private:
+    int64_t m_Origin[3];
+    size_t m_NumberOfPoints;
+    std::vector<Run_t> m_Runs;
+};
+
+#endif /* _packingfootprint_hpp_ */
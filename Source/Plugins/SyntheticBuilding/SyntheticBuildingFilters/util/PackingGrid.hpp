@@ -0,0 +1,280 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#ifndef _packinggrid_hpp_
+#define _packinggrid_hpp_
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "SIMPLib/SIMPLib.h"
+
+/**
+ * @class PackingGrid PackingGrid.hpp SyntheticBuilding/SyntheticBuildingFilters/util/PackingGrid.hpp
+ * @brief Sparse, tiled array of non-negative counters over the packing grid.
+ *
+ * The points are split into tiles of k_TileSize consecutive grid indices. A tile whose counters are all zero is not
+ * allocated, and is released again as soon as its last counter drops back to zero. An allocated tile stores its
+ * counters with the smallest width (1, 2 or 4 bytes) that holds the largest value it has seen.
+ */
+class PackingGrid
+{
+  public:
+    static const int64_t k_TileShift = 12;
+    static const int64_t k_TileSize = 1 << 12;
+
+    PackingGrid() :
+      m_NumberOfPoints(0),
+      m_MemoryUsage(0),
+      m_PeakMemoryUsage(0)
+    {}
+
+    virtual ~PackingGrid()
+    {
+      clear();
+    }
+
+    /**
+     * @brief resize Sets the number of points; all counters are zero afterwards
+     */
+    void resize(int64_t numberOfPoints)
+    {
+      clear();
+      m_NumberOfPoints = numberOfPoints;
+      m_Tiles.assign(static_cast<size_t>((numberOfPoints + k_TileSize - 1) >> k_TileShift), NULL);
+      m_MemoryUsage = m_Tiles.size() * sizeof(Tile_t*);
+      m_PeakMemoryUsage = m_MemoryUsage;
+    }
+
+    /**
+     * @brief clear Releases all tiles
+     */
+    void clear()
+    {
+      for (size_t t = 0; t < m_Tiles.size(); t++)
+      {
+        delete m_Tiles[t];
+      }
+      m_Tiles.clear();
+      m_NumberOfPoints = 0;
+      m_MemoryUsage = 0;
+    }
+
+    int64_t getNumberOfPoints() const { return m_NumberOfPoints; }
+    int64_t getNumberOfTiles() const { return static_cast<int64_t>(m_Tiles.size()); }
+
+    /**
+     * @brief isTileEmpty Returns whether all counters of the tile are zero
+     */
+    bool isTileEmpty(int64_t tile) const { return NULL == m_Tiles[tile]; }
+
+    /**
+     * @brief getValue Returns the counter of a point
+     */
+    int32_t getValue(int64_t index) const
+    {
+      const Tile_t* tile = m_Tiles[index >> k_TileShift];
+      if (NULL == tile) { return 0; }
+      return tile->get(index & (k_TileSize - 1));
+    }
+
+    int32_t operator[](int64_t index) const { return getValue(index); }
+
+    /**
+     * @brief add Adds delta to the counter of a point
+     * @return The new value of the counter
+     */
+    int32_t add(int64_t index, int32_t delta)
+    {
+      size_t t = static_cast<size_t>(index >> k_TileShift);
+      int64_t offset = index & (k_TileSize - 1);
+      Tile_t* tile = m_Tiles[t];
+      int32_t oldValue = (NULL == tile) ? 0 : tile->get(offset);
+      int32_t newValue = oldValue + delta;
+      if (newValue == oldValue) { return newValue; }
+      if (NULL == tile)
+      {
+        tile = new Tile_t();
+        m_Tiles[t] = tile;
+        m_MemoryUsage += sizeof(Tile_t) + tile->m_Data.size();
+      }
+      int32_t width = WidthFor(newValue);
+      if (width > tile->m_Width)
+      {
+        m_MemoryUsage -= tile->m_Data.size();
+        tile->widen(width);
+        m_MemoryUsage += tile->m_Data.size();
+      }
+      tile->set(offset, newValue);
+      if (oldValue == 0) { tile->m_NonZero++; }
+      else if (newValue == 0) { tile->m_NonZero--; }
+
+      if (tile->m_NonZero == 0)
+      {
+        m_MemoryUsage -= sizeof(Tile_t) + tile->m_Data.size();
+        delete tile;
+        m_Tiles[t] = NULL;
+      }
+      m_PeakMemoryUsage = std::max(m_PeakMemoryUsage, m_MemoryUsage);
+      return newValue;
+    }
+
+    /**
+     * @brief setValue Sets the counter of a point
+     */
+    void setValue(int64_t index, int32_t value)
+    {
+      add(index, value - getValue(index));
+    }
+
+    /**
+     * @brief getMemoryUsage Returns the number of bytes currently held by the grid
+     */
+    size_t getMemoryUsage() const { return m_MemoryUsage; }
+
+    /**
+     * @brief getPeakMemoryUsage Returns the largest number of bytes the grid has held since it was resized
+     */
+    size_t getPeakMemoryUsage() const { return m_PeakMemoryUsage; }
+
+    /**
+     * @brief getTiles Copies the allocated tiles out, e.g. for a checkpoint
+     * @param tiles Receives the index of every allocated tile
+     * @param values Receives k_TileSize counters per allocated tile
+     */
+    void getTiles(std::vector<int64_t>& tiles, std::vector<int32_t>& values) const
+    {
+      tiles.clear();
+      values.clear();
+      for (size_t t = 0; t < m_Tiles.size(); t++)
+      {
+        if (NULL == m_Tiles[t]) { continue; }
+        tiles.push_back(static_cast<int64_t>(t));
+        for (int64_t i = 0; i < k_TileSize; i++)
+        {
+          values.push_back(m_Tiles[t]->get(i));
+        }
+      }
+    }
+
+    /**
+     * @brief setTiles Replaces all counters with the tiles written by getTiles
+     * @return false if the tiles do not fit the grid
+     */
+    bool setTiles(const std::vector<int64_t>& tiles, const std::vector<int32_t>& values)
+    {
+      if (values.size() != tiles.size() * static_cast<size_t>(k_TileSize)) { return false; }
+      for (size_t i = 0; i < tiles.size(); i++)
+      {
+        if (tiles[i] < 0 || tiles[i] >= getNumberOfTiles()) { return false; }
+      }
+      resize(m_NumberOfPoints);
+      for (size_t i = 0; i < tiles.size(); i++)
+      {
+        int64_t start = tiles[i] << k_TileShift;
+        for (int64_t j = 0; j < k_TileSize && start + j < m_NumberOfPoints; j++)
+        {
+          add(start + j, values[i * k_TileSize + j]);
+        }
+      }
+      return true;
+    }
+
+  private:
+    /**
+     * @brief One allocated tile; m_Data holds k_TileSize counters of m_Width bytes each
+     */
+    class Tile_t
+    {
+      public:
+        Tile_t() :
+          m_Width(1),
+          m_NonZero(0),
+          m_Data(k_TileSize, 0)
+        {}
+
+        int32_t get(int64_t offset) const
+        {
+          const uint8_t* data = &(m_Data.front());
+          if (m_Width == 1) { return data[offset]; }
+          if (m_Width == 2) { return reinterpret_cast<const uint16_t*>(data)[offset]; }
+          return reinterpret_cast<const int32_t*>(data)[offset];
+        }
+
+        void set(int64_t offset, int32_t value)
+        {
+          uint8_t* data = &(m_Data.front());
+          if (m_Width == 1) { data[offset] = static_cast<uint8_t>(value); }
+          else if (m_Width == 2) { reinterpret_cast<uint16_t*>(data)[offset] = static_cast<uint16_t>(value); }
+          else { reinterpret_cast<int32_t*>(data)[offset] = value; }
+        }
+
+        void widen(int32_t width)
+        {
+          Tile_t wider;
+          wider.m_Width = width;
+          wider.m_Data.assign(k_TileSize * width, 0);
+          for (int64_t i = 0; i < k_TileSize; i++)
+          {
+            wider.set(i, get(i));
+          }
+          m_Width = width;
+          m_Data.swap(wider.m_Data);
+        }
+
+        int32_t m_Width;
+        int32_t m_NonZero;
+        std::vector<uint8_t> m_Data;
+    };
+
+    int64_t m_NumberOfPoints;
+    std::vector<Tile_t*> m_Tiles;
+    size_t m_MemoryUsage;
+    size_t m_PeakMemoryUsage;
+
+    static int32_t WidthFor(int32_t value)
+    {
+      if (value >= 0 && value <= static_cast<int32_t>(std::numeric_limits<uint8_t>::max())) { return 1; }
+      if (value >= 0 && value <= static_cast<int32_t>(std::numeric_limits<uint16_t>::max())) { return 2; }
+      return 4;
+    }
+
+    PackingGrid(const PackingGrid&); // Copy Constructor Not Implemented
+    void operator=(const PackingGrid&); // Operator '=' Not Implemented
+};
+
+#endif /* _packinggrid_hpp_ */
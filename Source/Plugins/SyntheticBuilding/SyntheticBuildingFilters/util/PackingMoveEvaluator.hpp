@@ -0,0 +1,224 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#ifndef _packingmoveevaluator_hpp_
+#define _packingmoveevaluator_hpp_
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
+#include "SIMPLib/SIMPLib.h"
+
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PackingFootprint.hpp"
+
+/**
+ * @brief A trial move of one Feature by a whole number of packing grid cells
+ */
+typedef struct
+{
+  int32_t m_Feature;
+  int64_t m_Shift[3];
+} PackingMove_t;
+
+/**
+ * @class PackingMoveEvaluator PackingMoveEvaluator.hpp SyntheticBuilding/SyntheticBuildingFilters/util/PackingMoveEvaluator.hpp
+ * @brief Computes the change of the packing filling error for trial moves without touching the packing grid.
+ *
+ * The filling error is the sum over all packing points of (owners - 1)^2, where owners is the number of Features
+ * covering the point. A move changes the owner count of the points in the Feature's old and new footprints only, so
+ * its delta is exact integer arithmetic over those points. Moves whose footprints are disjoint do not change each
+ * other's delta, which is what allows a batch of moves to be evaluated in parallel against the same grid and then
+ * committed in order, re-evaluating only the moves whose footprint was touched by an earlier accepted move.
+ */
+class PackingMoveEvaluator
+{
+  public:
+    /**
+     * @brief PackingMoveEvaluator
+     * @param packingPoints Dimensions of the packing grid
+     * @param periodicBoundaries Whether footprints wrap around the grid
+     * @param footprints Packing grid footprint of every Feature
+     */
+    PackingMoveEvaluator(const int64_t packingPoints[3], bool periodicBoundaries, const std::vector<PackingFootprint>& footprints) :
+      m_PeriodicBoundaries(periodicBoundaries),
+      m_Footprints(footprints)
+    {
+      m_PackingPoints[0] = packingPoints[0];
+      m_PackingPoints[1] = packingPoints[1];
+      m_PackingPoints[2] = packingPoints[2];
+    }
+
+    virtual ~PackingMoveEvaluator() {}
+
+    /**
+     * @brief moveDelta Returns the change of the (unnormalized) filling error if the move was applied to the grid
+     * @param featureOwners Number of Features covering each packing point; any type indexed with operator[]
+     * @param move The trial move
+     * @param cells Filled with the sorted, distinct packing points covered by the old or new footprint
+     */
+    template<typename OwnersType>
+    int64_t moveDelta(const OwnersType& featureOwners, const PackingMove_t& move, std::vector<int64_t>& cells) const
+    {
+      const PackingFootprint& footprint = m_Footprints[move.m_Feature];
+      const int64_t noShift[3] = { 0, 0, 0 };
+      int64_t planeStride = m_PackingPoints[0] * m_PackingPoints[1];
+      PackingFootprint::Segment_t segments[3];
+
+      std::vector<std::pair<int64_t, int32_t> > changes;
+      changes.reserve(2 * footprint.getNumberOfPoints());
+      size_t numRuns = footprint.getNumberOfRuns();
+      for (size_t i = 0; i < numRuns; i++)
+      {
+        int32_t numSegments = footprint.getSegments(i, m_PackingPoints, m_PeriodicBoundaries, noShift, segments);
+        for (int32_t s = 0; s < numSegments; s++)
+        {
+          for (int64_t k = 0, index = segments[s].m_Start; k < segments[s].m_Count; k++, index += planeStride)
+          {
+            changes.push_back(std::make_pair(index, -1));
+          }
+        }
+        numSegments = footprint.getSegments(i, m_PackingPoints, m_PeriodicBoundaries, move.m_Shift, segments);
+        for (int32_t s = 0; s < numSegments; s++)
+        {
+          for (int64_t k = 0, index = segments[s].m_Start; k < segments[s].m_Count; k++, index += planeStride)
+          {
+            changes.push_back(std::make_pair(index, 1));
+          }
+        }
+      }
+      std::sort(changes.begin(), changes.end());
+
+      cells.clear();
+      int64_t delta = 0;
+      size_t numChanges = changes.size();
+      for (size_t i = 0; i < numChanges;)
+      {
+        int64_t index = changes[i].first;
+        int64_t net = 0;
+        for (; i < numChanges && changes[i].first == index; i++)
+        {
+          net += changes[i].second;
+        }
+        int64_t before = static_cast<int64_t>(featureOwners[index]) - 1;
+        int64_t after = before + net;
+        delta += (after * after) - (before * before);
+        cells.push_back(index);
+      }
+      return delta;
+    }
+
+    /**
+     * @brief evaluateMoves Computes moveDelta for every move of a batch, in parallel when available
+     * @param featureOwners Number of Features covering each packing point; only read
+     * @param moves The trial moves
+     * @param deltas Filled with the delta of each move
+     * @param cells Filled with the footprint points of each move
+     */
+    template<typename OwnersType>
+    void evaluateMoves(const OwnersType& featureOwners, const std::vector<PackingMove_t>& moves, std::vector<int64_t>& deltas, std::vector<std::vector<int64_t> >& cells) const
+    {
+      deltas.resize(moves.size());
+      cells.resize(moves.size());
+      if (moves.empty()) { return; }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+      bool doParallel = true;
+      if (doParallel == true)
+      {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, moves.size()), EvaluateMovesImpl<OwnersType>(this, &featureOwners, &(moves.front()), &(deltas.front()), &(cells.front())), tbb::auto_partitioner());
+      }
+      else
+#endif
+      {
+        EvaluateMovesImpl<OwnersType> serial(this, &featureOwners, &(moves.front()), &(deltas.front()), &(cells.front()));
+        serial.evaluate(0, moves.size());
+      }
+    }
+
+  private:
+    int64_t m_PackingPoints[3];
+    bool m_PeriodicBoundaries;
+    const std::vector<PackingFootprint>& m_Footprints;
+
+    template<typename OwnersType>
+    class EvaluateMovesImpl
+    {
+        const PackingMoveEvaluator* m_Evaluator;
+        const OwnersType* m_FeatureOwners;
+        const PackingMove_t* m_Moves;
+        int64_t* m_Deltas;
+        std::vector<int64_t>* m_Cells;
+
+      public:
+        EvaluateMovesImpl(const PackingMoveEvaluator* evaluator, const OwnersType* featureOwners, const PackingMove_t* moves, int64_t* deltas, std::vector<int64_t>* cells) :
+          m_Evaluator(evaluator),
+          m_FeatureOwners(featureOwners),
+          m_Moves(moves),
+          m_Deltas(deltas),
+          m_Cells(cells)
+        {}
+
+        virtual ~EvaluateMovesImpl() {}
+
+        void evaluate(size_t start, size_t end) const
+        {
+          for (size_t i = start; i < end; i++)
+          {
+            m_Deltas[i] = m_Evaluator->moveDelta(*m_FeatureOwners, m_Moves[i], m_Cells[i]);
+          }
+        }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+        void operator()(const tbb::blocked_range<size_t>& r) const
+        {
+          evaluate(r.begin(), r.end());
+        }
+#endif
+    };
+
+    PackingMoveEvaluator(const PackingMoveEvaluator&); // Copy Constructor Not Implemented
+    void operator=(const PackingMoveEvaluator&); // Operator '=' Not Implemented
+};
+
+#endif /* _packingmoveevaluator_hpp_ */
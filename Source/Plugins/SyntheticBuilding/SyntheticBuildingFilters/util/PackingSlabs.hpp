@@ -0,0 +1,320 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#ifndef _packingslabs_hpp_
+#define _packingslabs_hpp_
+
+#include <algorithm>
+#include <vector>
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
+#include "SIMPLib/SIMPLib.h"
+
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PeriodicBox.hpp"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/ShapeRunKernel.hpp"
+
+/**
+ * @class PackingSlabs PackingSlabs.hpp SyntheticBuilding/SyntheticBuildingFilters/util/PackingSlabs.hpp
+ * @brief Splits a volume into slabs of whole planes and buckets the Features by the slabs their bounding boxes
+ * overlap, in Feature Id order.
+ *
+ * The bounding box of a Feature is given as column, row and plane ranges that may extend one box length past either
+ * side of the volume when the boundaries are periodic; the planes past the volume count for the slabs they wrap to.
+ */
+class PackingSlabs
+{
+  public:
+    PackingSlabs() {}
+    virtual ~PackingSlabs() {}
+
+    /**
+     * @brief initialize Splits the planes into slabs and buckets the Features
+     * @param dims Dimensions of the volume
+     * @param numSlabs Number of slabs, at most the number of planes
+     * @param bounds Minimum and maximum column, row and plane of each Feature, 6 values per Feature
+     * @param firstFeature First Feature to bucket
+     * @param totalFeatures Number of Features
+     */
+    void initialize(const int64_t dims[3], int64_t numSlabs, const int64_t* bounds, int64_t firstFeature, int64_t totalFeatures)
+    {
+      numSlabs = std::max<int64_t>(1, std::min<int64_t>(dims[2], numSlabs));
+      m_SlabPlanes.assign(numSlabs + 1, 0);
+      std::vector<int64_t> planeSlabs(dims[2], 0);
+      for (int64_t slab = 0; slab < numSlabs; slab++)
+      {
+        m_SlabPlanes[slab] = (slab * dims[2]) / numSlabs;
+        m_SlabPlanes[slab + 1] = ((slab + 1) * dims[2]) / numSlabs;
+        for (int64_t p = m_SlabPlanes[slab]; p < m_SlabPlanes[slab + 1]; p++) { planeSlabs[p] = slab; }
+      }
+
+      m_SlabOffsets.assign(numSlabs + 1, 0);
+      m_SlabFeatures.clear();
+      std::vector<int64_t> lastFeature(numSlabs, -1);
+      // The first pass counts the Features of each slab and the second pass lists them in Feature Id order
+      for (int32_t pass = 0; pass < 2; pass++)
+      {
+        std::vector<int64_t> slabFill(m_SlabOffsets.begin(), m_SlabOffsets.end() - 1);
+        lastFeature.assign(numSlabs, -1);
+        for (int64_t i = firstFeature; i < totalFeatures; i++)
+        {
+          // A periodic Feature may extend one box length past either side of the volume
+          for (int64_t shift = -dims[2]; shift <= dims[2]; shift += dims[2])
+          {
+            int64_t zStart = std::max(bounds[6 * i + 4], shift);
+            int64_t zEnd = std::min(bounds[6 * i + 5] + 1, dims[2] + shift);
+            if (zStart >= zEnd) { continue; }
+            for (int64_t slab = planeSlabs[zStart - shift]; slab <= planeSlabs[zEnd - 1 - shift]; slab++)
+            {
+              if (lastFeature[slab] == i) { continue; }
+              lastFeature[slab] = i;
+              if (pass == 0) { m_SlabOffsets[slab + 1]++; }
+              else { m_SlabFeatures[slabFill[slab]++] = i; }
+            }
+          }
+        }
+        if (pass == 0)
+        {
+          for (int64_t slab = 0; slab < numSlabs; slab++) { m_SlabOffsets[slab + 1] += m_SlabOffsets[slab]; }
+          m_SlabFeatures.resize(m_SlabOffsets[numSlabs] + 1, 0);
+        }
+      }
+    }
+
+    int64_t getNumSlabs() const { return static_cast<int64_t>(m_SlabPlanes.size()) - 1; }
+
+    /**
+     * @brief getSlabPlanes Returns the first plane of each slab followed by the number of planes
+     */
+    const int64_t* getSlabPlanes() const { return &(m_SlabPlanes.front()); }
+
+    /**
+     * @brief getSlabOffsets Returns where the Features of each slab start in getSlabFeatures(), followed by the
+     * total number of entries
+     */
+    const int64_t* getSlabOffsets() const { return &(m_SlabOffsets.front()); }
+
+    const int64_t* getSlabFeatures() const { return &(m_SlabFeatures.front()); }
+
+  private:
+    std::vector<int64_t> m_SlabPlanes;
+    std::vector<int64_t> m_SlabOffsets;
+    std::vector<int64_t> m_SlabFeatures;
+
+    PackingSlabs(const PackingSlabs&); // Copy Constructor Not Implemented
+    void operator=(const PackingSlabs&); // Operator '=' Not Implemented
+};
+
+/**
+ * @class PackingSlabAssigner PackingSlabs.hpp SyntheticBuilding/SyntheticBuildingFilters/util/PackingSlabs.hpp
+ * @brief Assigns every voxel of a volume to the Feature with the largest shape function there, slab by slab.
+ *
+ * Each slab visits the Features bucketed for it in Feature Id order, so ties go to the lower Id. No two slabs write
+ * the same voxel and the result does not depend on the number of threads.
+ *
+ * The ShapeSource sets up the shape functions: ShapeSource::Ops is a set of shape functions private to one slab,
+ * createOps() makes one and setup(ops, feature) returns the shape function of a Feature, of type
+ * ShapeSource::ShapeOp, set up with its shape arguments.
+ */
+template<typename ShapeSource>
+class PackingSlabAssigner
+{
+  public:
+    /**
+     * @param dims Dimensions of the volume
+     * @param res Resolution of the volume
+     * @param slabs Slabs with their Features
+     * @param centers Centroid of each Feature
+     * @param invRadCur Inverse semi axis lengths of each Feature
+     * @param gA Rotation into the principal axis frame of each Feature, 9 values per Feature
+     * @param bounds Minimum and maximum column, row and plane of each Feature, 6 values per Feature
+     * @param shapes Source of the shape functions
+     * @param newowners Receives the owning Feature of each voxel; must be initialized to -1
+     * @param ellipfuncs Receives the shape function value of the owner of each voxel
+     */
+    PackingSlabAssigner(const int64_t dims[3], const float res[3], const PackingSlabs* slabs, const float* centers, const float* invRadCur,
+                        const float* gA, const int64_t* bounds, const ShapeSource* shapes, int32_t* newowners, float* ellipfuncs) :
+      m_Slabs(slabs),
+      m_Centers(centers),
+      m_InvRadCur(invRadCur),
+      m_GA(gA),
+      m_Bounds(bounds),
+      m_Shapes(shapes),
+      m_NewOwners(newowners),
+      m_EllipFuncs(ellipfuncs)
+    {
+      for (int32_t i = 0; i < 3; i++)
+      {
+        m_Dims[i] = dims[i];
+        m_Res[i] = res[i];
+      }
+    }
+
+    virtual ~PackingSlabAssigner() {}
+
+    /**
+     * @brief assign Assigns the voxels of a range of slabs, in parallel when doParallel is true and the parallel
+     * algorithms are available
+     */
+    void assign(int64_t slabStart, int64_t slabEnd, bool doParallel) const
+    {
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+      if (doParallel == true)
+      {
+        tbb::parallel_for(tbb::blocked_range<int64_t>(slabStart, slabEnd, 1), *this, tbb::auto_partitioner());
+        return;
+      }
+#else
+      (void)doParallel;
+#endif
+      convert(slabStart, slabEnd);
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void convert(int64_t slabStart, int64_t slabEnd) const
+    {
+      // The shape ops keep the parameters of the last Feature they were set up for, so each slab needs its own
+      typename ShapeSource::Ops ops = m_Shapes->createOps();
+      const int64_t* slabPlanes = m_Slabs->getSlabPlanes();
+      const int64_t* slabOffsets = m_Slabs->getSlabOffsets();
+      const int64_t* slabFeatures = m_Slabs->getSlabFeatures();
+
+      for (int64_t slab = slabStart; slab < slabEnd; slab++)
+      {
+        int64_t planeStart = slabPlanes[slab];
+        int64_t planeEnd = slabPlanes[slab + 1];
+        for (int64_t f = slabOffsets[slab]; f < slabOffsets[slab + 1]; f++)
+        {
+          int64_t i = slabFeatures[f];
+          const int64_t* bounds = m_Bounds + 6 * i;
+          typename ShapeSource::ShapeOp* shapeOp = NULL;
+          // A periodic Feature may extend one box length past either side of the volume
+          for (int64_t shift = -m_Dims[2]; shift <= m_Dims[2]; shift += m_Dims[2])
+          {
+            int64_t zStart = std::max(bounds[4], planeStart + shift);
+            int64_t zEnd = std::min(bounds[5] + 1, planeEnd + shift);
+            if (zStart >= zEnd) { continue; }
+            if (NULL == shapeOp)
+            {
+              shapeOp = m_Shapes->setup(ops, i);
+            }
+            assignFeature(i, shapeOp, zStart, zEnd);
+          }
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void assignFeature(int64_t curFeature, typename ShapeSource::ShapeOp* shapeOp, int64_t zStart, int64_t zEnd) const
+    {
+      int64_t index = 0;
+      float coords[3] = { 0.0f, 0.0f, 0.0f };
+      float inside = 0.0f;
+
+      const int64_t* bounds = m_Bounds + 6 * curFeature;
+      const float* center = m_Centers + 3 * curFeature;
+      const float* invRadCur = m_InvRadCur + 3 * curFeature;
+      float ga[3][3] =
+      {
+        { m_GA[9 * curFeature], m_GA[9 * curFeature + 1], m_GA[9 * curFeature + 2] },
+        { m_GA[9 * curFeature + 3], m_GA[9 * curFeature + 4], m_GA[9 * curFeature + 5] },
+        { m_GA[9 * curFeature + 6], m_GA[9 * curFeature + 7], m_GA[9 * curFeature + 8] }
+      };
+
+      // The shape function is evaluated a whole run of columns at a time
+      ShapeRunKernel kernel(ga, invRadCur);
+      size_t rowLength = static_cast<size_t>(bounds[1] - bounds[0] + 1);
+      std::vector<float> columnCoords(rowLength, 0.0f);
+      std::vector<float> runInside(rowLength, 0.0f);
+      for (size_t i = 0; i < rowLength; i++)
+      {
+        columnCoords[i] = float(bounds[0] + int64_t(i)) * m_Res[0] - center[0];
+      }
+
+      // Without periodic boundaries the bounds were already clipped to the volume, so they never wrap
+      const int64_t slabBounds[6] = { bounds[0], bounds[1], bounds[2], bounds[3], zStart, zEnd - 1 };
+      PeriodicBox box(m_Dims, true, slabBounds);
+      PeriodicBox::Run_t run;
+      while (box.next(run) == true)
+      {
+        coords[1] = float(run.m_Row) * m_Res[1] - center[1];
+        coords[2] = float(run.m_Plane) * m_Res[2] - center[2];
+        kernel.setRun(0, coords);
+        kernel.evaluate(shapeOp, &(columnCoords[run.m_Column - bounds[0]]), static_cast<size_t>(run.m_Count), &(runInside.front()));
+
+        index = run.m_Index;
+        for (int64_t i = 0; i < run.m_Count; i++, index++)
+        {
+          inside = runInside[i];
+          if (inside >= 0 && (m_NewOwners[index] == -1 || inside > m_EllipFuncs[index]))
+          {
+            m_NewOwners[index] = static_cast<int32_t>(curFeature);
+            m_EllipFuncs[index] = inside;
+          }
+        }
+      }
+    }
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+    void operator()(const tbb::blocked_range<int64_t>& r) const
+    {
+      convert(r.begin(), r.end());
+    }
+#endif
+
+  private:
+    int64_t m_Dims[3];
+    float m_Res[3];
+    const PackingSlabs* m_Slabs;
+    const float* m_Centers;
+    const float* m_InvRadCur;
+    const float* m_GA;
+    const int64_t* m_Bounds;
+    const ShapeSource* m_Shapes;
+    int32_t* m_NewOwners;
+    float* m_EllipFuncs;
+};
+
+#endif /* _packingslabs_hpp_ */
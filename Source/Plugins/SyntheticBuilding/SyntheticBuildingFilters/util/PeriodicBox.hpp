@@ -0,0 +1,191 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#ifndef _periodicbox_hpp_
+#define _periodicbox_hpp_
+
+#include <algorithm>
+
+#include "SIMPLib/SIMPLib.h"
+
+/**
+ * @class PeriodicBox PeriodicBox.hpp SyntheticBuilding/SyntheticBuildingFilters/util/PeriodicBox.hpp
+ * @brief Walks the bounding box of a Feature as contiguous runs along the x axis of a grid.
+ *
+ * The box is given in unwrapped coordinates. With periodic boundaries every coordinate is wrapped by at most one
+ * period, so each axis of the box is split into at most three ranges that are contiguous on the grid; points that
+ * are still outside of the grid after one wrap are dropped. Without periodic boundaries the box is clipped to the
+ * grid. Either way the runs are found once per row instead of wrapping every voxel.
+ */
+class PeriodicBox
+{
+  public:
+    /**
+     * @brief A range of m_Count unwrapped coordinates starting at m_Start; m_Start + m_Wrap is the first grid coordinate
+     */
+    typedef struct
+    {
+      int64_t m_Start;
+      int64_t m_Count;
+      int64_t m_Wrap;
+    } Range_t;
+
+    /**
+     * @brief A run of m_Count consecutive grid points starting at grid index m_Index. m_Column, m_Row and m_Plane are
+     * the unwrapped coordinates of the first point of the run
+     */
+    typedef struct
+    {
+      int64_t m_Index;
+      int64_t m_Count;
+      int64_t m_Column;
+      int64_t m_Row;
+      int64_t m_Plane;
+    } Run_t;
+
+    /**
+     * @brief PeriodicBox
+     * @param dims Dimensions of the grid
+     * @param periodic Whether the grid is periodic
+     * @param bounds Inclusive unwrapped bounds of the box as xmin, xmax, ymin, ymax, zmin, zmax
+     */
+    PeriodicBox(const int64_t dims[3], bool periodic, const int64_t bounds[6])
+    {
+      for (int32_t i = 0; i < 3; i++)
+      {
+        m_Dims[i] = dims[i];
+        m_NumRanges[i] = SplitRange(bounds[2 * i], bounds[2 * i + 1] + 1, dims[i], periodic, m_Ranges[i]);
+      }
+      reset();
+    }
+
+    virtual ~PeriodicBox() {}
+
+    /**
+     * @brief SplitRange Splits the unwrapped range [start, end) of one axis into the ranges that are contiguous on the grid
+     * @param start First unwrapped coordinate
+     * @param end One past the last unwrapped coordinate
+     * @param dim Number of grid points along the axis
+     * @param periodic Whether the axis is periodic
+     * @param ranges Filled with up to 3 ranges, in the order of the coordinates
+     * @return Number of ranges
+     */
+    static int32_t SplitRange(int64_t start, int64_t end, int64_t dim, bool periodic, Range_t ranges[3])
+    {
+      // [-dim, 0) wraps up by one period, [0, dim) is in place and [dim, 2 * dim) wraps down by one period
+      int64_t low[3] = { -dim, 0, dim };
+      int64_t high[3] = { 0, dim, 2 * dim };
+      int64_t wrap[3] = { dim, 0, -dim };
+      int32_t numRanges = 0;
+      for (int32_t s = 0; s < 3; s++)
+      {
+        if (periodic == false && s != 1) { continue; }
+        int64_t first = std::max(start, low[s]);
+        int64_t last = std::min(end, high[s]);
+        if (first >= last) { continue; }
+        ranges[numRanges].m_Start = first;
+        ranges[numRanges].m_Count = last - first;
+        ranges[numRanges].m_Wrap = wrap[s];
+        numRanges++;
+      }
+      return numRanges;
+    }
+
+    /**
+     * @brief reset Starts the walk over from the first run
+     */
+    void reset()
+    {
+      m_XRange = m_YRange = m_ZRange = 0;
+      m_Row = (m_NumRanges[1] > 0) ? m_Ranges[1][0].m_Start : 0;
+      m_Plane = (m_NumRanges[2] > 0) ? m_Ranges[2][0].m_Start : 0;
+      // a box that misses the grid along any axis has no runs at all
+      if (m_NumRanges[0] == 0 || m_NumRanges[1] == 0) { m_ZRange = m_NumRanges[2]; }
+    }
+
+    /**
+     * @brief next Returns the next run; the runs go through the box plane by plane and row by row
+     * @param run Filled with the run
+     * @return false once every run has been returned
+     */
+    bool next(Run_t& run)
+    {
+      if (m_ZRange >= m_NumRanges[2]) { return false; }
+
+      const Range_t& x = m_Ranges[0][m_XRange];
+      const Range_t& y = m_Ranges[1][m_YRange];
+      const Range_t& z = m_Ranges[2][m_ZRange];
+      run.m_Index = (m_Dims[0] * m_Dims[1] * (m_Plane + z.m_Wrap)) + (m_Dims[0] * (m_Row + y.m_Wrap)) + x.m_Start + x.m_Wrap;
+      run.m_Count = x.m_Count;
+      run.m_Column = x.m_Start;
+      run.m_Row = m_Row;
+      run.m_Plane = m_Plane;
+
+      // step to the next x range, then row, then plane
+      m_XRange++;
+      if (m_XRange < m_NumRanges[0]) { return true; }
+      m_XRange = 0;
+      m_Row++;
+      if (m_Row < y.m_Start + y.m_Count) { return true; }
+      m_YRange++;
+      if (m_YRange < m_NumRanges[1])
+      {
+        m_Row = m_Ranges[1][m_YRange].m_Start;
+        return true;
+      }
+      m_YRange = 0;
+      m_Row = m_Ranges[1][0].m_Start;
+      m_Plane++;
+      if (m_Plane < z.m_Start + z.m_Count) { return true; }
+      m_ZRange++;
+      if (m_ZRange < m_NumRanges[2]) { m_Plane = m_Ranges[2][m_ZRange].m_Start; }
+      return true;
+    }
+
+  private:
+    int64_t m_Dims[3];
+    Range_t m_Ranges[3][3];
+    int32_t m_NumRanges[3];
+    int32_t m_XRange;
+    int32_t m_YRange;
+    int32_t m_ZRange;
+    int64_t m_Row;
+    int64_t m_Plane;
+
+    PeriodicBox(const PeriodicBox&); // Copy Constructor Not Implemented
+    void operator=(const PeriodicBox&); // Operator '=' Not Implemented
+};
+
+#endif /* _periodicbox_hpp_ */
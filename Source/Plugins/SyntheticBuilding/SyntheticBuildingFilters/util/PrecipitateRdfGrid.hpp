@@ -0,0 +1,248 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+
+#ifndef _precipitaterdfgrid_hpp_
+#define _precipitaterdfgrid_hpp_
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "SIMPLib/SIMPLib.h"
+
+/**
+ * @class PrecipitateRdfGrid PrecipitateRdfGrid.hpp SyntheticBuilding/SyntheticBuildingFilters/util/PrecipitateRdfGrid.hpp
+ * @brief Uniform grid of cells over the precipitate centroids that InsertPrecipitatePhases keeps its RDF with.
+ *
+ * Only the RDF bins below the cutoff are compared against the target, so the cells are made at least as large as
+ * the cutoff and the pairs of a precipitate are all in the 27 cells around it. The grid has at most
+ * max(27, 4 * number of precipitates) cells, so a large box with a short cutoff does not spend its time walking
+ * empty cells. A precipitate is moved to the cell of its current centroid whenever its pairs are counted.
+ */
+class PrecipitateRdfGrid
+{
+  public:
+    PrecipitateRdfGrid() :
+      m_RdfMin(0.0f),
+      m_StepSize(0.0f),
+      m_NumBins(0)
+    {
+      clear();
+    }
+
+    virtual ~PrecipitateRdfGrid() {}
+
+    /**
+     * @brief clear Releases the cells
+     */
+    void clear()
+    {
+      for (int32_t i = 0; i < 3; i++)
+      {
+        m_CellSize[i] = 0.0f;
+        m_CellDims[i] = 0;
+      }
+      m_Cells.clear();
+      m_FeatureCell.clear();
+    }
+
+    /**
+     * @brief initialize Sets up the RDF bins and the cells and bins the precipitate centroids
+     * @param centroids Centroids of all Features, 3 values per Feature
+     * @param firstFeature First precipitate Feature
+     * @param numFeatures Number of Features
+     * @param size Size of the box along x, y and z
+     * @param rdfMin Smallest distance of the RDF bins
+     * @param rdfMax Largest distance of the RDF bins, which is the cutoff
+     * @param stepSize Width of an RDF bin
+     * @param numBins Number of RDF bins
+     */
+    void initialize(const float* centroids, size_t firstFeature, size_t numFeatures, const float size[3], float rdfMin, float rdfMax, float stepSize, int32_t numBins)
+    {
+      m_RdfMin = rdfMin;
+      m_StepSize = stepSize;
+      m_NumBins = numBins;
+
+      // the cells are made slightly larger than the cutoff so that rounding in the bin computation can not miss a pair
+      float cutoff = rdfMax * 1.001f;
+      for (int32_t i = 0; i < 3; i++)
+      {
+        m_CellDims[i] = 1;
+        if (cutoff > 0.0f && size[i] > cutoff)
+        {
+          m_CellDims[i] = static_cast<int64_t>(size[i] / cutoff);
+        }
+      }
+      int64_t maxCells = std::max<int64_t>(27, 4 * static_cast<int64_t>(numFeatures - firstFeature));
+      while (m_CellDims[0] * m_CellDims[1] * m_CellDims[2] > maxCells)
+      {
+        int32_t largest = 0;
+        if (m_CellDims[1] > m_CellDims[largest]) { largest = 1; }
+        if (m_CellDims[2] > m_CellDims[largest]) { largest = 2; }
+        m_CellDims[largest] = (m_CellDims[largest] + 1) / 2;
+      }
+      for (int32_t i = 0; i < 3; i++)
+      {
+        m_CellSize[i] = size[i] / static_cast<float>(m_CellDims[i]);
+      }
+
+      m_Cells.clear();
+      m_Cells.resize(m_CellDims[0] * m_CellDims[1] * m_CellDims[2]);
+      m_FeatureCell.assign(numFeatures, -1);
+      for (size_t i = firstFeature; i < numFeatures; i++)
+      {
+        update(centroids, static_cast<int32_t>(i));
+      }
+    }
+
+    /**
+     * @brief getCellDims Returns the number of cells along x, y and z
+     */
+    void getCellDims(int64_t dims[3]) const
+    {
+      for (int32_t i = 0; i < 3; i++) { dims[i] = m_CellDims[i]; }
+    }
+
+    /**
+     * @brief update Moves a precipitate to the cell that contains its current centroid. Centroids outside the box
+     * go to the nearest cell, which only moves them away from the cells they can not pair with.
+     * @param centroids Centroids of all Features
+     * @param feature Precipitate to move
+     */
+    void update(const float* centroids, int32_t feature)
+    {
+      int64_t cell[3] = { 0, 0, 0 };
+      for (int32_t i = 0; i < 3; i++)
+      {
+        cell[i] = static_cast<int64_t>(centroids[3 * feature + i] / m_CellSize[i]);
+        if (cell[i] < 0) { cell[i] = 0; }
+        if (cell[i] >= m_CellDims[i]) { cell[i] = m_CellDims[i] - 1; }
+      }
+      int64_t newCell = (cell[2] * m_CellDims[1] + cell[1]) * m_CellDims[0] + cell[0];
+      int64_t oldCell = m_FeatureCell[feature];
+      if (newCell == oldCell)
+      {
+        return;
+      }
+      if (oldCell >= 0)
+      {
+        std::vector<int32_t>& members = m_Cells[oldCell];
+        std::vector<int32_t>::iterator iter = std::find(members.begin(), members.end(), feature);
+        *iter = members.back();
+        members.pop_back();
+      }
+      m_Cells[newCell].push_back(feature);
+      m_FeatureCell[feature] = newCell;
+    }
+
+    /**
+     * @brief accumulate Adds an increment to the RDF bin of the distance between a precipitate and every other
+     * precipitate of its phase within the cutoff. Bin 0 of the RDF holds the distances below rdfMin.
+     * @param centroids Centroids of all Features
+     * @param phases Phase of each Feature
+     * @param feature Precipitate to count the pairs of
+     * @param increment Amount to add to the bins
+     * @param rdf RDF to update
+     * @return One more than the number of pairs counted
+     */
+    int32_t accumulate(const float* centroids, const int32_t* phases, int32_t feature, int32_t increment, std::vector<float>& rdf)
+    {
+      // The precipitate may have been moved since it was last binned
+      update(centroids, feature);
+
+      int32_t numPPTfeatures = 1;
+      int32_t phase = phases[feature];
+      float x = centroids[3 * feature];
+      float y = centroids[3 * feature + 1];
+      float z = centroids[3 * feature + 2];
+
+      int64_t cell = m_FeatureCell[feature];
+      int64_t cx = cell % m_CellDims[0];
+      int64_t cy = (cell / m_CellDims[0]) % m_CellDims[1];
+      int64_t cz = cell / (m_CellDims[0] * m_CellDims[1]);
+
+      // Every precipitate within the cutoff is in one of the 27 cells around this one
+      for (int64_t k = std::max<int64_t>(cz - 1, 0); k <= std::min<int64_t>(cz + 1, m_CellDims[2] - 1); k++)
+      {
+        for (int64_t j = std::max<int64_t>(cy - 1, 0); j <= std::min<int64_t>(cy + 1, m_CellDims[1] - 1); j++)
+        {
+          for (int64_t i = std::max<int64_t>(cx - 1, 0); i <= std::min<int64_t>(cx + 1, m_CellDims[0] - 1); i++)
+          {
+            const std::vector<int32_t>& members = m_Cells[(k * m_CellDims[1] + j) * m_CellDims[0] + i];
+            for (size_t m = 0; m < members.size(); m++)
+            {
+              int32_t n = members[m];
+              if (phases[n] != phase || n == feature)
+              {
+                continue;
+              }
+              float xn = centroids[3 * n];
+              float yn = centroids[3 * n + 1];
+              float zn = centroids[3 * n + 2];
+              float r = sqrtf((x - xn) * (x - xn) + (y - yn) * (y - yn) + (z - zn) * (z - zn));
+
+              int32_t rdfBin = (r - m_RdfMin) / m_StepSize;
+              if (r < m_RdfMin) { rdfBin = -1; }
+              // Distances past the target RDF are never compared, and are not all visited by the cell search
+              if (rdfBin >= m_NumBins || rdfBin + 1 >= static_cast<int32_t>(rdf.size()))
+              {
+                continue;
+              }
+              rdf[rdfBin + 1] += increment;
+
+              numPPTfeatures += 1;
+            }
+          }
+        }
+      }
+      return numPPTfeatures;
+    }
+
+  private:
+    float m_RdfMin;
+    float m_StepSize;
+    int32_t m_NumBins;
+    float m_CellSize[3];
+    int64_t m_CellDims[3];
+    std::vector<std::vector<int32_t> > m_Cells;
+    std::vector<int64_t> m_FeatureCell;
+
+    PrecipitateRdfGrid(const PrecipitateRdfGrid&); // Copy Constructor Not Implemented
+    void operator=(const PrecipitateRdfGrid&); // Operator '=' Not Implemented
+};
+
+#endif /* _precipitaterdfgrid_hpp_ */
@@ -0,0 +1,195 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#ifndef _shaperunkernel_hpp_
+#define _shaperunkernel_hpp_
+
+#include <cmath>
+#include <vector>
+
+#include "SIMPLib/SIMPLib.h"
+
+/**
+ * @class ShapeRunKernel ShapeRunKernel.hpp SyntheticBuilding/SyntheticBuildingFilters/util/ShapeRunKernel.hpp
+ * @brief Evaluates the shape function of one Feature for a run of grid points along one axis.
+ *
+ * The rotation into the principal axis frame and the inverse semi axis lengths are set up once per Feature, and the
+ * products with the two coordinates that are fixed along a run are set up once per run, so each point of the run only
+ * needs one multiply-add per axis in loops the compiler can vectorize. The products are summed in the same order as
+ * when each point is rotated with MatrixMath::Multiply3x3with3x1.
+ *
+ * All shape classes are bounded by the unit cube in the principal axis frame, so the shape function is only called
+ * for points with all three components in [-1, 1]; every other point gets the value -1.
+ */
+class ShapeRunKernel
+{
+  public:
+    /**
+     * @param ga Rotation from the sample frame into the principal axis frame of the Feature
+     * @param oneOverRadii Inverse semi axis lengths of the Feature
+     */
+    ShapeRunKernel(const float ga[3][3], const float oneOverRadii[3]) :
+      m_RunAxis(0)
+    {
+      for (int32_t i = 0; i < 3; i++)
+      {
+        m_OneOverRadii[i] = oneOverRadii[i];
+        m_Fixed[i] = 0.0f;
+        m_FixedA[i] = 0.0f;
+        m_FixedB[i] = 0.0f;
+        for (int32_t j = 0; j < 3; j++)
+        {
+          m_GA[i][j] = ga[i][j];
+        }
+      }
+    }
+
+    virtual ~ShapeRunKernel() {}
+
+    /**
+     * @brief setRun Starts a run along runAxis; coords holds the coordinates relative to the Feature center, the
+     * entry for runAxis is ignored
+     */
+    void setRun(int32_t runAxis, const float coords[3])
+    {
+      m_RunAxis = runAxis;
+      for (int32_t k = 0; k < 3; k++)
+      {
+        // Keep the summation order of the full matrix vector product
+        if (runAxis == 0)
+        {
+          m_FixedA[k] = m_GA[k][1] * coords[1];
+          m_FixedB[k] = m_GA[k][2] * coords[2];
+        }
+        else if (runAxis == 1)
+        {
+          m_FixedA[k] = m_GA[k][0] * coords[0];
+          m_FixedB[k] = m_GA[k][2] * coords[2];
+        }
+        else
+        {
+          m_Fixed[k] = m_GA[k][0] * coords[0] + m_GA[k][1] * coords[1];
+        }
+      }
+    }
+
+    /**
+     * @brief transform Computes the principal axis components of count points of the current run
+     * @param runCoords Coordinates along the run axis relative to the Feature center
+     */
+    void transform(const float* runCoords, size_t count)
+    {
+      m_Axis1.resize(count);
+      m_Axis2.resize(count);
+      m_Axis3.resize(count);
+      transformAxis(0, runCoords, count, &(m_Axis1.front()));
+      transformAxis(1, runCoords, count, &(m_Axis2.front()));
+      transformAxis(2, runCoords, count, &(m_Axis3.front()));
+    }
+
+    /**
+     * @brief evaluate Computes the shape function of count points of the current run
+     * @param shapeOp Shape function of the Feature, already set up with its shape arguments
+     * @param runCoords Coordinates along the run axis relative to the Feature center
+     * @param inside Receives the shape function values; values >= 0 are inside the Feature
+     */
+    template<typename ShapeOpType>
+    void evaluate(ShapeOpType* shapeOp, const float* runCoords, size_t count, float* inside)
+    {
+      if (count == 0) { return; }
+      transform(runCoords, count);
+      const float* axis1 = &(m_Axis1.front());
+      const float* axis2 = &(m_Axis2.front());
+      const float* axis3 = &(m_Axis3.front());
+      for (size_t i = 0; i < count; i++)
+      {
+        inside[i] = -1.0f;
+        if (std::fabs(axis1[i]) <= 1.0f && std::fabs(axis2[i]) <= 1.0f && std::fabs(axis3[i]) <= 1.0f)
+        {
+          inside[i] = shapeOp->inside(axis1[i], axis2[i], axis3[i]);
+        }
+      }
+    }
+
+    const std::vector<float>& getAxis1() const { return m_Axis1; }
+    const std::vector<float>& getAxis2() const { return m_Axis2; }
+    const std::vector<float>& getAxis3() const { return m_Axis3; }
+
+  private:
+    float m_GA[3][3];
+    float m_OneOverRadii[3];
+    int32_t m_RunAxis;
+    float m_Fixed[3];
+    float m_FixedA[3];
+    float m_FixedB[3];
+    std::vector<float> m_Axis1;
+    std::vector<float> m_Axis2;
+    std::vector<float> m_Axis3;
+
+    void transformAxis(int32_t k, const float* runCoords, size_t count, float* axis) const
+    {
+      const float g0 = m_GA[k][0];
+      const float g1 = m_GA[k][1];
+      const float g2 = m_GA[k][2];
+      const float fixed = m_Fixed[k];
+      const float fixedA = m_FixedA[k];
+      const float fixedB = m_FixedB[k];
+      const float scale = m_OneOverRadii[k];
+      if (m_RunAxis == 0)
+      {
+        for (size_t i = 0; i < count; i++)
+        {
+          axis[i] = ((g0 * runCoords[i] + fixedA) + fixedB) * scale;
+        }
+      }
+      else if (m_RunAxis == 1)
+      {
+        for (size_t i = 0; i < count; i++)
+        {
+          axis[i] = ((fixedA + g1 * runCoords[i]) + fixedB) * scale;
+        }
+      }
+      else
+      {
+        for (size_t i = 0; i < count; i++)
+        {
+          axis[i] = (fixed + g2 * runCoords[i]) * scale;
+        }
+      }
+    }
+};
+
+#endif /* _shaperunkernel_hpp_ */
@@ -0,0 +1,281 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#ifndef _syntheticbuildingrandom_hpp_
+#define _syntheticbuildingrandom_hpp_
+
+#include <cmath>
+
+#include <QtCore/QDateTime>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/Math/SIMPLibMath.h"
+
+/**
+ * @class SyntheticBuildingRandom SyntheticBuildingRandom.hpp SyntheticBuilding/SyntheticBuildingFilters/util/SyntheticBuildingRandom.hpp
+ * @brief A counter based random number stream (Philox4x32-10, Salmon et al. "Parallel Random Numbers: As Easy as 1, 2, 3", SC11).
+ *
+ * Every value of the stream is a pure function of (seed, stream, feature, iteration, draw index), so the numbers used
+ * for one feature do not depend on how many numbers were drawn for any other feature or on the order in which the
+ * features are processed. This lets the synthetic building filters generate features, or visit voxels, in parallel
+ * and still produce bit identical results for a given seed. The sampling methods have the same names as SIMPLibRandom
+ * so a stream can be dropped in where a SIMPLibRandom was used.
+ */
+class SyntheticBuildingRandom
+{
+  public:
+    /**
+     * @brief The Stream enum separates the streams used by the different filters (and by different stages of one filter)
+     * so that they never overlap even when they are given the same seed and feature id.
+     */
+    enum Stream
+    {
+      PackPrimaryPhasesEstimate = 0x0100,
+      PackPrimaryPhasesFeatures = 0x0101,
+      PackPrimaryPhasesPlacement = 0x0102,
+      InsertPrecipitatePhasesFeatures = 0x0201,
+      InsertPrecipitatePhasesPlacement = 0x0202,
+      MatchCrystallographyInitial = 0x0301,
+      MatchCrystallographySwaps = 0x0302,
+      JumbleOrientationsShuffle = 0x0401
+    };
+
+    /**
+     * @brief SyntheticBuildingRandom Creates the stream for the given key.
+     * @param seed The user (or clock) seed of the filter run
+     * @param stream Which filter/stage the numbers are for
+     * @param featureId The feature the numbers are for (0 for streams that are not per feature)
+     * @param iteration The attempt/iteration for that feature
+     */
+    SyntheticBuildingRandom(uint64_t seed, Stream stream, uint32_t featureId = 0, uint32_t iteration = 0) :
+      m_Index(4),
+      m_HaveNormal(false),
+      m_Normal(0.0)
+    {
+      m_Key[0] = static_cast<uint32_t>(seed);
+      m_Key[1] = static_cast<uint32_t>(seed >> 32);
+      m_Counter[0] = 0;
+      m_Counter[1] = iteration;
+      m_Counter[2] = featureId;
+      m_Counter[3] = static_cast<uint32_t>(stream);
+    }
+
+    virtual ~SyntheticBuildingRandom() {}
+
+    /**
+     * @brief ResolveSeed Returns the seed a filter should use: the user value when a fixed seed was requested and
+     * the current time otherwise.
+     */
+    static uint64_t ResolveSeed(bool useFixedSeed, int32_t fixedSeed)
+    {
+      if (useFixedSeed == true)
+      {
+        return static_cast<uint64_t>(static_cast<uint32_t>(fixedSeed));
+      }
+      return static_cast<uint64_t>(QDateTime::currentMSecsSinceEpoch());
+    }
+
+    /**
+     * @brief Philox4x32 Applies the 10 round Philox bijection to a counter with the given key.
+     */
+    static void Philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4])
+    {
+      const uint64_t k_M0 = 0xD2511F53;
+      const uint64_t k_M1 = 0xCD9E8D57;
+      uint32_t c[4] = { counter[0], counter[1], counter[2], counter[3] };
+      uint32_t k[2] = { key[0], key[1] };
+      for (int32_t round = 0; round < 10; round++)
+      {
+        uint64_t p0 = k_M0 * c[0];
+        uint64_t p1 = k_M1 * c[2];
+        uint32_t hi0 = static_cast<uint32_t>(p0 >> 32);
+        uint32_t lo0 = static_cast<uint32_t>(p0);
+        uint32_t hi1 = static_cast<uint32_t>(p1 >> 32);
+        uint32_t lo1 = static_cast<uint32_t>(p1);
+        c[0] = hi1 ^ c[1] ^ k[0];
+        c[1] = lo1;
+        c[2] = hi0 ^ c[3] ^ k[1];
+        c[3] = lo0;
+        k[0] += 0x9E3779B9;
+        k[1] += 0xBB67AE85;
+      }
+      out[0] = c[0];
+      out[1] = c[1];
+      out[2] = c[2];
+      out[3] = c[3];
+    }
+
+    /**
+     * @brief genrand_int32 Returns the next uniformly distributed 32 bit integer of the stream
+     */
+    uint32_t genrand_int32()
+    {
+      if (m_Index == 4)
+      {
+        Philox4x32(m_Counter, m_Key, m_Block);
+        m_Counter[0]++;
+        m_Index = 0;
+      }
+      return m_Block[m_Index++];
+    }
+
+    /**
+     * @brief genrand_int64 Returns the next uniformly distributed 64 bit integer. This is what should be handed to
+     * code that wants its own seed (e.g. SpaceGroupOps::determineEulerAngles)
+     */
+    uint64_t genrand_int64()
+    {
+      uint64_t hi = genrand_int32();
+      return (hi << 32) | genrand_int32();
+    }
+
+    /**
+     * @brief genrand_res53 Returns a uniformly distributed double on [0,1) with 53 bit resolution
+     */
+    double genrand_res53()
+    {
+      uint32_t a = genrand_int32() >> 5;
+      uint32_t b = genrand_int32() >> 6;
+      return (a * 67108864.0 + b) * (1.0 / 9007199254740992.0);
+    }
+
+    /**
+     * @brief genrand_norm Returns a normally distributed value (Box-Muller)
+     */
+    double genrand_norm(double mean, double stdDev)
+    {
+      if (m_HaveNormal == true)
+      {
+        m_HaveNormal = false;
+        return mean + stdDev * m_Normal;
+      }
+      double u1 = 1.0 - genrand_res53(); // (0,1]
+      double u2 = genrand_res53();
+      double r = sqrt(-2.0 * log(u1));
+      double theta = SIMPLib::Constants::k_2Pi * u2;
+      m_Normal = r * sin(theta);
+      m_HaveNormal = true;
+      return mean + stdDev * r * cos(theta);
+    }
+
+    /**
+     * @brief genrand_gamma Returns a Gamma(shape, 1) distributed value (Marsaglia & Tsang)
+     */
+    double genrand_gamma(double shape)
+    {
+      if (shape <= 0.0)
+      {
+        return 0.0;
+      }
+      if (shape < 1.0)
+      {
+        double u = 1.0 - genrand_res53();
+        return genrand_gamma(shape + 1.0) * pow(u, 1.0 / shape);
+      }
+      double d = shape - 1.0 / 3.0;
+      double c = 1.0 / sqrt(9.0 * d);
+      while (true)
+      {
+        double x = 0.0;
+        double v = 0.0;
+        do
+        {
+          x = genrand_norm(0.0, 1.0);
+          v = 1.0 + c * x;
+        }
+        while (v <= 0.0);
+        v = v * v * v;
+        double u = 1.0 - genrand_res53();
+        if (u < 1.0 - 0.0331 * (x * x) * (x * x)) { return d * v; }
+        if (log(u) < 0.5 * x * x + d * (1.0 - v + log(v))) { return d * v; }
+      }
+    }
+
+    /**
+     * @brief genrand_beta Returns a Beta(a, b) distributed value. A shape parameter that is not positive puts all
+     * of the mass at the corresponding end of [0,1].
+     */
+    double genrand_beta(double a, double b)
+    {
+      if (a <= 0.0) { return 0.0; }
+      if (b <= 0.0) { return 1.0; }
+      double x = genrand_gamma(a);
+      double y = genrand_gamma(b);
+      if (x + y <= 0.0) { return (a >= b) ? 1.0 : 0.0; }
+      return x / (x + y);
+    }
+
+    /**
+     * @brief getState Returns the position of the stream, i.e. the number of 32 bit values drawn so far, and the
+     * cached second normal deviate. Together with the seed, stream, Feature Id and iteration this is the whole state.
+     */
+    void getState(uint64_t& position, bool& haveNormal, double& normal) const
+    {
+      position = (static_cast<uint64_t>(m_Counter[0]) * 4) - 4 + static_cast<uint64_t>(m_Index);
+      haveNormal = m_HaveNormal;
+      normal = m_Normal;
+    }
+
+    /**
+     * @brief setState Moves the stream to a state returned by getState
+     */
+    void setState(uint64_t position, bool haveNormal, double normal)
+    {
+      m_Counter[0] = static_cast<uint32_t>(position / 4);
+      m_Index = static_cast<int32_t>(position % 4);
+      if (m_Index == 0)
+      {
+        m_Index = 4;
+      }
+      else
+      {
+        Philox4x32(m_Counter, m_Key, m_Block);
+        m_Counter[0]++;
+      }
+      m_HaveNormal = haveNormal;
+      m_Normal = normal;
+    }
+
+  private:
+    uint32_t m_Key[2];
+    uint32_t m_Counter[4];
+    uint32_t m_Block[4];
+    int32_t m_Index;
+    bool m_HaveNormal;
+    double m_Normal;
+};
+
+#endif /* _syntheticbuildingrandom_hpp_ */
@@ -0,0 +1,292 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/Common/SIMPLibSetGetMacros.h"
+#include "SIMPLib/Common/FilterManager.h"
+#include "SIMPLib/Common/FilterFactory.hpp"
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataArrays/StatsDataArray.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+#include "SIMPLib/StatsData/PrecipitateStatsData.h"
+#include "SIMPLib/Utilities/UnitTestSupport.hpp"
+#include "SIMPLib/Utilities/QMetaObjectUtilities.h"
+
+#include "SyntheticBuildingTestFileLocations.h"
+
+class InsertPrecipitatePhasesTest
+{
+  public:
+    InsertPrecipitatePhasesTest(){}
+    virtual ~InsertPrecipitatePhasesTest(){}
+    SIMPL_TYPE_MACRO(InsertPrecipitatePhasesTest)
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void RemoveTestFiles()
+    {
+#if REMOVE_TEST_FILES
+      QFile::remove(UnitTest::InsertPrecipitatePhasesTest::CheckpointFile);
+#endif
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int TestFilterAvailability()
+    {
+      // Now instantiate the InsertPrecipitatePhases Filter from the FilterManager
+      QString filtName = "InsertPrecipitatePhases";
+      FilterManager* fm = FilterManager::Instance();
+      IFilterFactory::Pointer filterFactory = fm->getFactoryForFilter(filtName);
+      if (NULL == filterFactory.get() )
+      {
+        std::stringstream ss;
+        ss << "The InsertPrecipitatePhasesTest Requires the use of the " << filtName.toStdString() << " filter which is found in the SyntheticBuilding Plugin";
+        DREAM3D_TEST_THROW_EXCEPTION(ss.str())
+      }
+      return 0;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Builds a single primary Feature filling a 24^3 volume together with the
+    // statistics of one precipitate phase
+    // -----------------------------------------------------------------------------
+    DataContainerArray::Pointer CreateDataContainerArray()
+    {
+      DataContainerArray::Pointer dca = DataContainerArray::New();
+      DataContainer::Pointer m = DataContainer::New(SIMPL::Defaults::SyntheticVolumeDataContainerName);
+      ImageGeom::Pointer image = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+      m->setGeometry(image);
+      size_t dims[3] = { 24, 24, 24 };
+      image->setDimensions(dims);
+      image->setResolution(1.0f, 1.0f, 1.0f);
+      dca->addDataContainer(m);
+
+      QVector<size_t> cDims(1, 1);
+      QVector<size_t> tDims(3, 24);
+      AttributeMatrix::Pointer cellAttrMat = AttributeMatrix::New(tDims, SIMPL::Defaults::CellAttributeMatrixName, SIMPL::AttributeMatrixType::Cell);
+      m->addAttributeMatrix(cellAttrMat->getName(), cellAttrMat);
+      Int32ArrayType::Pointer featureIds = Int32ArrayType::CreateArray(tDims, cDims, SIMPL::CellData::FeatureIds);
+      featureIds->initializeWithValue(1);
+      cellAttrMat->addAttributeArray(featureIds->getName(), featureIds);
+      Int32ArrayType::Pointer cellPhases = Int32ArrayType::CreateArray(tDims, cDims, SIMPL::CellData::Phases);
+      cellPhases->initializeWithValue(1);
+      cellAttrMat->addAttributeArray(cellPhases->getName(), cellPhases);
+      Int8ArrayType::Pointer boundaryCells = Int8ArrayType::CreateArray(tDims, cDims, SIMPL::CellData::BoundaryCells);
+      boundaryCells->initializeWithZeros();
+      cellAttrMat->addAttributeArray(boundaryCells->getName(), boundaryCells);
+
+      QVector<size_t> fDims(1, 2);
+      AttributeMatrix::Pointer featureAttrMat = AttributeMatrix::New(fDims, SIMPL::Defaults::CellFeatureAttributeMatrixName, SIMPL::AttributeMatrixType::CellFeature);
+      m->addAttributeMatrix(featureAttrMat->getName(), featureAttrMat);
+      Int32ArrayType::Pointer featurePhases = Int32ArrayType::CreateArray(fDims, cDims, SIMPL::FeatureData::Phases);
+      featurePhases->setValue(0, 0);
+      featurePhases->setValue(1, 1);
+      featureAttrMat->addAttributeArray(featurePhases->getName(), featurePhases);
+
+      QVector<size_t> eDims(1, 3);
+      AttributeMatrix::Pointer ensembleAttrMat = AttributeMatrix::New(eDims, SIMPL::Defaults::CellEnsembleAttributeMatrixName, SIMPL::AttributeMatrixType::CellEnsemble);
+      m->addAttributeMatrix(ensembleAttrMat->getName(), ensembleAttrMat);
+      UInt32ArrayType::Pointer phaseTypes = UInt32ArrayType::CreateArray(eDims, cDims, SIMPL::EnsembleData::PhaseTypes);
+      phaseTypes->setValue(0, SIMPL::PhaseType::UnknownPhaseType);
+      phaseTypes->setValue(1, SIMPL::PhaseType::PrimaryPhase);
+      phaseTypes->setValue(2, SIMPL::PhaseType::PrecipitatePhase);
+      ensembleAttrMat->addAttributeArray(phaseTypes->getName(), phaseTypes);
+      UInt32ArrayType::Pointer shapeTypes = UInt32ArrayType::CreateArray(eDims, cDims, SIMPL::EnsembleData::ShapeTypes);
+      shapeTypes->setValue(0, SIMPL::ShapeType::UnknownShapeType);
+      shapeTypes->setValue(1, SIMPL::ShapeType::EllipsoidShape);
+      shapeTypes->setValue(2, SIMPL::ShapeType::EllipsoidShape);
+      ensembleAttrMat->addAttributeArray(shapeTypes->getName(), shapeTypes);
+      Int32ArrayType::Pointer numFeatures = Int32ArrayType::CreateArray(eDims, cDims, SIMPL::EnsembleData::NumFeatures);
+      numFeatures->setValue(0, 0);
+      numFeatures->setValue(1, 1);
+      numFeatures->setValue(2, 0);
+      ensembleAttrMat->addAttributeArray(numFeatures->getName(), numFeatures);
+
+      StatsDataArray::Pointer statsDataArray = StatsDataArray::CreateArray(eDims[0], SIMPL::EnsembleData::Statistics);
+      statsDataArray->fillArrayWithNewStatsData(eDims[0], phaseTypes->getPointer(0));
+      ensembleAttrMat->addAttributeArray(statsDataArray->getName(), statsDataArray);
+
+      PrecipitateStatsData* pp = PrecipitateStatsData::SafePointerDownCast((*statsDataArray)[2].get());
+      DREAM3D_REQUIRE(NULL != pp)
+      pp->setPhaseFraction(0.04f);
+      pp->setPrecipBoundaryFraction(0.0f);
+      pp->setBinStepSize(0.5f);
+      pp->setMinFeatureDiameter(3.5f);
+      pp->setMaxFeatureDiameter(7.0f);
+      int32_t numBins = 7;
+
+      VectorOfFloatArray sizeDist = pp->CreateCorrelatedDistributionArrays(SIMPL::DistributionType::LogNormal, 1);
+      sizeDist[0]->setValue(0, logf(5.0f));
+      sizeDist[1]->setValue(0, 0.1f);
+      pp->setFeatureSizeDistribution(sizeDist);
+      pp->setFeatureSize_DistType(SIMPL::DistributionType::LogNormal);
+
+      VectorOfFloatArray bovera = pp->CreateCorrelatedDistributionArrays(SIMPL::DistributionType::Beta, numBins);
+      VectorOfFloatArray covera = pp->CreateCorrelatedDistributionArrays(SIMPL::DistributionType::Beta, numBins);
+      VectorOfFloatArray omegas = pp->CreateCorrelatedDistributionArrays(SIMPL::DistributionType::Beta, numBins);
+      for (int32_t i = 0; i < numBins; i++)
+      {
+        bovera[0]->setValue(i, 15.0f);
+        bovera[1]->setValue(i, 1.5f);
+        covera[0]->setValue(i, 15.0f);
+        covera[1]->setValue(i, 1.5f);
+        omegas[0]->setValue(i, 10.0f);
+        omegas[1]->setValue(i, 1.5f);
+      }
+      pp->setFeatureSize_BOverA(bovera);
+      pp->setBOverA_DistType(SIMPL::DistributionType::Beta);
+      pp->setFeatureSize_COverA(covera);
+      pp->setCOverA_DistType(SIMPL::DistributionType::Beta);
+      pp->setFeatureSize_Omegas(omegas);
+      pp->setOmegas_DistType(SIMPL::DistributionType::Beta);
+
+      FloatArrayType::Pointer axisODF = FloatArrayType::CreateArray(1, SIMPL::StringConstants::AxisOrientation);
+      axisODF->setValue(0, 1.0f);
+      pp->setAxisOrientation(axisODF);
+
+      RdfData::Pointer rdf = RdfData::New();
+      std::vector<float> freqs(10, 0.1f);
+      rdf->setFrequencies(freqs);
+      rdf->setMinDistance(4.0f);
+      rdf->setMaxDistance(14.0f);
+      pp->setRadialDistFunction(rdf);
+
+      return dca;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void SetPathProperty(AbstractFilter::Pointer filter, const char* name, const QString& attrMatName, const QString& arrayName)
+    {
+      QVariant var;
+      DataArrayPath path(SIMPL::Defaults::SyntheticVolumeDataContainerName, attrMatName, arrayName);
+      var.setValue(path);
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty(name, var), true)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    AbstractFilter::Pointer CreateFilter(DataContainerArray::Pointer dca, bool writeCheckpoints, bool resumeFromCheckpoint)
+    {
+      FilterManager* fm = FilterManager::Instance();
+      IFilterFactory::Pointer filterFactory = fm->getFactoryForFilter("InsertPrecipitatePhases");
+      DREAM3D_REQUIRE(NULL != filterFactory.get())
+      AbstractFilter::Pointer filter = filterFactory->create();
+      filter->setDataContainerArray(dca);
+
+      SetPathProperty(filter, "InputStatsArrayPath", SIMPL::Defaults::CellEnsembleAttributeMatrixName, SIMPL::EnsembleData::Statistics);
+      SetPathProperty(filter, "InputPhaseTypesArrayPath", SIMPL::Defaults::CellEnsembleAttributeMatrixName, SIMPL::EnsembleData::PhaseTypes);
+      SetPathProperty(filter, "InputShapeTypesArrayPath", SIMPL::Defaults::CellEnsembleAttributeMatrixName, SIMPL::EnsembleData::ShapeTypes);
+      SetPathProperty(filter, "NumFeaturesArrayPath", SIMPL::Defaults::CellEnsembleAttributeMatrixName, SIMPL::EnsembleData::NumFeatures);
+      SetPathProperty(filter, "FeatureIdsArrayPath", SIMPL::Defaults::CellAttributeMatrixName, SIMPL::CellData::FeatureIds);
+      SetPathProperty(filter, "CellPhasesArrayPath", SIMPL::Defaults::CellAttributeMatrixName, SIMPL::CellData::Phases);
+      SetPathProperty(filter, "BoundaryCellsArrayPath", SIMPL::Defaults::CellAttributeMatrixName, SIMPL::CellData::BoundaryCells);
+      SetPathProperty(filter, "FeaturePhasesArrayPath", SIMPL::Defaults::CellFeatureAttributeMatrixName, SIMPL::FeatureData::Phases);
+
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("PeriodicBoundaries", true), true)
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("MatchRDF", true), true)
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("UseFixedSeed", true), true)
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("RandomSeed", 4242), true)
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("WriteCheckpoints", writeCheckpoints), true)
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("CheckpointInterval", 1000), true)
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("ResumeFromCheckpoint", resumeFromCheckpoint), true)
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("CheckpointFile", UnitTest::InsertPrecipitatePhasesTest::CheckpointFile), true)
+      return filter;
+    }
+
+    // -----------------------------------------------------------------------------
+    // The uninterrupted run leaves its last checkpoint behind; resuming from it has to
+    // finish the RDF matching exactly the way the uninterrupted run did
+    // -----------------------------------------------------------------------------
+    void ResumeTest()
+    {
+      RemoveTestFiles();
+
+      DataContainerArray::Pointer uninterrupted = CreateDataContainerArray();
+      AbstractFilter::Pointer filter = CreateFilter(uninterrupted, true, false);
+      filter->execute();
+      DREAM3D_REQUIRE_EQUAL(filter->getErrorCondition(), 0)
+      DREAM3D_REQUIRE(QFile::exists(UnitTest::InsertPrecipitatePhasesTest::CheckpointFile))
+
+      DataContainerArray::Pointer resumed = CreateDataContainerArray();
+      filter = CreateFilter(resumed, false, true);
+      filter->execute();
+      DREAM3D_REQUIRE_EQUAL(filter->getErrorCondition(), 0)
+
+      DataArrayPath featurePhasesPath(SIMPL::Defaults::SyntheticVolumeDataContainerName, SIMPL::Defaults::CellFeatureAttributeMatrixName, SIMPL::FeatureData::Phases);
+      size_t numFeatures = uninterrupted->getAttributeMatrix(featurePhasesPath)->getNumTuples();
+      DREAM3D_REQUIRE(numFeatures > 2)
+      DREAM3D_REQUIRE_EQUAL(resumed->getAttributeMatrix(featurePhasesPath)->getNumTuples(), numFeatures)
+
+      DataArrayPath featureIdsPath(SIMPL::Defaults::SyntheticVolumeDataContainerName, SIMPL::Defaults::CellAttributeMatrixName, SIMPL::CellData::FeatureIds);
+      Int32ArrayType::Pointer expected = uninterrupted->getPrereqArrayFromPath<Int32ArrayType, AbstractFilter>(NULL, featureIdsPath, QVector<size_t>(1, 1));
+      Int32ArrayType::Pointer actual = resumed->getPrereqArrayFromPath<Int32ArrayType, AbstractFilter>(NULL, featureIdsPath, QVector<size_t>(1, 1));
+      DREAM3D_REQUIRE(NULL != expected.get())
+      DREAM3D_REQUIRE(NULL != actual.get())
+      size_t numTuples = expected->getNumberOfTuples();
+      size_t precipitateCells = 0;
+      for (size_t i = 0; i < numTuples; i++)
+      {
+        DREAM3D_REQUIRE_EQUAL(actual->getValue(i), expected->getValue(i))
+        if (expected->getValue(i) > 1) { precipitateCells++; }
+      }
+      DREAM3D_REQUIRE(precipitateCells > 0)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( TestFilterAvailability() );
+      DREAM3D_REGISTER_TEST( ResumeTest() )
+      DREAM3D_REGISTER_TEST( RemoveTestFiles() )
+    }
+
+  private:
+    InsertPrecipitatePhasesTest(const InsertPrecipitatePhasesTest&); // Copy Constructor Not Implemented
+    void operator=(const InsertPrecipitatePhasesTest&); // Operator '=' Not Implemented
+};
@@ -0,0 +1,356 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "OrientationLib/SpaceGroupOps/CubicOps.h"
+
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/OrientationChainRunner.hpp"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/SyntheticBuildingRandom.hpp"
+
+class OrientationChainRunnerTest
+{
+  public:
+    OrientationChainRunnerTest(){}
+    virtual ~OrientationChainRunnerTest(){}
+
+    // -----------------------------------------------------------------------------
+    // A random phase laid out like MatchCrystallography::measure_misorientations: Feature 0 is unused, every
+    // boundary is stored once for each of its two Features and some Features belong to another phase
+    // -----------------------------------------------------------------------------
+    void makePhase(int32_t numFeatures, SyntheticBuildingRandom& rg, std::vector<bool>& samePhase, std::vector<size_t>& neighborOffsets,
+                   std::vector<int32_t>& neighbors, std::vector<float>& areaFractions, std::vector<float>& volumeFractions, std::vector<bool>& selectable)
+    {
+      samePhase.assign(numFeatures, false);
+      selectable.assign(numFeatures, false);
+      volumeFractions.assign(numFeatures, 0.0f);
+      float totalVolume = 0.0f;
+      for (int32_t i = 1; i < numFeatures; i++)
+      {
+        samePhase[i] = (rg.genrand_res53() < 0.85);
+        selectable[i] = samePhase[i] && (rg.genrand_res53() < 0.8);
+        if (selectable[i] == true)
+        {
+          volumeFractions[i] = static_cast<float>(0.5 + rg.genrand_res53());
+          totalVolume += volumeFractions[i];
+        }
+      }
+      for (int32_t i = 1; i < numFeatures; i++)
+      {
+        volumeFractions[i] /= totalVolume;
+      }
+
+      // a ring keeps every Feature connected, random chords add more boundaries
+      std::vector<std::vector<int32_t> > featureNeighbors(numFeatures);
+      std::vector<std::vector<float> > featureAreas(numFeatures);
+      float totalArea = 0.0f;
+      for (int32_t i = 1; i < numFeatures; i++)
+      {
+        int32_t count = (i == numFeatures - 1) ? 1 : 3;
+        for (int32_t n = 0; n < count; n++)
+        {
+          int32_t j = (n == 0) ? ((i == numFeatures - 1) ? 1 : i + 1) : 1 + int32_t(rg.genrand_res53() * (numFeatures - 1));
+          if (j >= numFeatures || j == i || std::find(featureNeighbors[i].begin(), featureNeighbors[i].end(), j) != featureNeighbors[i].end()) { continue; }
+          float area = static_cast<float>(0.1 + rg.genrand_res53());
+          featureNeighbors[i].push_back(j);
+          featureAreas[i].push_back(area);
+          featureNeighbors[j].push_back(i);
+          featureAreas[j].push_back(area);
+          if (samePhase[i] == true && samePhase[j] == true) { totalArea += 2.0f * area; }
+        }
+      }
+
+      neighborOffsets.assign(numFeatures + 1, 0);
+      neighbors.clear();
+      areaFractions.clear();
+      for (int32_t i = 0; i < numFeatures; i++)
+      {
+        neighborOffsets[i] = neighbors.size();
+        for (size_t j = 0; j < featureNeighbors[i].size(); j++)
+        {
+          neighbors.push_back(featureNeighbors[i][j]);
+          bool counted = samePhase[i] == true && samePhase[featureNeighbors[i][j]] == true;
+          areaFractions.push_back(counted ? featureAreas[i][j] / totalArea : 0.0f);
+        }
+      }
+      neighborOffsets[numFeatures] = neighbors.size();
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void makeDistribution(int32_t numbins, SyntheticBuildingRandom& rg, std::vector<float>& distribution)
+    {
+      distribution.resize(numbins);
+      float total = 0.0f;
+      for (int32_t i = 0; i < numbins; i++)
+      {
+        // a few strong bins, so that swaps and switches can improve the fit
+        distribution[i] = (rg.genrand_res53() < 0.05) ? static_cast<float>(1.0 + 10.0 * rg.genrand_res53()) : static_cast<float>(rg.genrand_res53());
+        total += distribution[i];
+      }
+      for (int32_t i = 0; i < numbins; i++)
+      {
+        distribution[i] /= total;
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    // Builds the distributions of a chain from its Euler angles, like MatchCrystallography::assign_eulers and
+    // measure_misorientations do for the initial state
+    // -----------------------------------------------------------------------------
+    void computeChain(SpaceGroupOps::Pointer ops, const std::vector<bool>& samePhase, const std::vector<size_t>& neighborOffsets,
+                      const std::vector<int32_t>& neighbors, const std::vector<float>& areaFractions, const std::vector<float>& volumeFractions,
+                      const std::vector<bool>& selectable, OrientationChain_t& chain)
+    {
+      size_t numFeatures = samePhase.size();
+      chain.m_Quats.assign(numFeatures, QuaternionMathF::New());
+      chain.m_SimOdf.assign(ops->getODFSize(), 0.0f);
+      chain.m_SimMdf.assign(ops->getMDFSize(), 0.0f);
+      chain.m_MisorientationBins.assign(neighbors.size(), -1);
+      FOrientArrayType rod(4, 0.0);
+      FOrientArrayType quat(4, 0.0);
+      for (size_t i = 1; i < numFeatures; i++)
+      {
+        if (samePhase[i] == false) { continue; }
+        FOrientTransformsType::eu2qu(FOrientArrayType(&(chain.m_FeatureEulerAngles[3 * i]), 3), quat);
+        chain.m_Quats[i] = quat.toQuaternion();
+        if (selectable[i] == true)
+        {
+          FOrientTransformsType::eu2ro(FOrientArrayType(&(chain.m_FeatureEulerAngles[3 * i]), 3), rod);
+          chain.m_SimOdf[ops->getOdfBin(rod)] += volumeFractions[i];
+        }
+      }
+      for (size_t i = 1; i < numFeatures; i++)
+      {
+        for (size_t k = neighborOffsets[i]; k < neighborOffsets[i + 1]; k++)
+        {
+          if (samePhase[i] == false || samePhase[neighbors[k]] == false) { continue; }
+          int32_t neighbor = neighbors[k];
+          chain.m_MisorientationBins[k] = OrientationChainRunner::MisorientationBin(ops, chain.m_Quats[i], chain.m_Quats[neighbor]);
+          // every boundary counts once, from its interior Feature with the lower Id
+          if (selectable[i] == true && (neighbor > static_cast<int32_t>(i) || selectable[neighbor] == false))
+          {
+            chain.m_SimMdf[chain.m_MisorientationBins[k]] += areaFractions[k];
+          }
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void randomEulers(SpaceGroupOps::Pointer ops, const std::vector<bool>& samePhase, SyntheticBuildingRandom& rg, OrientationChain_t& chain)
+    {
+      chain.m_FeatureEulerAngles.assign(3 * samePhase.size(), 0.0f);
+      for (size_t i = 1; i < samePhase.size(); i++)
+      {
+        if (samePhase[i] == false) { continue; }
+        int32_t choose = int32_t(rg.genrand_res53() * ops->getODFSize());
+        FOrientArrayType eulers = ops->determineEulerAngles(rg.genrand_int64(), choose);
+        chain.m_FeatureEulerAngles[3 * i] = eulers[0];
+        chain.m_FeatureEulerAngles[3 * i + 1] = eulers[1];
+        chain.m_FeatureEulerAngles[3 * i + 2] = eulers[2];
+      }
+      chain.m_Iterations = 0;
+      chain.m_BadTryCount = 0;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    bool closeTo(double value, double expected)
+    {
+      return std::fabs(value - expected) <= 1.0E-6 + 1.0E-4 * std::fabs(expected);
+    }
+
+    // -----------------------------------------------------------------------------
+    // The incrementally updated distributions, bins and errors must match a recomputation from scratch
+    // after every swap and switch
+    // -----------------------------------------------------------------------------
+    void IncrementalErrorTest()
+    {
+      const int32_t numFeatures = 120;
+      SpaceGroupOps::Pointer ops = CubicOps::New();
+      SyntheticBuildingRandom rg(5489, SyntheticBuildingRandom::MatchCrystallographySwaps, 1);
+      std::vector<bool> samePhase, selectable;
+      std::vector<size_t> neighborOffsets;
+      std::vector<int32_t> neighbors;
+      std::vector<float> areaFractions, volumeFractions, actualOdf, actualMdf;
+      makePhase(numFeatures, rg, samePhase, neighborOffsets, neighbors, areaFractions, volumeFractions, selectable);
+      makeDistribution(ops->getODFSize(), rg, actualOdf);
+      makeDistribution(ops->getMDFSize(), rg, actualMdf);
+      OrientationChainRunner runner(ops, &(actualOdf.front()), &(actualMdf.front()), neighborOffsets, neighbors, areaFractions, volumeFractions, selectable, 100000);
+
+      OrientationChain_t chain;
+      randomEulers(ops, samePhase, rg, chain);
+      computeChain(ops, samePhase, neighborOffsets, neighbors, areaFractions, volumeFractions, selectable, chain);
+      runner.computeErrors(chain);
+
+      int32_t swaps = 0;
+      int32_t switches = 0;
+      OrientationChain_t expected;
+      for (int32_t trial = 0; trial < 2000; trial++)
+      {
+        int32_t feature1 = runner.selectFeature(rg, -1);
+        DREAM3D_REQUIRE(feature1 > 0 && selectable[feature1] == true)
+        if (rg.genrand_res53() < 0.5)
+        {
+          if (runner.swapOutOrientation(chain, rg, feature1) == true) { swaps++; }
+        }
+        else
+        {
+          int32_t feature2 = runner.selectFeature(rg, feature1);
+          DREAM3D_REQUIRE(feature2 > 0 && feature2 != feature1 && selectable[feature2] == true)
+          if (runner.switchOrientations(chain, feature1, feature2) == true) { switches++; }
+        }
+
+        expected.m_FeatureEulerAngles = chain.m_FeatureEulerAngles;
+        computeChain(ops, samePhase, neighborOffsets, neighbors, areaFractions, volumeFractions, selectable, expected);
+        runner.computeErrors(expected);
+        DREAM3D_REQUIRE(closeTo(chain.m_OdfError, expected.m_OdfError))
+        DREAM3D_REQUIRE(closeTo(chain.m_MdfError, expected.m_MdfError))
+        for (size_t i = 0; i < expected.m_SimOdf.size(); i++)
+        {
+          DREAM3D_REQUIRE(closeTo(chain.m_SimOdf[i], expected.m_SimOdf[i]))
+        }
+        for (size_t i = 0; i < expected.m_SimMdf.size(); i++)
+        {
+          DREAM3D_REQUIRE(closeTo(chain.m_SimMdf[i], expected.m_SimMdf[i]))
+        }
+        // the runner computes the bin of a boundary from the side of the Feature that changed, so either order is valid
+        for (int32_t i = 1; i < numFeatures; i++)
+        {
+          for (size_t k = neighborOffsets[i]; k < neighborOffsets[i + 1]; k++)
+          {
+            int32_t bin = chain.m_MisorientationBins[k];
+            if (expected.m_MisorientationBins[k] < 0)
+            {
+              DREAM3D_REQUIRE_EQUAL(bin, -1)
+              continue;
+            }
+            int32_t reverseBin = OrientationChainRunner::MisorientationBin(ops, expected.m_Quats[neighbors[k]], expected.m_Quats[i]);
+            DREAM3D_REQUIRE(bin == expected.m_MisorientationBins[k] || bin == reverseBin)
+          }
+        }
+      }
+      DREAM3D_REQUIRE(swaps > 0)
+      DREAM3D_REQUIRE(switches > 0)
+    }
+
+    // -----------------------------------------------------------------------------
+    // With a fixed seed the chains must not depend on the number of threads, and every chain of a multi
+    // chain run must match a single chain run on the same stream
+    // -----------------------------------------------------------------------------
+    void ThreadCountTest()
+    {
+      const int32_t numFeatures = 200;
+      const size_t numChains = 4;
+      const int32_t numBatches = 5;
+      const int32_t exchangeInterval = 300;
+      SpaceGroupOps::Pointer ops = CubicOps::New();
+      SyntheticBuildingRandom rg(5489, SyntheticBuildingRandom::MatchCrystallographySwaps, 2);
+      std::vector<bool> samePhase, selectable;
+      std::vector<size_t> neighborOffsets;
+      std::vector<int32_t> neighbors;
+      std::vector<float> areaFractions, volumeFractions, actualOdf, actualMdf;
+      makePhase(numFeatures, rg, samePhase, neighborOffsets, neighbors, areaFractions, volumeFractions, selectable);
+      makeDistribution(ops->getODFSize(), rg, actualOdf);
+      makeDistribution(ops->getMDFSize(), rg, actualMdf);
+      OrientationChainRunner runner(ops, &(actualOdf.front()), &(actualMdf.front()), neighborOffsets, neighbors, areaFractions, volumeFractions, selectable, 100000);
+
+      OrientationChain_t initial;
+      randomEulers(ops, samePhase, rg, initial);
+      computeChain(ops, samePhase, neighborOffsets, neighbors, areaFractions, volumeFractions, selectable, initial);
+      runner.computeErrors(initial);
+
+      // every chain on its own
+      std::vector<OrientationChain_t> reference(numChains, initial);
+      for (size_t c = 0; c < numChains; c++)
+      {
+        SyntheticBuildingRandom chainRg(5489, SyntheticBuildingRandom::MatchCrystallographySwaps, 1, static_cast<uint32_t>(c));
+        runner.runChain(reference[c], chainRg, numBatches * exchangeInterval);
+      }
+
+      for (int32_t threads = 1; threads <= 4; threads *= 2)
+      {
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+        tbb::task_scheduler_init init(threads);
+#endif
+        std::vector<OrientationChain_t> chains(numChains, initial);
+        std::vector<SyntheticBuildingRandom> generators;
+        for (size_t c = 0; c < numChains; c++)
+        {
+          generators.push_back(SyntheticBuildingRandom(5489, SyntheticBuildingRandom::MatchCrystallographySwaps, 1, static_cast<uint32_t>(c)));
+        }
+        for (int32_t batch = 0; batch < numBatches; batch++)
+        {
+          runner.runChains(chains, generators, exchangeInterval);
+        }
+        for (size_t c = 0; c < numChains; c++)
+        {
+          DREAM3D_REQUIRE(chains[c].m_FeatureEulerAngles == reference[c].m_FeatureEulerAngles)
+          DREAM3D_REQUIRE(chains[c].m_MisorientationBins == reference[c].m_MisorientationBins)
+          DREAM3D_REQUIRE(chains[c].m_SimOdf == reference[c].m_SimOdf)
+          DREAM3D_REQUIRE(chains[c].m_SimMdf == reference[c].m_SimMdf)
+          DREAM3D_REQUIRE_EQUAL(chains[c].m_OdfError, reference[c].m_OdfError)
+          DREAM3D_REQUIRE_EQUAL(chains[c].m_MdfError, reference[c].m_MdfError)
+          DREAM3D_REQUIRE_EQUAL(chains[c].m_Iterations, reference[c].m_Iterations)
+          DREAM3D_REQUIRE_EQUAL(chains[c].m_BadTryCount, reference[c].m_BadTryCount)
+        }
+      }
+      // the chains draw from different streams, so they must not all end in the same state
+      DREAM3D_REQUIRE(reference[0].m_FeatureEulerAngles != reference[1].m_FeatureEulerAngles)
+      DREAM3D_REQUIRE(reference[0].m_MdfError < initial.m_MdfError || reference[0].m_OdfError < initial.m_OdfError)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( IncrementalErrorTest() )
+      DREAM3D_REGISTER_TEST( ThreadCountTest() )
+    }
+
+  private:
+    OrientationChainRunnerTest(const OrientationChainRunnerTest&); // Copy Constructor Not Implemented
+    void operator=(const OrientationChainRunnerTest&); // Operator '=' Not Implemented
+};
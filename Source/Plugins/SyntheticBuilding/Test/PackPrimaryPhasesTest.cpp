@@ -0,0 +1,227 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <cmath>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QString>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/Common/SIMPLibSetGetMacros.h"
+#include "SIMPLib/Common/FilterManager.h"
+#include "SIMPLib/Common/FilterFactory.hpp"
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataArrays/StatsDataArray.h"
+#include "SIMPLib/DataArrays/StringDataArray.hpp"
+#include "SIMPLib/Geometry/ImageGeom.h"
+#include "SIMPLib/StatsData/PrimaryStatsData.h"
+#include "SIMPLib/Utilities/UnitTestSupport.hpp"
+#include "SIMPLib/Utilities/QMetaObjectUtilities.h"
+
+class PackPrimaryPhasesTest
+{
+  public:
+    PackPrimaryPhasesTest(){}
+    virtual ~PackPrimaryPhasesTest(){}
+    SIMPL_TYPE_MACRO(PackPrimaryPhasesTest)
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int TestFilterAvailability()
+    {
+      // Now instantiate the PackPrimaryPhases Filter from the FilterManager
+      QString filtName = "PackPrimaryPhases";
+      FilterManager* fm = FilterManager::Instance();
+      IFilterFactory::Pointer filterFactory = fm->getFactoryForFilter(filtName);
+      if (NULL == filterFactory.get() )
+      {
+        std::stringstream ss;
+        ss << "The PackPrimaryPhasesTest Requires the use of the " << filtName.toStdString() << " filter which is found in the SyntheticBuilding Plugin";
+        DREAM3D_TEST_THROW_EXCEPTION(ss.str())
+      }
+      return 0;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Builds the statistics of one equiaxed primary phase and an empty 32^3 volume
+    // -----------------------------------------------------------------------------
+    DataContainerArray::Pointer CreateDataContainerArray()
+    {
+      DataContainerArray::Pointer dca = DataContainerArray::New();
+
+      DataContainer::Pointer sg = DataContainer::New(SIMPL::Defaults::StatsGenerator);
+      dca->addDataContainer(sg);
+      QVector<size_t> cDims(1, 1);
+      QVector<size_t> eDims(1, 2);
+      AttributeMatrix::Pointer ensembleAttrMat = AttributeMatrix::New(eDims, SIMPL::Defaults::CellEnsembleAttributeMatrixName, SIMPL::AttributeMatrixType::CellEnsemble);
+      sg->addAttributeMatrix(ensembleAttrMat->getName(), ensembleAttrMat);
+      UInt32ArrayType::Pointer phaseTypes = UInt32ArrayType::CreateArray(eDims, cDims, SIMPL::EnsembleData::PhaseTypes);
+      phaseTypes->setValue(0, SIMPL::PhaseType::UnknownPhaseType);
+      phaseTypes->setValue(1, SIMPL::PhaseType::PrimaryPhase);
+      ensembleAttrMat->addAttributeArray(phaseTypes->getName(), phaseTypes);
+      UInt32ArrayType::Pointer shapeTypes = UInt32ArrayType::CreateArray(eDims, cDims, SIMPL::EnsembleData::ShapeTypes);
+      shapeTypes->setValue(0, SIMPL::ShapeType::UnknownShapeType);
+      shapeTypes->setValue(1, SIMPL::ShapeType::EllipsoidShape);
+      ensembleAttrMat->addAttributeArray(shapeTypes->getName(), shapeTypes);
+      StringDataArray::Pointer phaseNames = StringDataArray::CreateArray(eDims[0], SIMPL::EnsembleData::PhaseName);
+      phaseNames->setValue(0, "Invalid Phase");
+      phaseNames->setValue(1, "Primary");
+      ensembleAttrMat->addAttributeArray(phaseNames->getName(), phaseNames);
+
+      StatsDataArray::Pointer statsDataArray = StatsDataArray::CreateArray(eDims[0], SIMPL::EnsembleData::Statistics);
+      statsDataArray->fillArrayWithNewStatsData(eDims[0], phaseTypes->getPointer(0));
+      ensembleAttrMat->addAttributeArray(statsDataArray->getName(), statsDataArray);
+
+      PrimaryStatsData* pp = PrimaryStatsData::SafePointerDownCast((*statsDataArray)[1].get());
+      DREAM3D_REQUIRE(NULL != pp)
+      pp->setPhaseFraction(1.0f);
+      pp->setBinStepSize(0.5f);
+      pp->setMinFeatureDiameter(4.5f);
+      pp->setMaxFeatureDiameter(8.0f);
+      pp->generateBinNumbers();
+      int32_t numBins = static_cast<int32_t>(pp->getBinNumbers()->getSize());
+
+      VectorOfFloatArray sizeDist = pp->CreateCorrelatedDistributionArrays(SIMPL::DistributionType::LogNormal, 1);
+      sizeDist[0]->setValue(0, logf(6.0f));
+      sizeDist[1]->setValue(0, 0.1f);
+      pp->setFeatureSizeDistribution(sizeDist);
+      pp->setFeatureSize_DistType(SIMPL::DistributionType::LogNormal);
+
+      VectorOfFloatArray bovera = pp->CreateCorrelatedDistributionArrays(SIMPL::DistributionType::Beta, numBins);
+      VectorOfFloatArray covera = pp->CreateCorrelatedDistributionArrays(SIMPL::DistributionType::Beta, numBins);
+      VectorOfFloatArray omegas = pp->CreateCorrelatedDistributionArrays(SIMPL::DistributionType::Beta, numBins);
+      VectorOfFloatArray neighbors = pp->CreateCorrelatedDistributionArrays(SIMPL::DistributionType::LogNormal, numBins);
+      for (int32_t i = 0; i < numBins; i++)
+      {
+        bovera[0]->setValue(i, 15.0f);
+        bovera[1]->setValue(i, 1.5f);
+        covera[0]->setValue(i, 15.0f);
+        covera[1]->setValue(i, 1.5f);
+        omegas[0]->setValue(i, 10.0f);
+        omegas[1]->setValue(i, 1.5f);
+        neighbors[0]->setValue(i, 2.5f);
+        neighbors[1]->setValue(i, 0.3f);
+      }
+      pp->setFeatureSize_BOverA(bovera);
+      pp->setBOverA_DistType(SIMPL::DistributionType::Beta);
+      pp->setFeatureSize_COverA(covera);
+      pp->setCOverA_DistType(SIMPL::DistributionType::Beta);
+      pp->setFeatureSize_Omegas(omegas);
+      pp->setOmegas_DistType(SIMPL::DistributionType::Beta);
+      pp->setFeatureSize_Neighbors(neighbors);
+
+      FloatArrayType::Pointer axisODF = FloatArrayType::CreateArray(1, SIMPL::StringConstants::AxisOrientation);
+      axisODF->setValue(0, 1.0f);
+      pp->setAxisOrientation(axisODF);
+
+      DataContainer::Pointer m = DataContainer::New(SIMPL::Defaults::SyntheticVolumeDataContainerName);
+      ImageGeom::Pointer image = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+      m->setGeometry(image);
+      size_t dims[3] = { 32, 32, 32 };
+      image->setDimensions(dims);
+      image->setResolution(1.0f, 1.0f, 1.0f);
+      dca->addDataContainer(m);
+      QVector<size_t> tDims(3, 32);
+      AttributeMatrix::Pointer cellAttrMat = AttributeMatrix::New(tDims, SIMPL::Defaults::CellAttributeMatrixName, SIMPL::AttributeMatrixType::Cell);
+      m->addAttributeMatrix(cellAttrMat->getName(), cellAttrMat);
+
+      return dca;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    AbstractFilter::Pointer CreateFilter(DataContainerArray::Pointer dca, bool batchMoveEvaluation)
+    {
+      FilterManager* fm = FilterManager::Instance();
+      IFilterFactory::Pointer filterFactory = fm->getFactoryForFilter("PackPrimaryPhases");
+      DREAM3D_REQUIRE(NULL != filterFactory.get())
+      AbstractFilter::Pointer filter = filterFactory->create();
+      filter->setDataContainerArray(dca);
+
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("PeriodicBoundaries", true), true)
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("UseFixedSeed", true), true)
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("RandomSeed", 4242), true)
+      DREAM3D_REQUIRE_EQUAL(filter->setProperty("BatchMoveEvaluation", batchMoveEvaluation), true)
+      return filter;
+    }
+
+    // -----------------------------------------------------------------------------
+    // The batched moves see the grid as it was at the start of their batch, so they
+    // do not take the same path as the serial moves; the packing they end in must
+    // still be about as good
+    // -----------------------------------------------------------------------------
+    void BatchMoveEvaluationTest()
+    {
+      float fillingError[2] = { 0.0f, 0.0f };
+      float neighborhoodError[2] = { 0.0f, 0.0f };
+      DataArrayPath featurePhasesPath(SIMPL::Defaults::SyntheticVolumeDataContainerName, SIMPL::Defaults::CellFeatureAttributeMatrixName, SIMPL::FeatureData::Phases);
+      for (int32_t batch = 0; batch < 2; batch++)
+      {
+        DataContainerArray::Pointer dca = CreateDataContainerArray();
+        AbstractFilter::Pointer filter = CreateFilter(dca, batch == 1);
+        filter->execute();
+        DREAM3D_REQUIRE_EQUAL(filter->getErrorCondition(), 0)
+        DREAM3D_REQUIRE(dca->getAttributeMatrix(featurePhasesPath)->getNumTuples() > 20)
+
+        bool ok = false;
+        fillingError[batch] = filter->property("FillingError").toFloat(&ok);
+        DREAM3D_REQUIRE(ok)
+        neighborhoodError[batch] = filter->property("NeighborhoodError").toFloat(&ok);
+        DREAM3D_REQUIRE(ok)
+      }
+
+      DREAM3D_REQUIRE(fillingError[0] > 0.0f)
+      DREAM3D_REQUIRE(neighborhoodError[0] > 0.0f)
+      DREAM3D_REQUIRE(fabsf(fillingError[1] - fillingError[0]) <= 0.25f * fillingError[0] + 0.02f)
+      DREAM3D_REQUIRE(fabsf(neighborhoodError[1] - neighborhoodError[0]) <= 0.25f * neighborhoodError[0] + 0.05f)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( TestFilterAvailability() );
+      DREAM3D_REGISTER_TEST( BatchMoveEvaluationTest() )
+    }
+
+  private:
+    PackPrimaryPhasesTest(const PackPrimaryPhasesTest&); // Copy Constructor Not Implemented
+    void operator=(const PackPrimaryPhasesTest&); // Operator '=' Not Implemented
+};
@@ -0,0 +1,194 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <map>
+#include <vector>
+
+#include <QtCore/QFile>
+
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PackingCheckpoint.hpp"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/SyntheticBuildingRandom.hpp"
+
+#include "SyntheticBuildingTestFileLocations.h"
+
+class PackingCheckpointTest
+{
+  public:
+    PackingCheckpointTest(){}
+    virtual ~PackingCheckpointTest(){}
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void RemoveTestFiles()
+    {
+#if REMOVE_TEST_FILES
+      QFile::remove(UnitTest::PackingCheckpointTest::TestFile);
+      QFile::remove(UnitTest::PackingCheckpointTest::TestFile2);
+#endif
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void RoundTripTest()
+    {
+      std::vector<float> centroids(300);
+      for (size_t i = 0; i < centroids.size(); i++)
+      {
+        centroids[i] = 0.25f * static_cast<float>(i);
+      }
+      std::map<size_t, size_t> points;
+      for (size_t i = 0; i < 50; i++)
+      {
+        points[3 * i] = i;
+      }
+      int64_t packingPoints[3] = { 64, 32, 16 };
+
+      PackingCheckpoint checkpoint;
+      checkpoint.setValue("Iteration", int32_t(12345));
+      checkpoint.setValue("Seed", uint64_t(0x0123456789abcdefULL));
+      checkpoint.setArray("PackingPoints", packingPoints, 3);
+      checkpoint.setArray("Centroids", centroids);
+      checkpoint.setArray("Empty", std::vector<int32_t>());
+      checkpoint.setMap("AvailablePoints", points);
+      DREAM3D_REQUIRE_EQUAL(checkpoint.writeFile(UnitTest::PackingCheckpointTest::TestFile), 0)
+
+      PackingCheckpoint restored;
+      DREAM3D_REQUIRE_EQUAL(restored.readFile(UnitTest::PackingCheckpointTest::TestFile), 0)
+      int32_t iteration = 0;
+      uint64_t seed = 0;
+      int64_t restoredPoints[3] = { 0, 0, 0 };
+      std::vector<float> restoredCentroids;
+      std::vector<int32_t> empty(4, 1);
+      std::map<size_t, size_t> restoredMap;
+      DREAM3D_REQUIRE(restored.getValue("Iteration", iteration))
+      DREAM3D_REQUIRE_EQUAL(iteration, 12345)
+      DREAM3D_REQUIRE(restored.getValue("Seed", seed))
+      DREAM3D_REQUIRE(seed == 0x0123456789abcdefULL)
+      DREAM3D_REQUIRE(restored.getArray("PackingPoints", restoredPoints, 3))
+      DREAM3D_REQUIRE_EQUAL(restoredPoints[0], 64)
+      DREAM3D_REQUIRE_EQUAL(restoredPoints[2], 16)
+      DREAM3D_REQUIRE(restored.getArray("Centroids", restoredCentroids))
+      DREAM3D_REQUIRE(restoredCentroids == centroids)
+      DREAM3D_REQUIRE(restored.getArray("Empty", empty))
+      DREAM3D_REQUIRE_EQUAL(empty.size(), 0)
+      DREAM3D_REQUIRE(restored.getMap("AvailablePoints", restoredMap))
+      DREAM3D_REQUIRE(restoredMap == points)
+
+      // blocks that are missing or have the wrong size are rejected
+      DREAM3D_REQUIRE_EQUAL(restored.getArray("PackingPoints", restoredPoints, 2), false)
+      DREAM3D_REQUIRE_EQUAL(restored.getValue("Missing", iteration), false)
+
+      // a truncated file is rejected
+      QFile file(UnitTest::PackingCheckpointTest::TestFile);
+      DREAM3D_REQUIRE(file.resize(file.size() - 5))
+      DREAM3D_REQUIRE(restored.readFile(UnitTest::PackingCheckpointTest::TestFile) < 0)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void WriterTest()
+    {
+      PackingCheckpointWriter writer;
+      PackingCheckpoint checkpoint;
+      for (int32_t i = 0; i < 5; i++)
+      {
+        checkpoint.setValue("Iteration", i);
+        checkpoint.setArray("Data", std::vector<int32_t>(10000, i));
+        DREAM3D_REQUIRE_EQUAL(writer.write(checkpoint, UnitTest::PackingCheckpointTest::TestFile2), 0)
+        // the writer takes over the snapshot
+        int32_t iteration = -1;
+        DREAM3D_REQUIRE_EQUAL(checkpoint.getValue("Iteration", iteration), false)
+      }
+      DREAM3D_REQUIRE_EQUAL(writer.wait(), 0)
+
+      PackingCheckpoint restored;
+      int32_t iteration = -1;
+      std::vector<int32_t> data;
+      DREAM3D_REQUIRE_EQUAL(restored.readFile(UnitTest::PackingCheckpointTest::TestFile2), 0)
+      DREAM3D_REQUIRE(restored.getValue("Iteration", iteration))
+      DREAM3D_REQUIRE_EQUAL(iteration, 4)
+      DREAM3D_REQUIRE(restored.getArray("Data", data))
+      DREAM3D_REQUIRE(data == std::vector<int32_t>(10000, 4))
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void RandomStateTest()
+    {
+      // the stream continues identically after its state is restored, at any position within a block
+      for (int32_t skip = 0; skip < 9; skip++)
+      {
+        SyntheticBuildingRandom rg(987654321, SyntheticBuildingRandom::PackPrimaryPhasesPlacement);
+        for (int32_t i = 0; i < skip; i++)
+        {
+          rg.genrand_int32();
+        }
+        rg.genrand_norm(0.0, 1.0);
+        uint64_t position = 0;
+        bool haveNormal = false;
+        double normal = 0.0;
+        rg.getState(position, haveNormal, normal);
+
+        SyntheticBuildingRandom resumed(987654321, SyntheticBuildingRandom::PackPrimaryPhasesPlacement);
+        resumed.setState(position, haveNormal, normal);
+        for (int32_t i = 0; i < 20; i++)
+        {
+          DREAM3D_REQUIRE(rg.genrand_norm(0.0, 1.0) == resumed.genrand_norm(0.0, 1.0))
+          DREAM3D_REQUIRE_EQUAL(rg.genrand_int32(), resumed.genrand_int32())
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( RoundTripTest() )
+      DREAM3D_REGISTER_TEST( WriterTest() )
+      DREAM3D_REGISTER_TEST( RandomStateTest() )
+      DREAM3D_REGISTER_TEST( RemoveTestFiles() )
+    }
+
+  private:
+    PackingCheckpointTest(const PackingCheckpointTest&); // Copy Constructor Not Implemented
+    void operator=(const PackingCheckpointTest&); // Operator '=' Not Implemented
+};
@@ -0,0 +1,166 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <vector>
+
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PackingFootprint.hpp"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/SyntheticBuildingRandom.hpp"
+
+class PackingFootprintTest
+{
+  public:
+    PackingFootprintTest(){}
+    virtual ~PackingFootprintTest(){}
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void RunLengthTest()
+    {
+      // a solid box is stored as one run per column and row
+      PackingFootprint footprint;
+      footprint.clear(10, 20, 30);
+      for (int64_t i = 8; i < 13; i++)
+      {
+        for (int64_t j = 19; j < 22; j++)
+        {
+          for (int64_t k = 25; k < 35; k++)
+          {
+            footprint.addPoint(i, j, k, k >= 28 && k < 32);
+          }
+        }
+      }
+      DREAM3D_REQUIRE_EQUAL(footprint.getNumberOfPoints(), 5 * 3 * 10)
+      // the exclusion flag splits every column into 3 runs
+      DREAM3D_REQUIRE_EQUAL(footprint.getNumberOfRuns(), 5 * 3 * 3)
+      DREAM3D_REQUIRE_EQUAL(footprint.getRun(0).m_Column, -2)
+      DREAM3D_REQUIRE_EQUAL(footprint.getRun(0).m_Row, -1)
+      DREAM3D_REQUIRE_EQUAL(footprint.getRun(0).m_Plane, -5)
+      DREAM3D_REQUIRE_EQUAL(footprint.getRun(0).m_Length, 3)
+      DREAM3D_REQUIRE_EQUAL(footprint.getRun(1).m_Exclusion, true)
+      DREAM3D_REQUIRE_EQUAL(footprint.getRun(1).m_Length, 4)
+
+      footprint.translate(-3, 4, 1);
+      DREAM3D_REQUIRE_EQUAL(footprint.getOrigin()[0], 7)
+      DREAM3D_REQUIRE_EQUAL(footprint.getOrigin()[1], 24)
+      DREAM3D_REQUIRE_EQUAL(footprint.getOrigin()[2], 31)
+    }
+
+    // -----------------------------------------------------------------------------
+    // The segments have to visit the same packing points, in the same order, as wrapping (periodic) or clipping
+    // (non periodic) the individual points of the footprint
+    // -----------------------------------------------------------------------------
+    void SegmentTest()
+    {
+      const int64_t packingPoints[3] = { 13, 9, 7 };
+      const int64_t noShift[3] = { 0, 0, 0 };
+      int64_t planeStride = packingPoints[0] * packingPoints[1];
+      SyntheticBuildingRandom rg(5489, SyntheticBuildingRandom::PackPrimaryPhasesPlacement, 5);
+      PackingFootprint::Segment_t segments[3];
+      for (int32_t p = 0; p < 2; p++)
+      {
+        bool periodic = (p == 1);
+        for (int32_t trial = 0; trial < 100; trial++)
+        {
+          int64_t center[3] = { 0, 0, 0 };
+          for (int32_t d = 0; d < 3; d++)
+          {
+            center[d] = static_cast<int64_t>(rg.genrand_res53() * packingPoints[d]);
+          }
+          std::vector<int64_t> expected;
+          std::vector<bool> expectedExclusion;
+          PackingFootprint footprint;
+          footprint.clear(center[0], center[1], center[2]);
+          for (int64_t i = center[0] - 6; i <= center[0] + 6; i++)
+          {
+            for (int64_t j = center[1] - 5; j <= center[1] + 5; j++)
+            {
+              for (int64_t k = center[2] - 5; k <= center[2] + 5; k++)
+              {
+                if (rg.genrand_res53() < 0.3) { continue; }
+                bool exclusion = (rg.genrand_res53() < 0.5);
+                footprint.addPoint(i, j, k, exclusion);
+                int64_t col = i, row = j, plane = k;
+                if (periodic == true)
+                {
+                  if (col < 0) { col = col + packingPoints[0]; }
+                  if (col > packingPoints[0] - 1) { col = col - packingPoints[0]; }
+                  if (row < 0) { row = row + packingPoints[1]; }
+                  if (row > packingPoints[1] - 1) { row = row - packingPoints[1]; }
+                  if (plane < 0) { plane = plane + packingPoints[2]; }
+                  if (plane > packingPoints[2] - 1) { plane = plane - packingPoints[2]; }
+                }
+                if (col < 0 || col >= packingPoints[0] || row < 0 || row >= packingPoints[1] || plane < 0 || plane >= packingPoints[2]) { continue; }
+                expected.push_back((planeStride * plane) + (packingPoints[0] * row) + col);
+                expectedExclusion.push_back(exclusion);
+              }
+            }
+          }
+
+          std::vector<int64_t> visited;
+          std::vector<bool> visitedExclusion;
+          for (size_t r = 0; r < footprint.getNumberOfRuns(); r++)
+          {
+            int32_t numSegments = footprint.getSegments(r, packingPoints, periodic, noShift, segments);
+            for (int32_t s = 0; s < numSegments; s++)
+            {
+              for (int64_t k = 0; k < segments[s].m_Count; k++)
+              {
+                visited.push_back(segments[s].m_Start + k * planeStride);
+                visitedExclusion.push_back(footprint.getRun(r).m_Exclusion);
+              }
+            }
+          }
+          DREAM3D_REQUIRE(visited == expected)
+          DREAM3D_REQUIRE(visitedExclusion == expectedExclusion)
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( RunLengthTest() )
+      DREAM3D_REGISTER_TEST( SegmentTest() )
+    }
+
+  private:
+    PackingFootprintTest(const PackingFootprintTest&); // Copy Constructor Not Implemented
+    void operator=(const PackingFootprintTest&); // Operator '=' Not Implemented
+};
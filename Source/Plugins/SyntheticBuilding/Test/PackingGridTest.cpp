@@ -0,0 +1,214 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <vector>
+
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PackingAvailablePoints.hpp"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PackingGrid.hpp"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/SyntheticBuildingRandom.hpp"
+
+class PackingGridTest
+{
+  public:
+    PackingGridTest(){}
+    virtual ~PackingGridTest(){}
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestGrid()
+    {
+      const int64_t numPoints = 3 * PackingGrid::k_TileSize + 17;
+      PackingGrid grid;
+      grid.resize(numPoints);
+      DREAM3D_REQUIRE_EQUAL(grid.getNumberOfTiles(), 4)
+      size_t emptyUsage = grid.getMemoryUsage();
+
+      // an empty grid reads as zeros and holds no tiles
+      for (int64_t i = 0; i < numPoints; i += 101)
+      {
+        DREAM3D_REQUIRE_EQUAL(grid.getValue(i), 0)
+      }
+      for (int64_t t = 0; t < grid.getNumberOfTiles(); t++)
+      {
+        DREAM3D_REQUIRE_EQUAL(grid.isTileEmpty(t), true)
+      }
+
+      // counters are widened as they grow and the tile is released once it is all zeros again
+      int64_t index = PackingGrid::k_TileSize + 5;
+      DREAM3D_REQUIRE_EQUAL(grid.add(index, 1), 1)
+      DREAM3D_REQUIRE_EQUAL(grid.isTileEmpty(1), false)
+      size_t narrowUsage = grid.getMemoryUsage();
+      DREAM3D_REQUIRE(narrowUsage > emptyUsage)
+      DREAM3D_REQUIRE_EQUAL(grid.add(index, 300), 301)
+      DREAM3D_REQUIRE(grid.getMemoryUsage() > narrowUsage)
+      DREAM3D_REQUIRE_EQUAL(grid.add(index, 100000), 100301)
+      DREAM3D_REQUIRE_EQUAL(grid.add(index + 1, -70000), -70000)
+      DREAM3D_REQUIRE_EQUAL(grid[index], 100301)
+      DREAM3D_REQUIRE_EQUAL(grid[index + 1], -70000)
+      DREAM3D_REQUIRE_EQUAL(grid[index - 1], 0)
+      size_t peak = grid.getMemoryUsage();
+      grid.setValue(index, 0);
+      grid.setValue(index + 1, 0);
+      DREAM3D_REQUIRE_EQUAL(grid.isTileEmpty(1), true)
+      DREAM3D_REQUIRE_EQUAL(grid.getMemoryUsage(), emptyUsage)
+      DREAM3D_REQUIRE_EQUAL(grid.getPeakMemoryUsage(), peak)
+
+      // random updates against a dense copy, including the short last tile
+      SyntheticBuildingRandom rg(5, SyntheticBuildingRandom::PackPrimaryPhasesPlacement);
+      std::vector<int32_t> dense(numPoints, 0);
+      for (int32_t n = 0; n < 20000; n++)
+      {
+        int64_t i = static_cast<int64_t>(rg.genrand_res53() * numPoints);
+        int32_t delta = (rg.genrand_res53() < 0.5) ? -1 : 1;
+        if (dense[i] + delta < 0) { delta = 1; }
+        dense[i] += delta;
+        DREAM3D_REQUIRE_EQUAL(grid.add(i, delta), dense[i])
+      }
+      for (int64_t i = 0; i < numPoints; i++)
+      {
+        DREAM3D_REQUIRE_EQUAL(grid.getValue(i), dense[i])
+      }
+
+      // the allocated tiles round trip through getTiles / setTiles
+      std::vector<int64_t> tiles;
+      std::vector<int32_t> values;
+      grid.getTiles(tiles, values);
+      PackingGrid restored;
+      restored.resize(numPoints);
+      DREAM3D_REQUIRE_EQUAL(restored.setTiles(tiles, values), true)
+      for (int64_t i = 0; i < numPoints; i++)
+      {
+        DREAM3D_REQUIRE_EQUAL(restored.getValue(i), dense[i])
+      }
+      tiles.push_back(restored.getNumberOfTiles());
+      values.resize(values.size() + PackingGrid::k_TileSize, 0);
+      DREAM3D_REQUIRE_EQUAL(restored.setTiles(tiles, values), false)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void CheckAvailablePoints(const PackingGrid& exclusionOwners, const std::vector<bool>& mask, bool useMask, const PackingAvailablePoints& availablePoints)
+    {
+      std::vector<int64_t> expected;
+      for (int64_t i = 0; i < exclusionOwners.getNumberOfPoints(); i++)
+      {
+        if (exclusionOwners.getValue(i) == 0 && (useMask == false || mask[i] == true)) { expected.push_back(i); }
+      }
+      DREAM3D_REQUIRE_EQUAL(availablePoints.getCount(), static_cast<int64_t>(expected.size()))
+      for (size_t k = 0; k < expected.size(); k++)
+      {
+        DREAM3D_REQUIRE_EQUAL(availablePoints.getPoint(exclusionOwners, static_cast<int64_t>(k)), expected[k])
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestAvailablePoints()
+    {
+      const int64_t numPoints = 5 * PackingGrid::k_TileSize + 300;
+      SyntheticBuildingRandom rg(11, SyntheticBuildingRandom::PackPrimaryPhasesPlacement);
+      std::vector<bool> mask(numPoints, true);
+      bool* maskPtr = new bool[numPoints];
+      for (int64_t i = 0; i < numPoints; i++)
+      {
+        mask[i] = (rg.genrand_res53() < 0.8);
+        maskPtr[i] = mask[i];
+      }
+
+      for (int32_t useMask = 0; useMask < 2; useMask++)
+      {
+        PackingGrid exclusionOwners;
+        exclusionOwners.resize(numPoints);
+        // start from some exclusion zones, leaving whole tiles empty
+        for (int64_t i = PackingGrid::k_TileSize; i < 3 * PackingGrid::k_TileSize; i++)
+        {
+          if (rg.genrand_res53() < 0.5) { exclusionOwners.add(i, 1); }
+        }
+        PackingAvailablePoints availablePoints;
+        availablePoints.rebuild(exclusionOwners, useMask == 1 ? maskPtr : NULL);
+        CheckAvailablePoints(exclusionOwners, mask, useMask == 1, availablePoints);
+
+        // apply moves the way the packing does: adjust the counters, then report the points that changed state
+        for (int32_t move = 0; move < 50; move++)
+        {
+          std::vector<int64_t> removed;
+          std::vector<int64_t> added;
+          for (int32_t n = 0; n < 200; n++)
+          {
+            int64_t i = static_cast<int64_t>(rg.genrand_res53() * numPoints);
+            if (exclusionOwners.getValue(i) > 0 && rg.genrand_res53() < 0.5)
+            {
+              if (exclusionOwners.add(i, -1) == 0) { added.push_back(i); }
+            }
+            else
+            {
+              if (exclusionOwners.add(i, 1) == 1) { removed.push_back(i); }
+            }
+          }
+          for (size_t k = 0; k < removed.size(); k++)
+          {
+            availablePoints.pointRemoved(removed[k]);
+          }
+          for (size_t k = 0; k < added.size(); k++)
+          {
+            availablePoints.pointAdded(added[k]);
+          }
+          if (move % 10 == 0)
+          {
+            CheckAvailablePoints(exclusionOwners, mask, useMask == 1, availablePoints);
+          }
+        }
+        CheckAvailablePoints(exclusionOwners, mask, useMask == 1, availablePoints);
+      }
+      delete[] maskPtr;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( TestGrid() )
+      DREAM3D_REGISTER_TEST( TestAvailablePoints() )
+    }
+
+  private:
+    PackingGridTest(const PackingGridTest&); // Copy Constructor Not Implemented
+    void operator=(const PackingGridTest&); // Operator '=' Not Implemented
+};
@@ -0,0 +1,330 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <stdlib.h>
+
+#include <vector>
+
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PackingMoveEvaluator.hpp"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/SyntheticBuildingRandom.hpp"
+
+class PackingMoveEvaluatorTest
+{
+  public:
+    PackingMoveEvaluatorTest(){}
+    virtual ~PackingMoveEvaluatorTest(){}
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int64_t wrap(int64_t v, int64_t dim, bool periodic)
+    {
+      if (periodic == true)
+      {
+        if (v < 0) { v = v + dim; }
+        if (v > dim - 1) { v = v - dim; }
+      }
+      return v;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Adds (increment 1) or removes (increment -1) the footprint of a Feature like PackPrimaryPhases::check_fillingerror
+    // -----------------------------------------------------------------------------
+    void stamp(std::vector<int32_t>& featureOwners, const int64_t packingPoints[3], bool periodic, const std::vector<int64_t>& cl,
+               const std::vector<int64_t>& rl, const std::vector<int64_t>& pl, int32_t increment)
+    {
+      for (size_t i = 0; i < cl.size(); i++)
+      {
+        int64_t col = wrap(cl[i], packingPoints[0], periodic);
+        int64_t row = wrap(rl[i], packingPoints[1], periodic);
+        int64_t plane = wrap(pl[i], packingPoints[2], periodic);
+        if (col < 0 || col >= packingPoints[0] || row < 0 || row >= packingPoints[1] || plane < 0 || plane >= packingPoints[2]) { continue; }
+        featureOwners[(packingPoints[0] * packingPoints[1] * plane) + (packingPoints[0] * row) + col] += increment;
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int64_t fillingError(const std::vector<int32_t>& featureOwners)
+    {
+      int64_t error = 0;
+      for (size_t i = 0; i < featureOwners.size(); i++)
+      {
+        error += static_cast<int64_t>(featureOwners[i] - 1) * static_cast<int64_t>(featureOwners[i] - 1);
+      }
+      return error;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Places numFeatures spherical footprints of random radius at random grid points
+    // -----------------------------------------------------------------------------
+    void makePacking(const int64_t packingPoints[3], bool periodic, size_t numFeatures, int64_t maxRadius, SyntheticBuildingRandom& rg,
+                     std::vector<std::vector<int64_t> >& columnList, std::vector<std::vector<int64_t> >& rowList, std::vector<std::vector<int64_t> >& planeList,
+                     std::vector<PackingFootprint>& footprints, std::vector<int32_t>& featureOwners)
+    {
+      footprints.assign(numFeatures, PackingFootprint());
+      columnList.assign(numFeatures, std::vector<int64_t>());
+      rowList.assign(numFeatures, std::vector<int64_t>());
+      planeList.assign(numFeatures, std::vector<int64_t>());
+      featureOwners.assign(packingPoints[0] * packingPoints[1] * packingPoints[2], 0);
+      for (size_t f = 1; f < numFeatures; f++)
+      {
+        int64_t radius = 1 + static_cast<int64_t>(rg.genrand_res53() * maxRadius);
+        int64_t center[3] = { 0, 0, 0 };
+        for (int32_t d = 0; d < 3; d++)
+        {
+          center[d] = static_cast<int64_t>(rg.genrand_res53() * packingPoints[d]);
+        }
+        footprints[f].clear(center[0], center[1], center[2]);
+        for (int64_t i = -radius; i <= radius; i++)
+        {
+          for (int64_t j = -radius; j <= radius; j++)
+          {
+            for (int64_t k = -radius; k <= radius; k++)
+            {
+              if (i * i + j * j + k * k > radius * radius) { continue; }
+              columnList[f].push_back(center[0] + i);
+              rowList[f].push_back(center[1] + j);
+              planeList[f].push_back(center[2] + k);
+              footprints[f].addPoint(center[0] + i, center[1] + j, center[2] + k, false);
+            }
+          }
+        }
+        stamp(featureOwners, packingPoints, periodic, columnList[f], rowList[f], planeList[f], 1);
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void randomMove(size_t numFeatures, int64_t maxShift, SyntheticBuildingRandom& rg, PackingMove_t& move)
+    {
+      move.m_Feature = 1 + static_cast<int32_t>(rg.genrand_res53() * (numFeatures - 1));
+      for (int32_t d = 0; d < 3; d++)
+      {
+        move.m_Shift[d] = static_cast<int64_t>(rg.genrand_res53() * (2 * maxShift + 1)) - maxShift;
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void applyMove(const PackingMove_t& move, const int64_t packingPoints[3], bool periodic, std::vector<std::vector<int64_t> >& columnList,
+                   std::vector<std::vector<int64_t> >& rowList, std::vector<std::vector<int64_t> >& planeList, std::vector<PackingFootprint>& footprints,
+                   std::vector<int32_t>& featureOwners)
+    {
+      footprints[move.m_Feature].translate(move.m_Shift[0], move.m_Shift[1], move.m_Shift[2]);
+      std::vector<int64_t>& cl = columnList[move.m_Feature];
+      std::vector<int64_t>& rl = rowList[move.m_Feature];
+      std::vector<int64_t>& pl = planeList[move.m_Feature];
+      stamp(featureOwners, packingPoints, periodic, cl, rl, pl, -1);
+      for (size_t i = 0; i < cl.size(); i++)
+      {
+        cl[i] += move.m_Shift[0];
+        rl[i] += move.m_Shift[1];
+        pl[i] += move.m_Shift[2];
+      }
+      stamp(featureOwners, packingPoints, periodic, cl, rl, pl, 1);
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void MoveDeltaTest()
+    {
+      const int64_t packingPoints[3] = { 23, 17, 11 };
+      for (int32_t p = 0; p < 2; p++)
+      {
+        bool periodic = (p == 1);
+        SyntheticBuildingRandom rg(5489, SyntheticBuildingRandom::PackPrimaryPhasesPlacement, p);
+        std::vector<std::vector<int64_t> > columnList, rowList, planeList;
+        std::vector<PackingFootprint> footprints;
+        std::vector<int32_t> featureOwners;
+        makePacking(packingPoints, periodic, 40, 4, rg, columnList, rowList, planeList, footprints, featureOwners);
+        PackingMoveEvaluator evaluator(packingPoints, periodic, footprints);
+
+        std::vector<int64_t> cells;
+        PackingMove_t move;
+        for (int32_t i = 0; i < 200; i++)
+        {
+          randomMove(columnList.size(), 5, rg, move);
+          int64_t before = fillingError(featureOwners);
+          int64_t delta = evaluator.moveDelta(&(featureOwners.front()), move, cells);
+          applyMove(move, packingPoints, periodic, columnList, rowList, planeList, footprints, featureOwners);
+          DREAM3D_REQUIRE_EQUAL(delta, fillingError(featureOwners) - before)
+          // keep the improving moves so later moves see a changing grid
+          if (delta > 0)
+          {
+            move.m_Shift[0] = -move.m_Shift[0];
+            move.m_Shift[1] = -move.m_Shift[1];
+            move.m_Shift[2] = -move.m_Shift[2];
+            applyMove(move, packingPoints, periodic, columnList, rowList, planeList, footprints, featureOwners);
+            DREAM3D_REQUIRE_EQUAL(fillingError(featureOwners), before)
+          }
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    // Committing an evaluated batch in order, re-evaluating the moves that overlap an earlier committed move,
+    // has to end in the same packing as evaluating and committing the same moves one at a time
+    // -----------------------------------------------------------------------------
+    void BatchCommitTest()
+    {
+      const int64_t packingPoints[3] = { 32, 32, 32 };
+      const bool periodic = true;
+      SyntheticBuildingRandom rg(5489, SyntheticBuildingRandom::PackPrimaryPhasesPlacement, 2);
+      std::vector<std::vector<int64_t> > columnList, rowList, planeList;
+      std::vector<PackingFootprint> footprints;
+      std::vector<int32_t> featureOwners;
+      makePacking(packingPoints, periodic, 120, 4, rg, columnList, rowList, planeList, footprints, featureOwners);
+
+      std::vector<std::vector<int64_t> > serialColumnList(columnList), serialRowList(rowList), serialPlaneList(planeList);
+      std::vector<PackingFootprint> serialFootprints(footprints);
+      std::vector<int32_t> serialOwners(featureOwners);
+
+      PackingMoveEvaluator evaluator(packingPoints, periodic, footprints);
+      PackingMoveEvaluator serialEvaluator(packingPoints, periodic, serialFootprints);
+
+      const size_t batchSize = 64;
+      std::vector<PackingMove_t> moves(batchSize);
+      std::vector<int64_t> deltas;
+      std::vector<std::vector<int64_t> > cells;
+      std::vector<int64_t> serialCells;
+      std::vector<int32_t> claimedPoints(featureOwners.size(), -1);
+      std::vector<int32_t> movedFeatures(columnList.size(), -1);
+      int32_t accepted = 0, serialAccepted = 0, reevaluated = 0;
+      for (int32_t batch = 0; batch < 50; batch++)
+      {
+        for (size_t m = 0; m < batchSize; m++)
+        {
+          randomMove(columnList.size(), 3, rg, moves[m]);
+        }
+        for (size_t m = 0; m < batchSize; m++)
+        {
+          if (serialEvaluator.moveDelta(&(serialOwners.front()), moves[m], serialCells) <= 0)
+          {
+            applyMove(moves[m], packingPoints, periodic, serialColumnList, serialRowList, serialPlaneList, serialFootprints, serialOwners);
+            serialAccepted++;
+          }
+        }
+
+        evaluator.evaluateMoves(&(featureOwners.front()), moves, deltas, cells);
+        for (size_t m = 0; m < batchSize; m++)
+        {
+          bool stale = (movedFeatures[moves[m].m_Feature] == batch);
+          for (size_t c = 0; c < cells[m].size() && stale == false; c++)
+          {
+            if (claimedPoints[cells[m][c]] == batch) { stale = true; }
+          }
+          if (stale == true)
+          {
+            deltas[m] = evaluator.moveDelta(&(featureOwners.front()), moves[m], cells[m]);
+            reevaluated++;
+          }
+          if (deltas[m] <= 0)
+          {
+            applyMove(moves[m], packingPoints, periodic, columnList, rowList, planeList, footprints, featureOwners);
+            accepted++;
+            movedFeatures[moves[m].m_Feature] = batch;
+            for (size_t c = 0; c < cells[m].size(); c++)
+            {
+              claimedPoints[cells[m][c]] = batch;
+            }
+          }
+        }
+        DREAM3D_REQUIRE(featureOwners == serialOwners)
+      }
+      DREAM3D_REQUIRE_EQUAL(accepted, serialAccepted)
+      DREAM3D_REQUIRE(reevaluated > 0)
+      DREAM3D_REQUIRE(columnList == serialColumnList)
+    }
+
+    // -----------------------------------------------------------------------------
+    // The deltas of a batch must not depend on the number of threads that evaluate it
+    // -----------------------------------------------------------------------------
+    void ThreadCountTest()
+    {
+      const int64_t packingPoints[3] = { 32, 32, 32 };
+      const bool periodic = true;
+      SyntheticBuildingRandom rg(5489, SyntheticBuildingRandom::PackPrimaryPhasesPlacement, 3);
+      std::vector<std::vector<int64_t> > columnList, rowList, planeList;
+      std::vector<PackingFootprint> footprints;
+      std::vector<int32_t> featureOwners;
+      makePacking(packingPoints, periodic, 60, 4, rg, columnList, rowList, planeList, footprints, featureOwners);
+      PackingMoveEvaluator evaluator(packingPoints, periodic, footprints);
+
+      std::vector<PackingMove_t> moves(64);
+      std::vector<int64_t> deltas, allDeltas, reference;
+      std::vector<std::vector<int64_t> > cells;
+      const int32_t numBatches = 4;
+
+      for (int32_t threads = 1; threads <= 4; threads *= 2)
+      {
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+        tbb::task_scheduler_init init(threads);
+#endif
+        SyntheticBuildingRandom moveRg(5489, SyntheticBuildingRandom::PackPrimaryPhasesPlacement, 4);
+        allDeltas.clear();
+        for (int32_t batch = 0; batch < numBatches; batch++)
+        {
+          for (size_t m = 0; m < moves.size(); m++)
+          {
+            randomMove(columnList.size(), 4, moveRg, moves[m]);
+          }
+          evaluator.evaluateMoves(&(featureOwners.front()), moves, deltas, cells);
+          allDeltas.insert(allDeltas.end(), deltas.begin(), deltas.end());
+        }
+        if (reference.empty()) { reference = allDeltas; }
+        DREAM3D_REQUIRE(allDeltas == reference)
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( MoveDeltaTest() )
+      DREAM3D_REGISTER_TEST( BatchCommitTest() )
+      DREAM3D_REGISTER_TEST( ThreadCountTest() )
+    }
+
+  private:
+    PackingMoveEvaluatorTest(const PackingMoveEvaluatorTest&); // Copy Constructor Not Implemented
+    void operator=(const PackingMoveEvaluatorTest&); // Operator '=' Not Implemented
+};
@@ -0,0 +1,340 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+#include <tbb/task_scheduler_init.h>
+#endif
+
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PackingSlabs.hpp"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/SyntheticBuildingRandom.hpp"
+
+/**
+ * @brief Super ellipsoid shape function with a different exponent for every Feature
+ */
+class PackingSlabsShapeOp
+{
+  public:
+    PackingSlabsShapeOp() : m_N(2.0f) {}
+    void setExponent(float n) { m_N = n; }
+    float inside(float axis1comp, float axis2comp, float axis3comp)
+    {
+      return 1.0f - powf(fabsf(axis1comp), m_N) - powf(fabsf(axis2comp), m_N) - powf(fabsf(axis3comp), m_N);
+    }
+  private:
+    float m_N;
+};
+
+/**
+ * @brief Shape source of PackingSlabAssigner for the test Features
+ */
+class PackingSlabsShapes
+{
+  public:
+    typedef std::vector<PackingSlabsShapeOp> Ops;
+    typedef PackingSlabsShapeOp ShapeOp;
+
+    PackingSlabsShapes(const std::vector<float>& exponents) : m_Exponents(exponents) {}
+
+    Ops createOps() const { return Ops(1); }
+
+    ShapeOp* setup(Ops& ops, int64_t feature) const
+    {
+      ops[0].setExponent(m_Exponents[feature]);
+      return &(ops[0]);
+    }
+
+  private:
+    std::vector<float> m_Exponents;
+};
+
+/**
+ * @brief Randomly placed and rotated Features with their bounding boxes computed the way assign_voxels does
+ */
+class PackingSlabsFeatures
+{
+  public:
+    PackingSlabsFeatures(const int64_t dims[3], const float res[3], bool periodic, int64_t totalFeatures, uint32_t seed) :
+      m_Centers(3 * totalFeatures, 0.0f),
+      m_InvRadCur(3 * totalFeatures, 0.0f),
+      m_GA(9 * totalFeatures, 0.0f),
+      m_Bounds(6 * totalFeatures, 0),
+      m_Exponents(totalFeatures, 2.0f)
+    {
+      SyntheticBuildingRandom rg(5489, SyntheticBuildingRandom::PackPrimaryPhasesPlacement, seed);
+      // Feature 0 is never placed
+      for (int64_t i = 1; i < totalFeatures; i++)
+      {
+        float radcur[3] = { 0.0f, 0.0f, 0.0f };
+        radcur[0] = static_cast<float>(1.0 + 4.0 * rg.genrand_res53());
+        radcur[1] = radcur[0] * static_cast<float>(0.4 + 0.6 * rg.genrand_res53());
+        radcur[2] = radcur[0] * static_cast<float>(0.4 + 0.6 * rg.genrand_res53());
+        m_Exponents[i] = static_cast<float>(1.5 + 3.0 * rg.genrand_res53());
+
+        // rotation matrix from a random unit quaternion
+        float q[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        float norm = 0.0f;
+        for (int32_t j = 0; j < 4; j++)
+        {
+          q[j] = static_cast<float>(rg.genrand_norm(0.0, 1.0));
+          norm += q[j] * q[j];
+        }
+        norm = sqrtf(norm);
+        float w = q[0] / norm, x = q[1] / norm, y = q[2] / norm, z = q[3] / norm;
+        float ga[9] =
+        {
+          1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y - w * z), 2.0f * (x * z + w * y),
+          2.0f * (x * y + w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z - w * x),
+          2.0f * (x * z - w * y), 2.0f * (y * z + w * x), 1.0f - 2.0f * (x * x + y * y)
+        };
+
+        for (int32_t j = 0; j < 3; j++)
+        {
+          float size = float(dims[j]) * res[j];
+          m_Centers[3 * i + j] = static_cast<float>(rg.genrand_res53()) * size;
+          m_InvRadCur[3 * i + j] = 1.0f / radcur[j];
+          int64_t cell = static_cast<int64_t>(m_Centers[3 * i + j] / res[j]);
+          int64_t low = static_cast<int64_t>(cell - ((radcur[0] / res[j]) + 1));
+          int64_t high = static_cast<int64_t>(cell + ((radcur[0] / res[j]) + 1));
+          if (periodic == true)
+          {
+            low = std::max(low, -dims[j]);
+            high = std::min(high, 2 * dims[j] - 1);
+          }
+          else
+          {
+            low = std::max<int64_t>(low, 0);
+            high = std::min(high, dims[j] - 1);
+          }
+          m_Bounds[6 * i + 2 * j] = low;
+          m_Bounds[6 * i + 2 * j + 1] = high;
+        }
+        for (int32_t j = 0; j < 9; j++) { m_GA[9 * i + j] = ga[j]; }
+      }
+    }
+
+    std::vector<float> m_Centers;
+    std::vector<float> m_InvRadCur;
+    std::vector<float> m_GA;
+    std::vector<int64_t> m_Bounds;
+    std::vector<float> m_Exponents;
+};
+
+class PackingSlabsTest
+{
+  public:
+    PackingSlabsTest(){}
+    virtual ~PackingSlabsTest(){}
+
+    // -----------------------------------------------------------------------------
+    // Wraps an unwrapped coordinate by at most one period; returns -1 if it is still outside of the grid
+    // -----------------------------------------------------------------------------
+    int64_t wrap(int64_t c, int64_t dim)
+    {
+      if (c < 0) { c += dim; }
+      else if (c >= dim) { c -= dim; }
+      return (c >= 0 && c < dim) ? c : -1;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestBuckets()
+    {
+      const int64_t dims[3] = { 9, 7, 23 };
+      const float res[3] = { 1.0f, 1.0f, 1.0f };
+      const int64_t totalFeatures = 61;
+      const int64_t slabCounts[5] = { 1, 4, 7, 23, 50 };
+      for (int32_t p = 0; p < 2; p++)
+      {
+        bool periodic = (p == 1);
+        PackingSlabsFeatures features(dims, res, periodic, totalFeatures, 1 + p);
+        for (int32_t s = 0; s < 5; s++)
+        {
+          PackingSlabs slabs;
+          slabs.initialize(dims, slabCounts[s], &(features.m_Bounds.front()), 1, totalFeatures);
+          int64_t numSlabs = slabs.getNumSlabs();
+          DREAM3D_REQUIRE_EQUAL(numSlabs, std::min(slabCounts[s], dims[2]))
+          const int64_t* slabPlanes = slabs.getSlabPlanes();
+          const int64_t* slabOffsets = slabs.getSlabOffsets();
+          const int64_t* slabFeatures = slabs.getSlabFeatures();
+          DREAM3D_REQUIRE_EQUAL(slabPlanes[0], 0)
+          DREAM3D_REQUIRE_EQUAL(slabPlanes[numSlabs], dims[2])
+          DREAM3D_REQUIRE_EQUAL(slabOffsets[0], 0)
+
+          for (int64_t slab = 0; slab < numSlabs; slab++)
+          {
+            DREAM3D_REQUIRE(slabPlanes[slab] < slabPlanes[slab + 1])
+            // every Feature with a plane of its bounding box in the slab, after wrapping, in Feature Id order
+            std::vector<int64_t> expected;
+            for (int64_t i = 1; i < totalFeatures; i++)
+            {
+              bool overlaps = false;
+              for (int64_t z = features.m_Bounds[6 * i + 4]; z <= features.m_Bounds[6 * i + 5]; z++)
+              {
+                int64_t plane = wrap(z, dims[2]);
+                if (plane >= slabPlanes[slab] && plane < slabPlanes[slab + 1]) { overlaps = true; }
+              }
+              if (overlaps == true) { expected.push_back(i); }
+            }
+            std::vector<int64_t> actual(slabFeatures + slabOffsets[slab], slabFeatures + slabOffsets[slab + 1]);
+            DREAM3D_REQUIRE(actual == expected)
+          }
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    // Assigns the voxels one Feature at a time over the whole bounding box, the way assign_voxels did before the
+    // slabs, evaluating the shape function one voxel at a time
+    // -----------------------------------------------------------------------------
+    void bruteForceAssign(const int64_t dims[3], const float res[3], const PackingSlabsFeatures& features, int64_t totalFeatures,
+                          std::vector<int32_t>& newowners, std::vector<float>& ellipfuncs)
+    {
+      newowners.assign(dims[0] * dims[1] * dims[2], -1);
+      ellipfuncs.assign(dims[0] * dims[1] * dims[2], -1.0f);
+      PackingSlabsShapes shapes(features.m_Exponents);
+      PackingSlabsShapes::Ops ops = shapes.createOps();
+      for (int64_t i = 1; i < totalFeatures; i++)
+      {
+        PackingSlabsShapeOp* shapeOp = shapes.setup(ops, i);
+        const int64_t* bounds = &(features.m_Bounds[6 * i]);
+        const float* center = &(features.m_Centers[3 * i]);
+        float ga[3][3] = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+        for (int32_t j = 0; j < 9; j++) { ga[j / 3][j % 3] = features.m_GA[9 * i + j]; }
+        ShapeRunKernel kernel(ga, &(features.m_InvRadCur[3 * i]));
+        for (int64_t z = bounds[4]; z <= bounds[5]; z++)
+        {
+          for (int64_t y = bounds[2]; y <= bounds[3]; y++)
+          {
+            for (int64_t x = bounds[0]; x <= bounds[1]; x++)
+            {
+              int64_t column = wrap(x, dims[0]), row = wrap(y, dims[1]), plane = wrap(z, dims[2]);
+              if (column < 0 || row < 0 || plane < 0) { continue; }
+              float coords[3] = { 0.0f, float(y) * res[1] - center[1], float(z) * res[2] - center[2] };
+              float columnCoord = float(x) * res[0] - center[0];
+              float inside = 0.0f;
+              kernel.setRun(0, coords);
+              kernel.evaluate(shapeOp, &columnCoord, 1, &inside);
+              int64_t index = (plane * dims[1] + row) * dims[0] + column;
+              if (inside >= 0 && (newowners[index] == -1 || inside > ellipfuncs[index]))
+              {
+                newowners[index] = static_cast<int32_t>(i);
+                ellipfuncs[index] = inside;
+              }
+            }
+          }
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestAssignSerialAndParallel()
+    {
+      const int64_t dims[3] = { 17, 13, 11 };
+      const float res[3] = { 0.9f, 1.1f, 1.3f };
+      const int64_t totalFeatures = 41;
+      const int64_t slabCounts[3] = { 1, 3, 11 };
+      for (int32_t p = 0; p < 2; p++)
+      {
+        bool periodic = (p == 1);
+        PackingSlabsFeatures features(dims, res, periodic, totalFeatures, 10 + p);
+        PackingSlabsShapes shapes(features.m_Exponents);
+        std::vector<int32_t> expectedOwners;
+        std::vector<float> expectedFuncs;
+        bruteForceAssign(dims, res, features, totalFeatures, expectedOwners, expectedFuncs);
+
+        // the Features overlap and do not fill the volume
+        std::vector<bool> owned(totalFeatures, false);
+        int64_t unassigned = 0;
+        for (size_t v = 0; v < expectedOwners.size(); v++)
+        {
+          if (expectedOwners[v] == -1) { unassigned++; }
+          else { owned[expectedOwners[v]] = true; }
+        }
+        DREAM3D_REQUIRE(unassigned > 0)
+        DREAM3D_REQUIRE(std::count(owned.begin(), owned.end(), true) > totalFeatures / 2)
+
+        for (int32_t s = 0; s < 3; s++)
+        {
+          PackingSlabs slabs;
+          slabs.initialize(dims, slabCounts[s], &(features.m_Bounds.front()), 1, totalFeatures);
+          for (int32_t threads = 1; threads <= 4; threads *= 2)
+          {
+#ifdef SIMPLib_USE_PARALLEL_ALGORITHMS
+            tbb::task_scheduler_init init(threads);
+#endif
+            for (int32_t parallel = 0; parallel < 2; parallel++)
+            {
+              std::vector<int32_t> newowners(expectedOwners.size(), -1);
+              std::vector<float> ellipfuncs(expectedFuncs.size(), -1.0f);
+              PackingSlabAssigner<PackingSlabsShapes> assigner(dims, res, &slabs, &(features.m_Centers.front()), &(features.m_InvRadCur.front()),
+                                                               &(features.m_GA.front()), &(features.m_Bounds.front()), &shapes,
+                                                               &(newowners.front()), &(ellipfuncs.front()));
+              // in rounds of two slabs, as assign_voxels reports its progress
+              for (int64_t slabStart = 0; slabStart < slabs.getNumSlabs(); slabStart += 2)
+              {
+                assigner.assign(slabStart, std::min(slabStart + 2, slabs.getNumSlabs()), parallel == 1);
+              }
+              DREAM3D_REQUIRE(newowners == expectedOwners)
+              DREAM3D_REQUIRE(ellipfuncs == expectedFuncs)
+            }
+          }
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( TestBuckets() )
+      DREAM3D_REGISTER_TEST( TestAssignSerialAndParallel() )
+    }
+
+  private:
+    PackingSlabsTest(const PackingSlabsTest&); // Copy Constructor Not Implemented
+    void operator=(const PackingSlabsTest&); // Operator '=' Not Implemented
+};
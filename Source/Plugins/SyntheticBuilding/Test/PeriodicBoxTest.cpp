@@ -0,0 +1,185 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <vector>
+
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PeriodicBox.hpp"
+
+class PeriodicBoxTest
+{
+  public:
+    PeriodicBoxTest(){}
+    virtual ~PeriodicBoxTest(){}
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int64_t WrapOnce(int64_t coord, int64_t dim, bool periodic)
+    {
+      if (periodic == true)
+      {
+        if (coord < 0) { coord = coord + dim; }
+        else if (coord > dim - 1) { coord = coord - dim; }
+      }
+      if (coord < 0 || coord > dim - 1) { return -1; }
+      return coord;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void CheckBox(const int64_t dims[3], bool periodic, const int64_t bounds[6])
+    {
+      // every point of the box wrapped on its own, in the order the runs go through the box
+      std::vector<int64_t> expected;
+      std::vector<int64_t> expectedColumns;
+      for (int64_t z = bounds[4]; z <= bounds[5]; z++)
+      {
+        for (int64_t y = bounds[2]; y <= bounds[3]; y++)
+        {
+          for (int64_t x = bounds[0]; x <= bounds[1]; x++)
+          {
+            int64_t column = WrapOnce(x, dims[0], periodic);
+            int64_t row = WrapOnce(y, dims[1], periodic);
+            int64_t plane = WrapOnce(z, dims[2], periodic);
+            if (column < 0 || row < 0 || plane < 0) { continue; }
+            expected.push_back((dims[0] * dims[1] * plane) + (dims[0] * row) + column);
+            expectedColumns.push_back(x);
+          }
+        }
+      }
+
+      std::vector<int64_t> actual;
+      std::vector<int64_t> actualColumns;
+      PeriodicBox box(dims, periodic, bounds);
+      PeriodicBox::Run_t run;
+      while (box.next(run) == true)
+      {
+        DREAM3D_REQUIRE(run.m_Count > 0)
+        DREAM3D_REQUIRE(run.m_Row >= bounds[2] && run.m_Row <= bounds[3])
+        DREAM3D_REQUIRE(run.m_Plane >= bounds[4] && run.m_Plane <= bounds[5])
+        // a run never crosses the edge of a grid row
+        DREAM3D_REQUIRE_EQUAL(run.m_Index / dims[0], (run.m_Index + run.m_Count - 1) / dims[0])
+        for (int64_t i = 0; i < run.m_Count; i++)
+        {
+          actual.push_back(run.m_Index + i);
+          actualColumns.push_back(run.m_Column + i);
+        }
+      }
+      DREAM3D_REQUIRE_EQUAL(actual.size(), expected.size())
+      for (size_t i = 0; i < expected.size(); i++)
+      {
+        DREAM3D_REQUIRE_EQUAL(actual[i], expected[i])
+        DREAM3D_REQUIRE_EQUAL(actualColumns[i], expectedColumns[i])
+      }
+
+      // the walk starts over after a reset
+      box.reset();
+      size_t count = 0;
+      while (box.next(run) == true) { count += static_cast<size_t>(run.m_Count); }
+      DREAM3D_REQUIRE_EQUAL(count, expected.size())
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestSplitRange()
+    {
+      PeriodicBox::Range_t ranges[3];
+      // periodic: a range over both edges splits in three
+      DREAM3D_REQUIRE_EQUAL(PeriodicBox::SplitRange(-3, 14, 10, true, ranges), 3)
+      DREAM3D_REQUIRE_EQUAL(ranges[0].m_Start, -3)
+      DREAM3D_REQUIRE_EQUAL(ranges[0].m_Count, 3)
+      DREAM3D_REQUIRE_EQUAL(ranges[0].m_Wrap, 10)
+      DREAM3D_REQUIRE_EQUAL(ranges[1].m_Start, 0)
+      DREAM3D_REQUIRE_EQUAL(ranges[1].m_Count, 10)
+      DREAM3D_REQUIRE_EQUAL(ranges[1].m_Wrap, 0)
+      DREAM3D_REQUIRE_EQUAL(ranges[2].m_Start, 10)
+      DREAM3D_REQUIRE_EQUAL(ranges[2].m_Count, 4)
+      DREAM3D_REQUIRE_EQUAL(ranges[2].m_Wrap, -10)
+      // points more than one period out are dropped
+      DREAM3D_REQUIRE_EQUAL(PeriodicBox::SplitRange(-25, -5, 10, true, ranges), 1)
+      DREAM3D_REQUIRE_EQUAL(ranges[0].m_Start, -10)
+      DREAM3D_REQUIRE_EQUAL(ranges[0].m_Count, 5)
+      // not periodic: the range is clipped
+      DREAM3D_REQUIRE_EQUAL(PeriodicBox::SplitRange(-3, 14, 10, false, ranges), 1)
+      DREAM3D_REQUIRE_EQUAL(ranges[0].m_Start, 0)
+      DREAM3D_REQUIRE_EQUAL(ranges[0].m_Count, 10)
+      DREAM3D_REQUIRE_EQUAL(PeriodicBox::SplitRange(12, 14, 10, false, ranges), 0)
+      DREAM3D_REQUIRE_EQUAL(PeriodicBox::SplitRange(5, 5, 10, true, ranges), 0)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestBoxes()
+    {
+      const int64_t dims[3] = { 11, 7, 5 };
+      // inside the grid, then wrapping on one, two and three axes, over both edges, and wider than the grid
+      const int64_t boxes[][6] =
+      {
+        { 2, 6, 1, 4, 1, 3 },
+        { -3, 4, 1, 4, 1, 3 },
+        { 8, 13, 1, 4, 1, 3 },
+        { -3, 4, 5, 9, 1, 3 },
+        { 2, 6, -2, 3, 3, 6 },
+        { -3, 4, -2, 3, -1, 2 },
+        { 8, 13, 5, 9, 4, 7 },
+        { -2, 12, -1, 8, -2, 6 },
+        { -11, 21, -7, 13, -5, 9 },
+        { 15, 30, 1, 4, 1, 3 },
+      };
+      size_t numBoxes = sizeof(boxes) / sizeof(boxes[0]);
+      for (size_t b = 0; b < numBoxes; b++)
+      {
+        CheckBox(dims, true, boxes[b]);
+        CheckBox(dims, false, boxes[b]);
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( TestSplitRange() )
+      DREAM3D_REGISTER_TEST( TestBoxes() )
+    }
+
+  private:
+    PeriodicBoxTest(const PeriodicBoxTest&); // Copy Constructor Not Implemented
+    void operator=(const PeriodicBoxTest&); // Operator '=' Not Implemented
+};
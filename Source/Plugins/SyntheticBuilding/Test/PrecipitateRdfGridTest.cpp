@@ -0,0 +1,232 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/PrecipitateRdfGrid.hpp"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/SyntheticBuildingRandom.hpp"
+
+class PrecipitateRdfGridTest
+{
+  public:
+    PrecipitateRdfGridTest(){}
+    virtual ~PrecipitateRdfGridTest(){}
+
+    // -----------------------------------------------------------------------------
+    // The RDF the way determine_currentRDF built it before the cell grid: every ordered pair of precipitates of
+    // the same phase, binned by distance, with the bins past the cutoff left out
+    // -----------------------------------------------------------------------------
+    std::vector<float> bruteForceRdf(const std::vector<float>& centroids, const std::vector<int32_t>& phases, size_t firstFeature, float rdfMin,
+                                     float stepSize, int32_t numBins, size_t rdfSize)
+    {
+      std::vector<float> rdf(rdfSize, 0.0f);
+      for (size_t a = firstFeature; a < phases.size(); a++)
+      {
+        if (phases[a] == 0) { continue; }
+        for (size_t b = firstFeature; b < phases.size(); b++)
+        {
+          if (a == b || phases[a] != phases[b]) { continue; }
+          float dx = centroids[3 * a] - centroids[3 * b];
+          float dy = centroids[3 * a + 1] - centroids[3 * b + 1];
+          float dz = centroids[3 * a + 2] - centroids[3 * b + 2];
+          float r = sqrtf(dx * dx + dy * dy + dz * dz);
+          int32_t rdfBin = (r - rdfMin) / stepSize;
+          if (r < rdfMin) { rdfBin = -1; }
+          if (rdfBin >= numBins || rdfBin + 1 >= static_cast<int32_t>(rdfSize)) { continue; }
+          rdf[rdfBin + 1] += 1.0f;
+        }
+      }
+      return rdf;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void placeCentroid(SyntheticBuildingRandom& rg, const float size[3], bool periodic, std::vector<float>& centroids, size_t feature)
+    {
+      for (int32_t i = 0; i < 3; i++)
+      {
+        float u = static_cast<float>(rg.genrand_res53());
+        // wrapped precipitates of a periodic box can have their centroids up to half a box outside of it
+        centroids[3 * feature + i] = periodic ? (2.0f * u - 0.5f) * size[i] : u * size[i];
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    // Adds, removes and moves precipitates the way the RDF matching loop does and compares the RDF the grid keeps
+    // with a brute-force pair histogram after every step
+    // -----------------------------------------------------------------------------
+    void RunSequence(const float size[3], bool periodic, int32_t numPrecipitates, float rdfMin, float rdfMax, int32_t numBins, uint32_t seed)
+    {
+      SyntheticBuildingRandom rg(5489, SyntheticBuildingRandom::InsertPrecipitatePhasesPlacement, seed);
+      const size_t firstFeature = 3;
+      const size_t numFeatures = firstFeature + static_cast<size_t>(numPrecipitates);
+      const float stepSize = (rdfMax - rdfMin) / float(numBins);
+      const size_t rdfSize = static_cast<size_t>(numBins) + 6;
+
+      // phase 0 marks the precipitates that are not placed
+      std::vector<float> centroids(3 * numFeatures, 0.0f);
+      std::vector<int32_t> phases(numFeatures, 0);
+      for (size_t i = firstFeature; i < numFeatures; i++)
+      {
+        placeCentroid(rg, size, periodic, centroids, i);
+        if (rg.genrand_res53() < 0.8) { phases[i] = 1 + static_cast<int32_t>(rg.genrand_res53() * 2.0); }
+      }
+
+      PrecipitateRdfGrid grid;
+      grid.initialize(&(centroids.front()), firstFeature, numFeatures, size, rdfMin, rdfMax, stepSize, numBins);
+      int64_t cellDims[3] = { 0, 0, 0 };
+      grid.getCellDims(cellDims);
+      for (int32_t i = 0; i < 3; i++)
+      {
+        DREAM3D_REQUIRE(cellDims[i] >= 1)
+        // cells are never smaller than the cutoff
+        DREAM3D_REQUIRE(size[i] / static_cast<float>(cellDims[i]) >= rdfMax || cellDims[i] == 1)
+      }
+      DREAM3D_REQUIRE(cellDims[0] * cellDims[1] * cellDims[2] <= std::max<int64_t>(27, 4 * numPrecipitates))
+
+      std::vector<float> rdf(rdfSize, 0.0f);
+      for (size_t i = firstFeature; i < numFeatures; i++)
+      {
+        if (phases[i] != 0) { grid.accumulate(&(centroids.front()), &(phases.front()), static_cast<int32_t>(i), 1, rdf); }
+      }
+      DREAM3D_REQUIRE(rdf == bruteForceRdf(centroids, phases, firstFeature, rdfMin, stepSize, numBins, rdfSize))
+
+      // some pairs have to fall inside the bins for the comparison to mean anything
+      float maxPairs = 0.0f;
+      for (int32_t step = 0; step < 300; step++)
+      {
+        int32_t feature = static_cast<int32_t>(firstFeature) + static_cast<int32_t>(rg.genrand_res53() * numPrecipitates);
+        double action = rg.genrand_res53();
+        if (phases[feature] == 0)
+        {
+          // add a precipitate
+          placeCentroid(rg, size, periodic, centroids, feature);
+          phases[feature] = 1 + static_cast<int32_t>(rg.genrand_res53() * 2.0);
+          grid.accumulate(&(centroids.front()), &(phases.front()), feature, 2, rdf);
+        }
+        else if (action < 0.2)
+        {
+          // remove a precipitate
+          grid.accumulate(&(centroids.front()), &(phases.front()), feature, -2, rdf);
+          phases[feature] = 0;
+        }
+        else
+        {
+          // move a precipitate, either a short step across nearby cells or anywhere in the box
+          grid.accumulate(&(centroids.front()), &(phases.front()), feature, -2, rdf);
+          if (action < 0.6)
+          {
+            for (int32_t i = 0; i < 3; i++)
+            {
+              centroids[3 * feature + i] += (2.0f * static_cast<float>(rg.genrand_res53()) - 1.0f) * rdfMax;
+            }
+          }
+          else
+          {
+            placeCentroid(rg, size, periodic, centroids, feature);
+          }
+          grid.accumulate(&(centroids.front()), &(phases.front()), feature, 2, rdf);
+        }
+        DREAM3D_REQUIRE(rdf == bruteForceRdf(centroids, phases, firstFeature, rdfMin, stepSize, numBins, rdfSize))
+
+        float pairs = 0.0f;
+        for (size_t i = 0; i < rdf.size(); i++) { pairs += rdf[i]; }
+        maxPairs = std::max(maxPairs, pairs);
+      }
+      DREAM3D_REQUIRE(maxPairs > 0.0f)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestAgainstBruteForce()
+    {
+      const float size[3] = { 40.0f, 30.0f, 20.0f };
+      for (int32_t p = 0; p < 2; p++)
+      {
+        bool periodic = (p == 1);
+        // a few cells per axis
+        RunSequence(size, periodic, 60, 1.0f, 9.0f, 8, 1);
+        // a cutoff longer than the box, so all precipitates share one cell
+        RunSequence(size, periodic, 40, 2.0f, 60.0f, 12, 2);
+        // short cutoffs that would make far more cells than max(27, 4 * numPPT)
+        RunSequence(size, periodic, 50, 0.5f, 3.0f, 5, 3);
+        RunSequence(size, periodic, 6, 0.0f, 12.0f, 6, 4);
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void TestCellCap()
+    {
+      const float size[3] = { 40.0f, 30.0f, 20.0f };
+      std::vector<float> centroids(3 * 8, 1.0f);
+      PrecipitateRdfGrid grid;
+      int64_t cellDims[3] = { 0, 0, 0 };
+
+      // a cutoff of 3 would make 13 x 10 x 6 cells; 5 precipitates allow only 27 of them
+      grid.initialize(&(centroids.front()), 3, 8, size, 0.5f, 3.0f, 0.5f, 5);
+      grid.getCellDims(cellDims);
+      DREAM3D_REQUIRE(cellDims[0] * cellDims[1] * cellDims[2] <= 27)
+
+      // a cutoff of 9 makes 4 x 3 x 2 cells, below the cap
+      grid.initialize(&(centroids.front()), 3, 8, size, 1.0f, 9.0f, 1.0f, 8);
+      grid.getCellDims(cellDims);
+      DREAM3D_REQUIRE_EQUAL(cellDims[0], 4)
+      DREAM3D_REQUIRE_EQUAL(cellDims[1], 3)
+      DREAM3D_REQUIRE_EQUAL(cellDims[2], 2)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( TestCellCap() )
+      DREAM3D_REGISTER_TEST( TestAgainstBruteForce() )
+    }
+
+  private:
+    PrecipitateRdfGridTest(const PrecipitateRdfGridTest&); // Copy Constructor Not Implemented
+    void operator=(const PrecipitateRdfGridTest&); // Operator '=' Not Implemented
+};
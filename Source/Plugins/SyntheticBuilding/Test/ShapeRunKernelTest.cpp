@@ -0,0 +1,183 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <cmath>
+#include <vector>
+
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/ShapeRunKernel.hpp"
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/SyntheticBuildingRandom.hpp"
+
+/**
+ * @brief Super ellipsoid shape function with the same form as the one of the shape ops
+ */
+class TestSuperEllipsoidOp
+{
+  public:
+    TestSuperEllipsoidOp(float n) : m_N(n) {}
+    float inside(float axis1comp, float axis2comp, float axis3comp)
+    {
+      return 1.0f - powf(fabsf(axis1comp), m_N) - powf(fabsf(axis2comp), m_N) - powf(fabsf(axis3comp), m_N);
+    }
+  private:
+    float m_N;
+};
+
+class ShapeRunKernelTest
+{
+  public:
+    ShapeRunKernelTest(){}
+    virtual ~ShapeRunKernelTest(){}
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void RandomRotation(SyntheticBuildingRandom& rg, float ga[3][3])
+    {
+      // rotation matrix from a random unit quaternion
+      float q[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+      float norm = 0.0f;
+      for (int32_t i = 0; i < 4; i++)
+      {
+        q[i] = static_cast<float>(rg.genrand_norm(0.0, 1.0));
+        norm += q[i] * q[i];
+      }
+      norm = sqrtf(norm);
+      float w = q[0] / norm, x = q[1] / norm, y = q[2] / norm, z = q[3] / norm;
+      ga[0][0] = 1.0f - 2.0f * (y * y + z * z);
+      ga[0][1] = 2.0f * (x * y - w * z);
+      ga[0][2] = 2.0f * (x * z + w * y);
+      ga[1][0] = 2.0f * (x * y + w * z);
+      ga[1][1] = 1.0f - 2.0f * (x * x + z * z);
+      ga[1][2] = 2.0f * (y * z - w * x);
+      ga[2][0] = 2.0f * (x * z - w * y);
+      ga[2][1] = 2.0f * (y * z + w * x);
+      ga[2][2] = 1.0f - 2.0f * (x * x + y * y);
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void RunTest()
+    {
+      SyntheticBuildingRandom rg(2016, SyntheticBuildingRandom::PackPrimaryPhasesFeatures);
+      float res[3] = { 0.5f, 0.75f, 1.0f };
+      for (int32_t trial = 0; trial < 20; trial++)
+      {
+        float ga[3][3];
+        RandomRotation(rg, ga);
+        float radii[3] = { 0.0f, 0.0f, 0.0f };
+        float oneOverRadii[3] = { 0.0f, 0.0f, 0.0f };
+        float center[3] = { 0.0f, 0.0f, 0.0f };
+        for (int32_t k = 0; k < 3; k++)
+        {
+          radii[k] = static_cast<float>(2.0 + 6.0 * rg.genrand_res53());
+          oneOverRadii[k] = 1.0f / radii[k];
+          center[k] = static_cast<float>(20.0 * rg.genrand_res53());
+        }
+        TestSuperEllipsoidOp shapeOp(static_cast<float>(1.5 + 2.0 * rg.genrand_res53()));
+        ShapeRunKernel kernel(ga, oneOverRadii);
+
+        int64_t first = -10;
+        int64_t last = 40;
+        size_t count = static_cast<size_t>(last - first + 1);
+        for (int32_t runAxis = 0; runAxis < 3; runAxis++)
+        {
+          std::vector<float> runCoords(count, 0.0f);
+          for (size_t i = 0; i < count; i++)
+          {
+            runCoords[i] = float(first + int64_t(i)) * res[runAxis] - center[runAxis];
+          }
+          std::vector<float> inside(count, 0.0f);
+          for (int64_t a = first; a <= last; a += 5)
+          {
+            for (int64_t b = first; b <= last; b += 5)
+            {
+              int64_t fixedPoint[2] = { a, b };
+              float coords[3] = { 0.0f, 0.0f, 0.0f };
+              for (int32_t k = 0, f = 0; k < 3; k++)
+              {
+                if (k == runAxis) { continue; }
+                coords[k] = float(fixedPoint[f]) * res[k] - center[k];
+                f++;
+              }
+              kernel.setRun(runAxis, coords);
+              kernel.evaluate(&shapeOp, &(runCoords.front()), count, &(inside.front()));
+
+              for (size_t i = 0; i < count; i++)
+              {
+                // the components have to be the same as rotating the point on its own
+                coords[runAxis] = runCoords[i];
+                float rotated[3] = { 0.0f, 0.0f, 0.0f };
+                for (int32_t k = 0; k < 3; k++)
+                {
+                  rotated[k] = ga[k][0] * coords[0] + ga[k][1] * coords[1] + ga[k][2] * coords[2];
+                }
+                float axis1comp = rotated[0] * oneOverRadii[0];
+                float axis2comp = rotated[1] * oneOverRadii[1];
+                float axis3comp = rotated[2] * oneOverRadii[2];
+                // (up to rounding, the compiler may contract the vectorized loops into fused multiply-adds)
+                DREAM3D_REQUIRE(fabsf(kernel.getAxis1()[i] - axis1comp) <= 1.0e-5f * (1.0f + fabsf(axis1comp)))
+                DREAM3D_REQUIRE(fabsf(kernel.getAxis2()[i] - axis2comp) <= 1.0e-5f * (1.0f + fabsf(axis2comp)))
+                DREAM3D_REQUIRE(fabsf(kernel.getAxis3()[i] - axis3comp) <= 1.0e-5f * (1.0f + fabsf(axis3comp)))
+
+                float expected = shapeOp.inside(axis1comp, axis2comp, axis3comp);
+                if (fabsf(expected) > 1.0e-4f)
+                {
+                  DREAM3D_REQUIRE_EQUAL(inside[i] >= 0.0f, expected >= 0.0f)
+                }
+                if (expected > 1.0e-4f)
+                {
+                  DREAM3D_REQUIRE(fabsf(inside[i] - expected) <= 1.0e-4f)
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( RunTest() )
+    }
+
+  private:
+    ShapeRunKernelTest(const ShapeRunKernelTest&); // Copy Constructor Not Implemented
+    void operator=(const ShapeRunKernelTest&); // Operator '=' Not Implemented
+};
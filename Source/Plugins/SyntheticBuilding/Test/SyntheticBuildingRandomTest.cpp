@@ -0,0 +1,167 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <cmath>
+#include <vector>
+
+#include "SyntheticBuilding/SyntheticBuildingFilters/util/SyntheticBuildingRandom.hpp"
+
+class SyntheticBuildingRandomTest
+{
+  public:
+    SyntheticBuildingRandomTest(){}
+    virtual ~SyntheticBuildingRandomTest(){}
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void KnownAnswerTest()
+    {
+      // Known answer vectors for Philox4x32-10 published with Random123
+      const uint32_t counters[3][4] = { { 0x00000000, 0x00000000, 0x00000000, 0x00000000 },
+        { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff },
+        { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }
+      };
+      const uint32_t keys[3][2] = { { 0x00000000, 0x00000000 }, { 0xffffffff, 0xffffffff }, { 0xa4093822, 0x299f31d0 } };
+      const uint32_t expected[3][4] = { { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 },
+        { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd },
+        { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 }
+      };
+      uint32_t out[4] = { 0, 0, 0, 0 };
+      for (int32_t i = 0; i < 3; i++)
+      {
+        SyntheticBuildingRandom::Philox4x32(counters[i], keys[i], out);
+        for (int32_t j = 0; j < 4; j++)
+        {
+          DREAM3D_REQUIRE_EQUAL(out[j], expected[i][j])
+        }
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void StreamIndependenceTest()
+    {
+      const uint64_t seed = 0x0123456789ABCDEFULL;
+
+      // The same key always reproduces the same sequence, regardless of what other streams were used in between
+      SyntheticBuildingRandom a(seed, SyntheticBuildingRandom::PackPrimaryPhasesFeatures, 17, 3);
+      std::vector<uint32_t> first(64, 0);
+      for (size_t i = 0; i < first.size(); i++) { first[i] = a.genrand_int32(); }
+
+      SyntheticBuildingRandom other(seed, SyntheticBuildingRandom::PackPrimaryPhasesFeatures, 18, 3);
+      for (size_t i = 0; i < 1000; i++) { other.genrand_res53(); }
+
+      SyntheticBuildingRandom b(seed, SyntheticBuildingRandom::PackPrimaryPhasesFeatures, 17, 3);
+      for (size_t i = 0; i < first.size(); i++)
+      {
+        DREAM3D_REQUIRE_EQUAL(b.genrand_int32(), first[i])
+      }
+
+      // Changing any part of the key gives a different sequence
+      SyntheticBuildingRandom streams[4] = { SyntheticBuildingRandom(seed + 1, SyntheticBuildingRandom::PackPrimaryPhasesFeatures, 17, 3),
+                                             SyntheticBuildingRandom(seed, SyntheticBuildingRandom::InsertPrecipitatePhasesFeatures, 17, 3),
+                                             SyntheticBuildingRandom(seed, SyntheticBuildingRandom::PackPrimaryPhasesFeatures, 16, 3),
+                                             SyntheticBuildingRandom(seed, SyntheticBuildingRandom::PackPrimaryPhasesFeatures, 17, 4)
+                                           };
+      for (int32_t s = 0; s < 4; s++)
+      {
+        size_t same = 0;
+        for (size_t i = 0; i < first.size(); i++)
+        {
+          if (streams[s].genrand_int32() == first[i]) { same++; }
+        }
+        DREAM3D_REQUIRE(same < 2)
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void DistributionTest()
+    {
+      const size_t numSamples = 200000;
+      SyntheticBuildingRandom rg(5489, SyntheticBuildingRandom::MatchCrystallographySwaps);
+
+      double sum = 0.0, sumSq = 0.0;
+      for (size_t i = 0; i < numSamples; i++)
+      {
+        double u = rg.genrand_res53();
+        DREAM3D_REQUIRE(u >= 0.0 && u < 1.0)
+        sum += u;
+      }
+      DREAM3D_REQUIRE(fabs(sum / numSamples - 0.5) < 0.005)
+
+      sum = 0.0;
+      for (size_t i = 0; i < numSamples; i++)
+      {
+        double n = rg.genrand_norm(2.0, 0.5);
+        sum += n;
+        sumSq += n * n;
+      }
+      double mean = sum / numSamples;
+      double var = sumSq / numSamples - mean * mean;
+      DREAM3D_REQUIRE(fabs(mean - 2.0) < 0.01)
+      DREAM3D_REQUIRE(fabs(var - 0.25) < 0.01)
+
+      // Beta(a, b) has mean a / (a + b)
+      const double a = 15.0, b = 1.5;
+      sum = 0.0;
+      for (size_t i = 0; i < numSamples; i++)
+      {
+        double x = rg.genrand_beta(a, b);
+        DREAM3D_REQUIRE(x >= 0.0 && x <= 1.0)
+        sum += x;
+      }
+      DREAM3D_REQUIRE(fabs(sum / numSamples - a / (a + b)) < 0.005)
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      DREAM3D_REGISTER_TEST( KnownAnswerTest() )
+      DREAM3D_REGISTER_TEST( StreamIndependenceTest() )
+      DREAM3D_REGISTER_TEST( DistributionTest() )
+    }
+
+  private:
+    SyntheticBuildingRandomTest(const SyntheticBuildingRandomTest&); // Copy Constructor Not Implemented
+    void operator=(const SyntheticBuildingRandomTest&); // Operator '=' Not Implemented
+};